@@ -31,9 +31,8 @@ DummyPlayer::~DummyPlayer() {
 }
 
 void DummyPlayer::OnFramesReady(size_t buffer_size) {
-  // Consume the next frame.
-  buffer_.resize(buffer_size);
-  const EncodedFrame frame = receiver_->ConsumeNextFrame(buffer_);
+  // Consume the next frame, taking the buffer it was assembled in.
+  const EncodedFrame frame = receiver_->TakeNextFrame(&buffer_);
   receiver_->ReportPlayoutEvent(frame.frame_id, frame.rtp_timestamp,
                                 Clock::now());
 
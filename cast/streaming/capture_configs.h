@@ -5,6 +5,7 @@
 #ifndef CAST_STREAMING_CAPTURE_CONFIGS_H_
 #define CAST_STREAMING_CAPTURE_CONFIGS_H_
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,16 @@ struct AudioCaptureConfig {
   // in RFC 6381: https://datatracker.ietf.org/doc/html/rfc6381
   // NOTE: the "profiles" parameter is not supported in our implementation.
   std::string codec_parameter;
+
+  // The Forward Error Correction overhead to offer, as the ratio of parity
+  // packets to data packets (e.g., 0.1 for one parity packet every ten data
+  // packets). Zero disables FEC. Only used by the sender.
+  double fec_overhead_ratio = 0.0;
+
+  // If set, the sender offers to let the receiver adapt the target playout
+  // delay, and then adopts the delays the receiver requests, if they are within
+  // these bounds. Only used by the sender.
+  std::optional<PlayoutDelayBounds> adaptive_playout_delay;
 };
 
 // A configuration set that can be used by the sender to capture video, as
@@ -74,6 +85,16 @@ struct VideoCaptureConfig {
   // https://www.webmproject.org/vp9/mp4/#codecs-parameter-string
   // NOTE: the "profiles" parameter is not supported in our implementation.
   std::string codec_parameter;
+
+  // The Forward Error Correction overhead to offer, as the ratio of parity
+  // packets to data packets (e.g., 0.1 for one parity packet every ten data
+  // packets). Zero disables FEC. Only used by the sender.
+  double fec_overhead_ratio = 0.0;
+
+  // If set, the sender offers to let the receiver adapt the target playout
+  // delay, and then adopts the delays the receiver requests, if they are within
+  // these bounds. Only used by the sender.
+  std::optional<PlayoutDelayBounds> adaptive_playout_delay;
 };
 
 }  // namespace openscreen::cast
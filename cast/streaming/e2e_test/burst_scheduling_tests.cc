@@ -0,0 +1,306 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "cast/streaming/impl/congestion_controller.h"
+#include "cast/streaming/impl/delay_based_congestion_controller.h"
+#include "cast/streaming/impl/receiver_impl.h"
+#include "cast/streaming/impl/receiver_packet_router.h"
+#include "cast/streaming/impl/sender_impl.h"
+#include "cast/streaming/public/constants.h"
+#include "cast/streaming/public/encoded_frame.h"
+#include "cast/streaming/public/frame_id.h"
+#include "cast/streaming/public/receiver.h"
+#include "cast/streaming/public/sender.h"
+#include "cast/streaming/public/session_config.h"
+#include "cast/streaming/rtp_time.h"
+#include "cast/streaming/sender_packet_router.h"
+#include "cast/streaming/testing/simulated_network.h"
+#include "gtest/gtest.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+#include "util/raw_ref.h"
+
+namespace openscreen::cast {
+namespace {
+
+// The synthetic streams: 50 FPS audio at 64 kbps, and 30 FPS video at about
+// 2 Mbps, with a 120 KB key frame every second. The key frames take 160 ms to
+// cross the 6 Mbps bottleneck.
+constexpr int kAudioRtpTimebase = 48000;
+constexpr int kAudioFramesPerSecond = 50;
+constexpr int kAudioFrameSize = 64'000 / 8 / kAudioFramesPerSecond;
+constexpr microseconds kAudioFrameInterval(1'000'000 / kAudioFramesPerSecond);
+
+constexpr int kVideoRtpTimebase = 90000;
+constexpr int kVideoFramesPerSecond = 30;
+constexpr int kVideoFrameSize = 2'000'000 / 8 / kVideoFramesPerSecond;
+constexpr int kKeyFrameSize = 120 * 1024;
+constexpr microseconds kVideoFrameInterval(1'000'000 / kVideoFramesPerSecond);
+constexpr int kKeyFrameInterval = kVideoFramesPerSecond;
+
+constexpr seconds kDuration(10);
+constexpr milliseconds kTargetPlayoutDelay(400);
+
+constexpr int kBottleneckBandwidth = 6'000'000;
+
+// The audio stream is given the lower-priority SSRCs, so that its packets are
+// only sent ahead of the video's because of their deadlines.
+constexpr Ssrc kVideoSenderSsrc = 1;
+constexpr Ssrc kVideoReceiverSsrc = 2;
+constexpr Ssrc kAudioSenderSsrc = 60001;
+constexpr Ssrc kAudioReceiverSsrc = 60002;
+
+constexpr auto kAesKey =
+    std::array<uint8_t, 16>{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                             0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr auto kCastIvMask =
+    std::array<uint8_t, 16>{{0xf0, 0xe0, 0xd0, 0xc0, 0xb0, 0xa0, 0x90, 0x80,
+                             0x70, 0x60, 0x50, 0x40, 0x30, 0x20, 0x10, 0x00}};
+
+SessionConfig MakeAudioConfig() {
+  return SessionConfig(kAudioSenderSsrc, kAudioReceiverSsrc, kAudioRtpTimebase,
+                       /* channels */ 2, kTargetPlayoutDelay, kAesKey,
+                       kCastIvMask, /* is_pli_enabled */ false,
+                       StreamType::kAudio);
+}
+
+SessionConfig MakeVideoConfig() {
+  return SessionConfig(kVideoSenderSsrc, kVideoReceiverSsrc, kVideoRtpTimebase,
+                       /* channels */ 1, kTargetPlayoutDelay, kAesKey,
+                       kCastIvMask, /* is_pli_enabled */ false,
+                       StreamType::kVideo);
+}
+
+// A CongestionController that never has a network bandwidth estimate, so that
+// the SenderPacketRouter does not pace the video.
+class NoEstimateCongestionController : public CongestionController {
+ public:
+  NoEstimateCongestionController() = default;
+  ~NoEstimateCongestionController() override = default;
+
+  // CongestionController overrides.
+  void OnBurstComplete(int num_packets_sent, Clock::time_point when) override {}
+  void OnRtcpReceived(Clock::time_point arrival_time,
+                      Clock::duration estimated_round_trip_time) override {}
+  void OnPayloadReceived(int payload_bytes_acknowledged,
+                         Clock::time_point ack_arrival_time,
+                         Clock::duration estimated_round_trip_time) override {}
+  int ComputeNetworkBandwidth() const override { return 0; }
+};
+
+// Records the end-to-end latency of each frame a Receiver plays out, from its
+// capture until the Receiver made it available for consumption.
+class LatencyRecorder : public Receiver::Consumer {
+ public:
+  explicit LatencyRecorder(ReceiverImpl& receiver) : receiver_(receiver) {
+    receiver_->SetConsumer(this);
+  }
+  ~LatencyRecorder() override { receiver_->SetConsumer(nullptr); }
+
+  const std::vector<Clock::duration>& latencies() const { return latencies_; }
+
+  void OnFrameEnqueued(FrameId frame_id, Clock::time_point capture_time) {
+    capture_times_[frame_id] = capture_time;
+  }
+
+  // Receiver::Consumer override.
+  void OnFramesReady(size_t next_frame_buffer_size) override {
+    std::optional<size_t> buffer_size = next_frame_buffer_size;
+    while (buffer_size) {
+      const EncodedFrame frame = receiver_->TakeNextFrame(&buffer_);
+      const auto it = capture_times_.find(frame.frame_id);
+      OSP_CHECK(it != capture_times_.end());
+      latencies_.push_back(FakeClock::now() - it->second);
+      buffer_size = receiver_->AdvanceToNextFrame();
+    }
+  }
+
+ private:
+  const raw_ref<ReceiverImpl> receiver_;
+  std::map<FrameId, Clock::time_point> capture_times_;
+  std::vector<uint8_t> buffer_;
+  std::vector<Clock::duration> latencies_;
+};
+
+// What the test measures of the audio stream.
+struct AudioResults {
+  int frames_played_out = 0;
+
+  // The mean absolute difference between the latencies of consecutive frames,
+  // like the RFC 3550 interarrival jitter, and the maximum latency.
+  Clock::duration jitter{};
+  Clock::duration max_latency{};
+};
+
+// Streams the synthetic audio and video from two SenderImpls, sharing one
+// SenderPacketRouter, to two ReceiverImpls over a SimulatedNetwork with a
+// bottleneck link, and measures the latency of the audio.
+AudioResults StreamAudioAndVideo(bool pace_video) {
+  FakeClock clock(Clock::now());
+  FakeTaskRunner task_runner(clock);
+  SimulatedNetwork network(
+      &FakeClock::now, task_runner,
+      {.bandwidth = kBottleneckBandwidth,
+       .queue_size = 512 * 1024,
+       .delay = milliseconds(10)},
+      {.bandwidth = kBottleneckBandwidth, .delay = milliseconds(10)});
+
+  SenderPacketRouter sender_packet_router(network.sender_environment());
+  // The DelayBasedCongestionController's estimate tracks the throughput at the
+  // bottleneck, to which the SenderPacketRouter paces the video.
+  if (pace_video) {
+    sender_packet_router.SetCongestionController(
+        std::make_unique<DelayBasedCongestionController>(FakeClock::now()));
+  } else {
+    sender_packet_router.SetCongestionController(
+        std::make_unique<NoEstimateCongestionController>());
+  }
+  SenderImpl audio_sender(network.sender_environment(), sender_packet_router,
+                          MakeAudioConfig(), RtpPayloadType::kAudioOpus);
+  SenderImpl video_sender(network.sender_environment(), sender_packet_router,
+                          MakeVideoConfig(), RtpPayloadType::kVideoVp8);
+
+  ReceiverPacketRouter receiver_packet_router(network.receiver_environment());
+  ReceiverImpl audio_receiver(network.receiver_environment(),
+                              receiver_packet_router, MakeAudioConfig());
+  ReceiverImpl video_receiver(network.receiver_environment(),
+                              receiver_packet_router, MakeVideoConfig());
+  LatencyRecorder audio_recorder(audio_receiver);
+  LatencyRecorder video_recorder(video_receiver);
+
+  const Clock::time_point start_time = FakeClock::now();
+  const Clock::time_point end_time = start_time + kDuration;
+  Clock::time_point next_audio_time = start_time;
+  Clock::time_point next_video_time = start_time;
+  int audio_frame_count = 0;
+  int video_frame_count = 0;
+  while (true) {
+    const Clock::time_point next_time =
+        std::min(next_audio_time, next_video_time);
+    if (next_time >= end_time) {
+      break;
+    }
+    clock.Advance(next_time - FakeClock::now());
+
+    if (next_time == next_audio_time) {
+      const std::vector<uint8_t> payload(
+          kAudioFrameSize, static_cast<uint8_t>(audio_frame_count));
+      const FrameId frame_id = audio_sender.GetNextFrameId();
+      const EncodedFrame frame(
+          EncodedFrame::Dependency::kKeyFrame, frame_id, frame_id,
+          RtpTimeTicks() +
+              RtpTimeDelta::FromTicks(int64_t{audio_frame_count} *
+                                      kAudioRtpTimebase /
+                                      kAudioFramesPerSecond),
+          FakeClock::now(), milliseconds(0), payload);
+      if (audio_sender.EnqueueFrame(frame) == Sender::OK) {
+        audio_recorder.OnFrameEnqueued(frame_id, FakeClock::now());
+      }
+      ++audio_frame_count;
+      next_audio_time += kAudioFrameInterval;
+    }
+
+    if (next_time == next_video_time) {
+      const RtpTimeTicks rtp_timestamp =
+          RtpTimeTicks() + RtpTimeDelta::FromTicks(int64_t{video_frame_count} *
+                                                   kVideoRtpTimebase /
+                                                   kVideoFramesPerSecond);
+      // Like a real encoder, drop frames while too much media is in flight.
+      if (video_sender.GetInFlightMediaDuration(rtp_timestamp) <=
+          video_sender.GetMaxInFlightMediaDuration()) {
+        const bool is_key_frame = video_frame_count % kKeyFrameInterval == 0 ||
+                                  video_sender.NeedsKeyFrame();
+        const std::vector<uint8_t> payload(
+            is_key_frame ? kKeyFrameSize : kVideoFrameSize,
+            static_cast<uint8_t>(video_frame_count));
+        const FrameId frame_id = video_sender.GetNextFrameId();
+        const EncodedFrame frame(
+            is_key_frame ? EncodedFrame::Dependency::kKeyFrame
+                         : EncodedFrame::Dependency::kDependent,
+            frame_id, is_key_frame ? frame_id : frame_id - 1, rtp_timestamp,
+            FakeClock::now(), milliseconds(0), payload);
+        if (video_sender.EnqueueFrame(frame) == Sender::OK) {
+          video_recorder.OnFrameEnqueued(frame_id, FakeClock::now());
+        }
+      }
+      ++video_frame_count;
+      next_video_time += kVideoFrameInterval;
+    }
+  }
+
+  // Give the last frames the rest of the playout delay to arrive.
+  clock.Advance(end_time + kTargetPlayoutDelay - FakeClock::now());
+
+  AudioResults results;
+  const std::vector<Clock::duration>& latencies = audio_recorder.latencies();
+  results.frames_played_out = static_cast<int>(latencies.size());
+  if (latencies.size() > 1) {
+    Clock::duration total_difference{};
+    for (size_t i = 1; i < latencies.size(); ++i) {
+      total_difference += std::chrono::abs(latencies[i] - latencies[i - 1]);
+    }
+    results.jitter =
+        total_difference / static_cast<int64_t>(latencies.size() - 1);
+    results.max_latency =
+        *std::max_element(latencies.begin(), latencies.end());
+  }
+  return results;
+}
+
+// Tests that pacing the video keeps its key frames from queuing up at the
+// bottleneck ahead of the audio, which reduces the audio's jitter. In both
+// cases, the SenderPacketRouter sends the audio packets ahead of the video
+// packets in each burst, since their deadlines are nearer.
+TEST(BurstSchedulingE2ETest, PacingVideoReducesAudioJitterDuringKeyFrames) {
+  const AudioResults unpaced = StreamAudioAndVideo(/* pace_video */ false);
+  const AudioResults paced = StreamAudioAndVideo(/* pace_video */ true);
+
+  const int64_t unpaced_jitter_us = to_microseconds(unpaced.jitter).count();
+  const int64_t paced_jitter_us = to_microseconds(paced.jitter).count();
+  const int64_t unpaced_max_ms = to_milliseconds(unpaced.max_latency).count();
+  const int64_t paced_max_ms = to_milliseconds(paced.max_latency).count();
+  OSP_LOG_INFO << "Audio jitter: unpaced=" << unpaced_jitter_us
+               << " us, paced=" << paced_jitter_us
+               << " us; max latency: unpaced=" << unpaced_max_ms
+               << " ms, paced=" << paced_max_ms << " ms";
+  RecordProperty("unpaced_audio_jitter_us",
+                 static_cast<int>(unpaced_jitter_us));
+  RecordProperty("paced_audio_jitter_us", static_cast<int>(paced_jitter_us));
+  RecordProperty("unpaced_audio_max_latency_ms",
+                 static_cast<int>(unpaced_max_ms));
+  RecordProperty("paced_audio_max_latency_ms", static_cast<int>(paced_max_ms));
+
+  // While a key frame holds up the audio's feedback, the audio Sender has to
+  // drop a few frames to keep the media in flight within bounds. Without
+  // pacing, that happens during every key frame. With pacing, it only happens
+  // during the first one, which is sent before there is a network bandwidth
+  // estimate to pace the video to.
+  constexpr int kNumAudioFrames = kDuration.count() * kAudioFramesPerSecond;
+  constexpr int kNumKeyFrames =
+      kDuration.count() * kVideoFramesPerSecond / kKeyFrameInterval;
+  constexpr int kMaxAudioFramesDroppedPerKeyFrame = 4;
+  EXPECT_LE(unpaced.frames_played_out, kNumAudioFrames - kNumKeyFrames);
+  EXPECT_GE(
+      unpaced.frames_played_out,
+      kNumAudioFrames - kNumKeyFrames * kMaxAudioFramesDroppedPerKeyFrame);
+  EXPECT_GE(paced.frames_played_out,
+            kNumAudioFrames - kMaxAudioFramesDroppedPerKeyFrame);
+
+  EXPECT_LT(paced.jitter, unpaced.jitter);
+  EXPECT_LT(paced.max_latency, unpaced.max_latency);
+}
+
+}  // namespace
+}  // namespace openscreen::cast
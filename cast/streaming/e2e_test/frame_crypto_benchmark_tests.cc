@@ -0,0 +1,94 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "cast/streaming/impl/frame_crypto.h"
+#include "cast/streaming/public/frame_id.h"
+#include "gtest/gtest.h"
+#include "platform/base/span.h"
+#include "util/crypto/random_bytes.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+namespace {
+
+// The sizes of the frames encrypted and decrypted: a small audio frame, a
+// typical video frame and a large key frame.
+constexpr size_t kFrameSizes[] = {1024, 100 * 1024, 1024 * 1024};
+
+// The number of bytes processed for each frame size, to get a measurable run
+// time.
+constexpr size_t kBytesPerRun = 256 * 1024 * 1024;
+
+// The payload size of the packets the frames are received in, before their
+// RTP header.
+constexpr size_t kPacketPayloadSize = 1400;
+
+double GetGigabytesPerSecond(std::chrono::steady_clock::duration run_time,
+                             size_t num_bytes) {
+  return num_bytes / std::chrono::duration<double>(run_time).count() / 1e9;
+}
+
+std::string FormatSize(size_t size) {
+  return size >= 1024 * 1024 ? std::to_string(size / (1024 * 1024)) + "MB"
+                             : std::to_string(size / 1024) + "KB";
+}
+
+// Measures the throughput of encrypting whole frames, as the Sender does, and
+// of decrypting them one packet at a time, as the FrameCollector does when the
+// packets arrive.
+TEST(FrameCryptoBenchmark, MeasuresThroughputByFrameSize) {
+  FrameCrypto crypto(GenerateRandomBytes16(), GenerateRandomBytes16());
+  for (size_t frame_size : kFrameSizes) {
+    std::vector<uint8_t> plaintext(frame_size);
+    std::iota(plaintext.begin(), plaintext.end(), 0);
+    std::vector<uint8_t> ciphertext(frame_size);
+    std::vector<uint8_t> decrypted(frame_size);
+    const size_t num_frames = kBytesPerRun / frame_size;
+
+    FrameId frame_id = FrameId::first();
+    auto start_time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_frames; ++i) {
+      crypto.Encrypt(++frame_id, plaintext, ciphertext);
+    }
+    const double encrypt_gbps = GetGigabytesPerSecond(
+        std::chrono::steady_clock::now() - start_time, kBytesPerRun);
+
+    // Decrypts the last frame encrypted above, over and over.
+    start_time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_frames; ++i) {
+      for (size_t offset = 0; offset < frame_size;
+           offset += kPacketPayloadSize) {
+        const size_t size = std::min(kPacketPayloadSize, frame_size - offset);
+        crypto.DecryptAt(frame_id, offset,
+                         ByteView(ciphertext).subspan(offset, size),
+                         ByteBuffer(decrypted).subspan(offset, size));
+      }
+    }
+    const double decrypt_gbps = GetGigabytesPerSecond(
+        std::chrono::steady_clock::now() - start_time, kBytesPerRun);
+
+    const std::string name = FormatSize(frame_size);
+    OSP_LOG_INFO << "FrameCrypto with " << name << " frames: encrypts "
+                 << encrypt_gbps << " GB/s, decrypts " << decrypt_gbps
+                 << " GB/s in " << kPacketPayloadSize << "-byte packets.";
+    RecordProperty("encrypt_" + name + "_megabytes_per_second",
+                   static_cast<int>(encrypt_gbps * 1000));
+    RecordProperty("decrypt_" + name + "_megabytes_per_second",
+                   static_cast<int>(decrypt_gbps * 1000));
+
+    EXPECT_EQ(plaintext, decrypted);
+  }
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -0,0 +1,296 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cast/streaming/impl/compound_rtcp_builder.h"
+#include "cast/streaming/impl/compound_rtcp_parser.h"
+#include "cast/streaming/impl/rtcp_common.h"
+#include "cast/streaming/impl/rtcp_session.h"
+#include "cast/streaming/impl/rtp_defines.h"
+#include "cast/streaming/impl/sender_impl.h"
+#include "cast/streaming/public/encoded_frame.h"
+#include "cast/streaming/public/frame_id.h"
+#include "cast/streaming/public/sender.h"
+#include "cast/streaming/public/session_config.h"
+#include "cast/streaming/sender_packet_router.h"
+#include "cast/streaming/ssrc.h"
+#include "cast/streaming/testing/mock_environment.h"
+#include "gtest/gtest.h"
+#include "platform/base/span.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "platform/test/paths.h"
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+#include "util/read_file.h"
+
+namespace openscreen::cast {
+namespace {
+
+// The SSRCs and maximum feedback frame ID the seed corpus was made with. See
+// compound_rtcp_parser_fuzzer.cc.
+constexpr Ssrc kSenderSsrc = 1;
+constexpr Ssrc kReceiverSsrc = 2;
+constexpr FrameId kMaxFeedbackFrameId = FrameId::first() + 100;
+
+// The recorded Receiver feedback whose NACKs drive the benchmark: runs of
+// whole-frame and single-packet losses over many frames, some frames being
+// ACKed among them.
+constexpr const char* kFeedbackSeeds[] = {
+    "builder_with_lots_of_nacks.bin",
+    "builder_with_lots_of_nacks_and_some_acks.bin",
+    "builder_with_lots_of_nacks_and_some_more_acks.bin",
+    "builder_with_nack_mix.bin",
+    "feedback_with_nacks.bin",
+    "feedback_with_one_nack_and_one_ack.bin",
+};
+
+// The number of times each recorded feedback is replayed, to get a measurable
+// run time.
+constexpr int kNumIterations = 200;
+
+constexpr int kRtpTimebase = 90000;
+constexpr int kRtpTicksPerFrame = kRtpTimebase / 30;
+constexpr milliseconds kTargetPlayoutDelay(400);
+
+// Each frame takes about 25 packets, more than the recorded NACKs refer to.
+constexpr int kFrameSize = 32 * 1024;
+
+// Long enough for a resend to never be considered too recent.
+constexpr seconds kFeedbackDelay(1);
+
+constexpr auto kAesKey =
+    std::array<uint8_t, 16>{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                             0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr auto kCastIvMask =
+    std::array<uint8_t, 16>{{0xf0, 0xe0, 0xd0, 0xc0, 0xb0, 0xa0, 0x90, 0x80,
+                             0x70, 0x60, 0x50, 0x40, 0x30, 0x20, 0x10, 0x00}};
+
+// The time seen by the Sender. It is not a FakeClock, so that advancing it
+// does not run the SenderPacketRouter's tasks: the benchmark pulls the packets
+// from the Sender itself.
+Clock::time_point g_now = Clock::time_point(seconds(1000));
+
+Clock::time_point Now() {
+  return g_now;
+}
+
+// The feedback of a recording, with its frame IDs as offsets from its
+// checkpoint frame.
+struct RecordedFeedback {
+  std::vector<PacketNack> nacks;
+  std::vector<FrameId> acks;
+  int num_frames = 0;
+};
+
+// Collects the feedback of a recorded RTCP packet.
+class FeedbackRecorder : public CompoundRtcpParser::Client {
+ public:
+  FrameId checkpoint = FrameId::leader();
+  std::vector<FrameId> acks;
+  std::vector<PacketNack> nacks;
+
+  // CompoundRtcpParser::Client overrides.
+  void OnReceiverCheckpoint(FrameId frame_id,
+                            std::chrono::milliseconds playout_delay) override {
+    checkpoint = frame_id;
+  }
+  void OnReceiverHasFrames(const std::vector<FrameId>& frame_acks) override {
+    acks = frame_acks;
+  }
+  void OnReceiverIsMissingPackets(
+      const std::vector<PacketNack>& packet_nacks) override {
+    nacks = packet_nacks;
+  }
+};
+
+RecordedFeedback ReadRecordedFeedback(const char* file_name) {
+  // GetTestDataPath() is the "test/data/" directory in the source root.
+  const std::string path = GetTestDataPath() +
+                           "../../cast/streaming/"
+                           "compound_rtcp_parser_fuzzer_seeds/" +
+                           file_name;
+  const std::string seed = ReadEntireFileToString(path);
+  OSP_CHECK(!seed.empty()) << "Missing seed: " << path;
+
+  RtcpSession session(kSenderSsrc, kReceiverSsrc, Clock::time_point{});
+  FeedbackRecorder recorder;
+  CompoundRtcpParser parser(session, recorder);
+  OSP_CHECK(parser.Parse(
+      ByteView(reinterpret_cast<const uint8_t*>(seed.data()), seed.size()),
+      kMaxFeedbackFrameId));
+  OSP_CHECK(!recorder.nacks.empty()) << file_name;
+
+  // Rebase the frame IDs, so that they can be replayed from any checkpoint.
+  RecordedFeedback feedback;
+  const auto rebase = [&](FrameId frame_id) {
+    const int offset = frame_id - recorder.checkpoint;
+    feedback.num_frames = std::max(feedback.num_frames, offset);
+    return FrameId::first() + offset;
+  };
+  for (PacketNack nack : recorder.nacks) {
+    nack.frame_id = rebase(nack.frame_id);
+    feedback.nacks.push_back(nack);
+  }
+  for (FrameId frame_id : recorder.acks) {
+    feedback.acks.push_back(rebase(frame_id));
+  }
+  return feedback;
+}
+
+// Counts the packets the Sender reports as retransmitted.
+class RetransmitCounter : public Sender::Observer {
+ public:
+  int count = 0;
+
+  // Sender::Observer overrides.
+  void OnFrameCanceled(FrameId frame_id) override {}
+  void OnPictureLost() override {}
+  void OnPacketsRetransmitted(int packets) override { count += packets; }
+};
+
+struct ResendResults {
+  double ns_per_feedback = 0;
+  double ns_per_resent_packet = 0;
+  int resent_packets = 0;
+  int reported_retransmits = 0;
+};
+
+// Replays the recorded `feedback` kNumIterations times against a SenderImpl
+// that has just sent the frames it refers to, and measures the cost of
+// handling the feedback, and then of producing every packet to resend.
+ResendResults ReplayFeedback(const RecordedFeedback& feedback) {
+  FakeClock clock(Clock::now());
+  FakeTaskRunner task_runner(clock);
+  testing::NiceMock<MockEnvironment> environment(&Now, task_runner);
+  SenderPacketRouter packet_router(environment);
+  SessionConfig config(kSenderSsrc, kReceiverSsrc, kRtpTimebase,
+                       /* channels */ 1, kTargetPlayoutDelay, kAesKey,
+                       kCastIvMask, /* is_pli_enabled */ false,
+                       StreamType::kVideo);
+  config.max_in_flight_media_duration = seconds(10);
+  SenderImpl sender(environment, packet_router, config,
+                    RtpPayloadType::kVideoVp8);
+  RetransmitCounter counter;
+  sender.SetObserver(&counter);
+  SenderPacketRouter::Sender& router_sender = sender;
+
+  RtcpSession receiver_session(kSenderSsrc, kReceiverSsrc, Now());
+  CompoundRtcpBuilder builder(receiver_session);
+  builder.SetPlayoutDelay(kTargetPlayoutDelay);
+  std::vector<uint8_t> rtcp_buffer(kMaxRtpPacketSizeForIpv4UdpOnEthernet);
+  std::vector<uint8_t> rtp_buffer(packet_router.max_packet_size());
+  const std::vector<uint8_t> payload(kFrameSize, 0xab);
+
+  // Returns the number of packets the Sender had to send.
+  const auto send_all_packets = [&] {
+    int count = 0;
+    while (!router_sender.GetRtpPacketForImmediateSend(Now(), rtp_buffer)
+                .empty()) {
+      ++count;
+    }
+    return count;
+  };
+  const auto receive_feedback = [&] {
+    g_now += kFeedbackDelay;
+    router_sender.OnReceivedRtcpPacket(
+        Now(), builder.BuildPacket(Now(), rtcp_buffer));
+  };
+
+  ResendResults results;
+  std::chrono::steady_clock::duration feedback_time{};
+  std::chrono::steady_clock::duration resend_time{};
+  for (int i = 0; i < kNumIterations; ++i) {
+    // Send the frames the feedback refers to.
+    const FrameId checkpoint = sender.GetNextFrameId() - 1;
+    for (int j = 0; j < feedback.num_frames; ++j) {
+      EncodedFrame frame;
+      frame.frame_id = sender.GetNextFrameId();
+      frame.dependency = frame.frame_id == FrameId::first()
+                             ? EncodedFrame::Dependency::kKeyFrame
+                             : EncodedFrame::Dependency::kDependent;
+      frame.referenced_frame_id =
+          std::max(frame.frame_id - 1, FrameId::first());
+      frame.rtp_timestamp =
+          RtpTimeTicks() + RtpTimeDelta::FromTicks(
+                               kRtpTicksPerFrame *
+                               (frame.frame_id - FrameId::first() + 1));
+      frame.reference_time = Now();
+      frame.data = payload;
+      OSP_CHECK_EQ(sender.EnqueueFrame(frame), Sender::OK);
+    }
+    send_all_packets();
+
+    // Replay the recorded feedback against these frames.
+    std::vector<PacketNack> nacks = feedback.nacks;
+    for (PacketNack& nack : nacks) {
+      nack.frame_id = checkpoint + (nack.frame_id - FrameId::first());
+    }
+    std::vector<FrameId> acks = feedback.acks;
+    for (FrameId& ack : acks) {
+      ack = checkpoint + (ack - FrameId::first());
+    }
+    builder.SetCheckpointFrame(checkpoint);
+    builder.IncludeFeedbackInNextPacket(std::move(nacks), std::move(acks));
+
+    auto start_time = std::chrono::steady_clock::now();
+    receive_feedback();
+    feedback_time += std::chrono::steady_clock::now() - start_time;
+
+    start_time = std::chrono::steady_clock::now();
+    results.resent_packets += send_all_packets();
+    resend_time += std::chrono::steady_clock::now() - start_time;
+
+    // ACK every frame, to start the next iteration from a clean slate.
+    builder.SetCheckpointFrame(sender.GetNextFrameId() - 1);
+    receive_feedback();
+    OSP_CHECK_EQ(sender.GetInFlightFrameCount(), 0u);
+  }
+  sender.SetObserver(nullptr);
+
+  results.ns_per_feedback =
+      std::chrono::duration<double, std::nano>(feedback_time).count() /
+      kNumIterations;
+  results.ns_per_resent_packet =
+      std::chrono::duration<double, std::nano>(resend_time).count() /
+      std::max(results.resent_packets, 1);
+  results.reported_retransmits = counter.count;
+  return results;
+}
+
+// Measures how quickly a Sender handles recorded NACK feedback, and produces
+// the packets it asks to be resent.
+TEST(NackResendBenchmark, ReplaysRecordedNackPatterns) {
+  for (const char* file_name : kFeedbackSeeds) {
+    const RecordedFeedback feedback = ReadRecordedFeedback(file_name);
+    const ResendResults results = ReplayFeedback(feedback);
+
+    const std::string name(file_name, std::string(file_name).find('.'));
+    OSP_LOG_INFO << name << ": " << feedback.nacks.size() << " NACKs over "
+                 << feedback.num_frames << " frames, "
+                 << results.resent_packets / kNumIterations
+                 << " packets resent, " << results.ns_per_feedback
+                 << " ns per feedback, " << results.ns_per_resent_packet
+                 << " ns per resent packet.";
+    RecordProperty(name + "_ns_per_feedback",
+                   static_cast<int>(results.ns_per_feedback));
+    RecordProperty(name + "_ns_per_resent_packet",
+                   static_cast<int>(results.ns_per_resent_packet));
+
+    // Every packet the Sender produced was a retransmission it reported.
+    EXPECT_GT(results.resent_packets, 0) << name;
+    EXPECT_EQ(results.reported_retransmits, results.resent_packets) << name;
+  }
+}
+
+}  // namespace
+}  // namespace openscreen::cast
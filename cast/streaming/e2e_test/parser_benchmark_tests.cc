@@ -0,0 +1,161 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "cast/streaming/impl/compound_rtcp_parser.h"
+#include "cast/streaming/impl/rtcp_session.h"
+#include "cast/streaming/impl/rtp_packet_parser.h"
+#include "cast/streaming/public/frame_id.h"
+#include "cast/streaming/ssrc.h"
+#include "gtest/gtest.h"
+#include "platform/api/time.h"
+#include "platform/base/span.h"
+#include "platform/test/paths.h"
+#include "util/osp_logging.h"
+#include "util/read_file.h"
+
+namespace openscreen::cast {
+namespace {
+
+// The SSRCs and maximum feedback frame ID the seed corpora were made with. See
+// rtp_packet_parser_fuzzer.cc and compound_rtcp_parser_fuzzer.cc.
+constexpr Ssrc kRtpSenderSsrcInSeedCorpus = 0x01020304;
+constexpr Ssrc kRtcpSenderSsrcInSeedCorpus = 1;
+constexpr Ssrc kRtcpReceiverSsrcInSeedCorpus = 2;
+constexpr FrameId kMaxFeedbackFrameId = FrameId::first() + 100;
+
+constexpr const char* kRtpSeeds[] = {
+    "rtp_packet_for_key_frame.bin",
+    "rtp_packet_for_key_frame_with_bad_packet_id.bin",
+    "rtp_packet_for_key_frame_with_latency_ext.bin",
+    "rtp_packet_for_key_frame_with_multiple_ext.bin",
+    "rtp_packet_for_non_key_frame_with_rfid.bin",
+    "rtp_packet_for_non_key_frame_without_rfid.bin",
+    "rtp_packet_trunc_to_18_bytes.bin",
+    "rtp_packet_trunc_to_1_byte.bin",
+    "rtp_packet_trunc_to_22_bytes.bin",
+    "rtp_packet_trunc_to_33_bytes.bin",
+    "rtp_packet_trunc_to_34_bytes.bin",
+};
+
+constexpr const char* kRtcpSeeds[] = {
+    "builder_basics.bin",
+    "builder_including_picture_loss_indicator.bin",
+    "builder_including_receiver_report_block.bin",
+    "builder_with_lots_of_nacks.bin",
+    "builder_with_lots_of_nacks_and_some_acks.bin",
+    "builder_with_lots_of_nacks_and_some_more_acks.bin",
+    "builder_with_multiple_acks.bin",
+    "builder_with_nack_mix.bin",
+    "builder_with_one_ack.bin",
+};
+
+// The number of times each corpus is parsed, to get a measurable run time.
+constexpr int kNumIterations = 20'000;
+
+// Reads the files of a fuzzer's seed corpus, which is a directory next to the
+// fuzzer's build target in cast/streaming.
+template <size_t N>
+std::vector<std::string> ReadSeedCorpus(const char* directory,
+                                        const char* const (&file_names)[N]) {
+  // GetTestDataPath() is the "test/data/" directory in the source root.
+  const std::string path =
+      GetTestDataPath() + "../../cast/streaming/" + directory + "/";
+  std::vector<std::string> seeds;
+  for (const char* file_name : file_names) {
+    seeds.push_back(ReadEntireFileToString(path + file_name));
+    OSP_CHECK(!seeds.back().empty()) << "Missing seed: " << path << file_name;
+  }
+  return seeds;
+}
+
+ByteView AsByteView(const std::string& seed) {
+  return ByteView(reinterpret_cast<const uint8_t*>(seed.data()), seed.size());
+}
+
+double GetNanosecondsPerPacket(Clock::duration run_time, size_t num_packets) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(run_time)
+             .count() /
+         static_cast<double>(num_packets * kNumIterations);
+}
+
+// Measures the cost of parsing the RTP packets of the seed corpus, in batches
+// as they would come from one batched socket read.
+TEST(ParserBenchmark, MeasuresRtpPacketParsingCost) {
+  const std::vector<std::string> seeds =
+      ReadSeedCorpus("rtp_packet_parser_fuzzer_seeds", kRtpSeeds);
+  std::vector<ByteView> packets;
+  for (const std::string& seed : seeds) {
+    packets.push_back(AsByteView(seed));
+  }
+  std::vector<std::optional<RtpPacketParser::ParseResult>> results(
+      packets.size());
+
+  RtpPacketParser parser(kRtpSenderSsrcInSeedCorpus);
+  int num_parsed = 0;
+  const Clock::time_point start_time = Clock::now();
+  for (int i = 0; i < kNumIterations; ++i) {
+    num_parsed += parser.ParseBatch(packets, results);
+  }
+  const double ns_per_packet =
+      GetNanosecondsPerPacket(Clock::now() - start_time, packets.size());
+
+  OSP_LOG_INFO << "RTP parsing cost " << ns_per_packet << " ns per packet.";
+  RecordProperty("rtp_parse_ns_per_packet", static_cast<int>(ns_per_packet));
+
+  // The corpus has both well-formed and corrupt packets.
+  EXPECT_GT(num_parsed, 0);
+  EXPECT_LT(num_parsed, static_cast<int>(packets.size()) * kNumIterations);
+}
+
+// Measures the cost of parsing the compound RTCP packets of the seed corpus,
+// including dispatching their contents to a Client.
+TEST(ParserBenchmark, MeasuresCompoundRtcpPacketParsingCost) {
+  const std::vector<std::string> seeds =
+      ReadSeedCorpus("compound_rtcp_parser_fuzzer_seeds", kRtcpSeeds);
+
+  // Counts the NACKs, so that their parsing cannot be optimized away.
+  class NackCountingClient : public CompoundRtcpParser::Client {
+   public:
+    void OnReceiverIsMissingPackets(
+        const std::vector<PacketNack>& nacks) override {
+      num_nacks += nacks.size();
+    }
+
+    size_t num_nacks = 0;
+  };
+  NackCountingClient client;
+  RtcpSession session(kRtcpSenderSsrcInSeedCorpus,
+                      kRtcpReceiverSsrcInSeedCorpus, Clock::time_point{});
+
+  int num_parsed = 0;
+  Clock::duration run_time{};
+  for (const std::string& seed : seeds) {
+    // Each seed gets its own parser, which would otherwise ignore the seeds
+    // having older Receiver reference times than those parsed before them.
+    CompoundRtcpParser parser(session, client);
+    const Clock::time_point start_time = Clock::now();
+    for (int i = 0; i < kNumIterations; ++i) {
+      num_parsed += parser.Parse(AsByteView(seed), kMaxFeedbackFrameId);
+    }
+    run_time += Clock::now() - start_time;
+  }
+  const double ns_per_packet = GetNanosecondsPerPacket(run_time, seeds.size());
+
+  OSP_LOG_INFO << "Compound RTCP parsing cost " << ns_per_packet
+               << " ns per packet.";
+  RecordProperty("rtcp_parse_ns_per_packet", static_cast<int>(ns_per_packet));
+
+  EXPECT_EQ(static_cast<int>(seeds.size()) * kNumIterations, num_parsed);
+  EXPECT_GT(client.num_nacks, 0u);
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -0,0 +1,220 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cast/streaming/public/environment.h"
+#include "gtest/gtest.h"
+#include "platform/api/task_runner.h"
+#include "platform/base/ip_address.h"
+#include "platform/base/udp_packet.h"
+#include "platform/impl/platform_client_posix.h"
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+namespace {
+
+// Bursts of full-size packets, as a Sender sends a large video frame.
+constexpr int kPacketSize = 1400;
+constexpr int kPacketsPerBurst = 64;
+constexpr int kNumBursts = 500;
+constexpr int kNumPackets = kPacketsPerBurst * kNumBursts;
+
+// Large enough to hold a whole burst, so that no packet is dropped while the
+// receiving side catches up.
+constexpr size_t kReceiveBufferSize = 1 << 20;
+
+// How long to wait for a burst to be received before giving up on it.
+constexpr seconds kBurstTimeout(5);
+
+// The number of reads delivered by the Environment, which gets the arrival
+// time of the packets once per read. Only accessed on the TaskRunner.
+int g_num_reads = 0;
+
+Clock::time_point CountingNow() {
+  ++g_num_reads;
+  return Clock::now();
+}
+
+// Counts every packet delivered to it, and the largest number delivered from
+// one read of the socket.
+class CountingConsumer : public Environment::PacketConsumer {
+ public:
+  ~CountingConsumer() override = default;
+
+  int packets_received() const { return packets_received_.load(); }
+  int largest_read() const { return largest_read_; }
+
+  // Environment::PacketConsumer implementation.
+  void OnReceivedPacket(const IPEndpoint& source,
+                        Clock::time_point arrival_time,
+                        UdpPacket packet) override {
+    if (g_num_reads != last_read_) {
+      last_read_ = g_num_reads;
+      packets_in_read_ = 0;
+    }
+    largest_read_ = std::max(largest_read_, ++packets_in_read_);
+    ++packets_received_;
+  }
+
+ private:
+  std::atomic<int> packets_received_{0};
+  int last_read_ = 0;
+  int packets_in_read_ = 0;
+  int largest_read_ = 0;
+};
+
+struct ReceiveResults {
+  int packets_received = 0;
+  int num_reads = 0;
+  int largest_read = 0;
+  double packets_per_second = 0;
+  double cpu_ns_per_packet = 0;
+};
+
+// Returns the CPU time consumed so far by all threads of this process: the
+// sender, the network thread reading the socket, and the TaskRunner delivering
+// the packets.
+Clock::duration GetProcessCpuTime() {
+  timespec now{};
+  OSP_CHECK_EQ(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now), 0);
+  return std::chrono::duration_cast<Clock::duration>(
+      std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec));
+}
+
+class ReceiveBatchBenchmark : public testing::Test {
+ public:
+  ReceiveBatchBenchmark() {
+    PlatformClientPosix::Create(milliseconds(10));
+    task_runner_ = &PlatformClientPosix::GetInstance()->GetTaskRunner();
+  }
+
+  ~ReceiveBatchBenchmark() override { PlatformClientPosix::ShutDown(); }
+
+ protected:
+  // Sends kNumPackets to an Environment that reads up to `batch_size` packets
+  // per wakeup, or its default if zero, and measures how quickly they are
+  // received.
+  ReceiveResults Run(size_t batch_size) {
+    std::unique_ptr<Environment> environment;
+    CountingConsumer consumer;
+    RunOnTaskRunner([&] {
+      g_num_reads = 0;
+      environment = std::make_unique<Environment>(
+          &CountingNow, *task_runner_, IPEndpoint{IPAddress(127, 0, 0, 1), 0});
+      if (batch_size > 0) {
+        environment->SetReceiveBatchSize(batch_size);
+      }
+      environment->SetReceiveBufferSize(kReceiveBufferSize);
+      environment->ConsumeIncomingPackets(&consumer);
+    });
+    const IPEndpoint endpoint = environment->GetBoundLocalEndpoint();
+
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    OSP_CHECK_GE(fd, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(endpoint.port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    const std::vector<uint8_t> payload(kPacketSize, 0xab);
+
+    const Clock::duration start_cpu_time = GetProcessCpuTime();
+    const Clock::time_point start_time = Clock::now();
+    for (int i = 0; i < kNumBursts; ++i) {
+      for (int j = 0; j < kPacketsPerBurst; ++j) {
+        OSP_CHECK_EQ(sendto(fd, payload.data(), payload.size(), 0,
+                            reinterpret_cast<const sockaddr*>(&address),
+                            sizeof(address)),
+                     static_cast<ssize_t>(payload.size()));
+      }
+      const int expected = (i + 1) * kPacketsPerBurst;
+      const Clock::time_point deadline = Clock::now() + kBurstTimeout;
+      while (consumer.packets_received() < expected &&
+             Clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+    }
+    const Clock::duration run_time = Clock::now() - start_time;
+    const Clock::duration cpu_time = GetProcessCpuTime() - start_cpu_time;
+    close(fd);
+
+    ReceiveResults results;
+    RunOnTaskRunner([&] {
+      environment.reset();
+      results.num_reads = g_num_reads;
+    });
+    results.packets_received = consumer.packets_received();
+    results.largest_read = consumer.largest_read();
+    results.packets_per_second =
+        results.packets_received /
+        std::chrono::duration<double>(run_time).count();
+    results.cpu_ns_per_packet =
+        to_nanoseconds(cpu_time).count() /
+        static_cast<double>(std::max(results.packets_received, 1));
+    return results;
+  }
+
+  void Report(const char* name, const ReceiveResults& results) {
+    OSP_LOG_INFO << name << ": " << results.packets_received << " packets in "
+                 << results.num_reads << " reads (at most "
+                 << results.largest_read << " per read), "
+                 << static_cast<int>(results.packets_per_second)
+                 << " packets/s, "
+                 << static_cast<int>(results.cpu_ns_per_packet)
+                 << " ns CPU per packet.";
+    RecordProperty(std::string(name) + "_packets_per_second",
+                   static_cast<int>(results.packets_per_second));
+    RecordProperty(std::string(name) + "_cpu_ns_per_packet",
+                   static_cast<int>(results.cpu_ns_per_packet));
+    RecordProperty(std::string(name) + "_packets_per_read",
+                   static_cast<int>(results.packets_received /
+                                    std::max(results.num_reads, 1)));
+  }
+
+  // Runs `task` on the TaskRunner, and waits for it to complete.
+  template <typename Task>
+  void RunOnTaskRunner(Task task) {
+    std::promise<void> done_promise;
+    std::future<void> done_future = done_promise.get_future();
+    task_runner_->PostTask([&task, &done_promise] {
+      task();
+      done_promise.set_value();
+    });
+    done_future.wait();
+  }
+
+  TaskRunner* task_runner_ = nullptr;
+};
+
+// Measures the rate at which an Environment receives bursts of packets, reading
+// one packet per wakeup versus its default batch size.
+TEST_F(ReceiveBatchBenchmark, ComparesPacketsPerSecond) {
+  const ReceiveResults unbatched = Run(1);
+  Report("unbatched", unbatched);
+  const ReceiveResults batched = Run(0);
+  Report("batched", batched);
+
+  EXPECT_EQ(kNumPackets, unbatched.packets_received);
+  EXPECT_EQ(kNumPackets, batched.packets_received);
+  EXPECT_EQ(1, unbatched.largest_read);
+  // By default, the Environment drains a burst with more than one packet per
+  // read.
+  EXPECT_LT(1, batched.largest_read);
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -0,0 +1,240 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+#include <time.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cast/streaming/impl/receiver_impl.h"
+#include "cast/streaming/impl/receiver_packet_router.h"
+#include "cast/streaming/public/encoded_frame.h"
+#include "cast/streaming/public/environment.h"
+#include "cast/streaming/public/frame_id.h"
+#include "cast/streaming/public/receiver.h"
+#include "cast/streaming/public/sender_engine.h"
+#include "cast/streaming/public/session_config.h"
+#include "cast/streaming/rtp_time.h"
+#include "gtest/gtest.h"
+#include "platform/api/task_runner.h"
+#include "platform/base/ip_address.h"
+#include "platform/impl/platform_client_posix.h"
+#include "platform/impl/task_runner.h"
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+namespace {
+
+// Each session streams 8 Mbps of 30 FPS video, with a key frame every second.
+constexpr int kSessionBitrate = 8'000'000;
+constexpr int kFramesPerSecond = 30;
+constexpr int kFrameSize = kSessionBitrate / 8 / kFramesPerSecond;
+constexpr microseconds kFrameInterval(1'000'000 / kFramesPerSecond);
+constexpr int kKeyFrameInterval = kFramesPerSecond;
+constexpr int kRtpTimebase = 90000;
+
+// The load placed on the one shard under test.
+constexpr int kNumSessions = 4;
+constexpr int kNumFrames = 2 * kFramesPerSecond;
+
+constexpr Ssrc kSenderSsrc = 1;
+constexpr Ssrc kReceiverSsrc = 2;
+constexpr milliseconds kTargetPlayoutDelay(400);
+constexpr auto kAesKey =
+    std::array<uint8_t, 16>{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                             0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr auto kCastIvMask =
+    std::array<uint8_t, 16>{{0xf0, 0xe0, 0xd0, 0xc0, 0xb0, 0xa0, 0x90, 0x80,
+                             0x70, 0x60, 0x50, 0x40, 0x30, 0x20, 0x10, 0x00}};
+constexpr SenderEngine::ChannelId kChannel = 1;
+
+SessionConfig MakeSessionConfig() {
+  return SessionConfig(kSenderSsrc, kReceiverSsrc, kRtpTimebase,
+                       /* channels */ 1, kTargetPlayoutDelay, kAesKey,
+                       kCastIvMask);
+}
+
+// Returns the CPU time consumed so far by the thread running `task_runner`.
+Clock::duration GetThreadCpuTime(TaskRunner& task_runner) {
+  std::promise<Clock::duration> cpu_time_promise;
+  std::future<Clock::duration> cpu_time_future =
+      cpu_time_promise.get_future();
+  task_runner.PostTask([&cpu_time_promise] {
+    timespec now{};
+    OSP_CHECK_EQ(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now), 0);
+    cpu_time_promise.set_value(
+        std::chrono::duration_cast<Clock::duration>(
+            std::chrono::seconds(now.tv_sec) +
+            std::chrono::nanoseconds(now.tv_nsec)));
+  });
+  return cpu_time_future.get();
+}
+
+// A local Receiver that consumes, and counts, every frame it completes.
+class LocalReceiver : public Receiver::Consumer {
+ public:
+  explicit LocalReceiver(TaskRunner& task_runner)
+      : environment_(&Clock::now,
+                     task_runner,
+                     IPEndpoint{IPAddress(127, 0, 0, 1), 0}),
+        packet_router_(environment_),
+        receiver_(environment_, packet_router_, MakeSessionConfig()) {
+    receiver_.SetConsumer(this);
+  }
+
+  ~LocalReceiver() override { receiver_.SetConsumer(nullptr); }
+
+  IPEndpoint endpoint() const { return environment_.GetBoundLocalEndpoint(); }
+  int frames_consumed() const { return frames_consumed_.load(); }
+
+  // Receiver::Consumer override.
+  void OnFramesReady(size_t next_frame_buffer_size) override {
+    std::optional<size_t> buffer_size = next_frame_buffer_size;
+    while (buffer_size) {
+      buffer_.resize(*buffer_size);
+      receiver_.ConsumeNextFrame(buffer_);
+      ++frames_consumed_;
+      buffer_size = receiver_.AdvanceToNextFrame();
+    }
+  }
+
+ private:
+  Environment environment_;
+  ReceiverPacketRouter packet_router_;
+  ReceiverImpl receiver_;
+  std::vector<uint8_t> buffer_;
+  std::atomic<int> frames_consumed_{0};
+};
+
+// NOTE: The receivers all run on the PlatformClientPosix's TaskRunner, while
+// the one shard of the SenderEngine runs on its own thread, whose CPU time is
+// what this test measures.
+class SenderEngineE2ETest : public testing::Test {
+ public:
+  SenderEngineE2ETest() {
+    PlatformClientPosix::Create(milliseconds(10));
+    receivers_task_runner_ =
+        &PlatformClientPosix::GetInstance()->GetTaskRunner();
+  }
+
+  ~SenderEngineE2ETest() override {
+    std::promise<void> destroyed_promise;
+    std::future<void> destroyed_future = destroyed_promise.get_future();
+    receivers_task_runner_->PostTask([this, &destroyed_promise] {
+      receivers_.clear();
+      destroyed_promise.set_value();
+    });
+    destroyed_future.wait();
+    PlatformClientPosix::ShutDown();
+  }
+
+ protected:
+  void CreateReceivers(int count) {
+    std::promise<void> created_promise;
+    std::future<void> created_future = created_promise.get_future();
+    receivers_task_runner_->PostTask([this, count, &created_promise] {
+      for (int i = 0; i < count; ++i) {
+        receivers_.push_back(
+            std::make_unique<LocalReceiver>(*receivers_task_runner_));
+      }
+      created_promise.set_value();
+    });
+    created_future.wait();
+  }
+
+  TaskRunner* receivers_task_runner_ = nullptr;
+  std::vector<std::unique_ptr<LocalReceiver>> receivers_;
+};
+
+// Streams kNumSessions 8 Mbps sessions from one shard, and reports how many
+// such sessions one core could sustain, given the shard thread's CPU usage.
+TEST_F(SenderEngineE2ETest, MeasuresConcurrentSessionsPerCore) {
+  TaskRunnerImpl shard_task_runner(&Clock::now);
+  std::thread shard_thread([&shard_task_runner] {
+    shard_task_runner.RunUntilStopped();
+  });
+
+  // Like any Environment, the shard's must be created on its own TaskRunner.
+  std::promise<std::unique_ptr<Environment>> environment_promise;
+  std::future<std::unique_ptr<Environment>> environment_future =
+      environment_promise.get_future();
+  shard_task_runner.PostTask([&shard_task_runner, &environment_promise] {
+    environment_promise.set_value(std::make_unique<Environment>(
+        &Clock::now, shard_task_runner,
+        IPEndpoint{IPAddress(127, 0, 0, 1), 0}));
+  });
+  std::vector<std::unique_ptr<Environment>> shard_environments;
+  shard_environments.push_back(environment_future.get());
+  auto engine = std::make_unique<SenderEngine>(std::move(shard_environments),
+                                               2 * kNumSessions *
+                                                   kSessionBitrate);
+
+  CreateReceivers(kNumSessions);
+  for (const std::unique_ptr<LocalReceiver>& receiver : receivers_) {
+    engine->AddSender(kChannel, receiver->endpoint(), MakeSessionConfig(),
+                      RtpPayloadType::kVideoVp8);
+  }
+
+  const std::vector<uint8_t> payload(kFrameSize, 0xab);
+  const Clock::duration start_cpu_time = GetThreadCpuTime(shard_task_runner);
+  const Clock::time_point start_time = Clock::now();
+  for (int i = 0; i < kNumFrames; ++i) {
+    const FrameId frame_id = FrameId::first() + i;
+    const bool is_key_frame =
+        i % kKeyFrameInterval == 0 || engine->NeedsKeyFrame(kChannel);
+    engine->PublishFrame(
+        kChannel,
+        std::make_shared<EncodedFrame>(
+            is_key_frame ? EncodedFrame::Dependency::kKeyFrame
+                         : EncodedFrame::Dependency::kDependent,
+            frame_id, is_key_frame ? frame_id : frame_id - 1,
+            RtpTimeTicks() + RtpTimeDelta::FromTicks(
+                                 int64_t{i} * kRtpTimebase / kFramesPerSecond),
+            Clock::now(), milliseconds(0), payload));
+    const Clock::time_point next_frame_time =
+        start_time + (i + 1) * kFrameInterval;
+    std::this_thread::sleep_for(next_frame_time - Clock::now());
+  }
+  const Clock::duration wall_time = Clock::now() - start_time;
+  const Clock::duration cpu_time =
+      GetThreadCpuTime(shard_task_runner) - start_cpu_time;
+
+  // Give the receivers the rest of the playout delay to catch up.
+  std::this_thread::sleep_for(kTargetPlayoutDelay);
+
+  engine.reset();
+  shard_task_runner.RequestStopSoon();
+  shard_thread.join();
+
+  const double sessions_per_core =
+      kNumSessions * to_microseconds(wall_time).count() /
+      static_cast<double>(std::max<int64_t>(to_microseconds(cpu_time).count(),
+                                            1));
+  OSP_LOG_INFO << "Shard thread used " << to_milliseconds(cpu_time).count()
+               << " ms of CPU to stream " << kNumSessions << " sessions for "
+               << to_milliseconds(wall_time).count()
+               << " ms: about " << static_cast<int>(sessions_per_core)
+               << " concurrent 8 Mbps sessions per core.";
+  RecordProperty("sessions_per_core", static_cast<int>(sessions_per_core));
+
+  // Sanity-check that the sessions were really streaming, without requiring
+  // every frame to arrive over a loaded loopback interface.
+  for (const std::unique_ptr<LocalReceiver>& receiver : receivers_) {
+    EXPECT_GT(receiver->frames_consumed(), kNumFrames / 2);
+  }
+  EXPECT_GT(sessions_per_core, 0);
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -0,0 +1,227 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "cast/streaming/impl/clock_offset_estimator.h"
+#include "cast/streaming/impl/statistics_analyzer.h"
+#include "cast/streaming/impl/statistics_collector.h"
+#include "cast/streaming/impl/statistics_common.h"
+#include "cast/streaming/public/frame_id.h"
+#include "cast/streaming/public/statistics.h"
+#include "cast/streaming/rtp_time.h"
+#include "gtest/gtest.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/big_endian.h"
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+namespace {
+
+// The synthetic stream: 30 FPS video at 8 Mbps, sent in packets of about 1 KB,
+// for one minute.
+constexpr int kBitrate = 8'000'000;
+constexpr int kFramesPerSecond = 30;
+constexpr int kPacketSize = 1000;
+constexpr int kPacketsPerFrame = kBitrate / 8 / kFramesPerSecond / kPacketSize;
+constexpr microseconds kFrameInterval(1'000'000 / kFramesPerSecond);
+constexpr int kNumFrames = 60 * kFramesPerSecond;
+constexpr int kRtpTimebase = 90000;
+constexpr milliseconds kNetworkLatency(20);
+
+// The Receiver's events for a frame arrive in its RTCP reports, some time after
+// the frame was sent.
+constexpr int kReceiverLogDelayInFrames = 3;
+
+// The number of times each configuration is run. The fastest run is used, to
+// filter out noise from the rest of the system.
+constexpr int kNumRuns = 3;
+
+// The size of the RTP header, up to and including the Cast-specific packet ID
+// fields that StatisticsCollector parses.
+constexpr int kRtpHeaderSize = 18;
+
+class StatsClient : public SenderStatsClient {
+ public:
+  void OnStatisticsUpdated(const SenderStats& updated_stats) override {
+    last_stats = updated_stats;
+  }
+
+  std::optional<SenderStats> last_stats;
+};
+
+// Streams the synthetic stream through a StatisticsAnalyzer, as a Sender
+// would, and reports the time per packet spent on statistics.
+class StatisticsBenchmark : public testing::Test {
+ protected:
+  // Plays the synthetic stream on a fake clock, and returns the real time
+  // taken. If `enable_statistics`, each frame and packet is reported to a
+  // StatisticsAnalyzer, along with the events a Receiver would log for it.
+  Clock::duration Run(bool enable_statistics) {
+    FakeClock clock(Clock::now());
+    FakeTaskRunner task_runner(clock);
+    start_time_ = FakeClock::now();
+    StatsClient stats_client;
+    std::unique_ptr<StatisticsAnalyzer> analyzer;
+    StatisticsCollector* collector = nullptr;
+    if (enable_statistics) {
+      analyzer = std::make_unique<StatisticsAnalyzer>(
+          &stats_client, &FakeClock::now, task_runner,
+          ClockOffsetEstimator::Create());
+      analyzer->ScheduleAnalysis();
+      collector = analyzer->statistics_collector();
+    }
+
+    const Clock::time_point start_time = Clock::now();
+    for (int i = 0; i < kNumFrames; ++i) {
+      SendFrame(i, collector);
+      if (collector && i >= kReceiverLogDelayInFrames) {
+        ReportReceiverEvents(i - kReceiverLogDelayInFrames, *collector);
+      }
+      // Runs the analysis, when it is due.
+      clock.Advance(kFrameInterval);
+    }
+    const Clock::duration run_time = Clock::now() - start_time;
+
+    if (collector) {
+      EXPECT_EQ(0u, collector->dropped_packet_events());
+      EXPECT_EQ(0u, collector->dropped_frame_events());
+      EXPECT_TRUE(stats_client.last_stats);
+      if (stats_client.last_stats) {
+        const SenderStats::StatisticsList& stats =
+            stats_client.last_stats->video_statistics;
+        EXPECT_LT(0.9 * kNumFrames * kPacketsPerFrame,
+                  stats[static_cast<int>(StatisticType::kNumPacketsSent)]);
+        EXPECT_LT(0, stats[static_cast<int>(
+                         StatisticType::kAvgNetworkLatencyMs)]);
+      }
+    }
+    return run_time;
+  }
+
+  // Packetizes frame `i`, and reports the Sender's events for it to
+  // `collector`, if any.
+  void SendFrame(int i, StatisticsCollector* collector) {
+    const RtpTimeTicks rtp_timestamp = GetRtpTimestamp(i);
+    const Clock::time_point capture_time = GetCaptureTime(i);
+    if (collector) {
+      collector->CollectFrameEvent(MakeFrameEvent(
+          i, StatisticsEvent::Type::kFrameCaptureBegin, capture_time));
+      collector->CollectFrameEvent(
+          MakeFrameEvent(i, StatisticsEvent::Type::kFrameCaptureEnd,
+                         capture_time + milliseconds(2)));
+      collector->CollectFrameEvent(
+          MakeFrameEvent(i, StatisticsEvent::Type::kFrameEncoded,
+                         capture_time + milliseconds(5)));
+    }
+
+    for (int packet_id = 0; packet_id < kPacketsPerFrame; ++packet_id) {
+      WriteBigEndian<uint32_t>(rtp_timestamp.lower_32_bits(), &header_[4]);
+      WriteBigEndian<uint16_t>(packet_id, &header_[14]);
+      WriteBigEndian<uint16_t>(kPacketsPerFrame - 1, &header_[16]);
+      if (collector) {
+        collector->CollectPacketSentEvent(
+            header_, payload_,
+            PacketMetadata{.stream_type = StreamType::kVideo,
+                           .rtp_timestamp = rtp_timestamp});
+      }
+    }
+  }
+
+  // Reports the events the Receiver logged for frame `i`, as they would be
+  // received in its RTCP reports.
+  void ReportReceiverEvents(int i, StatisticsCollector& collector) {
+    const Clock::time_point receive_time = GetCaptureTime(i) + kNetworkLatency;
+    for (int packet_id = 0; packet_id < kPacketsPerFrame; ++packet_id) {
+      PacketEvent event;
+      event.frame_id = FrameId::first() + i;
+      event.type = StatisticsEvent::Type::kPacketReceived;
+      event.media_type = StatisticsEvent::MediaType::kVideo;
+      event.rtp_timestamp = GetRtpTimestamp(i);
+      event.timestamp = receive_time;
+      event.received_timestamp = FakeClock::now();
+      event.packet_id = static_cast<uint16_t>(packet_id);
+      event.max_packet_id = kPacketsPerFrame - 1;
+      collector.CollectPacketEvent(event);
+    }
+    collector.CollectFrameEvent(
+        MakeFrameEvent(i, StatisticsEvent::Type::kFrameAckSent, receive_time));
+    collector.CollectFrameEvent(
+        MakeFrameEvent(i, StatisticsEvent::Type::kFrameAckReceived,
+                       receive_time + kNetworkLatency));
+    collector.CollectFrameEvent(
+        MakeFrameEvent(i, StatisticsEvent::Type::kFramePlayedOut,
+                       GetCaptureTime(i) + milliseconds(100)));
+  }
+
+  RtpTimeTicks GetRtpTimestamp(int i) const {
+    return RtpTimeTicks() + RtpTimeDelta::FromTicks(int64_t{i} * kRtpTimebase /
+                                                    kFramesPerSecond);
+  }
+
+  Clock::time_point GetCaptureTime(int i) const {
+    return start_time_ + i * kFrameInterval;
+  }
+
+  FrameEvent MakeFrameEvent(int i,
+                            StatisticsEvent::Type type,
+                            Clock::time_point timestamp) const {
+    FrameEvent event;
+    event.frame_id = FrameId::first() + i;
+    event.type = type;
+    event.media_type = StatisticsEvent::MediaType::kVideo;
+    event.rtp_timestamp = GetRtpTimestamp(i);
+    event.size = kPacketsPerFrame * kPacketSize;
+    event.timestamp = timestamp;
+    event.received_timestamp = FakeClock::now();
+    return event;
+  }
+
+  // Returns the fastest of `kNumRuns` runs.
+  Clock::duration RunFastest(bool enable_statistics) {
+    Clock::duration fastest = Clock::duration::max();
+    for (int i = 0; i < kNumRuns; ++i) {
+      fastest = std::min(fastest, Run(enable_statistics));
+    }
+    return fastest;
+  }
+
+  Clock::time_point start_time_;
+  std::array<uint8_t, kRtpHeaderSize> header_{};
+  const std::vector<uint8_t> payload_ =
+      std::vector<uint8_t>(kPacketSize - kRtpHeaderSize);
+};
+
+// Measures the cost, per packet sent, of collecting and analyzing statistics.
+TEST_F(StatisticsBenchmark, MeasuresCostPerPacket) {
+  const Clock::duration baseline_time = RunFastest(false);
+  const Clock::duration statistics_time = RunFastest(true);
+
+  constexpr int kNumPackets = kNumFrames * kPacketsPerFrame;
+  const double ns_per_packet =
+      std::max<int64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(statistics_time -
+                                                               baseline_time)
+              .count(),
+          0) /
+      static_cast<double>(kNumPackets);
+  OSP_LOG_INFO << "Statistics cost " << ns_per_packet << " ns per packet, for "
+               << kNumPackets << " packets and their receiver events.";
+  RecordProperty("statistics_ns_per_packet", static_cast<int>(ns_per_packet));
+
+  // A sanity check, that statistics cost far less than the time to send a
+  // packet at the stream's bitrate.
+  EXPECT_LT(ns_per_packet, 100'000);
+}
+
+}  // namespace
+}  // namespace openscreen::cast
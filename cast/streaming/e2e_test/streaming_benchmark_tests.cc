@@ -0,0 +1,320 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cast/streaming/impl/receiver_impl.h"
+#include "cast/streaming/impl/receiver_packet_router.h"
+#include "cast/streaming/impl/sender_impl.h"
+#include "cast/streaming/public/encoded_frame.h"
+#include "cast/streaming/public/frame_id.h"
+#include "cast/streaming/public/receiver.h"
+#include "cast/streaming/public/sender.h"
+#include "cast/streaming/public/session_config.h"
+#include "cast/streaming/rtp_time.h"
+#include "cast/streaming/sender_packet_router.h"
+#include "cast/streaming/testing/simulated_network.h"
+#include "gtest/gtest.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+namespace {
+
+// The synthetic trace: 30 FPS video at about 2 Mbps, with a key frame, five
+// times the size of the others, every two seconds.
+constexpr int kBitrate = 2'000'000;
+constexpr int kFramesPerSecond = 30;
+constexpr int kFrameSize = kBitrate / 8 / kFramesPerSecond;
+constexpr int kKeyFrameSize = 5 * kFrameSize;
+constexpr microseconds kFrameInterval(1'000'000 / kFramesPerSecond);
+constexpr int kKeyFrameInterval = 2 * kFramesPerSecond;
+constexpr int kNumFrames = 20 * kFramesPerSecond;
+constexpr int kRtpTimebase = 90000;
+
+constexpr Ssrc kSenderSsrc = 1;
+constexpr Ssrc kReceiverSsrc = 2;
+constexpr milliseconds kTargetPlayoutDelay(400);
+constexpr auto kAesKey =
+    std::array<uint8_t, 16>{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                             0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr auto kCastIvMask =
+    std::array<uint8_t, 16>{{0xf0, 0xe0, 0xd0, 0xc0, 0xb0, 0xa0, 0x90, 0x80,
+                             0x70, 0x60, 0x50, 0x40, 0x30, 0x20, 0x10, 0x00}};
+
+SessionConfig MakeSessionConfig(bool adapt_playout_delay) {
+  SessionConfig config(kSenderSsrc, kReceiverSsrc, kRtpTimebase,
+                       /* channels */ 1, kTargetPlayoutDelay, kAesKey,
+                       kCastIvMask);
+  if (adapt_playout_delay) {
+    config.adaptive_playout_delay =
+        PlayoutDelayBounds{.min = milliseconds(20), .max = kTargetPlayoutDelay};
+  }
+  return config;
+}
+
+// A network condition to benchmark the streaming stack under.
+struct Scenario {
+  const char* name;
+  SimulatedLinkConfig sender_to_receiver;
+  SimulatedLinkConfig receiver_to_sender;
+
+  // The minimum fraction of the trace's frames that must be played out, as a
+  // sanity check that the stack is not badly broken under these conditions.
+  double min_frames_played_out;
+
+  // Whether the Receiver adapts the target playout delay to the network.
+  bool adapt_playout_delay = false;
+};
+
+const Scenario kScenarios[] = {
+    {"Clean",
+     {.bandwidth = 20'000'000, .delay = milliseconds(10)},
+     {.bandwidth = 20'000'000, .delay = milliseconds(10)},
+     1.0},
+    {"BurstyLoss",
+     {.bandwidth = 20'000'000,
+      .delay = milliseconds(20),
+      .good_loss_probability = 0.005,
+      .bad_loss_probability = 0.5,
+      .good_to_bad_probability = 0.01,
+      .bad_to_good_probability = 0.3},
+     {.bandwidth = 20'000'000,
+      .delay = milliseconds(20),
+      .good_loss_probability = 0.01},
+     0.5},
+    {"JitterAndReordering",
+     {.bandwidth = 20'000'000,
+      .delay = milliseconds(30),
+      .jitter = milliseconds(30),
+      .reorder_probability = 0.02},
+     {.bandwidth = 20'000'000,
+      .delay = milliseconds(30),
+      .jitter = milliseconds(30)},
+     0.95},
+    {"ConstrainedBandwidth",
+     {.bandwidth = 3'000'000,
+      .queue_size = 64 * 1024,
+      .delay = milliseconds(20)},
+     {.bandwidth = 1'000'000, .delay = milliseconds(20)},
+     0.8},
+    {"AdaptivePlayoutDelay",
+     {.bandwidth = 20'000'000,
+      .delay = milliseconds(5),
+      .jitter = milliseconds(15)},
+     {.bandwidth = 20'000'000,
+      .delay = milliseconds(5),
+      .jitter = milliseconds(15)},
+     0.95,
+     /* adapt_playout_delay */ true},
+};
+
+void PrintTo(const Scenario& scenario, std::ostream* os) {
+  *os << scenario.name;
+}
+
+// What the benchmark measures.
+struct Results {
+  // The end-to-end latency of each frame played out, from its capture until
+  // the Receiver made it available for consumption.
+  std::vector<Clock::duration> latencies;
+
+  int frames_not_sent = 0;
+  int frames_played_out = 0;
+  int packets_retransmitted = 0;
+
+  // The bitrate of the payload of the frames played out.
+  int goodput = 0;
+
+  // If the Receiver adapted the target playout delay, its final setting.
+  std::optional<milliseconds> final_playout_delay;
+};
+
+// Returns the `percentile`th-percentile of the given `latencies`, in
+// milliseconds.
+int GetPercentileMs(std::vector<Clock::duration> latencies, int percentile) {
+  if (latencies.empty()) {
+    return 0;
+  }
+  const auto nth =
+      latencies.begin() + (latencies.size() - 1) * percentile / 100;
+  std::nth_element(latencies.begin(), nth, latencies.end());
+  return static_cast<int>(to_milliseconds(*nth).count());
+}
+
+// Streams the synthetic trace from a SenderImpl to a ReceiverImpl, over a
+// SimulatedNetwork with the scenario's conditions, and records what the
+// Receiver plays out.
+class StreamingBenchmark : public Receiver::Consumer, public Sender::Observer {
+ public:
+  explicit StreamingBenchmark(const Scenario& scenario)
+      : clock_(Clock::now()),
+        task_runner_(clock_),
+        network_(&FakeClock::now,
+                 task_runner_,
+                 scenario.sender_to_receiver,
+                 scenario.receiver_to_sender),
+        sender_packet_router_(network_.sender_environment()),
+        sender_(network_.sender_environment(),
+                sender_packet_router_,
+                MakeSessionConfig(scenario.adapt_playout_delay),
+                RtpPayloadType::kVideoVp8),
+        receiver_packet_router_(network_.receiver_environment()),
+        receiver_(network_.receiver_environment(),
+                  receiver_packet_router_,
+                  MakeSessionConfig(scenario.adapt_playout_delay)) {
+    sender_.SetObserver(this);
+    receiver_.SetConsumer(this);
+  }
+
+  ~StreamingBenchmark() override {
+    receiver_.SetConsumer(nullptr);
+    sender_.SetObserver(nullptr);
+  }
+
+  Results Run() {
+    const Clock::time_point start_time = FakeClock::now();
+    std::minstd_rand rand(1);
+    std::uniform_int_distribution<int> size_variation(-kFrameSize / 4,
+                                                      kFrameSize / 4);
+    for (int i = 0; i < kNumFrames; ++i) {
+      const RtpTimeTicks rtp_timestamp =
+          RtpTimeTicks() +
+          RtpTimeDelta::FromTicks(int64_t{i} * kRtpTimebase / kFramesPerSecond);
+      // Like a real encoder, drop frames while too much media is in flight.
+      if (sender_.GetInFlightMediaDuration(rtp_timestamp) >
+          sender_.GetMaxInFlightMediaDuration()) {
+        ++results_.frames_not_sent;
+      } else {
+        const bool is_key_frame =
+            i % kKeyFrameInterval == 0 || sender_.NeedsKeyFrame();
+        const int size =
+            (is_key_frame ? kKeyFrameSize : kFrameSize) + size_variation(rand);
+        const std::vector<uint8_t> payload(size, static_cast<uint8_t>(i));
+        const FrameId frame_id = sender_.GetNextFrameId();
+        const EncodedFrame frame(
+            is_key_frame ? EncodedFrame::Dependency::kKeyFrame
+                         : EncodedFrame::Dependency::kDependent,
+            frame_id, is_key_frame ? frame_id : frame_id - 1, rtp_timestamp,
+            FakeClock::now(), milliseconds(0), payload);
+        if (sender_.EnqueueFrame(frame) == Sender::OK) {
+          capture_times_[frame_id] = FakeClock::now();
+        } else {
+          ++results_.frames_not_sent;
+        }
+      }
+      clock_.Advance(kFrameInterval);
+    }
+    const Clock::duration duration = FakeClock::now() - start_time;
+
+    // Give the last frames the rest of the playout delay to arrive.
+    clock_.Advance(kTargetPlayoutDelay);
+
+    results_.goodput = static_cast<int>(
+        payload_bytes_played_out_ * 8 /
+        std::chrono::duration<double>(duration).count());
+    if (const AdaptiveJitterBuffer::Metrics* metrics =
+            receiver_.jitter_buffer_metrics()) {
+      results_.final_playout_delay = metrics->playout_delay;
+    }
+    return results_;
+  }
+
+  // Receiver::Consumer override.
+  void OnFramesReady(size_t next_frame_buffer_size) override {
+    std::optional<size_t> buffer_size = next_frame_buffer_size;
+    while (buffer_size) {
+      const EncodedFrame frame = receiver_.TakeNextFrame(&buffer_);
+      const auto it = capture_times_.find(frame.frame_id);
+      OSP_CHECK(it != capture_times_.end());
+      results_.latencies.push_back(FakeClock::now() - it->second);
+      ++results_.frames_played_out;
+      payload_bytes_played_out_ += frame.data.size();
+      buffer_size = receiver_.AdvanceToNextFrame();
+    }
+  }
+
+  // Sender::Observer overrides.
+  void OnFrameCanceled(FrameId frame_id) override {}
+  void OnPictureLost() override {}
+  void OnPacketsRetransmitted(int count) override {
+    results_.packets_retransmitted += count;
+  }
+
+ private:
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  SimulatedNetwork network_;
+  SenderPacketRouter sender_packet_router_;
+  SenderImpl sender_;
+  ReceiverPacketRouter receiver_packet_router_;
+  ReceiverImpl receiver_;
+
+  std::map<FrameId, Clock::time_point> capture_times_;
+  std::vector<uint8_t> buffer_;
+  int64_t payload_bytes_played_out_ = 0;
+  Results results_;
+};
+
+class StreamingBenchmarkE2ETest : public testing::TestWithParam<Scenario> {};
+
+// Replays the synthetic trace under each scenario, and reports the frame
+// latency percentiles, retransmissions and goodput, so that regressions in the
+// streaming stack can be tracked. The simulation is deterministic, and runs
+// faster than real time.
+TEST_P(StreamingBenchmarkE2ETest, ReplaysSyntheticTrace) {
+  const Scenario& scenario = GetParam();
+  const Results results = StreamingBenchmark(scenario).Run();
+
+  const int p50 = GetPercentileMs(results.latencies, 50);
+  const int p95 = GetPercentileMs(results.latencies, 95);
+  const int p99 = GetPercentileMs(results.latencies, 99);
+  const int frames_dropped =
+      kNumFrames - results.frames_not_sent - results.frames_played_out;
+  OSP_LOG_INFO << scenario.name << ": latency p50=" << p50
+               << " ms, p95=" << p95 << " ms, p99=" << p99
+               << " ms, retransmits=" << results.packets_retransmitted
+               << ", goodput=" << results.goodput
+               << " bps, frames_not_sent=" << results.frames_not_sent
+               << ", frames_dropped=" << frames_dropped;
+  RecordProperty("latency_p50_ms", p50);
+  RecordProperty("latency_p95_ms", p95);
+  RecordProperty("latency_p99_ms", p99);
+  RecordProperty("packets_retransmitted", results.packets_retransmitted);
+  RecordProperty("goodput_bps", results.goodput);
+  RecordProperty("frames_not_sent", results.frames_not_sent);
+  RecordProperty("frames_dropped", frames_dropped);
+  if (results.final_playout_delay) {
+    RecordProperty("final_playout_delay_ms",
+                   static_cast<int>(results.final_playout_delay->count()));
+    EXPECT_GT(kTargetPlayoutDelay, *results.final_playout_delay);
+  }
+
+  EXPECT_GE(results.frames_played_out,
+            static_cast<int>(scenario.min_frames_played_out * kNumFrames));
+  EXPECT_LE(p50, to_milliseconds(kTargetPlayoutDelay).count());
+  EXPECT_GT(results.goodput, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Scenarios,
+    StreamingBenchmarkE2ETest,
+    testing::ValuesIn(kScenarios),
+    [](const testing::TestParamInfo<Scenario>& info) {
+      return std::string(info.param.name);
+    });
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -0,0 +1,153 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/impl/adaptive_jitter_buffer.h"
+
+#include <algorithm>
+
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+
+using clock_operators::operator<<;
+
+namespace {
+
+// The number of transit times needed before the delay is adapted.
+constexpr int kMinFramesToAdapt = 16;
+
+// The percentile of the recent transit times that must be on time.
+constexpr int kTransitPercentile = 95;
+
+// The multiple of the jitter added to the transit times, as a safety margin.
+constexpr int kJitterMarginFactor = 2;
+
+// The RFC 3550 jitter estimator's gain, and the weight of each frame in the
+// late frame rate.
+constexpr int kJitterGainInverse = 16;
+constexpr double kLateFrameRateWeight = 1.0 / 64;
+
+// The late frame rate above which the delay is increased, by at least
+// `kLateFrameIncreaseFactor`.
+constexpr double kMaxLateFrameRate = 0.04;
+constexpr double kLateFrameIncreaseFactor = 1.25;
+
+// The delay is increased to slightly more than needed, and is decreased only
+// once it exceeds what is needed by more than the hysteresis, so that it does
+// not flap between two settings.
+constexpr milliseconds kIncreaseHeadroom(10);
+constexpr milliseconds kDecreaseHysteresis(30);
+
+// The delay decreases by at most one step per interval.
+constexpr milliseconds kMaxDecreaseStep(20);
+constexpr milliseconds kDecreaseInterval(500);
+
+}  // namespace
+
+AdaptiveJitterBuffer::AdaptiveJitterBuffer(milliseconds initial_playout_delay,
+                                           const PlayoutDelayBounds& bounds)
+    : bounds_(bounds) {
+  OSP_CHECK_GT(bounds_.min, milliseconds::zero());
+  OSP_CHECK_LE(bounds_.min, bounds_.max);
+  metrics_.playout_delay = initial_playout_delay;
+}
+
+AdaptiveJitterBuffer::~AdaptiveJitterBuffer() = default;
+
+void AdaptiveJitterBuffer::OnFrameComplete(Clock::duration transit_time) {
+  if (num_transit_times_ > 0) {
+    const Clock::duration previous =
+        transit_times_[(num_transit_times_ - 1) % kTransitWindowSize];
+    const Clock::duration variation = transit_time - previous;
+    metrics_.jitter +=
+        (std::chrono::abs(variation) - metrics_.jitter) / kJitterGainInverse;
+  }
+  transit_times_[num_transit_times_ % kTransitWindowSize] = transit_time;
+  ++num_transit_times_;
+
+  const bool is_late = transit_time > metrics_.playout_delay;
+  if (is_late) {
+    ++metrics_.frames_late;
+  }
+  UpdateLateFrameRate(is_late);
+
+  ++metrics_.frames_completed;
+  total_playout_delay_ += metrics_.playout_delay;
+  metrics_.average_playout_delay =
+      total_playout_delay_ / metrics_.frames_completed;
+}
+
+void AdaptiveJitterBuffer::OnFramesDropped(int count) {
+  OSP_CHECK_GT(count, 0);
+  metrics_.frames_dropped += count;
+  for (int i = 0; i < count; ++i) {
+    UpdateLateFrameRate(true);
+  }
+}
+
+void AdaptiveJitterBuffer::OnPlayoutDelayChanged(milliseconds playout_delay) {
+  metrics_.playout_delay = playout_delay;
+}
+
+std::optional<milliseconds> AdaptiveJitterBuffer::GetNewPlayoutDelay(
+    Clock::time_point now) {
+  if (num_transit_times_ < kMinFramesToAdapt) {
+    return std::nullopt;
+  }
+
+  const Clock::duration needed = ComputeNeededPlayoutDelay();
+  const Clock::duration current = metrics_.playout_delay;
+  Clock::duration new_delay = current;
+  if (metrics_.late_frame_rate > kMaxLateFrameRate) {
+    new_delay = std::max(needed + kIncreaseHeadroom,
+                         std::chrono::duration_cast<Clock::duration>(
+                             current * kLateFrameIncreaseFactor));
+  } else if (needed > current) {
+    new_delay = needed + kIncreaseHeadroom;
+  } else if (needed + kDecreaseHysteresis < current &&
+             now - last_change_time_ >= kDecreaseInterval) {
+    new_delay =
+        std::max(needed + kIncreaseHeadroom, current - kMaxDecreaseStep);
+  }
+
+  const milliseconds delay = std::clamp(
+      std::chrono::ceil<milliseconds>(new_delay), bounds_.min, bounds_.max);
+  if (delay == metrics_.playout_delay) {
+    return std::nullopt;
+  }
+  return ChangePlayoutDelay(delay, now);
+}
+
+Clock::duration AdaptiveJitterBuffer::ComputeNeededPlayoutDelay() const {
+  const int count = std::min(num_transit_times_, kTransitWindowSize);
+  std::array<Clock::duration, kTransitWindowSize> sorted = transit_times_;
+  const auto nth = sorted.begin() + (count - 1) * kTransitPercentile / 100;
+  std::nth_element(sorted.begin(), nth, sorted.begin() + count);
+  return *nth + kJitterMarginFactor * metrics_.jitter;
+}
+
+void AdaptiveJitterBuffer::UpdateLateFrameRate(bool is_late) {
+  metrics_.late_frame_rate +=
+      ((is_late ? 1.0 : 0.0) - metrics_.late_frame_rate) * kLateFrameRateWeight;
+}
+
+milliseconds AdaptiveJitterBuffer::ChangePlayoutDelay(milliseconds delay,
+                                                      Clock::time_point now) {
+  OSP_VLOG << "Changing target playout delay from " << metrics_.playout_delay
+           << " to " << delay << " (jitter=" << metrics_.jitter
+           << ", late_frame_rate=" << metrics_.late_frame_rate << ')';
+  if (delay > metrics_.playout_delay) {
+    ++metrics_.delay_increases;
+    // The frames that were late measured the previous delay, not this one.
+    metrics_.late_frame_rate = 0;
+  } else {
+    ++metrics_.delay_decreases;
+  }
+  metrics_.playout_delay = delay;
+  last_change_time_ = now;
+  return delay;
+}
+
+}  // namespace openscreen::cast
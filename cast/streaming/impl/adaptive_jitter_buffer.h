@@ -0,0 +1,116 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAST_STREAMING_IMPL_ADAPTIVE_JITTER_BUFFER_H_
+#define CAST_STREAMING_IMPL_ADAPTIVE_JITTER_BUFFER_H_
+
+#include <array>
+#include <chrono>
+#include <optional>
+
+#include "cast/streaming/public/session_config.h"
+#include "platform/api/time.h"
+
+namespace openscreen::cast {
+
+// Adapts a Receiver's target playout delay to the network conditions it
+// observes, so that it buffers frames for no longer than necessary. The
+// initial target playout delay of a session is usually a conservative
+// estimate, and the latency it adds is very noticeable in interactive
+// sessions, such as game streaming.
+//
+// Each completed frame provides one sample of its "transit time": the time from
+// its capture at the Sender until it was complete at the Receiver, plus the
+// player's processing time. A frame whose transit time exceeds the target
+// playout delay is late. From these, this tracks the RFC 3550 interarrival
+// jitter, and an exponentially-weighted rate of late and dropped frames.
+//
+// The target playout delay is then:
+//
+//   1. Immediately increased, when the recent transit times plus a jitter
+//      margin exceed it, or when too many frames are late or dropped.
+//
+//   2. Slowly decreased, by a small step at a time, when the recent transit
+//      times plus a jitter margin are well below it, and few frames are late.
+//
+// The asymmetry is deliberate: a late frame is a visible glitch, while a
+// slightly-too-long delay is not.
+class AdaptiveJitterBuffer {
+ public:
+  struct Metrics {
+    // The current target playout delay.
+    std::chrono::milliseconds playout_delay{};
+
+    // The RFC 3550 interarrival jitter of the transit times.
+    Clock::duration jitter{};
+
+    // The exponentially-weighted fraction of recent frames that were late or
+    // dropped.
+    double late_frame_rate = 0;
+
+    int frames_completed = 0;
+    int frames_late = 0;
+    int frames_dropped = 0;
+    int delay_increases = 0;
+    int delay_decreases = 0;
+
+    // The average target playout delay of the completed frames, which is the
+    // latency the Receiver added, to be weighed against `frames_late` and
+    // `frames_dropped`.
+    Clock::duration average_playout_delay{};
+  };
+
+  AdaptiveJitterBuffer(std::chrono::milliseconds initial_playout_delay,
+                       const PlayoutDelayBounds& bounds);
+  ~AdaptiveJitterBuffer();
+
+  // Called when a frame is complete, with its `transit_time` (see class
+  // comments).
+  void OnFrameComplete(Clock::duration transit_time);
+
+  // Called when `count` incomplete frames were skipped, since they were too
+  // late to be played out.
+  void OnFramesDropped(int count);
+
+  // Called when the Sender changed the target playout delay.
+  void OnPlayoutDelayChanged(std::chrono::milliseconds playout_delay);
+
+  // Returns a new target playout delay, if it should be changed `now`.
+  std::optional<std::chrono::milliseconds> GetNewPlayoutDelay(
+      Clock::time_point now);
+
+  const Metrics& metrics() const { return metrics_; }
+
+ private:
+  // The number of recent transit times used to estimate the playout delay
+  // needed.
+  static constexpr int kTransitWindowSize = 64;
+
+  // Returns the playout delay needed for all but a few of the recent frames to
+  // be on time.
+  Clock::duration ComputeNeededPlayoutDelay() const;
+
+  // Records a frame as on-time or late in the late frame rate.
+  void UpdateLateFrameRate(bool is_late);
+
+  // Changes the target playout delay to `delay`, and updates the metrics.
+  std::chrono::milliseconds ChangePlayoutDelay(std::chrono::milliseconds delay,
+                                               Clock::time_point now);
+
+  const PlayoutDelayBounds bounds_;
+
+  // A ring buffer of the most recent transit times, and the total number of
+  // transit times ever added to it.
+  std::array<Clock::duration, kTransitWindowSize> transit_times_{};
+  int num_transit_times_ = 0;
+
+  Clock::duration total_playout_delay_{};
+  Clock::time_point last_change_time_{};
+
+  Metrics metrics_;
+};
+
+}  // namespace openscreen::cast
+
+#endif  // CAST_STREAMING_IMPL_ADAPTIVE_JITTER_BUFFER_H_
@@ -0,0 +1,152 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/impl/adaptive_jitter_buffer.h"
+
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/chrono_helpers.h"
+
+namespace openscreen::cast {
+namespace {
+
+constexpr milliseconds kFrameInterval(33);
+constexpr PlayoutDelayBounds kBounds{.min = milliseconds(20),
+                                     .max = milliseconds(1000)};
+
+class AdaptiveJitterBufferTest : public testing::Test {
+ public:
+  AdaptiveJitterBufferTest() : now_(Clock::now()) {}
+
+  // Completes one frame per frame interval, with transit times returned by
+  // `next_transit_time`, for the given `duration`. Returns the changes to the
+  // target playout delay.
+  template <typename TransitTimeFunction>
+  std::vector<milliseconds> Run(AdaptiveJitterBuffer& jitter_buffer,
+                                Clock::duration duration,
+                                TransitTimeFunction next_transit_time) {
+    std::vector<milliseconds> changes;
+    for (const Clock::time_point end = now_ + duration; now_ < end;
+         now_ += kFrameInterval) {
+      jitter_buffer.OnFrameComplete(next_transit_time());
+      if (const std::optional<milliseconds> delay =
+              jitter_buffer.GetNewPlayoutDelay(now_)) {
+        EXPECT_EQ(*delay, jitter_buffer.metrics().playout_delay);
+        changes.push_back(*delay);
+      }
+    }
+    return changes;
+  }
+
+ protected:
+  Clock::time_point now_;
+};
+
+// Tests that the delay is decreased, gradually, toward the transit time on a
+// network without jitter.
+TEST_F(AdaptiveJitterBufferTest, ShrinksDelayOnACleanLink) {
+  AdaptiveJitterBuffer jitter_buffer(milliseconds(400), kBounds);
+  const std::vector<milliseconds> changes =
+      Run(jitter_buffer, seconds(20), [] { return milliseconds(50); });
+
+  ASSERT_FALSE(changes.empty());
+  milliseconds previous(400);
+  for (const milliseconds delay : changes) {
+    EXPECT_LT(delay, previous);
+    EXPECT_LE(previous - delay, milliseconds(20));
+    previous = delay;
+  }
+  // The delay settles within the hysteresis above the transit time.
+  EXPECT_EQ(milliseconds(80), changes.back());
+
+  const AdaptiveJitterBuffer::Metrics& metrics = jitter_buffer.metrics();
+  EXPECT_EQ(static_cast<int>(changes.size()), metrics.delay_decreases);
+  EXPECT_EQ(0, metrics.delay_increases);
+  EXPECT_EQ(0, metrics.frames_late);
+  EXPECT_EQ(0, metrics.frames_dropped);
+  EXPECT_EQ(Clock::duration::zero(), metrics.jitter);
+  EXPECT_LT(milliseconds(80), metrics.average_playout_delay);
+  EXPECT_GT(milliseconds(400), metrics.average_playout_delay);
+}
+
+// Tests that the delay is increased promptly when the transit times vary, so
+// that frames are played out on time.
+TEST_F(AdaptiveJitterBufferTest, GrowsDelayUnderJitter) {
+  AdaptiveJitterBuffer jitter_buffer(milliseconds(100), kBounds);
+  std::minstd_rand rand(1);
+  std::uniform_int_distribution<int> jitter_ms(0, 150);
+  const auto next_transit_time = [&] {
+    return milliseconds(50 + jitter_ms(rand));
+  };
+
+  const std::vector<milliseconds> changes =
+      Run(jitter_buffer, seconds(1), next_transit_time);
+  ASSERT_FALSE(changes.empty());
+  EXPECT_LT(milliseconds(200), changes.front());
+  EXPECT_LT(milliseconds(30), jitter_buffer.metrics().jitter);
+  EXPECT_LT(0, jitter_buffer.metrics().delay_increases);
+
+  // Once adapted, almost no frames are late.
+  const int frames_late_before = jitter_buffer.metrics().frames_late;
+  const int frames_completed_before = jitter_buffer.metrics().frames_completed;
+  Run(jitter_buffer, seconds(20), next_transit_time);
+  const int frames_late =
+      jitter_buffer.metrics().frames_late - frames_late_before;
+  const int frames_completed =
+      jitter_buffer.metrics().frames_completed - frames_completed_before;
+  EXPECT_LT(frames_late, frames_completed / 100);
+  EXPECT_LT(jitter_buffer.metrics().late_frame_rate, 0.02);
+}
+
+// Tests that dropped frames increase the delay, even if the frames that do
+// complete are on time.
+TEST_F(AdaptiveJitterBufferTest, GrowsDelayWhenFramesAreDropped) {
+  AdaptiveJitterBuffer jitter_buffer(milliseconds(80), kBounds);
+  EXPECT_TRUE(
+      Run(jitter_buffer, seconds(2), [] { return milliseconds(50); }).empty());
+
+  jitter_buffer.OnFramesDropped(3);
+  EXPECT_EQ(3, jitter_buffer.metrics().frames_dropped);
+  EXPECT_EQ(milliseconds(100), jitter_buffer.GetNewPlayoutDelay(now_));
+  EXPECT_EQ(1, jitter_buffer.metrics().delay_increases);
+
+  // The late frame rate measured the previous delay, and does not trigger
+  // another increase.
+  EXPECT_EQ(std::nullopt, jitter_buffer.GetNewPlayoutDelay(now_));
+}
+
+TEST_F(AdaptiveJitterBufferTest, FollowsChangesMadeByTheSender) {
+  AdaptiveJitterBuffer jitter_buffer(milliseconds(80), kBounds);
+  Run(jitter_buffer, seconds(1), [] { return milliseconds(50); });
+
+  jitter_buffer.OnPlayoutDelayChanged(milliseconds(300));
+  EXPECT_EQ(milliseconds(300), jitter_buffer.metrics().playout_delay);
+  const std::vector<milliseconds> changes =
+      Run(jitter_buffer, seconds(1), [] { return milliseconds(50); });
+  ASSERT_FALSE(changes.empty());
+  EXPECT_EQ(milliseconds(280), changes.front());
+}
+
+TEST_F(AdaptiveJitterBufferTest, StaysWithinBounds) {
+  constexpr PlayoutDelayBounds kNarrowBounds{.min = milliseconds(100),
+                                             .max = milliseconds(200)};
+  AdaptiveJitterBuffer jitter_buffer(milliseconds(150), kNarrowBounds);
+  for (const milliseconds delay :
+       Run(jitter_buffer, seconds(5), [] { return milliseconds(10); })) {
+    EXPECT_GE(delay, kNarrowBounds.min);
+  }
+  EXPECT_EQ(kNarrowBounds.min, jitter_buffer.metrics().playout_delay);
+
+  for (const milliseconds delay :
+       Run(jitter_buffer, seconds(5), [] { return milliseconds(500); })) {
+    EXPECT_LE(delay, kNarrowBounds.max);
+  }
+  EXPECT_EQ(kNarrowBounds.max, jitter_buffer.metrics().playout_delay);
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -278,6 +278,22 @@ TEST(AnswerMessagesTest, EmptyArraysOmitted) {
   EXPECT_FALSE(root["rtpExtensions"]);
 }
 
+TEST(AnswerMessagesTest, ReceiverFecRoundTrips) {
+  const Answer answer_without_fec = GetValidAnswer();
+  ASSERT_TRUE(answer_without_fec.receiver_fec.empty());
+  EXPECT_FALSE(answer_without_fec.ToJson().isMember("receiverFec"));
+
+  Answer answer = GetValidAnswer();
+  answer.receiver_fec = {3};
+  const Json::Value root = answer.ToJson();
+  ASSERT_EQ(root["receiverFec"].type(), Json::ValueType::arrayValue);
+  EXPECT_EQ(root["receiverFec"][0], 3);
+
+  const ErrorOr<Answer> parsed = Answer::TryParse(root);
+  ASSERT_TRUE(parsed.is_value()) << parsed.error();
+  EXPECT_THAT(parsed.value().receiver_fec, ElementsAre(3));
+}
+
 TEST(AnswerMessagesTest, InvalidDimensionsCauseInvalid) {
   Answer invalid_dimensions = GetValidAnswer();
   invalid_dimensions.display->dimensions->width = -1;
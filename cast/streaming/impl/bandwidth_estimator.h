@@ -9,6 +9,7 @@
 
 #include <limits>
 
+#include "cast/streaming/impl/congestion_controller.h"
 #include "platform/api/time.h"
 
 namespace openscreen::cast {
@@ -58,7 +59,9 @@ namespace openscreen::cast {
 //   2. When the estimated bitrate is more than the current encoding target
 //      bitrate, gradually increase the encoding bitrate (up to the maximum
 //      that is reasonable for the application).
-class BandwidthEstimator {
+//
+// This is the default CongestionController of a SenderPacketRouter.
+class BandwidthEstimator : public CongestionController {
  public:
   // `max_packets_per_timeslice` and `timeslice_duration` should match the burst
   // configuration in SenderPacketRouter. `start_time` should be a recent
@@ -67,7 +70,7 @@ class BandwidthEstimator {
                      Clock::duration timeslice_duration,
                      Clock::time_point start_time);
 
-  ~BandwidthEstimator();
+  ~BandwidthEstimator() override;
 
   // Returns the duration of the fixed, recent-history time window over which
   // data flows are being tracked.
@@ -78,24 +81,24 @@ class BandwidthEstimator {
   // non-payload packets (since both affect the modeled utilization/capacity).
   // For the inactive case, this method should be called with zero for
   // `num_packets_sent`.
-  void OnBurstComplete(int num_packets_sent, Clock::time_point when);
+  void OnBurstComplete(int num_packets_sent, Clock::time_point when) override;
 
   // Records when a RTCP packet was received. It's important for Senders to call
   // this any time a packet comes in from the Receivers, even if no payload is
   // being acknowledged, since the time windows of "nothing successfully
   // received" is also important information to track.
   void OnRtcpReceived(Clock::time_point arrival_time,
-                      Clock::duration estimated_round_trip_time);
+                      Clock::duration estimated_round_trip_time) override;
 
   // Records that some number of payload bytes has been acknowledged (i.e.,
   // successfully received).
   void OnPayloadReceived(int payload_bytes_acknowledged,
                          Clock::time_point ack_arrival_time,
-                         Clock::duration estimated_round_trip_time);
+                         Clock::duration estimated_round_trip_time) override;
 
   // Computes the current network bandwith estimate. Returns 0 if this cannot be
   // determined due to a lack of sufficiently-recent data.
-  int ComputeNetworkBandwidth() const;
+  int ComputeNetworkBandwidth() const override;
 
  private:
   // FlowTracker (below) manages a ring buffer of size 256. It simplifies the
@@ -95,11 +95,14 @@ bool CompoundRtcpParser::Parse(ByteView buffer, FrameId max_feedback_frame_id) {
   // succeeds.
   Clock::time_point receiver_reference_time = kNullTimePoint;
   std::optional<RtcpReportBlock> receiver_report;
-  std::vector<RtcpReceiverFrameLogMessage> log_messages;
+  std::vector<RtcpReceiverFrameLogMessage>& log_messages = log_messages_;
+  ClearLogMessages(log_messages);
   FrameId checkpoint_frame_id;
   milliseconds target_playout_delay{};
-  std::vector<FrameId> received_frames;
-  std::vector<PacketNack> packet_nacks;
+  std::vector<FrameId>& received_frames = received_frames_;
+  received_frames.clear();
+  std::vector<PacketNack>& packet_nacks = packet_nacks_;
+  packet_nacks.clear();
   bool picture_loss_indicator = false;
 
   // The data contained in `buffer` can be a "compound packet," which means that
@@ -189,18 +192,18 @@ bool CompoundRtcpParser::Parse(ByteView buffer, FrameId max_feedback_frame_id) {
     client_->OnReceiverReport(*receiver_report);
   }
   if (!log_messages.empty()) {
-    client_->OnCastReceiverFrameLogMessages(std::move(log_messages));
+    client_->OnCastReceiverFrameLogMessages(log_messages);
   }
   if (!checkpoint_frame_id.is_null()) {
     client_->OnReceiverCheckpoint(checkpoint_frame_id, target_playout_delay);
   }
   if (!received_frames.empty()) {
     OSP_DCHECK(AreElementsSortedAndUnique(received_frames));
-    client_->OnReceiverHasFrames(std::move(received_frames));
+    client_->OnReceiverHasFrames(received_frames);
   }
   CanonicalizePacketNackVector(&packet_nacks);
   if (!packet_nacks.empty()) {
-    client_->OnReceiverIsMissingPackets(std::move(packet_nacks));
+    client_->OnReceiverIsMissingPackets(packet_nacks);
   }
   if (picture_loss_indicator) {
     client_->OnReceiverIndicatesPictureLoss();
@@ -253,7 +256,7 @@ bool CompoundRtcpParser::ParseFrameLogMessages(
     std::vector<RtcpReceiverFrameLogMessage>& messages) {
   while (!in.empty()) {
     if (in.size() < kRtcpReceiverFrameLogMessageHeaderSize) {
-      messages.clear();
+      ClearLogMessages(messages);
       return false;
     }
     const uint32_t truncated_rtp_timestamp = ConsumeField<uint32_t>(in);
@@ -272,12 +275,16 @@ bool CompoundRtcpParser::ParseFrameLogMessages(
 
     const RtpTimeTicks frame_log_rtp_timestamp =
         latest_frame_log_rtp_timestamp_.Expand(truncated_rtp_timestamp);
-    RtcpReceiverFrameLogMessage frame_log_message{.rtp_timestamp =
-                                                      frame_log_rtp_timestamp};
+    RtcpReceiverFrameLogMessage& frame_log_message = messages.emplace_back(
+        RtcpReceiverFrameLogMessage{.rtp_timestamp = frame_log_rtp_timestamp});
+    if (!spare_event_logs_.empty()) {
+      frame_log_message.messages = std::move(spare_event_logs_.back());
+      spare_event_logs_.pop_back();
+    }
 
     for (size_t event = 0; event < num_events; ++event) {
       if (in.size() < kRtcpReceiverFrameLogMessageBlockSize) {
-        messages.clear();
+        ClearLogMessages(messages);
         return false;
       }
 
@@ -306,12 +313,20 @@ bool CompoundRtcpParser::ParseFrameLogMessages(
       frame_log_message.messages.emplace_back(std::move(event_log));
     }
     latest_frame_log_rtp_timestamp_ = frame_log_rtp_timestamp;
-    messages.emplace_back(std::move(frame_log_message));
   }
 
   return true;
 }
 
+void CompoundRtcpParser::ClearLogMessages(
+    std::vector<RtcpReceiverFrameLogMessage>& messages) {
+  for (RtcpReceiverFrameLogMessage& message : messages) {
+    message.messages.clear();
+    spare_event_logs_.emplace_back(std::move(message.messages));
+  }
+  messages.clear();
+}
+
 bool CompoundRtcpParser::ParseFeedback(ByteView in,
                                        FrameId max_feedback_frame_id,
                                        FrameId* checkpoint_frame_id,
@@ -466,14 +481,14 @@ void CompoundRtcpParser::Client::OnReceiverReferenceTimeAdvanced(
 void CompoundRtcpParser::Client::OnReceiverReport(
     const RtcpReportBlock& receiver_report) {}
 void CompoundRtcpParser::Client::OnCastReceiverFrameLogMessages(
-    std::vector<RtcpReceiverFrameLogMessage> messages) {}
+    const std::vector<RtcpReceiverFrameLogMessage>& messages) {}
 void CompoundRtcpParser::Client::OnReceiverIndicatesPictureLoss() {}
 void CompoundRtcpParser::Client::OnReceiverCheckpoint(
     FrameId frame_id,
     milliseconds playout_delay) {}
 void CompoundRtcpParser::Client::OnReceiverHasFrames(
-    std::vector<FrameId> acks) {}
+    const std::vector<FrameId>& acks) {}
 void CompoundRtcpParser::Client::OnReceiverIsMissingPackets(
-    std::vector<PacketNack> nacks) {}
+    const std::vector<PacketNack>& nacks) {}
 
 }  // namespace openscreen::cast
@@ -34,6 +34,10 @@ class CompoundRtcpParser {
   //      inconsistent (e.g., the same frame being ACKed and NACKed; or a frame
   //      that has not been sent yet is being NACKed). While that would indicate
   //      a badly-behaving Receiver, the Sender should be robust to such things.
+  //
+  // The vectors passed to the callbacks are owned by the CompoundRtcpParser,
+  // which re-uses them for later packets. They are only valid for the duration
+  // of the call.
   class Client {
    public:
     Client();
@@ -47,7 +51,7 @@ class CompoundRtcpParser {
 
     // Called when a group of Cast Receiver frame log messages has been parsed.
     virtual void OnCastReceiverFrameLogMessages(
-        std::vector<RtcpReceiverFrameLogMessage> messages);
+        const std::vector<RtcpReceiverFrameLogMessage>& messages);
 
     // Called when the Receiver has encountered an unrecoverable error in
     // decoding the data. The Sender should provide a key frame as soon as
@@ -66,13 +70,14 @@ class CompoundRtcpParser {
     // Called to indicate the Receiver has successfully received all of the
     // packets for each of the given `acks`. The argument's elements are in
     // monotonically increasing order.
-    virtual void OnReceiverHasFrames(std::vector<FrameId> acks);
+    virtual void OnReceiverHasFrames(const std::vector<FrameId>& acks);
 
     // Called to indicate the Receiver is missing certain specific packets for
     // certain specific frames. Any elements where the packet_id is
     // kAllPacketsLost indicates that all the packets are missing for a frame.
     // The argument's elements are in monotonically increasing order.
-    virtual void OnReceiverIsMissingPackets(std::vector<PacketNack> nacks);
+    virtual void OnReceiverIsMissingPackets(
+        const std::vector<PacketNack>& nacks);
 
    protected:
     virtual ~Client();
@@ -91,6 +96,9 @@ class CompoundRtcpParser {
   // `max_feedback_frame_id` is the maximum-valued FrameId that could possibly
   // be ACKnowledged by the Receiver, if there is Cast Feedback in the `packet`.
   // This is needed for expanding truncated frame IDs correctly.
+  //
+  // Once the parser has seen packets of typical sizes, parsing does not
+  // allocate memory.
   bool Parse(ByteView packet, FrameId max_feedback_frame_id);
 
  private:
@@ -108,6 +116,10 @@ class CompoundRtcpParser {
   bool ParseFrameLogMessages(
       ByteView in,
       std::vector<RtcpReceiverFrameLogMessage>& messages);
+
+  // Clears `messages`, keeping the event vectors of its elements in
+  // `spare_event_logs_` for re-use.
+  void ClearLogMessages(std::vector<RtcpReceiverFrameLogMessage>& messages);
   bool ParseFeedback(ByteView in,
                      FrameId max_feedback_frame_id,
                      FrameId* checkpoint_frame_id,
@@ -128,6 +140,17 @@ class CompoundRtcpParser {
 
   // Tracks the last parsed RTP timestamp seen from any Cast receiver frame log.
   RtpTimeTicks latest_frame_log_rtp_timestamp_;
+
+  // The results of the current Parse(), which are dispatched to the Client once
+  // the whole packet is known to be well-formed. These are only members to
+  // avoid re-allocating them for each packet.
+  std::vector<RtcpReceiverFrameLogMessage> log_messages_;
+  std::vector<FrameId> received_frames_;
+  std::vector<PacketNack> packet_nacks_;
+
+  // Cleared event vectors from earlier log messages, for re-use by the frame
+  // log messages of later packets.
+  std::vector<std::vector<RtcpReceiverEventLogMessage>> spare_event_logs_;
 };
 
 }  // namespace openscreen::cast
@@ -248,6 +248,56 @@ TEST_F(CompoundRtcpParserTest,
   EXPECT_EQ(FramePacketId{7701}, second_first_log.packet_id);
 }
 
+// Tests that the storage the parser re-uses for frame log messages does not
+// leak events from one packet into the next.
+TEST_F(CompoundRtcpParserTest,
+       OnCastReceiverFrameLogMessages_ConsecutivePackets) {
+  // clang-format off
+  const uint8_t kPacketWithTwoEvents[] = {
+      0b10000000 | 2,          // Version=2, Padding=no, Subtype=ReceiverLog.
+      204,                     // RTCP Packet type of application defined.
+      0x00, 0x06,              // Length of remainder of packet in 32-bit words.
+      0x00, 0x00, 0x00, 0x02,  // Receiver SSRC.
+       'C',  'A',  'S',  'T',  // Name.
+      0x01, 0x02, 0x03, 0x04,  // Truncated RTP timestamp.
+      0x01,                    // Number of events (minus one).
+            0x10, 0x20, 0x30,  // Event timestamp.
+      0x01, 0x15,              // Event one: packet ID.
+                  0xE1, 0x19,  // Event one: type (packet received), timestamp.
+      0x02, 0x17,              // Event two: delay delta
+                  0xC2, 0x27,  // Event two: type (frame playout), timestamp.
+  };
+  const uint8_t kPacketWithOneEvent[] = {
+      0b10000000 | 2,          // Version=2, Padding=no, Subtype=ReceiverLog.
+      204,                     // RTCP Packet type of application defined.
+      0x00, 0x05,              // Length of remainder of packet in 32-bit words.
+      0x00, 0x00, 0x00, 0x02,  // Receiver SSRC.
+       'C',  'A',  'S',  'T',  // Name.
+      0x01, 0x02, 0x03, 0x05,  // Truncated RTP timestamp.
+      0x00,                    // Number of events (minus one).
+            0x10, 0x20, 0x30,  // Event timestamp.
+      0x1E, 0x15,              // Event one: packet ID.
+                  0xE1, 0xF9,  // Event one: type (packet received), timestamp.
+  };
+  // clang-format on
+
+  std::vector<RtcpReceiverFrameLogMessage> messages;
+  EXPECT_CALL(*(client()), OnCastReceiverFrameLogMessages(_))
+      .WillOnce(SaveArg<0>(&messages));
+  EXPECT_TRUE(parser()->Parse(kPacketWithTwoEvents, FrameId::first()));
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_EQ(2u, messages[0].messages.size());
+  Mock::VerifyAndClearExpectations(client());
+
+  EXPECT_CALL(*(client()), OnCastReceiverFrameLogMessages(_))
+      .WillOnce(SaveArg<0>(&messages));
+  EXPECT_TRUE(parser()->Parse(kPacketWithOneEvent, FrameId::first()));
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_EQ(RtpTimeTicks(16909061), messages[0].rtp_timestamp);
+  ASSERT_EQ(1u, messages[0].messages.size());
+  EXPECT_EQ(FramePacketId{7701}, messages[0].messages[0].packet_id);
+}
+
 TEST_F(CompoundRtcpParserTest, OnCastReceiverFrameLogMessages_WrongName) {
   // clang-format off
   const uint8_t kPacketWithWrongName[] = {
@@ -0,0 +1,16 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/impl/congestion_controller.h"
+
+namespace openscreen::cast {
+
+CongestionController::~CongestionController() = default;
+
+void CongestionController::OnFrameDelivered(
+    int payload_bytes,
+    Clock::time_point last_packet_send_time,
+    Clock::time_point ack_arrival_time) {}
+
+}  // namespace openscreen::cast
@@ -0,0 +1,59 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAST_STREAMING_IMPL_CONGESTION_CONTROLLER_H_
+#define CAST_STREAMING_IMPL_CONGESTION_CONTROLLER_H_
+
+#include "platform/api/time.h"
+
+namespace openscreen::cast {
+
+// The network bandwidth estimation employed by a SenderPacketRouter. The
+// router reports every burst of packets it sends, and its Senders report the
+// feedback they receive from their Receivers. Upstream code modules then use
+// ComputeNetworkBandwidth() as the control signal for adjusting the media's
+// encoding target bitrate (see the discussion in bandwidth_estimator.h).
+//
+// BandwidthEstimator is the default implementation, and
+// DelayBasedCongestionController an alternative that reacts to growing
+// queueing delay before the network starts dropping packets.
+class CongestionController {
+ public:
+  virtual ~CongestionController();
+
+  // Records `when` burst-sending was active or inactive. For the active case,
+  // `num_packets_sent` includes all network packets sent, including non-payload
+  // packets. For the inactive case, `num_packets_sent` is zero.
+  virtual void OnBurstComplete(int num_packets_sent,
+                               Clock::time_point when) = 0;
+
+  // Records when a RTCP packet was received from any Receiver, whether or not
+  // it acknowledged any payload.
+  virtual void OnRtcpReceived(Clock::time_point arrival_time,
+                              Clock::duration estimated_round_trip_time) = 0;
+
+  // Records that some number of payload bytes has been acknowledged (i.e.,
+  // successfully received).
+  virtual void OnPayloadReceived(int payload_bytes_acknowledged,
+                                 Clock::time_point ack_arrival_time,
+                                 Clock::duration estimated_round_trip_time) = 0;
+
+  // Records that a frame of `payload_bytes`, whose last packet was sent at
+  // `last_packet_send_time`, was acknowledged by a RTCP packet that arrived at
+  // `ack_arrival_time`. Since Receivers send feedback as soon as a frame is
+  // complete, the time between the two tracks the network's round trip time,
+  // including any queueing delay. The default implementation does nothing.
+  virtual void OnFrameDelivered(int payload_bytes,
+                                Clock::time_point last_packet_send_time,
+                                Clock::time_point ack_arrival_time);
+
+  // Computes the current network bandwith estimate, in bits per second.
+  // Returns 0 if this cannot be determined due to a lack of sufficiently-recent
+  // data.
+  virtual int ComputeNetworkBandwidth() const = 0;
+};
+
+}  // namespace openscreen::cast
+
+#endif  // CAST_STREAMING_IMPL_CONGESTION_CONTROLLER_H_
@@ -0,0 +1,224 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/impl/delay_based_congestion_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+#include "util/saturate_cast.h"
+
+namespace openscreen::cast {
+
+using clock_operators::operator<<;
+
+namespace {
+
+// The weight of the previous value when smoothing the accumulated delay
+// variation.
+constexpr double kDelaySmoothingFactor = 0.6;
+
+// The trendline's slope is scaled by the number of samples (up to this many)
+// and this gain before comparing it to the over-use threshold, so that the
+// detector is less sensitive while it has few samples.
+constexpr int kMaxTrendSampleCount = 60;
+constexpr double kTrendGain = 4.0;
+
+// The scaled trendline slope beyond which the network is deemed to be
+// over-used (or under-used, if negative), and the number of consecutive
+// samples that must exceed it for over-use to be detected.
+constexpr double kOveruseThreshold = 12.5;
+constexpr int kMinOverusingSamples = 2;
+
+// The time window over which the delivered throughput is measured.
+constexpr Clock::duration kThroughputWindow = milliseconds(500);
+
+// On over-use, the estimate is decreased to this fraction of the delivered
+// throughput, and no more often than this.
+constexpr double kDecreaseFactor = 0.85;
+constexpr Clock::duration kMinDecreaseInterval = milliseconds(100);
+
+// Otherwise, the estimate is increased by this factor per second, but to no
+// more than this multiple of the delivered throughput.
+constexpr double kIncreaseFactorPerSecond = 1.25;
+constexpr double kMaxEstimateToThroughputRatio = 1.5;
+
+constexpr double kBitsPerByte = 8;
+
+double ToMilliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // namespace
+
+DelayBasedCongestionController::DelayBasedCongestionController(
+    Clock::time_point start_time)
+    : start_time_(start_time),
+      last_update_time_(start_time),
+      last_decrease_time_(start_time) {}
+
+DelayBasedCongestionController::~DelayBasedCongestionController() = default;
+
+void DelayBasedCongestionController::OnBurstComplete(int num_packets_sent,
+                                                     Clock::time_point when) {
+  OSP_CHECK_GE(num_packets_sent, 0);
+}
+
+void DelayBasedCongestionController::OnRtcpReceived(
+    Clock::time_point arrival_time,
+    Clock::duration estimated_round_trip_time) {
+  OSP_CHECK_GE(estimated_round_trip_time, Clock::duration::zero());
+  round_trip_time_ = estimated_round_trip_time;
+}
+
+void DelayBasedCongestionController::OnPayloadReceived(
+    int payload_bytes_acknowledged,
+    Clock::time_point ack_arrival_time,
+    Clock::duration estimated_round_trip_time) {
+  // Deliveries are tracked by OnFrameDelivered(), which also knows when each
+  // frame was sent.
+  OSP_CHECK_GE(payload_bytes_acknowledged, 0);
+}
+
+void DelayBasedCongestionController::OnFrameDelivered(
+    int payload_bytes,
+    Clock::time_point last_packet_send_time,
+    Clock::time_point ack_arrival_time) {
+  OSP_CHECK_GE(payload_bytes, 0);
+  OSP_CHECK_LE(last_packet_send_time, ack_arrival_time);
+  UpdateDelayTrend(last_packet_send_time, ack_arrival_time);
+  const double throughput = UpdateThroughput(payload_bytes, ack_arrival_time);
+  if (throughput > 0) {
+    UpdateEstimate(throughput, ack_arrival_time);
+  }
+}
+
+int DelayBasedCongestionController::ComputeNetworkBandwidth() const {
+  return saturate_cast<int>(estimate_);
+}
+
+void DelayBasedCongestionController::UpdateDelayTrend(
+    Clock::time_point last_packet_send_time,
+    Clock::time_point ack_arrival_time) {
+  if (!has_previous_sample_) {
+    has_previous_sample_ = true;
+    previous_send_time_ = last_packet_send_time;
+    previous_arrival_time_ = ack_arrival_time;
+    return;
+  }
+  // Ignore frames whose packets were sent before those of the previous sample
+  // (e.g., ACKed late, after a retransmission).
+  if (last_packet_send_time < previous_send_time_ ||
+      ack_arrival_time < previous_arrival_time_) {
+    return;
+  }
+
+  const double delay_variation_ms =
+      ToMilliseconds((ack_arrival_time - previous_arrival_time_) -
+                     (last_packet_send_time - previous_send_time_));
+  previous_send_time_ = last_packet_send_time;
+  previous_arrival_time_ = ack_arrival_time;
+
+  accumulated_delay_ms_ += delay_variation_ms;
+  smoothed_delay_ms_ = kDelaySmoothingFactor * smoothed_delay_ms_ +
+                       (1 - kDelaySmoothingFactor) * accumulated_delay_ms_;
+  trendline_samples_[num_delay_samples_ % kTrendlineWindowSize] = DelaySample{
+      ToMilliseconds(ack_arrival_time - start_time_), smoothed_delay_ms_};
+  ++num_delay_samples_;
+
+  const int num_samples = std::min(num_delay_samples_, kTrendlineWindowSize);
+  if (num_samples < kTrendlineWindowSize) {
+    return;
+  }
+
+  // Fit a line to the samples, by linear least squares.
+  double mean_x = 0;
+  double mean_y = 0;
+  for (const DelaySample& sample : trendline_samples_) {
+    mean_x += sample.arrival_time_ms;
+    mean_y += sample.smoothed_delay_ms;
+  }
+  mean_x /= num_samples;
+  mean_y /= num_samples;
+  double numerator = 0;
+  double denominator = 0;
+  for (const DelaySample& sample : trendline_samples_) {
+    const double dx = sample.arrival_time_ms - mean_x;
+    numerator += dx * (sample.smoothed_delay_ms - mean_y);
+    denominator += dx * dx;
+  }
+  if (denominator == 0) {
+    return;
+  }
+  const double slope = numerator / denominator;
+
+  const double trend =
+      std::min(num_delay_samples_, kMaxTrendSampleCount) * slope * kTrendGain;
+  if (trend > kOveruseThreshold) {
+    if (++num_overusing_samples_ >= kMinOverusingSamples) {
+      usage_ = Usage::kOverusing;
+    }
+  } else {
+    num_overusing_samples_ = 0;
+    usage_ =
+        (trend < -kOveruseThreshold) ? Usage::kUnderusing : Usage::kNormal;
+  }
+}
+
+double DelayBasedCongestionController::UpdateThroughput(
+    int payload_bytes,
+    Clock::time_point arrival_time) {
+  first_delivery_time_ = std::min(first_delivery_time_, arrival_time);
+  recent_deliveries_.push_back(Delivery{arrival_time, payload_bytes});
+  recent_payload_bytes_ += payload_bytes;
+  while (recent_deliveries_.front().arrival_time <=
+         arrival_time - kThroughputWindow) {
+    recent_payload_bytes_ -= recent_deliveries_.front().payload_bytes;
+    recent_deliveries_.pop_front();
+  }
+
+  if (arrival_time - first_delivery_time_ < kThroughputWindow) {
+    return 0;
+  }
+  return recent_payload_bytes_ * kBitsPerByte /
+         std::chrono::duration<double>(kThroughputWindow).count();
+}
+
+void DelayBasedCongestionController::UpdateEstimate(double throughput,
+                                                    Clock::time_point now) {
+  const double max_estimate = kMaxEstimateToThroughputRatio * throughput;
+  if (estimate_ == 0) {
+    estimate_ = max_estimate;
+  }
+
+  switch (usage_) {
+    case Usage::kOverusing:
+      if (now - last_decrease_time_ >=
+          std::max(round_trip_time_, kMinDecreaseInterval)) {
+        estimate_ = std::min(estimate_, kDecreaseFactor * throughput);
+        last_decrease_time_ = now;
+      }
+      break;
+
+    case Usage::kUnderusing:
+      break;
+
+    case Usage::kNormal: {
+      const double seconds_elapsed = std::min(
+          std::chrono::duration<double>(now - last_update_time_).count(), 1.0);
+      estimate_ = std::min(
+          estimate_ * std::pow(kIncreaseFactorPerSecond, seconds_elapsed),
+          max_estimate);
+      break;
+    }
+  }
+  last_update_time_ = now;
+}
+
+// static
+constexpr int DelayBasedCongestionController::kTrendlineWindowSize;
+
+}  // namespace openscreen::cast
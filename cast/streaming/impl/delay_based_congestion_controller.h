@@ -0,0 +1,133 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAST_STREAMING_IMPL_DELAY_BASED_CONGESTION_CONTROLLER_H_
+#define CAST_STREAMING_IMPL_DELAY_BASED_CONGESTION_CONTROLLER_H_
+
+#include <array>
+#include <deque>
+
+#include "cast/streaming/impl/congestion_controller.h"
+#include "platform/api/time.h"
+
+namespace openscreen::cast {
+
+// A CongestionController, in the spirit of Google Congestion Control (GCC),
+// that detects congestion from growing queueing delay. On shared-medium
+// networks such as 802.11 WiFi, queues build up at the bottleneck long before
+// packets are lost, and long before BandwidthEstimator notices that fewer
+// payload bytes are being acknowledged.
+//
+// Each delivered frame (see OnFrameDelivered()) is one delay sample: the time
+// from the sending of its last packet until the arrival of its ACK. The change
+// in that time from one frame to the next (the "delay variation") is
+// accumulated and smoothed, and a trendline is fitted over the most recent
+// samples. A rising trendline means a queue is building at the bottleneck
+// (over-use), and a falling one that it is draining (under-use).
+//
+// The estimate is then driven by an AIMD rate controller:
+//
+//   1. On over-use, the estimate is immediately decreased to a fraction of the
+//      throughput being delivered to the Receivers, at most once per round
+//      trip.
+//
+//   2. On under-use, the estimate is held while the queue drains.
+//
+//   3. Otherwise, the estimate grows gradually, but to no more than a multiple
+//      of the delivered throughput, since a network that is not being fully
+//      used provides no evidence of more capacity.
+class DelayBasedCongestionController final : public CongestionController {
+ public:
+  enum class Usage { kNormal, kOverusing, kUnderusing };
+
+  // `start_time` should be a recent point-in-time before the first packet is
+  // sent.
+  explicit DelayBasedCongestionController(Clock::time_point start_time);
+  ~DelayBasedCongestionController() final;
+
+  // The most recent detection of the network's usage, from the trend in the
+  // queueing delay.
+  Usage usage() const { return usage_; }
+
+  // CongestionController overrides.
+  void OnBurstComplete(int num_packets_sent, Clock::time_point when) final;
+  void OnRtcpReceived(Clock::time_point arrival_time,
+                      Clock::duration estimated_round_trip_time) final;
+  void OnPayloadReceived(int payload_bytes_acknowledged,
+                         Clock::time_point ack_arrival_time,
+                         Clock::duration estimated_round_trip_time) final;
+  void OnFrameDelivered(int payload_bytes,
+                        Clock::time_point last_packet_send_time,
+                        Clock::time_point ack_arrival_time) final;
+
+  // Returns 0 until enough frames have been delivered to measure the
+  // throughput.
+  int ComputeNetworkBandwidth() const final;
+
+ private:
+  // The number of recent delay samples the trendline is fitted to.
+  static constexpr int kTrendlineWindowSize = 10;
+
+  struct DelaySample {
+    // Milliseconds since `start_time_` that the sample's ACK arrived.
+    double arrival_time_ms;
+
+    // The smoothed delay variation accumulated since the first sample.
+    double smoothed_delay_ms;
+  };
+
+  struct Delivery {
+    Clock::time_point arrival_time;
+    int payload_bytes;
+  };
+
+  // Adds a delay sample and re-detects the network's usage.
+  void UpdateDelayTrend(Clock::time_point last_packet_send_time,
+                        Clock::time_point ack_arrival_time);
+
+  // Records a delivery and returns the throughput over the recent throughput
+  // measurement window, in bits per second, or 0 if the window is not yet
+  // filled.
+  double UpdateThroughput(int payload_bytes, Clock::time_point arrival_time);
+
+  // Adjusts the estimate for the current usage and `throughput`.
+  void UpdateEstimate(double throughput, Clock::time_point now);
+
+  const Clock::time_point start_time_;
+
+  // The times of the previous delay sample, if any.
+  bool has_previous_sample_ = false;
+  Clock::time_point previous_send_time_;
+  Clock::time_point previous_arrival_time_;
+
+  double accumulated_delay_ms_ = 0;
+  double smoothed_delay_ms_ = 0;
+
+  // A ring buffer of the most recent delay samples, and the total number of
+  // samples ever added to it.
+  std::array<DelaySample, kTrendlineWindowSize> trendline_samples_{};
+  int num_delay_samples_ = 0;
+
+  // The number of consecutive samples for which the trend exceeded the
+  // over-use threshold.
+  int num_overusing_samples_ = 0;
+  Usage usage_ = Usage::kNormal;
+
+  // The deliveries in the throughput measurement window, and their total
+  // payload bytes.
+  std::deque<Delivery> recent_deliveries_;
+  int recent_payload_bytes_ = 0;
+  Clock::time_point first_delivery_time_ = Clock::time_point::max();
+
+  Clock::duration round_trip_time_{};
+  Clock::time_point last_update_time_;
+  Clock::time_point last_decrease_time_;
+
+  // The current estimate, in bits per second, or zero if none yet.
+  double estimate_ = 0;
+};
+
+}  // namespace openscreen::cast
+
+#endif  // CAST_STREAMING_IMPL_DELAY_BASED_CONGESTION_CONTROLLER_H_
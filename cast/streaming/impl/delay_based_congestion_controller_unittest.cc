@@ -0,0 +1,403 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/impl/delay_based_congestion_controller.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "cast/streaming/impl/bandwidth_estimator.h"
+#include "cast/streaming/public/constants.h"
+#include "cast/streaming/public/environment.h"
+#include "cast/streaming/sender_packet_router.h"
+#include "cast/streaming/testing/simulated_network.h"
+#include "gtest/gtest.h"
+#include "platform/api/time.h"
+#include "platform/base/udp_packet.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/big_endian.h"
+#include "util/chrono_helpers.h"
+#include "util/osp_logging.h"
+#include "util/raw_ref.h"
+
+namespace openscreen::cast {
+namespace {
+
+using Usage = DelayBasedCongestionController::Usage;
+
+// Use a fake, fixed start time.
+constexpr Clock::time_point kStartTime =
+    Clock::time_point() + Clock::duration(1234567890);
+
+constexpr int kFramesPerSecond = 30;
+constexpr Clock::duration kFrameInterval =
+    microseconds(1'000'000 / kFramesPerSecond);
+constexpr Clock::duration kRoundTripTime = milliseconds(40);
+
+// Delivers one frame of `payload_bytes` every kFrameInterval, for `duration`,
+// with the network's round trip time increasing by `delay_growth` per frame.
+// Returns the time after the last frame.
+Clock::time_point DeliverFrames(DelayBasedCongestionController& controller,
+                                Clock::time_point send_time,
+                                Clock::duration duration,
+                                int payload_bytes,
+                                Clock::duration& round_trip_time,
+                                Clock::duration delay_growth) {
+  const Clock::time_point end_time = send_time + duration;
+  for (; send_time < end_time; send_time += kFrameInterval) {
+    round_trip_time += delay_growth;
+    controller.OnRtcpReceived(send_time + round_trip_time, kRoundTripTime);
+    controller.OnFrameDelivered(payload_bytes, send_time,
+                                send_time + round_trip_time);
+  }
+  return send_time;
+}
+
+TEST(DelayBasedCongestionControllerTest, DoesNotEstimateUntilFramesDelivered) {
+  DelayBasedCongestionController controller(kStartTime);
+  EXPECT_EQ(0, controller.ComputeNetworkBandwidth());
+
+  // Bursts and ACKs without frame timing are not enough.
+  controller.OnBurstComplete(10, kStartTime);
+  controller.OnRtcpReceived(kStartTime + kRoundTripTime, kRoundTripTime);
+  controller.OnPayloadReceived(10000, kStartTime + kRoundTripTime,
+                               kRoundTripTime);
+  EXPECT_EQ(0, controller.ComputeNetworkBandwidth());
+
+  Clock::duration round_trip_time = kRoundTripTime;
+  const Clock::time_point t =
+      DeliverFrames(controller, kStartTime, milliseconds(400), 10000,
+                    round_trip_time, Clock::duration::zero());
+  EXPECT_EQ(0, controller.ComputeNetworkBandwidth());
+  DeliverFrames(controller, t, milliseconds(200), 10000, round_trip_time,
+                Clock::duration::zero());
+  EXPECT_LT(0, controller.ComputeNetworkBandwidth());
+}
+
+// Tests that, while the network's delay is steady, the estimate stays at a
+// multiple of the delivered throughput, rather than growing without bound.
+TEST(DelayBasedCongestionControllerTest, LimitsEstimateWhileDelayIsSteady) {
+  DelayBasedCongestionController controller(kStartTime);
+  constexpr int kPayloadBytes = 10000;
+  constexpr int kThroughput = kPayloadBytes * 8 * kFramesPerSecond;
+
+  Clock::duration round_trip_time = kRoundTripTime;
+  DeliverFrames(controller, kStartTime, seconds(10), kPayloadBytes,
+                round_trip_time, Clock::duration::zero());
+  EXPECT_EQ(Usage::kNormal, controller.usage());
+  EXPECT_NEAR(1.5 * kThroughput, controller.ComputeNetworkBandwidth(),
+              0.1 * kThroughput);
+}
+
+// Tests that the estimate is decreased below the delivered throughput as soon
+// as a queue starts building at the bottleneck, and is then held while the
+// queue drains.
+TEST(DelayBasedCongestionControllerTest, BacksOffWhenQueueingDelayGrows) {
+  DelayBasedCongestionController controller(kStartTime);
+  constexpr int kPayloadBytes = 10000;
+  constexpr int kThroughput = kPayloadBytes * 8 * kFramesPerSecond;
+
+  Clock::duration round_trip_time = kRoundTripTime;
+  Clock::time_point t =
+      DeliverFrames(controller, kStartTime, seconds(2), kPayloadBytes,
+                    round_trip_time, Clock::duration::zero());
+  ASSERT_EQ(Usage::kNormal, controller.usage());
+
+  // Each frame spends another 3 ms in the queue than the one before it. Within
+  // half a second, the queueing delay has grown by 45 ms.
+  t = DeliverFrames(controller, t, milliseconds(500), kPayloadBytes,
+                    round_trip_time, milliseconds(3));
+  EXPECT_EQ(Usage::kOverusing, controller.usage());
+  EXPECT_GT(kThroughput, controller.ComputeNetworkBandwidth());
+
+  // While the queue drains, the estimate is not increased.
+  t = DeliverFrames(controller, t, milliseconds(300), kPayloadBytes,
+                    round_trip_time, milliseconds(-3));
+  ASSERT_EQ(Usage::kUnderusing, controller.usage());
+  const int estimate = controller.ComputeNetworkBandwidth();
+  DeliverFrames(controller, t, milliseconds(200), kPayloadBytes,
+                round_trip_time, milliseconds(-3));
+  EXPECT_EQ(Usage::kUnderusing, controller.usage());
+  EXPECT_EQ(estimate, controller.ComputeNetworkBandwidth());
+}
+
+// A deterministic simulation of a Sender streaming over a SimulatedNetwork
+// whose bottleneck link has a drop-tail queue, driven by a FakeClock. Frames
+// are encoded at a bitrate that follows the bandwidth estimate of the given
+// CongestionController, in the same way as the standalone sender does, and are
+// sent in bursts like a SenderPacketRouter does. No packets are retransmitted,
+// so a frame that loses a packet is dropped.
+class BottleneckSimulation {
+ public:
+  static constexpr int kPacketSize = 1400;
+  static constexpr int kMaxPacketsPerBurst =
+      SenderPacketRouter::kDefaultMaxBurstBitrate / 8 / kPacketSize /
+      (1000 / SenderPacketRouter::kDefaultBurstInterval.count());
+
+  struct Results {
+    // The bitrate of the payload of the frames that completed on time.
+    int goodput;
+
+    // The mean and maximum time that packets spent in the bottleneck's queue.
+    Clock::duration mean_queueing_delay;
+    Clock::duration max_queueing_delay;
+
+    // The number of frames that lost a packet, or completed too late to be
+    // played out.
+    int frames_dropped;
+  };
+
+  BottleneckSimulation(CongestionController& controller, int capacity)
+      : controller_(controller),
+        network_(&FakeClock::now,
+                 task_runner_,
+                 {.bandwidth = capacity,
+                  .queue_size = kQueueSize,
+                  .delay = kOneWayDelay},
+                 {.delay = kOneWayDelay}) {
+    network_.receiver_environment().ConsumeIncomingPackets(&receiver_);
+    network_.sender_environment().ConsumeIncomingPackets(&sender_);
+    task_runner_.PostTask([this] { EncodeNextFrame(); });
+    task_runner_.PostTask([this] { SendBurst(); });
+    task_runner_.PostTask([this] { SendReceiverReport(); });
+    task_runner_.PostTask([this] { ControlForNetworkCongestion(); });
+  }
+
+  ~BottleneckSimulation() {
+    network_.receiver_environment().DropIncomingPackets();
+    network_.sender_environment().DropIncomingPackets();
+  }
+
+  void set_capacity(int capacity) {
+    SimulatedLinkConfig config = network_.sender_to_receiver().config();
+    config.bandwidth = capacity;
+    network_.sender_to_receiver().set_config(config);
+  }
+
+  void RunFor(Clock::duration duration) {
+    clock_.Advance(duration);
+    run_time_ += duration;
+  }
+
+  Results GetResults() {
+    Results results{};
+    int64_t payload_bytes = 0;
+    for (const Frame& frame : frames_) {
+      // Frames that could still be played out are neither on time nor late.
+      if (frame.capture_time + kTargetPlayoutDelay > FakeClock::now()) {
+        continue;
+      }
+      if (frame.is_on_time) {
+        payload_bytes += frame.payload_bytes;
+      } else {
+        ++results.frames_dropped;
+      }
+    }
+    results.goodput = static_cast<int>(
+        payload_bytes * 8 / std::chrono::duration<double>(run_time_).count());
+    const SimulatedLink::Stats& stats = network_.sender_to_receiver().stats();
+    const int num_packets_transmitted =
+        stats.packets_delivered + stats.packets_lost;
+    if (num_packets_transmitted > 0) {
+      results.mean_queueing_delay =
+          stats.total_queueing_delay / num_packets_transmitted;
+    }
+    results.max_queueing_delay = stats.max_queueing_delay;
+    return results;
+  }
+
+ private:
+  static constexpr int kQueueSize = 256 * 1024;
+  static constexpr Clock::duration kOneWayDelay = milliseconds(20);
+  static constexpr milliseconds kTargetPlayoutDelay{400};
+  static constexpr milliseconds kCongestionCheckInterval{500};
+  static constexpr int kMinBitrate = 384 << 10;
+  static constexpr int kMaxBitrate = 5 << 20;
+
+  // The size of the Receiver's feedback packets, and the frame index that
+  // marks a periodic receiver report, rather than the feedback for a frame.
+  static constexpr int kFeedbackPacketSize = 32;
+  static constexpr uint32_t kReceiverReportIndex = UINT32_MAX;
+
+  struct Frame {
+    Clock::time_point capture_time;
+    int payload_bytes = 0;
+    int num_packets = 0;
+    int num_packets_received = 0;
+    bool is_on_time = false;
+    Clock::time_point last_packet_send_time;
+  };
+
+  // Passes the index of the frame in each packet arriving at one end of the
+  // SimulatedNetwork to a method of the simulation.
+  class FrameIndexConsumer final : public Environment::PacketConsumer {
+   public:
+    FrameIndexConsumer(BottleneckSimulation& simulation,
+                       void (BottleneckSimulation::*method)(uint32_t))
+        : simulation_(simulation), method_(method) {}
+
+    void OnReceivedPacket(const IPEndpoint& source,
+                          Clock::time_point arrival_time,
+                          UdpPacket packet) final {
+      OSP_CHECK_GE(packet.size(), sizeof(uint32_t));
+      ((*simulation_).*method_)(ReadBigEndian<uint32_t>(packet.data()));
+    }
+
+   private:
+    const raw_ref<BottleneckSimulation> simulation_;
+    void (BottleneckSimulation::*const method_)(uint32_t);
+  };
+
+  // Returns a packet of `size` bytes that carries `frame_index`.
+  static std::vector<uint8_t> MakePacket(uint32_t frame_index, int size) {
+    std::vector<uint8_t> packet(size);
+    WriteBigEndian<uint32_t>(frame_index, packet.data());
+    return packet;
+  }
+
+  void EncodeNextFrame() {
+    Frame& frame = frames_.emplace_back();
+    frame.capture_time = FakeClock::now();
+    frame.payload_bytes = encoder_bitrate_ / 8 / kFramesPerSecond;
+    const uint32_t frame_index = static_cast<uint32_t>(frames_.size()) - 1;
+    for (int remaining = frame.payload_bytes; remaining > 0;
+         remaining -= kPacketSize) {
+      send_queue_.push_back(
+          MakePacket(frame_index, std::min(remaining, kPacketSize)));
+      ++frame.num_packets;
+    }
+    task_runner_.PostTaskWithDelay([this] { EncodeNextFrame(); },
+                                   kFrameInterval);
+  }
+
+  void SendBurst() {
+    const Clock::time_point now = FakeClock::now();
+    int num_packets_sent = 0;
+    for (; num_packets_sent < kMaxPacketsPerBurst && !send_queue_.empty();
+         ++num_packets_sent) {
+      const std::vector<uint8_t>& packet = send_queue_.front();
+      frames_[ReadBigEndian<uint32_t>(packet.data())].last_packet_send_time =
+          now;
+      network_.sender_environment().SendPacket(packet, PacketMetadata{});
+      send_queue_.pop_front();
+    }
+    controller_.OnBurstComplete(num_packets_sent, now);
+    task_runner_.PostTaskWithDelay([this] { SendBurst(); },
+                                   SenderPacketRouter::kDefaultBurstInterval);
+  }
+
+  // Called at the Receiver for each packet of a frame.
+  void OnPacketReceived(uint32_t frame_index) {
+    Frame& frame = frames_[frame_index];
+    if (++frame.num_packets_received < frame.num_packets) {
+      return;
+    }
+    frame.is_on_time =
+        FakeClock::now() <= frame.capture_time + kTargetPlayoutDelay;
+    // The Receiver sends its feedback as soon as the frame is complete.
+    network_.receiver_environment().SendPacket(
+        MakePacket(frame_index, kFeedbackPacketSize), PacketMetadata{});
+  }
+
+  // Called at the Sender for each feedback packet from the Receiver.
+  void OnFeedbackReceived(uint32_t frame_index) {
+    const Clock::time_point now = FakeClock::now();
+    controller_.OnRtcpReceived(now, kRoundTripTime);
+    if (frame_index == kReceiverReportIndex) {
+      return;
+    }
+    const Frame& frame = frames_[frame_index];
+    controller_.OnPayloadReceived(frame.payload_bytes, now, kRoundTripTime);
+    controller_.OnFrameDelivered(frame.payload_bytes,
+                                 frame.last_packet_send_time, now);
+  }
+
+  void SendReceiverReport() {
+    network_.receiver_environment().SendPacket(
+        MakePacket(kReceiverReportIndex, kFeedbackPacketSize),
+        PacketMetadata{});
+    task_runner_.PostTaskWithDelay([this] { SendReceiverReport(); },
+                                   kRtcpReportInterval);
+  }
+
+  // Like LoopingFileSender::ControlForNetworkCongestion().
+  void ControlForNetworkCongestion() {
+    const int estimate = controller_.ComputeNetworkBandwidth();
+    if (estimate > 0) {
+      const int usable_bandwidth = std::max<int>(0.8 * estimate, kMinBitrate);
+      if (usable_bandwidth > encoder_bitrate_) {
+        encoder_bitrate_ =
+            std::min<int>(encoder_bitrate_ * 1.1, usable_bandwidth);
+      } else {
+        encoder_bitrate_ = usable_bandwidth;
+      }
+      encoder_bitrate_ = std::min(encoder_bitrate_, kMaxBitrate);
+    }
+    task_runner_.PostTaskWithDelay([this] { ControlForNetworkCongestion(); },
+                                   kCongestionCheckInterval);
+  }
+
+  FakeClock clock_{kStartTime};
+  FakeTaskRunner task_runner_{clock_};
+  CongestionController& controller_;
+  SimulatedNetwork network_;
+  FrameIndexConsumer receiver_{*this, &BottleneckSimulation::OnPacketReceived};
+  FrameIndexConsumer sender_{*this, &BottleneckSimulation::OnFeedbackReceived};
+  Clock::duration run_time_{};
+
+  int encoder_bitrate_ = 1 << 20;
+  std::vector<Frame> frames_;
+  std::deque<std::vector<uint8_t>> send_queue_;
+};
+
+// Streams over a link whose capacity drops, as when a WiFi client moves away
+// from its access point. The BandwidthEstimator only notices once fewer payload
+// bytes are being acknowledged, by which time the bottleneck's queue is full;
+// whereas the DelayBasedCongestionController backs off as soon as the queue
+// starts to build.
+TEST(DelayBasedCongestionControllerTest, OutperformsBandwidthEstimatorOnWifi) {
+  constexpr int kInitialCapacity = 6 << 20;
+  constexpr int kDegradedCapacity = 2 << 20;
+
+  const auto simulate = [](CongestionController& controller) {
+    BottleneckSimulation simulation(controller, kInitialCapacity);
+    simulation.RunFor(seconds(10));
+    simulation.set_capacity(kDegradedCapacity);
+    simulation.RunFor(seconds(10));
+    return simulation.GetResults();
+  };
+
+  BandwidthEstimator bandwidth_estimator(
+      BottleneckSimulation::kMaxPacketsPerBurst,
+      SenderPacketRouter::kDefaultBurstInterval, kStartTime);
+  const BottleneckSimulation::Results baseline = simulate(bandwidth_estimator);
+  DelayBasedCongestionController delay_based(kStartTime);
+  const BottleneckSimulation::Results results = simulate(delay_based);
+
+  OSP_LOG_INFO << "BandwidthEstimator: goodput=" << baseline.goodput
+               << ", mean_queueing_delay="
+               << to_milliseconds(baseline.mean_queueing_delay).count()
+               << " ms, max_queueing_delay="
+               << to_milliseconds(baseline.max_queueing_delay).count()
+               << " ms, frames_dropped=" << baseline.frames_dropped;
+  OSP_LOG_INFO << "DelayBasedCongestionController: goodput=" << results.goodput
+               << ", mean_queueing_delay="
+               << to_milliseconds(results.mean_queueing_delay).count()
+               << " ms, max_queueing_delay="
+               << to_milliseconds(results.max_queueing_delay).count()
+               << " ms, frames_dropped=" << results.frames_dropped;
+
+  EXPECT_LT(results.mean_queueing_delay, baseline.mean_queueing_delay);
+  EXPECT_LT(results.max_queueing_delay, baseline.max_queueing_delay);
+  EXPECT_LT(results.frames_dropped, baseline.frames_dropped);
+  // The lower delay is not bought with a much lower throughput.
+  EXPECT_GT(results.goodput, baseline.goodput * 9 / 10);
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -0,0 +1,158 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/public/environment.h"
+
+#include <stdint.h>
+
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "cast/streaming/testing/mock_environment.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/api/udp_socket.h"
+#include "platform/base/ip_address.h"
+#include "platform/base/udp_packet.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/chrono_helpers.h"
+#include "util/raw_ref.h"
+
+namespace openscreen::cast {
+namespace {
+
+constexpr size_t kNumPackets = 3;
+
+// Records every packet delivered to it, and optionally stops consuming once it
+// has received `stop_after` of them.
+class RecordingConsumer : public Environment::PacketConsumer {
+ public:
+  struct Received {
+    IPEndpoint source;
+    Clock::time_point arrival_time;
+    UdpPacket packet;
+  };
+
+  RecordingConsumer(Environment& environment, size_t stop_after)
+      : environment_(environment), stop_after_(stop_after) {}
+  ~RecordingConsumer() override = default;
+
+  const std::vector<Received>& received() const { return received_; }
+
+  // Environment::PacketConsumer implementation.
+  void OnReceivedPacket(const IPEndpoint& source,
+                        Clock::time_point arrival_time,
+                        UdpPacket packet) override {
+    received_.push_back(Received{source, arrival_time, std::move(packet)});
+    if (received_.size() == stop_after_) {
+      environment_->DropIncomingPackets();
+    }
+  }
+
+ private:
+  const raw_ref<Environment> environment_;
+  const size_t stop_after_;
+  std::vector<Received> received_;
+};
+
+// Handles each batch as a whole, recording its size.
+class BatchConsumer : public Environment::PacketConsumer {
+ public:
+  ~BatchConsumer() override = default;
+
+  const std::vector<size_t>& batch_sizes() const { return batch_sizes_; }
+
+  // Environment::PacketConsumer implementation.
+  void OnReceivedPacket(const IPEndpoint& source,
+                        Clock::time_point arrival_time,
+                        UdpPacket packet) override {
+    ADD_FAILURE() << "Packets of a batch should be delivered together.";
+  }
+  void OnReceivedPackets(Clock::time_point arrival_time,
+                         std::span<UdpPacket> packets) override {
+    batch_sizes_.push_back(packets.size());
+  }
+
+ private:
+  std::vector<size_t> batch_sizes_;
+};
+
+class EnvironmentTest : public testing::Test {
+ public:
+  EnvironmentTest()
+      : clock_(Clock::now()),
+        task_runner_(clock_),
+        environment_(&FakeClock::now, task_runner_) {}
+
+ protected:
+  // Returns a batch of packets, as the socket would read them in one wakeup.
+  static std::vector<UdpPacket> MakeBatch() {
+    std::vector<UdpPacket> batch;
+    for (size_t i = 0; i < kNumPackets; ++i) {
+      UdpPacket packet(/* size */ 4, /* fill_value */ static_cast<uint8_t>(i));
+      packet.set_source(
+          IPEndpoint{IPAddress(192, 168, 0, 1), static_cast<uint16_t>(i + 1)});
+      batch.push_back(std::move(packet));
+    }
+    return batch;
+  }
+
+  // Delivers `batch` as the Environment's socket would.
+  void DeliverBatch(std::vector<UdpPacket> batch) {
+    static_cast<UdpSocket::Client&>(environment_)
+        .OnReadBatch(nullptr, std::move(batch));
+  }
+
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  testing::NiceMock<MockEnvironment> environment_;
+};
+
+// Tests that every packet of a batch is delivered, in order, with the time the
+// batch was read as the arrival time of each.
+TEST_F(EnvironmentTest, DeliversBatchInOrderWithOneArrivalTime) {
+  RecordingConsumer consumer(environment_, /* stop_after */ 0);
+  environment_.ConsumeIncomingPackets(&consumer);
+
+  clock_.Advance(milliseconds(5));
+  const Clock::time_point read_time = FakeClock::now();
+  DeliverBatch(MakeBatch());
+
+  ASSERT_EQ(kNumPackets, consumer.received().size());
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    const RecordingConsumer::Received& received = consumer.received()[i];
+    EXPECT_EQ(i + 1, received.source.port);
+    EXPECT_EQ(read_time, received.arrival_time);
+    EXPECT_THAT(received.packet, testing::Each(static_cast<uint8_t>(i)));
+    EXPECT_EQ(4u, received.packet.size());
+  }
+}
+
+// Tests that a consumer handling whole batches is given each batch in one call.
+TEST_F(EnvironmentTest, DeliversWholeBatchToBatchConsumer) {
+  BatchConsumer consumer;
+  environment_.ConsumeIncomingPackets(&consumer);
+
+  DeliverBatch(MakeBatch());
+  DeliverBatch(MakeBatch());
+  EXPECT_THAT(consumer.batch_sizes(),
+              testing::ElementsAre(kNumPackets, kNumPackets));
+}
+
+// Tests that batches are dropped once the consumer stops consuming.
+TEST_F(EnvironmentTest, DropsBatchesAfterConsumerStops) {
+  RecordingConsumer consumer(environment_, /* stop_after */ kNumPackets);
+  environment_.ConsumeIncomingPackets(&consumer);
+
+  DeliverBatch(MakeBatch());
+  ASSERT_EQ(kNumPackets, consumer.received().size());
+
+  DeliverBatch(MakeBatch());
+  EXPECT_EQ(kNumPackets, consumer.received().size());
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <utility>
 
 #include "cast/streaming/impl/rtp_defines.h"
 #include "cast/streaming/public/frame_id.h"
@@ -28,7 +29,7 @@ FrameCollector::FrameCollector()
 FrameCollector::~FrameCollector() = default;
 
 bool FrameCollector::CollectRtpPacket(const RtpPacketParser::ParseResult& part,
-                                      std::vector<uint8_t>* buffer) {
+                                      UdpPacket* buffer) {
   OSP_CHECK(!frame_.frame_id.is_null());
 
   if (part.frame_id != frame_.frame_id) {
@@ -63,6 +64,10 @@ bool FrameCollector::CollectRtpPacket(const RtpPacketParser::ParseResult& part,
     return false;
   }
 
+  if (part.fec_parity) {
+    return CollectParityPacket(part, buffer);
+  }
+
   // Don't process duplicate packets.
   if (chunks_[part.packet_id].has_data()) {
     // Note: No logging here because this is a common occurrence that is not
@@ -70,35 +75,196 @@ bool FrameCollector::CollectRtpPacket(const RtpPacketParser::ParseResult& part,
     return true;
   }
 
+  if (part.packet_id == FramePacketId{0}) {
+    PopulateFrameMetadata(part);
+  }
+
+  StorePayload(part.packet_id, part.payload, buffer);
+
+  // Success!
+  --num_missing_packets_;
+  OSP_CHECK_GE(num_missing_packets_, 0);
+
+  // With this packet collected, another one of its group may be recoverable.
+  for (const ParityChunk& parity : parity_chunks_) {
+    if (part.packet_id >= parity.first_packet_id &&
+        part.packet_id <
+            parity.first_packet_id + parity.num_protected_packets) {
+      MaybeRecoverPacket(parity);
+    }
+  }
+  return true;
+}
+
+void FrameCollector::PopulateFrameMetadata(
+    const RtpPacketParser::ParseResult& part) {
   // Populate metadata from packet 0 only, which is the only packet that must
   // contain a complete set of values.
+  if (part.is_key_frame) {
+    frame_.dependency = EncodedFrame::Dependency::kKeyFrame;
+  } else if (part.frame_id == part.referenced_frame_id) {
+    frame_.dependency = EncodedFrame::Dependency::kIndependent;
+  } else {
+    frame_.dependency = EncodedFrame::Dependency::kDependent;
+  }
+  frame_.referenced_frame_id = part.referenced_frame_id;
+  frame_.rtp_timestamp = part.rtp_timestamp;
+  frame_.new_playout_delay = part.new_playout_delay;
+}
+
+bool FrameCollector::CollectParityPacket(
+    const RtpPacketParser::ParseResult& part,
+    UdpPacket* buffer) {
+  // The parser has already checked that the protected packets exist.
+  OSP_CHECK_LE(part.packet_id + part.fec_parity->num_protected_packets,
+               static_cast<int>(chunks_.size()));
+
+  // Don't process duplicate packets.
+  for (const ParityChunk& parity : parity_chunks_) {
+    if (parity.first_packet_id == part.packet_id) {
+      return true;
+    }
+  }
+
+  // The parity packet protecting packet 0 carries the same metadata.
   if (part.packet_id == FramePacketId{0}) {
-    if (part.is_key_frame) {
-      frame_.dependency = EncodedFrame::Dependency::kKeyFrame;
-    } else if (part.frame_id == part.referenced_frame_id) {
-      frame_.dependency = EncodedFrame::Dependency::kIndependent;
+    PopulateFrameMetadata(part);
+  }
+
+  ParityChunk& parity = parity_chunks_.emplace_back();
+  parity.parity.buffer = std::move(*buffer);
+  parity.parity.payload = part.payload;
+  parity.first_packet_id = part.packet_id;
+  parity.num_protected_packets = part.fec_parity->num_protected_packets;
+  parity.payload_size_xor = part.fec_parity->payload_size_xor;
+
+  MaybeRecoverPacket(parity);
+  return true;
+}
+
+void FrameCollector::MaybeRecoverPacket(const ParityChunk& parity) {
+  const int end = parity.first_packet_id + parity.num_protected_packets;
+  int missing_packet_id = -1;
+  size_t missing_size = parity.payload_size_xor;
+  for (int packet_id = parity.first_packet_id; packet_id < end; ++packet_id) {
+    if (chunks_[packet_id].has_data()) {
+      missing_size ^= chunks_[packet_id].payload.size();
+    } else if (missing_packet_id == -1) {
+      missing_packet_id = packet_id;
     } else {
-      frame_.dependency = EncodedFrame::Dependency::kDependent;
+      return;  // More than one packet is missing.
+    }
+  }
+  if (missing_packet_id == -1) {
+    return;  // Nothing is missing.
+  }
+  if (missing_size > parity.parity.payload.size()) {
+    OSP_LOG_WARN << "Ignoring potentially corrupt parity packet for frame "
+                 << frame_.frame_id << " (payload sizes mismatch).";
+    return;
+  }
+
+  // XOR the parity with the other packets of the group. The buffer is never
+  // empty, so that the recovered chunk has_data() even if its payload is.
+  UdpPacket recovered(std::max<size_t>(missing_size, 1));
+  std::copy(parity.parity.payload.begin(),
+            parity.parity.payload.begin() + missing_size, recovered.begin());
+  std::vector<uint8_t> ciphertext;
+  for (int packet_id = parity.first_packet_id; packet_id < end; ++packet_id) {
+    ByteView payload = chunks_[packet_id].payload;
+    if (chunks_[packet_id].is_decrypted) {
+      // The parity was computed from the encrypted payload.
+      ciphertext.resize(payload.size());
+      crypto_->DecryptAt(frame_.frame_id, packet_id * packet_stride_, payload,
+                         ciphertext);
+      payload = ciphertext;
+    }
+    for (size_t i = 0; i < payload.size() && i < missing_size; ++i) {
+      recovered[i] ^= payload[i];
     }
-    frame_.referenced_frame_id = part.referenced_frame_id;
-    frame_.rtp_timestamp = part.rtp_timestamp;
-    frame_.new_playout_delay = part.new_playout_delay;
   }
 
+  const ByteView payload(recovered.data(), missing_size);
+  StorePayload(missing_packet_id, payload, &recovered);
+  --num_missing_packets_;
+  OSP_CHECK_GE(num_missing_packets_, 0);
+}
+
+void FrameCollector::StorePayload(int packet_id,
+                                  ByteView payload,
+                                  UdpPacket* buffer) {
   // Take ownership of the contents of the `buffer` (no copy!), and record the
   // region of the buffer containing the payload data. The payload region is
   // usually all but the first few dozen bytes of the buffer.
-  PayloadChunk& chunk = chunks_[part.packet_id];
-  chunk.buffer.swap(*buffer);
-  chunk.payload = part.payload;
+  PayloadChunk& chunk = chunks_[packet_id];
+  chunk.buffer = std::move(*buffer);
+  chunk.payload = payload;
   OSP_CHECK_GE(chunk.payload.data(), chunk.buffer.data());
   OSP_CHECK_LE(chunk.payload.data() + chunk.payload.size(),
                chunk.buffer.data() + chunk.buffer.size());
 
-  // Success!
-  --num_missing_packets_;
-  OSP_CHECK_GE(num_missing_packets_, 0);
-  return true;
+  if (!crypto_ || !is_contiguous_) {
+    return;
+  }
+  if (!frame_buffer_.empty()) {
+    MoveIntoFrameBuffer(packet_id);
+    return;
+  }
+
+  // The last packet may carry less payload than the others, so it does not
+  // determine the stride unless it is the only one.
+  const int frame_packet_count = static_cast<int>(chunks_.size());
+  if (packet_id == frame_packet_count - 1 && frame_packet_count > 1) {
+    return;
+  }
+  if (payload.empty() && frame_packet_count > 1) {
+    FallBackToEncryptedChunks();
+    return;
+  }
+  packet_stride_ = payload.size();
+  // The buffer is never empty, so that a chunk within it has_data() even if its
+  // payload is empty.
+  frame_buffer_.resize(
+      std::max<size_t>(frame_packet_count * packet_stride_, 1));
+  for (int i = 0; i < frame_packet_count && is_contiguous_; ++i) {
+    if (chunks_[i].has_data()) {
+      MoveIntoFrameBuffer(i);
+    }
+  }
+}
+
+void FrameCollector::MoveIntoFrameBuffer(int packet_id) {
+  PayloadChunk& chunk = chunks_[packet_id];
+  const bool is_last_packet = packet_id == static_cast<int>(chunks_.size()) - 1;
+  if (is_last_packet ? chunk.payload.size() > packet_stride_
+                     : chunk.payload.size() != packet_stride_) {
+    OSP_VLOG << "Packets of frame " << frame_.frame_id
+             << " have uneven payload sizes; decrypting it when consumed.";
+    FallBackToEncryptedChunks();
+    return;
+  }
+
+  const size_t offset = packet_id * packet_stride_;
+  const ByteBuffer destination =
+      ByteBuffer(frame_buffer_).subspan(offset, chunk.payload.size());
+  crypto_->DecryptAt(frame_.frame_id, offset, chunk.payload, destination);
+  chunk.buffer = UdpPacket();
+  chunk.payload = destination;
+  chunk.is_decrypted = true;
+}
+
+void FrameCollector::FallBackToEncryptedChunks() {
+  is_contiguous_ = false;
+  for (size_t packet_id = 0; packet_id < chunks_.size(); ++packet_id) {
+    PayloadChunk& chunk = chunks_[packet_id];
+    if (chunk.is_decrypted) {
+      const size_t offset = packet_id * packet_stride_;
+      const ByteBuffer payload =
+          ByteBuffer(frame_buffer_).subspan(offset, chunk.payload.size());
+      crypto_->DecryptAt(frame_.frame_id, offset, payload, payload);
+      chunk.is_decrypted = false;
+    }
+  }
 }
 
 void FrameCollector::GetMissingPackets(std::vector<PacketNack>* nacks) const {
@@ -136,8 +302,25 @@ size_t FrameCollector::GetFramePayloadSize() const {
       });
 }
 
+bool FrameCollector::is_decrypted() const {
+  OSP_CHECK(is_complete());
+  return crypto_ && is_contiguous_;
+}
+
+ByteView FrameCollector::GetDecryptedPayload() const {
+  OSP_CHECK(is_decrypted());
+  return ByteView(frame_buffer_).first(GetFramePayloadSize());
+}
+
+std::vector<uint8_t> FrameCollector::TakeDecryptedPayload() {
+  const size_t payload_size = GetDecryptedPayload().size();
+  frame_buffer_.resize(payload_size);
+  return std::move(frame_buffer_);
+}
+
 std::vector<ByteView> FrameCollector::GetPayloadChunks() const {
   OSP_CHECK(is_complete());
+  OSP_CHECK(!is_decrypted());
   std::vector<ByteView> result;
   result.reserve(chunks_.size());
   for (const PayloadChunk& chunk : chunks_) {
@@ -150,9 +333,17 @@ void FrameCollector::Reset() {
   num_missing_packets_ = kUnknownNumberOfPackets;
   frame_ = EncodedFrame();
   chunks_.clear();
+  parity_chunks_.clear();
+  is_contiguous_ = true;
+  // Free the memory, unlike clear().
+  std::vector<uint8_t>().swap(frame_buffer_);
+  packet_stride_ = 0;
 }
 
 FrameCollector::PayloadChunk::PayloadChunk() = default;
+FrameCollector::PayloadChunk::PayloadChunk(PayloadChunk&&) noexcept = default;
+FrameCollector::PayloadChunk& FrameCollector::PayloadChunk::operator=(
+    PayloadChunk&&) = default;
 FrameCollector::PayloadChunk::~PayloadChunk() = default;
 
 }  // namespace openscreen::cast
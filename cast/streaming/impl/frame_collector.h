@@ -5,6 +5,8 @@
 #ifndef CAST_STREAMING_IMPL_FRAME_COLLECTOR_H_
 #define CAST_STREAMING_IMPL_FRAME_COLLECTOR_H_
 
+#include <stdint.h>
+
 #include <vector>
 
 #include "cast/streaming/impl/frame_crypto.h"
@@ -12,11 +14,20 @@
 #include "cast/streaming/impl/rtp_packet_parser.h"
 #include "cast/streaming/public/frame_id.h"
 #include "platform/base/span.h"
+#include "platform/base/udp_packet.h"
+#include "util/raw_ptr.h"
 
 namespace openscreen::cast {
 
 // Used by a Receiver to collect the parts of a frame, track what is
 // missing/complete, and assemble a complete frame.
+//
+// If given a FrameCrypto, the collector decrypts the payload as packets arrive,
+// directly into one buffer for the whole frame, and releases each packet's
+// buffer right away. Every packet of a frame but the last carries the same
+// amount of payload, so the first one to arrive determines where each packet's
+// payload goes. If a packet breaks that layout, the collector falls back to
+// keeping the encrypted packets, for decryption when the frame is consumed.
 class FrameCollector {
  public:
   FrameCollector();
@@ -26,13 +37,23 @@ class FrameCollector {
   // each Reset(), and before any of the other methods.
   void set_frame_id(FrameId frame_id) { frame_.frame_id = frame_id; }
 
+  // Sets the FrameCrypto used to decrypt the payload as it is collected, or
+  // nullptr to collect encrypted payload chunks. This is kept across Reset()s,
+  // and must only be changed while no frame is being collected.
+  void set_crypto(FrameCrypto* crypto) { crypto_ = crypto; }
+
   // Examine the parsed packet, representing part of the whole frame, and
   // collect any data/metadata from it that helps complete the frame. Returns
   // false if the `part` contained invalid data. On success, this method takes
   // the data contained within the `buffer`, into which `part.payload` is
-  // pointing, in lieu of copying the data.
+  // pointing, in lieu of copying the data. If the `buffer` came from a
+  // UdpPacketPool, it is returned to the pool by Reset().
+  //
+  // The `part` may also be a Forward Error Correction parity packet, from which
+  // a data packet is recovered as soon as it is the only one of its group still
+  // missing.
   [[nodiscard]] bool CollectRtpPacket(const RtpPacketParser::ParseResult& part,
-                                      std::vector<uint8_t>* buffer);
+                                      UdpPacket* buffer);
 
   // Returns true if the frame data collection is complete and the frame can be
   // assembled.
@@ -55,9 +76,27 @@ class FrameCollector {
   // called.
   size_t GetFramePayloadSize() const;
 
-  // Returns the collected payload chunks in order.
+  // Returns true if the payload was decrypted, as it was collected, into one
+  // contiguous buffer. Otherwise, it must be decrypted from the chunks returned
+  // by GetPayloadChunks().
   // Precondition: is_complete() must return true before this method can be
   // called.
+  bool is_decrypted() const;
+
+  // Returns the decrypted payload.
+  // Precondition: is_decrypted() must return true before this method can be
+  // called.
+  ByteView GetDecryptedPayload() const;
+
+  // Moves the buffer holding the decrypted payload out of the collector, sized
+  // to the payload. The collector must then be Reset().
+  // Precondition: is_decrypted() must return true before this method can be
+  // called.
+  std::vector<uint8_t> TakeDecryptedPayload();
+
+  // Returns the collected, encrypted payload chunks in order.
+  // Precondition: is_complete() must return true, and is_decrypted() false,
+  // before this method can be called.
   std::vector<ByteView> GetPayloadChunks() const;
 
   // Resets the FrameCollector back to its initial state, freeing-up memory.
@@ -65,15 +104,54 @@ class FrameCollector {
 
  private:
   struct PayloadChunk {
-    std::vector<uint8_t> buffer;
-    ByteView payload;  // Once set, is within `buffer.data()`.
+    UdpPacket buffer;
+
+    // Once set, is within `buffer.data()`, or within `frame_buffer_` once
+    // moved there. The latter may hold the decrypted payload.
+    ByteView payload;
+    bool is_decrypted = false;
 
     PayloadChunk();
+    PayloadChunk(PayloadChunk&&) noexcept;
+    PayloadChunk& operator=(PayloadChunk&&);
     ~PayloadChunk();
 
     bool has_data() const { return !!payload.data(); }
   };
 
+  struct ParityChunk {
+    PayloadChunk parity;
+    FramePacketId first_packet_id{};
+    int num_protected_packets = 0;
+    uint16_t payload_size_xor = 0;
+  };
+
+  // Populates the frame metadata from the first packet of the frame, or from
+  // the parity packet protecting it.
+  void PopulateFrameMetadata(const RtpPacketParser::ParseResult& part);
+
+  // Helper for CollectRtpPacket(), for FEC parity packets.
+  bool CollectParityPacket(const RtpPacketParser::ParseResult& part,
+                           UdpPacket* buffer);
+
+  // Recovers the data packet protected by `parity`, if it is the only one of
+  // its group that has not been collected yet.
+  void MaybeRecoverPacket(const ParityChunk& parity);
+
+  // Stores the `payload` of a data packet, which is within the `buffer`, taking
+  // ownership of the `buffer`. With a FrameCrypto, the payload is then moved
+  // into `frame_buffer_` if possible.
+  void StorePayload(int packet_id, ByteView payload, UdpPacket* buffer);
+
+  // Decrypts the payload of the given packet into its place in
+  // `frame_buffer_`, and releases the packet's buffer. Falls back to keeping
+  // the encrypted packets if the payload does not fit there.
+  void MoveIntoFrameBuffer(int packet_id);
+
+  // Re-encrypts the payload already moved into `frame_buffer_`, and stops
+  // moving payload there.
+  void FallBackToEncryptedChunks();
+
   // Storage for frame metadata.
   EncodedFrame frame_;
 
@@ -85,6 +163,21 @@ class FrameCollector {
   // correspond 1:1 with packet IDs. When the first part is collected, this is
   // resized to match the total number of packets being expected.
   std::vector<PayloadChunk> chunks_;
+
+  // The FEC parity packets collected for the frame, if any.
+  std::vector<ParityChunk> parity_chunks_;
+
+  // If set, the payload is decrypted into `frame_buffer_` as it is collected.
+  raw_ptr<FrameCrypto> crypto_ = nullptr;
+
+  // Cleared if the frame's packets turn out not to fit `frame_buffer_`.
+  bool is_contiguous_ = true;
+
+  // Holds the payload of each packet at `packet_id * packet_stride_`, where the
+  // stride is the payload size of every packet but the last. It is allocated,
+  // for the whole frame, once the stride is known.
+  std::vector<uint8_t> frame_buffer_;
+  size_t packet_stride_ = 0;
 };
 
 }  // namespace openscreen::cast
@@ -7,14 +7,20 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <random>
 #include <vector>
 
+#include "cast/streaming/impl/frame_crypto.h"
 #include "cast/streaming/impl/rtcp_common.h"
+#include "cast/streaming/impl/rtp_defines.h"
+#include "cast/streaming/impl/rtp_packetizer.h"
 #include "cast/streaming/public/encoded_frame.h"
 #include "cast/streaming/public/frame_id.h"
 #include "cast/streaming/rtp_time.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "platform/base/udp_packet_pool.h"
+#include "util/crypto/random_bytes.h"
 
 using testing::ElementsAreArray;
 
@@ -62,7 +68,7 @@ TEST(FrameCollectorTest, CollectsFrameWithOnlyOnePart) {
       part.new_playout_delay = std::chrono::milliseconds(800);
     }
     part.referenced_frame_id = kSomeFrameId;
-    std::vector<uint8_t> buffer(255);
+    UdpPacket buffer(255);
     for (int j = 0; j < 255; ++j) {
       buffer[j] = static_cast<uint8_t>(j);
     }
@@ -131,7 +137,7 @@ TEST(FrameCollectorTest, CollectsFrameWithMultiplePartsArrivingOutOfOrder) {
     // Prepare a copy of the payload to pass into the FrameCollector. Place 24
     // bytes of bogus data at the start of the buffer to simulate the
     // non-payload part of the RTP packet.
-    std::vector<uint8_t> buffer(24, uint8_t{0xab});
+    UdpPacket buffer(24, uint8_t{0xab});
     buffer.insert(buffer.end(), payloads[packet_id].begin(),
                   payloads[packet_id].end());
     part.payload = ByteBuffer(buffer.data() + 24, buffer.size() - 24);
@@ -181,7 +187,7 @@ TEST(FrameCollectorTest, RejectsInvalidParts) {
   part.frame_id = kSomeFrameId;
   part.packet_id = 0;
   part.max_packet_id = 3;
-  std::vector<uint8_t> buffer(1, 'A');
+  UdpPacket buffer(1, 'A');
   part.payload = ByteBuffer(buffer);
   EXPECT_FALSE(collector.CollectRtpPacket(part, &buffer));
   // Note: When CollectRtpPacket() returns false, it does not take ownership of
@@ -211,5 +217,321 @@ TEST(FrameCollectorTest, RejectsInvalidParts) {
   ASSERT_TRUE(buffer.size() == 1 && buffer[0] == 'A');
 }
 
+TEST(FrameCollectorTest, ReturnsPooledBuffersOnReset) {
+  auto pool = UdpPacketPool::Create(/* max_free_buffers */ 8,
+                                    /* min_buffer_capacity */ 1500);
+  FrameCollector collector;
+  collector.set_frame_id(kSomeFrameId);
+
+  RtpPacketParser::ParseResult part{};
+  part.rtp_timestamp = kSomeRtpTimestamp;
+  part.is_key_frame = true;
+  part.frame_id = kSomeFrameId;
+  part.max_packet_id = 1;
+  part.referenced_frame_id = kSomeFrameId;
+  for (FramePacketId packet_id = 0; packet_id <= 1; ++packet_id) {
+    UdpPacket buffer = pool->Acquire(100);
+    part.packet_id = packet_id;
+    part.payload = ByteBuffer(buffer);
+    EXPECT_TRUE(collector.CollectRtpPacket(part, &buffer));
+  }
+  EXPECT_TRUE(collector.is_complete());
+
+  // The collector holds on to the buffers until it is reset.
+  EXPECT_EQ(pool->GetStats().free_buffers, 0u);
+  collector.Reset();
+  EXPECT_EQ(pool->GetStats().free_buffers, 2u);
+}
+
+// Returns the payload of packet `packet_id` of a test frame having
+// `num_packets` packets of `kChunkSize` bytes, except for the last one.
+constexpr int kChunkSize = 100;
+constexpr int kLastChunkSize = 37;
+std::vector<uint8_t> MakeChunk(int packet_id, int num_packets) {
+  std::vector<uint8_t> chunk(packet_id == num_packets - 1 ? kLastChunkSize
+                                                          : kChunkSize);
+  for (size_t i = 0; i < chunk.size(); ++i) {
+    chunk[i] = static_cast<uint8_t>(packet_id * 31 + i);
+  }
+  return chunk;
+}
+
+// Collects `chunk` as packet `packet_id` of the test frame, or as the parity
+// packet protecting all its packets if `fec_parity` is set.
+void CollectChunk(FrameCollector& collector,
+                  int packet_id,
+                  int num_packets,
+                  std::vector<uint8_t> chunk,
+                  std::optional<RtpPacketParser::ParseResult::FecParity>
+                      fec_parity = std::nullopt) {
+  RtpPacketParser::ParseResult part{};
+  part.rtp_timestamp = kSomeRtpTimestamp;
+  part.is_key_frame = true;
+  part.frame_id = kSomeFrameId;
+  part.packet_id = static_cast<FramePacketId>(packet_id);
+  part.max_packet_id = static_cast<FramePacketId>(num_packets - 1);
+  part.referenced_frame_id = kSomeFrameId;
+  part.fec_parity = fec_parity;
+  UdpPacket buffer(chunk.begin(), chunk.end());
+  part.payload = ByteBuffer(buffer);
+  EXPECT_TRUE(collector.CollectRtpPacket(part, &buffer));
+}
+
+TEST(FrameCollectorTest, RecoversMissingPacketFromParity) {
+  constexpr int kNumPackets = 4;
+  std::vector<uint8_t> parity(kChunkSize);
+  uint16_t payload_size_xor = 0;
+  for (int packet_id = 0; packet_id < kNumPackets; ++packet_id) {
+    const std::vector<uint8_t> chunk = MakeChunk(packet_id, kNumPackets);
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      parity[i] ^= chunk[i];
+    }
+    payload_size_xor ^= static_cast<uint16_t>(chunk.size());
+  }
+  const RtpPacketParser::ParseResult::FecParity fec_parity{kNumPackets,
+                                                           payload_size_xor};
+
+  // Try losing each packet, with the parity packet arriving both before and
+  // after the others.
+  for (int lost_packet_id = 0; lost_packet_id < kNumPackets; ++lost_packet_id) {
+    for (const bool parity_first : {true, false}) {
+      SCOPED_TRACE(testing::Message() << "lost_packet_id=" << lost_packet_id
+                                      << " parity_first=" << parity_first);
+      FrameCollector collector;
+      collector.set_frame_id(kSomeFrameId);
+      if (parity_first) {
+        CollectChunk(collector, 0, kNumPackets, parity, fec_parity);
+      }
+      for (int packet_id = 0; packet_id < kNumPackets; ++packet_id) {
+        if (packet_id != lost_packet_id) {
+          EXPECT_FALSE(collector.is_complete());
+          CollectChunk(collector, packet_id, kNumPackets,
+                       MakeChunk(packet_id, kNumPackets));
+        }
+      }
+      if (!parity_first) {
+        EXPECT_HAS_NACKS((std::vector<PacketNack>{
+                             {kSomeFrameId,
+                              static_cast<FramePacketId>(lost_packet_id)}}),
+                         collector);
+        CollectChunk(collector, 0, kNumPackets, parity, fec_parity);
+      }
+
+      ASSERT_TRUE(collector.is_complete());
+      EXPECT_EQ(EncodedFrame::Dependency::kKeyFrame,
+                collector.PeekFrameMetadata().dependency);
+      EXPECT_EQ(kSomeRtpTimestamp, collector.PeekFrameMetadata().rtp_timestamp);
+      const std::vector<ByteView> chunks = collector.GetPayloadChunks();
+      ASSERT_EQ(static_cast<size_t>(kNumPackets), chunks.size());
+      for (int packet_id = 0; packet_id < kNumPackets; ++packet_id) {
+        EXPECT_THAT(chunks[packet_id],
+                    ElementsAreArray(MakeChunk(packet_id, kNumPackets)));
+      }
+    }
+  }
+}
+
+TEST(FrameCollectorTest, CannotRecoverTwoMissingPacketsFromParity) {
+  constexpr int kNumPackets = 4;
+  FrameCollector collector;
+  collector.set_frame_id(kSomeFrameId);
+  CollectChunk(collector, 0, kNumPackets, std::vector<uint8_t>(kChunkSize),
+               RtpPacketParser::ParseResult::FecParity{kNumPackets, 0});
+  CollectChunk(collector, 0, kNumPackets, MakeChunk(0, kNumPackets));
+  CollectChunk(collector, 2, kNumPackets, MakeChunk(2, kNumPackets));
+  EXPECT_FALSE(collector.is_complete());
+  EXPECT_HAS_NACKS((std::vector<PacketNack>{{kSomeFrameId, 1},
+                                            {kSomeFrameId, 3}}),
+                   collector);
+}
+
+// Simulates sending frames over a network with random packet loss, where each
+// packet the Receiver NACKs is retransmitted one round trip later (and may be
+// lost again). With FEC, most frames having lost packets are recovered without
+// waiting for any retransmissions, and so are completed sooner on average.
+TEST(FrameCollectorTest, CompletesFramesSoonerWithFecUnderRandomLoss) {
+  constexpr int kNumFrames = 500;
+  constexpr int kFramePayloadSize = 12000;  // 9 packets.
+  constexpr int kFecGroupSize = 5;
+  const Ssrc ssrc = 1234;
+  FrameCrypto crypto(GenerateRandomBytes16(), GenerateRandomBytes16());
+  std::vector<uint8_t> data(kFramePayloadSize, 0x5a);
+
+  // Returns the average number of round trips, beyond the first transmission,
+  // needed to complete each frame.
+  const auto simulate = [&](double loss_rate, int fec_group_size) {
+    std::mt19937 generator(42);
+    std::bernoulli_distribution is_lost(loss_rate);
+    RtpPacketizer packetizer(RtpPayloadType::kVideoVp8, ssrc,
+                             kMaxRtpPacketSizeForIpv4UdpOnEthernet,
+                             fec_group_size);
+    RtpPacketParser parser(ssrc);
+    FrameCollector collector;
+    uint8_t scratch[kMaxRtpPacketSizeForIpv4UdpOnEthernet];
+    const auto deliver = [&](ByteBuffer packet) {
+      if (is_lost(generator)) {
+        return;
+      }
+      UdpPacket buffer(packet.begin(), packet.end());
+      const auto part = parser.Parse(buffer);
+      ASSERT_TRUE(part);
+      ASSERT_TRUE(collector.CollectRtpPacket(*part, &buffer));
+    };
+
+    int total_round_trips = 0;
+    for (int i = 0; i < kNumFrames; ++i) {
+      EncodedFrame encoded;
+      encoded.dependency = EncodedFrame::Dependency::kDependent;
+      encoded.frame_id = FrameId::first() + i;
+      encoded.referenced_frame_id = encoded.frame_id - 1;
+      encoded.rtp_timestamp = RtpTimeTicks() + RtpTimeDelta::FromTicks(i);
+      encoded.data = data;
+      const EncryptedFrame frame = crypto.Encrypt(encoded);
+      collector.Reset();
+      collector.set_frame_id(frame.frame_id);
+
+      // First transmission, with a parity packet after each group.
+      const int num_packets = packetizer.ComputeNumberOfPackets(frame);
+      for (int packet_id = 0; packet_id < num_packets; ++packet_id) {
+        deliver(packetizer.GeneratePacket(
+            frame, static_cast<FramePacketId>(packet_id), scratch));
+        const int group_start =
+            fec_group_size > 0 ? packet_id - packet_id % fec_group_size : 0;
+        if (fec_group_size > 0 &&
+            (packet_id - group_start + 1 == fec_group_size ||
+             packet_id + 1 == num_packets)) {
+          deliver(packetizer.GenerateParityPacket(
+              frame, static_cast<FramePacketId>(group_start),
+              packet_id - group_start + 1, scratch));
+        }
+      }
+
+      // Retransmit whatever is still missing, once per round trip.
+      while (!collector.is_complete()) {
+        ++total_round_trips;
+        std::vector<PacketNack> nacks;
+        collector.GetMissingPackets(&nacks);
+        for (const PacketNack& nack : nacks) {
+          if (nack.packet_id == kAllPacketsLost) {
+            for (int packet_id = 0; packet_id < num_packets; ++packet_id) {
+              deliver(packetizer.GeneratePacket(
+                  frame, static_cast<FramePacketId>(packet_id), scratch));
+            }
+          } else {
+            deliver(packetizer.GeneratePacket(frame, nack.packet_id, scratch));
+          }
+        }
+      }
+    }
+    return static_cast<double>(total_round_trips) / kNumFrames;
+  };
+
+  for (const double loss_rate : {0.01, 0.03, 0.05}) {
+    SCOPED_TRACE(testing::Message() << "loss_rate=" << loss_rate);
+    const double without_fec = simulate(loss_rate, 0);
+    const double with_fec = simulate(loss_rate, kFecGroupSize);
+    EXPECT_GT(without_fec, 0.0);
+    // A single parity packet per group recovers nearly all losses at these
+    // rates, so that at least half of the retransmission delay is avoided.
+    EXPECT_LT(with_fec, without_fec / 2);
+  }
+}
+
+// With a FrameCrypto, the payload is decrypted into one buffer as packets
+// arrive, in any order, and each packet's buffer is released right away.
+TEST(FrameCollectorTest, DecryptsPayloadAsPacketsArrive) {
+  constexpr int kFramePayloadSize = 11000;  // 8 packets.
+  constexpr int kFecGroupSize = 4;
+  const Ssrc ssrc = 1234;
+  FrameCrypto crypto(GenerateRandomBytes16(), GenerateRandomBytes16());
+  std::vector<uint8_t> data(kFramePayloadSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  EncodedFrame encoded;
+  encoded.dependency = EncodedFrame::Dependency::kKeyFrame;
+  encoded.frame_id = kSomeFrameId;
+  encoded.referenced_frame_id = kSomeFrameId;
+  encoded.rtp_timestamp = kSomeRtpTimestamp;
+  encoded.data = data;
+  const EncryptedFrame frame = crypto.Encrypt(encoded);
+
+  RtpPacketizer packetizer(RtpPayloadType::kVideoVp8, ssrc,
+                           kMaxRtpPacketSizeForIpv4UdpOnEthernet,
+                           kFecGroupSize);
+  RtpPacketParser parser(ssrc);
+  auto pool = UdpPacketPool::Create(/* max_free_buffers */ 16,
+                                    /* min_buffer_capacity */ 1500);
+  uint8_t scratch[kMaxRtpPacketSizeForIpv4UdpOnEthernet];
+  FrameCollector collector;
+  collector.set_crypto(&crypto);
+  collector.set_frame_id(frame.frame_id);
+  const auto deliver = [&](ByteBuffer packet) {
+    UdpPacket buffer = pool->Acquire(packet.size());
+    std::copy(packet.begin(), packet.end(), buffer.begin());
+    const auto part = parser.Parse(buffer);
+    ASSERT_TRUE(part);
+    ASSERT_TRUE(collector.CollectRtpPacket(*part, &buffer));
+  };
+
+  // The last packet arrives first, and is held encrypted until the next one
+  // determines where its payload goes. Packet 5 is lost, and recovered from
+  // the parity packet protecting packets 4 through 7.
+  const int num_packets = packetizer.ComputeNumberOfPackets(frame);
+  ASSERT_EQ(8, num_packets);
+  const int kArrivalOrder[] = {7, 2, 0, 6, 1, 4, 3};
+  for (const int packet_id : kArrivalOrder) {
+    EXPECT_FALSE(collector.is_complete());
+    deliver(packetizer.GeneratePacket(
+        frame, static_cast<FramePacketId>(packet_id), scratch));
+  }
+  // Only the last packet's buffer was held for a while, so the buffers of the
+  // others were recycled from one packet to the next.
+  EXPECT_EQ(pool->GetStats().heap_allocations, 2u);
+  EXPECT_EQ(pool->GetStats().buffers_recycled, std::size(kArrivalOrder));
+  EXPECT_FALSE(collector.is_complete());
+  deliver(packetizer.GenerateParityPacket(frame, FramePacketId{4},
+                                          kFecGroupSize, scratch));
+
+  ASSERT_TRUE(collector.is_complete());
+  ASSERT_TRUE(collector.is_decrypted());
+  EXPECT_EQ(static_cast<size_t>(kFramePayloadSize),
+            collector.GetFramePayloadSize());
+  EXPECT_THAT(collector.GetDecryptedPayload(), ElementsAreArray(data));
+  EXPECT_EQ(collector.TakeDecryptedPayload(), data);
+  collector.Reset();
+}
+
+// A frame whose packets do not all carry the same amount of payload (except
+// for the last) is decrypted from its encrypted chunks instead.
+TEST(FrameCollectorTest, FallsBackToEncryptedChunksForUnevenPackets) {
+  FrameCrypto crypto(GenerateRandomBytes16(), GenerateRandomBytes16());
+  std::vector<uint8_t> plaintext(290);
+  std::vector<uint8_t> ciphertext(plaintext.size());
+  for (size_t i = 0; i < plaintext.size(); ++i) {
+    plaintext[i] = static_cast<uint8_t>(i * 3);
+  }
+  crypto.Encrypt(kSomeFrameId, plaintext, ciphertext);
+
+  // The packets carry 100, 90 and 100 bytes of payload.
+  const ByteView whole(ciphertext);
+  const ByteView chunks[] = {whole.first(100), whole.subspan(100, 90),
+                             whole.subspan(190)};
+  FrameCollector collector;
+  collector.set_crypto(&crypto);
+  collector.set_frame_id(kSomeFrameId);
+  for (const int packet_id : {0, 2, 1}) {
+    CollectChunk(collector, packet_id, 3,
+                 std::vector<uint8_t>(chunks[packet_id].begin(),
+                                      chunks[packet_id].end()));
+  }
+
+  ASSERT_TRUE(collector.is_complete());
+  EXPECT_FALSE(collector.is_decrypted());
+  std::vector<uint8_t> decrypted(collector.GetFramePayloadSize());
+  crypto.Decrypt(kSomeFrameId, collector.GetPayloadChunks(), decrypted);
+  EXPECT_EQ(decrypted, plaintext);
+}
+
 }  // namespace
 }  // namespace openscreen::cast
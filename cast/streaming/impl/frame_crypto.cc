@@ -7,6 +7,7 @@
 #include <random>
 #include <utility>
 
+#include "openssl/aes.h"
 #include "openssl/crypto.h"
 #include "openssl/err.h"
 #include "openssl/rand.h"
@@ -39,19 +40,23 @@ EncryptedFrame& EncryptedFrame::operator=(EncryptedFrame&& other) {
   return *this;
 }
 
+std::vector<uint8_t> EncryptedFrame::ReleaseBuffer() {
+  data = ByteView();
+  return std::move(owned_data_);
+}
+
 FrameCrypto::FrameCrypto(const std::array<uint8_t, 16>& aes_key,
                          const std::array<uint8_t, 16>& cast_iv_mask)
-    : aes_key_{}, cast_iv_mask_(cast_iv_mask) {
+    : cipher_context_(EVP_CIPHER_CTX_new()), cast_iv_mask_(cast_iv_mask) {
   // Ensure that the library has been initialized. CRYPTO_library_init() may be
   // safely called multiple times during the life of a process.
   CRYPTO_library_init();
 
-  // Initialize the 244-byte AES_KEY struct once, here at construction time. The
-  // const_cast<> is reasonable as this is a one-time-ctor-initialized value
-  // that will remain constant from here onward.
-  const int return_code = AES_set_encrypt_key(
-      aes_key.data(), aes_key.size() * 8, const_cast<AES_KEY*>(&aes_key_));
-  if (return_code != 0) {
+  // Expand the AES key once, here at construction time. The IV is provided
+  // separately for each frame.
+  if (!cipher_context_ ||
+      EVP_EncryptInit_ex(cipher_context_.get(), EVP_aes_128_ctr(), nullptr,
+                         aes_key.data(), nullptr) != 1) {
     ClearOpenSSLERRStack(CURRENT_LOCATION);
     OSP_LOG_FATAL << "Failure when setting encryption key; unsafe to continue.";
     OSP_NOTREACHED();
@@ -60,24 +65,41 @@ FrameCrypto::FrameCrypto(const std::array<uint8_t, 16>& aes_key,
 
 FrameCrypto::~FrameCrypto() = default;
 
-EncryptedFrame FrameCrypto::Encrypt(const EncodedFrame& encoded_frame) const {
+EncryptedFrame FrameCrypto::Encrypt(const EncodedFrame& encoded_frame,
+                                    std::vector<uint8_t> buffer) {
   EncryptedFrame result;
   encoded_frame.CopyMetadataTo(&result);
+  result.owned_data_ = std::move(buffer);
   result.owned_data_.resize(encoded_frame.data.size());
   result.data = result.owned_data_;
-  Crypt(encoded_frame.frame_id, {&encoded_frame.data, 1}, result.owned_data_);
+  Crypt(encoded_frame.frame_id, 0, {&encoded_frame.data, 1},
+        result.owned_data_);
   return result;
 }
 
+void FrameCrypto::Encrypt(FrameId frame_id,
+                          ByteView plaintext,
+                          ByteBuffer out) {
+  Crypt(frame_id, 0, {&plaintext, 1}, out);
+}
+
 void FrameCrypto::Decrypt(FrameId frame_id,
                           ChunkList chunks,
-                          ByteBuffer out) const {
-  Crypt(frame_id, chunks, out);
+                          ByteBuffer out) {
+  Crypt(frame_id, 0, chunks, out);
+}
+
+void FrameCrypto::DecryptAt(FrameId frame_id,
+                            size_t offset,
+                            ByteView chunk,
+                            ByteBuffer out) {
+  Crypt(frame_id, offset, {&chunk, 1}, out);
 }
 
 void FrameCrypto::Crypt(FrameId frame_id,
+                        size_t offset,
                         ChunkList chunks,
-                        ByteBuffer out) const {
+                        ByteBuffer out) {
   OSP_CHECK(!frame_id.is_null());
 
   // Compute the AES nonce for Cast Streaming payload encryption, which is based
@@ -90,14 +112,43 @@ void FrameCrypto::Crypt(FrameId frame_id,
     aes_nonce[i] ^= cast_iv_mask_[i];
   }
 
-  std::array<uint8_t, 16> ecount_buf{};
-  unsigned int block_offset = 0;
+  // The nonce is the initial value of a 128-bit big-endian counter, which is
+  // incremented for each block of the key stream. Start at the block
+  // containing the `offset`.
+  uint64_t carry = offset / AES_BLOCK_SIZE;
+  for (size_t i = aes_nonce.size(); i > 0 && carry > 0; --i) {
+    carry += aes_nonce[i - 1];
+    aes_nonce[i - 1] = static_cast<uint8_t>(carry);
+    carry >>= 8;
+  }
+
+  // Passing only an IV keeps the key schedule, and restarts the key stream.
+  EVP_CIPHER_CTX* const context = cipher_context_.get();
+  OSP_CHECK_EQ(EVP_EncryptInit_ex(context, nullptr, nullptr, nullptr,
+                                  aes_nonce.data()),
+               1);
+
+  // Discard the part of the first block's key stream before the `offset`.
+  if (offset % AES_BLOCK_SIZE != 0) {
+    std::array<uint8_t, AES_BLOCK_SIZE> discarded{};
+    int bytes_written = 0;
+    OSP_CHECK_EQ(EVP_EncryptUpdate(context, discarded.data(), &bytes_written,
+                                   discarded.data(),
+                                   static_cast<int>(offset % AES_BLOCK_SIZE)),
+                 1);
+  }
+
+  // The context carries the position within the current key stream block over
+  // from one chunk to the next, so chunks need not be block-aligned.
   size_t out_offset = 0;
   for (ByteView chunk : chunks) {
     OSP_CHECK_LE(out_offset + chunk.size(), out.size());
-    AES_ctr128_encrypt(chunk.data(), out.data() + out_offset, chunk.size(),
-                       &aes_key_, aes_nonce.data(), ecount_buf.data(),
-                       &block_offset);
+    int bytes_written = 0;
+    OSP_CHECK_EQ(EVP_EncryptUpdate(context, out.data() + out_offset,
+                                   &bytes_written, chunk.data(),
+                                   static_cast<int>(chunk.size())),
+                 1);
+    OSP_CHECK_EQ(static_cast<size_t>(bytes_written), chunk.size());
     out_offset += chunk.size();
   }
   OSP_CHECK_EQ(out_offset, out.size());
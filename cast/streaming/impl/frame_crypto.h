@@ -12,7 +12,7 @@
 #include <vector>
 
 #include "cast/streaming/public/encoded_frame.h"
-#include "openssl/aes.h"
+#include "openssl/evp.h"
 #include "platform/base/span.h"
 
 namespace openscreen::cast {
@@ -29,6 +29,10 @@ struct EncryptedFrame : public EncodedFrame {
   EncryptedFrame(EncryptedFrame&&) noexcept;
   EncryptedFrame& operator=(EncryptedFrame&&);
 
+  // Empties this frame, and returns the buffer that held its payload data so
+  // that it can be passed to a later FrameCrypto::Encrypt() call.
+  std::vector<uint8_t> ReleaseBuffer();
+
  protected:
   // Since only FrameCrypto is trusted to generate the
   // payload data, it is allowed direct access to the storage.
@@ -41,6 +45,15 @@ struct EncryptedFrame : public EncodedFrame {
 
 // Encrypts EncodedFrames before sending, or decrypts EncryptedFrames that have
 // been received.
+//
+// The payload is encrypted with AES-128 in counter mode through boringssl's
+// EVP interface, which uses the fastest implementation available on the CPU
+// (e.g., AES-NI or VAES). All methods operate on caller-provided buffers, so
+// that frames can be encrypted and decrypted without allocating.
+//
+// This class is not thread-safe: every method that encrypts or decrypts
+// re-initializes the cipher context shared by all of them, so they are
+// non-const, and an instance must only be used from one thread at a time.
 class FrameCrypto {
  public:
   using ChunkList = std::span<const ByteView>;
@@ -53,24 +66,45 @@ class FrameCrypto {
 
   ~FrameCrypto();
 
-  EncryptedFrame Encrypt(const EncodedFrame& encoded_frame) const;
+  // Returns an encrypted copy of `encoded_frame`. The payload is stored in
+  // `buffer`, whose capacity is reused if it is large enough; a buffer
+  // previously released from another EncryptedFrame can be passed to avoid
+  // allocating.
+  EncryptedFrame Encrypt(const EncodedFrame& encoded_frame,
+                         std::vector<uint8_t> buffer = {});
+
+  // Encrypts the `plaintext` payload of the frame having the given `frame_id`
+  // into `out`, which must be the same size. `out` may be the same buffer as
+  // `plaintext`, to encrypt in-place.
+  void Encrypt(FrameId frame_id, ByteView plaintext, ByteBuffer out);
 
   // Decrypts `chunks` into `out`. `out` must have a sufficiently-sized
-  // data buffer.
-  void Decrypt(FrameId frame_id, ChunkList chunks, ByteBuffer out) const;
+  // data buffer. As with Encrypt(), a single chunk may be decrypted in-place.
+  void Decrypt(FrameId frame_id, ChunkList chunks, ByteBuffer out);
+
+  // Decrypts the `chunk` of payload data found `offset` bytes into the frame
+  // having the given `frame_id`, into `out`, which must be the same size. This
+  // allows a frame to be decrypted piecemeal, in any order, as its packets
+  // arrive. Since AES-CTR is symmetric, this also re-encrypts decrypted data.
+  // As with Decrypt(), the `chunk` may be decrypted in-place.
+  void DecryptAt(FrameId frame_id,
+                 size_t offset,
+                 ByteView chunk,
+                 ByteBuffer out);
 
  private:
-  // The 244-byte AES_KEY struct, derived from the `aes_key` passed to the ctor,
-  // and initialized by boringssl's AES_set_encrypt_key() function.
-  const AES_KEY aes_key_;
+  // AES-CTR is symmetric. Thus, the "meat" of both Encrypt() and Decrypt() is
+  // the same. The key stream is started from `offset` bytes into the frame.
+  void Crypt(FrameId frame_id, size_t offset, ChunkList chunks, ByteBuffer out);
+
+  // Holds the AES key schedule, which is computed once at construction time.
+  // Only the IV changes from one frame to the next, so Crypt() re-initializes
+  // the context with just the frame's IV.
+  const bssl::UniquePtr<EVP_CIPHER_CTX> cipher_context_;
 
   // Random bytes used in the custom heuristic to generate a different
   // initialization vector for each frame.
   const std::array<uint8_t, 16> cast_iv_mask_;
-
-  // AES-CTR is symmetric. Thus, the "meat" of both Encrypt() and Decrypt() is
-  // the same.
-  void Crypt(FrameId frame_id, ChunkList chunks, ByteBuffer out) const;
 };
 
 }  // namespace openscreen::cast
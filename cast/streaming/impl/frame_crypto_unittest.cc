@@ -4,8 +4,11 @@
 
 #include "cast/streaming/impl/frame_crypto.h"
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -19,6 +22,12 @@ namespace {
 using testing::ElementsAreArray;
 using testing::Not;
 
+std::vector<uint8_t> MakePayload(size_t size) {
+  std::vector<uint8_t> payload(size);
+  std::iota(payload.begin(), payload.end(), 0);
+  return payload;
+}
+
 TEST(FrameCryptoTest, EncryptsAndDecryptsFrames) {
   // Prepare two frames with different FrameIds, but having the same payload
   // bytes.
@@ -36,7 +45,7 @@ TEST(FrameCryptoTest, EncryptsAndDecryptsFrames) {
   const std::array<uint8_t, 16> key = GenerateRandomBytes16();
   const std::array<uint8_t, 16> iv = GenerateRandomBytes16();
   EXPECT_NE(0, memcmp(key.data(), iv.data(), sizeof(key)));
-  const FrameCrypto crypto(key, iv);
+  FrameCrypto crypto(key, iv);
 
   // Encrypt both frames, and confirm the encrypted data is something other than
   // the plaintext, and that both frames have different encrypted data.
@@ -73,5 +82,114 @@ TEST(FrameCryptoTest, EncryptsAndDecryptsFrames) {
   EXPECT_THAT(frame1.data, ElementsAreArray(decrypted_frame1.data));
 }
 
+// The first block of the F.5.1 CTR-AES128.Encrypt example in NIST SP 800-38A.
+// The first FrameId contributes zeros to the nonce, so the IV mask is used as
+// the initial counter block as-is.
+TEST(FrameCryptoTest, MatchesAesCtrTestVector) {
+  const std::array<uint8_t, 16> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae,
+                                       0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
+                                       0x09, 0xcf, 0x4f, 0x3c};
+  const std::array<uint8_t, 16> iv = {0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5,
+                                      0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb,
+                                      0xfc, 0xfd, 0xfe, 0xff};
+  const uint8_t kPlaintext[] = {0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40,
+                                0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11,
+                                0x73, 0x93, 0x17, 0x2a};
+  const uint8_t kCiphertext[] = {0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20,
+                                 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64,
+                                 0x99, 0x0d, 0xb6, 0xce};
+
+  FrameCrypto crypto(key, iv);
+  std::array<uint8_t, sizeof(kPlaintext)> out{};
+  crypto.Encrypt(FrameId::first(), kPlaintext, out);
+  EXPECT_THAT(out, ElementsAreArray(kCiphertext));
+}
+
+TEST(FrameCryptoTest, EncryptsAndDecryptsInPlace) {
+  FrameCrypto crypto(GenerateRandomBytes16(), GenerateRandomBytes16());
+  const FrameId frame_id = FrameId::first() + 42;
+  const std::vector<uint8_t> plaintext = MakePayload(1000);
+
+  std::vector<uint8_t> expected_ciphertext(plaintext.size());
+  crypto.Encrypt(frame_id, plaintext, expected_ciphertext);
+
+  std::vector<uint8_t> buffer = plaintext;
+  crypto.Encrypt(frame_id, buffer, buffer);
+  EXPECT_EQ(buffer, expected_ciphertext);
+
+  const ByteView chunk(buffer);
+  crypto.Decrypt(frame_id, {&chunk, 1}, buffer);
+  EXPECT_EQ(buffer, plaintext);
+}
+
+// Packets split frames at arbitrary offsets, which are generally not aligned
+// to the AES block size.
+TEST(FrameCryptoTest, DecryptsUnalignedChunks) {
+  FrameCrypto crypto(GenerateRandomBytes16(), GenerateRandomBytes16());
+  const FrameId frame_id = FrameId::first() + 7;
+  const std::vector<uint8_t> plaintext = MakePayload(3000);
+  std::vector<uint8_t> ciphertext(plaintext.size());
+  crypto.Encrypt(frame_id, plaintext, ciphertext);
+
+  const ByteView whole(ciphertext);
+  const ByteView chunks[] = {whole.subspan(0, 1), whole.subspan(1, 1399),
+                             whole.subspan(1400, 17), whole.subspan(1417)};
+  std::vector<uint8_t> decrypted(plaintext.size());
+  crypto.Decrypt(frame_id, chunks, decrypted);
+  EXPECT_EQ(decrypted, plaintext);
+}
+
+// Packets arrive in any order, and may be decrypted as they do.
+TEST(FrameCryptoTest, DecryptsChunksAtOffsetsInAnyOrder) {
+  // An IV mask ending in 0xff bytes ensures the counter carries into the
+  // higher-order bytes within the frame.
+  std::array<uint8_t, 16> cast_iv_mask = GenerateRandomBytes16();
+  std::fill(cast_iv_mask.begin() + 12, cast_iv_mask.end(), 0xff);
+  FrameCrypto crypto(GenerateRandomBytes16(), cast_iv_mask);
+  const FrameId frame_id = FrameId::first() + 42;
+  const std::vector<uint8_t> plaintext = MakePayload(10000);
+  std::vector<uint8_t> buffer(plaintext.size());
+  crypto.Encrypt(frame_id, plaintext, buffer);
+
+  // Decrypt in-place, from the end of the frame to its beginning, in chunks
+  // that are not aligned to the AES block size.
+  constexpr size_t kChunkSize = 1379;
+  for (size_t end = buffer.size(); end > 0;) {
+    const size_t offset = end > kChunkSize ? end - kChunkSize : 0;
+    const ByteBuffer chunk = ByteBuffer(buffer).subspan(offset, end - offset);
+    crypto.DecryptAt(frame_id, offset, chunk, chunk);
+    end = offset;
+  }
+  EXPECT_EQ(buffer, plaintext);
+
+  // Re-encrypting a chunk restores its ciphertext.
+  std::vector<uint8_t> ciphertext(plaintext.size());
+  crypto.Encrypt(frame_id, plaintext, ciphertext);
+  const ByteBuffer chunk = ByteBuffer(buffer).subspan(5000, 100);
+  crypto.DecryptAt(frame_id, 5000, chunk, chunk);
+  EXPECT_THAT(chunk, ElementsAreArray(ByteView(ciphertext).subspan(5000, 100)));
+}
+
+TEST(FrameCryptoTest, EncryptsIntoRecycledBuffer) {
+  FrameCrypto crypto(GenerateRandomBytes16(), GenerateRandomBytes16());
+  const std::vector<uint8_t> payload = MakePayload(500);
+  EncodedFrame frame;
+  frame.frame_id = FrameId::first();
+  frame.data = payload;
+
+  EncryptedFrame encrypted_frame = crypto.Encrypt(frame);
+  const uint8_t* const buffer_data = encrypted_frame.data.data();
+  std::vector<uint8_t> buffer = encrypted_frame.ReleaseBuffer();
+  EXPECT_TRUE(encrypted_frame.data.empty());
+
+  // A smaller frame reuses the released buffer.
+  frame.frame_id = frame.frame_id + 1;
+  frame.data = ByteView(payload).first(100);
+  encrypted_frame = crypto.Encrypt(frame, std::move(buffer));
+  EXPECT_EQ(encrypted_frame.data.data(), buffer_data);
+  EXPECT_EQ(encrypted_frame.data.size(), 100u);
+  EXPECT_THAT(encrypted_frame.data, Not(ElementsAreArray(frame.data)));
+}
+
 }  // namespace
 }  // namespace openscreen::cast
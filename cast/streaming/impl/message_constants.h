@@ -9,6 +9,8 @@ namespace openscreen::cast {
 
 // RTP extension strings.
 inline constexpr char kInputEventsRtpExtension[] = "input_events";
+inline constexpr char kAdaptivePlayoutDelayRtpExtension[] =
+    "adaptive_playout_delay";
 
 }  // namespace openscreen::cast
 
@@ -4,6 +4,8 @@
 
 #include "cast/streaming/testing/mock_environment.h"
 
+#include <vector>
+
 namespace openscreen::cast {
 
 MockEnvironment::MockEnvironment(ClockNowFunctionPtr now_function,
@@ -12,4 +14,20 @@ MockEnvironment::MockEnvironment(ClockNowFunctionPtr now_function,
 
 MockEnvironment::~MockEnvironment() = default;
 
+void MockEnvironment::SendPackets(
+    std::span<const UdpSocket::GatheredMessage> packets,
+    std::span<const PacketMetadata> metadata) {
+  std::vector<uint8_t> buffer;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (packets[i].payload.empty()) {
+      SendPacket(packets[i].header, metadata[i]);
+      continue;
+    }
+    buffer.assign(packets[i].header.begin(), packets[i].header.end());
+    buffer.insert(buffer.end(), packets[i].payload.begin(),
+                  packets[i].payload.end());
+    SendPacket(buffer, metadata[i]);
+  }
+}
+
 }  // namespace openscreen::cast
@@ -10,9 +10,11 @@
 #include <utility>
 
 #include "cast/streaming/impl/rtp_defines.h"
+#include "cast/streaming/public/constants.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "util/json/json_serialization.h"
+#include "util/stringprintf.h"
 
 using ::testing::ElementsAre;
 
@@ -754,6 +756,44 @@ TEST(OfferTest, ErrorOnMixedDscpValues) {
                        Error::Code::kJsonParseError);
 }
 
+TEST(OfferTest, ParsesFecGroupSize) {
+  const auto make_offer = [](int fec_group_size) {
+    return StringFormat(R"({{
+      "castMode": "mirroring",
+      "supportedStreams": [{{
+        "index": 2,
+        "type": "video_source",
+        "codecName": "vp8",
+        "rtpProfile": "cast",
+        "rtpPayloadType": 100,
+        "ssrc": 19088743,
+        "timeBase": "1/90000",
+        "maxBitRate": 10000,
+        "aesKey": "51027e4e2347cbcb49d57ef10177aebc",
+        "aesIvMask": "7f12a19be62a36c04ae4116caaeff6d1",
+        "fecGroupSize": {}
+      }}]
+    }})",
+                        fec_group_size);
+  };
+
+  ErrorOr<Json::Value> root = json::Parse(make_offer(10));
+  ASSERT_TRUE(root.is_value());
+  const auto offer_or_error = Offer::TryParse(root.value());
+  ASSERT_TRUE(offer_or_error.is_value()) << offer_or_error.error();
+  const Stream& stream = offer_or_error.value().video_streams[0].stream;
+  EXPECT_EQ(10, stream.fec_group_size);
+  EXPECT_EQ(10, stream.ToJson()["fecGroupSize"].asInt());
+
+  // FEC is not offered by default.
+  Stream stream_without_fec = stream;
+  stream_without_fec.fec_group_size = 0;
+  EXPECT_FALSE(stream_without_fec.ToJson().isMember("fecGroupSize"));
+
+  ExpectFailureOnParse(make_offer(kMaxFecGroupSize + 1),
+                       Error::Code::kJsonParseError);
+}
+
 TEST(OfferTest, CanParseValidOfferWithDataTransport) {
   ErrorOr<Json::Value> root = json::Parse(R"({
     "castMode": "mirroring",
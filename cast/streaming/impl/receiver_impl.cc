@@ -57,6 +57,16 @@ ReceiverImpl::ReceiverImpl(Environment& environment,
   rtcp_builder_->SetPlayoutDelay(config.target_playout_delay);
   playout_delay_changes_.emplace_back(FrameId::leader(),
                                       config.target_playout_delay);
+  if (config.adaptive_playout_delay) {
+    jitter_buffer_.emplace(config.target_playout_delay,
+                           *config.adaptive_playout_delay);
+  }
+
+  // Decrypt each frame as its packets arrive, so that it is ready to be handed
+  // over by the time it is consumed.
+  for (PendingFrame& entry : pending_frames_) {
+    entry.collector.set_crypto(&crypto_);
+  }
 
   packet_router_->RegisterPacketConsumer(rtcp_session_.sender_ssrc(), this);
 }
@@ -69,6 +79,11 @@ const SessionConfig& ReceiverImpl::config() const {
   return config_;
 }
 
+const AdaptiveJitterBuffer::Metrics* ReceiverImpl::jitter_buffer_metrics()
+    const {
+  return jitter_buffer_ ? &jitter_buffer_->metrics() : nullptr;
+}
+
 void ReceiverImpl::SetConsumer(Consumer* consumer) {
   consumer_ = consumer;
   ScheduleFrameReadyCheck();
@@ -230,6 +245,36 @@ std::optional<size_t> ReceiverImpl::AdvanceToNextFrame() {
 
 EncodedFrame ReceiverImpl::ConsumeNextFrame(ByteBuffer buffer) {
   TRACE_DEFAULT_SCOPED(TraceCategory::kReceiver);
+  FrameCollector& collector = GetNextFrameToConsume().collector;
+
+  // `buffer` will contain the decrypted frame contents. Usually, the frame was
+  // already decrypted as its packets arrived.
+  if (collector.is_decrypted()) {
+    const ByteView payload = collector.GetDecryptedPayload();
+    OSP_CHECK_EQ(payload.size(), buffer.size());
+    std::copy(payload.begin(), payload.end(), buffer.begin());
+  } else {
+    crypto_.Decrypt(collector.PeekFrameMetadata().frame_id,
+                    collector.GetPayloadChunks(), buffer);
+  }
+  return FinishConsumingFrame(buffer);
+}
+
+EncodedFrame ReceiverImpl::TakeNextFrame(std::vector<uint8_t>* buffer) {
+  TRACE_DEFAULT_SCOPED(TraceCategory::kReceiver);
+  FrameCollector& collector = GetNextFrameToConsume().collector;
+
+  if (collector.is_decrypted()) {
+    *buffer = collector.TakeDecryptedPayload();
+  } else {
+    buffer->resize(collector.GetFramePayloadSize());
+    crypto_.Decrypt(collector.PeekFrameMetadata().frame_id,
+                    collector.GetPayloadChunks(), *buffer);
+  }
+  return FinishConsumingFrame(*buffer);
+}
+
+ReceiverImpl::PendingFrame& ReceiverImpl::GetNextFrameToConsume() {
   // Assumption: The required call to AdvanceToNextFrame() ensures that
   // `last_frame_consumed_` is set to one before the frame to be consumed here.
   const FrameId frame_id = last_frame_consumed_ + 1;
@@ -237,19 +282,19 @@ EncodedFrame ReceiverImpl::ConsumeNextFrame(ByteBuffer buffer) {
 
   TRACE_FLOW_STEP(TraceCategory::kReceiver, "Frame.Consumed", frame_id);
 
-  // Decrypt the frame, populating the given output `frame`.
   PendingFrame& entry = GetQueueEntry(frame_id);
   OSP_CHECK(entry.collector.is_complete());
   OSP_CHECK(entry.estimated_capture_time);
+  return entry;
+}
 
-  const EncodedFrame& metadata = entry.collector.PeekFrameMetadata();
+EncodedFrame ReceiverImpl::FinishConsumingFrame(ByteView payload) {
+  const FrameId frame_id = last_frame_consumed_ + 1;
+  PendingFrame& entry = GetQueueEntry(frame_id);
 
-  // `buffer` will contain the decrypted frame contents.
-  crypto_.Decrypt(metadata.frame_id, entry.collector.GetPayloadChunks(),
-                  buffer);
   EncodedFrame frame;
-  metadata.CopyMetadataTo(&frame);
-  frame.data = buffer;
+  entry.collector.PeekFrameMetadata().CopyMetadataTo(&frame);
+  frame.data = payload;
   frame.reference_time = *entry.estimated_capture_time +
                          ResolveTargetPlayoutDelay(frame_id) -
                          player_processing_time_;
@@ -276,9 +321,24 @@ EncodedFrame ReceiverImpl::ConsumeNextFrame(ByteBuffer buffer) {
 }
 
 void ReceiverImpl::OnReceivedRtpPacket(Clock::time_point arrival_time,
-                                       std::vector<uint8_t> packet) {
-  const std::optional<RtpPacketParser::ParseResult> part =
-      rtp_parser_.Parse(packet);
+                                       UdpPacket packet) {
+  ProcessRtpPacket(arrival_time, rtp_parser_.Parse(packet), packet);
+}
+
+void ReceiverImpl::OnReceivedRtpPackets(Clock::time_point arrival_time,
+                                        std::span<UdpPacket> packets) {
+  rtp_batch_views_.assign(packets.begin(), packets.end());
+  rtp_batch_results_.resize(packets.size());
+  rtp_parser_.ParseBatch(rtp_batch_views_, rtp_batch_results_);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    ProcessRtpPacket(arrival_time, rtp_batch_results_[i], packets[i]);
+  }
+}
+
+void ReceiverImpl::ProcessRtpPacket(
+    Clock::time_point arrival_time,
+    const std::optional<RtpPacketParser::ParseResult>& part,
+    UdpPacket& packet) {
   if (!part) {
     RECEIVER_LOG(WARN) << "Parsing of " << packet.size()
                        << " bytes as an RTP packet failed.";
@@ -343,9 +403,9 @@ void ReceiverImpl::OnReceivedRtpPacket(Clock::time_point arrival_time,
     return;  // Bad data in the parsed packet. Ignore it.
   }
 
-  // The first packet in a frame contains timing information critical for
-  // computing this frame's (and all future frames') playout time. Process that,
-  // but only once.
+  // The first packet in a frame, and the FEC parity packet protecting it,
+  // contain timing information critical for computing this frame's (and all
+  // future frames') playout time. Process that, but only once.
   if (part->packet_id == FramePacketId{0} &&
       !pending_frame.estimated_capture_time) {
     pending_frame.rtp_timestamp = part->rtp_timestamp;
@@ -369,6 +429,9 @@ void ReceiverImpl::OnReceivedRtpPacket(Clock::time_point arrival_time,
     // If a target playout delay change was included in this packet, record it.
     if (part->new_playout_delay > milliseconds::zero()) {
       RecordNewTargetPlayoutDelay(part->frame_id, part->new_playout_delay);
+      if (jitter_buffer_) {
+        jitter_buffer_->OnPlayoutDelayChanged(part->new_playout_delay);
+      }
     }
 
     // Now that the estimated capture time is known, other frames may have just
@@ -376,7 +439,9 @@ void ReceiverImpl::OnReceivedRtpPacket(Clock::time_point arrival_time,
     ScheduleFrameReadyCheck();
   }
 
-  if (config_.are_receiver_event_logs_enabled) {
+  // Only the receipt of the frame's data packets is reported, and not that of
+  // FEC parity packets.
+  if (config_.are_receiver_event_logs_enabled && !part->fec_parity) {
     AddEventToPendingLogs(part->rtp_timestamp,
                           RtcpReceiverEventLogMessage{
                               .type = StatisticsEvent::Type::kPacketReceived,
@@ -389,6 +454,13 @@ void ReceiverImpl::OnReceivedRtpPacket(Clock::time_point arrival_time,
   }
   TRACE_FLOW_STEP(TraceCategory::kReceiver, "Frame.Complete", part->frame_id);
 
+  if (jitter_buffer_ && pending_frame.estimated_capture_time) {
+    jitter_buffer_->OnFrameComplete(arrival_time -
+                                    *pending_frame.estimated_capture_time +
+                                    player_processing_time_);
+    AdaptPlayoutDelay();
+  }
+
   const EncodedFrame& metadata = collector.PeekFrameMetadata();
 
   // Whenever a key frame has been received, the decoder has what it needs to
@@ -528,11 +600,17 @@ void ReceiverImpl::RecordNewTargetPlayoutDelay(FrameId as_of_frame,
                                std::prev(keep_one_before_it));
 
   // Insert the delay change entry, maintaining the ascending ordering of the
-  // vector.
+  // vector. A change the Receiver requested may be superseded by another for
+  // the same frame.
   const auto insert_it = std::find_if(
       playout_delay_changes_.begin(), playout_delay_changes_.end(),
-      [&](const auto& entry) { return entry.first > as_of_frame; });
-  playout_delay_changes_.emplace(insert_it, as_of_frame, delay);
+      [&](const auto& entry) { return entry.first >= as_of_frame; });
+  if (insert_it != playout_delay_changes_.end() &&
+      insert_it->first == as_of_frame) {
+    insert_it->second = delay;
+  } else {
+    playout_delay_changes_.emplace(insert_it, as_of_frame, delay);
+  }
 
   OSP_DCHECK(AreElementsSortedAndUnique(playout_delay_changes_));
 }
@@ -591,19 +669,38 @@ void ReceiverImpl::DropAllFramesBefore(FrameId first_kept_frame) {
   OSP_CHECK_LE(first_kept_frame, latest_frame_expected_);
 
   // Reset each of the frames being dropped, pretending that they were consumed.
+  int num_incomplete_frames = 0;
   for (FrameId f = first_to_drop; f < first_kept_frame; ++f) {
     PendingFrame& entry = GetQueueEntry(f);
     if (!config_.allow_skip_to_keyframe) {
       OSP_CHECK(entry.estimated_capture_time);
     }
+    if (!entry.collector.is_complete()) {
+      ++num_incomplete_frames;
+    }
     entry.collector.Reset();
   }
   last_frame_consumed_ = first_kept_frame - 1;
 
+  if (jitter_buffer_ && num_incomplete_frames > 0) {
+    jitter_buffer_->OnFramesDropped(num_incomplete_frames);
+    AdaptPlayoutDelay();
+  }
+
   RECEIVER_LOG(INFO) << "Artificially advancing checkpoint after skipping.";
   AdvanceCheckpoint(first_kept_frame);
 }
 
+void ReceiverImpl::AdaptPlayoutDelay() {
+  const std::optional<milliseconds> delay =
+      jitter_buffer_->GetNewPlayoutDelay(now_());
+  if (delay) {
+    // The frames already in flight keep the delay they were sent with. The new
+    // delay is reported to the Sender once the checkpoint reaches it.
+    RecordNewTargetPlayoutDelay(latest_frame_expected_ + 1, *delay);
+  }
+}
+
 void ReceiverImpl::ScheduleFrameReadyCheck(Clock::time_point when) {
   consumption_alarm_.Schedule(
       [this] {
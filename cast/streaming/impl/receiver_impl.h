@@ -14,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "cast/streaming/impl/adaptive_jitter_buffer.h"
 #include "cast/streaming/impl/clock_drift_smoother.h"
 #include "cast/streaming/impl/compound_rtcp_builder.h"
 #include "cast/streaming/impl/frame_collector.h"
@@ -30,6 +31,7 @@
 #include "cast/streaming/ssrc.h"
 #include "platform/api/time.h"
 #include "platform/base/span.h"
+#include "platform/base/udp_packet.h"
 #include "util/alarm.h"
 #include "util/chrono_helpers.h"
 #include "util/raw_ptr.h"
@@ -65,14 +67,22 @@ class ReceiverImpl : public Receiver,
   void RequestKeyFrame() override;
   std::optional<size_t> AdvanceToNextFrame() override;
   EncodedFrame ConsumeNextFrame(ByteBuffer buffer) override;
+  EncodedFrame TakeNextFrame(std::vector<uint8_t>* buffer) override;
 
   // The default "player processing time" amount. See SetPlayerProcessingTime().
   using openscreen::cast::Receiver::kDefaultPlayerProcessingTime;
 
+  // Returns the metrics of the adaptive jitter buffer, for tuning the added
+  // latency against the frames late or dropped; or nullptr if the target
+  // playout delay is not adapted (see SessionConfig::adaptive_playout_delay).
+  const AdaptiveJitterBuffer::Metrics* jitter_buffer_metrics() const;
+
  protected:
   // ReceiverPacketRouter::PacketConsumer implementation.
   void OnReceivedRtpPacket(Clock::time_point arrival_time,
-                           std::vector<uint8_t> packet) override;
+                           UdpPacket packet) override;
+  void OnReceivedRtpPackets(Clock::time_point arrival_time,
+                            std::span<UdpPacket> packets) override;
   void OnReceivedRtcpPacket(Clock::time_point arrival_time,
                             std::span<const uint8_t> packet) override;
 
@@ -112,11 +122,21 @@ class ReceiverImpl : public Receiver,
   const PendingFrame& GetQueueEntry(FrameId frame_id) const;
   PendingFrame& GetQueueEntry(FrameId frame_id);
 
+  // Helpers for ConsumeNextFrame() and TakeNextFrame(): The former returns the
+  // queue entry of the frame to be consumed, and the latter populates the
+  // consumed frame, given its decrypted `payload`, and advances past it.
+  PendingFrame& GetNextFrameToConsume();
+  EncodedFrame FinishConsumingFrame(ByteView payload);
+
   // Record that the target playout delay has changed starting with the given
   // FrameId.
   void RecordNewTargetPlayoutDelay(FrameId as_of_frame,
                                    std::chrono::milliseconds delay);
 
+  // Called when a frame was completed or dropped, to change the target playout
+  // delay if the adaptive jitter buffer decides it should be.
+  void AdaptPlayoutDelay();
+
   // Examine the known target playout delay changes to determine what setting is
   // in-effect for the given frame.
   std::chrono::milliseconds ResolveTargetPlayoutDelay(FrameId frame_id) const;
@@ -141,6 +161,12 @@ class ReceiverImpl : public Receiver,
                                            FrameId immediate_next_frame,
                                            const PendingFrame& entry);
 
+  // Processes the RTP `packet`, given the result of parsing it (`part`), which
+  // is std::nullopt if it was corrupt.
+  void ProcessRtpPacket(Clock::time_point arrival_time,
+                        const std::optional<RtpPacketParser::ParseResult>& part,
+                        UdpPacket& packet);
+
   // Sets the `consumption_alarm_` to check whether any frames are ready,
   // including possibly skipping over late frames in order to make not-yet-late
   // frames become ready. The default argument value means "without delay."
@@ -157,8 +183,12 @@ class ReceiverImpl : public Receiver,
   std::unique_ptr<CompoundRtcpBuilder> rtcp_builder_;
   PacketReceiveStatsTracker stats_tracker_;  // Tracks transmission stats.
   RtpPacketParser rtp_parser_;
+  // Scratch space for parsing a batch of RTP packets, kept to avoid
+  // re-allocating it for each batch.
+  std::vector<ByteView> rtp_batch_views_;
+  std::vector<std::optional<RtpPacketParser::ParseResult>> rtp_batch_results_;
   const int rtp_timebase_;    // RTP timestamp ticks per second.
-  const FrameCrypto crypto_;  // Decrypts assembled frames.
+  FrameCrypto crypto_;        // Decrypts assembled frames.
   bool is_pli_enabled_;       // Whether picture loss indication is enabled.
 
   // Buffer for serializing/sending RTCP packets.
@@ -218,9 +248,10 @@ class ReceiverImpl : public Receiver,
   std::vector<RtpTimeTicks> pending_frame_acks_;
 
   // Tracks the recent changes to the target playout delay, which is controlled
-  // by the Sender. The FrameId indicates the first frame where a new delay
-  // setting takes effect. This vector is never empty, is kept sorted, and is
-  // pruned to remain as small as possible.
+  // by the Sender (or adapted by the Receiver, see `jitter_buffer_`). The
+  // FrameId indicates the first frame where a new delay setting takes effect.
+  // This vector is never empty, is kept sorted, and is pruned to remain as
+  // small as possible.
   //
   // The target playout delay is the amount of time between a frame's
   // capture/recording on the Sender and when it should be played-out at the
@@ -228,6 +259,10 @@ class ReceiverImpl : public Receiver,
   std::vector<std::pair<FrameId, std::chrono::milliseconds>>
       playout_delay_changes_;
 
+  // If configured, adapts the target playout delay to the network conditions,
+  // in addition to the changes made by the Sender.
+  std::optional<AdaptiveJitterBuffer> jitter_buffer_;
+
   // The consumer to notify when there are one or more frames completed and
   // ready to be consumed.
   raw_ptr<Consumer> consumer_ = nullptr;
@@ -255,6 +255,29 @@ class MockSender : public CompoundRtcpParser::Client {
     }
   }
 
+  // Like SendRtpPackets(), but delivers the packets as if read all at once by a
+  // batched socket read, with a packet of junk in the middle.
+  void SendRtpPacketsInOneRead(
+      const std::vector<FramePacketId>& packets_to_send) {
+    uint8_t buffer[kMaxRtpPacketSize];
+    std::vector<UdpPacket> batch;
+    for (FramePacketId packet_id : packets_to_send) {
+      const auto span = rtp_packetizer_.GeneratePacket(
+          frame_being_sent_, packet_id, ByteBuffer(buffer, kMaxRtpPacketSize));
+      batch.emplace_back(span.begin(), span.end());
+      batch.back().set_source(sender_endpoint_);
+      if (batch.size() == packets_to_send.size() / 2) {
+        batch.emplace_back(span.begin(), span.begin() + 10);
+        batch.back().set_source(sender_endpoint_);
+      }
+    }
+    task_runner_->PostTaskWithDelay(
+        [receiver = receiver_, batch = std::move(batch)]() mutable {
+          receiver->OnReadBatch(nullptr, std::move(batch));
+        },
+        kOneWayNetworkDelay);
+  }
+
   // Called to process a packet from the Receiver.
   void OnPacketFromReceiver(ByteView packet) {
     EXPECT_TRUE(rtcp_parser_.Parse(packet, max_feedback_frame_id_));
@@ -273,7 +296,7 @@ class MockSender : public CompoundRtcpParser::Client {
               (override));
   MOCK_METHOD(void,
               OnCastReceiverFrameLogMessages,
-              (std::vector<RtcpReceiverFrameLogMessage> messages),
+              (const std::vector<RtcpReceiverFrameLogMessage>& messages),
               (override));
   MOCK_METHOD(void, OnReceiverIndicatesPictureLoss, (), (override));
   MOCK_METHOD(void,
@@ -282,11 +305,11 @@ class MockSender : public CompoundRtcpParser::Client {
               (override));
   MOCK_METHOD(void,
               OnReceiverHasFrames,
-              (std::vector<FrameId> acks),
+              (const std::vector<FrameId>& acks),
               (override));
   MOCK_METHOD(void,
               OnReceiverIsMissingPackets,
-              (std::vector<PacketNack> nacks),
+              (const std::vector<PacketNack>& nacks),
               (override));
 
  private:
@@ -313,6 +336,7 @@ struct ReceiverOptions {
   bool allow_skipping = false;
   std::optional<std::chrono::milliseconds> receiver_proactive_pli_interval =
       std::nullopt;
+  std::optional<PlayoutDelayBounds> adaptive_playout_delay = std::nullopt;
 };
 
 class ReceiverTest : public testing::Test {
@@ -337,6 +361,7 @@ class ReceiverTest : public testing::Test {
         /* .are_receiver_event_logs_enabled = */ true, options.allow_skipping);
     config.receiver_proactive_pli_interval =
         options.receiver_proactive_pli_interval;
+    config.adaptive_playout_delay = options.adaptive_playout_delay;
     receiver_ =
         std::make_unique<ReceiverImpl>(env_, packet_router_, std::move(config));
     env_.SetSocketSubscriber(&socket_subscriber_);
@@ -552,6 +577,33 @@ TEST_F(ReceiverTest, ReceivesFramesInOrder) {
   EXPECT_FALSE(receiver()->AdvanceToNextFrame().has_value());
 }
 
+// Tests that the Receiver processes the RTP packets of batched socket reads,
+// ignoring any junk among them.
+TEST_F(ReceiverTest, ReceivesFramesFromBatchedReads) {
+  const Clock::time_point start_time = FakeClock::now();
+  ExchangeInitialReportPackets(start_time);
+
+  EXPECT_CALL(*consumer(), OnFramesReady(Gt(0))).Times(3);
+  for (int i = 0; i <= 2; ++i) {
+    EXPECT_CALL(*sender(), OnReceiverCheckpoint(
+                               FrameId::first() + i,
+                               SimulatedFrame::GetExpectedPlayoutDelay(i)))
+        .Times(1);
+    EXPECT_CALL(*sender(), OnReceiverIsMissingPackets(_)).Times(0);
+
+    sender()->SetFrameBeingSent(SimulatedFrame(start_time, i));
+    sender()->SendRtpPacketsInOneRead(sender()->GetAllPacketIds(i));
+    AdvanceClockAndRunTasks(kRoundTripNetworkDelay);
+    testing::Mock::VerifyAndClearExpectations(sender());
+
+    AdvanceClockAndRunTasks(SimulatedFrame::kFrameDuration -
+                            kRoundTripNetworkDelay);
+  }
+
+  ConsumeAndVerifyFrames(0, 2, start_time);
+  EXPECT_FALSE(receiver()->AdvanceToNextFrame().has_value());
+}
+
 // Tests that the Receiver processes RTP packets, can receive frames out of
 // order, and issues the appropriate ACK/NACK feedback to the Sender as it
 // realizes what it has and what it's missing.
@@ -595,6 +647,63 @@ TEST_F(ReceiverTest, ReceivesFramesOutOfOrder) {
   EXPECT_FALSE(receiver()->AdvanceToNextFrame().has_value());
 }
 
+// Tests that the Receiver can hand over the buffer it decrypted a frame into,
+// instead of copying the payload into one provided by the consumer.
+TEST_F(ReceiverTest, HandsOverDecryptedFrames) {
+  const Clock::time_point start_time = FakeClock::now();
+  ExchangeInitialReportPackets(start_time);
+
+  EXPECT_CALL(*consumer(), OnFramesReady(Gt(0))).Times(AtLeast(1));
+  for (int i = 0; i <= 2; ++i) {
+    sender()->SetFrameBeingSent(SimulatedFrame(start_time, i));
+    // Send the packets in a different order for each frame.
+    sender()->SendRtpPackets(sender()->GetAllPacketIds(i + 1));
+    AdvanceClockAndRunTasks(kRoundTripNetworkDelay);
+  }
+
+  std::vector<uint8_t> buffer;
+  for (int i = 0; i <= 2; ++i) {
+    const SimulatedFrame sent_frame(start_time, i);
+    ASSERT_TRUE(receiver()->AdvanceToNextFrame().has_value());
+    const EncodedFrame received_frame = receiver()->TakeNextFrame(&buffer);
+    EXPECT_EQ(sent_frame.frame_id, received_frame.frame_id);
+    EXPECT_EQ(sent_frame.rtp_timestamp, received_frame.rtp_timestamp);
+    EXPECT_EQ(buffer.data(), received_frame.data.data());
+    EXPECT_THAT(sent_frame.data,
+                testing::ElementsAreArray(received_frame.data));
+  }
+  EXPECT_FALSE(receiver()->AdvanceToNextFrame().has_value());
+}
+
+// Tests that the default Receiver::TakeNextFrame(), which copies the payload
+// with ConsumeNextFrame(), has the same precondition as the ReceiverImpl
+// override: AdvanceToNextFrame() must have been called first.
+TEST_F(ReceiverTest, DefaultTakeNextFrameConsumesAdvancedFrame) {
+  const Clock::time_point start_time = FakeClock::now();
+  ExchangeInitialReportPackets(start_time);
+
+  EXPECT_CALL(*consumer(), OnFramesReady(Gt(0))).Times(AtLeast(1));
+  for (int i = 0; i <= 2; ++i) {
+    sender()->SetFrameBeingSent(SimulatedFrame(start_time, i));
+    sender()->SendRtpPackets(sender()->GetAllPacketIds(i + 1));
+    AdvanceClockAndRunTasks(kRoundTripNetworkDelay);
+  }
+
+  std::vector<uint8_t> buffer;
+  for (int i = 0; i <= 2; ++i) {
+    const SimulatedFrame sent_frame(start_time, i);
+    const std::optional<size_t> frame_size = receiver()->AdvanceToNextFrame();
+    ASSERT_TRUE(frame_size.has_value());
+    const EncodedFrame received_frame =
+        receiver()->Receiver::TakeNextFrame(&buffer);
+    EXPECT_EQ(sent_frame.frame_id, received_frame.frame_id);
+    EXPECT_EQ(*frame_size, buffer.size());
+    EXPECT_THAT(sent_frame.data,
+                testing::ElementsAreArray(received_frame.data));
+  }
+  EXPECT_FALSE(receiver()->AdvanceToNextFrame().has_value());
+}
+
 // Tests that the Receiver will respond to a key frame request from its client
 // by sending a Picture Loss Indicator (PLI) to the Sender, and then will
 // automatically stop sending the PLI once a key frame has been received.
@@ -1093,5 +1202,46 @@ TEST_F(ReceiverTest, ReportPlayoutEventWithZeroDelay) {
   AdvanceClockAndRunTasks(kRtcpReportInterval + kOneWayNetworkDelay);
 }
 
+// Tests that, if configured, the Receiver shrinks the target playout delay on a
+// clean network, and reports each change to the Sender.
+TEST_F(ReceiverTest, AdaptsPlayoutDelayToTheNetwork) {
+  ConstructReceiver(ReceiverOptions{
+      .adaptive_playout_delay =
+          PlayoutDelayBounds{.min = milliseconds(10), .max = seconds(1)}});
+  EXPECT_EQ(kTargetPlayoutDelay,
+            receiver()->jitter_buffer_metrics()->playout_delay);
+
+  const Clock::time_point start_time = FakeClock::now();
+  ExchangeInitialReportPackets(start_time);
+  milliseconds reported_delay = kTargetPlayoutDelay;
+  ON_CALL(*sender(), OnReceiverCheckpoint(_, _))
+      .WillByDefault(SaveArg<1>(&reported_delay));
+
+  // Send and consume three seconds of frames. Frame 5 is sent with an increase
+  // of the target playout delay, to 800 ms.
+  constexpr int kNumFrames = 300;
+  sender()->set_max_feedback_frame_id(FrameId::first() + kNumFrames);
+  for (int i = 0; i < kNumFrames; ++i) {
+    sender()->SetFrameBeingSent(SimulatedFrame(start_time, i));
+    sender()->SendRtpPackets(sender()->GetAllPacketIds());
+    AdvanceClockAndRunTasks(SimulatedFrame::kFrameDuration);
+    while (const std::optional<size_t> payload_size =
+               receiver()->AdvanceToNextFrame()) {
+      std::vector<uint8_t> buffer(*payload_size);
+      receiver()->ConsumeNextFrame(buffer);
+    }
+  }
+  AdvanceClockAndRunTasks(kRoundTripNetworkDelay);
+
+  const AdaptiveJitterBuffer::Metrics& metrics =
+      *receiver()->jitter_buffer_metrics();
+  EXPECT_EQ(kNumFrames, metrics.frames_completed);
+  EXPECT_EQ(0, metrics.frames_late);
+  EXPECT_EQ(0, metrics.delay_increases);
+  EXPECT_LT(0, metrics.delay_decreases);
+  EXPECT_GT(kTargetPlayoutDelayChange, metrics.playout_delay);
+  EXPECT_EQ(metrics.playout_delay, reported_delay);
+}
+
 }  // namespace
 }  // namespace openscreen::cast
@@ -5,6 +5,7 @@
 #include "cast/streaming/impl/receiver_packet_router.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "cast/streaming/impl/packet_util.h"
 #include "platform/base/span.h"
@@ -54,16 +55,73 @@ void ReceiverPacketRouter::SendRtcpPacket(ByteView packet) {
                            PacketMetadata{});
 }
 
+void ReceiverPacketRouter::PacketConsumer::OnReceivedRtpPackets(
+    Clock::time_point arrival_time,
+    std::span<UdpPacket> packets) {
+  for (UdpPacket& packet : packets) {
+    OnReceivedRtpPacket(arrival_time, std::move(packet));
+  }
+}
+
 void ReceiverPacketRouter::OnReceivedPacket(const IPEndpoint& source,
                                             Clock::time_point arrival_time,
-                                            std::vector<uint8_t> packet) {
+                                            UdpPacket packet) {
+  const auto [consumer, type] = Route(source, packet);
+  if (!consumer) {
+    return;
+  }
+  if (type == ApparentPacketType::RTP) {
+    consumer->OnReceivedRtpPacket(arrival_time, std::move(packet));
+  } else {
+    consumer->OnReceivedRtcpPacket(arrival_time, packet);
+  }
+}
+
+void ReceiverPacketRouter::OnReceivedPackets(Clock::time_point arrival_time,
+                                             std::span<UdpPacket> packets) {
+  // Consecutive RTP packets for the same consumer are handed over together,
+  // so that it can parse them as a batch. They are gathered at the front of
+  // `packets`, in place of the ones already handed over or dropped.
+  PacketConsumer* rtp_consumer = nullptr;
+  size_t rtp_begin = 0;
+  size_t rtp_end = 0;
+  const auto flush_rtp_packets = [&] {
+    if (rtp_consumer && rtp_end > rtp_begin) {
+      rtp_consumer->OnReceivedRtpPackets(
+          arrival_time, packets.subspan(rtp_begin, rtp_end - rtp_begin));
+    }
+    rtp_consumer = nullptr;
+    rtp_begin = rtp_end;
+  };
+
+  for (UdpPacket& packet : packets) {
+    const auto [consumer, type] = Route(packet.source(), packet);
+    if (!consumer) {
+      continue;
+    }
+    if (type == ApparentPacketType::RTCP) {
+      flush_rtp_packets();
+      consumer->OnReceivedRtcpPacket(arrival_time, packet);
+      continue;
+    }
+    if (consumer != rtp_consumer) {
+      flush_rtp_packets();
+      rtp_consumer = consumer;
+    }
+    packets[rtp_end++] = std::move(packet);
+  }
+  flush_rtp_packets();
+}
+
+std::pair<ReceiverPacketRouter::PacketConsumer*, ApparentPacketType>
+ReceiverPacketRouter::Route(const IPEndpoint& source, ByteView packet) {
   OSP_CHECK_NE(source.port, uint16_t{0});
 
   // If the sender endpoint is known, ignore any packet that did not come from
   // that same endpoint.
   if (environment_->remote_endpoint().port != 0) {
     if (source != environment_->remote_endpoint()) {
-      return;
+      return {nullptr, ApparentPacketType::UNKNOWN};
     }
   }
 
@@ -76,11 +134,11 @@ void ReceiverPacketRouter::OnReceivedPacket(const IPEndpoint& source,
     OSP_LOG_WARN << "UNKNOWN packet of " << packet.size()
                  << " bytes. Partial hex dump: "
                  << HexEncode(packet.data(), encode_size);
-    return;
+    return {nullptr, ApparentPacketType::UNKNOWN};
   }
   auto it = receivers_.find(seems_like.second);
   if (it == receivers_.end()) {
-    return;
+    return {nullptr, ApparentPacketType::UNKNOWN};
   }
   // At this point, a valid packet has been matched with a receiver. Lock-in
   // the remote endpoint as the `source` of this `packet` so that only packets
@@ -88,12 +146,7 @@ void ReceiverPacketRouter::OnReceivedPacket(const IPEndpoint& source,
   if (environment_->remote_endpoint().port == 0) {
     environment_->set_remote_endpoint(source);
   }
-
-  if (seems_like.first == ApparentPacketType::RTP) {
-    it->second->OnReceivedRtpPacket(arrival_time, std::move(packet));
-  } else if (seems_like.first == ApparentPacketType::RTCP) {
-    it->second->OnReceivedRtcpPacket(arrival_time, packet);
-  }
+  return {it->second.get(), seems_like.first};
 }
 
 }  // namespace openscreen::cast
@@ -10,9 +10,11 @@
 #include <utility>
 #include <vector>
 
+#include "cast/streaming/impl/packet_util.h"
 #include "cast/streaming/public/environment.h"
 #include "cast/streaming/ssrc.h"
 #include "platform/base/span.h"
+#include "platform/base/udp_packet.h"
 #include "util/flat_map.h"
 #include "util/raw_ptr.h"
 #include "util/raw_ref.h"
@@ -31,7 +33,13 @@ class ReceiverPacketRouter final : public Environment::PacketConsumer {
   class PacketConsumer {
    public:
     virtual void OnReceivedRtpPacket(Clock::time_point arrival_time,
-                                     std::vector<uint8_t> packet) = 0;
+                                     UdpPacket packet) = 0;
+
+    // Called with consecutive RTP packets from one batched socket read, which
+    // share the same `arrival_time`. The default implementation calls
+    // OnReceivedRtpPacket() for each.
+    virtual void OnReceivedRtpPackets(Clock::time_point arrival_time,
+                                      std::span<UdpPacket> packets);
     virtual void OnReceivedRtcpPacket(Clock::time_point arrival_time,
                                       std::span<const uint8_t> packet) = 0;
 
@@ -57,7 +65,15 @@ class ReceiverPacketRouter final : public Environment::PacketConsumer {
   // Environment::PacketConsumer implementation.
   void OnReceivedPacket(const IPEndpoint& source,
                         Clock::time_point arrival_time,
-                        std::vector<uint8_t> packet) final;
+                        UdpPacket packet) final;
+  void OnReceivedPackets(Clock::time_point arrival_time,
+                         std::span<UdpPacket> packets) final;
+
+  // Returns the PacketConsumer to which the `packet` from `source` should be
+  // dispatched, and whether it is RTP or RTCP; or nullptr if it should be
+  // dropped.
+  std::pair<PacketConsumer*, ApparentPacketType> Route(const IPEndpoint& source,
+                                                       ByteView packet);
 
   const raw_ref<Environment> environment_;
 
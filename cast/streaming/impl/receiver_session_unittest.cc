@@ -1111,6 +1111,103 @@ TEST_F(ReceiverSessionTest, EnablesDscpInAnswer) {
   ASSERT_TRUE(dscp2.empty());
 }
 
+TEST_F(ReceiverSessionTest, AcceptsOfferedFecIfSupported) {
+  // Offer FEC on every stream.
+  ErrorOr<Json::Value> offer = json::Parse(kValidOfferMessage);
+  ASSERT_TRUE(offer.is_value());
+  for (Json::Value& stream : offer.value()["offer"]["supportedStreams"]) {
+    stream["fecGroupSize"] = 8;
+  }
+  const ErrorOr<std::string> offer_message = json::Stringify(offer.value());
+  ASSERT_TRUE(offer_message.is_value());
+
+  for (const bool supports_fec : {true, false}) {
+    SCOPED_TRACE(testing::Message() << "supports_fec=" << supports_fec);
+    message_port_->clear();
+    ReceiverConstraints constraints;
+    constraints.supports_fec = supports_fec;
+    SetUpWithConstraints(std::move(constraints));
+    EXPECT_CALL(client_, OnNegotiated(session_.get(), _));
+    EXPECT_CALL(client_,
+                OnReceiversDestroying(session_.get(),
+                                      ReceiverSession::Client::kEndOfSession));
+    message_port_->ReceiveMessage(offer_message.value());
+
+    const std::vector<std::string>& messages =
+        message_port_->posted_messages();
+    ASSERT_EQ(1u, messages.size());
+    const Json::Value message = ExpectIsValidAnswer(messages[0]);
+    const Json::Value& answer = message["answer"];
+    ASSERT_TRUE(answer.isObject());
+    if (supports_fec) {
+      // Both the selected audio and video streams accept FEC.
+      EXPECT_EQ(answer["receiverFec"], answer["sendIndexes"]);
+    } else {
+      EXPECT_FALSE(answer.isMember("receiverFec"));
+    }
+  }
+}
+
+TEST_F(ReceiverSessionTest, AcceptsOfferedAdaptivePlayoutDelayIfSupported) {
+  // Offer adaptive playout delay on every stream.
+  ErrorOr<Json::Value> offer = json::Parse(kValidOfferMessage);
+  ASSERT_TRUE(offer.is_value());
+  for (Json::Value& stream : offer.value()["offer"]["supportedStreams"]) {
+    stream["rtpExtensions"].append(kAdaptivePlayoutDelayRtpExtension);
+  }
+  const ErrorOr<std::string> offer_message = json::Stringify(offer.value());
+  ASSERT_TRUE(offer_message.is_value());
+
+  constexpr PlayoutDelayBounds kBounds{.min = std::chrono::milliseconds(40),
+                                       .max = std::chrono::milliseconds(400)};
+  for (const bool supported : {true, false}) {
+    SCOPED_TRACE(testing::Message() << "supported=" << supported);
+    message_port_->clear();
+    ReceiverConstraints constraints;
+    if (supported) {
+      constraints.adaptive_playout_delay = kBounds;
+    }
+    SetUpWithConstraints(std::move(constraints));
+    EXPECT_CALL(client_, OnNegotiated(session_.get(), _))
+        .WillOnce([&](const ReceiverSession* session,
+                      ReceiverSession::ConfiguredReceivers cr) {
+          for (const Receiver* receiver : {cr.audio_receiver.get(),
+                                           cr.video_receiver.get()}) {
+            ASSERT_TRUE(receiver);
+            const std::optional<PlayoutDelayBounds>& bounds =
+                receiver->config().adaptive_playout_delay;
+            ASSERT_EQ(supported, bounds.has_value());
+            if (supported) {
+              EXPECT_EQ(kBounds.min, bounds->min);
+              EXPECT_EQ(kBounds.max, bounds->max);
+            }
+          }
+        });
+    EXPECT_CALL(client_,
+                OnReceiversDestroying(session_.get(),
+                                      ReceiverSession::Client::kEndOfSession));
+    message_port_->ReceiveMessage(offer_message.value());
+
+    const std::vector<std::string>& messages =
+        message_port_->posted_messages();
+    ASSERT_EQ(1u, messages.size());
+    const Json::Value message = ExpectIsValidAnswer(messages[0]);
+    const Json::Value& answer = message["answer"];
+    ASSERT_TRUE(answer.isObject());
+    if (supported) {
+      // Both the selected audio and video streams accept the extension.
+      const Json::Value& extensions = answer["rtpExtensions"];
+      ASSERT_EQ(2u, extensions.size());
+      for (const Json::Value& stream_extensions : extensions) {
+        EXPECT_TRUE(
+            Contains(stream_extensions, kAdaptivePlayoutDelayRtpExtension));
+      }
+    } else {
+      EXPECT_FALSE(answer.isMember("rtpExtensions"));
+    }
+  }
+}
+
 TEST_F(ReceiverSessionTest, InputEventsOptIn) {
   ReceiverConstraints constraints;
   constraints.supports_input_events = true;
@@ -125,8 +125,8 @@ inline constexpr uint8_t kRtpKeyFrameBitMask = 0b10000000;
 inline constexpr uint8_t kRtpHasReferenceFrameIdBitMask = 0b01000000;
 inline constexpr uint8_t kRtpExtensionCountMask = 0b00111111;
 
-// Cast extensions. This implementation supports only the Adaptive Latency
-// extension, and ignores all others:
+// Cast extensions. This implementation supports the Adaptive Latency and
+// Forward Error Correction extensions, and ignores all others:
 //
 //  0                   1                   2                   3
 //  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
@@ -137,6 +137,24 @@ inline constexpr uint8_t kRtpExtensionCountMask = 0b00111111;
 // The Adaptive Latency extension permits changing the fixed end-to-end playout
 // delay of a single RTP stream.
 inline constexpr uint8_t kAdaptiveLatencyRtpExtensionType = 1;
+//
+//  0                   1                   2                   3
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |  TYPE = 3 | Ext data SIZE = 4 |   Number of protected packets |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |     XOR of payload sizes      |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// The Forward Error Correction extension marks a parity packet, which is only
+// sent if FEC was negotiated for the RTP stream. A parity packet has the same
+// RTP and Cast headers as the frame's data packets, except that the marker bit
+// is never set and the Packet ID is that of the first of a group of consecutive
+// data packets it protects. Its payload is the XOR of the payloads of those
+// data packets, each zero-padded to the size of the largest one. A Receiver
+// missing exactly one packet of the group can recover it from the others and
+// the parity packet, without waiting for a retransmission.
+inline constexpr uint8_t kFecRtpExtensionType = 3;
 inline constexpr int kNumExtensionDataSizeFieldBits = 10;
 
 // RTCP Common Header:
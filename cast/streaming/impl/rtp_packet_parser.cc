@@ -12,6 +12,31 @@
 
 namespace openscreen::cast {
 
+namespace {
+
+// The offsets of the fields in the fixed-size part of the Cast RTP header,
+// which is checked to be present before any of them are read.
+constexpr size_t kPayloadTypeOffset = 1;
+constexpr size_t kSequenceNumberOffset = 2;
+constexpr size_t kRtpTimestampOffset = 4;
+constexpr size_t kSsrcOffset = 8;
+constexpr size_t kCastFlagsOffset = 12;
+constexpr size_t kFrameIdOffset = 13;
+constexpr size_t kPacketIdOffset = 14;
+constexpr size_t kMaxPacketIdOffset = 16;
+
+// Reads the field at `kOffset` in the fixed-size part of the header. The field
+// is known at compile time to lie within it, so unlike ConsumeField(), this
+// needs no run-time bounds check.
+template <typename Integer, size_t kOffset>
+Integer ReadHeaderField(const uint8_t* header) {
+  static_assert(kOffset + sizeof(Integer) <= size_t{kRtpPacketMinValidSize},
+                "field must be within the fixed-size header");
+  return ReadBigEndian<Integer>(header + kOffset);
+}
+
+}  // namespace
+
 RtpPacketParser::RtpPacketParser(Ssrc sender_ssrc)
     : sender_ssrc_(sender_ssrc), highest_rtp_frame_id_(FrameId::first()) {}
 
@@ -20,9 +45,10 @@ RtpPacketParser::~RtpPacketParser() = default;
 std::optional<RtpPacketParser::ParseResult> RtpPacketParser::Parse(
     ByteView buffer) {
   if (buffer.size() < kRtpPacketMinValidSize ||
-      ConsumeField<uint8_t>(buffer) != kRtpRequiredFirstByte) {
+      buffer[0] != kRtpRequiredFirstByte) {
     return std::nullopt;
   }
+  const uint8_t* const header = buffer.data();
 
   // RTP header elements.
   //
@@ -31,34 +57,40 @@ std::optional<RtpPacketParser::ParseResult> RtpPacketParser::Parse(
   // lenient just in case some sender implementations don't adhere to this tiny,
   // subtle detail.
   const uint8_t payload_type =
-      ConsumeField<uint8_t>(buffer) & kRtpPayloadTypeMask;
+      ReadHeaderField<uint8_t, kPayloadTypeOffset>(header) &
+      kRtpPayloadTypeMask;
   if (!IsRtpPayloadType(payload_type)) {
     return std::nullopt;
   }
-  ParseResult result;
-  result.payload_type = static_cast<RtpPayloadType>(payload_type);
-  result.sequence_number = ConsumeField<uint16_t>(buffer);
-  result.rtp_timestamp =
-      last_parsed_rtp_timestamp_.Expand(ConsumeField<uint32_t>(buffer));
-  if (ConsumeField<uint32_t>(buffer) != sender_ssrc_) {
+  if (ReadHeaderField<uint32_t, kSsrcOffset>(header) != sender_ssrc_) {
     return std::nullopt;
   }
+  ParseResult result;
+  result.payload_type = static_cast<RtpPayloadType>(payload_type);
+  result.sequence_number =
+      ReadHeaderField<uint16_t, kSequenceNumberOffset>(header);
+  result.rtp_timestamp = last_parsed_rtp_timestamp_.Expand(
+      ReadHeaderField<uint32_t, kRtpTimestampOffset>(header));
 
   // Cast-specific header elements.
-  const uint8_t byte12 = ConsumeField<uint8_t>(buffer);
-  result.is_key_frame = !!(byte12 & kRtpKeyFrameBitMask);
+  const uint8_t cast_flags = ReadHeaderField<uint8_t, kCastFlagsOffset>(header);
+  result.is_key_frame = !!(cast_flags & kRtpKeyFrameBitMask);
   const bool has_referenced_frame_id =
-      !!(byte12 & kRtpHasReferenceFrameIdBitMask);
-  const size_t num_cast_extensions = byte12 & kRtpExtensionCountMask;
-  result.frame_id = highest_rtp_frame_id_.Expand(ConsumeField<uint8_t>(buffer));
-  result.packet_id = ConsumeField<uint16_t>(buffer);
-  result.max_packet_id = ConsumeField<uint16_t>(buffer);
+      !!(cast_flags & kRtpHasReferenceFrameIdBitMask);
+  const size_t num_cast_extensions = cast_flags & kRtpExtensionCountMask;
+  result.frame_id = highest_rtp_frame_id_.Expand(
+      ReadHeaderField<uint8_t, kFrameIdOffset>(header));
+  result.packet_id = ReadHeaderField<uint16_t, kPacketIdOffset>(header);
+  result.max_packet_id = ReadHeaderField<uint16_t, kMaxPacketIdOffset>(header);
   if (result.max_packet_id == kAllPacketsLost) {
     return std::nullopt;  // Packet ID cannot be the special value.
   }
   if (result.packet_id > result.max_packet_id) {
     return std::nullopt;
   }
+
+  // The optional fields follow the fixed-size header.
+  buffer = buffer.subspan(kRtpPacketMinValidSize);
   if (has_referenced_frame_id) {
     if (buffer.empty()) {
       return std::nullopt;
@@ -91,6 +123,20 @@ std::optional<RtpPacketParser::ParseResult> RtpPacketParser::Parse(
       }
       result.new_playout_delay =
           std::chrono::milliseconds(ReadBigEndian<uint16_t>(buffer.data()));
+    } else if (type == kFecRtpExtensionType) {
+      if (size != 2 * sizeof(uint16_t)) {
+        return std::nullopt;
+      }
+      const int num_protected_packets =
+          ReadBigEndian<uint16_t>(buffer.data());
+      if (num_protected_packets == 0 ||
+          int{result.packet_id} + num_protected_packets >
+              int{result.max_packet_id} + 1) {
+        return std::nullopt;
+      }
+      result.fec_parity = ParseResult::FecParity{
+          num_protected_packets,
+          ReadBigEndian<uint16_t>(buffer.data() + sizeof(uint16_t))};
     }
     buffer = buffer.subspan(size);
   }
@@ -107,6 +153,20 @@ std::optional<RtpPacketParser::ParseResult> RtpPacketParser::Parse(
   return result;
 }
 
+int RtpPacketParser::ParseBatch(
+    std::span<const ByteView> packets,
+    std::span<std::optional<ParseResult>> results) {
+  OSP_CHECK_GE(results.size(), packets.size());
+  int num_parsed = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    results[i] = Parse(packets[i]);
+    if (results[i]) {
+      ++num_parsed;
+    }
+  }
+  return num_parsed;
+}
+
 RtpPacketParser::ParseResult::ParseResult() = default;
 RtpPacketParser::ParseResult::~ParseResult() = default;
 
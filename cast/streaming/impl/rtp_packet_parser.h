@@ -5,8 +5,11 @@
 #ifndef CAST_STREAMING_IMPL_RTP_PACKET_PARSER_H_
 #define CAST_STREAMING_IMPL_RTP_PACKET_PARSER_H_
 
+#include <stdint.h>
+
 #include <chrono>
 #include <optional>
+#include <span>
 
 #include "cast/streaming/impl/rtp_defines.h"
 #include "cast/streaming/public/frame_id.h"
@@ -41,6 +44,14 @@ class RtpPacketParser {
     FrameId referenced_frame_id;  // ID of frame required to decode this one.
     std::chrono::milliseconds new_playout_delay{};  // Ignore if non-positive.
 
+    // Set only for Forward Error Correction parity packets, which protect the
+    // data packets in the range [packet_id,packet_id+num_protected_packets).
+    struct FecParity {
+      int num_protected_packets;  // Always at least one.
+      uint16_t payload_size_xor;  // XOR of the protected payload sizes.
+    };
+    std::optional<FecParity> fec_parity;
+
     // Portion of the `packet` that was passed into Parse() that contains the
     // payload. WARNING: This memory region is only valid while the original
     // `packet` memory remains valid.
@@ -58,6 +69,14 @@ class RtpPacketParser {
   // instance. Returns std::nullopt if the `packet` was corrupt.
   std::optional<ParseResult> Parse(ByteView packet);
 
+  // Parses each of the `packets`, in order, as if by Parse(), into the
+  // corresponding element of `results`, which must have room for all of them.
+  // ReceiverImpl uses this for the RTP packets of one batched socket read (see
+  // Environment::SetReceiveBatchSize()). Returns the number of packets that
+  // were well-formed.
+  int ParseBatch(std::span<const ByteView> packets,
+                 std::span<std::optional<ParseResult>> results);
+
  private:
   const Ssrc sender_ssrc_;
 
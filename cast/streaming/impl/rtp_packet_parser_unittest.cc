@@ -4,6 +4,8 @@
 
 #include "cast/streaming/impl/rtp_packet_parser.h"
 
+#include <optional>
+
 #include "cast/streaming/impl/rtp_defines.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -195,6 +197,48 @@ TEST(RtpPacketParserTest, ParsesPacketWithMultipleExtensions) {
   EXPECT_THAT(result->payload, ElementsAreArray(kInput + 34, 15));
 }
 
+// Tests that a Forward Error Correction parity packet can be parsed, and that
+// it is rejected if it claims to protect packets past the end of the frame.
+TEST(RtpPacketParserTest, ParsesParityPacket) {
+  // clang-format off
+  const uint8_t kInput[] = {
+    0b10000000,  // Version/Padding byte.
+    96,  // Payload type byte.
+    0xde, 0xad,  // Sequence number.
+    2, 4, 6, 8,  // RTP timestamp.
+    0, 0, 1, 1,  // SSRC.
+    0b01000001,  // Has ref frame ID; has one extension.
+    64,  // Frame ID.
+    0x0, 0x8,  // Packet ID.
+    0x0, 0xb,  // Max packet ID.
+    63,  // Reference Frame ID.
+    12, 4, 0, 4, 0x12, 0x34,  // Cast FEC Extension data.
+    1, 3, 5, 7, 9, 11, 13, 15  // Payload.
+  };
+  // clang-format on
+  const Ssrc kSenderSsrc = 0x00000101;
+
+  RtpPacketParser parser(kSenderSsrc);
+  const auto result = parser.Parse(kInput);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(FramePacketId{0x0008}, result->packet_id);
+  EXPECT_EQ(FramePacketId{0x000b}, result->max_packet_id);
+  ASSERT_TRUE(result->fec_parity);
+  EXPECT_EQ(4, result->fec_parity->num_protected_packets);
+  EXPECT_EQ(UINT16_C(0x1234), result->fec_parity->payload_size_xor);
+  EXPECT_THAT(result->payload, ElementsAreArray(kInput + 25, 8));
+
+  // Protecting packets 8 through 12, with 11 being the last, is invalid.
+  uint8_t input_with_bad_range[sizeof(kInput)];
+  memcpy(input_with_bad_range, kInput, sizeof(kInput));
+  WriteBigEndian<uint16_t>(5, &input_with_bad_range[21]);
+  EXPECT_FALSE(parser.Parse(input_with_bad_range));
+
+  // So is protecting no packets at all.
+  WriteBigEndian<uint16_t>(0, &input_with_bad_range[21]);
+  EXPECT_FALSE(parser.Parse(input_with_bad_range));
+}
+
 // Tests that the parser ignores packets from an unknown source.
 TEST(RtpPacketParserTest, IgnoresPacketWithWrongSsrc) {
   // clang-format off
@@ -297,5 +341,56 @@ TEST(RtpPacketParserTest, RejectsPacketWithBadFramePacketIds) {
   ASSERT_FALSE(parser.Parse(input_with_bad_max_packet_id));
 }
 
+// Tests that a batch of packets is parsed in order, with a result for each
+// packet, and that corrupt packets in the batch do not affect the others.
+TEST(RtpPacketParserTest, ParsesBatchOfPackets) {
+  // clang-format off
+  const uint8_t kFirstPacket[] = {
+    0b10000000,  // Version/Padding byte.
+    96,  // Payload type byte.
+    0x00, 0x01,  // Sequence number.
+    9, 8, 7, 6,  // RTP timestamp.
+    1, 2, 3, 4,  // SSRC.
+    0b10000000,  // Is key frame, no extensions.
+    5,  // Frame ID.
+    0x0, 0x0,  // Packet ID.
+    0x0, 0x1,  // Max packet ID.
+    0xf, 0xe, 0xd, 0xc,  // Payload.
+  };
+  const uint8_t kSecondPacket[] = {
+    0b10000000,  // Version/Padding byte.
+    96,  // Payload type byte.
+    0x00, 0x02,  // Sequence number.
+    9, 8, 7, 6,  // RTP timestamp.
+    1, 2, 3, 4,  // SSRC.
+    0b10000000,  // Is key frame, no extensions.
+    5,  // Frame ID.
+    0x0, 0x1,  // Packet ID.
+    0x0, 0x1,  // Max packet ID.
+    0xb, 0xa,  // Payload.
+  };
+  // clang-format on
+  const Ssrc kSenderSsrc = 0x01020304;
+
+  const ByteView packets[] = {
+      kFirstPacket,
+      ByteView(kSecondPacket, 10),  // Truncated.
+      kSecondPacket,
+  };
+  std::optional<RtpPacketParser::ParseResult> results[3];
+  RtpPacketParser parser(kSenderSsrc);
+  EXPECT_EQ(2, parser.ParseBatch(packets, results));
+
+  ASSERT_TRUE(results[0]);
+  EXPECT_EQ(UINT16_C(1), results[0]->sequence_number);
+  EXPECT_EQ(FramePacketId{0}, results[0]->packet_id);
+  EXPECT_THAT(results[0]->payload, ElementsAreArray(kFirstPacket + 18, 4));
+  EXPECT_FALSE(results[1]);
+  ASSERT_TRUE(results[2]);
+  EXPECT_EQ(UINT16_C(2), results[2]->sequence_number);
+  EXPECT_EQ(FramePacketId{1}, results[2]->packet_id);
+  EXPECT_THAT(results[2]->payload, ElementsAreArray(kSecondPacket + 18, 2));
+}
+
 }  // namespace
 }  // namespace openscreen::cast
@@ -37,13 +37,16 @@ uint16_t GenerateRandomSequenceNumberStart() {
 
 RtpPacketizer::RtpPacketizer(RtpPayloadType payload_type,
                              Ssrc sender_ssrc,
-                             int max_packet_size)
+                             int max_packet_size,
+                             int fec_group_size)
     : payload_type_7bits_(static_cast<uint8_t>(payload_type)),
       sender_ssrc_(sender_ssrc),
       max_packet_size_(max_packet_size),
+      fec_group_size_(fec_group_size),
       sequence_number_(GenerateRandomSequenceNumberStart()) {
   OSP_CHECK(IsRtpPayloadType(payload_type_7bits_));
-  OSP_CHECK_GT(max_packet_size_, kMaxRtpHeaderSize);
+  OSP_CHECK_GE(fec_group_size_, 0);
+  OSP_CHECK_GT(max_payload_size(), 0);
 }
 
 RtpPacketizer::~RtpPacketizer() = default;
@@ -53,34 +56,127 @@ ByteBuffer RtpPacketizer::GeneratePacket(const EncryptedFrame& frame,
                                          ByteBuffer buffer) {
   OSP_CHECK_GE(static_cast<int>(buffer.size()), max_packet_size_);
 
+  const UdpSocket::GatheredMessage packet =
+      GeneratePacketHeader(frame, packet_id, buffer);
+  // Copy the encrypted payload data into the packet, after the header.
+  std::copy(packet.payload.begin(), packet.payload.end(),
+            buffer.data() + packet.header.size());
+  return buffer.first(packet.size());
+}
+
+UdpSocket::GatheredMessage RtpPacketizer::GeneratePacketHeader(
+    const EncryptedFrame& frame,
+    FramePacketId packet_id,
+    ByteBuffer buffer) {
+  OSP_CHECK_GE(static_cast<int>(buffer.size()), kMaxRtpHeaderSize);
+
   const int num_packets = ComputeNumberOfPackets(frame);
   OSP_CHECK_GT(num_packets, 0);
   OSP_CHECK_LT(int{packet_id}, num_packets);
   const bool is_last_packet = int{packet_id} == (num_packets - 1);
 
-  // Compute the size of this packet, which is the number of bytes of header
-  // plus the number of bytes of payload. Note that the optional Adaptive
-  // Latency information is only added to the first packet.
-  int packet_size = kBaseRtpHeaderSize;
+  const int header_size = WriteHeader(frame, packet_id, num_packets,
+                                      /* num_protected_packets */ 0,
+                                      /* payload_size_xor */ 0, buffer);
+  int data_chunk_size = max_payload_size();
+  const int data_chunk_start = data_chunk_size * int{packet_id};
+  if (is_last_packet) {
+    data_chunk_size = static_cast<int>(frame.data.size()) - data_chunk_start;
+  }
+  OSP_CHECK_LE(header_size + data_chunk_size, max_packet_size_);
+
+  return {ByteView(buffer.data(), header_size),
+          frame.data.subspan(data_chunk_start, data_chunk_size)};
+}
+
+ByteBuffer RtpPacketizer::GenerateParityPacket(const EncryptedFrame& frame,
+                                               FramePacketId first_packet_id,
+                                               int num_packets,
+                                               ByteBuffer buffer) {
+  OSP_CHECK_GT(fec_group_size_, 0);
+  OSP_CHECK_GE(static_cast<int>(buffer.size()), max_packet_size_);
+  const int frame_packet_count = ComputeNumberOfPackets(frame);
+  OSP_CHECK_GT(num_packets, 0);
+  OSP_CHECK_LE(int{first_packet_id} + num_packets, frame_packet_count);
+
+  // Returns the payload of the i-th data packet of the group.
+  const int max_chunk_size = max_payload_size();
+  const int frame_size = static_cast<int>(frame.data.size());
+  const auto get_chunk = [&](int i) {
+    const int chunk_start = max_chunk_size * (int{first_packet_id} + i);
+    return frame.data.subspan(
+        chunk_start, std::min(max_chunk_size, frame_size - chunk_start));
+  };
+
+  // Only the last packet of a frame can have less than `max_payload_size()`
+  // bytes of payload, and so the first packet of the group is the largest.
+  const ByteView first_chunk = get_chunk(0);
+  const int parity_size = static_cast<int>(first_chunk.size());
+
+  uint16_t payload_size_xor = 0;
+  for (int i = 0; i < num_packets; ++i) {
+    payload_size_xor ^= static_cast<uint16_t>(get_chunk(i).size());
+  }
+
+  const int header_size =
+      WriteHeader(frame, first_packet_id, frame_packet_count, num_packets,
+                  payload_size_xor, buffer);
+  OSP_CHECK_LE(header_size + parity_size, max_packet_size_);
+
+  const ByteBuffer parity = buffer.subspan(header_size, parity_size);
+  std::copy(first_chunk.begin(), first_chunk.end(), parity.begin());
+  for (int i = 1; i < num_packets; ++i) {
+    const ByteView chunk = get_chunk(i);
+    for (size_t j = 0; j < chunk.size(); ++j) {
+      parity[j] ^= chunk[j];
+    }
+  }
+
+  return buffer.first(header_size + parity_size);
+}
+
+int RtpPacketizer::ComputeNumberOfPackets(const EncryptedFrame& frame) const {
+  // The total number of packets is computed by assuming the payload will be
+  // split-up across as few packets as possible.
+  int num_packets = DividePositivesRoundingUp(
+      static_cast<int>(frame.data.size()), max_payload_size());
+  // Edge case: There must always be at least one packet, even when there are no
+  // payload bytes. Some audio codecs, for example, use zero bytes to represent
+  // a period of silence.
+  num_packets = std::max(1, num_packets);
+
+  // Ensure that the entire range of FramePacketIds can be represented.
+  return num_packets <= int{kMaxAllowedFramePacketId} ? num_packets : -1;
+}
+
+int RtpPacketizer::WriteHeader(const EncryptedFrame& frame,
+                               FramePacketId packet_id,
+                               int num_packets,
+                               int num_protected_packets,
+                               uint16_t payload_size_xor,
+                               ByteBuffer buffer) {
+  // Compute the number of bytes of header. Note that the optional Adaptive
+  // Latency information is only added to the first packet (and to the parity
+  // packet protecting it).
+  int header_size = kBaseRtpHeaderSize;
   const bool include_adaptive_latency_change =
       (packet_id == 0 &&
        frame.new_playout_delay > std::chrono::milliseconds(0));
   if (include_adaptive_latency_change) {
     OSP_CHECK_LE(frame.new_playout_delay.count(),
                  int{std::numeric_limits<uint16_t>::max()});
-    packet_size += kAdaptiveLatencyHeaderSize;
+    header_size += kAdaptiveLatencyHeaderSize;
   }
-  int data_chunk_size = max_payload_size();
-  const int data_chunk_start = data_chunk_size * int{packet_id};
-  if (is_last_packet) {
-    data_chunk_size = static_cast<int>(frame.data.size()) - data_chunk_start;
+  const bool include_fec = num_protected_packets > 0;
+  if (include_fec) {
+    header_size += kFecHeaderSize;
   }
-  packet_size += data_chunk_size;
-  OSP_CHECK_LE(packet_size, max_packet_size_);
-  const ByteBuffer packet(buffer.data(), packet_size);
+  OSP_CHECK_GE(static_cast<int>(buffer.size()), header_size);
 
   // RTP Header.
   AppendField<uint8_t>(kRtpRequiredFirstByte, buffer);
+  const bool is_last_packet =
+      !include_fec && int{packet_id} == (num_packets - 1);
   AppendField<uint8_t>(
       (is_last_packet ? kRtpMarkerBitMask : 0) | payload_type_7bits_, buffer);
   AppendField<uint16_t>(sequence_number_++, buffer);
@@ -93,7 +189,7 @@ ByteBuffer RtpPacketizer::GeneratePacket(const EncryptedFrame& frame,
            ? kRtpKeyFrameBitMask
            : 0) |
           kRtpHasReferenceFrameIdBitMask |
-          (include_adaptive_latency_change ? 1 : 0),
+          ((include_adaptive_latency_change ? 1 : 0) + (include_fec ? 1 : 0)),
       buffer);
   AppendField<uint8_t>(frame.frame_id.lower_8_bits(), buffer);
   AppendField<uint16_t>(packet_id, buffer);
@@ -109,25 +205,17 @@ ByteBuffer RtpPacketizer::GeneratePacket(const EncryptedFrame& frame,
     AppendField<uint16_t>(frame.new_playout_delay.count(), buffer);
   }
 
-  // Copy the encrypted payload data into the packet.
-  auto data_chunk = frame.data.subspan(data_chunk_start, data_chunk_size);
-  std::copy(data_chunk.begin(), data_chunk.end(), buffer.data());
-
-  return packet;
-}
-
-int RtpPacketizer::ComputeNumberOfPackets(const EncryptedFrame& frame) const {
-  // The total number of packets is computed by assuming the payload will be
-  // split-up across as few packets as possible.
-  int num_packets = DividePositivesRoundingUp(
-      static_cast<int>(frame.data.size()), max_payload_size());
-  // Edge case: There must always be at least one packet, even when there are no
-  // payload bytes. Some audio codecs, for example, use zero bytes to represent
-  // a period of silence.
-  num_packets = std::max(1, num_packets);
+  // Extension of Cast Header for Forward Error Correction parity packets.
+  if (include_fec) {
+    AppendField<uint16_t>(
+        (kFecRtpExtensionType << kNumExtensionDataSizeFieldBits) |
+            (2 * sizeof(uint16_t)),
+        buffer);
+    AppendField<uint16_t>(num_protected_packets, buffer);
+    AppendField<uint16_t>(payload_size_xor, buffer);
+  }
 
-  // Ensure that the entire range of FramePacketIds can be represented.
-  return num_packets <= int{kMaxAllowedFramePacketId} ? num_packets : -1;
+  return header_size;
 }
 
 }  // namespace openscreen::cast
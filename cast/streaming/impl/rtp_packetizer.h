@@ -10,6 +10,7 @@
 #include "cast/streaming/impl/frame_crypto.h"
 #include "cast/streaming/impl/rtp_defines.h"
 #include "cast/streaming/ssrc.h"
+#include "platform/api/udp_socket.h"
 #include "platform/base/span.h"
 
 namespace openscreen::cast {
@@ -25,9 +26,14 @@ class RtpPacketizer {
   // The `max_packet_size` argument depends on the optimal over-the-wire size of
   // packets for the network medium being used. See discussion in rtp_defines.h
   // for further info.
+  //
+  // If `fec_group_size` is positive, room is reserved in every packet so that
+  // a Forward Error Correction parity packet can be generated for every group
+  // of up to `fec_group_size` data packets (see GenerateParityPacket()).
   RtpPacketizer(RtpPayloadType payload_type,
                 Ssrc sender_ssrc,
-                int max_packet_size);
+                int max_packet_size,
+                int fec_group_size = 0);
 
   ~RtpPacketizer();
 
@@ -41,6 +47,28 @@ class RtpPacketizer {
                             FramePacketId packet_id,
                             ByteBuffer buffer);
 
+  // Like GeneratePacket(), but only wire-formats the packet header into
+  // `buffer`, which must be at least kMaxRtpHeaderSize bytes. The payload is
+  // not copied: It is returned as a view into `frame.data`, to be sent after
+  // the header (e.g., with UdpSocket::SendGatheredMessages()).
+  UdpSocket::GatheredMessage GeneratePacketHeader(const EncryptedFrame& frame,
+                                                  FramePacketId packet_id,
+                                                  ByteBuffer buffer);
+
+  // Wire-format the Forward Error Correction parity packet protecting the
+  // `num_packets` data packets of `frame` starting at `first_packet_id`. Like
+  // GeneratePacket(), this returns the subspan of `buffer` that contains the
+  // packet, and `buffer` must be at least `max_packet_size` bytes. See
+  // rtp_defines.h for the parity packet format.
+  ByteBuffer GenerateParityPacket(const EncryptedFrame& frame,
+                                  FramePacketId first_packet_id,
+                                  int num_packets,
+                                  ByteBuffer buffer);
+
+  // Returns the number of data packets in each FEC group of a frame, or zero
+  // if FEC is disabled. The last group of a frame may be smaller.
+  int fec_group_size() const { return fec_group_size_; }
+
   // Given `frame`, compute the total number of packets over which the whole
   // frame will be split-up. Returns -1 if the frame is too large and cannot be
   // packetized.
@@ -54,21 +82,36 @@ class RtpPacketizer {
   static constexpr int kAdaptiveLatencyHeaderSize = 4;
   static constexpr int kMaxRtpHeaderSize =
       kBaseRtpHeaderSize + kAdaptiveLatencyHeaderSize;
+  static constexpr int kFecHeaderSize = 6;
 
  private:
   int max_payload_size() const {
     // Start with the configured max packet size, then subtract reserved space
     // for packet header fields. The rest can be allocated to the payload.
-    return max_packet_size_ - kMaxRtpHeaderSize;
+    // Parity packets carry as much payload as the data packets, and so also
+    // reserve space for the FEC header.
+    return max_packet_size_ - kMaxRtpHeaderSize -
+           (fec_group_size_ > 0 ? kFecHeaderSize : 0);
   }
 
+  // Wire-formats the RTP and Cast headers of a packet of `frame` into
+  // `buffer`, and returns the header size. The FEC header is only included, for
+  // parity packets, if `num_protected_packets` is positive.
+  int WriteHeader(const EncryptedFrame& frame,
+                  FramePacketId packet_id,
+                  int num_packets,
+                  int num_protected_packets,
+                  uint16_t payload_size_xor,
+                  ByteBuffer buffer);
+
   // The validated ctor RtpPayloadType arg, in wire-format form.
   const uint8_t payload_type_7bits_;
 
   const Ssrc sender_ssrc_;
   const int max_packet_size_;
+  const int fec_group_size_;
 
-  // Incremented each time GeneratePacket() is called. Every packet, even those
+  // Incremented each time a packet is generated. Every packet, even those
   // re-transmitted, must have different sequence numbers (within wrap-around
   // concerns) per the RTP spec.
   uint16_t sequence_number_;
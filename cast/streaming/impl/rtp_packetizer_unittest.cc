@@ -4,9 +4,11 @@
 
 #include "cast/streaming/impl/rtp_packetizer.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "cast/streaming/impl/frame_crypto.h"
 #include "cast/streaming/impl/rtp_defines.h"
@@ -42,7 +44,7 @@ class RtpPacketizerTest : public testing::Test {
   EncryptedFrame CreateFrame(FrameId frame_id,
                              bool is_key_frame,
                              milliseconds new_playout_delay,
-                             int payload_size) const {
+                             int payload_size) {
     EncodedFrame frame;
     frame.dependency = is_key_frame ? EncodedFrame::Dependency::kKeyFrame
                                     : EncodedFrame::Dependency::kDependent;
@@ -129,7 +131,7 @@ class RtpPacketizerTest : public testing::Test {
   // The RtpPacketizer instance under test, plus some surrounding dependencies
   // to generate its input and examine its output.
   const Ssrc ssrc_{GenerateSsrc(true)};
-  const FrameCrypto crypto_{GenerateRandomBytes16(), GenerateRandomBytes16()};
+  FrameCrypto crypto_{GenerateRandomBytes16(), GenerateRandomBytes16()};
   RtpPacketizer packetizer_{kPayloadType, ssrc_,
                             kMaxRtpPacketSizeForIpv4UdpOnEthernet};
   RtpPacketParser parser_{ssrc_};
@@ -206,5 +208,104 @@ TEST_F(RtpPacketizerTest, GeneratesPacketForRetransmission) {
   }
 }
 
+// Tests that generating just the packet headers, leaving the payloads in the
+// frame, results in the same packets as GeneratePacket() does.
+TEST_F(RtpPacketizerTest, GeneratesHeadersWithoutCopyingPayload) {
+  const EncryptedFrame frame =
+      CreateFrame(FrameId::first() + 7, true, milliseconds(100), 5000);
+  const int num_packets = packetizer()->ComputeNumberOfPackets(frame);
+  ASSERT_EQ(4, num_packets);
+
+  // A second packetizer generates the same packets with copies, for
+  // comparison. Only the random starting sequence numbers differ.
+  RtpPacketizer copying_packetizer(kPayloadType, GenerateSsrc(true),
+                                   kMaxRtpPacketSizeForIpv4UdpOnEthernet);
+  constexpr int kSequenceNumberOffset = 2;
+  constexpr int kSsrcOffset = 8;
+  constexpr int kSsrcSize = 4;
+
+  for (int i = 0; i < num_packets; ++i) {
+    SCOPED_TRACE(testing::Message() << "packet_id=" << i);
+    const FramePacketId packet_id = static_cast<FramePacketId>(i);
+    uint8_t header_buffer[RtpPacketizer::kMaxRtpHeaderSize];
+    const UdpSocket::GatheredMessage parts =
+        packetizer()->GeneratePacketHeader(frame, packet_id, header_buffer);
+    ASSERT_TRUE(IsSubspan(parts.header, header_buffer));
+    ASSERT_TRUE(IsSubspan(parts.payload, frame.data));
+
+    uint8_t scratch[kMaxRtpPacketSizeForIpv4UdpOnEthernet];
+    const ByteBuffer packet =
+        copying_packetizer.GeneratePacket(frame, packet_id, scratch);
+    ASSERT_EQ(packet.size(), parts.size());
+
+    std::vector<uint8_t> gathered(parts.header.begin(), parts.header.end());
+    gathered.insert(gathered.end(), parts.payload.begin(), parts.payload.end());
+    std::vector<uint8_t> expected(packet.begin(), packet.end());
+    for (std::vector<uint8_t>* bytes : {&gathered, &expected}) {
+      std::fill_n(bytes->begin() + kSequenceNumberOffset, sizeof(uint16_t), 0);
+      std::fill_n(bytes->begin() + kSsrcOffset, kSsrcSize, 0);
+    }
+    EXPECT_EQ(gathered, expected);
+  }
+}
+
+// Tests that parity packets carry the XOR of the payloads of the data packets
+// they protect, along with the metadata needed to recover any one of them.
+TEST_F(RtpPacketizerTest, GeneratesParityPackets) {
+  constexpr int kFecGroupSize = 3;
+  const Ssrc ssrc = GenerateSsrc(true);
+  RtpPacketizer fec_packetizer(kPayloadType, ssrc,
+                               kMaxRtpPacketSizeForIpv4UdpOnEthernet,
+                               kFecGroupSize);
+  RtpPacketParser parser(ssrc);
+  const EncryptedFrame frame =
+      CreateFrame(FrameId::first() + 3, true, milliseconds(250), 6000);
+  const int num_packets = fec_packetizer.ComputeNumberOfPackets(frame);
+  ASSERT_EQ(5, num_packets);
+
+  std::vector<std::vector<uint8_t>> payloads;
+  for (int i = 0; i < num_packets; ++i) {
+    uint8_t scratch[kMaxRtpPacketSizeForIpv4UdpOnEthernet];
+    const auto result = parser.Parse(fec_packetizer.GeneratePacket(
+        frame, static_cast<FramePacketId>(i), scratch));
+    ASSERT_TRUE(result);
+    EXPECT_FALSE(result->fec_parity);
+    payloads.emplace_back(result->payload.begin(), result->payload.end());
+  }
+
+  for (int first = 0; first < num_packets; first += kFecGroupSize) {
+    SCOPED_TRACE(testing::Message() << "first_packet_id=" << first);
+    const int group_size = std::min(kFecGroupSize, num_packets - first);
+    std::vector<uint8_t> expected_parity(payloads[first].size());
+    uint16_t expected_size_xor = 0;
+    for (int i = first; i < first + group_size; ++i) {
+      for (size_t j = 0; j < payloads[i].size(); ++j) {
+        expected_parity[j] ^= payloads[i][j];
+      }
+      expected_size_xor ^= static_cast<uint16_t>(payloads[i].size());
+    }
+
+    uint8_t scratch[kMaxRtpPacketSizeForIpv4UdpOnEthernet];
+    const ByteBuffer packet = fec_packetizer.GenerateParityPacket(
+        frame, static_cast<FramePacketId>(first), group_size, scratch);
+    ASSERT_TRUE(IsSubspan(packet, scratch));
+    const auto result = parser.Parse(packet);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(frame.frame_id, result->frame_id);
+    EXPECT_EQ(static_cast<FramePacketId>(first), result->packet_id);
+    EXPECT_EQ(static_cast<FramePacketId>(num_packets - 1),
+              result->max_packet_id);
+    EXPECT_TRUE(result->is_key_frame);
+    // Like packet 0, the parity packet protecting it carries the playout delay
+    // change.
+    EXPECT_EQ(first == 0 ? milliseconds(250) : milliseconds(0),
+              result->new_playout_delay);
+    ASSERT_TRUE(result->fec_parity);
+    EXPECT_EQ(group_size, result->fec_parity->num_protected_packets);
+    EXPECT_EQ(expected_size_xor, result->fec_parity->payload_size_xor);
+    EXPECT_THAT(result->payload, ElementsAreArray(expected_parity));
+  }
+}
+
 }  // namespace
 }  // namespace openscreen::cast
@@ -0,0 +1,241 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/public/sender_engine.h"
+
+#include <stdint.h>
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "cast/streaming/impl/rtp_defines.h"
+#include "cast/streaming/impl/rtp_packet_parser.h"
+#include "cast/streaming/public/encoded_frame.h"
+#include "cast/streaming/public/frame_id.h"
+#include "cast/streaming/public/session_config.h"
+#include "cast/streaming/rtp_time.h"
+#include "cast/streaming/sender_packet_router.h"
+#include "cast/streaming/testing/mock_environment.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/base/ip_address.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/chrono_helpers.h"
+
+namespace openscreen::cast {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+using testing::NiceMock;
+
+using SenderId = SenderEngine::SenderId;
+
+constexpr Ssrc kSenderSsrc = 1;
+constexpr Ssrc kReceiverSsrc = 2;
+constexpr int kRtpTimebase = 90000;
+constexpr int kRtpTicksPerFrame = kRtpTimebase / 30;
+constexpr milliseconds kTargetPlayoutDelay(400);
+constexpr auto kAesKey =
+    std::array<uint8_t, 16>{{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                             0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}};
+constexpr auto kCastIvMask =
+    std::array<uint8_t, 16>{{0xf0, 0xe0, 0xd0, 0xc0, 0xb0, 0xa0, 0x90, 0x80,
+                             0x70, 0x60, 0x50, 0x40, 0x30, 0x20, 0x10, 0x00}};
+
+constexpr SenderEngine::ChannelId kRoomA = 1;
+constexpr SenderEngine::ChannelId kRoomB = 2;
+
+IPEndpoint MakeReceiverEndpoint(uint8_t host) {
+  return IPEndpoint{IPAddress(192, 0, 2, host), 2344};
+}
+
+// Records the frames of the RTP packets sent to each destination.
+class RecordingEnvironment : public MockEnvironment {
+ public:
+  using MockEnvironment::MockEnvironment;
+
+  void SendPacketsTo(const IPEndpoint& destination,
+                     std::span<const UdpSocket::GatheredMessage> packets,
+                     std::span<const PacketMetadata> metadata) override {
+    for (const UdpSocket::GatheredMessage& packet : packets) {
+      std::vector<uint8_t> buffer(packet.header.begin(), packet.header.end());
+      buffer.insert(buffer.end(), packet.payload.begin(), packet.payload.end());
+      const std::optional<RtpPacketParser::ParseResult> part =
+          parser_.Parse(buffer);
+      if (part) {
+        frames_sent[destination].insert(part->frame_id);
+      }
+    }
+  }
+
+  // The IDs of the frames sent to each destination.
+  std::map<IPEndpoint, std::set<FrameId>> frames_sent;
+
+ private:
+  RtpPacketParser parser_{kSenderSsrc};
+};
+
+class SenderEngineTest : public testing::Test {
+ public:
+  SenderEngineTest() : clock_(Clock::now()) {
+    std::vector<std::unique_ptr<Environment>> environments;
+    for (int i = 0; i < 2; ++i) {
+      shard_task_runners_.push_back(std::make_unique<FakeTaskRunner>(clock_));
+      auto environment = std::make_unique<NiceMock<RecordingEnvironment>>(
+          &FakeClock::now, *shard_task_runners_.back());
+      shard_environments_.push_back(environment.get());
+      environments.push_back(std::move(environment));
+    }
+    engine_ = std::make_unique<SenderEngine>(
+        std::move(environments), SenderPacketRouter::kDefaultMaxBurstBitrate);
+  }
+
+  SenderId AddSender(SenderEngine::ChannelId channel,
+                     const IPEndpoint& remote_endpoint) {
+    SessionConfig config(kSenderSsrc, kReceiverSsrc, kRtpTimebase, 1,
+                         kTargetPlayoutDelay, kAesKey, kCastIvMask);
+    // No Receiver acknowledges any frames in these tests.
+    config.max_in_flight_media_duration = kTargetPlayoutDelay;
+    return engine_->AddSender(channel, remote_endpoint, config,
+                              RtpPayloadType::kVideoVp8);
+  }
+
+  // Publishes a frame with the given `frame_id` to `channel`, that is a key
+  // frame or depends on the frame before it.
+  void PublishFrame(SenderEngine::ChannelId channel,
+                    FrameId frame_id,
+                    bool is_key_frame) {
+    const int64_t frame_number = frame_id - FrameId::first();
+    auto frame = std::make_shared<EncodedFrame>(
+        is_key_frame ? EncodedFrame::Dependency::kKeyFrame
+                     : EncodedFrame::Dependency::kDependent,
+        frame_id, is_key_frame ? frame_id : frame_id - 1,
+        RtpTimeTicks() + RtpTimeDelta::FromTicks(frame_number *
+                                                 kRtpTicksPerFrame),
+        FakeClock::now(), milliseconds(0), payload_);
+    engine_->PublishFrame(channel, std::move(frame));
+    clock_.Advance(milliseconds(33));
+  }
+
+  // Returns the frames sent to `remote_endpoint`, by any shard.
+  std::set<FrameId> GetFramesSentTo(const IPEndpoint& remote_endpoint) {
+    std::set<FrameId> frames;
+    for (RecordingEnvironment* environment : shard_environments_) {
+      const auto it = environment->frames_sent.find(remote_endpoint);
+      if (it != environment->frames_sent.end()) {
+        frames.insert(it->second.begin(), it->second.end());
+      }
+    }
+    return frames;
+  }
+
+ protected:
+  FakeClock clock_;
+  std::vector<std::unique_ptr<FakeTaskRunner>> shard_task_runners_;
+  std::vector<RecordingEnvironment*> shard_environments_;
+  const std::vector<uint8_t> payload_ = std::vector<uint8_t>(3000, 0xab);
+  std::unique_ptr<SenderEngine> engine_;
+};
+
+TEST_F(SenderEngineTest, PinsSendersToLeastLoadedShard) {
+  ASSERT_EQ(engine_->num_shards(), 2u);
+  const SenderId first = AddSender(kRoomA, MakeReceiverEndpoint(1));
+  const SenderId second = AddSender(kRoomA, MakeReceiverEndpoint(2));
+  const SenderId third = AddSender(kRoomB, MakeReceiverEndpoint(3));
+  EXPECT_EQ(engine_->GetShardIndex(first), 0u);
+  EXPECT_EQ(engine_->GetShardIndex(second), 1u);
+  EXPECT_EQ(engine_->GetShardIndex(third), 0u);
+
+  engine_->RemoveSender(first);
+  engine_->RemoveSender(third);
+  const SenderId fourth = AddSender(kRoomB, MakeReceiverEndpoint(4));
+  EXPECT_EQ(engine_->GetShardIndex(fourth), 0u);
+}
+
+// Tests that each frame is sent to every Receiver of its channel, through the
+// socket of the shard that the Receiver's Sender is pinned to.
+TEST_F(SenderEngineTest, FansOutFramesToTheSendersOfTheirChannel) {
+  const IPEndpoint kReceivers[] = {MakeReceiverEndpoint(1),
+                                   MakeReceiverEndpoint(2),
+                                   MakeReceiverEndpoint(3)};
+  const IPEndpoint kRoomBReceiver = MakeReceiverEndpoint(4);
+  std::vector<SenderId> senders;
+  for (const IPEndpoint& receiver : kReceivers) {
+    senders.push_back(AddSender(kRoomA, receiver));
+  }
+  AddSender(kRoomB, kRoomBReceiver);
+
+  PublishFrame(kRoomA, FrameId::first(), true);
+  PublishFrame(kRoomA, FrameId::first() + 1, false);
+
+  for (size_t i = 0; i < senders.size(); ++i) {
+    EXPECT_THAT(GetFramesSentTo(kReceivers[i]),
+                ElementsAre(FrameId::first(), FrameId::first() + 1));
+    // Only the Sender's own shard sent it anything.
+    const size_t shard = engine_->GetShardIndex(senders[i]);
+    EXPECT_TRUE(shard_environments_[shard]->frames_sent.count(kReceivers[i]));
+    EXPECT_FALSE(
+        shard_environments_[1 - shard]->frames_sent.count(kReceivers[i]));
+  }
+  EXPECT_THAT(GetFramesSentTo(kRoomBReceiver), IsEmpty());
+}
+
+// Tests that a Sender added part-way through a stream waits for the next key
+// frame, and then numbers the frames it sends from the start.
+TEST_F(SenderEngineTest, LateSenderJoinsAtNextKeyFrame) {
+  const IPEndpoint early_receiver = MakeReceiverEndpoint(1);
+  const IPEndpoint late_receiver = MakeReceiverEndpoint(2);
+  EXPECT_FALSE(engine_->NeedsKeyFrame(kRoomA));
+  AddSender(kRoomA, early_receiver);
+  EXPECT_TRUE(engine_->NeedsKeyFrame(kRoomA));
+  PublishFrame(kRoomA, FrameId::first(), true);
+  EXPECT_FALSE(engine_->NeedsKeyFrame(kRoomA));
+  PublishFrame(kRoomA, FrameId::first() + 1, false);
+
+  AddSender(kRoomA, late_receiver);
+  EXPECT_TRUE(engine_->NeedsKeyFrame(kRoomA));
+  PublishFrame(kRoomA, FrameId::first() + 2, false);
+  EXPECT_TRUE(engine_->NeedsKeyFrame(kRoomA));
+  EXPECT_THAT(GetFramesSentTo(late_receiver), IsEmpty());
+
+  PublishFrame(kRoomA, FrameId::first() + 3, true);
+  EXPECT_FALSE(engine_->NeedsKeyFrame(kRoomA));
+  PublishFrame(kRoomA, FrameId::first() + 4, false);
+
+  EXPECT_THAT(GetFramesSentTo(early_receiver),
+              ElementsAre(FrameId::first(), FrameId::first() + 1,
+                          FrameId::first() + 2, FrameId::first() + 3,
+                          FrameId::first() + 4));
+  EXPECT_THAT(GetFramesSentTo(late_receiver),
+              ElementsAre(FrameId::first(), FrameId::first() + 1));
+}
+
+// Tests that the shards only reference a published frame until they have
+// enqueued it, since each Sender keeps its own encrypted copy.
+TEST_F(SenderEngineTest, ReleasesPublishedFramesOnceEnqueued) {
+  AddSender(kRoomA, MakeReceiverEndpoint(1));
+  AddSender(kRoomA, MakeReceiverEndpoint(2));
+  auto frame = std::make_shared<EncodedFrame>(
+      EncodedFrame::Dependency::kKeyFrame, FrameId::first(), FrameId::first(),
+      RtpTimeTicks(), FakeClock::now(), milliseconds(0), payload_);
+  const std::weak_ptr<EncodedFrame> weak_frame = frame;
+  engine_->PublishFrame(kRoomA, std::move(frame));
+  EXPECT_FALSE(weak_frame.expired());
+  for (const std::unique_ptr<FakeTaskRunner>& task_runner :
+       shard_task_runners_) {
+    task_runner->RunTasksUntilIdle();
+  }
+  EXPECT_TRUE(weak_frame.expired());
+}
+
+}  // namespace
+}  // namespace openscreen::cast
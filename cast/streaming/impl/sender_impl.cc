@@ -36,9 +36,11 @@ using clock_operators::operator<<;
 SenderImpl::SenderImpl(Environment& environment,
                        SenderPacketRouter& packet_router,
                        SessionConfig config,
-                       RtpPayloadType rtp_payload_type)
+                       RtpPayloadType rtp_payload_type,
+                       const IPEndpoint& remote_endpoint)
     : config_(config),
       packet_router_(packet_router),
+      remote_endpoint_(remote_endpoint),
       rtcp_session_(config.sender_ssrc,
                     config.receiver_ssrc,
                     environment.now()),
@@ -46,7 +48,8 @@ SenderImpl::SenderImpl(Environment& environment,
       sender_report_builder_(rtcp_session_),
       rtp_packetizer_(rtp_payload_type,
                       config.sender_ssrc,
-                      packet_router_->max_packet_size()),
+                      packet_router_->max_packet_size(),
+                      config.fec_group_size),
       rtp_timebase_(config.rtp_timebase),
       crypto_(config.aes_secret_key, config.aes_iv_mask),
       statistics_dispatcher_(environment),
@@ -58,11 +61,13 @@ SenderImpl::SenderImpl(Environment& environment,
 
   pending_sender_report_.reference_time = SenderPacketRouter::kNever;
 
-  packet_router_->OnSenderCreated(rtcp_session_.receiver_ssrc(), this);
+  packet_router_->OnSenderCreated(remote_endpoint_,
+                                  rtcp_session_.receiver_ssrc(), this);
 }
 
 SenderImpl::~SenderImpl() {
-  packet_router_->OnSenderDestroyed(rtcp_session_.receiver_ssrc());
+  packet_router_->OnSenderDestroyed(remote_endpoint_,
+                                    rtcp_session_.receiver_ssrc());
 }
 
 void SenderImpl::SetObserver(openscreen::cast::Sender::Observer* observer) {
@@ -183,14 +188,18 @@ openscreen::cast::Sender::EnqueueFrameResult SenderImpl::EnqueueFrame(
   // Encrypt the frame and initialize the slot tracking its sending.
   PendingFrameSlot& slot = get_slot_for(frame.frame_id);
   OSP_CHECK(!slot.frame);
-  slot.frame = crypto_.Encrypt(frame);
+  slot.frame = crypto_.Encrypt(frame, std::move(slot.recycled_buffer));
   const int packet_count = rtp_packetizer_.ComputeNumberOfPackets(*slot.frame);
   if (packet_count <= 0) {
-    slot.frame.reset();
+    slot.ReleaseFrame();
     return PAYLOAD_TOO_LARGE;
   }
   slot.send_flags.Resize(packet_count, BitVector::SET);
+  slot.send_flags_search_start = 0;
   slot.packet_sent_times.assign(packet_count, SenderPacketRouter::kNever);
+  slot.num_unsent_packets = packet_count;
+  slot.latest_packet_sent_time = SenderPacketRouter::kNever;
+  FlagSlotForSend(slot);
 
   // Officially record the "enqueue."
   ++num_frames_in_flight_;
@@ -230,11 +239,13 @@ openscreen::cast::Sender::EnqueueFrameResult SenderImpl::EnqueueFrame(
   // Sender Report from this Sender. Thus, this Sender really needs to send
   // that, right now!
   if (round_trip_time_ == Clock::duration::zero()) {
-    packet_router_->RequestRtcpSend(rtcp_session_.receiver_ssrc());
+    packet_router_->RequestRtcpSend(remote_endpoint_,
+                                    rtcp_session_.receiver_ssrc());
   }
 
   // Re-activate RTP sending if it was suspended.
-  packet_router_->RequestRtpSend(rtcp_session_.receiver_ssrc());
+  packet_router_->RequestRtpSend(remote_endpoint_,
+                                 rtcp_session_.receiver_ssrc());
   statistics_dispatcher_.DispatchEnqueueEvents(config_.stream_type, frame);
 
   return OK;
@@ -265,7 +276,8 @@ void SenderImpl::OnReceivedRtcpPacket(Clock::time_point arrival_time,
   // This call to Parse() invoke zero or more of the OnReceiverXYZ() methods in
   // the current call stack:
   if (rtcp_parser_.Parse(packet, last_enqueued_frame_id_)) {
-    packet_router_->OnRtcpReceived(arrival_time, round_trip_time_);
+    packet_router_->congestion_controller().OnRtcpReceived(arrival_time,
+                                                           round_trip_time_);
   }
 }
 
@@ -293,6 +305,31 @@ ByteBuffer SenderImpl::GetRtcpPacketForImmediateSend(
 
 ByteBuffer SenderImpl::GetRtpPacketForImmediateSend(Clock::time_point send_time,
                                                     ByteBuffer buffer) {
+  const UdpSocket::GatheredMessage packet =
+      GetRtpPacketPartsForImmediateSend(send_time, buffer);
+  std::copy(packet.payload.begin(), packet.payload.end(),
+            buffer.data() + packet.header.size());
+  return buffer.first(packet.size());
+}
+
+UdpSocket::GatheredMessage SenderImpl::GetRtpPacketPartsForImmediateSend(
+    Clock::time_point send_time,
+    ByteBuffer buffer) {
+  // A parity packet is sent right after the last packet of the group it
+  // protects, unless the frame has been canceled since.
+  if (pending_parity_) {
+    const PendingParity parity = *std::exchange(pending_parity_, std::nullopt);
+    PendingFrameSlot& slot = get_slot_for(parity.frame_id);
+    if (slot.is_active_for_frame(parity.frame_id)) {
+      const ByteBuffer packet = rtp_packetizer_.GenerateParityPacket(
+          *slot.frame, parity.first_packet_id, parity.num_packets, buffer);
+      ++pending_sender_report_.send_packet_count;
+      pending_sender_report_.send_octet_count +=
+          static_cast<int>(packet.size()) - RtpPacketizer::kBaseRtpHeaderSize;
+      return {packet, ByteView()};
+    }
+  }
+
   ChosenPacket chosen = ChooseNextRtpPacketNeedingSend();
 
   // If no packets need sending (i.e., all packets have been sent at least once
@@ -308,7 +345,7 @@ ByteBuffer SenderImpl::GetRtpPacketForImmediateSend(Clock::time_point send_time,
       // Nothing to send, so return "empty" signal to the packet router. The
       // packet router will suspend RTP sending until this Sender explicitly
       // resumes it.
-      return buffer.subspan(0, 0);
+      return {};
     }
     chosen = kickstart;
     OSP_CHECK(chosen);
@@ -328,10 +365,32 @@ ByteBuffer SenderImpl::GetRtpPacketForImmediateSend(Clock::time_point send_time,
                  << ", packet_id=" << chosen.packet_id;
   }
 
-  const ByteBuffer result = rtp_packetizer_.GeneratePacket(
-      *chosen.slot->frame, chosen.packet_id, buffer);
+  // The payload is left in the encrypted frame, which is not released before
+  // the end of the burst.
+  const UdpSocket::GatheredMessage result =
+      rtp_packetizer_.GeneratePacketHeader(*chosen.slot->frame,
+                                           chosen.packet_id, buffer);
   chosen.slot->send_flags.Clear(chosen.packet_id);
   chosen.slot->packet_sent_times[chosen.packet_id] = send_time;
+  chosen.slot->latest_packet_sent_time = send_time;
+  if (!is_retransmission) {
+    --chosen.slot->num_unsent_packets;
+  }
+
+  // Packets are first sent in order, and so the parity packet for a group is
+  // due once its last packet has been sent for the first time.
+  const int fec_group_size = rtp_packetizer_.fec_group_size();
+  if (fec_group_size > 0 && !is_retransmission) {
+    const int packet_id = chosen.packet_id;
+    const int group_start = packet_id - packet_id % fec_group_size;
+    const int num_packets_in_group = packet_id - group_start + 1;
+    if (num_packets_in_group == fec_group_size ||
+        packet_id + 1 == static_cast<int>(chosen.slot->send_flags.size())) {
+      pending_parity_ = PendingParity{chosen.slot->frame->frame_id,
+                                      static_cast<FramePacketId>(group_start),
+                                      num_packets_in_group};
+    }
+  }
 
   ++pending_sender_report_.send_packet_count;
   // According to RFC3550, the octet count does not include the RTP header. The
@@ -348,12 +407,36 @@ ByteBuffer SenderImpl::GetRtpPacketForImmediateSend(Clock::time_point send_time,
 }
 
 Clock::time_point SenderImpl::GetRtpResumeTime() {
-  if (ChooseNextRtpPacketNeedingSend()) {
+  if (pending_parity_ || ChooseNextRtpPacketNeedingSend()) {
     return Alarm::kImmediately;
   }
   return ChooseKickstartPacket().when;
 }
 
+Clock::time_point SenderImpl::GetNextRtpPacketDeadline() {
+  // The next packet is chosen the same way GetRtpPacketPartsForImmediateSend()
+  // would choose it.
+  const PendingFrameSlot* slot = nullptr;
+  if (pending_parity_) {
+    slot = &get_slot_for(pending_parity_->frame_id);
+    if (!slot->is_active_for_frame(pending_parity_->frame_id)) {
+      slot = nullptr;
+    }
+  }
+  if (!slot) {
+    if (const ChosenPacket chosen = ChooseNextRtpPacketNeedingSend()) {
+      slot = chosen.slot;
+    } else if (const ChosenPacketAndWhen kickstart = ChooseKickstartPacket()) {
+      slot = kickstart.slot;
+    }
+  }
+  if (!slot) {
+    return SenderPacketRouter::kNever;
+  }
+  // The frame is due at the Receiver one playout delay after it was captured.
+  return slot->frame->reference_time + target_playout_delay_;
+}
+
 RtpTimeTicks SenderImpl::GetLastRtpTimestamp() const {
   return {};
 }
@@ -436,7 +519,7 @@ void SenderImpl::OnReceiverReport(const RtcpReportBlock& receiver_report) {
 }
 
 void SenderImpl::OnCastReceiverFrameLogMessages(
-    std::vector<RtcpReceiverFrameLogMessage> messages) {
+    const std::vector<RtcpReceiverFrameLogMessage>& messages) {
   statistics_dispatcher_.DispatchFrameLogMessages(config_.stream_type,
                                                   messages);
 }
@@ -521,12 +604,20 @@ void SenderImpl::OnReceiverCheckpoint(FrameId frame_id,
 
   if (playout_delay != target_playout_delay_ &&
       frame_id >= playout_delay_change_at_frame_id_) {
-    OSP_LOG_WARN << "Sender's target playout delay (" << target_playout_delay_
-                 << ") disagrees with the Receiver's (" << playout_delay << ")";
+    if (config_.adaptive_playout_delay &&
+        playout_delay >= config_.adaptive_playout_delay->min &&
+        playout_delay <= config_.adaptive_playout_delay->max) {
+      // The Receiver adapted the target playout delay to the network.
+      target_playout_delay_ = playout_delay;
+    } else {
+      OSP_LOG_WARN << "Sender's target playout delay (" << target_playout_delay_
+                   << ") disagrees with the Receiver's (" << playout_delay
+                   << ")";
+    }
   }
 }
 
-void SenderImpl::OnReceiverHasFrames(std::vector<FrameId> acks) {
+void SenderImpl::OnReceiverHasFrames(const std::vector<FrameId>& acks) {
   OSP_DCHECK(!acks.empty() && AreElementsSortedAndUnique(acks));
   TRACE_DEFAULT_SCOPED1(TraceCategory::kSender, "frame_ids",
                         string_util::Join(acks));
@@ -555,7 +646,8 @@ void SenderImpl::OnReceiverHasFrames(std::vector<FrameId> acks) {
   DispatchCancellations();
 }
 
-void SenderImpl::OnReceiverIsMissingPackets(std::vector<PacketNack> nacks) {
+void SenderImpl::OnReceiverIsMissingPackets(
+    const std::vector<PacketNack>& nacks) {
   TRACE_DEFAULT_SCOPED1(TraceCategory::kSender, "number_of_packets",
                         std::to_string(nacks.size()));
   OSP_DCHECK(!nacks.empty() && AreElementsSortedAndUnique(nacks));
@@ -605,7 +697,8 @@ void SenderImpl::OnReceiverIsMissingPackets(std::vector<PacketNack> nacks) {
     const auto HandleIndividualNack = [&](FramePacketId packet_id) {
       if (slot->packet_sent_times[packet_id] <= too_recent_a_send_time) {
         slot->send_flags.Set(packet_id);
-        need_to_send = true;
+        slot->send_flags_search_start =
+            std::min<size_t>(slot->send_flags_search_start, packet_id);
         retransmitted_count++;
       } else {
         ignored_count++;
@@ -613,8 +706,17 @@ void SenderImpl::OnReceiverIsMissingPackets(std::vector<PacketNack> nacks) {
     };
     const FramePacketId range_end = slot->packet_sent_times.size();
     if (nack_it->packet_id == kAllPacketsLost) {
-      for (FramePacketId packet_id = 0; packet_id < range_end; ++packet_id) {
-        HandleIndividualNack(packet_id);
+      if (slot->num_unsent_packets == 0 &&
+          slot->latest_packet_sent_time <= too_recent_a_send_time) {
+        // Fast path: every packet was last sent long enough ago, so all of
+        // them are re-flagged a word at a time.
+        slot->send_flags.SetAll();
+        slot->send_flags_search_start = 0;
+        retransmitted_count = range_end;
+      } else {
+        for (FramePacketId packet_id = 0; packet_id < range_end; ++packet_id) {
+          HandleIndividualNack(packet_id);
+        }
       }
       ++nack_it;
     } else {
@@ -630,6 +732,10 @@ void SenderImpl::OnReceiverIsMissingPackets(std::vector<PacketNack> nacks) {
       }
     }
 
+    if (retransmitted_count > 0) {
+      FlagSlotForSend(*slot);
+      need_to_send = true;
+    }
     if (retransmitted_count > 0 || ignored_count > 0) {
       OSP_DLOG_INFO << "Frame " << frame_id
                     << " NACKed. Retransmitted packets: " << retransmitted_count
@@ -643,21 +749,34 @@ void SenderImpl::OnReceiverIsMissingPackets(std::vector<PacketNack> nacks) {
   }
 
   if (need_to_send) {
-    packet_router_->RequestRtpSend(rtcp_session_.receiver_ssrc());
+    packet_router_->RequestRtpSend(remote_endpoint_,
+                                   rtcp_session_.receiver_ssrc());
   }
 }
 
 SenderImpl::ChosenPacket SenderImpl::ChooseNextRtpPacketNeedingSend() {
-  // Find the oldest packet needing to be sent (or re-sent).
-  for (FrameId frame_id = checkpoint_frame_id_ + 1;
-       frame_id <= last_enqueued_frame_id_; ++frame_id) {
-    PendingFrameSlot& slot = get_slot_for(frame_id);
-    if (!slot.is_active_for_frame(frame_id)) {
-      continue;  // Frame was canceled. None of its packets need to be sent.
-    }
-    const FramePacketId packet_id = slot.send_flags.FindFirstSet();
-    if (packet_id < slot.send_flags.size()) {
-      return {&slot, packet_id};
+  // Find the oldest packet needing to be sent (or re-sent). Only the slots in
+  // the ready-queue are visited, in FrameId order: that is, from the slot of
+  // the frame after the checkpoint to the end of `pending_frames_`, and then
+  // around from its start.
+  const size_t oldest_index = get_slot_index(checkpoint_frame_id_ + 1);
+  const std::pair<size_t, size_t> index_ranges[] = {
+      {oldest_index, pending_frames_.size()}, {0, oldest_index}};
+  for (const auto& [begin, end] : index_ranges) {
+    for (size_t index = slots_needing_send_.FindNextSet(begin); index < end;
+         index = slots_needing_send_.FindNextSet(index + 1)) {
+      // Every active slot holds a frame after the checkpoint. Canceled frames
+      // have no packets that need to be sent.
+      PendingFrameSlot& slot = pending_frames_[index];
+      if (slot.frame) {
+        const size_t packet_id =
+            slot.send_flags.FindNextSet(slot.send_flags_search_start);
+        slot.send_flags_search_start = packet_id;
+        if (packet_id < slot.send_flags.size()) {
+          return {&slot, static_cast<FramePacketId>(packet_id)};
+        }
+      }
+      slots_needing_send_.Clear(index);
     }
   }
 
@@ -719,11 +838,19 @@ void SenderImpl::CancelPendingFrame(FrameId frame_id, bool was_acked) {
   }
 
   if (was_acked) {
-    packet_router_->OnPayloadReceived(
-        slot.frame->data.size(), rtcp_packet_arrival_time_, round_trip_time_);
+    CongestionController& congestion_controller =
+        packet_router_->congestion_controller();
+    const int payload_bytes = static_cast<int>(slot.frame->data.size());
+    congestion_controller.OnPayloadReceived(
+        payload_bytes, rtcp_packet_arrival_time_, round_trip_time_);
+    if (slot.latest_packet_sent_time <= rtcp_packet_arrival_time_) {
+      congestion_controller.OnFrameDelivered(payload_bytes,
+                                             slot.latest_packet_sent_time,
+                                             rtcp_packet_arrival_time_);
+    }
   }
 
-  slot.frame.reset();
+  slot.ReleaseFrame();
   OSP_CHECK_GT(num_frames_in_flight_, 0);
   --num_frames_in_flight_;
   if (observer_) {
@@ -749,4 +876,9 @@ void SenderImpl::DispatchCancellations() {
 SenderImpl::PendingFrameSlot::PendingFrameSlot() = default;
 SenderImpl::PendingFrameSlot::~PendingFrameSlot() = default;
 
+void SenderImpl::PendingFrameSlot::ReleaseFrame() {
+  recycled_buffer = frame->ReleaseBuffer();
+  frame.reset();
+}
+
 }  // namespace openscreen::cast
@@ -26,6 +26,7 @@
 #include "cast/streaming/rtp_time.h"
 #include "cast/streaming/sender_packet_router.h"
 #include "platform/api/time.h"
+#include "platform/base/ip_address.h"
 #include "platform/base/span.h"
 #include "util/bit_vector.h"
 #include "util/raw_ptr.h"
@@ -48,10 +49,15 @@ class SenderImpl final : public Sender,
   // the overall end-to-end connection process that occurs before Cast Streaming
   // is started). The `rtp_payload_type` does not affect the behavior of this
   // Sender. It is simply passed along to a Receiver in the RTP packet stream.
+  //
+  // The Receiver is assumed to be at the `environment`'s remote endpoint,
+  // unless a `remote_endpoint` is given. The latter allows the `packet_router`
+  // to be shared by the Senders of many Receivers.
   SenderImpl(Environment& environment,
              SenderPacketRouter& packet_router,
              SessionConfig config,
-             RtpPayloadType rtp_payload_type);
+             RtpPayloadType rtp_payload_type,
+             const IPEndpoint& remote_endpoint = IPEndpoint{});
 
   ~SenderImpl() final;
 
@@ -91,15 +97,34 @@ class SenderImpl final : public Sender,
     // FramePacketId. A set bit means a packet needs to be sent (or re-sent).
     BitVector send_flags;
 
+    // No bit in `send_flags` before this position is set. This lets the next
+    // packet needing a send be found without rescanning the packets already
+    // sent.
+    size_t send_flags_search_start = 0;
+
+    // The number of packets that have not been sent even once, and the time
+    // the most-recently sent packet was sent. When no packets are unsent and
+    // that time is old enough, a whole-frame NACK re-flags every packet at
+    // once instead of checking `packet_sent_times` one by one.
+    int num_unsent_packets = 0;
+    Clock::time_point latest_packet_sent_time = SenderPacketRouter::kNever;
+
     // The time when each of the packets was last sent, or
     // `SenderPacketRouter::kNever` if the packet has not been sent yet.
     // Elements are indexed by FramePacketId. This is used to avoid
     // re-transmitting any given packet too frequently.
     std::vector<Clock::time_point> packet_sent_times;
 
+    // The payload buffer of the last frame sent from this slot, kept so that
+    // the next frame can be encrypted into it without allocating.
+    std::vector<uint8_t> recycled_buffer;
+
     PendingFrameSlot();
     ~PendingFrameSlot();
 
+    // Marks this slot as no longer in use, keeping the frame's buffer.
+    void ReleaseFrame();
+
     bool is_active_for_frame(FrameId frame_id) const {
       return frame && frame->frame_id == frame_id;
     }
@@ -119,6 +144,13 @@ class SenderImpl final : public Sender,
     Clock::time_point when = SenderPacketRouter::kNever;
   };
 
+  // Identifies the FEC parity packet protecting a group of packets of a frame.
+  struct PendingParity {
+    FrameId frame_id;
+    FramePacketId first_packet_id{};
+    int num_packets = 0;
+  };
+
   // SenderPacketRouter::Sender implementation.
   void OnReceivedRtcpPacket(Clock::time_point arrival_time,
                             ByteView packet) final;
@@ -126,7 +158,11 @@ class SenderImpl final : public Sender,
                                            ByteBuffer buffer) final;
   ByteBuffer GetRtpPacketForImmediateSend(Clock::time_point send_time,
                                           ByteBuffer buffer) final;
+  UdpSocket::GatheredMessage GetRtpPacketPartsForImmediateSend(
+      Clock::time_point send_time,
+      ByteBuffer buffer) final;
   Clock::time_point GetRtpResumeTime() final;
+  Clock::time_point GetNextRtpPacketDeadline() final;
   RtpTimeTicks GetLastRtpTimestamp() const final;
   StreamType GetStreamType() const final;
 
@@ -134,12 +170,12 @@ class SenderImpl final : public Sender,
   void OnReceiverReferenceTimeAdvanced(Clock::time_point reference_time) final;
   void OnReceiverReport(const RtcpReportBlock& receiver_report) final;
   void OnCastReceiverFrameLogMessages(
-      std::vector<RtcpReceiverFrameLogMessage> messages) final;
+      const std::vector<RtcpReceiverFrameLogMessage>& messages) final;
   void OnReceiverIndicatesPictureLoss() final;
   void OnReceiverCheckpoint(FrameId frame_id,
                             std::chrono::milliseconds playout_delay) final;
-  void OnReceiverHasFrames(std::vector<FrameId> acks) final;
-  void OnReceiverIsMissingPackets(std::vector<PacketNack> nacks) final;
+  void OnReceiverHasFrames(const std::vector<FrameId>& acks) final;
+  void OnReceiverIsMissingPackets(const std::vector<PacketNack>& nacks) final;
 
   // Helper to choose which packet to send, from those that have been flagged as
   // "need to send." Returns a "false" result if nothing needs to be sent.
@@ -168,19 +204,30 @@ class SenderImpl final : public Sender,
   // to notify the observer, if any, about cancellations.
   void DispatchCancellations();
 
-  // Inline helper to return the slot that would contain the tracking info for
-  // the given `frame_id`.
+  // Flags the given `slot` as having packets that need to be sent, after bits
+  // were set in its `send_flags`.
+  void FlagSlotForSend(const PendingFrameSlot& slot) {
+    slots_needing_send_.Set(&slot - pending_frames_.data());
+  }
+
+  // Inline helpers to return the slot that would contain the tracking info for
+  // the given `frame_id`, and its position in `pending_frames_`.
+  size_t get_slot_index(FrameId frame_id) const {
+    return (frame_id - FrameId::first()) % pending_frames_.size();
+  }
   const PendingFrameSlot& get_slot_for(FrameId frame_id) const {
-    return pending_frames_[(frame_id - FrameId::first()) %
-                           pending_frames_.size()];
+    return pending_frames_[get_slot_index(frame_id)];
   }
   PendingFrameSlot& get_slot_for(FrameId frame_id) {
-    return pending_frames_[(frame_id - FrameId::first()) %
-                           pending_frames_.size()];
+    return pending_frames_[get_slot_index(frame_id)];
   }
 
   const SessionConfig config_;
   const raw_ref<SenderPacketRouter> packet_router_;
+
+  // The Receiver's endpoint, or the zero IPEndpoint if the Receiver is at the
+  // Environment's remote endpoint.
+  const IPEndpoint remote_endpoint_;
   RtcpSession rtcp_session_;
   CompoundRtcpParser rtcp_parser_;
   SenderReportBuilder sender_report_builder_;
@@ -194,6 +241,12 @@ class SenderImpl final : public Sender,
   // access the correct slot for a given FrameId.
   std::array<PendingFrameSlot, kMaxUnackedFrames> pending_frames_ = {};
 
+  // The ready-queue of `pending_frames_`: a set bit means the slot at the same
+  // position may have packets that need to be sent. Bits are set whenever
+  // `send_flags` are, and cleared lazily by ChooseNextRtpPacketNeedingSend()
+  // once it finds nothing left to send in the slot.
+  BitVector slots_needing_send_{kMaxUnackedFrames, BitVector::CLEARED};
+
   // A count of the number of frames in-flight (i.e., the number of active
   // entries in `pending_frames_`).
   size_t num_frames_in_flight_ = 0;
@@ -227,6 +280,9 @@ class SenderImpl final : public Sender,
   // count stats.
   RtcpSenderReport pending_sender_report_;
 
+  // The FEC parity packet to send next, if any. Only used if FEC is enabled.
+  std::optional<PendingParity> pending_parity_;
+
   ClockNowFunctionPtr now_;
 
   // These are used to determine whether a key frame needs to be sent to the
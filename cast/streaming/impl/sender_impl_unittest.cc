@@ -45,6 +45,7 @@
 
 using testing::_;
 using testing::AtLeast;
+using testing::ElementsAre;
 using testing::InvokeWithoutArgs;
 using testing::Mock;
 using testing::NiceMock;
@@ -141,7 +142,7 @@ class SimulatedNetworkPipe {
     task_runner_->PostTaskWithDelay(
         [this, pkt = std::move(packet)]() mutable {
           remote_->OnReceivedPacket(local_endpoint_, FakeClock::now(),
-                                    std::move(pkt));
+                                    UdpPacket(pkt.begin(), pkt.end()));
         },
         network_delay_);
   }
@@ -204,6 +205,10 @@ class MockReceiver : public Environment::PacketConsumer {
     rtcp_builder_.SetPictureLossIndicator(picture_is_lost);
   }
 
+  void SetPlayoutDelay(milliseconds playout_delay) {
+    rtcp_builder_.SetPlayoutDelay(playout_delay);
+  }
+
   void SetReceiverReport(StatusReportId reply_for,
                          RtcpReportBlock::Delay processing_delay) {
     RtcpReportBlock receiver_report;
@@ -241,7 +246,7 @@ class MockReceiver : public Environment::PacketConsumer {
   // collection and Sender Report parsing/handling.
   void OnReceivedPacket(const IPEndpoint& source,
                         Clock::time_point arrival_time,
-                        std::vector<uint8_t> packet) override {
+                        UdpPacket packet) override {
     const auto type_and_ssrc = InspectPacketForRouting(packet);
     EXPECT_NE(ApparentPacketType::UNKNOWN, type_and_ssrc.first);
     EXPECT_EQ(kSenderSsrc, type_and_ssrc.second);
@@ -288,7 +293,7 @@ class MockReceiver : public Environment::PacketConsumer {
   // calls OnFrameComplete(). Ignores extra RTP packets that are no longer
   // needed.
   void CollectRtpPacket(const RtpPacketParser::ParseResult& part_of_frame,
-                        std::vector<uint8_t> packet) {
+                        UdpPacket packet) {
     const FrameId frame_id = part_of_frame.frame_id;
     if (complete_frames_.find(frame_id) != complete_frames_.end()) {
       return;
@@ -553,6 +558,64 @@ TEST_F(SenderTest, SendsFramesEfficiently) {
   ExpectFramesReceivedCorrectly(frames, receiver()->TakeCompleteFrames());
 }
 
+// Tests that, with FEC enabled, the Sender follows each group of packets with a
+// parity packet, from which the Receiver recovers a dropped packet without
+// needing it to be retransmitted.
+TEST_F(SenderTest, SendsParityPacketsWhenFecIsEnabled) {
+  sender_.reset();
+  SessionConfig config = {/* .sender_ssrc = */ kSenderSsrc,
+                          /* .receiver_ssrc = */ kReceiverSsrc,
+                          /* .rtp_timebase = */ kRtpTimebase,
+                          /* .channels = */ 2,
+                          /* .target_playout_delay = */ kTargetPlayoutDelay,
+                          /* .aes_secret_key = */ kAesKey,
+                          /* .aes_iv_mask = */ kCastIvMask,
+                          /* .is_pli_enabled = */ true};
+  config.fec_group_size = 4;
+  SenderImpl fec_sender(sender_environment_, sender_packet_router_, config,
+                        kRtpPayloadType);
+
+  // Record the ranges protected by parity packets, which must each arrive
+  // right after the last packet of their group.
+  std::vector<std::pair<int, int>> parity_ranges;
+  int last_data_packet_id = -1;
+  EXPECT_CALL(*receiver(), OnRtpPacket(_))
+      .WillRepeatedly([&](const RtpPacketParser::ParseResult& parsed_packet) {
+        if (parsed_packet.fec_parity) {
+          const int first = parsed_packet.packet_id;
+          const int last =
+              first + parsed_packet.fec_parity->num_protected_packets - 1;
+          EXPECT_EQ(last, last_data_packet_id);
+          parity_ranges.emplace_back(first, last);
+        } else {
+          last_data_packet_id = parsed_packet.packet_id;
+        }
+      });
+  ON_CALL(*receiver(), OnFrameComplete(_)).WillByDefault(InvokeWithoutArgs([&] {
+    if (receiver()->AutoAdvanceCheckpoint()) {
+      receiver()->TransmitRtcpFeedbackPacket();
+    }
+  }));
+
+  // The network drops packet 2, which is never retransmitted since nothing
+  // NACKs it.
+  receiver()->SetIgnoreList({PacketNack{FrameId::first(), 2}});
+  StrictMock<MockObserver> observer;
+  EXPECT_CALL(observer, OnFrameCanceled(FrameId::first()));
+  fec_sender.SetObserver(&observer);
+
+  EncodedFrameWithBuffer frame;
+  PopulateFrameWithDefaults(FrameId::first(), FakeClock::now() - kCaptureDelay,
+                            0x42, 8196 /* bytes */, &frame);
+  ASSERT_EQ(Sender::OK, fec_sender.EnqueueFrame(frame));
+  SimulateExecution(kTargetPlayoutDelay);
+
+  EXPECT_THAT(parity_ranges,
+              ElementsAre(std::make_pair(0, 3), std::make_pair(4, 5)));
+  ExpectFramesReceivedCorrectly(Span<EncodedFrameWithBuffer>(&frame, 1),
+                                receiver()->TakeCompleteFrames());
+}
+
 // Tests that the Sender properly updates the checkpoint frame ID while
 // it is cancelling frames. See https://crbug.com/1433584 for an example crash
 // where the checkpoint frame ID is invalid.
@@ -744,6 +807,53 @@ TEST_F(SenderTest, EnforcesMinimumInFlightForSmallPlayoutDelays) {
   EXPECT_EQ(kMinSenderInFlight, MaxInFlightForPlayoutDelay(milliseconds(90)));
 }
 
+// Tests that, if the Receiver adapts the target playout delay, the Sender
+// adopts the delay the Receiver reports if it is within the Sender's bounds,
+// and bounds the media in flight by it.
+TEST_F(SenderTest, AdoptsPlayoutDelayAdaptedByTheReceiver) {
+  sender_.reset();
+  SessionConfig config = {/* .sender_ssrc = */ kSenderSsrc,
+                          /* .receiver_ssrc = */ kReceiverSsrc,
+                          /* .rtp_timebase = */ kRtpTimebase,
+                          /* .channels = */ 2,
+                          /* .target_playout_delay = */ kTargetPlayoutDelay,
+                          /* .aes_secret_key = */ kAesKey,
+                          /* .aes_iv_mask = */ kCastIvMask,
+                          /* .is_pli_enabled = */ true};
+  config.adaptive_playout_delay =
+      PlayoutDelayBounds{.min = milliseconds(10), .max = seconds(1)};
+  SenderImpl adaptive_sender(sender_environment_, sender_packet_router_,
+                             config, kRtpPayloadType);
+
+  EncodedFrameWithBuffer frame;
+  PopulateFrameWithDefaults(FrameId::first(), FakeClock::now(), 0,
+                            1 /* byte */, &frame);
+  ASSERT_EQ(Sender::OK, adaptive_sender.EnqueueFrame(frame));
+
+  // Measure a round-trip time long enough for the in-flight limit to be capped
+  // by the target playout delay.
+  constexpr milliseconds kOneWayDelay(50);
+  SimulateNetworkRoundTrip(kOneWayDelay, kOneWayDelay);
+  EXPECT_EQ(Clock::to_duration(kTargetPlayoutDelay) / 3,
+            adaptive_sender.GetMaxInFlightMediaDuration());
+
+  // The Receiver ACKs the frame, and reports that it reduced the delay.
+  constexpr milliseconds kAdaptedPlayoutDelay(300);
+  receiver()->SetPlayoutDelay(kAdaptedPlayoutDelay);
+  receiver()->SetCheckpointFrame(FrameId::first());
+  receiver()->TransmitRtcpFeedbackPacket();
+  SimulateExecution(kOneWayDelay);
+  EXPECT_EQ(Clock::to_duration(kAdaptedPlayoutDelay) / 3,
+            adaptive_sender.GetMaxInFlightMediaDuration());
+
+  // A delay outside of the Sender's bounds is not adopted.
+  receiver()->SetPlayoutDelay(milliseconds(5));
+  receiver()->TransmitRtcpFeedbackPacket();
+  SimulateExecution(kOneWayDelay);
+  EXPECT_EQ(Clock::to_duration(kAdaptedPlayoutDelay) / 3,
+            adaptive_sender.GetMaxInFlightMediaDuration());
+}
+
 // Tests the asymmetric "fast attack, slow decay" round-trip-time smoothing
 // filter directly. See crbug.com/498036656.
 TEST(SenderRoundTripTimeSmoothingTest, ReactsQuicklyToSpikesAndDecaysSlowly) {
@@ -1301,6 +1411,71 @@ TEST_F(SenderTest, ResendsIndividuallyNackedPackets) {
   ExpectFramesReceivedCorrectly(frames, receiver()->TakeCompleteFrames());
 }
 
+// Tests that the Sender retransmits exactly the packets NACKed from a large key
+// frame, oldest first, for NACK patterns typical of bursty loss: long runs of
+// consecutive packets, plus scattered single losses.
+TEST_F(SenderTest, ResendsNackedPacketsOfLargeFrameInOrder) {
+  constexpr int kNumPackets = 200;
+  constexpr int kFrameDataSize =
+      kNumPackets * (kMaxRtpPacketSizeForIpv6UdpOnEthernet - 64);
+  constexpr milliseconds kOneWayNetworkDelay(1);
+  SetSenderToReceiverNetworkDelay(kOneWayNetworkDelay);
+  SetReceiverToSenderNetworkDelay(kOneWayNetworkDelay);
+
+  const std::vector<std::pair<int, int>> kLossPatterns[] = {
+      // The first packet.
+      {{0, 1}},
+      // Bursts.
+      {{3, 13}, {40, 42}, {90, 130}},
+      // Scattered single packets.
+      {{7, 8}, {64, 65}, {127, 128}, {150, 151}, {170, 171}},
+  };
+  for (const auto& loss_pattern : kLossPatterns) {
+    const FrameId frame_id = sender()->GetNextFrameId();
+    std::vector<PacketNack> dropped_packets;
+    for (const auto& [begin, end] : loss_pattern) {
+      for (int packet_id = begin; packet_id < end; ++packet_id) {
+        dropped_packets.push_back(
+            PacketNack{frame_id, static_cast<FramePacketId>(packet_id)});
+      }
+    }
+    receiver()->SetIgnoreList(dropped_packets);
+
+    EncodedFrameWithBuffer frame;
+    PopulateFrameWithDefaults(frame_id, FakeClock::now() - kCaptureDelay, 0,
+                              kFrameDataSize, &frame);
+    ASSERT_EQ(Sender::OK, sender()->EnqueueFrame(frame));
+    SimulateExecution(kTargetPlayoutDelay);
+
+    receiver()->SetNacksAndAcks(dropped_packets, {});
+    receiver()->TransmitRtcpFeedbackPacket();
+    receiver()->SetIgnoreList({});
+
+    StrictMock<MockObserver> observer;
+    sender()->SetObserver(&observer);
+    const int num_dropped_packets = static_cast<int>(dropped_packets.size());
+    EXPECT_CALL(observer, OnPacketsRetransmitted(num_dropped_packets));
+    EXPECT_CALL(observer, OnFrameCanceled(frame_id));
+    std::vector<PacketNack> resent_packets;
+    EXPECT_CALL(*receiver(), OnRtpPacket(_))
+        .WillRepeatedly([&](const RtpPacketParser::ParseResult& packet) {
+          resent_packets.push_back(
+              PacketNack{packet.frame_id, packet.packet_id});
+        });
+    EXPECT_CALL(*receiver(), OnFrameComplete(frame_id))
+        .WillOnce(InvokeWithoutArgs([&] {
+          receiver()->SetCheckpointFrame(frame_id);
+          receiver()->TransmitRtcpFeedbackPacket();
+        }));
+    SimulateExecution(kTargetPlayoutDelay);
+    sender()->SetObserver(nullptr);
+    Mock::VerifyAndClearExpectations(receiver());
+
+    EXPECT_EQ(dropped_packets, resent_packets);
+    EXPECT_EQ(0u, sender()->GetInFlightFrameCount());
+  }
+}
+
 // Tests that the Sender retransmits an entire frame if the Receiver requests it
 // (i.e., a full frame NACK), but does not retransmit any packets for frames
 // (before or after) that have been acknowledged.
@@ -23,6 +23,7 @@
 #include "platform/test/fake_task_runner.h"
 #include "util/chrono_helpers.h"
 #include "util/no_destructor.h"
+#include "util/std_util.h"
 #include "util/stringprintf.h"
 
 using ::testing::_;
@@ -474,6 +475,62 @@ TEST_F(SenderSessionTest, HandlesStreamTypes) {
   message_port_->ReceiveMessage(answer);
 }
 
+TEST_F(SenderSessionTest, AdoptsAdaptivePlayoutDelayIfAccepted) {
+  constexpr PlayoutDelayBounds kBounds{.min = milliseconds(40),
+                                       .max = milliseconds(400)};
+  AudioCaptureConfig audio_config = GetAudioCaptureConfigValid();
+  audio_config.adaptive_playout_delay = kBounds;
+  VideoCaptureConfig video_config = GetVideoCaptureConfigValid();
+  video_config.adaptive_playout_delay = kBounds;
+
+  for (const bool accepted : {true, false}) {
+    SCOPED_TRACE(testing::Message() << "accepted=" << accepted);
+    message_port_->clear();
+    ASSERT_TRUE(session_
+                    ->Negotiate(std::vector<AudioCaptureConfig>{audio_config},
+                                std::vector<VideoCaptureConfig>{video_config})
+                    .ok());
+
+    // Every stream of the offer asks for the extension.
+    const ErrorOr<Json::Value> offer =
+        json::Parse(message_port_->posted_messages()[0]);
+    ASSERT_TRUE(offer.is_value());
+    for (const Json::Value& stream :
+         offer.value()["offer"]["supportedStreams"]) {
+      EXPECT_TRUE(
+          Contains(stream["rtpExtensions"], kAdaptivePlayoutDelayRtpExtension));
+    }
+
+    ErrorOr<Json::Value> answer =
+        json::Parse(ConstructAnswerFromOffer(CastMode::kMirroring));
+    ASSERT_TRUE(answer.is_value());
+    if (accepted) {
+      Json::Value& extensions = answer.value()["answer"]["rtpExtensions"];
+      for (int i = 0; i < 2; ++i) {
+        extensions[i].append(kAdaptivePlayoutDelayRtpExtension);
+      }
+    }
+
+    EXPECT_CALL(client_, OnNegotiated(session_.get(), _, _))
+        .WillOnce([&](const SenderSession* sender_session,
+                      SenderSession::ConfiguredSenders senders,
+                      capture_recommendations::Recommendations) {
+          for (const Sender* sender :
+               {senders.audio_sender.get(), senders.video_sender.get()}) {
+            ASSERT_TRUE(sender);
+            const std::optional<PlayoutDelayBounds>& bounds =
+                sender->config().adaptive_playout_delay;
+            ASSERT_EQ(accepted, bounds.has_value());
+            if (accepted) {
+              EXPECT_EQ(kBounds.min, bounds->min);
+              EXPECT_EQ(kBounds.max, bounds->max);
+            }
+          }
+        });
+    message_port_->ReceiveMessage(json::Stringify(answer.value()).value());
+  }
+}
+
 TEST_F(SenderSessionTest, HandlesInvalidNamespace) {
   NegotiateMirroringWithValidConfigs();
   std::string answer = ConstructAnswerFromOffer(CastMode::kMirroring);
@@ -18,16 +18,44 @@ namespace {
 
 constexpr Clock::duration kAnalysisInterval = std::chrono::milliseconds(500);
 
-constexpr size_t kMaxRecentPacketInfoMapSize = 1000;
-constexpr size_t kMaxRecentFrameInfoMapSize = 200;
-
 constexpr int kDefaultMaxLatencyBucketMs = 800;
 constexpr int kDefaultBucketWidthMs = 20;
 
+template <typename Enum>
+constexpr size_t ToIndex(Enum value) {
+  return static_cast<size_t>(value);
+}
+
 double InMilliseconds(Clock::duration duration) {
   return static_cast<double>(to_milliseconds(duration).count());
 }
 
+// Unlike InMilliseconds(), keeps the fractions of a millisecond.
+double InFractionalMilliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+LatencyType ToLatencyType(StatisticType latency_stat) {
+  switch (latency_stat) {
+    case StatisticType::kAvgCaptureLatencyMs:
+      return LatencyType::kCaptureLatencyMs;
+    case StatisticType::kAvgEncodeTimeMs:
+      return LatencyType::kEncodeTimeMs;
+    case StatisticType::kAvgQueueingLatencyMs:
+      return LatencyType::kQueueingLatencyMs;
+    case StatisticType::kAvgNetworkLatencyMs:
+      return LatencyType::kNetworkLatencyMs;
+    case StatisticType::kAvgPacketLatencyMs:
+      return LatencyType::kPacketLatencyMs;
+    case StatisticType::kAvgFrameLatencyMs:
+      return LatencyType::kFrameLatencyMs;
+    case StatisticType::kAvgEndToEndLatencyMs:
+      return LatencyType::kEndToEndLatencyMs;
+    default:
+      OSP_NOTREACHED();
+  }
+}
+
 bool IsReceiverEvent(StatisticsEvent::Type event) {
   return event == StatisticsEvent::Type::kFrameAckSent ||
          event == StatisticsEvent::Type::kFrameDecoded ||
@@ -70,8 +98,10 @@ void StatisticsAnalyzer::InitHistograms() {
 }
 
 void StatisticsAnalyzer::AnalyzeStatistics() {
-  ProcessFrameEvents(statistics_collector_->TakeRecentFrameEvents());
-  ProcessPacketEvents(statistics_collector_->TakeRecentPacketEvents());
+  statistics_collector_->TakeRecentFrameEvents(&frame_events_);
+  ProcessFrameEvents();
+  statistics_collector_->TakeRecentPacketEvents(&packet_events_);
+  ProcessPacketEvents();
   SendStatistics();
   ScheduleAnalysis();
 }
@@ -88,50 +118,38 @@ void StatisticsAnalyzer::SendStatistics() {
       .audio_histograms = histograms_.audio,
       .video_statistics =
           ConstructStatisticsList(end_time, StatisticsEvent::MediaType::kVideo),
-      .video_histograms = histograms_.video});
+      .video_histograms = histograms_.video,
+      .audio_latency_quantiles =
+          ConstructLatencyQuantilesList(StatisticsEvent::MediaType::kAudio),
+      .video_latency_quantiles =
+          ConstructLatencyQuantilesList(StatisticsEvent::MediaType::kVideo),
+      .dropped_packet_events = statistics_collector_->dropped_packet_events(),
+      .dropped_frame_events = statistics_collector_->dropped_frame_events()});
 }
 
-void StatisticsAnalyzer::ProcessFrameEvents(
-    const std::vector<FrameEvent>& frame_events) {
-  for (FrameEvent frame_event : frame_events) {
+void StatisticsAnalyzer::ProcessFrameEvents() {
+  for (const FrameEvent& frame_event : frame_events_) {
     offset_estimator_->OnFrameEvent(frame_event);
 
-    FrameStatsMap& frame_stats_map = frame_stats_.Get(frame_event.media_type);
-    auto it = frame_stats_map.find(frame_event.type);
-    if (it == frame_stats_map.end()) {
-      frame_stats_map.insert(std::make_pair(
-          frame_event.type,
-          FrameStatsAggregate{.event_counter = 1,
-                              .sum_size = frame_event.size,
-                              .sum_delay = frame_event.delay_delta}));
-    } else {
-      ++(it->second.event_counter);
-      it->second.sum_size += frame_event.size;
-      it->second.sum_delay += frame_event.delay_delta;
-    }
+    FrameStatsAggregate& aggregate =
+        frame_stats_.Get(frame_event.media_type)[ToIndex(frame_event.type)];
+    ++aggregate.event_counter;
+    aggregate.sum_size += frame_event.size;
+    aggregate.sum_delay += frame_event.delay_delta;
 
     RecordEventTimes(frame_event);
     RecordFrameLatencies(frame_event);
   }
 }
 
-void StatisticsAnalyzer::ProcessPacketEvents(
-    const std::vector<PacketEvent>& packet_events) {
-  for (PacketEvent packet_event : packet_events) {
+void StatisticsAnalyzer::ProcessPacketEvents() {
+  for (const PacketEvent& packet_event : packet_events_) {
     offset_estimator_->OnPacketEvent(packet_event);
 
-    PacketStatsMap& packet_stats_map =
-        packet_stats_.Get(packet_event.media_type);
-    auto it = packet_stats_map.find(packet_event.type);
-    if (it == packet_stats_map.end()) {
-      packet_stats_map.insert(
-          std::make_pair(packet_event.type,
-                         PacketStatsAggregate{.event_counter = 1,
-                                              .sum_size = packet_event.size}));
-    } else {
-      ++(it->second.event_counter);
-      it->second.sum_size += packet_event.size;
-    }
+    PacketStatsAggregate& aggregate =
+        packet_stats_.Get(packet_event.media_type)[ToIndex(packet_event.type)];
+    ++aggregate.event_counter;
+    aggregate.sum_size += packet_event.size;
 
     RecordEventTimes(packet_event);
     if (packet_event.type == StatisticsEvent::Type::kPacketSentToNetwork ||
@@ -146,36 +164,25 @@ void StatisticsAnalyzer::ProcessPacketEvents(
 }
 
 void StatisticsAnalyzer::RecordFrameLatencies(const FrameEvent& frame_event) {
-  FrameInfoMap& frame_infos = recent_frame_infos_.Get(frame_event.media_type);
+  FrameInfo* const frame_info =
+      recent_frame_infos_.Get(frame_event.media_type)
+          .FindOrAdd(frame_event.rtp_timestamp);
 
   // Event is too old, don't bother.
-  const bool map_is_full = frame_infos.size() == kMaxRecentFrameInfoMapSize;
-  if (map_is_full && frame_event.rtp_timestamp <= frame_infos.begin()->first) {
+  if (!frame_info) {
     return;
   }
 
-  auto it = frame_infos.find(frame_event.rtp_timestamp);
-  if (it == frame_infos.end()) {
-    if (map_is_full) {
-      frame_infos.erase(frame_infos.begin());
-    }
-
-    auto emplace_result =
-        frame_infos.emplace(frame_event.rtp_timestamp, FrameInfo{});
-    OSP_CHECK(emplace_result.second);
-    it = emplace_result.first;
-  }
-
   switch (frame_event.type) {
     case StatisticsEvent::Type::kFrameCaptureBegin:
-      it->second.capture_begin_time = frame_event.timestamp;
+      frame_info->capture_begin_time = frame_event.timestamp;
       break;
 
     case StatisticsEvent::Type::kFrameCaptureEnd: {
-      it->second.capture_end_time = frame_event.timestamp;
-      if (it->second.capture_begin_time != Clock::time_point::min()) {
+      frame_info->capture_end_time = frame_event.timestamp;
+      if (frame_info->capture_begin_time != Clock::time_point::min()) {
         const Clock::duration capture_latency =
-            frame_event.timestamp - it->second.capture_begin_time;
+            frame_event.timestamp - frame_info->capture_begin_time;
         AddToLatencyAggregrate(StatisticType::kAvgCaptureLatencyMs,
                                capture_latency, frame_event.media_type);
         AddToHistogram(HistogramType::kCaptureLatencyMs, frame_event.media_type,
@@ -184,10 +191,10 @@ void StatisticsAnalyzer::RecordFrameLatencies(const FrameEvent& frame_event) {
     } break;
 
     case StatisticsEvent::Type::kFrameEncoded: {
-      it->second.encode_end_time = frame_event.timestamp;
-      if (it->second.capture_end_time != Clock::time_point::min()) {
+      frame_info->encode_end_time = frame_event.timestamp;
+      if (frame_info->capture_end_time != Clock::time_point::min()) {
         const Clock::duration encode_latency =
-            frame_event.timestamp - it->second.capture_end_time;
+            frame_event.timestamp - frame_info->capture_end_time;
         AddToLatencyAggregrate(StatisticType::kAvgEncodeTimeMs, encode_latency,
                                frame_event.media_type);
         AddToHistogram(HistogramType::kEncodeTimeMs, frame_event.media_type,
@@ -204,9 +211,9 @@ void StatisticsAnalyzer::RecordFrameLatencies(const FrameEvent& frame_event) {
         return;
       }
 
-      if (it->second.encode_end_time != Clock::time_point::min()) {
+      if (frame_info->encode_end_time != Clock::time_point::min()) {
         const Clock::duration frame_latency =
-            *adjusted_timestamp - it->second.encode_end_time;
+            *adjusted_timestamp - frame_info->encode_end_time;
         AddToLatencyAggregrate(StatisticType::kAvgFrameLatencyMs, frame_latency,
                                frame_event.media_type);
       }
@@ -219,9 +226,9 @@ void StatisticsAnalyzer::RecordFrameLatencies(const FrameEvent& frame_event) {
         return;
       }
 
-      if (it->second.capture_begin_time != Clock::time_point::min()) {
+      if (frame_info->capture_begin_time != Clock::time_point::min()) {
         const Clock::duration e2e_latency =
-            *adjusted_timestamp - it->second.capture_begin_time;
+            *adjusted_timestamp - frame_info->capture_begin_time;
         AddToLatencyAggregrate(StatisticType::kAvgEndToEndLatencyMs,
                                e2e_latency, frame_event.media_type);
         AddToHistogram(HistogramType::kEndToEndLatencyMs,
@@ -243,17 +250,19 @@ void StatisticsAnalyzer::RecordFrameLatencies(const FrameEvent& frame_event) {
 
 void StatisticsAnalyzer::RecordPacketLatencies(
     const PacketEvent& packet_event) {
-  FrameInfoMap& frame_infos = recent_frame_infos_.Get(packet_event.media_type);
+  FrameInfoTable& frame_infos =
+      recent_frame_infos_.Get(packet_event.media_type);
 
   // Queueing latency is the time from when a frame is encoded to when the
   // packet is first sent.
   if (packet_event.type == StatisticsEvent::Type::kPacketSentToNetwork) {
-    const auto it = frame_infos.find(packet_event.rtp_timestamp);
+    const FrameInfo* const frame_info =
+        frame_infos.Find(packet_event.rtp_timestamp);
 
     // We have an encode end time for a frame associated with this packet.
-    if (it != frame_infos.end()) {
+    if (frame_info) {
       const Clock::duration queueing_latency =
-          packet_event.timestamp - it->second.encode_end_time;
+          packet_event.timestamp - frame_info->encode_end_time;
       AddToLatencyAggregrate(StatisticType::kAvgQueueingLatencyMs,
                              queueing_latency, packet_event.media_type);
       AddToHistogram(HistogramType::kQueueingLatencyMs, packet_event.media_type,
@@ -261,21 +270,20 @@ void StatisticsAnalyzer::RecordPacketLatencies(
     }
   }
 
-  StatisticsAnalyzer::PacketKey key =
+  const StatisticsAnalyzer::PacketKey key =
       std::make_pair(packet_event.rtp_timestamp, packet_event.packet_id);
-  PacketInfoMap& packet_infos =
+  PacketInfoTable& packet_infos =
       recent_packet_infos_.Get(packet_event.media_type);
 
-  const auto it = packet_infos.find(key);
-  if (it == packet_infos.end()) {
-    packet_infos.insert(
-        std::make_pair(key, PacketInfo{.timestamp = packet_event.timestamp,
-                                       .type = packet_event.type}));
-    if (packet_infos.size() > kMaxRecentPacketInfoMapSize) {
-      packet_infos.erase(packet_infos.begin());
+  const PacketInfo* const packet_info = packet_infos.Find(key);
+  if (!packet_info) {
+    PacketInfo* const new_packet_info = packet_infos.FindOrAdd(key);
+    if (new_packet_info) {
+      *new_packet_info = PacketInfo{.timestamp = packet_event.timestamp,
+                                    .type = packet_event.type};
     }
   } else {  // We know when this packet was sent, and when it arrived.
-    PacketInfo value = it->second;
+    const PacketInfo value = *packet_info;
     StatisticsEvent::Type recorded_type = value.type;
     Clock::time_point packet_sent_time;
     Clock::time_point packet_received_time;
@@ -292,7 +300,7 @@ void StatisticsAnalyzer::RecordPacketLatencies(
       return;
     }
 
-    packet_infos.erase(it);
+    packet_infos.Erase(key);
 
     // Use the offset estimator directly since we are trying to calculate the
     // average network latency.
@@ -311,10 +319,11 @@ void StatisticsAnalyzer::RecordPacketLatencies(
 
     // Packet latency is the time from when a frame is encoded until when the
     // packet is received.
-    const auto frame_it = frame_infos.find(packet_event.rtp_timestamp);
-    if (frame_it != frame_infos.end()) {
+    const FrameInfo* const frame_info =
+        frame_infos.Find(packet_event.rtp_timestamp);
+    if (frame_info) {
       const Clock::duration packet_latency =
-          packet_received_time - frame_it->second.encode_end_time;
+          packet_received_time - frame_info->encode_end_time;
       AddToLatencyAggregrate(StatisticType::kAvgPacketLatencyMs, packet_latency,
                              packet_event.media_type);
       AddToHistogram(HistogramType::kPacketLatencyMs, packet_event.media_type,
@@ -352,26 +361,20 @@ void StatisticsAnalyzer::RecordEventTimes(const StatisticsEvent& event) {
 void StatisticsAnalyzer::ErasePacketInfo(const PacketEvent& packet_event) {
   const StatisticsAnalyzer::PacketKey key =
       std::make_pair(packet_event.rtp_timestamp, packet_event.packet_id);
-  PacketInfoMap& packet_infos =
-      recent_packet_infos_.Get(packet_event.media_type);
-  packet_infos.erase(key);
+  recent_packet_infos_.Get(packet_event.media_type).Erase(key);
 }
 
 void StatisticsAnalyzer::AddToLatencyAggregrate(
     StatisticType latency_stat,
     Clock::duration latency_delta,
     StatisticsEvent::MediaType media_type) {
-  LatencyStatsMap& latency_stats = latency_stats_.Get(media_type);
-
-  auto it = latency_stats.find(latency_stat);
-  if (it == latency_stats.end()) {
-    latency_stats.insert(std::make_pair(
-        latency_stat, LatencyStatsAggregate{.data_point_counter = 1,
-                                            .sum_latency = latency_delta}));
-  } else {
-    ++(it->second.data_point_counter);
-    it->second.sum_latency += latency_delta;
-  }
+  LatencyStatsAggregate& aggregate =
+      latency_stats_.Get(media_type)[ToIndex(latency_stat)];
+  ++aggregate.data_point_counter;
+  aggregate.sum_latency += latency_delta;
+
+  latency_sketches_.Get(media_type)[ToIndex(ToLatencyType(latency_stat))].Add(
+      InFractionalMilliseconds(latency_delta));
 }
 
 void StatisticsAnalyzer::AddToHistogram(HistogramType histogram,
@@ -436,16 +439,35 @@ SenderStats::StatisticsList StatisticsAnalyzer::ConstructStatisticsList(
   return stats_list;
 }
 
+SenderStats::LatencyQuantilesList
+StatisticsAnalyzer::ConstructLatencyQuantilesList(
+    StatisticsEvent::MediaType media_type) const {
+  SenderStats::LatencyQuantilesList quantiles_list;
+  const LatencySketchArray& sketches = latency_sketches_.Get(media_type);
+  for (size_t i = 0; i < sketches.size(); ++i) {
+    const QuantileSketch& sketch = sketches[i];
+    if (sketch.empty()) {
+      continue;
+    }
+    quantiles_list[i] = LatencyQuantiles{.count = sketch.count(),
+                                         .p50_ms = sketch.GetQuantile(0.5),
+                                         .p90_ms = sketch.GetQuantile(0.9),
+                                         .p95_ms = sketch.GetQuantile(0.95),
+                                         .p99_ms = sketch.GetQuantile(0.99),
+                                         .max_ms = sketch.max()};
+  }
+  return quantiles_list;
+}
+
 void StatisticsAnalyzer::PopulatePacketCountStat(
     StatisticsEvent::Type event,
     StatisticType stat,
     StatisticsEvent::MediaType media_type,
     SenderStats::StatisticsList& stats_list) {
-  PacketStatsMap& stats_map = packet_stats_.Get(media_type);
-
-  auto it = stats_map.find(event);
-  if (it != stats_map.end()) {
-    stats_list[static_cast<int>(stat)] = it->second.event_counter;
+  const PacketStatsAggregate& aggregate =
+      packet_stats_.Get(media_type)[ToIndex(event)];
+  if (aggregate.event_counter > 0) {
+    stats_list[static_cast<int>(stat)] = aggregate.event_counter;
   }
 }
 
@@ -454,11 +476,10 @@ void StatisticsAnalyzer::PopulateFrameCountStat(
     StatisticType stat,
     StatisticsEvent::MediaType media_type,
     SenderStats::StatisticsList& stats_list) {
-  FrameStatsMap& stats_map = frame_stats_.Get(media_type);
-
-  const auto it = stats_map.find(event);
-  if (it != stats_map.end()) {
-    stats_list[static_cast<int>(stat)] = it->second.event_counter;
+  const FrameStatsAggregate& aggregate =
+      frame_stats_.Get(media_type)[ToIndex(event)];
+  if (aggregate.event_counter > 0) {
+    stats_list[static_cast<int>(stat)] = aggregate.event_counter;
   }
 }
 
@@ -468,13 +489,12 @@ void StatisticsAnalyzer::PopulateFpsStat(
     StatisticsEvent::MediaType media_type,
     Clock::time_point end_time,
     SenderStats::StatisticsList& stats_list) {
-  FrameStatsMap& stats_map = frame_stats_.Get(media_type);
-
-  const auto it = stats_map.find(event);
-  if (it != stats_map.end()) {
+  const FrameStatsAggregate& aggregate =
+      frame_stats_.Get(media_type)[ToIndex(event)];
+  if (aggregate.event_counter > 0) {
     const Clock::duration duration = end_time - start_time_;
     if (duration != Clock::duration::zero()) {
-      const int count = it->second.event_counter;
+      const int count = aggregate.event_counter;
       const double fps = (count / InMilliseconds(duration)) * 1000;
       stats_list[static_cast<int>(stat)] = fps;
     }
@@ -487,12 +507,11 @@ void StatisticsAnalyzer::PopulateAvgLatencyStat(
     SenderStats::StatisticsList& stats_list
 
 ) {
-  LatencyStatsMap& latency_map = latency_stats_.Get(media_type);
-
-  const auto it = latency_map.find(stat);
-  if (it != latency_map.end() && it->second.data_point_counter > 0) {
+  const LatencyStatsAggregate& aggregate =
+      latency_stats_.Get(media_type)[ToIndex(stat)];
+  if (aggregate.data_point_counter > 0) {
     const double avg_latency =
-        InMilliseconds(it->second.sum_latency) / it->second.data_point_counter;
+        InMilliseconds(aggregate.sum_latency) / aggregate.data_point_counter;
     stats_list[static_cast<int>(stat)] = avg_latency;
   }
 }
@@ -503,13 +522,12 @@ void StatisticsAnalyzer::PopulateFrameBitrateStat(
     StatisticsEvent::MediaType media_type,
     Clock::time_point end_time,
     SenderStats::StatisticsList& stats_list) {
-  FrameStatsMap& stats_map = frame_stats_.Get(media_type);
-
-  const auto it = stats_map.find(event);
-  if (it != stats_map.end()) {
+  const FrameStatsAggregate& aggregate =
+      frame_stats_.Get(media_type)[ToIndex(event)];
+  if (aggregate.event_counter > 0) {
     const Clock::duration duration = end_time - start_time_;
     if (duration != Clock::duration::zero()) {
-      const double kbps = it->second.sum_size / InMilliseconds(duration) * 8;
+      const double kbps = aggregate.sum_size / InMilliseconds(duration) * 8;
       stats_list[static_cast<int>(stat)] = kbps;
     }
   }
@@ -521,13 +539,12 @@ void StatisticsAnalyzer::PopulatePacketBitrateStat(
     StatisticsEvent::MediaType media_type,
     Clock::time_point end_time,
     SenderStats::StatisticsList& stats_list) {
-  PacketStatsMap& stats_map = packet_stats_.Get(media_type);
-
-  auto it = stats_map.find(event);
-  if (it != stats_map.end()) {
+  const PacketStatsAggregate& aggregate =
+      packet_stats_.Get(media_type)[ToIndex(event)];
+  if (aggregate.event_counter > 0) {
     const Clock::duration duration = end_time - start_time_;
     if (duration != Clock::duration::zero()) {
-      const double kbps = it->second.sum_size / InMilliseconds(duration) * 8;
+      const double kbps = aggregate.sum_size / InMilliseconds(duration) * 8;
       stats_list[static_cast<int>(stat)] = kbps;
     }
   }
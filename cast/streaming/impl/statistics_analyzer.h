@@ -5,7 +5,10 @@
 #ifndef CAST_STREAMING_IMPL_STATISTICS_ANALYZER_H_
 #define CAST_STREAMING_IMPL_STATISTICS_ANALYZER_H_
 
-#include <map>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
 #include <memory>
 #include <optional>
 #include <utility>
@@ -16,6 +19,7 @@
 #include "cast/streaming/public/statistics.h"
 #include "platform/api/time.h"
 #include "util/alarm.h"
+#include "util/quantile_sketch.h"
 #include "util/raw_ptr.h"
 
 namespace openscreen::cast {
@@ -36,20 +40,22 @@ class StatisticsAnalyzer {
   }
 
  private:
+  // An aggregate with a zero counter has not seen any events, and its stat is
+  // not reported.
   struct FrameStatsAggregate {
-    int event_counter;
-    uint32_t sum_size;
-    Clock::duration sum_delay;
+    int event_counter = 0;
+    uint32_t sum_size = 0;
+    Clock::duration sum_delay{};
   };
 
   struct PacketStatsAggregate {
-    int event_counter;
-    uint32_t sum_size;
+    int event_counter = 0;
+    uint32_t sum_size = 0;
   };
 
   struct LatencyStatsAggregate {
-    int data_point_counter;
-    Clock::duration sum_latency;
+    int data_point_counter = 0;
+    Clock::duration sum_latency{};
   };
 
   struct FrameInfo {
@@ -88,13 +94,84 @@ class StatisticsAnalyzer {
     }
   };
 
-  using FrameStatsMap = std::map<StatisticsEvent::Type, FrameStatsAggregate>;
-  using PacketStatsMap = std::map<StatisticsEvent::Type, PacketStatsAggregate>;
-  using LatencyStatsMap = std::map<StatisticType, LatencyStatsAggregate>;
+  // A fixed-size table of the infos of recent frames or packets, with
+  // 2^`kSizeLog2` slots. Each key maps to exactly one slot, by a multiplicative
+  // hash, so finding an info is a single array access. The hash spreads out the
+  // RTP timestamps of consecutive frames, which advance by a constant step,
+  // evenly over the slots. When two keys map to the same slot, the newer one
+  // replaces the older one, since infos are needed only until the later events
+  // of their frame or packet are seen.
+  template <typename Key, typename Info, int kSizeLog2>
+  class RecentInfoTable {
+   public:
+    RecentInfoTable() : slots_(size_t{1} << kSizeLog2) {}
+
+    // Returns the info for `key`, or nullptr if there is none.
+    Info* Find(const Key& key) {
+      Slot& slot = slots_[GetSlotIndex(key)];
+      return (slot.in_use && slot.key == key) ? &slot.info : nullptr;
+    }
+
+    // Returns the info for `key`, adding an empty one if there is none. Returns
+    // nullptr if the slot for `key` holds the info of a newer key.
+    Info* FindOrAdd(const Key& key) {
+      Slot& slot = slots_[GetSlotIndex(key)];
+      if (!slot.in_use || slot.key < key) {
+        slot = Slot{.key = key, .in_use = true, .info = Info{}};
+      } else if (key < slot.key) {
+        return nullptr;
+      }
+      return &slot.info;
+    }
+
+    void Erase(const Key& key) {
+      Slot& slot = slots_[GetSlotIndex(key)];
+      if (slot.in_use && slot.key == key) {
+        slot.in_use = false;
+      }
+    }
+
+   private:
+    struct Slot {
+      Key key{};
+      bool in_use = false;
+      Info info{};
+    };
+
+    static size_t GetSlotIndex(const Key& key) {
+      // 2^64 divided by the golden ratio (Fibonacci hashing).
+      constexpr uint64_t kMultiplier = 0x9E3779B97F4A7C15;
+      return static_cast<size_t>((HashKey(key) * kMultiplier) >>
+                                 (64 - kSizeLog2));
+    }
+
+    std::vector<Slot> slots_;
+  };
 
-  using FrameInfoMap = std::map<RtpTimeTicks, FrameInfo>;
   using PacketKey = std::pair<RtpTimeTicks, uint16_t>;
-  using PacketInfoMap = std::map<PacketKey, PacketInfo>;
+
+  static uint64_t HashKey(RtpTimeTicks rtp_timestamp) {
+    return rtp_timestamp.lower_32_bits();
+  }
+  static uint64_t HashKey(const PacketKey& key) {
+    return (uint64_t{key.first.lower_32_bits()} << 16) | key.second;
+  }
+
+  // The aggregates are indexed by their StatisticsEvent::Type or StatisticType.
+  using FrameStatsArray =
+      std::array<FrameStatsAggregate,
+                 static_cast<size_t>(StatisticsEvent::Type::kNumOfEvents)>;
+  using PacketStatsArray =
+      std::array<PacketStatsAggregate,
+                 static_cast<size_t>(StatisticsEvent::Type::kNumOfEvents)>;
+  using LatencyStatsArray =
+      std::array<LatencyStatsAggregate,
+                 static_cast<size_t>(StatisticType::kNumTypes)>;
+  using LatencySketchArray =
+      std::array<QuantileSketch, static_cast<size_t>(LatencyType::kNumTypes)>;
+
+  using FrameInfoTable = RecentInfoTable<RtpTimeTicks, FrameInfo, 8>;
+  using PacketInfoTable = RecentInfoTable<PacketKey, PacketInfo, 11>;
 
   // Initialize the stats histograms with the preferred min, max, and width.
   void InitHistograms();
@@ -107,10 +184,10 @@ class StatisticsAnalyzer {
   // Constructs a stats list, and sends it to `stats_client_`;
   void SendStatistics();
 
-  // Handles incoming stat events, and adds their infos to all of the proper
-  // stats maps / aggregates.
-  void ProcessFrameEvents(const std::vector<FrameEvent>& frame_events);
-  void ProcessPacketEvents(const std::vector<PacketEvent>& packet_events);
+  // Handles the events taken into `frame_events_` and `packet_events_`, and
+  // adds their infos to all of the proper stats tables / aggregates.
+  void ProcessFrameEvents();
+  void ProcessPacketEvents();
   void RecordFrameLatencies(const FrameEvent& frame_event);
   void RecordPacketLatencies(const PacketEvent& packet_event);
   void RecordEventTimes(const StatisticsEvent& event);
@@ -128,6 +205,10 @@ class StatisticsAnalyzer {
       Clock::time_point end_time,
       StatisticsEvent::MediaType media_type);
 
+  // Creates a list of the quantiles of each latency, from `latency_sketches_`.
+  SenderStats::LatencyQuantilesList ConstructLatencyQuantilesList(
+      StatisticsEvent::MediaType media_type) const;
+
   void PopulatePacketCountStat(StatisticsEvent::Type event,
                                StatisticType stat,
                                StatisticsEvent::MediaType media_type,
@@ -184,16 +265,24 @@ class StatisticsAnalyzer {
   Alarm alarm_;
   Clock::time_point start_time_;
 
-  // Maps of frame / packet infos used for stats that rely on seeing multiple
+  // The events taken from `statistics_collector_` by the current analysis.
+  // Their storage is reused by each analysis.
+  std::vector<FrameEvent> frame_events_;
+  std::vector<PacketEvent> packet_events_;
+
+  // Tables of frame / packet infos used for stats that rely on seeing multiple
   // events. For example, network latency is the calculated time difference
   // between went a packet is sent, and when it is received.
-  AVPair<FrameInfoMap> recent_frame_infos_;
-  AVPair<PacketInfoMap> recent_packet_infos_;
+  AVPair<FrameInfoTable> recent_frame_infos_;
+  AVPair<PacketInfoTable> recent_packet_infos_;
 
   // Aggregate statistics.
-  AVPair<FrameStatsMap> frame_stats_;
-  AVPair<PacketStatsMap> packet_stats_;
-  AVPair<LatencyStatsMap> latency_stats_;
+  AVPair<FrameStatsArray> frame_stats_;
+  AVPair<PacketStatsArray> packet_stats_;
+  AVPair<LatencyStatsArray> latency_stats_;
+
+  // Sketches of the distributions of the latencies, in milliseconds.
+  AVPair<LatencySketchArray> latency_sketches_;
 
   // Stats that relate to the entirety of the session. For example, total late
   // frames, or time of last event.
@@ -4,8 +4,10 @@
 
 #include "cast/streaming/impl/statistics_analyzer.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <numeric>
+#include <vector>
 
 #include "cast/streaming/public/statistics.h"
 #include "gmock/gmock.h"
@@ -299,6 +301,65 @@ TEST_F(StatisticsAnalyzerTest, FramePlayedOut) {
                    (kDefaultStatIntervalMs * kDefaultNumEvents)));
 }
 
+TEST_F(StatisticsAnalyzerTest, LatencyQuantiles) {
+  analyzer_->ScheduleAnalysis();
+
+  // Most frames have an end to end latency of 100 - 149 ms, and every tenth
+  // frame a much longer one, which only the tail quantiles should reflect.
+  constexpr int kNumFrames = 400;
+  std::vector<double> latencies_ms;
+  RtpTimeTicks rtp_timestamp;
+  for (int i = 0; i < kNumFrames; i++) {
+    const int latency_ms = (i % 10 == 9) ? 500 + i : 100 + (i * 7) % 50;
+    latencies_ms.push_back(latency_ms);
+
+    FrameEvent event1 = MakeFrameEvent(i, rtp_timestamp);
+    event1.type = StatisticsEvent::Type::kFrameCaptureBegin;
+    FrameEvent event2 = MakeFrameEvent(i, rtp_timestamp);
+    event2.type = StatisticsEvent::Type::kFramePlayedOut;
+    event2.timestamp += milliseconds(latency_ms);
+
+    collector_->CollectFrameEvent(event1);
+    collector_->CollectFrameEvent(event2);
+    fake_clock_.Advance(milliseconds(1));
+    rtp_timestamp += RtpTimeDelta::FromTicks(90);
+  }
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  const auto exact_quantile = [&](double quantile) {
+    return latencies_ms[static_cast<size_t>(quantile * (kNumFrames - 1))];
+  };
+
+  EXPECT_CALL(stats_client_, OnStatisticsUpdated(_))
+      .WillOnce([&](const SenderStats& stats) {
+        const LatencyQuantiles& quantiles =
+            stats.video_latency_quantiles[static_cast<int>(
+                LatencyType::kEndToEndLatencyMs)];
+        EXPECT_EQ(kNumFrames, quantiles.count);
+        EXPECT_NEAR(exact_quantile(0.5), quantiles.p50_ms,
+                    0.01 * exact_quantile(0.5));
+        EXPECT_NEAR(exact_quantile(0.9), quantiles.p90_ms,
+                    0.01 * exact_quantile(0.9));
+        EXPECT_NEAR(exact_quantile(0.95), quantiles.p95_ms,
+                    0.01 * exact_quantile(0.95));
+        EXPECT_NEAR(exact_quantile(0.99), quantiles.p99_ms,
+                    0.01 * exact_quantile(0.99));
+        EXPECT_EQ(latencies_ms.back(), quantiles.max_ms);
+        EXPECT_LT(quantiles.p50_ms, 150);
+        EXPECT_LT(500, quantiles.p95_ms);
+
+        // Latencies that were not measured have no quantiles.
+        EXPECT_EQ(LatencyQuantiles{},
+                  stats.video_latency_quantiles[static_cast<int>(
+                      LatencyType::kNetworkLatencyMs)]);
+        EXPECT_EQ(LatencyQuantiles{},
+                  stats.audio_latency_quantiles[static_cast<int>(
+                      LatencyType::kEndToEndLatencyMs)]);
+      });
+
+  fake_clock_.Advance(
+      milliseconds(kDefaultStatsAnalysisIntervalMs - kNumFrames));
+}
+
 TEST_F(StatisticsAnalyzerTest, FrameDroppedByEncoder) {
   analyzer_->ScheduleAnalysis();
 
@@ -325,6 +386,28 @@ TEST_F(StatisticsAnalyzerTest, FrameDroppedByEncoder) {
                    (kDefaultStatIntervalMs * kDefaultNumEvents)));
 }
 
+TEST_F(StatisticsAnalyzerTest, ReportsDroppedEvents) {
+  analyzer_->ScheduleAnalysis();
+
+  // Fill the frame event buffer, so that the last few events are dropped.
+  constexpr int kNumDropped = 3;
+  RtpTimeTicks rtp_timestamp;
+  for (size_t i = 0; i < StatisticsCollector::kFrameEventCapacity + kNumDropped;
+       i++) {
+    collector_->CollectFrameEvent(
+        MakeFrameEvent(static_cast<int>(i), rtp_timestamp));
+    rtp_timestamp += RtpTimeDelta::FromTicks(90);
+  }
+
+  EXPECT_CALL(stats_client_, OnStatisticsUpdated(_))
+      .WillOnce([&](const SenderStats& stats) {
+        EXPECT_EQ(uint64_t{kNumDropped}, stats.dropped_frame_events);
+        EXPECT_EQ(0u, stats.dropped_packet_events);
+      });
+
+  fake_clock_.Advance(milliseconds(kDefaultStatsAnalysisIntervalMs));
+}
+
 TEST_F(StatisticsAnalyzerTest, AllFrameEvents) {
   constexpr std::array<StatisticsEvent::Type, 5> kEventsToReport{
       StatisticsEvent::Type::kFrameCaptureBegin,
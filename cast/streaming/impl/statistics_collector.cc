@@ -14,18 +14,27 @@
 
 namespace openscreen::cast {
 
-StatisticsCollector::StatisticsCollector(ClockNowFunctionPtr now) : now_(now) {}
+StatisticsCollector::StatisticsCollector(ClockNowFunctionPtr now)
+    : now_(now),
+      recent_packet_events_(kPacketEventCapacity),
+      recent_frame_events_(kFrameEventCapacity) {}
 StatisticsCollector::~StatisticsCollector() = default;
 
 void StatisticsCollector::CollectPacketSentEvent(ByteView packet,
                                                  PacketMetadata metadata) {
+  CollectPacketSentEvent(packet, ByteView(), metadata);
+}
+
+void StatisticsCollector::CollectPacketSentEvent(ByteView header,
+                                                 ByteView payload,
+                                                 PacketMetadata metadata) {
   PacketEvent event;
 
-  // Populate the new PacketEvent by parsing the wire-format `packet`.
+  // Populate the new PacketEvent by parsing the wire-format `header`.
   event.timestamp = now_();
   event.type = StatisticsEvent::Type::kPacketSentToNetwork;
 
-  BigEndianReader reader(packet.data(), packet.size());
+  BigEndianReader reader(header.data(), header.size());
   bool success = reader.Skip(4);
   uint32_t truncated_rtp_timestamp = 0;
   success &= reader.Read<uint32_t>(&truncated_rtp_timestamp);
@@ -43,32 +52,49 @@ void StatisticsCollector::CollectPacketSentEvent(ByteView packet,
   static_assert(static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) <=
                     static_cast<uint64_t>(std::numeric_limits<size_t>::max()),
                 "invalid type cast assumption");
-  OSP_CHECK_LE(packet.size(),
+  const size_t packet_size = header.size() + payload.size();
+  OSP_CHECK_LE(packet_size,
                static_cast<size_t>(std::numeric_limits<uint32_t>::max()));
-  event.size = static_cast<uint32_t>(packet.size());
+  event.size = static_cast<uint32_t>(packet_size);
   OSP_CHECK(success);
 
-  recent_packet_events_.emplace_back(event);
+  CollectPacketEvent(event);
 }
 
 void StatisticsCollector::CollectPacketEvent(PacketEvent event) {
-  recent_packet_events_.emplace_back(event);
+  if (!recent_packet_events_.TryPush(event)) {
+    dropped_packet_events_.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 void StatisticsCollector::CollectFrameEvent(FrameEvent event) {
-  recent_frame_events_.emplace_back(event);
+  if (!recent_frame_events_.TryPush(std::move(event))) {
+    dropped_frame_events_.fetch_add(1, std::memory_order_relaxed);
+  }
 }
 
 std::vector<PacketEvent> StatisticsCollector::TakeRecentPacketEvents() {
   std::vector<PacketEvent> out;
-  recent_packet_events_.swap(out);
+  TakeRecentPacketEvents(&out);
   return out;
 }
 
 std::vector<FrameEvent> StatisticsCollector::TakeRecentFrameEvents() {
   std::vector<FrameEvent> out;
-  recent_frame_events_.swap(out);
+  TakeRecentFrameEvents(&out);
   return out;
 }
 
+void StatisticsCollector::TakeRecentPacketEvents(
+    std::vector<PacketEvent>* events) {
+  events->clear();
+  recent_packet_events_.PopAll(events);
+}
+
+void StatisticsCollector::TakeRecentFrameEvents(
+    std::vector<FrameEvent>* events) {
+  events->clear();
+  recent_frame_events_.PopAll(events);
+}
+
 }  // namespace openscreen::cast
@@ -5,11 +5,15 @@
 #ifndef CAST_STREAMING_IMPL_STATISTICS_COLLECTOR_H_
 #define CAST_STREAMING_IMPL_STATISTICS_COLLECTOR_H_
 
+#include <stdint.h>
+
+#include <atomic>
 #include <vector>
 
 #include "cast/streaming/impl/statistics_common.h"
 #include "platform/api/time.h"
 #include "platform/base/span.h"
+#include "util/spsc_ring_buffer.h"
 
 namespace openscreen::cast {
 
@@ -26,8 +30,19 @@ struct PacketMetadata {
 // This class is responsible for gathering packet and frame statistics using its
 // Collect*() methods, that can then be taken by consumers using the Take*()
 // methods.
+//
+// The events are kept in fixed-capacity, lock-free ring buffers, so collecting
+// an event never allocates or blocks. The Collect*() methods may be called on
+// one thread while the Take*() methods are called on another, as long as each
+// kind of event (packet or frame) is collected from only one thread at a time.
+// When a consumer falls too far behind, new events are dropped and counted.
 class StatisticsCollector {
  public:
+  // The maximum number of events of each kind that are kept between calls to
+  // the Take*() methods.
+  static constexpr size_t kPacketEventCapacity = 8192;
+  static constexpr size_t kFrameEventCapacity = 2048;
+
   explicit StatisticsCollector(ClockNowFunctionPtr now);
   ~StatisticsCollector();
 
@@ -35,6 +50,12 @@ class StatisticsCollector {
   // generate a packet event that is then  added to `recent_packet_events_`.
   void CollectPacketSentEvent(ByteView packet, PacketMetadata metadata);
 
+  // Same as above, for a packet that was sent as a `header` followed by a
+  // separate `payload`. Only the header is parsed.
+  void CollectPacketSentEvent(ByteView header,
+                              ByteView payload,
+                              PacketMetadata metadata);
+
   // Informs the collector that a packet event has occurred. This event is then
   // added to `recent_packet_events_`.
   void CollectPacketEvent(PacketEvent event);
@@ -53,10 +74,26 @@ class StatisticsCollector {
   // is reset to an empty vector.
   std::vector<FrameEvent> TakeRecentFrameEvents();
 
+  // Same as above, but replace the contents of `events` instead, so that a
+  // consumer can reuse its storage.
+  void TakeRecentPacketEvents(std::vector<PacketEvent>* events);
+  void TakeRecentFrameEvents(std::vector<FrameEvent>* events);
+
+  // The number of events that were dropped, since they were collected while
+  // `recent_packet_events_` or `recent_frame_events_` was full.
+  uint64_t dropped_packet_events() const {
+    return dropped_packet_events_.load(std::memory_order_relaxed);
+  }
+  uint64_t dropped_frame_events() const {
+    return dropped_frame_events_.load(std::memory_order_relaxed);
+  }
+
  private:
   ClockNowFunctionPtr now_;
-  std::vector<PacketEvent> recent_packet_events_;
-  std::vector<FrameEvent> recent_frame_events_;
+  SpscRingBuffer<PacketEvent> recent_packet_events_;
+  SpscRingBuffer<FrameEvent> recent_frame_events_;
+  std::atomic<uint64_t> dropped_packet_events_{0};
+  std::atomic<uint64_t> dropped_frame_events_{0};
 };
 
 }  // namespace openscreen::cast
@@ -140,4 +140,28 @@ TEST_F(StatisticsCollectorTest, CanCollectFrameEvents) {
   EXPECT_EQ(kEventTwo, events[1]);
 }
 
+TEST_F(StatisticsCollectorTest, DropsEventsWhenFull) {
+  FrameEvent event;
+  event.type = StatisticsEvent::Type::kFrameEncoded;
+  for (size_t i = 0; i < StatisticsCollector::kFrameEventCapacity + 3; ++i) {
+    event.frame_id = FrameId(i);
+    collector_.CollectFrameEvent(event);
+  }
+  EXPECT_EQ(3u, collector_.dropped_frame_events());
+  EXPECT_EQ(0u, collector_.dropped_packet_events());
+
+  // The oldest events are kept, and taking them makes room for more.
+  std::vector<FrameEvent> events;
+  collector_.TakeRecentFrameEvents(&events);
+  ASSERT_EQ(StatisticsCollector::kFrameEventCapacity, events.size());
+  EXPECT_EQ(FrameId(0), events.front().frame_id);
+  EXPECT_EQ(FrameId(StatisticsCollector::kFrameEventCapacity - 1),
+            events.back().frame_id);
+
+  collector_.CollectFrameEvent(event);
+  collector_.TakeRecentFrameEvents(&events);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_EQ(3u, collector_.dropped_frame_events());
+}
+
 }  // namespace openscreen::cast
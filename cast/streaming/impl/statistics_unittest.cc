@@ -55,4 +55,34 @@ TEST_F(StatisticsTest, SimpleHistogramSerialization) {
   EXPECT_EQ(kExpected, serialized);
 }
 
+TEST_F(StatisticsTest, LatencyQuantilesSerialization) {
+  constexpr LatencyQuantiles kQuantiles{.count = 3, .p50_ms = 1, .p90_ms = 2,
+                                        .p95_ms = 3, .p99_ms = 4, .max_ms = 5};
+  SenderStats stats;
+  stats.video_latency_quantiles[static_cast<int>(
+      LatencyType::kEndToEndLatencyMs)] = kQuantiles;
+
+  const Json::Value json = stats.ToJson();
+  const Json::Value& quantiles =
+      json["video_latency_quantiles"]["EndToEndLatencyMs"];
+  EXPECT_EQ(3, quantiles["count"].asInt64());
+  EXPECT_EQ(1, quantiles["p50"].asDouble());
+  EXPECT_EQ(2, quantiles["p90"].asDouble());
+  EXPECT_EQ(3, quantiles["p95"].asDouble());
+  EXPECT_EQ(4, quantiles["p99"].asDouble());
+  EXPECT_EQ(5, quantiles["max"].asDouble());
+  EXPECT_EQ(0, json["audio_latency_quantiles"]["EndToEndLatencyMs"]["count"]
+                   .asInt64());
+}
+
+TEST_F(StatisticsTest, DroppedEventsSerialization) {
+  SenderStats stats;
+  stats.dropped_packet_events = 7;
+  stats.dropped_frame_events = 2;
+
+  const Json::Value json = stats.ToJson();
+  EXPECT_EQ(7u, json["dropped_packet_events"].asUInt64());
+  EXPECT_EQ(2u, json["dropped_frame_events"].asUInt64());
+}
+
 }  // namespace openscreen::cast
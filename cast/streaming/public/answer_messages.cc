@@ -108,6 +108,9 @@ constexpr char kReceiverRtcpDscp[] = "receiverRtcpDscp";
 // If this optional field is present the receiver supports the specific
 // RTP extensions (such as adaptive playout delay).
 constexpr char kRtpExtensions[] = "rtpExtensions";
+// Optional array of numbers specifying the indexes of streams for which the
+// receiver accepts the Forward Error Correction offered in the OFFER message.
+constexpr char kReceiverFec[] = "receiverFec";
 constexpr char kDataTransport[] = "dataTransport";
 constexpr char kProtocol[] = "protocol";
 constexpr char kPort[] = "port";
@@ -496,6 +499,7 @@ ErrorOr<Answer> Answer::TryParse(const Json::Value& root) {
   json::TryParseIntArray(root[kReceiverRtcpEventLog],
                          &out.receiver_rtcp_event_log);
   json::TryParseIntArray(root[kReceiverRtcpDscp], &out.receiver_rtcp_dscp);
+  json::TryParseIntArray(root[kReceiverFec], &out.receiver_fec);
   json::TryParseNestedStringArray(root[kRtpExtensions], &out.rtp_extensions);
 
   if (root.isMember(kDataTransport)) {
@@ -559,6 +563,9 @@ Json::Value Answer::ToJson() const {
   if (!receiver_rtcp_dscp.empty()) {
     root[kReceiverRtcpDscp] = json::PrimitiveVectorToJson(receiver_rtcp_dscp);
   }
+  if (!receiver_fec.empty()) {
+    root[kReceiverFec] = json::PrimitiveVectorToJson(receiver_fec);
+  }
   if (!rtp_extensions.empty()) {
     root[kRtpExtensions] = json::NestedStringArrayToJson(rtp_extensions);
   }
@@ -138,6 +138,10 @@ struct Answer {
   // Optional configuration for an accepted data transport (e.g., WebTransport).
   // Included in the ANSWER when data channel negotiation succeeds.
   std::optional<DataTransportConfig> data_transport;
+
+  // The indexes of the offered streams for which the receiver accepts Forward
+  // Error Correction parity packets.
+  std::vector<int> receiver_fec;
 };
 
 }  // namespace openscreen::cast
@@ -22,6 +22,12 @@ namespace openscreen::cast {
 // capture from the source until presentation at the receiver.
 inline constexpr std::chrono::milliseconds kDefaultTargetPlayoutDelay(400);
 
+// The range within which the Receiver may adapt the target playout delay.
+struct PlayoutDelayBounds {
+  std::chrono::milliseconds min;
+  std::chrono::milliseconds max;
+};
+
 // Default UDP port, bound at the Receiver, for Cast Streaming. An
 // implementation is required to use the port specified by the Receiver in its
 // ANSWER control message, which may or may not match this port number here.
@@ -48,6 +54,11 @@ inline constexpr int kMaxUnackedFrames = 120;
 // The network must support a packet size of at least this many bytes.
 inline constexpr int kRequiredNetworkPacketSize = 256;
 
+// The largest number of RTP packets that a single Forward Error Correction
+// parity packet may protect. Larger groups have less overhead, but are less
+// likely to be recoverable.
+inline constexpr int kMaxFecGroupSize = 64;
+
 // The spec declares RTP timestamps must always have a timebase of 90000 ticks
 // per second for video.
 inline constexpr int kRtpVideoTimebase = 90000;
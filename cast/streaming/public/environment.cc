@@ -14,6 +14,29 @@
 
 namespace openscreen::cast {
 
+namespace {
+
+// The maximum number of unused packet buffers kept around for reuse. This
+// covers several frames' worth of packets at high bitrates, while bounding the
+// idle memory to well under 1 MB.
+constexpr size_t kMaxPooledPacketBuffers = 512;
+
+// The maximum number of packets read from the socket per wakeup. At high
+// bitrates, packets arrive in bursts, which this drains with a few system calls
+// instead of one per packet.
+constexpr size_t kReceiveBatchSize = 16;
+
+}  // namespace
+
+void Environment::PacketConsumer::OnReceivedPackets(
+    Clock::time_point arrival_time,
+    std::span<UdpPacket> packets) {
+  for (UdpPacket& packet : packets) {
+    const IPEndpoint source = packet.source();
+    OnReceivedPacket(source, arrival_time, std::move(packet));
+  }
+}
+
 Environment::PacketConsumer::~PacketConsumer() = default;
 
 Environment::SocketSubscriber::~SocketSubscriber() = default;
@@ -21,7 +44,11 @@ Environment::SocketSubscriber::~SocketSubscriber() = default;
 Environment::Environment(ClockNowFunctionPtr now_function,
                          TaskRunner& task_runner,
                          const IPEndpoint& local_endpoint)
-    : now_function_(now_function), task_runner_(task_runner) {
+    : now_function_(now_function),
+      task_runner_(task_runner),
+      packet_pool_(
+          UdpPacketPool::Create(kMaxPooledPacketBuffers,
+                                kMaxRtpPacketSizeForIpv4UdpOnEthernet)) {
   OSP_CHECK(now_function_);
   ErrorOr<std::unique_ptr<UdpSocket>> result =
       UdpSocket::Create(*task_runner_, this, local_endpoint);
@@ -32,6 +59,8 @@ Environment::Environment(ClockNowFunctionPtr now_function,
   }
   const_cast<std::unique_ptr<UdpSocket>&>(socket_) = std::move(result.value());
   OSP_CHECK(socket_);
+  socket_->SetPacketPool(packet_pool_);
+  socket_->SetReceiveBatchSize(kReceiveBatchSize);
   socket_->Bind();
 }
 
@@ -78,6 +107,10 @@ void Environment::DropIncomingPackets() {
   packet_consumer_ = nullptr;
 }
 
+UdpPacketPool::Stats Environment::GetPacketPoolStats() const {
+  return packet_pool_->GetStats();
+}
+
 int Environment::GetMaxPacketSize() const {
   // Return hard-coded values for UDP over wired Ethernet (which is a smaller
   // MTU than typical defaults for UDP over 802.11 wireless). Performance would
@@ -99,6 +132,12 @@ void Environment::SetDscp(UdpSocket::DscpMode mode) {
   }
 }
 
+void Environment::SetReceiveBatchSize(size_t max_packets) {
+  if (socket_) {
+    socket_->SetReceiveBatchSize(max_packets);
+  }
+}
+
 void Environment::SetReceiveBufferSize(size_t size) {
   if (socket_) {
     socket_->SetReceiveBufferSize(size);
@@ -122,6 +161,30 @@ void Environment::SendPacket(ByteView packet, PacketMetadata metadata) {
   }
 }
 
+void Environment::SendPackets(
+    std::span<const UdpSocket::GatheredMessage> packets,
+    std::span<const PacketMetadata> metadata) {
+  SendPacketsTo(remote_endpoint_, packets, metadata);
+}
+
+void Environment::SendPacketsTo(
+    const IPEndpoint& destination,
+    std::span<const UdpSocket::GatheredMessage> packets,
+    std::span<const PacketMetadata> metadata) {
+  OSP_CHECK_EQ(packets.size(), metadata.size());
+  OSP_CHECK(destination.address);
+  OSP_CHECK_NE(destination.port, 0);
+  if (socket_) {
+    socket_->SendGatheredMessages(packets, destination);
+  }
+  if (statistics_collector_) {
+    for (size_t i = 0; i < packets.size(); ++i) {
+      statistics_collector_->CollectPacketSentEvent(
+          packets[i].header, packets[i].payload, metadata[i]);
+    }
+  }
+}
+
 void Environment::OnBound(UdpSocket* socket) {
   OSP_CHECK_EQ(socket, socket_.get());
   state_ = SocketState::kReady;
@@ -175,9 +238,20 @@ void Environment::OnRead(UdpSocket* socket,
   const Clock::time_point arrival_time = now_function_();
 
   UdpPacket packet = std::move(packet_or_error.value());
-  packet_consumer_->OnReceivedPacket(
-      packet.source(), arrival_time,
-      std::move(static_cast<std::vector<uint8_t>&>(packet)));
+  const IPEndpoint source = packet.source();
+  packet_consumer_->OnReceivedPacket(source, arrival_time, std::move(packet));
+}
+
+void Environment::OnReadBatch(UdpSocket* socket,
+                              std::vector<UdpPacket> packets) {
+  // All packets in the batch were read by the same system call, so they share
+  // an arrival time. See comments in OnRead().
+  const Clock::time_point arrival_time = now_function_();
+
+  if (!packet_consumer_) {
+    return;
+  }
+  packet_consumer_->OnReceivedPackets(arrival_time, packets);
 }
 
 }  // namespace openscreen::cast
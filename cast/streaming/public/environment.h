@@ -16,6 +16,8 @@
 #include "platform/api/udp_socket.h"
 #include "platform/base/ip_address.h"
 #include "platform/base/span.h"
+#include "platform/base/udp_packet.h"
+#include "platform/base/udp_packet_pool.h"
 #include "util/raw_ptr.h"
 #include "util/raw_ref.h"
 
@@ -29,7 +31,15 @@ class Environment : public UdpSocket::Client {
    public:
     virtual void OnReceivedPacket(const IPEndpoint& source,
                                   Clock::time_point arrival_time,
-                                  std::vector<uint8_t> packet) = 0;
+                                  UdpPacket packet) = 0;
+
+    // Called with all the packets of one batched read of the socket (see
+    // SetReceiveBatchSize()), which share the same `arrival_time`. The default
+    // implementation calls OnReceivedPacket() for each, so a consumer that
+    // calls DropIncomingPackets() part-way through a batch still receives the
+    // rest of it.
+    virtual void OnReceivedPackets(Clock::time_point arrival_time,
+                                   std::span<UdpPacket> packets);
 
    protected:
     virtual ~PacketConsumer();
@@ -121,6 +131,11 @@ class Environment : public UdpSocket::Client {
   // call to ConsumeIncomingPackets() are cleared.
   void DropIncomingPackets();
 
+  // Returns the allocation statistics for the pool that incoming packets'
+  // buffers are recycled through. Once streaming reaches a steady state,
+  // `heap_allocations` should stop increasing.
+  UdpPacketPool::Stats GetPacketPoolStats() const;
+
   // Returns the maximum packet size for the network. This will always return a
   // value of at least kRequiredNetworkPacketSize.
   int GetMaxPacketSize() const;
@@ -128,6 +143,11 @@ class Environment : public UdpSocket::Client {
   // Sets the DSCP value for the underlying UDP socket.
   void SetDscp(UdpSocket::DscpMode mode);
 
+  // Sets the maximum number of packets read from the underlying UDP socket per
+  // wakeup. Batched reads are enabled by default; passing 1 disables them. See
+  // UdpSocket::SetReceiveBatchSize().
+  void SetReceiveBatchSize(size_t max_packets);
+
   // Sets the receive and send buffer sizes for the underlying UDP socket.
   // These should typically be called during session initialization before
   // streaming begins.
@@ -141,16 +161,43 @@ class Environment : public UdpSocket::Client {
   // before they actually head-out through the socket.
   virtual void SendPacket(ByteView packet, PacketMetadata metadata);
 
+  // Sends the given `packets` to the remote endpoint, in order and best-effort,
+  // using as few system calls as the platform allows. Each packet's header and
+  // payload are gathered by the socket, rather than copied together first.
+  // `metadata` holds the metadata for each of the `packets`.
+  // set_remote_endpoint() must be called beforehand with a valid IPEndpoint.
+  //
+  // Note: This method is virtual to allow unit tests to intercept packets
+  // before they actually head-out through the socket.
+  virtual void SendPackets(std::span<const UdpSocket::GatheredMessage> packets,
+                           std::span<const PacketMetadata> metadata);
+
+  // Like SendPackets(), but sends the `packets` to the given `destination`
+  // instead of the remote endpoint. This allows one Environment, and its
+  // socket, to be shared by Senders streaming to several Receivers.
+  //
+  // Note: This method is virtual to allow unit tests to intercept packets
+  // before they actually head-out through the socket.
+  virtual void SendPacketsTo(
+      const IPEndpoint& destination,
+      std::span<const UdpSocket::GatheredMessage> packets,
+      std::span<const PacketMetadata> metadata);
+
  private:
   // UdpSocket::Client implementation.
   void OnBound(UdpSocket* socket) final;
   void OnError(UdpSocket* socket, const Error& error) final;
   void OnSendError(UdpSocket* socket, const Error& error) final;
   void OnRead(UdpSocket* socket, ErrorOr<UdpPacket> packet_or_error) final;
+  void OnReadBatch(UdpSocket* socket, std::vector<UdpPacket> packets) final;
 
   ClockNowFunctionPtr now_function_;
   const raw_ref<TaskRunner> task_runner_;
 
+  // Incoming packets are acquired from this pool, and their buffers return to
+  // it once the PacketConsumer is done with them.
+  const std::shared_ptr<UdpPacketPool> packet_pool_;
+
   // The UDP socket bound to the local endpoint that was passed into the
   // constructor, or null if socket creation failed.
   const std::unique_ptr<UdpSocket> socket_;
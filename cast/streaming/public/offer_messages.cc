@@ -234,6 +234,12 @@ ErrorOr<Stream> Stream::TryParse(const Json::Value& value, Stream::Type type) {
   json::TryParseStringArray(value["rtpExtensions"], &out.rtp_extensions);
   json::TryParseString(value["codecParameter"], &out.codec_parameter);
 
+  if (json::TryParseInt(value["fecGroupSize"], &out.fec_group_size) &&
+      out.fec_group_size > kMaxFecGroupSize) {
+    return Error(Error::Code::kJsonParseError,
+                 "fecGroupSize (invalid FEC group size)");
+  }
+
   return out;
 }
 
@@ -263,13 +269,17 @@ Json::Value Stream::ToJson() const {
   if (!rtp_extensions.empty()) {
     root["rtpExtensions"] = json::PrimitiveVectorToJson(rtp_extensions);
   }
+  if (fec_group_size > 0) {
+    root["fecGroupSize"] = fec_group_size;
+  }
   return root;
 }
 
 bool Stream::IsValid() const {
   return channels >= 1 && index >= 0 && target_delay.count() > 0 &&
          target_delay.count() <= std::numeric_limits<int>::max() &&
-         rtp_timebase >= 1;
+         rtp_timebase >= 1 && fec_group_size >= 0 &&
+         fec_group_size <= kMaxFecGroupSize;
 }
 
 ErrorOr<AudioStream> AudioStream::TryParse(const Json::Value& value) {
@@ -72,6 +72,11 @@ struct Stream {
   std::string codec_parameter;
 
   std::vector<std::string> rtp_extensions;
+
+  // If > 0, the sender offers to send a Forward Error Correction parity packet
+  // after every group of this many RTP packets of a frame. The receiver accepts
+  // by listing the stream's index in the ANSWER's receiverFec field.
+  int fec_group_size = 0;
 };
 
 struct AudioStream {
@@ -4,6 +4,9 @@
 
 #include "cast/streaming/public/receiver.h"
 
+#include "cast/streaming/public/encoded_frame.h"
+#include "util/osp_logging.h"
+
 namespace openscreen::cast {
 
 Receiver::Consumer::~Consumer() = default;
@@ -12,4 +15,13 @@ Receiver::Receiver() = default;
 
 Receiver::~Receiver() = default;
 
+EncodedFrame Receiver::TakeNextFrame(std::vector<uint8_t>* buffer) {
+  // The caller has already advanced to the next frame, so this only looks up
+  // its size again.
+  const std::optional<size_t> next_frame_size = AdvanceToNextFrame();
+  OSP_CHECK(next_frame_size);
+  buffer->resize(*next_frame_size);
+  return ConsumeNextFrame(*buffer);
+}
+
 }  // namespace openscreen::cast
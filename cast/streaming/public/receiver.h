@@ -6,6 +6,8 @@
 #define CAST_STREAMING_PUBLIC_RECEIVER_H_
 
 #include <chrono>
+#include <optional>
+#include <vector>
 
 #include "cast/streaming/public/encoded_frame.h"
 #include "cast/streaming/public/session_config.h"
@@ -123,7 +125,8 @@ class Receiver {
   // for consumption. The caller should wait for a Consumer::OnFramesReady()
   // notification before trying again. Otherwise, the number of bytes of encoded
   // data is returned, and the caller should use this to ensure the buffer it
-  // passes to ConsumeNextFrame() is large enough.
+  // passes to ConsumeNextFrame() is large enough. Once a frame is ready, this
+  // method returns the same result until that frame is consumed.
   virtual std::optional<size_t> AdvanceToNextFrame() = 0;
 
   // Returns the next frame, both metadata and payload data. The Consumer calls
@@ -134,6 +137,16 @@ class Receiver {
   // `data` will be set to the portion of the buffer that was populated.
   virtual EncodedFrame ConsumeNextFrame(ByteBuffer buffer) = 0;
 
+  // Like ConsumeNextFrame(), but instead of copying the payload data into a
+  // caller-provided buffer, hands over the buffer the Receiver assembled the
+  // frame in, by moving it into `*buffer` (whose previous contents are
+  // discarded). The returned frame's `data` points into `*buffer`. As with
+  // ConsumeNextFrame(), this must only be called after AdvanceToNextFrame() has
+  // indicated that a frame is ready. The default implementation resizes
+  // `*buffer` to the size AdvanceToNextFrame() returns and calls
+  // ConsumeNextFrame().
+  virtual EncodedFrame TakeNextFrame(std::vector<uint8_t>* buffer);
+
   // The default "player processing time" amount. See SetPlayerProcessingTime().
   // This value is based on real world experimentation, however may vary
   // widely depending on the platform of the receiver and what type of
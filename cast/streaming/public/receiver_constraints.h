@@ -7,6 +7,7 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "cast/streaming/public/constants.h"
@@ -176,6 +177,16 @@ class ReceiverConstraints {
 
   // If true, the receiver supports sending input events to the sender.
   bool supports_input_events = false;
+
+  // If true, the receiver accepts Forward Error Correction for the streams
+  // on which the sender offers it, trading extra bandwidth for fewer
+  // retransmissions on lossy networks.
+  bool supports_fec = false;
+
+  // If set, the receiver adapts the target playout delay of the streams for
+  // which the sender offers it, within these bounds, to the network jitter and
+  // the rate of late frames (see SessionConfig::adaptive_playout_delay).
+  std::optional<PlayoutDelayBounds> adaptive_playout_delay;
 };
 
 }  // namespace openscreen::cast
@@ -435,6 +435,12 @@ std::unique_ptr<Receiver> ReceiverSession::ConstructReceiver(
                        stream.channels, stream.target_delay, stream.aes_key,
                        stream.aes_iv_mask, /* is_pli_enabled */ true,
                        StreamType::kUnknown, stream.receiver_rtcp_event_log);
+  if (constraints_.supports_fec) {
+    config.fec_group_size = stream.fec_group_size;
+  }
+  if (AcceptsAdaptivePlayoutDelay(stream)) {
+    config.adaptive_playout_delay = constraints_.adaptive_playout_delay;
+  }
   if (!config.IsValid()) {
     return nullptr;
   }
@@ -442,6 +448,11 @@ std::unique_ptr<Receiver> ReceiverSession::ConstructReceiver(
                                         std::move(config));
 }
 
+bool ReceiverSession::AcceptsAdaptivePlayoutDelay(const Stream& stream) const {
+  return constraints_.adaptive_playout_delay &&
+         Contains(stream.rtp_extensions, kAdaptivePlayoutDelayRtpExtension);
+}
+
 ReceiverSession::ConfiguredReceivers ReceiverSession::SpawnReceivers(
     const PendingOffer& properties) {
   OSP_CHECK(properties.IsValid());
@@ -577,17 +588,43 @@ Answer ReceiverSession::ConstructAnswer(const PendingOffer& properties) {
     stream_ssrcs.push_back(properties.selected_video->stream.ssrc + 1);
   }
 
+  std::vector<int> receiver_fec;
+  if (constraints_.supports_fec) {
+    if (properties.selected_audio &&
+        properties.selected_audio->stream.fec_group_size > 0) {
+      receiver_fec.push_back(properties.selected_audio->stream.index);
+    }
+    if (properties.selected_video &&
+        properties.selected_video->stream.fec_group_size > 0) {
+      receiver_fec.push_back(properties.selected_video->stream.index);
+    }
+  }
+
+  // The accepted RTP extensions of each stream, in the order of
+  // `stream_indexes`. Omitted entirely if no extension was accepted.
   std::vector<std::vector<std::string>> rtp_extensions;
-  if (constraints_.supports_input_events) {
-    const bool sender_requested_input_events =
-        properties.selected_video &&
+  bool accepted_any_rtp_extension = false;
+  if (properties.selected_audio) {
+    std::vector<std::string>& audio_extensions = rtp_extensions.emplace_back();
+    if (AcceptsAdaptivePlayoutDelay(properties.selected_audio->stream)) {
+      audio_extensions.push_back(kAdaptivePlayoutDelayRtpExtension);
+    }
+    accepted_any_rtp_extension |= !audio_extensions.empty();
+  }
+  if (properties.selected_video) {
+    std::vector<std::string>& video_extensions = rtp_extensions.emplace_back();
+    if (constraints_.supports_input_events &&
         Contains(properties.selected_video->stream.rtp_extensions,
-                 kInputEventsRtpExtension);
-
-    if (sender_requested_input_events) {
-      rtp_extensions.emplace_back();
-      rtp_extensions.push_back({kInputEventsRtpExtension});
+                 kInputEventsRtpExtension)) {
+      video_extensions.push_back(kInputEventsRtpExtension);
+    }
+    if (AcceptsAdaptivePlayoutDelay(properties.selected_video->stream)) {
+      video_extensions.push_back(kAdaptivePlayoutDelayRtpExtension);
     }
+    accepted_any_rtp_extension |= !video_extensions.empty();
+  }
+  if (!accepted_any_rtp_extension) {
+    rtp_extensions.clear();
   }
 
   return Answer{
@@ -598,9 +635,8 @@ Answer ReceiverSession::ConstructAnswer(const PendingOffer& properties) {
       .display = std::move(display),
       .receiver_rtcp_event_log = std::move(stream_indexes_with_events),
       .receiver_rtcp_dscp = receiver_rtcp_dscp,
-
-      // TODO(crbug.com/40238532): re-add support for adaptive playout delay??
-      .rtp_extensions = std::move(rtp_extensions)};
+      .rtp_extensions = std::move(rtp_extensions),
+      .receiver_fec = std::move(receiver_fec)};
 }
 
 ReceiverCapability ReceiverSession::CreateRemotingCapabilityV2() {
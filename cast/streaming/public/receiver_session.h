@@ -228,6 +228,10 @@ class ReceiverSession final : public Environment::SocketSubscriber {
   // Used by SpawnReceivers to generate a receiver for a specific stream.
   std::unique_ptr<Receiver> ConstructReceiver(const Stream& stream);
 
+  // Returns true if the sender offered to let the receiver adapt the target
+  // playout delay of `stream`, and the constraints allow it.
+  bool AcceptsAdaptivePlayoutDelay(const Stream& stream) const;
+
   // Creates a set of configured receivers from a given pair of audio and
   // video streams. NOTE: either audio or video may be null, but not both.
   ConfiguredReceivers SpawnReceivers(const PendingOffer& properties);
@@ -0,0 +1,267 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/public/sender_engine.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <optional>
+#include <utility>
+
+#include "cast/streaming/impl/sender_impl.h"
+#include "cast/streaming/sender_packet_router.h"
+#include "platform/api/task_runner.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+
+// The state of a channel that is shared by its Senders on all shards.
+struct SenderEngine::ChannelState {
+  // The number of the channel's Senders that need a key frame. Updated by the
+  // shards and read by NeedsKeyFrame().
+  std::atomic<int> num_senders_needing_key_frame{0};
+
+  // The number of the channel's Senders pinned to each shard. Only accessed on
+  // the thread calling the SenderEngine's public methods.
+  std::vector<int> num_senders_per_shard;
+};
+
+// A Sender pinned to a shard, and the state of its view of the channel. Like
+// every new Sender, it starts off needing a key frame, which AddSender() has
+// already counted.
+struct SenderEngine::ShardSender {
+  ShardSender(SenderId id,
+              std::shared_ptr<ChannelState> channel_state,
+              std::unique_ptr<SenderImpl> sender)
+      : id(id),
+        channel_state(std::move(channel_state)),
+        sender(std::move(sender)) {}
+
+  ~ShardSender() { SetNeedsKeyFrame(false); }
+
+  void SetNeedsKeyFrame(bool needs) {
+    if (needs != needs_key_frame) {
+      needs_key_frame = needs;
+      channel_state->num_senders_needing_key_frame.fetch_add(
+          needs ? 1 : -1, std::memory_order_relaxed);
+    }
+  }
+
+  const SenderId id;
+  const std::shared_ptr<ChannelState> channel_state;
+  const std::unique_ptr<SenderImpl> sender;
+
+  // The channel's frame ID minus the Sender's frame ID for the same frame, or
+  // nullopt if the Sender must wait for the next key frame.
+  std::optional<int64_t> frame_id_offset;
+
+  bool needs_key_frame = true;
+};
+
+class SenderEngine::Shard {
+ public:
+  Shard(std::unique_ptr<Environment> environment, int max_burst_bitrate)
+      : environment_(std::move(environment)),
+        packet_router_(*environment_, max_burst_bitrate) {}
+
+  ~Shard() {
+    // Senders must be destroyed before the SenderPacketRouter.
+    senders_.clear();
+  }
+
+  TaskRunner& task_runner() const { return environment_->task_runner(); }
+
+  // The number of Senders pinned to this shard. Only accessed on the thread
+  // calling the SenderEngine's public methods.
+  int num_senders = 0;
+
+  // The remaining methods are only called on task_runner().
+
+  void AddSender(SenderId id,
+                 std::shared_ptr<ChannelState> channel_state,
+                 const IPEndpoint& remote_endpoint,
+                 const SessionConfig& config,
+                 RtpPayloadType rtp_payload_type) {
+    senders_.push_back(std::make_unique<ShardSender>(
+        id, std::move(channel_state),
+        std::make_unique<SenderImpl>(*environment_, packet_router_, config,
+                                     rtp_payload_type, remote_endpoint)));
+  }
+
+  void RemoveSender(SenderId id) {
+    const auto it = std::find_if(
+        senders_.begin(), senders_.end(),
+        [id](const std::unique_ptr<ShardSender>& s) { return s->id == id; });
+    OSP_CHECK(it != senders_.end());
+    senders_.erase(it);
+  }
+
+  void PublishFrame(const ChannelState* channel_state,
+                    const EncodedFrame& frame) {
+    for (const std::unique_ptr<ShardSender>& s : senders_) {
+      if (s->channel_state.get() == channel_state) {
+        EnqueueFrame(*s, frame);
+      }
+    }
+  }
+
+ private:
+  void EnqueueFrame(ShardSender& s, const EncodedFrame& frame) {
+    // If the channel skipped a frame ID, the Sender can no longer follow the
+    // frames' dependencies.
+    if (s.frame_id_offset &&
+        frame.frame_id - *s.frame_id_offset != s.sender->GetNextFrameId()) {
+      s.frame_id_offset.reset();
+    }
+    if (!s.frame_id_offset) {
+      if (frame.dependency != EncodedFrame::Dependency::kKeyFrame) {
+        s.SetNeedsKeyFrame(true);
+        return;
+      }
+      s.frame_id_offset = frame.frame_id - s.sender->GetNextFrameId();
+    }
+
+    // Enqueue a copy of the frame's metadata, renumbered for the Sender, that
+    // refers to the shared payload.
+    EncodedFrame sender_frame;
+    frame.CopyMetadataTo(&sender_frame);
+    sender_frame.frame_id = frame.frame_id - *s.frame_id_offset;
+    sender_frame.referenced_frame_id =
+        frame.referenced_frame_id - *s.frame_id_offset;
+    sender_frame.data = frame.data;
+    if (s.sender->EnqueueFrame(sender_frame) != Sender::OK) {
+      s.frame_id_offset.reset();
+    }
+    s.SetNeedsKeyFrame(!s.frame_id_offset || s.sender->NeedsKeyFrame());
+  }
+
+  const std::unique_ptr<Environment> environment_;
+  SenderPacketRouter packet_router_;
+  std::vector<std::unique_ptr<ShardSender>> senders_;
+};
+
+SenderEngine::SenderEngine(
+    std::vector<std::unique_ptr<Environment>> shard_environments,
+    int max_burst_bitrate) {
+  OSP_CHECK(!shard_environments.empty());
+  for (std::unique_ptr<Environment>& environment : shard_environments) {
+    OSP_CHECK(environment);
+    shards_.push_back(
+        std::make_unique<Shard>(std::move(environment), max_burst_bitrate));
+  }
+}
+
+SenderEngine::~SenderEngine() {
+  for (std::unique_ptr<Shard>& shard : shards_) {
+    TaskRunner& task_runner = shard->task_runner();
+    if (task_runner.IsRunningOnTaskRunner()) {
+      shard.reset();
+      continue;
+    }
+    std::promise<void> destroy_promise;
+    std::future<void> destroy_future = destroy_promise.get_future();
+    task_runner.PostTask([shard = std::move(shard),
+                          promise = std::move(destroy_promise)]() mutable {
+      shard.reset();
+      promise.set_value();
+    });
+    destroy_future.wait();
+  }
+}
+
+SenderEngine::SenderId SenderEngine::AddSender(
+    ChannelId channel,
+    const IPEndpoint& remote_endpoint,
+    const SessionConfig& config,
+    RtpPayloadType rtp_payload_type) {
+  OSP_CHECK(remote_endpoint.address.IsV4());
+  OSP_CHECK_NE(remote_endpoint.port, 0);
+
+  std::shared_ptr<ChannelState>& channel_state = channels_[channel];
+  if (!channel_state) {
+    channel_state = std::make_shared<ChannelState>();
+    channel_state->num_senders_per_shard.resize(shards_.size());
+  }
+
+  const auto shard_it = std::min_element(
+      shards_.begin(), shards_.end(),
+      [](const std::unique_ptr<Shard>& a, const std::unique_ptr<Shard>& b) {
+        return a->num_senders < b->num_senders;
+      });
+  const size_t shard_index = shard_it - shards_.begin();
+  Shard* const shard = shard_it->get();
+  ++shard->num_senders;
+  ++channel_state->num_senders_per_shard[shard_index];
+  channel_state->num_senders_needing_key_frame.fetch_add(
+      1, std::memory_order_relaxed);
+
+  const SenderId id = next_sender_id_++;
+  senders_.emplace(id, SenderRecord{channel, shard_index});
+  shard->task_runner().PostTask(
+      [shard, id, channel_state, remote_endpoint, config, rtp_payload_type] {
+        shard->AddSender(id, channel_state, remote_endpoint, config,
+                         rtp_payload_type);
+      });
+  return id;
+}
+
+void SenderEngine::RemoveSender(SenderId sender) {
+  const auto it = senders_.find(sender);
+  OSP_CHECK(it != senders_.end());
+  const SenderRecord record = it->second;
+  senders_.erase(it);
+
+  Shard* const shard = shards_[record.shard_index].get();
+  --shard->num_senders;
+  const auto channel_it = channels_.find(record.channel);
+  std::vector<int>& num_senders_per_shard =
+      channel_it->second->num_senders_per_shard;
+  --num_senders_per_shard[record.shard_index];
+  if (std::all_of(num_senders_per_shard.begin(), num_senders_per_shard.end(),
+                  [](int count) { return count == 0; })) {
+    // The shards' Senders, and any frames still being published to them, share
+    // ownership of the ChannelState.
+    channels_.erase(channel_it);
+  }
+
+  shard->task_runner().PostTask(
+      [shard, sender] { shard->RemoveSender(sender); });
+}
+
+size_t SenderEngine::GetShardIndex(SenderId sender) const {
+  const auto it = senders_.find(sender);
+  OSP_CHECK(it != senders_.end());
+  return it->second.shard_index;
+}
+
+void SenderEngine::PublishFrame(ChannelId channel,
+                                std::shared_ptr<const EncodedFrame> frame) {
+  OSP_CHECK(frame);
+  const auto it = channels_.find(channel);
+  if (it == channels_.end()) {
+    return;
+  }
+  const std::shared_ptr<ChannelState>& channel_state = it->second;
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (channel_state->num_senders_per_shard[i] == 0) {
+      continue;
+    }
+    Shard* const shard = shards_[i].get();
+    shard->task_runner().PostTask([shard, channel_state, frame] {
+      shard->PublishFrame(channel_state.get(), *frame);
+    });
+  }
+}
+
+bool SenderEngine::NeedsKeyFrame(ChannelId channel) const {
+  const auto it = channels_.find(channel);
+  return it != channels_.end() &&
+         it->second->num_senders_needing_key_frame.load(
+             std::memory_order_relaxed) > 0;
+}
+
+}  // namespace openscreen::cast
@@ -0,0 +1,111 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAST_STREAMING_PUBLIC_SENDER_ENGINE_H_
+#define CAST_STREAMING_PUBLIC_SENDER_ENGINE_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "cast/streaming/impl/rtp_defines.h"
+#include "cast/streaming/public/encoded_frame.h"
+#include "cast/streaming/public/environment.h"
+#include "cast/streaming/public/session_config.h"
+#include "platform/base/ip_address.h"
+
+namespace openscreen::cast {
+
+// Hosts the Cast Streaming Senders of many Receivers, spreading them across a
+// fixed set of shards so that they can be run by several threads (e.g., one per
+// CPU core).
+//
+// Each shard owns one Environment, and so one UDP socket, and one
+// SenderPacketRouter that schedules the packet bursts of all the Senders pinned
+// to the shard. Senders never move between shards, and everything a shard owns
+// is only ever touched on the TaskRunner of its Environment.
+//
+// Senders are subscribed to a channel, which stands for one source of encoded
+// frames (e.g., the output of one encoder). Frames published to a channel are
+// fanned out to all of its Senders without copying their payload: each Sender
+// encrypts the shared, unencrypted payload directly into its own buffers. Since
+// every Sender numbers its own frames, a Sender that joins late, or falls
+// behind, skips frames until the next key frame.
+//
+// All methods, including the destructor, must be called on the same thread,
+// which should be none of the shards' TaskRunners, since the destructor blocks
+// until they have run their teardown tasks. The shards' TaskRunners must keep
+// running until the SenderEngine is destroyed.
+class SenderEngine {
+ public:
+  using ChannelId = int;
+  using SenderId = int;
+
+  // Creates one shard for each of the `shard_environments`, none of which may
+  // share a TaskRunner. As usual, each Environment must have been created on
+  // its own TaskRunner. Each shard's SenderPacketRouter is shared by all of its
+  // Senders, so `max_burst_bitrate` should allow for their combined bitrate.
+  SenderEngine(std::vector<std::unique_ptr<Environment>> shard_environments,
+               int max_burst_bitrate);
+  SenderEngine(const SenderEngine&) = delete;
+  SenderEngine& operator=(const SenderEngine&) = delete;
+
+  // Blocks until every shard has destroyed its Senders, SenderPacketRouter and
+  // Environment on its own TaskRunner.
+  ~SenderEngine();
+
+  size_t num_shards() const { return shards_.size(); }
+
+  // Adds a Sender streaming the frames of `channel` to the Receiver at
+  // `remote_endpoint`, pinning it to the shard with the fewest Senders. The
+  // `config` and `rtp_payload_type` are as for the SenderImpl constructor.
+  //
+  // Since the shards' Environments have no remote endpoint of their own, their
+  // packets are sized for IPv4, and so `remote_endpoint` must be IPv4.
+  SenderId AddSender(ChannelId channel,
+                     const IPEndpoint& remote_endpoint,
+                     const SessionConfig& config,
+                     RtpPayloadType rtp_payload_type);
+
+  // Stops and destroys the given `sender`.
+  void RemoveSender(SenderId sender);
+
+  // Returns the index of the shard that the given `sender` is pinned to.
+  size_t GetShardIndex(SenderId sender) const;
+
+  // Fans out the given `frame` to every Sender subscribed to `channel`. Frames
+  // must be published with increasing frame IDs and RTP timestamps. The frame's
+  // `data` must remain valid for as long as `frame` is referenced, which may be
+  // after this method returns, as each shard enqueues it on its own TaskRunner.
+  void PublishFrame(ChannelId channel,
+                    std::shared_ptr<const EncodedFrame> frame);
+
+  // Returns true if any of the Senders subscribed to `channel` needs a key
+  // frame, either to join the stream or to resolve a picture loss at its
+  // Receiver. This is updated by the shards each time a frame is published.
+  bool NeedsKeyFrame(ChannelId channel) const;
+
+ private:
+  struct ChannelState;
+  struct ShardSender;
+  class Shard;
+
+  struct SenderRecord {
+    ChannelId channel;
+    size_t shard_index;
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  // The following are only accessed on the thread calling the public methods.
+  std::map<ChannelId, std::shared_ptr<ChannelState>> channels_;
+  std::map<SenderId, SenderRecord> senders_;
+  SenderId next_sender_id_ = 0;
+};
+
+}  // namespace openscreen::cast
+
+#endif  // CAST_STREAMING_PUBLIC_SENDER_ENGINE_H_
@@ -8,12 +8,15 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <utility>
 #include <variant>
 
 #include "cast/streaming/impl/clock_offset_estimator.h"
+#include "cast/streaming/impl/delay_based_congestion_controller.h"
 #include "cast/streaming/impl/message_constants.h"
 #include "cast/streaming/impl/sender_impl.h"
 #include "cast/streaming/message_fields.h"
@@ -27,6 +30,7 @@
 #include "util/json/json_serialization.h"
 #include "util/osp_logging.h"
 #include "util/no_destructor.h"
+#include "util/std_util.h"
 #include "util/stringprintf.h"
 
 namespace openscreen::cast {
@@ -95,19 +99,34 @@ std::optional<int> ToWire(std::optional<UdpSocket::DscpMode> mode) {
   return std::nullopt;
 }
 
+// Converts a FEC overhead ratio into the number of data packets each parity
+// packet protects, or zero if FEC should not be offered.
+int ToFecGroupSize(double fec_overhead_ratio) {
+  if (!(fec_overhead_ratio > 0.0)) {
+    return 0;
+  }
+  return static_cast<int>(std::clamp(std::round(1.0 / fec_overhead_ratio),
+                                     1.0, double{kMaxFecGroupSize}));
+}
+
 AudioStream CreateStream(int index,
                          const AudioCaptureConfig& config,
                          bool use_android_rtp_hack,
                          std::optional<UdpSocket::DscpMode> dscp_mode,
                          bool /* supports_input_events */) {
   std::vector<std::string> rtp_extensions;
+  if (config.adaptive_playout_delay) {
+    rtp_extensions.push_back(kAdaptivePlayoutDelayRtpExtension);
+  }
   return AudioStream{
       Stream{index, Stream::Type::kAudioSource, config.channels,
              GetPayloadType(config.codec, use_android_rtp_hack),
              GenerateSsrc(true /*high_priority*/), config.target_playout_delay,
              GenerateRandomBytes16(), GenerateRandomBytes16(),
              true /* receiver_rtcp_event_log */, ToWire(dscp_mode),
-             config.sample_rate, config.codec_parameter},
+             config.sample_rate, config.codec_parameter,
+             std::move(rtp_extensions),
+             ToFecGroupSize(config.fec_overhead_ratio)},
       config.codec, std::max(config.bit_rate, kDefaultAudioMinBitRate)};
 }
 
@@ -121,6 +140,9 @@ VideoStream CreateStream(int index,
   if (supports_input_events) {
     rtp_extensions.push_back(kInputEventsRtpExtension);
   }
+  if (config.adaptive_playout_delay) {
+    rtp_extensions.push_back(kAdaptivePlayoutDelayRtpExtension);
+  }
   return VideoStream{
       Stream{index, Stream::Type::kVideoSource, kVideoStreamChannelCount,
              GetPayloadType(config.codec, use_android_rtp_hack),
@@ -128,7 +150,8 @@ VideoStream CreateStream(int index,
              GenerateRandomBytes16(), GenerateRandomBytes16(),
              true /* receiver_rtcp_event_log */, ToWire(dscp_mode),
              kRtpVideoTimebase, config.codec_parameter,
-             std::move(rtp_extensions)},
+             std::move(rtp_extensions),
+             ToFecGroupSize(config.fec_overhead_ratio)},
       config.codec,
       config.max_frame_rate,
       (config.max_bit_rate >= kDefaultVideoMinBitRate)
@@ -353,6 +376,12 @@ SenderSession::SenderSession(Configuration config)
                           this->OnInputMessage(std::move(message));
                         });
 
+  if (config_.use_delay_based_congestion_control) {
+    packet_router_.SetCongestionController(
+        std::make_unique<DelayBasedCongestionController>(
+            config_.environment->now()));
+  }
+
   if (config_.udp_receive_buffer_size.has_value()) {
     config_.environment->SetReceiveBufferSize(*config_.udp_receive_buffer_size);
   }
@@ -409,7 +438,7 @@ Error SenderSession::RequestCapabilities() {
 }
 
 int SenderSession::GetEstimatedNetworkBandwidth() const {
-  return packet_router_.ComputeNetworkBandwidth();
+  return packet_router_.congestion_controller().ComputeNetworkBandwidth();
 }
 
 void SenderSession::SetStatsClient(SenderStatsClient* client) {
@@ -597,9 +626,12 @@ void SenderSession::HandleErrorMessage(ReceiverMessage message,
   }
 }
 
-std::unique_ptr<Sender> SenderSession::CreateSender(Ssrc receiver_ssrc,
-                                                    const Stream& stream,
-                                                    RtpPayloadType type) {
+std::unique_ptr<Sender> SenderSession::CreateSender(
+    Ssrc receiver_ssrc,
+    const Stream& stream,
+    RtpPayloadType type,
+    bool use_fec,
+    std::optional<PlayoutDelayBounds> adaptive_playout_delay) {
   // Session config is currently only for mirroring.
   SessionConfig config{stream.ssrc,
                        receiver_ssrc,
@@ -610,6 +642,10 @@ std::unique_ptr<Sender> SenderSession::CreateSender(Ssrc receiver_ssrc,
                        stream.aes_iv_mask,
                        /* is_pli_enabled*/ true,
                        ToStreamType(type, config_.use_android_rtp_hack)};
+  if (use_fec) {
+    config.fec_group_size = stream.fec_group_size;
+  }
+  config.adaptive_playout_delay = adaptive_playout_delay;
   OSP_DCHECK(config.IsValid());
   return std::make_unique<SenderImpl>(*config_.environment, packet_router_,
                                       std::move(config), type);
@@ -618,15 +654,19 @@ std::unique_ptr<Sender> SenderSession::CreateSender(Ssrc receiver_ssrc,
 void SenderSession::SpawnAudioSender(ConfiguredSenders* senders,
                                      Ssrc receiver_ssrc,
                                      int send_index,
-                                     int config_index) {
+                                     int config_index,
+                                     bool use_fec,
+                                     bool use_adaptive_playout_delay) {
   const AudioCaptureConfig& config =
       current_negotiation_->audio_configs[config_index];
   const RtpPayloadType payload_type =
       GetPayloadType(config.codec, config_.use_android_rtp_hack);
   for (const AudioStream& stream : current_negotiation_->offer.audio_streams) {
     if (stream.stream.index == send_index) {
-      senders->audio_sender =
-          CreateSender(receiver_ssrc, stream.stream, payload_type);
+      senders->audio_sender = CreateSender(
+          receiver_ssrc, stream.stream, payload_type, use_fec,
+          use_adaptive_playout_delay ? config.adaptive_playout_delay
+                                     : std::nullopt);
       senders->audio_config = config;
       break;
     }
@@ -636,15 +676,19 @@ void SenderSession::SpawnAudioSender(ConfiguredSenders* senders,
 void SenderSession::SpawnVideoSender(ConfiguredSenders* senders,
                                      Ssrc receiver_ssrc,
                                      int send_index,
-                                     int config_index) {
+                                     int config_index,
+                                     bool use_fec,
+                                     bool use_adaptive_playout_delay) {
   const VideoCaptureConfig& config =
       current_negotiation_->video_configs[config_index];
   const RtpPayloadType payload_type =
       GetPayloadType(config.codec, config_.use_android_rtp_hack);
   for (const VideoStream& stream : current_negotiation_->offer.video_streams) {
     if (stream.stream.index == send_index) {
-      senders->video_sender =
-          CreateSender(receiver_ssrc, stream.stream, payload_type);
+      senders->video_sender = CreateSender(
+          receiver_ssrc, stream.stream, payload_type, use_fec,
+          use_adaptive_playout_delay ? config.adaptive_playout_delay
+                                     : std::nullopt);
       senders->video_config = config;
       break;
     }
@@ -672,14 +716,21 @@ SenderSession::ConfiguredSenders SenderSession::SelectSenders(
   for (size_t i = 0; i < answer.send_indexes.size(); ++i) {
     const Ssrc receiver_ssrc = answer.ssrcs[i];
     const size_t send_index = static_cast<size_t>(answer.send_indexes[i]);
+    const bool use_fec = Contains(answer.receiver_fec, answer.send_indexes[i]);
+    // The ANSWER's RTP extensions, if any, follow the order of its streams.
+    const bool use_adaptive_playout_delay =
+        i < answer.rtp_extensions.size() &&
+        Contains(answer.rtp_extensions[i], kAdaptivePlayoutDelayRtpExtension);
 
     const auto audio_size = current_negotiation_->audio_configs.size();
     const auto video_size = current_negotiation_->video_configs.size();
     if (send_index < audio_size) {
-      SpawnAudioSender(&senders, receiver_ssrc, send_index, send_index);
+      SpawnAudioSender(&senders, receiver_ssrc, send_index, send_index,
+                       use_fec, use_adaptive_playout_delay);
     } else if (send_index < (audio_size + video_size)) {
       SpawnVideoSender(&senders, receiver_ssrc, send_index,
-                       send_index - audio_size);
+                       send_index - audio_size, use_fec,
+                       use_adaptive_playout_delay);
     }
   }
   return senders;
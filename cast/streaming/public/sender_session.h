@@ -136,6 +136,12 @@ class SenderSession final {
     // in and experiment as desired.
     bool enable_dscp = false;
 
+    // If true, the bandwidth estimate (see GetEstimatedNetworkBandwidth()) is
+    // computed by a delay-based congestion controller, which reacts to growing
+    // queueing delay before the network starts dropping packets. This is off
+    // by default to allow embedders to opt in and experiment as desired.
+    bool use_delay_based_congestion_control = false;
+
     // Optional override for the UDP socket receive buffer size.
     // If set to > 0, sets SO_RCVBUF on the socket.
     std::optional<size_t> udp_receive_buffer_size;
@@ -260,20 +266,30 @@ class SenderSession final {
   // instead.
   void HandleErrorMessage(ReceiverMessage message, const Error& default_error);
 
-  // Used by SelectSenders to generate a sender for a specific stream.
-  std::unique_ptr<Sender> CreateSender(Ssrc receiver_ssrc,
-                                       const Stream& stream,
-                                       RtpPayloadType type);
+  // Used by SelectSenders to generate a sender for a specific stream. If
+  // `use_fec` is true, the receiver accepted the FEC offered for the stream.
+  // If `adaptive_playout_delay` is set, the receiver accepted adapting the
+  // stream's target playout delay, within these bounds.
+  std::unique_ptr<Sender> CreateSender(
+      Ssrc receiver_ssrc,
+      const Stream& stream,
+      RtpPayloadType type,
+      bool use_fec,
+      std::optional<PlayoutDelayBounds> adaptive_playout_delay);
 
   // Helper methods for spawning specific senders from the Answer message.
   void SpawnAudioSender(ConfiguredSenders* senders,
                         Ssrc receiver_ssrc,
                         int send_index,
-                        int config_index);
+                        int config_index,
+                        bool use_fec,
+                        bool use_adaptive_playout_delay);
   void SpawnVideoSender(ConfiguredSenders* senders,
                         Ssrc receiver_ssrc,
                         int send_index,
-                        int config_index);
+                        int config_index,
+                        bool use_fec,
+                        bool use_adaptive_playout_delay);
 
   // Spawn a set of configured senders from the currently stored negotiation.
   ConfiguredSenders SelectSenders(const Answer& answer);
@@ -51,6 +51,9 @@ bool SessionConfig::IsValid() const {
   return sender_ssrc > 0 && receiver_ssrc > 0 && rtp_timebase > 0 &&
          channels > 0 &&
          std::any_of(aes_secret_key.begin(), aes_secret_key.end(), IsNonZero) &&
-         std::any_of(aes_iv_mask.begin(), aes_iv_mask.end(), IsNonZero);
+         std::any_of(aes_iv_mask.begin(), aes_iv_mask.end(), IsNonZero) &&
+         (!adaptive_playout_delay ||
+          (adaptive_playout_delay->min > std::chrono::milliseconds::zero() &&
+           adaptive_playout_delay->min <= adaptive_playout_delay->max));
 }
 }  // namespace openscreen::cast
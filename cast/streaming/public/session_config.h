@@ -82,6 +82,21 @@ struct SessionConfig final {
 
   // Optional override for the maximum in-flight media duration.
   std::optional<std::chrono::milliseconds> max_in_flight_media_duration;
+
+  // If > 0, the Sender sends a Forward Error Correction parity packet after
+  // every group of this many RTP packets of a frame, from which the Receiver
+  // can recover one lost packet of the group without a retransmission. Only
+  // set if FEC was negotiated with the Receiver.
+  int fec_group_size = 0;
+
+  // If set, the Receiver adapts the target playout delay, within these bounds,
+  // to the network jitter and the rate of late frames it observes, and requests
+  // each change in its RTCP feedback, which the Sender adopts if it is within
+  // the Sender's own bounds. Set on both sides when negotiated through the
+  // "adaptive_playout_delay" RTP extension in the OFFER/ANSWER. This minimizes
+  // the latency of interactive sessions (e.g., game streaming), for which the
+  // initial target playout delay is usually too conservative.
+  std::optional<PlayoutDelayBounds> adaptive_playout_delay;
 };
 
 }  // namespace openscreen::cast
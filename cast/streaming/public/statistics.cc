@@ -80,6 +80,35 @@ extern const EnumNameTable<HistogramType,
          {"EndToEndLatencyMs", HistogramType::kEndToEndLatencyMs},
          {"FrameLatenessMs", HistogramType::kFrameLatenessMs}}};
 
+// External linkage for unit test
+extern const EnumNameTable<LatencyType,
+                           static_cast<size_t>(LatencyType::kNumTypes)>
+    kLatencyTypeNames = {
+        {{"CaptureLatencyMs", LatencyType::kCaptureLatencyMs},
+         {"EncodeTimeMs", LatencyType::kEncodeTimeMs},
+         {"QueueingLatencyMs", LatencyType::kQueueingLatencyMs},
+         {"NetworkLatencyMs", LatencyType::kNetworkLatencyMs},
+         {"PacketLatencyMs", LatencyType::kPacketLatencyMs},
+         {"FrameLatencyMs", LatencyType::kFrameLatencyMs},
+         {"EndToEndLatencyMs", LatencyType::kEndToEndLatencyMs}}};
+
+bool LatencyQuantiles::operator==(const LatencyQuantiles& other) const {
+  return count == other.count && p50_ms == other.p50_ms &&
+         p90_ms == other.p90_ms && p95_ms == other.p95_ms &&
+         p99_ms == other.p99_ms && max_ms == other.max_ms;
+}
+
+Json::Value LatencyQuantiles::ToJson() const {
+  Json::Value out;
+  out["count"] = static_cast<Json::Int64>(count);
+  out["p50"] = p50_ms;
+  out["p90"] = p90_ms;
+  out["p95"] = p95_ms;
+  out["p99"] = p99_ms;
+  out["max"] = max_ms;
+  return out;
+}
+
 SimpleHistogram::SimpleHistogram() = default;
 SimpleHistogram::SimpleHistogram(int64_t min, int64_t max, int64_t width)
 
@@ -163,6 +192,13 @@ Json::Value SenderStats::ToJson() const {
   out["audio_histograms"] = ArrayToJson(audio_histograms, kHistogramTypeNames);
   out["video_statistics"] = ArrayToJson(video_statistics, kStatisticTypeNames);
   out["video_histograms"] = ArrayToJson(video_histograms, kHistogramTypeNames);
+  out["audio_latency_quantiles"] =
+      ArrayToJson(audio_latency_quantiles, kLatencyTypeNames);
+  out["video_latency_quantiles"] =
+      ArrayToJson(video_latency_quantiles, kLatencyTypeNames);
+  out["dropped_packet_events"] =
+      static_cast<Json::UInt64>(dropped_packet_events);
+  out["dropped_frame_events"] = static_cast<Json::UInt64>(dropped_frame_events);
   return out;
 }
 
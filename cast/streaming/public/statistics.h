@@ -110,6 +110,37 @@ enum class HistogramType {
   kNumTypes = kFrameLatenessMs + 1
 };
 
+// The latency statistics whose quantiles are reported, in addition to their
+// averages (see the corresponding StatisticType).
+enum class LatencyType {
+  kCaptureLatencyMs,
+  kEncodeTimeMs,
+  kQueueingLatencyMs,
+  kNetworkLatencyMs,
+  kPacketLatencyMs,
+  kFrameLatencyMs,
+  kEndToEndLatencyMs,
+
+  // The number of latency types.
+  kNumTypes = kEndToEndLatencyMs + 1
+};
+
+// Quantiles of a latency statistic, in milliseconds, over the session. They are
+// estimates within 1% of the exact values, except for `max_ms`, which is exact.
+struct LatencyQuantiles {
+  bool operator==(const LatencyQuantiles&) const;
+
+  Json::Value ToJson() const;
+
+  // The number of samples. The quantiles are only set if this is non-zero.
+  int64_t count = 0;
+  double p50_ms = 0;
+  double p90_ms = 0;
+  double p95_ms = 0;
+  double p99_ms = 0;
+  double max_ms = 0;
+};
+
 struct SimpleHistogram {
   // This will create N+2 buckets where N = (max - min) / width:
   // Underflow bucket: < min
@@ -159,6 +190,9 @@ struct SenderStats {
   using HistogramsList =
       std::array<SimpleHistogram,
                  static_cast<size_t>(HistogramType::kNumTypes)>;
+  using LatencyQuantilesList =
+      std::array<LatencyQuantiles,
+                 static_cast<size_t>(LatencyType::kNumTypes)>;
 
   // The current audio statistics.
   StatisticsList audio_statistics = {};
@@ -172,6 +206,15 @@ struct SenderStats {
   // The current video histograms.
   HistogramsList video_histograms = {};
 
+  // The current quantiles of the audio and video latencies.
+  LatencyQuantilesList audio_latency_quantiles = {};
+  LatencyQuantilesList video_latency_quantiles = {};
+
+  // The total number of packet and frame events that were dropped instead of
+  // being analyzed, since the analysis fell too far behind the sending.
+  uint64_t dropped_packet_events = 0;
+  uint64_t dropped_frame_events = 0;
+
   Json::Value ToJson() const;
   std::string ToString() const;
 };
@@ -5,12 +5,16 @@
 #include "cast/streaming/sender_packet_router.h"
 
 #include <algorithm>
+#include <limits>
+#include <optional>
 #include <utility>
 
+#include "cast/streaming/impl/bandwidth_estimator.h"
 #include "cast/streaming/impl/packet_util.h"
 #include "cast/streaming/public/constants.h"
 #include "platform/base/span.h"
 #include "util/chrono_helpers.h"
+#include "util/hashing.h"
 #include "util/osp_logging.h"
 #include "util/saturate_cast.h"
 #include "util/stringprintf.h"
@@ -19,6 +23,17 @@ namespace openscreen::cast {
 
 using clock_operators::operator<<;
 
+namespace {
+
+// Upper bound on the number of packets queued before they are handed to the
+// Environment, which bounds the memory used by the packet buffer.
+constexpr int kMaxQueuedPackets = 64;
+
+constexpr int kBitsPerByte = 8;
+constexpr int64_t kMicrosecondsPerSecond = 1'000'000;
+
+}  // namespace
+
 SenderPacketRouter::SenderPacketRouter(Environment& environment,
                                        int max_burst_bitrate)
     : SenderPacketRouter(
@@ -31,28 +46,47 @@ SenderPacketRouter::SenderPacketRouter(Environment& environment,
 SenderPacketRouter::SenderPacketRouter(Environment& environment,
                                        int max_packets_per_burst,
                                        milliseconds burst_interval)
-    : BandwidthEstimator(max_packets_per_burst,
-                         burst_interval,
-                         environment.now()),
-      environment_(environment),
+    : environment_(environment),
       packet_buffer_size_(environment.GetMaxPacketSize()),
-      packet_buffer_(new uint8_t[packet_buffer_size_]),
+      max_queued_packets_(
+          std::clamp(max_packets_per_burst, 1, kMaxQueuedPackets)),
+      packet_buffer_(new uint8_t[packet_buffer_size_ * max_queued_packets_]),
       max_packets_per_burst_(max_packets_per_burst),
       burst_interval_(burst_interval),
       max_burst_bitrate_(ComputeMaxBurstBitrate(packet_buffer_size_,
                                                 max_packets_per_burst_,
                                                 burst_interval_)),
+      congestion_controller_(
+          std::make_unique<BandwidthEstimator>(max_packets_per_burst,
+                                               burst_interval,
+                                               environment.now())),
       alarm_(environment_->now_function(), environment_->task_runner()) {
   OSP_CHECK_GT(packet_buffer_size_, kRequiredNetworkPacketSize);
+  queued_packets_.reserve(max_queued_packets_);
+  queued_metadata_.reserve(max_queued_packets_);
+  queued_destinations_.reserve(max_queued_packets_);
 }
 
 SenderPacketRouter::~SenderPacketRouter() {
   OSP_CHECK(senders_.empty());
 }
 
+void SenderPacketRouter::SetCongestionController(
+    std::unique_ptr<CongestionController> congestion_controller) {
+  OSP_CHECK(congestion_controller);
+  congestion_controller_ = std::move(congestion_controller);
+}
+
 void SenderPacketRouter::OnSenderCreated(Ssrc receiver_ssrc, Sender* sender) {
-  OSP_CHECK(FindEntry(receiver_ssrc) == senders_.end());
-  senders_.push_back(SenderEntry{receiver_ssrc, sender, kNever, kNever});
+  OnSenderCreated(IPEndpoint{}, receiver_ssrc, sender);
+}
+
+void SenderPacketRouter::OnSenderCreated(const IPEndpoint& remote_endpoint,
+                                         Ssrc receiver_ssrc,
+                                         Sender* sender) {
+  OSP_CHECK(FindEntry(remote_endpoint, receiver_ssrc) == senders_.end());
+  senders_.push_back(
+      SenderEntry{remote_endpoint, receiver_ssrc, sender, kNever, kNever});
 
   if (senders_.size() == 1) {
     environment_->ConsumeIncomingPackets(this);
@@ -60,12 +94,19 @@ void SenderPacketRouter::OnSenderCreated(Ssrc receiver_ssrc, Sender* sender) {
     // Sort the list of Senders so that they are iterated in priority order.
     std::sort(senders_.begin(), senders_.end());
   }
+  IndexSenders();
 }
 
 void SenderPacketRouter::OnSenderDestroyed(Ssrc receiver_ssrc) {
-  const auto it = FindEntry(receiver_ssrc);
+  OnSenderDestroyed(IPEndpoint{}, receiver_ssrc);
+}
+
+void SenderPacketRouter::OnSenderDestroyed(const IPEndpoint& remote_endpoint,
+                                           Ssrc receiver_ssrc) {
+  const auto it = FindEntry(remote_endpoint, receiver_ssrc);
   OSP_CHECK(it != senders_.end());
   senders_.erase(it);
+  IndexSenders();
 
   // If there are no longer any Senders, suspend receiving RTCP packets.
   if (senders_.empty()) {
@@ -74,14 +115,24 @@ void SenderPacketRouter::OnSenderDestroyed(Ssrc receiver_ssrc) {
 }
 
 void SenderPacketRouter::RequestRtcpSend(Ssrc receiver_ssrc) {
-  const auto it = FindEntry(receiver_ssrc);
+  RequestRtcpSend(IPEndpoint{}, receiver_ssrc);
+}
+
+void SenderPacketRouter::RequestRtcpSend(const IPEndpoint& remote_endpoint,
+                                         Ssrc receiver_ssrc) {
+  const auto it = FindEntry(remote_endpoint, receiver_ssrc);
   OSP_CHECK(it != senders_.end());
   it->next_rtcp_send_time = Alarm::kImmediately;
   ScheduleNextBurst();
 }
 
 void SenderPacketRouter::RequestRtpSend(Ssrc receiver_ssrc) {
-  const auto it = FindEntry(receiver_ssrc);
+  RequestRtpSend(IPEndpoint{}, receiver_ssrc);
+}
+
+void SenderPacketRouter::RequestRtpSend(const IPEndpoint& remote_endpoint,
+                                        Ssrc receiver_ssrc) {
+  const auto it = FindEntry(remote_endpoint, receiver_ssrc);
   OSP_CHECK(it != senders_.end());
   it->next_rtp_send_time = Alarm::kImmediately;
   ScheduleNextBurst();
@@ -89,10 +140,13 @@ void SenderPacketRouter::RequestRtpSend(Ssrc receiver_ssrc) {
 
 void SenderPacketRouter::OnReceivedPacket(const IPEndpoint& source,
                                           Clock::time_point arrival_time,
-                                          std::vector<uint8_t> packet) {
-  // If the packet did not come from the expected endpoint, ignore it.
+                                          UdpPacket packet) {
+  // If the packet did not come from the expected endpoint, or from that of any
+  // Sender's Receiver, ignore it.
   OSP_CHECK_NE(source.port, uint16_t{0});
-  if (source != environment_->remote_endpoint()) {
+  const bool from_remote_endpoint = source == environment_->remote_endpoint();
+  if (!from_remote_endpoint &&
+      remote_endpoints_.find(source) == remote_endpoints_.end()) {
     return;
   }
 
@@ -110,18 +164,37 @@ void SenderPacketRouter::OnReceivedPacket(const IPEndpoint& source,
                  << HexEncode(packet.data(), encode_size);
     return;
   }
-  const auto it = FindEntry(seems_like.second);
+  auto it = FindEntry(source, seems_like.second);
+  if (it == senders_.end() && from_remote_endpoint) {
+    it = FindEntry(IPEndpoint{}, seems_like.second);
+  }
   if (it != senders_.end()) {
     it->sender->OnReceivedRtcpPacket(arrival_time, std::move(packet));
   }
 }
 
 SenderPacketRouter::SenderEntries::iterator SenderPacketRouter::FindEntry(
+    const IPEndpoint& remote_endpoint,
     Ssrc receiver_ssrc) {
-  return std::find_if(senders_.begin(), senders_.end(),
-                      [receiver_ssrc](const SenderEntry& entry) {
-                        return entry.receiver_ssrc == receiver_ssrc;
-                      });
+  const auto it =
+      sender_indices_.find(SenderKey(remote_endpoint, receiver_ssrc));
+  if (it == sender_indices_.end()) {
+    return senders_.end();
+  }
+  return senders_.begin() + it->second;
+}
+
+void SenderPacketRouter::IndexSenders() {
+  sender_indices_.clear();
+  remote_endpoints_.clear();
+  for (size_t i = 0; i < senders_.size(); ++i) {
+    const SenderEntry& entry = senders_[i];
+    sender_indices_.emplace(
+        SenderKey(entry.remote_endpoint, entry.receiver_ssrc), i);
+    if (entry.remote_endpoint.port != 0) {
+      remote_endpoints_.insert(entry.remote_endpoint);
+    }
+  }
 }
 
 void SenderPacketRouter::ScheduleNextBurst() {
@@ -163,9 +236,10 @@ void SenderPacketRouter::SendBurstOfPackets() {
   // Higher priority Senders' RTP packets are sent first.
   const int num_rtp_packets_sent = SendJustTheRtpPackets(
       burst_time, max_packets_per_burst_ - num_rtcp_packets_sent);
+  FlushQueuedPackets();
   last_burst_time_ = burst_time;
 
-  BandwidthEstimator::OnBurstComplete(
+  congestion_controller_->OnBurstComplete(
       num_rtcp_packets_sent + num_rtp_packets_sent, burst_time);
 
   ScheduleNextBurst();
@@ -184,12 +258,9 @@ int SenderPacketRouter::SendJustTheRtcpPackets(Clock::time_point send_time) {
     // burst would mean that all but the last one are old/irrelevant snapshots
     // of Sender state, and this would just thrash/confuse the Receiver.
     const ByteBuffer packet = entry.sender->GetRtcpPacketForImmediateSend(
-        send_time, ByteBuffer(packet_buffer_.get(), packet_buffer_size_));
+        send_time, GetNextPacketBuffer());
     if (!packet.empty()) {
-      environment_->SendPacket(
-          ByteView(packet.data(), packet.size()),
-          PacketMetadata{.stream_type = entry.sender->GetStreamType(),
-                         .rtp_timestamp = entry.sender->GetLastRtpTimestamp()});
+      QueuePacketForSend(entry, {packet, ByteView()});
       entry.next_rtcp_send_time = send_time + kRtcpReportInterval;
       ++num_sent;
     }
@@ -200,34 +271,201 @@ int SenderPacketRouter::SendJustTheRtcpPackets(Clock::time_point send_time) {
 
 int SenderPacketRouter::SendJustTheRtpPackets(Clock::time_point send_time,
                                               int num_packets_to_send) {
-  int num_sent = 0;
-  for (SenderEntry& entry : senders_) {
-    if (num_sent >= num_packets_to_send) {
-      break;
-    }
+  // Collect the Senders that are due to send. Those that have used up their
+  // pacing budget are instead rescheduled for when it allows sending again.
+  std::vector<RtpCandidate>& candidates = rtp_candidates_;
+  candidates.clear();
+  std::optional<int> video_pacing_rate;
+  for (size_t i = 0; i < senders_.size(); ++i) {
+    SenderEntry& entry = senders_[i];
     if (entry.next_rtp_send_time > send_time) {
       continue;
     }
+    if (entry.sender->GetStreamType() == StreamType::kVideo) {
+      if (!video_pacing_rate) {
+        video_pacing_rate = ComputeVideoPacingRate();
+      }
+      SetPacingRate(entry, *video_pacing_rate, send_time);
+    }
+    RefillPacingBudget(entry, send_time);
+    if (entry.pacing_rate > 0 && entry.pacing_budget <= 0) {
+      entry.next_rtp_send_time = GetPacingResumeTime(entry);
+    } else {
+      candidates.push_back(RtpCandidate{i, GetSchedulingDeadline(entry)});
+    }
+  }
+
+  int num_sent = 0;
+  while (num_sent < num_packets_to_send && !candidates.empty()) {
+    // Choose the Sender with the earliest deadline. Ties go to the Sender that
+    // comes first in `senders_`, which has the higher SSRC priority.
+    auto chosen = candidates.begin();
+    for (auto it = chosen + 1; it != candidates.end(); ++it) {
+      if (it->deadline < chosen->deadline) {
+        chosen = it;
+      }
+    }
 
-    for (; num_sent < num_packets_to_send; ++num_sent) {
-      const ByteBuffer packet = entry.sender->GetRtpPacketForImmediateSend(
-          send_time, ByteBuffer(packet_buffer_.get(), packet_buffer_size_));
-      if (packet.empty()) {
-        break;
+    SenderEntry& entry = senders_[chosen->index];
+    chosen->was_asked = true;
+    const UdpSocket::GatheredMessage packet =
+        entry.sender->GetRtpPacketPartsForImmediateSend(send_time,
+                                                        GetNextPacketBuffer());
+    if (packet.size() > 0) {
+      QueuePacketForSend(entry, packet);
+      ++num_sent;
+      if (entry.pacing_rate > 0) {
+        entry.pacing_budget -= static_cast<int64_t>(packet.size());
+      }
+      if (entry.pacing_rate == 0 || entry.pacing_budget > 0) {
+        // Only the chosen Sender's deadline has changed.
+        if (candidates.size() > 1) {
+          chosen->deadline = GetSchedulingDeadline(entry);
+        }
+        continue;
       }
-      environment_->SendPacket(
-          ByteView(packet.data(), packet.size()),
-          PacketMetadata{.stream_type = entry.sender->GetStreamType(),
-                         .rtp_timestamp = entry.sender->GetLastRtpTimestamp()});
     }
-    entry.next_rtp_send_time = entry.sender->GetRtpResumeTime();
+    // The Sender has nothing more to send, or may not send any more now.
+    RescheduleRtpSend(entry);
+    candidates.erase(chosen);
+  }
+
+  // Senders that were not asked for any packets before the burst filled up
+  // remain due, to be first in line for the next burst.
+  for (const RtpCandidate& candidate : candidates) {
+    if (candidate.was_asked) {
+      RescheduleRtpSend(senders_[candidate.index]);
+    }
   }
 
   return num_sent;
 }
 
+void SenderPacketRouter::RescheduleRtpSend(SenderEntry& entry) {
+  entry.next_rtp_send_time = entry.sender->GetRtpResumeTime();
+  if (entry.pacing_rate > 0 && entry.pacing_budget <= 0) {
+    entry.next_rtp_send_time =
+        std::max(entry.next_rtp_send_time, GetPacingResumeTime(entry));
+  }
+}
+
+// static
+Clock::time_point SenderPacketRouter::GetSchedulingDeadline(
+    const SenderEntry& entry) {
+  const Clock::time_point deadline = entry.sender->GetNextRtpPacketDeadline();
+  if (deadline == kNever ||
+      entry.sender->GetStreamType() != StreamType::kAudio) {
+    return deadline;
+  }
+  return deadline - kAudioLatencyBudget;
+}
+
+int SenderPacketRouter::ComputeVideoPacingRate() const {
+  const double rate = congestion_controller_->ComputeNetworkBandwidth() *
+                      kVideoPacingFactor;
+  return static_cast<int>(
+      std::min<double>(rate, std::numeric_limits<int>::max()));
+}
+
+void SenderPacketRouter::SetPacingRate(SenderEntry& entry,
+                                       int pacing_rate,
+                                       Clock::time_point send_time) {
+  if (pacing_rate == entry.pacing_rate) {
+    return;
+  }
+  // Bring the budget up to date at the old rate first.
+  RefillPacingBudget(entry, send_time);
+  if (entry.pacing_rate == 0) {
+    entry.pacing_budget = std::numeric_limits<int64_t>::max();
+    entry.pacing_budget_time = send_time;
+  }
+  entry.pacing_rate = pacing_rate;
+  RefillPacingBudget(entry, send_time);
+}
+
+void SenderPacketRouter::RefillPacingBudget(SenderEntry& entry,
+                                            Clock::time_point send_time) {
+  if (entry.pacing_rate == 0) {
+    return;
+  }
+  // Bounding the elapsed time avoids overflow after long idle periods, when
+  // the budget is full anyway.
+  const Clock::duration elapsed =
+      std::clamp<Clock::duration>(send_time - entry.pacing_budget_time,
+                                  Clock::duration::zero(), seconds(1));
+  const int64_t elapsed_us = to_microseconds(elapsed).count();
+  const int64_t max_budget = std::max<int64_t>(
+      int64_t{entry.pacing_rate} * to_microseconds(burst_interval_).count() /
+          kBitsPerByte / kMicrosecondsPerSecond,
+      packet_buffer_size_);
+  const int64_t refill =
+      elapsed_us * entry.pacing_rate / kBitsPerByte / kMicrosecondsPerSecond;
+  entry.pacing_budget =
+      entry.pacing_budget > max_budget - refill
+          ? max_budget
+          : entry.pacing_budget + refill;
+  entry.pacing_budget_time = send_time;
+}
+
+// static
+Clock::time_point SenderPacketRouter::GetPacingResumeTime(
+    const SenderEntry& entry) {
+  OSP_CHECK_GT(entry.pacing_rate, 0);
+  OSP_CHECK_LE(entry.pacing_budget, 0);
+  // The time for the budget to reach one byte, rounded up.
+  const int64_t bits_needed = (1 - entry.pacing_budget) * kBitsPerByte;
+  const int64_t wait_us =
+      (bits_needed * kMicrosecondsPerSecond + entry.pacing_rate - 1) /
+      entry.pacing_rate;
+  return entry.pacing_budget_time + microseconds(wait_us);
+}
+
+ByteBuffer SenderPacketRouter::GetNextPacketBuffer() {
+  if (static_cast<int>(queued_packets_.size()) == max_queued_packets_) {
+    FlushQueuedPackets();
+  }
+  return ByteBuffer(
+      packet_buffer_.get() + queued_packets_.size() * packet_buffer_size_,
+      packet_buffer_size_);
+}
+
+void SenderPacketRouter::QueuePacketForSend(
+    const SenderEntry& entry,
+    UdpSocket::GatheredMessage packet) {
+  queued_packets_.push_back(packet);
+  queued_metadata_.push_back(
+      PacketMetadata{.stream_type = entry.sender->GetStreamType(),
+                     .rtp_timestamp = entry.sender->GetLastRtpTimestamp()});
+  queued_destinations_.push_back(entry.remote_endpoint);
+}
+
+void SenderPacketRouter::FlushQueuedPackets() {
+  const std::span<const UdpSocket::GatheredMessage> packets(queued_packets_);
+  const std::span<const PacketMetadata> metadata(queued_metadata_);
+  size_t begin = 0;
+  while (begin < queued_packets_.size()) {
+    const IPEndpoint& destination = queued_destinations_[begin];
+    size_t end = begin + 1;
+    while (end < queued_packets_.size() &&
+           queued_destinations_[end] == destination) {
+      ++end;
+    }
+    const size_t count = end - begin;
+    if (destination.port == 0) {
+      environment_->SendPackets(packets.subspan(begin, count),
+                                metadata.subspan(begin, count));
+    } else {
+      environment_->SendPacketsTo(destination, packets.subspan(begin, count),
+                                  metadata.subspan(begin, count));
+    }
+    begin = end;
+  }
+  queued_packets_.clear();
+  queued_metadata_.clear();
+  queued_destinations_.clear();
+}
+
 namespace {
-constexpr int kBitsPerByte = 8;
 constexpr auto kOneSecondInMilliseconds = to_milliseconds(seconds(1));
 }  // namespace
 
@@ -261,13 +499,40 @@ int SenderPacketRouter::ComputeMaxBurstBitrate(int packet_size,
   return saturate_cast<int>(max_bits_per_burst * bursts_per_second);
 }
 
+UdpSocket::GatheredMessage
+SenderPacketRouter::Sender::GetRtpPacketPartsForImmediateSend(
+    Clock::time_point send_time,
+    ByteBuffer buffer) {
+  return {GetRtpPacketForImmediateSend(send_time, buffer), ByteView()};
+}
+
+Clock::time_point SenderPacketRouter::Sender::GetNextRtpPacketDeadline() {
+  return kNever;
+}
+
 SenderPacketRouter::Sender::~Sender() = default;
 
+size_t SenderPacketRouter::EndpointHash::operator()(
+    const IPEndpoint& endpoint) const {
+  uint64_t hash = ComputeAggregateHash(endpoint.port);
+  for (uint8_t byte : endpoint.address.bytes()) {
+    hash = CombineHash(hash, byte);
+  }
+  return hash;
+}
+
+size_t SenderPacketRouter::SenderKeyHash::operator()(
+    const SenderKey& key) const {
+  return CombineHash(EndpointHash()(key.first), key.second);
+}
+
 // static
 constexpr int SenderPacketRouter::kDefaultMaxBurstBitrate;
 // static
 constexpr milliseconds SenderPacketRouter::kDefaultBurstInterval;
 // static
+constexpr milliseconds SenderPacketRouter::kAudioLatencyBudget;
+// static
 constexpr Clock::time_point SenderPacketRouter::kNever;
 
 }  // namespace openscreen::cast
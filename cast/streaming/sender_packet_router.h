@@ -9,14 +9,20 @@
 
 #include <chrono>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
-#include "cast/streaming/impl/bandwidth_estimator.h"
+#include "cast/streaming/impl/congestion_controller.h"
 #include "cast/streaming/public/constants.h"
 #include "cast/streaming/public/environment.h"
 #include "cast/streaming/ssrc.h"
 #include "platform/api/time.h"
+#include "platform/api/udp_socket.h"
+#include "platform/base/ip_address.h"
 #include "platform/base/span.h"
+#include "platform/base/udp_packet.h"
 #include "util/alarm.h"
 #include "util/raw_ptr.h"
 #include "util/raw_ref.h"
@@ -40,8 +46,31 @@ namespace openscreen::cast {
 // packets can be sent together as one larger transmission unit, and this can be
 // critical for good performance over shared-medium networks (such as 802.11
 // WiFi). https://en.wikipedia.org/wiki/Frame-bursting
-class SenderPacketRouter : public BandwidthEstimator,
-                           public Environment::PacketConsumer {
+//
+// The packets of a burst are collected first, and then handed to the
+// Environment together, so that the platform can send them with as few system
+// calls as possible.
+//
+// Usually, all Senders stream to the Environment's remote endpoint. However,
+// Senders may also be registered with their own remote endpoint, which allows
+// one SenderPacketRouter (and its Environment's socket) to serve the Senders of
+// many Receivers at once. Senders are then identified by their Receiver's
+// endpoint as well as its SSRC.
+//
+// Scheduling strategy: RTCP packets are always sent first. Then, RTP packets
+// are sent one at a time from the Sender whose next packet has the earliest
+// deadline (see Sender::GetNextRtpPacketDeadline()). Audio packets are given a
+// head start of kAudioLatencyBudget, so that a large video key frame does not
+// hold back the audio packets captured after it, unless its own deadline is
+// much nearer. Senders without deadlines are scheduled in the priority order
+// implied by their SSRCs. Video Senders are also paced to a multiple of the
+// network bandwidth estimate (see kVideoPacingFactor).
+//
+// Congestion control: The router reports each burst of packets it sends to its
+// CongestionController, which is a BandwidthEstimator unless replaced by
+// SetCongestionController(). Senders report the feedback from their Receivers
+// to the congestion_controller() too.
+class SenderPacketRouter : public Environment::PacketConsumer {
  public:
   class Sender {
    public:
@@ -61,12 +90,28 @@ class SenderPacketRouter : public BandwidthEstimator,
     virtual ByteBuffer GetRtpPacketForImmediateSend(Clock::time_point send_time,
                                                     ByteBuffer buffer) = 0;
 
+    // Like GetRtpPacketForImmediateSend(), but the packet may be returned as a
+    // header in `buffer` followed by a payload that is not copied into it. The
+    // payload must remain valid until the end of the current burst, which
+    // always ends before control returns to the TaskRunner. Returns an empty
+    // message if nothing is ready to send. The default implementation returns
+    // the packet from GetRtpPacketForImmediateSend() as the header.
+    virtual UdpSocket::GatheredMessage GetRtpPacketPartsForImmediateSend(
+        Clock::time_point send_time,
+        ByteBuffer buffer);
+
     // Returns the point-in-time at which RTP sending should resume, or kNever
     // if it should be suspended until an explicit call to RequestRtpSend(). The
     // implementation may return a value on or before "now" to indicate an
     // immediate resume is desired.
     virtual Clock::time_point GetRtpResumeTime() = 0;
 
+    // Returns the point-in-time by which the packet to be returned next by
+    // GetRtpPacketPartsForImmediateSend() should be sent, for its frame to be
+    // played out on time, or kNever if there is no deadline. The default
+    // implementation returns kNever.
+    virtual Clock::time_point GetNextRtpPacketDeadline();
+
     // Returns the last logged RTP timestamp, for use in expanding truncated
     // packet RTP timestamps for metrics purposes.
     virtual RtpTimeTicks GetLastRtpTimestamp() const = 0;
@@ -94,22 +139,41 @@ class SenderPacketRouter : public BandwidthEstimator,
   int max_packet_size() const { return packet_buffer_size_; }
   int max_burst_bitrate() const { return max_burst_bitrate_; }
 
+  CongestionController& congestion_controller() {
+    return *congestion_controller_;
+  }
+  const CongestionController& congestion_controller() const {
+    return *congestion_controller_;
+  }
+
+  // Replaces the CongestionController. This should be called before any
+  // packets are sent, since the new one starts without any history.
+  void SetCongestionController(
+      std::unique_ptr<CongestionController> congestion_controller);
+
   // Called from a Sender constructor/destructor to register/deregister a Sender
   // instance that processes RTP/RTCP packets from a Receiver having the given
-  // SSRC.
+  // SSRC. The Receiver is at the given `remote_endpoint` or, if omitted, at the
+  // Environment's remote endpoint.
   void OnSenderCreated(Ssrc receiver_ssrc, Sender* client);
+  void OnSenderCreated(const IPEndpoint& remote_endpoint,
+                       Ssrc receiver_ssrc,
+                       Sender* client);
   void OnSenderDestroyed(Ssrc receiver_ssrc);
+  void OnSenderDestroyed(const IPEndpoint& remote_endpoint, Ssrc receiver_ssrc);
 
   // Requests an immediate send of a RTCP packet, and then RTCP sending will
   // repeat at regular intervals (see kRtcpSendInterval) until the Sender is
   // de-registered.
   void RequestRtcpSend(Ssrc receiver_ssrc);
+  void RequestRtcpSend(const IPEndpoint& remote_endpoint, Ssrc receiver_ssrc);
 
   // Requests an immediate send of a RTP packet. RTP sending will continue until
   // the Sender stops providing packet data.
   //
   // See also: Sender::GetRtpResumeTime().
   void RequestRtpSend(Ssrc receiver_ssrc);
+  void RequestRtpSend(const IPEndpoint& remote_endpoint, Ssrc receiver_ssrc);
 
   // A reasonable default maximum bitrate for bursting. Congestion control
   // should always be employed to limit the Senders' sustained/average outbound
@@ -122,16 +186,41 @@ class SenderPacketRouter : public BandwidthEstimator,
   // This value came from the original Chrome Cast Streaming implementation.
   static constexpr std::chrono::milliseconds kDefaultBurstInterval{10};
 
+  // How much sooner an audio packet's deadline is considered to be than that
+  // of a video packet. Audio frames are small and frequent, so sending them
+  // ahead of video costs the video little, whereas any delay of audio is
+  // readily noticed.
+  static constexpr std::chrono::milliseconds kAudioLatencyBudget{100};
+
+  // The RTP packets of each video Sender are limited to this multiple of the
+  // congestion controller's network bandwidth estimate, averaged over the burst
+  // interval, and are not paced while there is no estimate. This spreads out
+  // the key frames, so that they do not fill the network queues where the
+  // packets of the other Senders would have to wait behind them, while leaving
+  // the video enough headroom for the estimate to grow.
+  static constexpr double kVideoPacingFactor = 2.5;
+
   // A special time_point value representing "never."
   static constexpr Clock::time_point kNever = Clock::time_point::max();
 
  private:
   struct SenderEntry {
+    // The Receiver's endpoint, or the zero IPEndpoint if the Receiver is at the
+    // Environment's remote endpoint.
+    IPEndpoint remote_endpoint;
     Ssrc receiver_ssrc;
     raw_ptr<Sender> sender;
     Clock::time_point next_rtcp_send_time;
     Clock::time_point next_rtp_send_time;
 
+    // The maximum rate at which RTP packets are sent, in bits per second, or
+    // zero if unlimited (see kVideoPacingFactor). `pacing_budget` is the
+    // number of bytes that may yet be sent as of `pacing_budget_time`, and
+    // goes negative when the last packet sent exceeded it.
+    int pacing_rate = 0;
+    int64_t pacing_budget = 0;
+    Clock::time_point pacing_budget_time{};
+
     // Entries are ordered by the transmission priority (high→low), as implied
     // by their SSRC. See ssrc.h for details.
     bool operator<(const SenderEntry& other) const {
@@ -141,14 +230,43 @@ class SenderPacketRouter : public BandwidthEstimator,
 
   using SenderEntries = std::vector<SenderEntry>;
 
+  // Identifies a Sender by its SenderEntry's `remote_endpoint` and
+  // `receiver_ssrc`.
+  using SenderKey = std::pair<IPEndpoint, Ssrc>;
+
+  struct EndpointHash {
+    size_t operator()(const IPEndpoint& endpoint) const;
+  };
+  struct SenderKeyHash {
+    size_t operator()(const SenderKey& key) const;
+  };
+
+  // A Sender that may send RTP packets in the current burst, identified by its
+  // position in `senders_`.
+  struct RtpCandidate {
+    size_t index;
+
+    // The deadline of the Sender's next packet (see GetSchedulingDeadline()),
+    // which only changes when the Sender sends a packet.
+    Clock::time_point deadline;
+
+    // Whether the Sender has been asked for a packet in the current burst.
+    bool was_asked = false;
+  };
+
   // Environment::PacketConsumer implementation.
   void OnReceivedPacket(const IPEndpoint& source,
                         Clock::time_point arrival_time,
-                        std::vector<uint8_t> packet) final;
+                        UdpPacket packet) final;
 
   // Helper to return an iterator pointing to the entry corresponding to the
-  // given `receiver_ssrc`, or "end" if not found.
-  SenderEntries::iterator FindEntry(Ssrc receiver_ssrc);
+  // given `remote_endpoint` and `receiver_ssrc`, or "end" if not found.
+  SenderEntries::iterator FindEntry(const IPEndpoint& remote_endpoint,
+                                    Ssrc receiver_ssrc);
+
+  // Rebuilds `sender_indices_` and `remote_endpoints_` after `senders_` has
+  // changed.
+  void IndexSenders();
 
   // Examine the next send time for all Senders, and decide whether to schedule
   // a burst-send.
@@ -162,10 +280,51 @@ class SenderPacketRouter : public BandwidthEstimator,
   int SendJustTheRtcpPackets(Clock::time_point send_time);
 
   // Send zero or more RTP packets from each Sender, up to a maximum of
-  // `num_packets_to_send`, and return the number of packets sent.
+  // `num_packets_to_send`, and return the number of packets sent. The packets
+  // are sent in deadline order.
   int SendJustTheRtpPackets(Clock::time_point send_time,
                             int num_packets_to_send);
 
+  // Sets the next RTP send time of `entry`, after its Sender has been asked
+  // for packets in the current burst.
+  void RescheduleRtpSend(SenderEntry& entry);
+
+  // Returns the deadline by which to schedule the next RTP packet of the
+  // Sender of `entry`, which accounts for kAudioLatencyBudget.
+  static Clock::time_point GetSchedulingDeadline(const SenderEntry& entry);
+
+  // Returns the pacing rate for video Senders, or zero if they are not to be
+  // paced.
+  int ComputeVideoPacingRate() const;
+
+  // Changes the pacing rate of `entry`. A Sender that was not paced starts
+  // with a full pacing budget, as if it had been idle.
+  void SetPacingRate(SenderEntry& entry,
+                     int pacing_rate,
+                     Clock::time_point send_time);
+
+  // Adds to the pacing budget of `entry` for the time elapsed until
+  // `send_time`, up to the amount for one burst interval.
+  void RefillPacingBudget(SenderEntry& entry, Clock::time_point send_time);
+
+  // Returns the time at which the pacing budget of `entry`, which must have
+  // been used up, allows sending again.
+  static Clock::time_point GetPacingResumeTime(const SenderEntry& entry);
+
+  // Returns the region of `packet_buffer_` for the next packet in the burst.
+  // If the maximum number of packets is already queued, they are sent first.
+  ByteBuffer GetNextPacketBuffer();
+
+  // Queues a `packet` whose header was just written into the buffer returned by
+  // GetNextPacketBuffer(), to be sent to the Receiver of the given `entry` by
+  // the next FlushQueuedPackets().
+  void QueuePacketForSend(const SenderEntry& entry,
+                          UdpSocket::GatheredMessage packet);
+
+  // Sends all queued packets, with one call to Environment::SendPackets() or
+  // SendPacketsTo() for each run of packets bound for the same Receiver.
+  void FlushQueuedPackets();
+
   // Returns the maximum number of packets to send in one burst, based on the
   // given parameters.
   static int ComputeMaxPacketsPerBurst(
@@ -180,11 +339,17 @@ class SenderPacketRouter : public BandwidthEstimator,
 
   const raw_ref<Environment> environment_;
   const int packet_buffer_size_;
+
+  // The maximum number of packets queued for sending at once, each getting its
+  // own `packet_buffer_size_` region of `packet_buffer_`.
+  const int max_queued_packets_;
   const std::unique_ptr<uint8_t[]> packet_buffer_;
   const int max_packets_per_burst_;
   const std::chrono::milliseconds burst_interval_;
   const int max_burst_bitrate_;
 
+  std::unique_ptr<CongestionController> congestion_controller_;
+
   // Schedules the task that calls back into this SenderPacketRouter at a later
   // time to send the next burst of packets.
   Alarm alarm_;
@@ -193,9 +358,28 @@ class SenderPacketRouter : public BandwidthEstimator,
   // maintained in order of the priority implied by the Sender SSRC's.
   SenderEntries senders_;
 
+  // The position of each Sender's entry in `senders_`, and the set of remote
+  // endpoints other than the Environment's, so that inbound packets are routed
+  // without scanning `senders_`. These are rebuilt whenever a Sender is added
+  // or removed, which is rare compared to packet arrivals.
+  std::unordered_map<SenderKey, size_t, SenderKeyHash> sender_indices_;
+  std::unordered_set<IPEndpoint, EndpointHash> remote_endpoints_;
+
   // The last time a burst of packets was sent. This is used to determine the
   // next burst time.
   Clock::time_point last_burst_time_ = Clock::time_point::min();
+
+  // The Senders still able to send RTP packets in the current burst. This is
+  // only a member to avoid re-allocating it for each burst.
+  std::vector<RtpCandidate> rtp_candidates_;
+
+  // The packets of the current burst that have yet to be sent, their metadata
+  // and their destinations (see SenderEntry::remote_endpoint). The packet
+  // headers point into `packet_buffer_`, and the payloads (if any) into memory
+  // owned by the Senders.
+  std::vector<UdpSocket::GatheredMessage> queued_packets_;
+  std::vector<PacketMetadata> queued_metadata_;
+  std::vector<IPEndpoint> queued_destinations_;
 };
 
 }  // namespace openscreen::cast
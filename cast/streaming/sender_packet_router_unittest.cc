@@ -5,6 +5,10 @@
 #include "cast/streaming/sender_packet_router.h"
 
 #include <chrono>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "cast/streaming/public/constants.h"
 #include "cast/streaming/testing/mock_environment.h"
@@ -19,9 +23,11 @@
 #include "util/osp_logging.h"
 
 using testing::_;
+using testing::ElementsAre;
 using testing::ElementsAreArray;
 using testing::Mock;
 using testing::Return;
+using testing::UnorderedElementsAre;
 
 namespace openscreen::cast {
 namespace {
@@ -34,6 +40,9 @@ const IPEndpoint kRemoteEndpoint{
 const IPEndpoint kUnexpectedEndpoint{
     IPAddress::Parse("2001:db8:0d93:69c2:fd1a:49a6:a7c0:e8a7").value(), 25476};
 
+const IPEndpoint kOtherRemoteEndpoint{
+    IPAddress::Parse("2001:db8:0d93:69c2:fd1a:49a6:a7c0:e8a8").value(), 25476};
+
 // Limited burst parameters to simplify unit testing.
 constexpr int kMaxPacketsPerBurst = 3;
 constexpr auto kBurstInterval = milliseconds(10);
@@ -143,10 +152,85 @@ class MockSender : public SenderPacketRouter::Sender {
               (Clock::time_point send_time, ByteBuffer buffer),
               (override));
   MOCK_METHOD(Clock::time_point, GetRtpResumeTime, (), (override));
+  MOCK_METHOD(Clock::time_point, GetNextRtpPacketDeadline, (), (override));
   MOCK_METHOD(RtpTimeTicks, GetLastRtpTimestamp, (), (const, override));
   MOCK_METHOD(StreamType, GetStreamType, (), (const, override));
 };
 
+// A MockSender that returns each RTP packet from GetRtpPacketForImmediateSend()
+// as a header, followed by the next of `payloads`, which is not copied.
+class GatheringMockSender : public MockSender {
+ public:
+  UdpSocket::GatheredMessage GetRtpPacketPartsForImmediateSend(
+      Clock::time_point send_time,
+      ByteBuffer buffer) override {
+    const ByteBuffer header = GetRtpPacketForImmediateSend(send_time, buffer);
+    if (header.empty()) {
+      return {};
+    }
+    OSP_CHECK(!payloads.empty());
+    const ByteView payload = payloads.front();
+    payloads.pop_front();
+    return {header, payload};
+  }
+
+  std::deque<ByteView> payloads;
+};
+
+// A CongestionController whose network bandwidth estimate is set by the test.
+class FakeCongestionController : public CongestionController {
+ public:
+  FakeCongestionController() = default;
+  ~FakeCongestionController() override = default;
+
+  void set_network_bandwidth(int bandwidth) { network_bandwidth_ = bandwidth; }
+
+  // CongestionController overrides.
+  void OnBurstComplete(int num_packets_sent, Clock::time_point when) override {}
+  void OnRtcpReceived(Clock::time_point arrival_time,
+                      Clock::duration estimated_round_trip_time) override {}
+  void OnPayloadReceived(int payload_bytes_acknowledged,
+                         Clock::time_point ack_arrival_time,
+                         Clock::duration estimated_round_trip_time) override {}
+  int ComputeNetworkBandwidth() const override { return network_bandwidth_; }
+
+ private:
+  int network_bandwidth_ = 0;
+};
+
+// A MockEnvironment that also records how many packets were passed to each
+// SendPackets() call.
+class BurstRecordingEnvironment : public MockEnvironment {
+ public:
+  using MockEnvironment::MockEnvironment;
+
+  void SendPackets(std::span<const UdpSocket::GatheredMessage> packets,
+                   std::span<const PacketMetadata> metadata) override {
+    send_packets_call_sizes.push_back(packets.size());
+    for (const UdpSocket::GatheredMessage& packet : packets) {
+      sent_payloads.push_back(packet.payload);
+    }
+    MockEnvironment::SendPackets(packets, metadata);
+  }
+
+  void SendPacketsTo(const IPEndpoint& destination,
+                     std::span<const UdpSocket::GatheredMessage> packets,
+                     std::span<const PacketMetadata> metadata) override {
+    for (const UdpSocket::GatheredMessage& packet : packets) {
+      sent_to_destinations.emplace_back(destination,
+                                        ParseFlag(packet.header));
+    }
+  }
+
+  std::vector<size_t> send_packets_call_sizes;
+
+  // The destination and flag of each packet sent with SendPacketsTo().
+  std::vector<std::pair<IPEndpoint, char>> sent_to_destinations;
+
+  // The payloads of the packets sent, which were not copied into the packets.
+  std::vector<ByteView> sent_payloads;
+};
+
 class SenderPacketRouterTest : public testing::Test {
  public:
   SenderPacketRouterTest()
@@ -159,14 +243,14 @@ class SenderPacketRouterTest : public testing::Test {
 
   ~SenderPacketRouterTest() override = default;
 
-  MockEnvironment* env() { return &env_; }
+  BurstRecordingEnvironment* env() { return &env_; }
   SenderPacketRouter* router() { return &router_; }
   MockSender* audio_sender() { return &audio_sender_; }
   MockSender* video_sender() { return &video_sender_; }
 
   void SimulatePacketArrivedNow(const IPEndpoint& source, ByteView packet) {
     static_cast<Environment::PacketConsumer*>(&router_)->OnReceivedPacket(
-        source, env_.now(), std::vector<uint8_t>(packet.begin(), packet.end()));
+        source, env_.now(), UdpPacket(packet.begin(), packet.end()));
   }
 
   void AdvanceClockAndRunTasks(Clock::duration delta) { clock_.Advance(delta); }
@@ -175,7 +259,7 @@ class SenderPacketRouterTest : public testing::Test {
  private:
   FakeClock clock_;
   FakeTaskRunner task_runner_;
-  testing::NiceMock<MockEnvironment> env_;
+  testing::NiceMock<BurstRecordingEnvironment> env_;
   SenderPacketRouter router_;
   testing::NiceMock<MockSender> audio_sender_;
   testing::NiceMock<MockSender> video_sender_;
@@ -484,6 +568,134 @@ TEST_F(SenderPacketRouterTest, SchedulesAndTransmitsRTPBursts) {
 // Tests that the SenderPacketRouter schedules packet sends based on transmit
 // prority: RTCP before RTP, and the audio Sender's packets before the video
 // Sender's.
+// Tests that all the packets of a burst are handed to the Environment at once,
+// in the order they were generated.
+TEST_F(SenderPacketRouterTest, SendsEachBurstWithOneCall) {
+  env()->set_remote_endpoint(kRemoteEndpoint);
+  router()->OnSenderCreated(kVideoReceiverSsrc, video_sender());
+
+  std::vector<char> flags_sent;
+  EXPECT_CALL(*env(), SendPacket(_, _))
+      .WillRepeatedly([&](ByteView packet, PacketMetadata metadata) {
+        flags_sent.push_back(ParseFlag(packet));
+      });
+
+  // The Sender has five packets to send, which takes two bursts.
+  int num_get_rtp_calls = 0;
+  EXPECT_CALL(*video_sender(), GetRtpPacketForImmediateSend(_, _))
+      .WillRepeatedly([&](Clock::time_point send_time, ByteBuffer buffer) {
+        if (num_get_rtp_calls == 5) {
+          return ToEmptyPacketBuffer(send_time, buffer);
+        }
+        return MakeFakePacketWithFlag('a' + num_get_rtp_calls++, send_time,
+                                      buffer);
+      });
+  ON_CALL(*video_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(Alarm::kImmediately));
+
+  router()->RequestRtpSend(kVideoReceiverSsrc);
+  RunTasksUntilIdle();
+  AdvanceClockAndRunTasks(kBurstInterval);
+
+  EXPECT_THAT(env()->send_packets_call_sizes, ElementsAre(3, 2));
+  EXPECT_THAT(flags_sent, ElementsAre('a', 'b', 'c', 'd', 'e'));
+
+  router()->OnSenderDestroyed(kVideoReceiverSsrc);
+}
+
+// Tests that RTP payloads provided separately from their headers are handed to
+// the Environment as-is, rather than copied into the packet buffer.
+TEST_F(SenderPacketRouterTest, SendsRtpPayloadsWithoutCopying) {
+  testing::NiceMock<GatheringMockSender> sender;
+  env()->set_remote_endpoint(kRemoteEndpoint);
+  router()->OnSenderCreated(kVideoReceiverSsrc, &sender);
+
+  std::vector<std::vector<uint8_t>> packets_sent;
+  EXPECT_CALL(*env(), SendPacket(_, _))
+      .WillRepeatedly([&](ByteView packet, PacketMetadata metadata) {
+        packets_sent.emplace_back(packet.begin(), packet.end());
+      });
+
+  const std::vector<uint8_t> payload = {1, 2, 3, 4, 5, 6, 7, 8};
+  sender.payloads = {ByteView(payload).first(4), ByteView(payload).last(4)};
+  EXPECT_CALL(sender, GetRtpPacketForImmediateSend(_, _))
+      .WillOnce([](Clock::time_point send_time, ByteBuffer buffer) {
+        return MakeFakePacketWithFlag('a', send_time, buffer);
+      })
+      .WillOnce([](Clock::time_point send_time, ByteBuffer buffer) {
+        return MakeFakePacketWithFlag('b', send_time, buffer);
+      })
+      .WillOnce(&ToEmptyPacketBuffer);
+  ON_CALL(sender, GetRtpResumeTime())
+      .WillByDefault(Return(SenderPacketRouter::kNever));
+
+  router()->RequestRtpSend(kVideoReceiverSsrc);
+  RunTasksUntilIdle();
+
+  ASSERT_EQ(env()->sent_payloads.size(), 2u);
+  EXPECT_EQ(env()->sent_payloads[0].data(), payload.data());
+  EXPECT_EQ(env()->sent_payloads[1].data(), payload.data() + 4);
+  // Each packet is a fake header, made of a timestamp and flag, and a payload.
+  constexpr size_t kHeaderSize = sizeof(Clock::duration::rep) + sizeof(char);
+  ASSERT_EQ(packets_sent.size(), 2u);
+  EXPECT_EQ(ParseFlag(ByteView(packets_sent[0]).first(kHeaderSize)), 'a');
+  EXPECT_THAT(ByteView(packets_sent[0]).subspan(kHeaderSize),
+              ElementsAre(1, 2, 3, 4));
+  EXPECT_EQ(ParseFlag(ByteView(packets_sent[1]).first(kHeaderSize)), 'b');
+  EXPECT_THAT(ByteView(packets_sent[1]).subspan(kHeaderSize),
+              ElementsAre(5, 6, 7, 8));
+
+  router()->OnSenderDestroyed(kVideoReceiverSsrc);
+}
+
+// Tests that Senders registered with their own remote endpoints exchange
+// packets with those endpoints only, even if their Receivers share an SSRC.
+TEST_F(SenderPacketRouterTest, RoutesPacketsForSendersWithOwnRemoteEndpoints) {
+  router()->OnSenderCreated(kRemoteEndpoint, kVideoReceiverSsrc,
+                            audio_sender());
+  router()->OnSenderCreated(kOtherRemoteEndpoint, kVideoReceiverSsrc,
+                            video_sender());
+
+  const std::vector<uint8_t> rtcp_packet =
+      MakeRtcpPacketWithAlternateReceiverSsrc(kValidAudioRtcpPacket,
+                                              kVideoReceiverSsrc);
+  EXPECT_CALL(*audio_sender(), OnReceivedRtcpPacket(_, _)).Times(1);
+  EXPECT_CALL(*video_sender(), OnReceivedRtcpPacket(_, _)).Times(2);
+  SimulatePacketArrivedNow(kRemoteEndpoint, rtcp_packet);
+  SimulatePacketArrivedNow(kOtherRemoteEndpoint, rtcp_packet);
+  SimulatePacketArrivedNow(kOtherRemoteEndpoint, rtcp_packet);
+  SimulatePacketArrivedNow(kUnexpectedEndpoint, rtcp_packet);
+  Mock::VerifyAndClear(audio_sender());
+  Mock::VerifyAndClear(video_sender());
+
+  EXPECT_CALL(*env(), SendPacket(_, _)).Times(0);
+  EXPECT_CALL(*audio_sender(), GetRtpPacketForImmediateSend(_, _))
+      .WillOnce([](Clock::time_point send_time, ByteBuffer buffer) {
+        return MakeFakePacketWithFlag('a', send_time, buffer);
+      })
+      .WillOnce(&ToEmptyPacketBuffer);
+  EXPECT_CALL(*video_sender(), GetRtpPacketForImmediateSend(_, _))
+      .WillOnce([](Clock::time_point send_time, ByteBuffer buffer) {
+        return MakeFakePacketWithFlag('b', send_time, buffer);
+      })
+      .WillOnce(&ToEmptyPacketBuffer);
+  ON_CALL(*audio_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(SenderPacketRouter::kNever));
+  ON_CALL(*video_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(SenderPacketRouter::kNever));
+
+  router()->RequestRtpSend(kRemoteEndpoint, kVideoReceiverSsrc);
+  router()->RequestRtpSend(kOtherRemoteEndpoint, kVideoReceiverSsrc);
+  RunTasksUntilIdle();
+
+  EXPECT_THAT(env()->sent_to_destinations,
+              UnorderedElementsAre(std::make_pair(kRemoteEndpoint, 'a'),
+                                   std::make_pair(kOtherRemoteEndpoint, 'b')));
+
+  router()->OnSenderDestroyed(kRemoteEndpoint, kVideoReceiverSsrc);
+  router()->OnSenderDestroyed(kOtherRemoteEndpoint, kVideoReceiverSsrc);
+}
+
 TEST_F(SenderPacketRouterTest, SchedulesAndTransmitsAccountingForPriority) {
   env()->set_remote_endpoint(kRemoteEndpoint);
   ASSERT_LT(ComparePriority(kAudioReceiverSsrc, kVideoReceiverSsrc), 0);
@@ -584,5 +796,158 @@ TEST_F(SenderPacketRouterTest, SchedulesAndTransmitsAccountingForPriority) {
   router()->OnSenderDestroyed(kAudioReceiverSsrc);
 }
 
+// Tests that RTP packets are sent in the order of their deadlines, regardless
+// of the priority implied by the SSRCs of their Senders.
+TEST_F(SenderPacketRouterTest, SendsRtpPacketsInDeadlineOrder) {
+  env()->set_remote_endpoint(kRemoteEndpoint);
+  router()->OnSenderCreated(kVideoReceiverSsrc, video_sender());
+  router()->OnSenderCreated(kAudioReceiverSsrc, audio_sender());
+
+  std::vector<char> flags_sent;
+  EXPECT_CALL(*env(), SendPacket(_, _))
+      .WillRepeatedly([&](ByteView packet, PacketMetadata metadata) {
+        flags_sent.push_back(ParseFlag(packet));
+      });
+
+  // Each Sender has two packets to send, and the lower-priority Sender's are
+  // due first.
+  const Clock::time_point start_time = env()->now();
+  int num_audio_packets = 0;
+  int num_video_packets = 0;
+  EXPECT_CALL(*audio_sender(), GetRtpPacketForImmediateSend(_, _))
+      .WillRepeatedly([&](Clock::time_point send_time, ByteBuffer buffer) {
+        if (num_audio_packets == 2) {
+          return ToEmptyPacketBuffer(send_time, buffer);
+        }
+        return MakeFakePacketWithFlag('a' + num_audio_packets++, send_time,
+                                      buffer);
+      });
+  EXPECT_CALL(*video_sender(), GetRtpPacketForImmediateSend(_, _))
+      .WillRepeatedly([&](Clock::time_point send_time, ByteBuffer buffer) {
+        if (num_video_packets == 2) {
+          return ToEmptyPacketBuffer(send_time, buffer);
+        }
+        return MakeFakePacketWithFlag('v' + num_video_packets++, send_time,
+                                      buffer);
+      });
+  ON_CALL(*audio_sender(), GetNextRtpPacketDeadline())
+      .WillByDefault(Return(start_time + milliseconds(200)));
+  ON_CALL(*video_sender(), GetNextRtpPacketDeadline())
+      .WillByDefault(Return(start_time + milliseconds(100)));
+  ON_CALL(*audio_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(Alarm::kImmediately));
+  ON_CALL(*video_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(Alarm::kImmediately));
+
+  router()->RequestRtpSend(kAudioReceiverSsrc);
+  router()->RequestRtpSend(kVideoReceiverSsrc);
+  RunTasksUntilIdle();
+  AdvanceClockAndRunTasks(kBurstInterval);
+
+  EXPECT_THAT(flags_sent, ElementsAre('v', 'w', 'a', 'b'));
+
+  router()->OnSenderDestroyed(kVideoReceiverSsrc);
+  router()->OnSenderDestroyed(kAudioReceiverSsrc);
+}
+
+// Tests that audio packets are sent before video packets due earlier, unless
+// the video packets are due more than the latency budget earlier.
+TEST_F(SenderPacketRouterTest, SendsAudioFirstWithinLatencyBudget) {
+  env()->set_remote_endpoint(kRemoteEndpoint);
+  router()->OnSenderCreated(kAudioReceiverSsrc, audio_sender());
+  router()->OnSenderCreated(kVideoReceiverSsrc, video_sender());
+
+  std::vector<char> flags_sent;
+  EXPECT_CALL(*env(), SendPacket(_, _))
+      .WillRepeatedly([&](ByteView packet, PacketMetadata metadata) {
+        flags_sent.push_back(ParseFlag(packet));
+      });
+  ON_CALL(*audio_sender(), GetStreamType())
+      .WillByDefault(Return(StreamType::kAudio));
+  ON_CALL(*video_sender(), GetStreamType())
+      .WillByDefault(Return(StreamType::kVideo));
+  ON_CALL(*audio_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(SenderPacketRouter::kNever));
+  ON_CALL(*video_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(SenderPacketRouter::kNever));
+
+  const Clock::time_point start_time = env()->now();
+  const Clock::time_point audio_deadline = start_time + milliseconds(400);
+  ON_CALL(*audio_sender(), GetNextRtpPacketDeadline())
+      .WillByDefault(Return(audio_deadline));
+  for (const Clock::duration video_lead :
+       {SenderPacketRouter::kAudioLatencyBudget - milliseconds(1),
+        SenderPacketRouter::kAudioLatencyBudget + milliseconds(1)}) {
+    ON_CALL(*video_sender(), GetNextRtpPacketDeadline())
+        .WillByDefault(Return(audio_deadline - video_lead));
+    EXPECT_CALL(*audio_sender(), GetRtpPacketForImmediateSend(_, _))
+        .WillOnce([](Clock::time_point send_time, ByteBuffer buffer) {
+          return MakeFakePacketWithFlag('a', send_time, buffer);
+        })
+        .WillOnce(&ToEmptyPacketBuffer);
+    EXPECT_CALL(*video_sender(), GetRtpPacketForImmediateSend(_, _))
+        .WillOnce([](Clock::time_point send_time, ByteBuffer buffer) {
+          return MakeFakePacketWithFlag('v', send_time, buffer);
+        })
+        .WillOnce(&ToEmptyPacketBuffer);
+
+    router()->RequestRtpSend(kAudioReceiverSsrc);
+    router()->RequestRtpSend(kVideoReceiverSsrc);
+    AdvanceClockAndRunTasks(kBurstInterval);
+    Mock::VerifyAndClearExpectations(audio_sender());
+    Mock::VerifyAndClearExpectations(video_sender());
+  }
+
+  EXPECT_THAT(flags_sent, ElementsAre('a', 'v', 'v', 'a'));
+
+  router()->OnSenderDestroyed(kAudioReceiverSsrc);
+  router()->OnSenderDestroyed(kVideoReceiverSsrc);
+}
+
+// Tests that a video Sender's RTP packets are paced to a multiple of the
+// network bandwidth estimate, that the remaining capacity of each burst is not
+// given to it, and that it is not paced while there is no estimate.
+TEST_F(SenderPacketRouterTest, PacesVideoToTheNetworkBandwidth) {
+  constexpr int kPacketSize = 1000;
+  ASSERT_LT(kPacketSize, router()->max_packet_size());
+  env()->set_remote_endpoint(kRemoteEndpoint);
+  auto congestion_controller = std::make_unique<FakeCongestionController>();
+  FakeCongestionController* const fake_controller = congestion_controller.get();
+  router()->SetCongestionController(std::move(congestion_controller));
+  router()->OnSenderCreated(kVideoReceiverSsrc, video_sender());
+  ON_CALL(*video_sender(), GetStreamType())
+      .WillByDefault(Return(StreamType::kVideo));
+
+  // The Sender always has more packets to send.
+  EXPECT_CALL(*video_sender(), GetRtpPacketForImmediateSend(_, _))
+      .WillRepeatedly([](Clock::time_point send_time, ByteBuffer buffer) {
+        return buffer.subspan(0, kPacketSize);
+      });
+  ON_CALL(*video_sender(), GetRtpResumeTime())
+      .WillByDefault(Return(Alarm::kImmediately));
+
+  // Allow two packets per burst interval.
+  constexpr int kPacingRate =
+      2 * kPacketSize * 8 * (1000 / to_milliseconds(kBurstInterval).count());
+  fake_controller->set_network_bandwidth(
+      static_cast<int>(kPacingRate / SenderPacketRouter::kVideoPacingFactor));
+  router()->RequestRtpSend(kVideoReceiverSsrc);
+  RunTasksUntilIdle();
+  for (int i = 0; i < 4; ++i) {
+    AdvanceClockAndRunTasks(kBurstInterval);
+  }
+  EXPECT_THAT(env()->send_packets_call_sizes, ElementsAre(2, 2, 2, 2, 2));
+
+  // Without an estimate, every burst is full.
+  env()->send_packets_call_sizes.clear();
+  fake_controller->set_network_bandwidth(0);
+  for (int i = 0; i < 2; ++i) {
+    AdvanceClockAndRunTasks(kBurstInterval);
+  }
+  EXPECT_THAT(env()->send_packets_call_sizes, ElementsAre(3, 3));
+
+  router()->OnSenderDestroyed(kVideoReceiverSsrc);
+}
+
 }  // namespace
 }  // namespace openscreen::cast
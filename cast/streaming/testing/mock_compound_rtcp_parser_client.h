@@ -24,7 +24,7 @@ class MockCompoundRtcpParserClient : public CompoundRtcpParser::Client {
               (override));
   MOCK_METHOD(void,
               OnCastReceiverFrameLogMessages,
-              (std::vector<RtcpReceiverFrameLogMessage> messages),
+              (const std::vector<RtcpReceiverFrameLogMessage>& messages),
               (override));
   MOCK_METHOD(void, OnReceiverIndicatesPictureLoss, (), (override));
   MOCK_METHOD(void,
@@ -33,11 +33,11 @@ class MockCompoundRtcpParserClient : public CompoundRtcpParser::Client {
               (override));
   MOCK_METHOD(void,
               OnReceiverHasFrames,
-              (std::vector<FrameId> acks),
+              (const std::vector<FrameId>& acks),
               (override));
   MOCK_METHOD(void,
               OnReceiverIsMissingPackets,
-              (std::vector<PacketNack> nacks),
+              (const std::vector<PacketNack>& nacks),
               (override));
 };
 
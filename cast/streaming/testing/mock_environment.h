@@ -25,6 +25,12 @@ class MockEnvironment : public Environment {
               (ByteView packet, PacketMetadata metadata),
               (override));
 
+  // Forwards each packet to SendPacket(), so that tests only need to intercept
+  // the one method. Packets with a separate payload are first copied into one
+  // contiguous buffer.
+  void SendPackets(std::span<const UdpSocket::GatheredMessage> packets,
+                   std::span<const PacketMetadata> metadata) override;
+
   // Used for intercepting socket buffer size configuration from the
   // implementation under test.
   MOCK_METHOD(void, SetReceiveBufferSize, (size_t), (override));
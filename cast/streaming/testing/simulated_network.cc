@@ -0,0 +1,196 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/testing/simulated_network.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "platform/base/udp_packet.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::cast {
+
+SimulatedLink::SimulatedLink(ClockNowFunctionPtr now_function,
+                             TaskRunner& task_runner,
+                             SimulatedEnvironment& destination,
+                             const SimulatedLinkConfig& config,
+                             uint32_t seed)
+    : now_function_(now_function),
+      task_runner_(task_runner),
+      destination_(destination),
+      config_(config),
+      rand_(seed) {}
+
+SimulatedLink::~SimulatedLink() = default;
+
+void SimulatedLink::Send(const IPEndpoint& source,
+                         std::vector<uint8_t> packet) {
+  ++stats_.packets_sent;
+  const int size = static_cast<int>(packet.size());
+  if (config_.queue_size > 0 && queued_bytes_ + size > config_.queue_size) {
+    ++stats_.packets_dropped_by_queue;
+    return;
+  }
+  queue_.push_back(QueuedPacket{source, std::move(packet), now_function_()});
+  queued_bytes_ += size;
+  if (queue_.size() == 1) {
+    TransmitNextPacket();
+  }
+}
+
+void SimulatedLink::TransmitNextPacket() {
+  QueuedPacket& packet = queue_.front();
+  packet.queueing_delay = now_function_() - packet.enqueue_time;
+  stats_.max_queueing_delay =
+      std::max(stats_.max_queueing_delay, packet.queueing_delay);
+  if (config_.bandwidth <= 0) {
+    OnPacketTransmitted();
+    return;
+  }
+  const int64_t bits = static_cast<int64_t>(packet.data.size()) * 8;
+  const Clock::duration transmit_time =
+      Clock::to_duration(seconds(1)) * bits / config_.bandwidth;
+  task_runner_->PostTaskWithDelay([this] { OnPacketTransmitted(); },
+                                  transmit_time);
+}
+
+void SimulatedLink::OnPacketTransmitted() {
+  QueuedPacket packet = std::move(queue_.front());
+  queue_.pop_front();
+  queued_bytes_ -= static_cast<int>(packet.data.size());
+  stats_.total_queueing_delay += packet.queueing_delay;
+
+  if (ShouldLoseNextPacket()) {
+    ++stats_.packets_lost;
+  } else {
+    const Clock::time_point now = now_function_();
+    Clock::time_point arrival_time = now + config_.delay;
+    if (config_.jitter > Clock::duration::zero()) {
+      arrival_time += Clock::duration(std::uniform_int_distribution<int64_t>(
+          0, config_.jitter.count())(rand_));
+    }
+    if (config_.reorder_probability > 0 &&
+        std::bernoulli_distribution(config_.reorder_probability)(rand_)) {
+      arrival_time += config_.reorder_delay;
+    } else {
+      arrival_time = std::max(arrival_time, latest_arrival_time_);
+      latest_arrival_time_ = arrival_time;
+    }
+
+    ++stats_.packets_delivered;
+    stats_.bytes_delivered += packet.data.size();
+    task_runner_->PostTaskWithDelay(
+        [this, source = packet.source,
+         data = std::move(packet.data)]() mutable {
+          destination_->DeliverPacket(source, std::move(data));
+        },
+        arrival_time - now);
+  }
+
+  if (!queue_.empty()) {
+    TransmitNextPacket();
+  }
+}
+
+bool SimulatedLink::ShouldLoseNextPacket() {
+  const double transition_probability = is_in_bad_state_
+                                            ? config_.bad_to_good_probability
+                                            : config_.good_to_bad_probability;
+  if (transition_probability > 0 &&
+      std::bernoulli_distribution(transition_probability)(rand_)) {
+    is_in_bad_state_ = !is_in_bad_state_;
+  }
+  const double loss_probability = is_in_bad_state_
+                                      ? config_.bad_loss_probability
+                                      : config_.good_loss_probability;
+  return loss_probability > 0 &&
+         std::bernoulli_distribution(loss_probability)(rand_);
+}
+
+SimulatedEnvironment::SimulatedEnvironment(ClockNowFunctionPtr now_function,
+                                           TaskRunner& task_runner,
+                                           const IPEndpoint& local_endpoint)
+    : Environment(now_function, task_runner),
+      local_endpoint_(local_endpoint) {
+  SetSocketStateForTesting(SocketState::kReady);
+}
+
+SimulatedEnvironment::~SimulatedEnvironment() = default;
+
+void SimulatedEnvironment::DeliverPacket(const IPEndpoint& source,
+                                         std::vector<uint8_t> packet) {
+  UdpPacket udp_packet(packet.begin(), packet.end());
+  udp_packet.set_source(source);
+  udp_packet.set_destination(local_endpoint_);
+  // Environment's UdpSocket::Client implementation is private, since only its
+  // own socket is expected to call it.
+  static_cast<UdpSocket::Client*>(this)->OnRead(nullptr, std::move(udp_packet));
+}
+
+IPEndpoint SimulatedEnvironment::GetBoundLocalEndpoint() const {
+  return local_endpoint_;
+}
+
+void SimulatedEnvironment::SendPacket(ByteView packet,
+                                      PacketMetadata metadata) {
+  OSP_CHECK(outbound_link_);
+  outbound_link_->Send(local_endpoint_,
+                       std::vector<uint8_t>(packet.begin(), packet.end()));
+}
+
+void SimulatedEnvironment::SendPackets(
+    std::span<const UdpSocket::GatheredMessage> packets,
+    std::span<const PacketMetadata> metadata) {
+  SendPacketsTo(remote_endpoint(), packets, metadata);
+}
+
+void SimulatedEnvironment::SendPacketsTo(
+    const IPEndpoint& destination,
+    std::span<const UdpSocket::GatheredMessage> packets,
+    std::span<const PacketMetadata> metadata) {
+  OSP_CHECK(outbound_link_);
+  OSP_CHECK_EQ(packets.size(), metadata.size());
+  for (const UdpSocket::GatheredMessage& packet : packets) {
+    std::vector<uint8_t> data;
+    data.reserve(packet.size());
+    data.insert(data.end(), packet.header.begin(), packet.header.end());
+    data.insert(data.end(), packet.payload.begin(), packet.payload.end());
+    outbound_link_->Send(local_endpoint_, std::move(data));
+  }
+}
+
+SimulatedNetwork::SimulatedNetwork(
+    ClockNowFunctionPtr now_function,
+    TaskRunner& task_runner,
+    const SimulatedLinkConfig& sender_to_receiver,
+    const SimulatedLinkConfig& receiver_to_sender,
+    uint32_t seed)
+    : sender_environment_(now_function,
+                          task_runner,
+                          IPEndpoint{IPAddress(192, 0, 2, 1), 2344}),
+      receiver_environment_(now_function,
+                            task_runner,
+                            IPEndpoint{IPAddress(192, 0, 2, 2), 2344}),
+      sender_to_receiver_(now_function,
+                          task_runner,
+                          receiver_environment_,
+                          sender_to_receiver,
+                          seed),
+      receiver_to_sender_(now_function,
+                          task_runner,
+                          sender_environment_,
+                          receiver_to_sender,
+                          seed + 1) {
+  sender_environment_.set_remote_endpoint(
+      receiver_environment_.GetBoundLocalEndpoint());
+  sender_environment_.set_outbound_link(&sender_to_receiver_);
+  receiver_environment_.set_remote_endpoint(
+      sender_environment_.GetBoundLocalEndpoint());
+  receiver_environment_.set_outbound_link(&receiver_to_sender_);
+}
+
+SimulatedNetwork::~SimulatedNetwork() = default;
+
+}  // namespace openscreen::cast
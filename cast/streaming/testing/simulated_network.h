@@ -0,0 +1,190 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAST_STREAMING_TESTING_SIMULATED_NETWORK_H_
+#define CAST_STREAMING_TESTING_SIMULATED_NETWORK_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "cast/streaming/public/environment.h"
+#include "platform/api/task_runner.h"
+#include "platform/api/time.h"
+#include "platform/base/ip_address.h"
+#include "util/chrono_helpers.h"
+#include "util/raw_ptr.h"
+#include "util/raw_ref.h"
+
+namespace openscreen::cast {
+
+class SimulatedEnvironment;
+
+// The characteristics of one direction of a SimulatedNetwork.
+struct SimulatedLinkConfig {
+  // The capacity of the link, in bits per second, or zero for unlimited.
+  int bandwidth = 0;
+
+  // The capacity of the drop-tail queue in front of the link, in bytes, or zero
+  // for unlimited. Packets that arrive while the queue is full are dropped.
+  int queue_size = 0;
+
+  // The propagation delay of every packet, plus a uniformly-random amount of
+  // up to `jitter`. Jitter alone never reorders packets.
+  Clock::duration delay{};
+  Clock::duration jitter{};
+
+  // The probability that a packet is held back by an extra `reorder_delay`,
+  // letting the packets sent after it overtake it.
+  double reorder_probability = 0;
+  Clock::duration reorder_delay = milliseconds(20);
+
+  // Packet loss, according to the Gilbert-Elliott model: The link is either in
+  // the "good" or the "bad" state, each with its own loss probability, and
+  // switches state before each packet with the given transition
+  // probabilities. With the defaults, the link is always in the good state,
+  // and so `good_loss_probability` alone gives a uniformly-random loss.
+  double good_loss_probability = 0;
+  double bad_loss_probability = 1;
+  double good_to_bad_probability = 0;
+  double bad_to_good_probability = 1;
+};
+
+// Simulates one direction of a network path: a drop-tail queue in front of a
+// bottleneck link, followed by a lossy, jittery propagation delay. Everything
+// happens in tasks posted to the TaskRunner, so that a FakeClock can run the
+// simulation deterministically, and faster than real time.
+class SimulatedLink {
+ public:
+  struct Stats {
+    int packets_sent = 0;
+    int packets_dropped_by_queue = 0;
+    int packets_lost = 0;
+    int packets_delivered = 0;
+    int64_t bytes_delivered = 0;
+
+    // The total and maximum time that the transmitted packets, whether
+    // delivered or lost, spent in the queue.
+    Clock::duration total_queueing_delay{};
+    Clock::duration max_queueing_delay{};
+  };
+
+  // Packets are delivered to `destination`. `seed` seeds the random number
+  // generator, so that simulations are repeatable.
+  SimulatedLink(ClockNowFunctionPtr now_function,
+                TaskRunner& task_runner,
+                SimulatedEnvironment& destination,
+                const SimulatedLinkConfig& config,
+                uint32_t seed);
+  ~SimulatedLink();
+
+  const SimulatedLinkConfig& config() const { return config_; }
+  // Changes the characteristics of the link, effective for the packets sent
+  // from now on, and the packet being transmitted next.
+  void set_config(const SimulatedLinkConfig& config) { config_ = config; }
+
+  const Stats& stats() const { return stats_; }
+
+  // Sends a `packet` from `source` over the link.
+  void Send(const IPEndpoint& source, std::vector<uint8_t> packet);
+
+ private:
+  struct QueuedPacket {
+    IPEndpoint source;
+    std::vector<uint8_t> data;
+    Clock::time_point enqueue_time;
+    Clock::duration queueing_delay{};
+  };
+
+  // Starts transmitting the packet at the front of the queue.
+  void TransmitNextPacket();
+
+  // Called when the packet at the front of the queue has been transmitted, to
+  // propagate it to the destination.
+  void OnPacketTransmitted();
+
+  // Returns true if the next packet should be lost, advancing the
+  // Gilbert-Elliott model's state.
+  bool ShouldLoseNextPacket();
+
+  const ClockNowFunctionPtr now_function_;
+  const raw_ref<TaskRunner> task_runner_;
+  const raw_ref<SimulatedEnvironment> destination_;
+  SimulatedLinkConfig config_;
+  std::minstd_rand rand_;
+
+  std::deque<QueuedPacket> queue_;
+  int queued_bytes_ = 0;
+
+  // Whether the Gilbert-Elliott model is in the bad state.
+  bool is_in_bad_state_ = false;
+
+  // The latest arrival time of the packets that have not been reordered. Jitter
+  // does not let later packets arrive before this.
+  Clock::time_point latest_arrival_time_;
+
+  Stats stats_;
+};
+
+// An Environment that sends its packets over a SimulatedLink, and receives
+// those delivered to it by another SimulatedLink, instead of using its UDP
+// socket.
+class SimulatedEnvironment : public Environment {
+ public:
+  SimulatedEnvironment(ClockNowFunctionPtr now_function,
+                       TaskRunner& task_runner,
+                       const IPEndpoint& local_endpoint);
+  ~SimulatedEnvironment() override;
+
+  void set_outbound_link(SimulatedLink* link) { outbound_link_ = link; }
+
+  // Delivers a `packet` from `source` to the Environment's PacketConsumer, if
+  // any.
+  void DeliverPacket(const IPEndpoint& source, std::vector<uint8_t> packet);
+
+  // Environment overrides.
+  IPEndpoint GetBoundLocalEndpoint() const override;
+  void SendPacket(ByteView packet, PacketMetadata metadata) override;
+  void SendPackets(std::span<const UdpSocket::GatheredMessage> packets,
+                   std::span<const PacketMetadata> metadata) override;
+  void SendPacketsTo(const IPEndpoint& destination,
+                     std::span<const UdpSocket::GatheredMessage> packets,
+                     std::span<const PacketMetadata> metadata) override;
+
+ private:
+  const IPEndpoint local_endpoint_;
+  raw_ptr<SimulatedLink> outbound_link_ = nullptr;
+};
+
+// A pair of SimulatedEnvironments, one for a Sender and one for its Receiver,
+// connected by a SimulatedLink in each direction.
+class SimulatedNetwork {
+ public:
+  SimulatedNetwork(ClockNowFunctionPtr now_function,
+                   TaskRunner& task_runner,
+                   const SimulatedLinkConfig& sender_to_receiver,
+                   const SimulatedLinkConfig& receiver_to_sender,
+                   uint32_t seed = 1);
+  ~SimulatedNetwork();
+
+  SimulatedEnvironment& sender_environment() { return sender_environment_; }
+  SimulatedEnvironment& receiver_environment() {
+    return receiver_environment_;
+  }
+  SimulatedLink& sender_to_receiver() { return sender_to_receiver_; }
+  SimulatedLink& receiver_to_sender() { return receiver_to_sender_; }
+
+ private:
+  SimulatedEnvironment sender_environment_;
+  SimulatedEnvironment receiver_environment_;
+  SimulatedLink sender_to_receiver_;
+  SimulatedLink receiver_to_sender_;
+};
+
+}  // namespace openscreen::cast
+
+#endif  // CAST_STREAMING_TESTING_SIMULATED_NETWORK_H_
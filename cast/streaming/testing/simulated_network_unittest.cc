@@ -0,0 +1,205 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/streaming/testing/simulated_network.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/base/udp_packet.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/chrono_helpers.h"
+
+namespace openscreen::cast {
+namespace {
+
+using testing::ElementsAre;
+
+// Records the sequence numbers of the packets delivered to an Environment,
+// along with their arrival times.
+class RecordingConsumer : public Environment::PacketConsumer {
+ public:
+  struct Arrival {
+    int sequence_number;
+    Clock::time_point arrival_time;
+  };
+
+  void OnReceivedPacket(const IPEndpoint& source,
+                        Clock::time_point arrival_time,
+                        UdpPacket packet) override {
+    arrivals.push_back(Arrival{packet[0] << 8 | packet[1], arrival_time});
+  }
+
+  std::vector<int> sequence_numbers() const {
+    std::vector<int> result;
+    for (const Arrival& arrival : arrivals) {
+      result.push_back(arrival.sequence_number);
+    }
+    return result;
+  }
+
+  std::vector<Arrival> arrivals;
+};
+
+class SimulatedNetworkTest : public testing::Test {
+ public:
+  SimulatedNetworkTest() : clock_(Clock::now()), task_runner_(clock_) {}
+
+  void CreateNetwork(const SimulatedLinkConfig& config) {
+    network_ = std::make_unique<SimulatedNetwork>(
+        &FakeClock::now, task_runner_, config, SimulatedLinkConfig{});
+    network_->receiver_environment().ConsumeIncomingPackets(&consumer_);
+  }
+
+  // Sends `count` packets of `size` bytes from the sender, numbered from zero.
+  void SendPackets(int count, int size) {
+    for (int i = 0; i < count; ++i) {
+      std::vector<uint8_t> packet(size);
+      packet[0] = static_cast<uint8_t>(i >> 8);
+      packet[1] = static_cast<uint8_t>(i);
+      network_->sender_environment().SendPacket(packet, PacketMetadata{});
+    }
+  }
+
+ protected:
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  RecordingConsumer consumer_;
+  std::unique_ptr<SimulatedNetwork> network_;
+};
+
+TEST_F(SimulatedNetworkTest, SerializesPacketsAtTheLinkBandwidth) {
+  CreateNetwork(SimulatedLinkConfig{.bandwidth = 1'000'000,
+                                    .delay = milliseconds(30)});
+  const Clock::time_point start_time = FakeClock::now();
+  // Each packet takes 10 ms to transmit at 1 Mbps.
+  SendPackets(3, 1250);
+  clock_.Advance(seconds(1));
+
+  ASSERT_EQ(3u, consumer_.arrivals.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(i, consumer_.arrivals[i].sequence_number);
+    EXPECT_EQ(start_time + milliseconds(10 * (i + 1) + 30),
+              consumer_.arrivals[i].arrival_time);
+  }
+  EXPECT_EQ(milliseconds(0 + 10 + 20),
+            network_->sender_to_receiver().stats().total_queueing_delay);
+  EXPECT_EQ(milliseconds(20),
+            network_->sender_to_receiver().stats().max_queueing_delay);
+  EXPECT_EQ(3 * 1250,
+            network_->sender_to_receiver().stats().bytes_delivered);
+}
+
+TEST_F(SimulatedNetworkTest, DropsPacketsWhenTheQueueIsFull) {
+  CreateNetwork(
+      SimulatedLinkConfig{.bandwidth = 1'000'000, .queue_size = 5000});
+  SendPackets(10, 1000);
+  clock_.Advance(seconds(1));
+
+  EXPECT_THAT(consumer_.sequence_numbers(), ElementsAre(0, 1, 2, 3, 4));
+  EXPECT_EQ(5,
+            network_->sender_to_receiver().stats().packets_dropped_by_queue);
+}
+
+TEST_F(SimulatedNetworkTest, JitterDoesNotReorderPackets) {
+  CreateNetwork(SimulatedLinkConfig{.bandwidth = 10'000'000,
+                                    .delay = milliseconds(10),
+                                    .jitter = milliseconds(20)});
+  const Clock::time_point start_time = FakeClock::now();
+  SendPackets(1000, 100);
+  clock_.Advance(seconds(1));
+
+  ASSERT_EQ(1000u, consumer_.arrivals.size());
+  const std::vector<int> sequence_numbers = consumer_.sequence_numbers();
+  EXPECT_TRUE(
+      std::is_sorted(sequence_numbers.begin(), sequence_numbers.end()));
+  // All packets are transmitted within 80 ms, so the jitter shows up as
+  // arrivals later than that plus the propagation delay.
+  EXPECT_LT(start_time + milliseconds(90),
+            consumer_.arrivals.back().arrival_time);
+}
+
+TEST_F(SimulatedNetworkTest, ReordersPackets) {
+  CreateNetwork(SimulatedLinkConfig{.bandwidth = 10'000'000,
+                                    .delay = milliseconds(10),
+                                    .reorder_probability = 0.1});
+  SendPackets(1000, 100);
+  clock_.Advance(seconds(1));
+
+  ASSERT_EQ(1000u, consumer_.arrivals.size());
+  int num_reordered = 0;
+  for (size_t i = 1; i < consumer_.arrivals.size(); ++i) {
+    if (consumer_.arrivals[i].sequence_number <
+        consumer_.arrivals[i - 1].sequence_number) {
+      ++num_reordered;
+    }
+  }
+  EXPECT_NEAR(100, num_reordered, 40);
+}
+
+// Tests that the Gilbert-Elliott model loses packets in bursts, at the rate
+// implied by its parameters.
+TEST_F(SimulatedNetworkTest, LosesPacketsInBursts) {
+  CreateNetwork(SimulatedLinkConfig{.bad_loss_probability = 1,
+                                    .good_to_bad_probability = 0.02,
+                                    .bad_to_good_probability = 0.25});
+  constexpr int kNumPackets = 10000;
+  SendPackets(kNumPackets, 100);
+  clock_.Advance(seconds(1));
+
+  // The link spends 0.02 / (0.02 + 0.25), or about 7.4%, of the time in the bad
+  // state, in which every packet is lost. Bursts last 1 / 0.25, or 4, packets
+  // on average.
+  const std::vector<int> received = consumer_.sequence_numbers();
+  const int num_lost = kNumPackets - static_cast<int>(received.size());
+  EXPECT_EQ(num_lost, network_->sender_to_receiver().stats().packets_lost);
+  EXPECT_NEAR(0.074 * kNumPackets, num_lost, 0.02 * kNumPackets);
+  int num_bursts = 0;
+  int previous = -1;
+  for (const int sequence_number : received) {
+    if (sequence_number != previous + 1) {
+      ++num_bursts;
+    }
+    previous = sequence_number;
+  }
+  EXPECT_NEAR(4.0, static_cast<double>(num_lost) / num_bursts, 1.0);
+}
+
+// Tests that the same seed produces the same simulation.
+TEST_F(SimulatedNetworkTest, IsDeterministic) {
+  const SimulatedLinkConfig config{.bandwidth = 5'000'000,
+                                   .delay = milliseconds(10),
+                                   .jitter = milliseconds(5),
+                                   .reorder_probability = 0.05,
+                                   .good_loss_probability = 0.05};
+  CreateNetwork(config);
+  SendPackets(500, 1000);
+  clock_.Advance(seconds(2));
+  const std::vector<RecordingConsumer::Arrival> first_run =
+      std::move(consumer_.arrivals);
+  const Clock::time_point first_start_time = FakeClock::now() - seconds(2);
+
+  consumer_.arrivals.clear();
+  network_.reset();
+  CreateNetwork(config);
+  SendPackets(500, 1000);
+  clock_.Advance(seconds(2));
+  const Clock::time_point second_start_time = FakeClock::now() - seconds(2);
+
+  ASSERT_EQ(first_run.size(), consumer_.arrivals.size());
+  for (size_t i = 0; i < first_run.size(); ++i) {
+    EXPECT_EQ(first_run[i].sequence_number,
+              consumer_.arrivals[i].sequence_number);
+    EXPECT_EQ(first_run[i].arrival_time - first_start_time,
+              consumer_.arrivals[i].arrival_time - second_start_time);
+  }
+}
+
+}  // namespace
+}  // namespace openscreen::cast
@@ -0,0 +1,153 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "discovery/dnssd/impl/dns_data_graph.h"
+#include "discovery/mdns/testing/mdns_test_util.h"
+#include "gtest/gtest.h"
+#include "platform/api/time.h"
+#include "platform/base/ip_address.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::discovery {
+namespace {
+
+constexpr NetworkInterfaceIndex kNetworkInterface = 1234;
+constexpr int kNumInstances = 500;
+constexpr int kNumRounds = 4;
+
+void IgnoreDomainChange(const DomainName&) {}
+
+MdnsRecord CreateARecord(const DomainName& name, const IPAddress& address) {
+  return MdnsRecord(name, DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                    std::chrono::seconds(120), ARecordRdata(address));
+}
+
+// Creates a graph holding one complete service instance on each of `hosts`.
+std::unique_ptr<DnsDataGraph> CreatePopulatedGraph(
+    const std::vector<DomainName>& hosts) {
+  std::unique_ptr<DnsDataGraph> graph = DnsDataGraph::Create(kNetworkInterface);
+  graph->StartTracking(DomainName{"_cast", "_tcp", "local"},
+                       &IgnoreDomainChange);
+  for (size_t i = 0; i < hosts.size(); i++) {
+    const DomainName instance{"instance" + std::to_string(i), "_cast", "_tcp",
+                              "local"};
+    const std::vector<MdnsRecord> records{
+        GetFakePtrRecord(instance),
+        GetFakeTxtRecord(instance),
+        GetFakeSrvRecord(instance, hosts[i]),
+        GetFakeAAAARecord(hosts[i]),
+        CreateARecord(hosts[i], IPAddress(10, 0, 0, 1)),
+    };
+    for (const MdnsRecord& record : records) {
+      EXPECT_TRUE(graph
+                      ->ApplyDataRecordChange(record,
+                                              RecordChangedEvent::kCreated,
+                                              &IgnoreDomainChange,
+                                              &IgnoreDomainChange)
+                      .ok());
+    }
+  }
+  EXPECT_EQ(graph->TakeEndpointChanges().new_endpoints.size(), hosts.size());
+  return graph;
+}
+
+int NanosecondsPer(Clock::duration time, int count) {
+  return static_cast<int>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() /
+      count);
+}
+
+}  // namespace
+
+// Applies the same record changes to two identically populated graphs: one
+// reports the changed endpoints it tracked while applying each change, and the
+// other finds them the way callers did before, by recomputing the endpoints of
+// the changed host before and after the change. Both timings include applying
+// the change itself.
+TEST(DnsDataGraphBenchmarkTest, AddressFlaps) {
+  std::vector<DomainName> hosts;
+  for (int i = 0; i < kNumInstances; i++) {
+    hosts.push_back(DomainName{"host" + std::to_string(i), "local"});
+  }
+  std::unique_ptr<DnsDataGraph> incremental_graph =
+      CreatePopulatedGraph(hosts);
+  std::unique_ptr<DnsDataGraph> recompute_graph = CreatePopulatedGraph(hosts);
+
+  // Each round flaps the IPv4 address of every host, then refreshes the TTL of
+  // its IPv6 address, which does not change any endpoint.
+  size_t endpoints_returned = 0;
+  size_t endpoints_recomputed = 0;
+  Clock::duration incremental_time{};
+  Clock::duration recompute_time{};
+  for (int round = 0; round < kNumRounds; round++) {
+    const IPAddress address(10, 0, 0, round % 2 ? 1 : 2);
+    const std::chrono::seconds ttl(121 + round);
+    for (const DomainName& host : hosts) {
+      const std::vector<MdnsRecord> changes{
+          CreateARecord(host, address),
+          GetFakeAAAARecord(host, ttl),
+      };
+      for (const MdnsRecord& record : changes) {
+        Clock::time_point start = Clock::now();
+        const bool incremental_ok =
+            incremental_graph
+                ->ApplyDataRecordChange(record, RecordChangedEvent::kUpdated,
+                                        &IgnoreDomainChange,
+                                        &IgnoreDomainChange)
+                .ok();
+        DnsDataGraph::EndpointChanges endpoint_changes =
+            incremental_graph->TakeEndpointChanges();
+        incremental_time += Clock::now() - start;
+        EXPECT_TRUE(incremental_ok);
+        endpoints_returned += endpoint_changes.new_endpoints.size();
+
+        start = Clock::now();
+        std::vector<ErrorOr<DnsSdInstanceEndpoint>> old_endpoints =
+            recompute_graph->CreateEndpoints(
+                DnsDataGraph::DomainGroup::kAddress, host);
+        const bool recompute_ok =
+            recompute_graph
+                ->ApplyDataRecordChange(record, RecordChangedEvent::kUpdated,
+                                        &IgnoreDomainChange,
+                                        &IgnoreDomainChange)
+                .ok();
+        std::vector<ErrorOr<DnsSdInstanceEndpoint>> new_endpoints =
+            recompute_graph->CreateEndpoints(
+                DnsDataGraph::DomainGroup::kAddress, host);
+        recompute_time += Clock::now() - start;
+        EXPECT_TRUE(recompute_ok);
+        endpoints_recomputed += old_endpoints.size() + new_endpoints.size();
+        recompute_graph->TakeEndpointChanges();
+      }
+    }
+  }
+
+  const int num_changes = kNumInstances * kNumRounds * 2;
+  EXPECT_EQ(endpoints_returned, size_t{kNumInstances * kNumRounds});
+  EXPECT_EQ(endpoints_recomputed, size_t{2 * num_changes});
+
+  OSP_LOG_INFO << "Address flaps on " << kNumInstances << " instances: "
+               << num_changes << " record changes returned "
+               << endpoints_returned << " changed endpoints in "
+               << NanosecondsPer(incremental_time, num_changes)
+               << " ns per change, vs. recomputing " << endpoints_recomputed
+               << " endpoints around each change in "
+               << NanosecondsPer(recompute_time, num_changes)
+               << " ns per change";
+  RecordProperty("address_flap_endpoints_returned",
+                 static_cast<int>(endpoints_returned));
+  RecordProperty("address_flap_endpoints_recomputed",
+                 static_cast<int>(endpoints_recomputed));
+  RecordProperty("address_flap_incremental_ns_per_change",
+                 NanosecondsPer(incremental_time, num_changes));
+  RecordProperty("address_flap_recompute_ns_per_change",
+                 NanosecondsPer(recompute_time, num_changes));
+}
+
+}  // namespace openscreen::discovery
@@ -5,6 +5,7 @@
 #include "discovery/dnssd/impl/dns_data_graph.h"
 
 #include <optional>
+#include <set>
 #include <utility>
 #include <variant>
 
@@ -44,6 +45,16 @@ ErrorOr<DnsSdInstanceEndpoint> CreateEndpoint(
       network_interface, std::move(endpoints));
 }
 
+// ErrorOr<> is move-only, so an explicit copy is needed to both cache an
+// endpoint and report it.
+ErrorOr<DnsSdInstanceEndpoint> CopyEndpoint(
+    const ErrorOr<DnsSdInstanceEndpoint>& endpoint) {
+  if (endpoint.is_error()) {
+    return endpoint.error();
+  }
+  return endpoint.value();
+}
+
 class DnsDataGraphImpl : public DnsDataGraph {
  public:
   using DnsDataGraph::DomainChangeCallback;
@@ -69,6 +80,8 @@ class DnsDataGraphImpl : public DnsDataGraph {
       DomainGroup domain_group,
       const DomainName& name) const override;
 
+  EndpointChanges TakeEndpointChanges() override;
+
   Error ApplyDataRecordChange(MdnsRecord record,
                               RecordChangedEvent event,
                               DomainChangeCallback on_start_tracking,
@@ -130,6 +143,10 @@ class DnsDataGraphImpl : public DnsDataGraph {
     // Applies the specified change to domain `child` for this node.
     void ApplyChildChange(DomainName child_name, RecordChangedEvent event);
 
+    // Marks the service instances whose endpoints depend on the records of type
+    // `type` at this node as needing to be recomputed.
+    void MarkEndpointsDirty(DnsType type, const DomainName& child_name);
+
     // Finds an iterator to the record of the provided type, or to
     // records_.end() if no such record exists.
     std::vector<MdnsRecord>::iterator FindRecord(DnsType type);
@@ -194,6 +211,18 @@ class DnsDataGraphImpl : public DnsDataGraph {
   std::vector<ErrorOr<DnsSdInstanceEndpoint>> CalculatePtrRecordEndpoints(
       Node* node) const;
 
+  // Calculates the DnsSdInstanceEndpoints of the service instance represented
+  // by the SRV and TXT records at `node`.
+  std::vector<ErrorOr<DnsSdInstanceEndpoint>> CalculateInstanceEndpoints(
+      Node* node) const;
+
+  // Creates the DnsSdInstanceEndpoint of the service instance represented by
+  // `srv_and_txt` with addresses from `address`, or returns std::nullopt if the
+  // data required for such an endpoint has not been received.
+  std::optional<ErrorOr<DnsSdInstanceEndpoint>> TryCreateEndpoint(
+      Node* srv_and_txt,
+      Node* address) const;
+
   // Denotes whether the dtor for this instance has been called. This is
   // required for validation of Node instance functionality. See the
   // implementation of DnsDataGraph::Node::~Node() for more details.
@@ -203,6 +232,15 @@ class DnsDataGraphImpl : public DnsDataGraph {
   // name.
   std::map<DomainName, std::unique_ptr<Node>> nodes_;
 
+  // Map from the domain name of each service instance with endpoints to the
+  // endpoints last returned for it by TakeEndpointChanges().
+  std::map<DomainName, std::vector<ErrorOr<DnsSdInstanceEndpoint>>>
+      instance_endpoints_;
+
+  // Domain names of the service instances whose endpoints must be recomputed
+  // by the next call to TakeEndpointChanges().
+  std::set<DomainName> dirty_instances_;
+
   const NetworkInterfaceIndex network_interface_;
 
   // The methods to be called when a domain name either starts or stops being
@@ -234,6 +272,9 @@ DnsDataGraphImpl::Node::~Node() {
       RemoveChild(child);
     }
 
+    // Any endpoint of the instance at this domain is now gone.
+    graph_->dirty_instances_.insert(name_);
+
     OSP_CHECK(graph_->on_node_deletion_);
     graph_->on_node_deletion_(name_);
   }
@@ -265,6 +306,12 @@ Error DnsDataGraphImpl::Node::ApplyDataRecordChange(MdnsRecord record,
     it = FindRecord(record.dns_type());
   }
 
+  // Updates which only refresh the TTL of a record do not affect endpoints.
+  const DnsType type = record.dns_type();
+  const bool changes_rdata = event != RecordChangedEvent::kUpdated ||
+                             it == records_.end() ||
+                             it->rdata() != record.rdata();
+
   // Validate that the requested change is allowed and apply it.
   switch (event) {
     case RecordChangedEvent::kCreated:
@@ -289,6 +336,10 @@ Error DnsDataGraphImpl::Node::ApplyDataRecordChange(MdnsRecord record,
       break;
   }
 
+  if (changes_rdata) {
+    MarkEndpointsDirty(type, child_name);
+  }
+
   // Apply any required edge changes to the graph. This is only applicable if
   // a `child` was found earlier. Note that the same child can be added multiple
   // times to the `children_` vector, which simplifies the code dramatically.
@@ -318,6 +369,31 @@ void DnsDataGraphImpl::Node::ApplyChildChange(DomainName child_name,
   }
 }
 
+void DnsDataGraphImpl::Node::MarkEndpointsDirty(DnsType type,
+                                                const DomainName& child_name) {
+  switch (GetDomainGroup(type)) {
+    case DomainGroup::kPtr:
+      // PTR records only determine which instances are tracked.
+      graph_->dirty_instances_.insert(child_name);
+      break;
+
+    case DomainGroup::kSrvAndTxt:
+      graph_->dirty_instances_.insert(name_);
+      break;
+
+    case DomainGroup::kAddress:
+      // Address records are shared by all instances whose SRV record targets
+      // this domain, which may include this node itself.
+      for (const Node* parent : parents_) {
+        graph_->dirty_instances_.insert(parent->name());
+      }
+      break;
+
+    case DomainGroup::kNone:
+      break;
+  }
+}
+
 void DnsDataGraphImpl::Node::AddChild(Node* child) {
   OSP_CHECK(child);
   children_.push_back(child);
@@ -407,6 +483,18 @@ void DnsDataGraphImpl::StopTracking(const DomainName& domain,
   it->second.reset();
   const size_t erased_count = nodes_.erase(domain);
   OSP_CHECK(erased_count);
+
+  // Instances which are no longer tracked are dropped without being reported
+  // as deleted.
+  for (auto dirty_it = dirty_instances_.begin();
+       dirty_it != dirty_instances_.end();) {
+    if (IsTracked(*dirty_it)) {
+      ++dirty_it;
+    } else {
+      instance_endpoints_.erase(*dirty_it);
+      dirty_it = dirty_instances_.erase(dirty_it);
+    }
+  }
 }
 
 Error DnsDataGraphImpl::ApplyDataRecordChange(
@@ -475,46 +563,53 @@ std::vector<ErrorOr<DnsSdInstanceEndpoint>> DnsDataGraphImpl::CreateEndpoints(
   std::vector<ErrorOr<DnsSdInstanceEndpoint>> endpoints;
   for (Node* srv_and_txt : srv_and_txt_record_nodes) {
     for (Node* address : address_record_nodes) {
-      // First, there has to be a SRV record present (to provide the port
-      // number), and the target of that SRV record has to be the node where the
-      // address records are sourced from.
-      const std::optional<SrvRecordRdata> srv =
-          srv_and_txt->GetRdata<SrvRecordRdata>(DnsType::kSRV);
-      if (!srv.has_value() || srv.value().target() != address->name()) {
-        continue;
+      std::optional<ErrorOr<DnsSdInstanceEndpoint>> endpoint =
+          TryCreateEndpoint(srv_and_txt, address);
+      if (endpoint.has_value()) {
+        endpoints.push_back(std::move(endpoint.value()));
       }
+    }
+  }
 
-      // Next, a TXT record must be present to provide additional connection
-      // information about the service per RFC 6763.
-      const std::optional<TxtRecordRdata> txt =
-          srv_and_txt->GetRdata<TxtRecordRdata>(DnsType::kTXT);
-      if (!txt.has_value()) {
-        continue;
-      }
+  return endpoints;
+}
 
-      // Last, at least one address record must be present to provide an
-      // endpoint for this instance.
-      const std::optional<ARecordRdata> a =
-          address->GetRdata<ARecordRdata>(DnsType::kA);
-      const std::optional<AAAARecordRdata> aaaa =
-          address->GetRdata<AAAARecordRdata>(DnsType::kAAAA);
-      if (!a.has_value() && !aaaa.has_value()) {
-        continue;
-      }
+std::optional<ErrorOr<DnsSdInstanceEndpoint>>
+DnsDataGraphImpl::TryCreateEndpoint(Node* srv_and_txt, Node* address) const {
+  // First, there has to be a SRV record present (to provide the port
+  // number), and the target of that SRV record has to be the node where the
+  // address records are sourced from.
+  const std::optional<SrvRecordRdata> srv =
+      srv_and_txt->GetRdata<SrvRecordRdata>(DnsType::kSRV);
+  if (!srv.has_value() || srv.value().target() != address->name()) {
+    return std::nullopt;
+  }
 
-      // Then use the above info to create an endpoint object. If an error
-      // occurs, this is only related to the one endpoint and its possible that
-      // other endpoints may still be valid, so only the one endpoint is treated
-      // as failing. For instance, a bad TXT record for service A will not
-      // affect the endpoints for service B.
-      ErrorOr<DnsSdInstanceEndpoint> endpoint =
-          CreateEndpoint(srv_and_txt->name(), a, aaaa, srv.value(), txt.value(),
-                         network_interface_);
-      endpoints.push_back(std::move(endpoint));
-    }
+  // Next, a TXT record must be present to provide additional connection
+  // information about the service per RFC 6763.
+  const std::optional<TxtRecordRdata> txt =
+      srv_and_txt->GetRdata<TxtRecordRdata>(DnsType::kTXT);
+  if (!txt.has_value()) {
+    return std::nullopt;
   }
 
-  return endpoints;
+  // Last, at least one address record must be present to provide an
+  // endpoint for this instance.
+  const std::optional<ARecordRdata> a =
+      address->GetRdata<ARecordRdata>(DnsType::kA);
+  const std::optional<AAAARecordRdata> aaaa =
+      address->GetRdata<AAAARecordRdata>(DnsType::kAAAA);
+  if (!a.has_value() && !aaaa.has_value()) {
+    return std::nullopt;
+  }
+
+  // Then use the above info to create an endpoint object. If an error
+  // occurs, this is only related to the one endpoint and its possible that
+  // other endpoints may still be valid, so only the one endpoint is treated
+  // as failing. For instance, a bad TXT record for service A will not
+  // affect the endpoints for service B.
+  return CreateEndpoint(srv_and_txt->name(), a, aaaa, srv.value(), txt.value(),
+                        network_interface_);
 }
 
 // static
@@ -558,6 +653,63 @@ DnsDataGraphImpl::CalculatePtrRecordEndpoints(Node* node) const {
   return endpoints;
 }
 
+std::vector<ErrorOr<DnsSdInstanceEndpoint>>
+DnsDataGraphImpl::CalculateInstanceEndpoints(Node* node) const {
+  std::vector<ErrorOr<DnsSdInstanceEndpoint>> endpoints;
+  if (!IsValidSrvAndTxtNode(node)) {
+    return endpoints;
+  }
+
+  for (Node* address : node->children()) {
+    std::optional<ErrorOr<DnsSdInstanceEndpoint>> endpoint =
+        TryCreateEndpoint(node, address);
+    if (endpoint.has_value()) {
+      endpoints.push_back(std::move(endpoint.value()));
+    }
+  }
+  return endpoints;
+}
+
+DnsDataGraph::EndpointChanges DnsDataGraphImpl::TakeEndpointChanges() {
+  EndpointChanges changes;
+  for (const DomainName& name : dirty_instances_) {
+    std::vector<ErrorOr<DnsSdInstanceEndpoint>> endpoints;
+    const auto node_it = nodes_.find(name);
+    if (node_it != nodes_.end()) {
+      endpoints = CalculateInstanceEndpoints(node_it->second.get());
+    }
+
+    auto cached_it = instance_endpoints_.find(name);
+    if (cached_it == instance_endpoints_.end()) {
+      if (endpoints.empty()) {
+        continue;
+      }
+      cached_it =
+          instance_endpoints_
+              .emplace(name, std::vector<ErrorOr<DnsSdInstanceEndpoint>>{})
+              .first;
+    } else if (cached_it->second == endpoints) {
+      continue;
+    }
+
+    std::vector<ErrorOr<DnsSdInstanceEndpoint>>& cached = cached_it->second;
+    for (ErrorOr<DnsSdInstanceEndpoint>& endpoint : cached) {
+      changes.old_endpoints.push_back(std::move(endpoint));
+    }
+    if (endpoints.empty()) {
+      instance_endpoints_.erase(cached_it);
+    } else {
+      for (const ErrorOr<DnsSdInstanceEndpoint>& endpoint : endpoints) {
+        changes.new_endpoints.push_back(CopyEndpoint(endpoint));
+      }
+      cached = std::move(endpoints);
+    }
+  }
+
+  dirty_instances_.clear();
+  return changes;
+}
+
 }  // namespace
 
 DnsDataGraph::~DnsDataGraph() = default;
@@ -103,6 +103,20 @@ class DnsDataGraph {
       DomainGroup domain_group,
       const DomainName& name) const = 0;
 
+  // The endpoints of the service instances affected by record changes, as they
+  // were before and after these changes.
+  struct EndpointChanges {
+    std::vector<ErrorOr<DnsSdInstanceEndpoint>> old_endpoints;
+    std::vector<ErrorOr<DnsSdInstanceEndpoint>> new_endpoints;
+  };
+
+  // Returns the changes to the endpoints of all service instances affected by
+  // calls to ApplyDataRecordChange() since the last call to this method.
+  // Endpoints are cached per service instance, so only the instances whose
+  // records, or whose address records, changed are recomputed, and instances
+  // whose endpoints did not change are not returned.
+  virtual EndpointChanges TakeEndpointChanges() = 0;
+
   // Modifies this entity with the provided DnsRecord. If called with a valid
   // record type, the provided change will only be applied if the provided event
   // is valid at the time of calling. The returned result will be an error if
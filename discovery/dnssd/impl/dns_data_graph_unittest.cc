@@ -4,7 +4,9 @@
 
 #include "discovery/dnssd/impl/dns_data_graph.h"
 
+#include <chrono>
 #include <utility>
+#include <vector>
 
 #include "discovery/mdns/testing/mdns_test_util.h"
 #include "gmock/gmock.h"
@@ -32,6 +34,11 @@ IPAddress GetAddressV6(const DnsSdInstanceEndpoint endpoint) {
   return IPAddress{};
 }
 
+MdnsRecord CreateARecord(const DomainName& name, const IPAddress& address) {
+  return MdnsRecord(name, DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                    std::chrono::seconds(120), ARecordRdata(address));
+}
+
 }  // namespace
 
 using testing::_;
@@ -476,4 +483,95 @@ TEST_F(DnsDataGraphTests, FailedConversionOnlyFailsSingleEndpointCreation) {
   ExpectDomainEqual(endpoint, primary_domain_);
 }
 
+TEST_F(DnsDataGraphTests, EndpointChangesOnlyReportChangedInstances) {
+  auto ptr = GetFakePtrRecord(primary_domain_);
+  auto srv = GetFakeSrvRecord(primary_domain_, tertiary_domain_);
+  auto txt = GetFakeTxtRecord(primary_domain_);
+  auto ptr2 = GetFakePtrRecord(secondary_domain_);
+  auto srv2 = GetFakeSrvRecord(secondary_domain_, tertiary_domain_);
+  auto txt2 = GetFakeTxtRecord(secondary_domain_);
+  auto a = GetFakeARecord(tertiary_domain_);
+
+  TriggerRecordCreationWithCallback(ptr, primary_domain_);
+  TriggerRecordCreationWithCallback(srv, tertiary_domain_);
+  TriggerRecordCreation(txt);
+  EXPECT_TRUE(graph_->TakeEndpointChanges().new_endpoints.empty());
+
+  TriggerRecordCreation(a);
+  DnsDataGraph::EndpointChanges changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.old_endpoints.empty());
+  ASSERT_EQ(changes.new_endpoints.size(), size_t{1});
+  ASSERT_TRUE(changes.new_endpoints[0].is_value());
+  ExpectDomainEqual(changes.new_endpoints[0].value(), primary_domain_);
+
+  TriggerRecordCreationWithCallback(ptr2, secondary_domain_);
+  TriggerRecordCreation(srv2);
+  TriggerRecordCreation(txt2);
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.old_endpoints.empty());
+  ASSERT_EQ(changes.new_endpoints.size(), size_t{1});
+  ExpectDomainEqual(changes.new_endpoints[0].value(), secondary_domain_);
+
+  // A change to the shared address records affects both instances.
+  const MdnsRecord new_a =
+      CreateARecord(tertiary_domain_, IPAddress(192, 168, 1, 2));
+  EXPECT_TRUE(ApplyDataRecordChange(new_a, RecordChangedEvent::kUpdated).ok());
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_EQ(changes.old_endpoints.size(), size_t{2});
+  EXPECT_EQ(changes.new_endpoints.size(), size_t{2});
+
+  // An update which only refreshes the TTL affects no instance.
+  const MdnsRecord refreshed_a(new_a.name(), new_a.dns_type(),
+                               new_a.dns_class(), new_a.record_type(),
+                               new_a.ttl() + std::chrono::seconds(10),
+                               new_a.rdata());
+  EXPECT_TRUE(
+      ApplyDataRecordChange(refreshed_a, RecordChangedEvent::kUpdated).ok());
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.old_endpoints.empty());
+  EXPECT_TRUE(changes.new_endpoints.empty());
+
+  // Removing an instance only affects that instance.
+  EXPECT_CALL(callbacks_, OnStopTracking(primary_domain_));
+  EXPECT_TRUE(ApplyDataRecordChange(ptr, RecordChangedEvent::kExpired).ok());
+  testing::Mock::VerifyAndClearExpectations(&callbacks_);
+  changes = graph_->TakeEndpointChanges();
+  ASSERT_EQ(changes.old_endpoints.size(), size_t{1});
+  ExpectDomainEqual(changes.old_endpoints[0].value(), primary_domain_);
+  EXPECT_TRUE(changes.new_endpoints.empty());
+}
+
+TEST_F(DnsDataGraphTests, EndpointChangesNotReportedWhenTrackingStopped) {
+  auto ptr = GetFakePtrRecord(primary_domain_);
+  auto srv = GetFakeSrvRecord(primary_domain_, secondary_domain_);
+  auto txt = GetFakeTxtRecord(primary_domain_);
+  auto a = GetFakeARecord(secondary_domain_);
+
+  TriggerRecordCreationWithCallback(ptr, primary_domain_);
+  TriggerRecordCreation(txt);
+  TriggerRecordCreationWithCallback(srv, secondary_domain_);
+  TriggerRecordCreation(a);
+  EXPECT_EQ(graph_->TakeEndpointChanges().new_endpoints.size(), size_t{1});
+
+  EXPECT_CALL(callbacks_, OnStopTracking(ptr_domain_));
+  EXPECT_CALL(callbacks_, OnStopTracking(primary_domain_));
+  EXPECT_CALL(callbacks_, OnStopTracking(secondary_domain_));
+  StopTracking(ptr_domain_);
+  testing::Mock::VerifyAndClearExpectations(&callbacks_);
+  DnsDataGraph::EndpointChanges changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.old_endpoints.empty());
+  EXPECT_TRUE(changes.new_endpoints.empty());
+
+  // The instance is reported again once tracked again.
+  EXPECT_CALL(callbacks_, OnStartTracking(ptr_domain_));
+  StartTracking(ptr_domain_);
+  TriggerRecordCreationWithCallback(ptr, primary_domain_);
+  TriggerRecordCreation(txt);
+  TriggerRecordCreationWithCallback(srv, secondary_domain_);
+  TriggerRecordCreation(a);
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.old_endpoints.empty());
+  EXPECT_EQ(changes.new_endpoints.size(), size_t{1});
+}
+
 }  // namespace openscreen::discovery
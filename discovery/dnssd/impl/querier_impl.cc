@@ -324,22 +324,6 @@ std::vector<PendingQueryChange> QuerierImpl::OnRecordChanged(
         Error(Error::Code::kProcessReceivedRecordFailure));
   };
 
-  // Get the details to use for calling CreateEndpoints(). Special case PTR
-  // records to optimize performance.
-  const DomainName& create_endpoints_domain =
-      record.dns_type() != DnsType::kPTR
-          ? record.name()
-          : std::get<PtrRecordRdata>(record.rdata()).ptr_domain();
-  const DnsDataGraph::DomainGroup create_endpoints_group =
-      record.dns_type() != DnsType::kPTR
-          ? DnsDataGraph::GetDomainGroup(record)
-          : DnsDataGraph::DomainGroup::kSrvAndTxt;
-
-  // Get the current set of DnsSdInstanceEndpoints prior to this change. Special
-  // case PTR records to avoid iterating over unrelated child domains.
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> old_endpoints_or_errors =
-      graph_->CreateEndpoints(create_endpoints_group, create_endpoints_domain);
-
   // Apply the changes, creating a list of all pending changes that should be
   // applied afterwards.
   ErrorOr<std::vector<PendingQueryChange>> pending_changes_or_error =
@@ -354,9 +338,15 @@ std::vector<PendingQueryChange> QuerierImpl::OnRecordChanged(
   std::vector<PendingQueryChange>& pending_changes =
       pending_changes_or_error.value();
 
-  // Get the new set of DnsSdInstanceEndpoints following this change.
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> new_endpoints_or_errors =
-      graph_->CreateEndpoints(create_endpoints_group, create_endpoints_domain);
+  // Get the DnsSdInstanceEndpoints affected by this change, before and after
+  // it. Only the service instances depending on the changed record are
+  // considered.
+  DnsDataGraph::EndpointChanges endpoint_changes =
+      graph_->TakeEndpointChanges();
+  std::vector<ErrorOr<DnsSdInstanceEndpoint>>& old_endpoints_or_errors =
+      endpoint_changes.old_endpoints;
+  std::vector<ErrorOr<DnsSdInstanceEndpoint>>& new_endpoints_or_errors =
+      endpoint_changes.new_endpoints;
 
   // Return early if the resulting sets are equal. This will frequently be the
   // case, especially when both sets are empty.
@@ -67,6 +67,8 @@ class MockDnsDataGraph : public DnsDataGraph {
       std::vector<ErrorOr<DnsSdInstanceEndpoint>>(DomainGroup,
                                                   const DomainName&));
 
+  MOCK_METHOD0(TakeEndpointChanges, EndpointChanges());
+
   MOCK_METHOD4(ApplyDataRecordChange,
                Error(MdnsRecord,
                      RecordChangedEvent,
@@ -460,10 +462,11 @@ TEST_F(DnsSdQuerierImplTest, ErrorsOnlyAfterChangesAreLogged) {
   after_changes.emplace_back(Error::Code::kItemNotFound);
   after_changes.emplace_back(Error::Code::kItemAlreadyExists);
 
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  // Endpoints before and after applying record changes, then the error it
+  // logs.
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(DnsDataGraph::EndpointChanges{
+          std::move(before_changes), std::move(after_changes)})));
   EXPECT_CALL(querier_->reporting_client(), OnRecoverableError(_)).Times(3);
 
   // Call to apply record changes. The specifics are unimportant.
@@ -483,10 +486,10 @@ TEST_F(DnsSdQuerierImplTest, ErrorsOnlyBeforeChangesNotLogged) {
   before_changes.emplace_back(Error::Code::kItemAlreadyExists);
   std::vector<ErrorOr<DnsSdInstanceEndpoint>> after_changes{};
 
-  // Calls before and after applying record changes.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  // Endpoints before and after applying record changes.
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(DnsDataGraph::EndpointChanges{
+          std::move(before_changes), std::move(after_changes)})));
 
   // Call to apply record changes. The specifics are unimportant.
   EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
@@ -508,10 +511,10 @@ TEST_F(DnsSdQuerierImplTest, ErrorsBeforeAndAfterChangesNotLogged) {
   after_changes.emplace_back(Error::Code::kItemAlreadyExists);
   after_changes.emplace_back(Error::Code::kItemNotFound);
 
-  // Calls before and after applying record changes.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  // Endpoints before and after applying record changes.
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(DnsDataGraph::EndpointChanges{
+          std::move(before_changes), std::move(after_changes)})));
 
   // Call to apply record changes. The specifics are unimportant.
   EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
@@ -537,10 +540,11 @@ TEST_F(DnsSdQuerierImplTest, OrderOfErrorsDoesNotAffectResults) {
   after_changes.emplace_back(Error::Code::kItemAlreadyExists);
   after_changes.emplace_back(Error::Code::kOperationCancelled);
 
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  // Endpoints before and after applying record changes, then the error it
+  // logs.
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(DnsDataGraph::EndpointChanges{
+          std::move(before_changes), std::move(after_changes)})));
   EXPECT_CALL(querier_->reporting_client(), OnRecoverableError(_)).Times(1);
 
   // Call to apply record changes. The specifics are unimportant.
@@ -580,10 +584,11 @@ TEST_F(DnsSdQuerierImplTest, ResultsWithMultipleAddressRecordsHandled) {
   after_changes.emplace_back(instance3);
   after_changes.emplace_back(instance1);
 
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  // Endpoints before and after applying record changes, then the error it
+  // logs.
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(DnsDataGraph::EndpointChanges{
+          std::move(before_changes), std::move(after_changes)})));
   EXPECT_CALL(callback_, OnEndpointCreated(instance1));
   EXPECT_CALL(callback_, OnEndpointUpdated(instance5));
   EXPECT_CALL(callback_, OnEndpointDeleted(instance2));
@@ -630,10 +635,11 @@ TEST_F(DnsSdQuerierImplTest, MixOfErrorsAndSuccessesHandledCorrectly) {
   after_changes.emplace_back(instance5);
   after_changes.emplace_back(Error::Code::kOperationCancelled);
 
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  // Endpoints before and after applying record changes, then the error it
+  // logs.
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(DnsDataGraph::EndpointChanges{
+          std::move(before_changes), std::move(after_changes)})));
   EXPECT_CALL(querier_->reporting_client(), OnRecoverableError(_)).Times(1);
   EXPECT_CALL(callback_, OnEndpointCreated(instance3));
   EXPECT_CALL(callback_, OnEndpointUpdated(instance5));
@@ -0,0 +1,219 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "discovery/common/config.h"
+#include "discovery/common/reporting_client.h"
+#include "discovery/mdns/impl/mdns_querier.h"
+#include "discovery/mdns/impl/mdns_random.h"
+#include "discovery/mdns/impl/mdns_receiver.h"
+#include "discovery/mdns/impl/mdns_sender.h"
+#include "discovery/mdns/public/mdns_record_changed_callback.h"
+#include "discovery/mdns/public/mdns_records.h"
+#include "discovery/mdns/public/mdns_writer.h"
+#include "discovery/mdns/testing/mdns_test_util.h"
+#include "gtest/gtest.h"
+#include "platform/base/ip_address.h"
+#include "platform/base/udp_packet.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "platform/test/fake_udp_socket.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::discovery {
+namespace {
+
+class FailingReportingClient : public ReportingClient {
+ public:
+  ~FailingReportingClient() override = default;
+
+  void OnFatalError(const Error& error) override { ADD_FAILURE() << error; }
+  void OnRecoverableError(const Error& error) override {
+    ADD_FAILURE() << error;
+  }
+};
+
+// Counts the changes to the records of the queried service.
+class CountingCallback : public MdnsRecordChangedCallback {
+ public:
+  ~CountingCallback() override = default;
+
+  int created() const { return created_; }
+  int updated() const { return updated_; }
+
+  std::vector<PendingQueryChange> OnRecordChanged(
+      const MdnsRecord& record,
+      RecordChangedEvent event) override {
+    if (event == RecordChangedEvent::kCreated) {
+      ++created_;
+    } else if (event == RecordChangedEvent::kUpdated) {
+      ++updated_;
+    }
+    return {};
+  }
+
+ private:
+  int created_ = 0;
+  int updated_ = 0;
+};
+
+// Feeds the multicast traffic of many devices through an MdnsReceiver to an
+// MdnsQuerier querying for Cast devices.
+class MdnsQuerierBenchmark : public testing::Test {
+ public:
+  MdnsQuerierBenchmark()
+      : clock_(Clock::now()),
+        task_runner_(clock_),
+        sender_(socket_),
+        receiver_(config_) {
+    receiver_.Start();
+  }
+
+ protected:
+  // Creates the querier, caching up to `max_records`, and starts the query for
+  // Cast devices.
+  void StartQuerier(int max_records) {
+    config_.querier_max_records_cached = max_records;
+    querier_ = std::make_unique<MdnsQuerier>(sender_, receiver_, task_runner_,
+                                             &FakeClock::now, random_,
+                                             reporting_client_, config_);
+    querier_->StartQuery(DomainName{"_googlecast", "_tcp", "local"},
+                         DnsType::kPTR, DnsClass::kIN, &callback_);
+  }
+
+  // Creates the announcement of the `index`-th device offering `service_type`:
+  // a shared PTR record for its service instance, and its unique SRV, TXT and
+  // A records.
+  static UdpPacket CreateDeviceAnnouncement(
+      int index,
+      const std::string& service_type = "_googlecast") {
+    const DomainName service{service_type, "_tcp", "local"};
+    const DomainName instance{"Device-" + std::to_string(index), service_type,
+                              "_tcp", "local"};
+    const DomainName host{"host-" + std::to_string(index), "local"};
+    MdnsMessage message(CreateMessageId(), MessageType::Response);
+    message.AddAnswer(MdnsRecord(service, DnsType::kPTR, DnsClass::kIN,
+                                 RecordType::kShared, std::chrono::seconds(120),
+                                 PtrRecordRdata(instance)));
+    message.AddAdditionalRecord(
+        MdnsRecord(instance, DnsType::kSRV, DnsClass::kIN, RecordType::kUnique,
+                   std::chrono::seconds(120),
+                   SrvRecordRdata(0, 0, 8009, host)));
+    message.AddAdditionalRecord(MdnsRecord(
+        instance, DnsType::kTXT, DnsClass::kIN, RecordType::kUnique,
+        std::chrono::seconds(120),
+        MakeTxtRecord({"id=" + std::to_string(index)})));
+    const IPAddress address{10, static_cast<uint8_t>(index >> 16),
+                            static_cast<uint8_t>(index >> 8),
+                            static_cast<uint8_t>(index)};
+    message.AddAdditionalRecord(MdnsRecord(host, DnsType::kA, DnsClass::kIN,
+                                           RecordType::kUnique,
+                                           std::chrono::seconds(120),
+                                           ARecordRdata(address)));
+    UdpPacket packet(message.MaxWireSize());
+    MdnsWriter writer(packet.data(), packet.size());
+    OSP_CHECK(writer.Write(message));
+    packet.resize(writer.offset());
+    return packet;
+  }
+
+  // Creates the announcements of `num_devices` Cast devices.
+  static std::vector<UdpPacket> CreateAnnouncements(int num_devices) {
+    std::vector<UdpPacket> announcements;
+    for (int i = 0; i < num_devices; ++i) {
+      announcements.push_back(CreateDeviceAnnouncement(i));
+    }
+    return announcements;
+  }
+
+  // Delivers all the `packets` to the querier, and returns the time taken.
+  Clock::duration Receive(std::vector<UdpPacket> packets) {
+    const Clock::time_point start_time = Clock::now();
+    for (UdpPacket& packet : packets) {
+      receiver_.OnRead(&socket_, std::move(packet));
+    }
+    return Clock::now() - start_time;
+  }
+
+  static int NanosecondsPer(Clock::duration time, int count) {
+    return static_cast<int>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() /
+        count);
+  }
+
+  Config config_;
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  FakeUdpSocket socket_;
+  MdnsSender sender_;
+  MdnsReceiver receiver_;
+  MdnsRandom random_;
+  FailingReportingClient reporting_client_;
+  CountingCallback callback_;
+  std::unique_ptr<MdnsQuerier> querier_;
+};
+
+// Measures the cost of processing an announce storm, in which each of many
+// Cast devices re-announces all of its cached records.
+TEST_F(MdnsQuerierBenchmark, AnnounceStormOverManyCachedRecords) {
+  constexpr int kNumDevices = 2500;
+  constexpr int kNumRecords = kNumDevices * 4;
+  StartQuerier(kNumRecords);
+
+  Receive(CreateAnnouncements(kNumDevices));
+  ASSERT_EQ(kNumDevices, callback_.created());
+
+  const int ns_per_record =
+      NanosecondsPer(Receive(CreateAnnouncements(kNumDevices)), kNumRecords);
+
+  OSP_LOG_INFO << "Announce storm over " << kNumRecords << " cached records: "
+               << ns_per_record << " ns per record.";
+  RecordProperty("announce_storm_ns_per_record", ns_per_record);
+
+  // Re-announcing only refreshes the TTLs.
+  EXPECT_EQ(kNumDevices, callback_.created());
+  EXPECT_EQ(0, callback_.updated());
+}
+
+// Measures the cost of processing multicast traffic in which most responses
+// are for services that nobody queried, as on a busy LAN. Their records are
+// dropped by name hash, before being decoded.
+TEST_F(MdnsQuerierBenchmark, MulticastTrafficForOtherServices) {
+  constexpr int kNumDevices = 2000;
+  // One device in kRelevantInterval offers the queried service.
+  constexpr int kRelevantInterval = 8;
+  const std::string kOtherServiceTypes[] = {"_airplay", "_raop", "_spotify",
+                                            "_hap", "_ipp", "_companion-link",
+                                            "_sleep-proxy"};
+  StartQuerier(kNumDevices * 4);
+
+  std::vector<UdpPacket> packets;
+  for (int i = 0; i < kNumDevices; ++i) {
+    if (i % kRelevantInterval == 0) {
+      packets.push_back(CreateDeviceAnnouncement(i));
+    } else {
+      packets.push_back(CreateDeviceAnnouncement(
+          i, kOtherServiceTypes[i % std::size(kOtherServiceTypes)]));
+    }
+  }
+  const int ns_per_packet =
+      NanosecondsPer(Receive(std::move(packets)), kNumDevices);
+
+  OSP_LOG_INFO << "Multicast traffic of " << kNumDevices << " devices, one in "
+               << kRelevantInterval << " queried: " << ns_per_packet
+               << " ns per packet.";
+  RecordProperty("other_services_ns_per_packet", ns_per_packet);
+
+  // Only the devices offering the queried service are discovered.
+  EXPECT_EQ(kNumDevices / kRelevantInterval, callback_.created());
+}
+
+}  // namespace
+}  // namespace openscreen::discovery
@@ -0,0 +1,112 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "discovery/common/config.h"
+#include "discovery/mdns/public/mdns_reader.h"
+#include "discovery/mdns/public/mdns_records.h"
+#include "discovery/mdns/public/mdns_writer.h"
+#include "discovery/mdns/testing/mdns_test_util.h"
+#include "gtest/gtest.h"
+#include "platform/base/ip_address.h"
+#include "util/osp_logging.h"
+
+namespace openscreen::discovery {
+namespace {
+
+constexpr std::chrono::seconds kTtl(120);
+
+// Creates the response of the `index`-th Cast service to a query for Cast
+// services: its PTR, SRV, TXT and A records.
+std::vector<uint8_t> CreateServiceResponse(const DomainName& service,
+                                           int index) {
+  const DomainName instance{"Device-" + std::to_string(index), "_googlecast",
+                            "_tcp", "local"};
+  const DomainName host{"host-" + std::to_string(index), "local"};
+  MdnsMessage message(0, MessageType::Response);
+  message.AddAnswer(MdnsRecord(service, DnsType::kPTR, DnsClass::kIN,
+                               RecordType::kShared, kTtl,
+                               PtrRecordRdata(instance)));
+  message.AddAnswer(MdnsRecord(instance, DnsType::kSRV, DnsClass::kIN,
+                               RecordType::kUnique, kTtl,
+                               SrvRecordRdata(0, 0, 8009, host)));
+  message.AddAnswer(MdnsRecord(instance, DnsType::kTXT, DnsClass::kIN,
+                               RecordType::kUnique, kTtl,
+                               MakeTxtRecord({"id=" + std::to_string(index)})));
+  message.AddAnswer(MdnsRecord(
+      host, DnsType::kA, DnsClass::kIN, RecordType::kUnique, kTtl,
+      ARecordRdata(IPAddress{10, static_cast<uint8_t>(index >> 8),
+                             static_cast<uint8_t>(index), 1})));
+  std::vector<uint8_t> buffer(message.MaxWireSize());
+  MdnsWriter writer(buffer.data(), buffer.size());
+  OSP_CHECK(writer.Write(message));
+  buffer.resize(writer.offset());
+  return buffer;
+}
+
+// Replays the discovery of many Cast services, parsing and keeping all of their
+// records, and measures the cost of parsing and the memory used by the
+// interned domain names they refer to.
+TEST(MdnsRecordsBenchmark, DiscoveryReplay) {
+  constexpr int kNumServices = 1000;
+  const DomainName service{"_googlecast", "_tcp", "local"};
+  std::vector<std::vector<uint8_t>> messages;
+  for (int i = 0; i < kNumServices; ++i) {
+    messages.push_back(CreateServiceResponse(service, i));
+  }
+
+  const size_t initial_count = DomainName::GetInternedCountForTesting();
+  const size_t initial_bytes = DomainName::GetInternedBytesForTesting();
+  const Config config;
+  std::vector<MdnsMessage> parsed;
+  parsed.reserve(kNumServices);
+  const auto start_time = std::chrono::steady_clock::now();
+  for (const std::vector<uint8_t>& buffer : messages) {
+    MdnsReader reader(config, buffer.data(), buffer.size());
+    ErrorOr<MdnsMessage> message = reader.Read();
+    ASSERT_TRUE(message.is_value());
+    parsed.push_back(std::move(message.value()));
+  }
+  const auto run_time = std::chrono::steady_clock::now() - start_time;
+  const int ns_per_message = static_cast<int>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(run_time).count() /
+      kNumServices);
+  const size_t interned_count =
+      DomainName::GetInternedCountForTesting() - initial_count;
+  const size_t interned_bytes =
+      DomainName::GetInternedBytesForTesting() - initial_bytes;
+
+  // The domain names held by the parsed records, including their rdata.
+  size_t name_count = 0;
+  for (const MdnsMessage& message : parsed) {
+    for (const MdnsRecord& record : message.answers()) {
+      ++name_count;
+      if (std::holds_alternative<PtrRecordRdata>(record.rdata()) ||
+          std::holds_alternative<SrvRecordRdata>(record.rdata())) {
+        ++name_count;
+      }
+    }
+  }
+
+  OSP_LOG_INFO << "Discovery replay of " << kNumServices
+               << " services: " << ns_per_message << " ns per message; "
+               << name_count << " domain names share " << interned_count
+               << " interned names, using " << interned_bytes << " bytes.";
+  RecordProperty("discovery_replay_ns_per_message", ns_per_message);
+  RecordProperty("discovery_replay_interned_bytes",
+                 static_cast<int>(interned_bytes));
+
+  EXPECT_EQ(name_count, size_t{6 * kNumServices});
+  // The service name was already interned. Each service adds its host name,
+  // and its instance name along with the lowercase form of it.
+  EXPECT_EQ(interned_count, size_t{3 * kNumServices});
+}
+
+}  // namespace
+}  // namespace openscreen::discovery
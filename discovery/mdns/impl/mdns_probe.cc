@@ -9,6 +9,7 @@
 #include "discovery/mdns/impl/mdns_random.h"
 #include "discovery/mdns/impl/mdns_sender.h"
 #include "discovery/mdns/public/mdns_constants.h"
+#include "discovery/mdns/public/mdns_message_view.h"
 #include "platform/api/task_runner.h"
 #include "platform/api/time.h"
 
@@ -89,12 +90,17 @@ void MdnsProbeImpl::Postpone(std::chrono::seconds delay) {
   alarm_.ScheduleFromNow([this]() { ProbeOnce(); }, Clock::to_duration(delay));
 }
 
-void MdnsProbeImpl::OnMessageReceived(const MdnsMessage& message) {
+void MdnsProbeImpl::OnMessageReceived(const MdnsMessageView& message) {
   OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
   OSP_CHECK(message.type() == MessageType::Response);
 
-  for (const auto& record : message.answers()) {
-    if (record.name() == target_name()) {
+  const uint64_t target_name_hash = target_name().Hash();
+  for (const MdnsMessageView::Entry& entry : message.answers()) {
+    if (entry.name_hash != target_name_hash) {
+      continue;
+    }
+    const ErrorOr<MdnsRecord> record = message.ReadRecord(entry);
+    if (record.is_value() && record.value().name() == target_name()) {
       Stop();
       observer_->OnProbeFailure(this);
     }
@@ -106,7 +106,7 @@ class MdnsProbeImpl : public MdnsProbe {
   void Stop();
 
   // MdnsReceiver::ResponseClient overrides.
-  void OnMessageReceived(const MdnsMessage& message) override;
+  void OnMessageReceived(const MdnsMessageView& message) override;
 
   const raw_ref<MdnsRandom> random_delay_;
   const raw_ref<TaskRunner> task_runner_;
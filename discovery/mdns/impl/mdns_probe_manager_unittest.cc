@@ -12,6 +12,7 @@
 #include "discovery/mdns/impl/mdns_random.h"
 #include "discovery/mdns/impl/mdns_receiver.h"
 #include "discovery/mdns/impl/mdns_sender.h"
+#include "discovery/mdns/public/mdns_message_view.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "platform/test/fake_clock.h"
@@ -44,7 +45,7 @@ class MockMdnsProbe : public MdnsProbe {
       : MdnsProbe(std::move(target_name), std::move(address)) {}
 
   MOCK_METHOD1(Postpone, void(std::chrono::seconds));
-  MOCK_METHOD1(OnMessageReceived, void(const MdnsMessage&));
+  MOCK_METHOD1(OnMessageReceived, void(const MdnsMessageView&));
 };
 
 class TestMdnsProbeManager : public MdnsProbeManagerImpl {
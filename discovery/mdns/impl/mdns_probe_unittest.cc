@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "discovery/common/config.h"
 #include "discovery/mdns/impl/mdns_probe_manager.h"
@@ -12,6 +13,9 @@
 #include "discovery/mdns/impl/mdns_random.h"
 #include "discovery/mdns/impl/mdns_receiver.h"
 #include "discovery/mdns/impl/mdns_sender.h"
+#include "discovery/mdns/public/mdns_message_view.h"
+#include "discovery/mdns/public/mdns_reader.h"
+#include "discovery/mdns/public/mdns_writer.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "platform/test/fake_clock.h"
@@ -68,7 +72,13 @@ class MdnsProbeTests : public testing::Test {
   }
 
   void OnMessageReceived(const MdnsMessage& message) {
-    probe_->OnMessageReceived(message);
+    std::vector<uint8_t> buffer(message.MaxWireSize());
+    MdnsWriter writer(buffer.data(), buffer.size());
+    ASSERT_TRUE(writer.Write(message));
+    MdnsReader reader(config_, buffer.data(), writer.offset());
+    const ErrorOr<MdnsMessageView> view = reader.ReadView();
+    ASSERT_TRUE(view.is_value());
+    probe_->OnMessageReceived(view.value());
   }
 
   Config config_;
@@ -8,6 +8,7 @@
 #include <array>
 #include <bitset>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <variant>
@@ -24,6 +25,10 @@
 namespace openscreen::discovery {
 namespace {
 
+// The initial number of buckets in the record cache's hash table, which must be
+// a power of two.
+constexpr size_t kInitialRecordBucketCount = 16;
+
 constexpr std::array<DnsType, 5> kTranslatedNsecAnyQueryTypes = {
     DnsType::kA, DnsType::kPTR, DnsType::kTXT, DnsType::kAAAA, DnsType::kSRV};
 
@@ -214,6 +219,63 @@ void RemoveInvalidNsecFlags(std::vector<MdnsRecord>* records) {
 
 }  // namespace
 
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::Iterator::Iterator(
+    const TrackerRange* range,
+    const Node* node)
+    : range_(range), node_(node) {
+  while (node_ && !range_->Matches(*node_)) {
+    node_ = node_->next_in_bucket.get();
+  }
+}
+
+const MdnsRecordTracker&
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::Iterator::operator*() const {
+  return node_->tracker;
+}
+
+const MdnsRecordTracker*
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::Iterator::operator->()
+    const {
+  return &node_->tracker;
+}
+
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::Iterator&
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::Iterator::operator++() {
+  const Node* next = node_->next_in_bucket.get();
+  // Without wildcards, all matches are contiguous, so the first mismatch after
+  // a match ends the range.
+  if (next && range_->dns_type_ != DnsType::kANY &&
+      range_->dns_class_ != DnsClass::kANY && !range_->Matches(*next)) {
+    next = nullptr;
+  }
+  *this = Iterator(range_, next);
+  return *this;
+}
+
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::Iterator
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::Iterator::operator++(int) {
+  Iterator result = *this;
+  ++*this;
+  return result;
+}
+
+MdnsQuerier::RecordTrackerLruCache::TrackerRange::TrackerRange(
+    const Node* first,
+    DnsType dns_type,
+    DnsClass dns_class)
+    : first_(first), dns_type_(dns_type), dns_class_(dns_class) {}
+
+size_t MdnsQuerier::RecordTrackerLruCache::TrackerRange::size() const {
+  return std::distance(begin(), end());
+}
+
+bool MdnsQuerier::RecordTrackerLruCache::TrackerRange::Matches(
+    const Node& node) const {
+  const MdnsRecordTracker& tracker = node.tracker;
+  return (dns_type_ == DnsType::kANY || dns_type_ == tracker.dns_type()) &&
+         (dns_class_ == DnsClass::kANY || dns_class_ == tracker.dns_class());
+}
+
 MdnsQuerier::RecordTrackerLruCache::RecordTrackerLruCache(
     MdnsQuerier& querier,
     MdnsSender& sender,
@@ -228,58 +290,70 @@ MdnsQuerier::RecordTrackerLruCache::RecordTrackerLruCache(
       task_runner_(task_runner),
       now_function_(now_function),
       reporting_client_(reporting_client),
-      config_(config) {
+      config_(config),
+      buckets_(kInitialRecordBucketCount) {
   OSP_CHECK_GT(config_.querier_max_records_cached, 0);
 }
 
-std::vector<std::reference_wrapper<const MdnsRecordTracker>>
+MdnsQuerier::RecordTrackerLruCache::~RecordTrackerLruCache() = default;
+
+MdnsQuerier::RecordTrackerLruCache::TrackerRange
 MdnsQuerier::RecordTrackerLruCache::Find(const DomainName& name) {
   return Find(name, DnsType::kANY, DnsClass::kANY);
 }
 
-std::vector<std::reference_wrapper<const MdnsRecordTracker>>
+MdnsQuerier::RecordTrackerLruCache::TrackerRange
 MdnsQuerier::RecordTrackerLruCache::Find(const DomainName& name,
                                          DnsType dns_type,
                                          DnsClass dns_class) {
-  std::vector<RecordTrackerConstRef> results;
-  auto pair = records_.equal_range(name);
-  for (auto it = pair.first; it != pair.second; it++) {
-    const MdnsRecordTracker& tracker = *it->second;
-    if ((dns_type == DnsType::kANY || dns_type == tracker.dns_type()) &&
-        (dns_class == DnsClass::kANY || dns_class == tracker.dns_class())) {
-      results.push_back(std::cref(tracker));
-    }
-  }
-
-  return results;
+  const size_t index = FindBucket(name, name.Hash());
+  const Node* first =
+      index == kNotFound ? nullptr : buckets_[index].first.get();
+  return TrackerRange(first, dns_type, dns_class);
 }
 
 int MdnsQuerier::RecordTrackerLruCache::Erase(const DomainName& domain,
                                               TrackerApplicableCheck check) {
-  auto pair = records_.equal_range(domain);
+  const size_t index = FindBucket(domain, domain.Hash());
+  if (index == kNotFound) {
+    return 0;
+  }
+
   int count = 0;
-  for (RecordMap::iterator it = pair.first; it != pair.second;) {
-    if (check(*it->second)) {
-      lru_order_.erase(it->second);
-      it = records_.erase(it);
+  std::unique_ptr<Node>* link = &buckets_[index].first;
+  while (*link) {
+    Node& node = **link;
+    if (check(node.tracker)) {
+      Unlink(node);
+      // Destroys `node`.
+      *link = std::move(node.next_in_bucket);
+      --size_;
       count++;
     } else {
-      it++;
+      link = &node.next_in_bucket;
     }
   }
 
+  if (!buckets_[index].first) {
+    RemoveBucket(index);
+  }
   return count;
 }
 
 int MdnsQuerier::RecordTrackerLruCache::ExpireSoon(
     const DomainName& domain,
     TrackerApplicableCheck check) {
-  auto pair = records_.equal_range(domain);
+  const size_t index = FindBucket(domain, domain.Hash());
+  if (index == kNotFound) {
+    return 0;
+  }
+
   int count = 0;
-  for (RecordMap::iterator it = pair.first; it != pair.second; it++) {
-    if (check(*it->second)) {
-      MoveToEnd(it);
-      it->second->ExpireSoon();
+  for (Node* node = buckets_[index].first.get(); node;
+       node = node->next_in_bucket.get()) {
+    if (check(node->tracker)) {
+      MoveToEnd(*node);
+      node->tracker.ExpireSoon();
       count++;
     }
   }
@@ -296,11 +370,17 @@ int MdnsQuerier::RecordTrackerLruCache::Update(
     const MdnsRecord& record,
     TrackerApplicableCheck check,
     TrackerChangeCallback on_rdata_update) {
-  auto pair = records_.equal_range(record.name());
+  const size_t index = FindBucket(record.name(), record.name().Hash());
+  if (index == kNotFound) {
+    return 0;
+  }
+
   int count = 0;
-  for (RecordMap::iterator it = pair.first; it != pair.second; it++) {
-    if (check(*it->second)) {
-      auto result = it->second->Update(record);
+  for (Node* node = buckets_[index].first.get(); node;
+       node = node->next_in_bucket.get()) {
+    MdnsRecordTracker& tracker = node->tracker;
+    if (check(tracker)) {
+      auto result = tracker.Update(record);
 
       if (result.is_error()) {
         reporting_client_->OnRecoverableError(
@@ -311,12 +391,12 @@ int MdnsQuerier::RecordTrackerLruCache::Update(
 
       count++;
       if (result.value() == MdnsRecordTracker::UpdateType::kGoodbye) {
-        it->second->ExpireSoon();
-        MoveToEnd(it);
+        tracker.ExpireSoon();
+        MoveToEnd(*node);
       } else {
-        MoveToBeginning(it);
+        MoveToBeginning(*node);
         if (result.value() == MdnsRecordTracker::UpdateType::kRdata) {
-          on_rdata_update(*it->second);
+          on_rdata_update(tracker);
         }
       }
     }
@@ -333,33 +413,162 @@ const MdnsRecordTracker& MdnsQuerier::RecordTrackerLruCache::StartTracking(
     querier_->OnRecordExpired(tracker, r);
   };
 
-  while (lru_order_.size() >=
-         static_cast<size_t>(config_.querier_max_records_cached)) {
+  while (size_ >= static_cast<size_t>(config_.querier_max_records_cached)) {
     // This call erases one of the tracked records.
     OSP_DVLOG << "Maximum cacheable record count exceeded ("
               << config_.querier_max_records_cached << ")";
-    lru_order_.back().ExpireNow();
+    lru_tail_->tracker.ExpireNow();
+  }
+
+  const uint64_t name_hash = record.name().Hash();
+  const size_t index = FindOrAddBucket(record.name(), name_hash);
+  auto node = std::make_unique<Node>(std::move(record), dns_type, *sender_,
+                                     *task_runner_, now_function_,
+                                     *random_delay_,
+                                     std::move(expiration_callback));
+  Node& new_node = *node;
+  const DnsClass dns_class = new_node.tracker.dns_class();
+
+  // Keep the trackers of each (DNS type, DNS class) pair together, by inserting
+  // after the last one of the same pair, or at the front of the chain.
+  std::unique_ptr<Node>* link = &buckets_[index].first;
+  for (std::unique_ptr<Node>* it = link; *it; it = &(*it)->next_in_bucket) {
+    if ((*it)->tracker.dns_type() == dns_type &&
+        (*it)->tracker.dns_class() == dns_class) {
+      link = &(*it)->next_in_bucket;
+    }
+  }
+  node->next_in_bucket = std::move(*link);
+  *link = std::move(node);
+  ++size_;
+  LinkAtFront(new_node);
+
+  return new_node.tracker;
+}
+
+bool MdnsQuerier::RecordTrackerLruCache::ContainsNameHash(
+    uint64_t name_hash) const {
+  const size_t mask = buckets_.size() - 1;
+  for (size_t i = name_hash & mask; buckets_[i].first; i = (i + 1) & mask) {
+    if (buckets_[i].name_hash == name_hash) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t MdnsQuerier::RecordTrackerLruCache::FindBucket(
+    const DomainName& name,
+    uint64_t name_hash) const {
+  const size_t mask = buckets_.size() - 1;
+  for (size_t i = name_hash & mask; buckets_[i].first; i = (i + 1) & mask) {
+    if (buckets_[i].name_hash == name_hash &&
+        buckets_[i].first->tracker.name() == name) {
+      return i;
+    }
+  }
+  return kNotFound;
+}
+
+size_t MdnsQuerier::RecordTrackerLruCache::FindOrAddBucket(
+    const DomainName& name,
+    uint64_t name_hash) {
+  const size_t index = FindBucket(name, name_hash);
+  if (index != kNotFound) {
+    return index;
+  }
+
+  // Keep the load factor at or below 3/4, so probe sequences stay short.
+  if ((occupied_buckets_ + 1) * 4 > buckets_.size() * 3) {
+    Grow();
+  }
+  const size_t mask = buckets_.size() - 1;
+  size_t i = name_hash & mask;
+  while (buckets_[i].first) {
+    i = (i + 1) & mask;
+  }
+  buckets_[i].name_hash = name_hash;
+  ++occupied_buckets_;
+  return i;
+}
+
+void MdnsQuerier::RecordTrackerLruCache::RemoveBucket(size_t index) {
+  const size_t mask = buckets_.size() - 1;
+  size_t empty = index;
+  for (size_t i = (index + 1) & mask; buckets_[i].first; i = (i + 1) & mask) {
+    // The bucket at `i` may move into the empty one only if that does not put
+    // it before its home bucket in its probe sequence.
+    const size_t home = buckets_[i].name_hash & mask;
+    if (((i - home) & mask) >= ((i - empty) & mask)) {
+      buckets_[empty] = std::move(buckets_[i]);
+      empty = i;
+    }
   }
+  buckets_[empty].first.reset();
+  --occupied_buckets_;
+}
+
+void MdnsQuerier::RecordTrackerLruCache::Grow() {
+  std::vector<Bucket> old_buckets(buckets_.size() * 2);
+  old_buckets.swap(buckets_);
+  const size_t mask = buckets_.size() - 1;
+  for (Bucket& bucket : old_buckets) {
+    if (!bucket.first) {
+      continue;
+    }
+    size_t i = bucket.name_hash & mask;
+    while (buckets_[i].first) {
+      i = (i + 1) & mask;
+    }
+    buckets_[i] = std::move(bucket);
+  }
+}
+
+void MdnsQuerier::RecordTrackerLruCache::LinkAtFront(Node& node) {
+  node.lru_previous = nullptr;
+  node.lru_next = lru_head_;
+  if (lru_head_) {
+    lru_head_->lru_previous = &node;
+  } else {
+    lru_tail_ = &node;
+  }
+  lru_head_ = &node;
+}
 
-  auto name = record.name();
-  lru_order_.emplace_front(std::move(record), dns_type, *sender_, *task_runner_,
-                           now_function_, *random_delay_,
-                           std::move(expiration_callback));
-  records_.emplace(std::move(name), lru_order_.begin());
+void MdnsQuerier::RecordTrackerLruCache::LinkAtBack(Node& node) {
+  node.lru_next = nullptr;
+  node.lru_previous = lru_tail_;
+  if (lru_tail_) {
+    lru_tail_->lru_next = &node;
+  } else {
+    lru_head_ = &node;
+  }
+  lru_tail_ = &node;
+}
 
-  return lru_order_.front();
+void MdnsQuerier::RecordTrackerLruCache::Unlink(Node& node) {
+  if (node.lru_previous) {
+    node.lru_previous->lru_next = node.lru_next;
+  } else {
+    lru_head_ = node.lru_next;
+  }
+  if (node.lru_next) {
+    node.lru_next->lru_previous = node.lru_previous;
+  } else {
+    lru_tail_ = node.lru_previous;
+  }
+  node.lru_previous = nullptr;
+  node.lru_next = nullptr;
 }
 
-void MdnsQuerier::RecordTrackerLruCache::MoveToBeginning(
-    MdnsQuerier::RecordTrackerLruCache::RecordMap::iterator it) {
-  lru_order_.splice(lru_order_.begin(), lru_order_, it->second);
-  it->second = lru_order_.begin();
+void MdnsQuerier::RecordTrackerLruCache::MoveToBeginning(Node& node) {
+  Unlink(node);
+  LinkAtFront(node);
 }
 
-void MdnsQuerier::RecordTrackerLruCache::MoveToEnd(
-    MdnsQuerier::RecordTrackerLruCache::RecordMap::iterator it) {
-  lru_order_.splice(lru_order_.end(), lru_order_, it->second);
-  it->second = --lru_order_.end();
+void MdnsQuerier::RecordTrackerLruCache::MoveToEnd(Node& node) {
+  Unlink(node);
+  LinkAtBack(node);
 }
 
 MdnsQuerier::MdnsQuerier(MdnsSender& sender,
@@ -420,7 +629,7 @@ void MdnsQuerier::StartQuery(const DomainName& name,
   // NOTE: In the future, could allow callers to fetch cached records after
   // adding a callback, for example to prime the UI.
   std::vector<PendingQueryChange> pending_changes;
-  const std::vector<RecordTrackerLruCache::RecordTrackerConstRef> trackers =
+  const RecordTrackerLruCache::TrackerRange trackers =
       records_.Find(name, dns_type, dns_class);
   for (const MdnsRecordTracker& tracker : trackers) {
     if (!tracker.is_negative_response()) {
@@ -492,6 +701,7 @@ void MdnsQuerier::StopQuery(const DomainName& name,
     if (dns_type == tracked_question.dns_type() &&
         dns_class == tracked_question.dns_class()) {
       questions_.erase(entry);
+      RemoveQuestionNameHash(name.Hash(), 1);
       return;
     }
   }
@@ -507,7 +717,7 @@ void MdnsQuerier::ReinitializeQueries(const DomainName& name) {
   callbacks_.erase(name);
 
   // Remove all known questions and answers.
-  questions_.erase(name);
+  RemoveQuestionNameHash(name.Hash(), questions_.erase(name));
   records_.Erase(name, [](const MdnsRecordTracker& tracker) { return true; });
 
   // Restart the queries.
@@ -516,7 +726,7 @@ void MdnsQuerier::ReinitializeQueries(const DomainName& name) {
   }
 }
 
-void MdnsQuerier::OnMessageReceived(const MdnsMessage& message) {
+void MdnsQuerier::OnMessageReceived(const MdnsMessageView& message) {
   OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
   OSP_CHECK(message.type() == MessageType::Response);
 
@@ -527,21 +737,29 @@ void MdnsQuerier::OnMessageReceived(const MdnsMessage& message) {
 
   std::vector<MdnsRecord> records_to_process;
 
-  // Add any records that are relevant for this querier.
+  // Add any records that are relevant for this querier. Records are only
+  // decoded if their name hash matches a question or a known record.
   bool found_relevant_records = false;
-  for (const MdnsRecord& record : message.answers()) {
-    if (ShouldAnswerRecordBeProcessed(record)) {
-      records_to_process.push_back(record);
+  for (const MdnsMessageView::Entry& entry : message.answers()) {
+    if (IsNameHashRelevant(entry.name_hash) &&
+        ReadRecordToProcess(message, entry, &records_to_process)) {
       found_relevant_records = true;
     }
   }
 
   // If any of the message's answers are relevant, add all additional records.
-  // Else, since the message has already been received and parsed, use any
-  // individual records relevant to this querier to update the cache.
-  for (const MdnsRecord& record : message.additional_records()) {
-    if (found_relevant_records || ShouldAnswerRecordBeProcessed(record)) {
-      records_to_process.push_back(record);
+  // Else, use any individual records relevant to this querier to update the
+  // cache.
+  for (const MdnsMessageView::Entry& entry : message.additional_records()) {
+    if (found_relevant_records) {
+      ErrorOr<MdnsRecord> record = message.ReadRecord(entry);
+      if (record.is_value()) {
+        records_to_process.push_back(std::move(record.value()));
+      } else {
+        OSP_DVLOG << "\tDropping additional record that failed to parse...";
+      }
+    } else if (IsNameHashRelevant(entry.name_hash)) {
+      ReadRecordToProcess(message, entry, &records_to_process);
     }
   }
 
@@ -559,6 +777,40 @@ void MdnsQuerier::OnMessageReceived(const MdnsMessage& message) {
   // TODO(crbug.com/openscreen/83): Check authority records.
 }
 
+bool MdnsQuerier::IsNameHashRelevant(uint64_t name_hash) const {
+  return question_name_hashes_.find(name_hash) !=
+             question_name_hashes_.end() ||
+         records_.ContainsNameHash(name_hash);
+}
+
+bool MdnsQuerier::ReadRecordToProcess(const MdnsMessageView& message,
+                                      const MdnsMessageView::Entry& entry,
+                                      std::vector<MdnsRecord>* records) {
+  ErrorOr<MdnsRecord> record = message.ReadRecord(entry);
+  if (record.is_error()) {
+    OSP_DVLOG << "\tDropping record that failed to parse...";
+    return false;
+  }
+  if (!ShouldAnswerRecordBeProcessed(record.value())) {
+    return false;
+  }
+  records->push_back(std::move(record.value()));
+  return true;
+}
+
+void MdnsQuerier::RemoveQuestionNameHash(uint64_t name_hash, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  auto it = question_name_hashes_.find(name_hash);
+  OSP_CHECK(it != question_name_hashes_.end());
+  it->second -= static_cast<int>(count);
+  OSP_CHECK_GE(it->second, 0);
+  if (it->second == 0) {
+    question_name_hashes_.erase(it);
+  }
+}
+
 bool MdnsQuerier::ShouldAnswerRecordBeProcessed(const MdnsRecord& answer) {
   // First, accept the record if it's associated with an ongoing question.
   const auto questions_range = questions_.equal_range(answer.name());
@@ -587,7 +839,7 @@ bool MdnsQuerier::ShouldAnswerRecordBeProcessed(const MdnsRecord& answer) {
   }
 
   for (DnsType type : types) {
-    std::vector<RecordTrackerLruCache::RecordTrackerConstRef> trackers =
+    RecordTrackerLruCache::TrackerRange trackers =
         records_.Find(answer.name(), type, answer.dns_class());
     if (!trackers.empty()) {
       return true;
@@ -693,7 +945,7 @@ void MdnsQuerier::ProcessUniqueRecord(const MdnsRecord& record,
   OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
   OSP_CHECK(record.record_type() == RecordType::kUnique);
 
-  std::vector<RecordTrackerLruCache::RecordTrackerConstRef> trackers =
+  RecordTrackerLruCache::TrackerRange trackers =
       records_.Find(record.name(), dns_type, record.dns_class());
   size_t num_records_for_key = trackers.size();
 
@@ -708,7 +960,7 @@ void MdnsQuerier::ProcessUniqueRecord(const MdnsRecord& record,
   } else if (num_records_for_key == size_t{1}) {
     // There is exactly one tracker associated with this key. This is the
     // expected case when a record matching this one has already been seen.
-    ProcessSinglyTrackedUniqueRecord(record, trackers[0]);
+    ProcessSinglyTrackedUniqueRecord(record, trackers.front());
   } else {
     // Multiple records with the same key.
     ProcessMultiTrackedUniqueRecord(record, dns_type);
@@ -809,10 +1061,11 @@ void MdnsQuerier::AddQuestion(const MdnsQuestion& question) {
       config_);
   MdnsQuestionTracker* ptr = question_tracker.get();
   questions_.emplace(question.name(), std::move(question_tracker));
+  ++question_name_hashes_[question.name().Hash()];
 
   // Let all records associated with this question know that there is a new
   // query that can be used for their refresh.
-  std::vector<RecordTrackerLruCache::RecordTrackerConstRef> trackers =
+  RecordTrackerLruCache::TrackerRange trackers =
       records_.Find(question.name(), question.dns_type(), question.dns_class());
   for (const MdnsRecordTracker& tracker : trackers) {
     // NOTE: When the pointed to object is deleted, its dtor removes itself
@@ -5,14 +5,20 @@
 #ifndef DISCOVERY_MDNS_IMPL_MDNS_QUERIER_H_
 #define DISCOVERY_MDNS_IMPL_MDNS_QUERIER_H_
 
-#include <list>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "discovery/common/config.h"
 #include "discovery/mdns/impl/mdns_receiver.h"
 #include "discovery/mdns/impl/mdns_trackers.h"
+#include "discovery/mdns/public/mdns_message_view.h"
 #include "discovery/mdns/public/mdns_record_changed_callback.h"
 #include "discovery/mdns/public/mdns_records.h"
 #include "platform/api/task_runner.h"
@@ -77,15 +83,70 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
     const DnsClass dns_class;
   };
 
-  // Represents a Least Recently Used cache of MdnsRecordTrackers.
+  // Represents a Least Recently Used cache of MdnsRecordTrackers, indexed by
+  // the hashes of their domain names.
   class RecordTrackerLruCache {
+   private:
+    struct Node;
+
    public:
-    using RecordTrackerConstRef =
-        std::reference_wrapper<const MdnsRecordTracker>;
     using TrackerApplicableCheck =
         std::function<bool(const MdnsRecordTracker&)>;
     using TrackerChangeCallback = std::function<void(const MdnsRecordTracker&)>;
 
+    // The trackers returned by Find(), iterated over in place. A TrackerRange
+    // is invalidated by any change to the cache.
+    class TrackerRange {
+     public:
+      class Iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = MdnsRecordTracker;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const MdnsRecordTracker*;
+        using reference = const MdnsRecordTracker&;
+
+        Iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+        Iterator& operator++();
+        Iterator operator++(int);
+        bool operator==(const Iterator& other) const {
+          return node_ == other.node_;
+        }
+        bool operator!=(const Iterator& other) const {
+          return node_ != other.node_;
+        }
+
+       private:
+        friend class TrackerRange;
+
+        // Points at the first tracker in `range` at or after `node`.
+        Iterator(const TrackerRange* range, const Node* node);
+
+        const TrackerRange* range_ = nullptr;
+        const Node* node_ = nullptr;
+      };
+
+      Iterator begin() const { return Iterator(this, first_); }
+      Iterator end() const { return Iterator(); }
+      bool empty() const { return begin() == end(); }
+      size_t size() const;
+      const MdnsRecordTracker& front() const { return *begin(); }
+
+     private:
+      friend class RecordTrackerLruCache;
+
+      TrackerRange(const Node* first, DnsType dns_type, DnsClass dns_class);
+
+      bool Matches(const Node& node) const;
+
+      const Node* first_;
+      DnsType dns_type_;
+      DnsClass dns_class_;
+    };
+
     RecordTrackerLruCache(MdnsQuerier& querier,
                           MdnsSender& sender,
                           MdnsRandom& random_delay,
@@ -93,14 +154,19 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
                           ClockNowFunctionPtr now_function,
                           ReportingClient& reporting_client,
                           const Config& config);
+    ~RecordTrackerLruCache();
 
     // Returns all trackers with the associated `name` such that its type
     // represents a type corresponding to `dns_type` and class corresponding to
-    // `dns_class`.
-    std::vector<RecordTrackerConstRef> Find(const DomainName& name);
-    std::vector<RecordTrackerConstRef> Find(const DomainName& name,
-                                            DnsType dns_type,
-                                            DnsClass dns_class);
+    // `dns_class`. Does not allocate.
+    TrackerRange Find(const DomainName& name);
+    TrackerRange Find(const DomainName& name,
+                      DnsType dns_type,
+                      DnsClass dns_class);
+
+    // Returns whether any tracker might have a domain name with hash
+    // `name_hash`. Compares only hashes, so does not need a DomainName.
+    bool ContainsNameHash(uint64_t name_hash) const;
 
     // Calls ExpireSoon on all record trackers in the provided domain which
     // match the provided applicability check. Returns the number of trackers
@@ -123,14 +189,54 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
     // record.
     const MdnsRecordTracker& StartTracking(MdnsRecord record, DnsType type);
 
-    size_t size() { return records_.size(); }
+    size_t size() { return size_; }
 
    private:
-    using LruList = std::list<MdnsRecordTracker>;
-    using RecordMap = std::multimap<DomainName, LruList::iterator>;
+    // A tracker, linked into both the chain of its bucket and the LRU list.
+    struct Node {
+      template <typename... Args>
+      explicit Node(Args&&... args) : tracker(std::forward<Args>(args)...) {}
+
+      MdnsRecordTracker tracker;
+
+      // The next tracker with the same domain name. The trackers of each
+      // (DNS type, DNS class) pair are contiguous in the chain.
+      std::unique_ptr<Node> next_in_bucket;
+
+      // Neighbours in the LRU list, towards its most and least recently
+      // updated ends respectively.
+      Node* lru_previous = nullptr;
+      Node* lru_next = nullptr;
+    };
+
+    // A slot of the open-addressed (linear probing) hash table. Each occupied
+    // bucket owns the chain of trackers for exactly one domain name.
+    struct Bucket {
+      uint64_t name_hash = 0;
+      std::unique_ptr<Node> first;
+    };
+
+    static constexpr size_t kNotFound = static_cast<size_t>(-1);
 
-    void MoveToBeginning(RecordMap::iterator iterator);
-    void MoveToEnd(RecordMap::iterator iterator);
+    // Returns the index of the bucket for `name`, or kNotFound.
+    size_t FindBucket(const DomainName& name, uint64_t name_hash) const;
+
+    // Returns the index of the bucket for `name`, occupying a new one if
+    // needed.
+    size_t FindOrAddBucket(const DomainName& name, uint64_t name_hash);
+
+    // Empties the bucket at `index`, shifting back the buckets after it in its
+    // probe sequence so that none of them become unreachable.
+    void RemoveBucket(size_t index);
+
+    // Doubles the number of buckets, and re-inserts the occupied ones.
+    void Grow();
+
+    void LinkAtFront(Node& node);
+    void LinkAtBack(Node& node);
+    void Unlink(Node& node);
+    void MoveToBeginning(Node& node);
+    void MoveToEnd(Node& node);
 
     const raw_ref<MdnsQuerier> querier_;
     const raw_ref<MdnsSender> sender_;
@@ -140,28 +246,43 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
     const raw_ref<ReportingClient> reporting_client_;
     Config config_;
 
-    // List of RecordTracker instances used by this instance where the least
-    // recently updated element (or next to be deleted element) appears at the
-    // end of the list.
-    LruList lru_order_;
-
-    // A collection of active known record trackers, each is identified by
-    // domain name, DNS record type, and DNS record class. Multimap key is
-    // domain name only to allow easy support for wildcard processing for DNS
-    // record type and class and allow storing shared records that differ only
-    // in RDATA.
+    // The active known record trackers, each identified by domain name, DNS
+    // record type, and DNS record class. Buckets are keyed by domain name only
+    // to allow easy support for wildcard processing for DNS record type and
+    // class and allow storing shared records that differ only in RDATA. The
+    // number of buckets is always a power of two.
     //
-    // MdnsRecordTracker instances are stored as unique_ptr so they are not
-    // moved around in memory when the collection is modified. This allows
-    // passing a pointer to MdnsQuestionTracker to a task running on the
-    // TaskRunner.
-    RecordMap records_;
+    // Nodes are heap-allocated so they are not moved around in memory when the
+    // table is modified. This allows passing a pointer to MdnsRecordTracker to
+    // a task running on the TaskRunner.
+    std::vector<Bucket> buckets_;
+    size_t occupied_buckets_ = 0;
+    size_t size_ = 0;
+
+    // Intrusive list of all Nodes, where the least recently updated element
+    // (or next to be deleted element) is the tail.
+    Node* lru_head_ = nullptr;
+    Node* lru_tail_ = nullptr;
   };
 
   friend class MdnsQuerierTest;
 
   // MdnsReceiver::ResponseClient overrides.
-  void OnMessageReceived(const MdnsMessage& message) override;
+  void OnMessageReceived(const MdnsMessageView& message) override;
+
+  // Returns whether a record with a domain name with hash `name_hash` could be
+  // relevant to this querier, in which case it is worth decoding. False
+  // positives are possible, but false negatives are not.
+  bool IsNameHashRelevant(uint64_t name_hash) const;
+
+  // Decodes the record at `entry` of `message` and appends it to `records` if
+  // it should be processed. Returns whether it was appended.
+  bool ReadRecordToProcess(const MdnsMessageView& message,
+                           const MdnsMessageView::Entry& entry,
+                           std::vector<MdnsRecord>* records);
+
+  // Removes `count` entries for `name_hash` from `question_name_hashes_`.
+  void RemoveQuestionNameHash(uint64_t name_hash, size_t count);
 
   // Expires the record tracker provided. This callback is passed to owned
   // MdnsRecordTracker instances in `records_`.
@@ -224,6 +345,10 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
   // TaskRunner.
   std::multimap<DomainName, std::unique_ptr<MdnsQuestionTracker>> questions_;
 
+  // The number of entries in `questions_` for each domain name hash, used to
+  // drop irrelevant records before decoding them.
+  std::unordered_map<uint64_t, int> question_name_hashes_;
+
   // Set of records tracked by this querier.
   RecordTrackerLruCache records_;
 
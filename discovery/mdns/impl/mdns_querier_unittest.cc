@@ -4,8 +4,11 @@
 
 #include "discovery/mdns/impl/mdns_querier.h"
 
+#include <chrono>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "discovery/common/config.h"
 #include "discovery/common/testing/mock_reporting_client.h"
@@ -15,6 +18,7 @@
 #include "discovery/mdns/impl/mdns_trackers.h"
 #include "discovery/mdns/public/mdns_record_changed_callback.h"
 #include "discovery/mdns/public/mdns_writer.h"
+#include "discovery/mdns/testing/mdns_test_util.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "platform/base/udp_packet.h"
@@ -160,6 +164,33 @@ class MdnsQuerierTest : public testing::Test {
 
   size_t RecordCount(MdnsQuerier* querier) { return querier->records_.size(); }
 
+  // Creates the announcement of the `index`-th device offering `service_type`:
+  // a shared PTR record for its service instance, and its unique SRV, TXT and A
+  // records.
+  UdpPacket CreateDeviceAnnouncement(
+      int index,
+      const std::string& service_type = "_googlecast") {
+    const DomainName service{service_type, "_tcp", "local"};
+    const DomainName instance{"Device-" + std::to_string(index), service_type,
+                              "_tcp", "local"};
+    const DomainName host{"host-" + std::to_string(index), "local"};
+    const MdnsRecord ptr(service, DnsType::kPTR, DnsClass::kIN,
+                         RecordType::kShared, std::chrono::seconds(120),
+                         PtrRecordRdata(instance));
+    const MdnsRecord srv(instance, DnsType::kSRV, DnsClass::kIN,
+                         RecordType::kUnique, std::chrono::seconds(120),
+                         SrvRecordRdata(0, 0, 8009, host));
+    const MdnsRecord txt(instance, DnsType::kTXT, DnsClass::kIN,
+                         RecordType::kUnique, std::chrono::seconds(120),
+                         MakeTxtRecord({"id=" + std::to_string(index)}));
+    const IPAddress address{10, static_cast<uint8_t>(index >> 16),
+                            static_cast<uint8_t>(index >> 8),
+                            static_cast<uint8_t>(index)};
+    const MdnsRecord a(host, DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                       std::chrono::seconds(120), ARecordRdata(address));
+    return CreatePacketWithRecords({ptr}, {srv, txt, a});
+  }
+
   Config config_;
   FakeClock clock_;
   FakeTaskRunner task_runner_;
@@ -896,4 +927,92 @@ TEST_F(MdnsQuerierTest, TestMaxRecordsRespected) {
   EXPECT_TRUE(ContainsRecord(querier.get(), record1_created_, DnsType::kA));
 }
 
+TEST_F(MdnsQuerierTest, FindsRemainingRecordsAfterOthersExpire) {
+  constexpr int kNumDevices = 100;
+  config_.querier_max_records_cached = kNumDevices * 4;
+  std::unique_ptr<MdnsQuerier> querier = CreateQuerier();
+  testing::NiceMock<MockRecordChangedCallback> callback;
+  querier->StartQuery(DomainName{"_googlecast", "_tcp", "local"},
+                      DnsType::kPTR, DnsClass::kIN, &callback);
+  for (int i = 0; i < kNumDevices; ++i) {
+    receiver_.OnRead(&socket_, CreateDeviceAnnouncement(i));
+  }
+  ASSERT_EQ(RecordCount(querier.get()), size_t{kNumDevices * 4});
+
+  // Say goodbye to the A records of every other device.
+  for (int i = 0; i < kNumDevices; i += 2) {
+    const MdnsRecord goodbye(DomainName{"host-" + std::to_string(i), "local"},
+                             DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                             std::chrono::seconds(0),
+                             ARecordRdata(IPAddress{10, 0, 0,
+                                                    static_cast<uint8_t>(i)}));
+    receiver_.OnRead(&socket_, CreatePacketWithRecord(goodbye));
+  }
+  clock_.Advance(std::chrono::seconds(1));
+  ASSERT_EQ(RecordCount(querier.get()),
+            size_t{kNumDevices * 4 - kNumDevices / 2});
+
+  for (int i = 0; i < kNumDevices; ++i) {
+    const MdnsRecord a(DomainName{"host-" + std::to_string(i), "local"},
+                       DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                       std::chrono::seconds(120),
+                       ARecordRdata(IPAddress{10, 0, 0,
+                                              static_cast<uint8_t>(i)}));
+    EXPECT_EQ(ContainsRecord(querier.get(), a, DnsType::kA), i % 2 == 1);
+  }
+}
+
+// Tests that re-announcing cached records only refreshes them. See
+// discovery/mdns/e2e_test/mdns_querier_benchmark_tests.cc for the cost of an
+// announce storm over many more cached records.
+TEST_F(MdnsQuerierTest, ReannouncedRecordsAreOnlyRefreshed) {
+  constexpr int kNumDevices = 25;
+  constexpr int kNumRecords = kNumDevices * 4;
+  config_.querier_max_records_cached = kNumRecords;
+  std::unique_ptr<MdnsQuerier> querier = CreateQuerier();
+  MockRecordChangedCallback callback;
+  querier->StartQuery(DomainName{"_googlecast", "_tcp", "local"},
+                      DnsType::kPTR, DnsClass::kIN, &callback);
+
+  EXPECT_CALL(callback, OnRecordChanged(_, RecordChangedEvent::kCreated))
+      .Times(kNumDevices);
+  for (int i = 0; i < kNumDevices; ++i) {
+    receiver_.OnRead(&socket_, CreateDeviceAnnouncement(i));
+  }
+  ASSERT_EQ(RecordCount(querier.get()), size_t{kNumRecords});
+  testing::Mock::VerifyAndClearExpectations(&callback);
+
+  EXPECT_CALL(callback, OnRecordChanged(_, _)).Times(0);
+  for (int i = 0; i < kNumDevices; ++i) {
+    receiver_.OnRead(&socket_, CreateDeviceAnnouncement(i));
+  }
+  EXPECT_EQ(RecordCount(querier.get()), size_t{kNumRecords});
+}
+
+// Tests that only the records of devices offering the queried service are
+// cached, when most responses are for services that nobody queried. See
+// discovery/mdns/e2e_test/mdns_querier_benchmark_tests.cc for the cost of
+// processing such traffic.
+TEST_F(MdnsQuerierTest, DropsMulticastTrafficForOtherServices) {
+  constexpr int kNumDevices = 24;
+  // One device in kRelevantInterval offers the queried service.
+  constexpr int kRelevantInterval = 8;
+  config_.querier_max_records_cached = kNumDevices * 4;
+  std::unique_ptr<MdnsQuerier> querier = CreateQuerier();
+  MockRecordChangedCallback callback;
+  querier->StartQuery(DomainName{"_googlecast", "_tcp", "local"},
+                      DnsType::kPTR, DnsClass::kIN, &callback);
+
+  EXPECT_CALL(callback, OnRecordChanged(_, RecordChangedEvent::kCreated))
+      .Times(kNumDevices / kRelevantInterval);
+  for (int i = 0; i < kNumDevices; ++i) {
+    receiver_.OnRead(&socket_, i % kRelevantInterval == 0
+                                   ? CreateDeviceAnnouncement(i)
+                                   : CreateDeviceAnnouncement(i, "_airplay"));
+  }
+
+  EXPECT_EQ(RecordCount(querier.get()),
+            size_t{kNumDevices / kRelevantInterval * 4});
+}
+
 }  // namespace openscreen::discovery
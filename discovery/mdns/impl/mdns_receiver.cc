@@ -6,6 +6,7 @@
 
 #include <utility>
 
+#include "discovery/mdns/public/mdns_message_view.h"
 #include "discovery/mdns/public/mdns_reader.h"
 #include "util/std_util.h"
 #include "util/trace_logging.h"
@@ -62,11 +63,13 @@ void MdnsReceiver::OnRead(UdpSocket* socket,
   UdpPacket packet = std::move(packet_or_error.value());
 
   TRACE_SCOPED(TraceCategory::kMdns, "MdnsReceiver::OnRead");
+  // Responses are only indexed here, so that response clients can decode just
+  // the records they are interested in. Queries are parsed in full.
   MdnsReader reader(config_, packet.data(), packet.size());
-  const ErrorOr<MdnsMessage> message = reader.Read();
-  if (message.is_error()) {
-    TRACE_SET_RESULT(message.error());
-    if (message.error().code() == Error::Code::kMdnsNonConformingFailure) {
+  const ErrorOr<MdnsMessageView> view = reader.ReadView();
+  if (view.is_error()) {
+    TRACE_SET_RESULT(view.error());
+    if (view.error().code() == Error::Code::kMdnsNonConformingFailure) {
       OSP_DVLOG << "mDNS message dropped due to invalid rcode or opcode...";
     } else {
       OSP_DVLOG << "mDNS message failed to parse...";
@@ -74,20 +77,26 @@ void MdnsReceiver::OnRead(UdpSocket* socket,
     return;
   }
 
-  if (message.value().type() == MessageType::Response) {
+  if (view.value().type() == MessageType::Response) {
     for (ResponseClient* client : response_clients_) {
-      client->OnMessageReceived(message.value());
+      client->OnMessageReceived(view.value());
     }
     if (response_clients_.empty()) {
       OSP_DVLOG
           << "mDNS response message dropped. No response client registered...";
     }
   } else {
-    if (query_callback_) {
-      query_callback_(message.value(), packet.source());
-    } else {
+    if (!query_callback_) {
       OSP_DVLOG << "mDNS query message dropped. No query client registered...";
+      return;
+    }
+    const ErrorOr<MdnsMessage> message = view.value().ReadMessage();
+    if (message.is_error()) {
+      TRACE_SET_RESULT(message.error());
+      OSP_DVLOG << "mDNS message failed to parse...";
+      return;
     }
+    query_callback_(message.value(), packet.source());
   }
 }
 
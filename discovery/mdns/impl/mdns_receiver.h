@@ -17,6 +17,7 @@
 namespace openscreen::discovery {
 
 class MdnsMessage;
+class MdnsMessageView;
 
 class MdnsReceiver {
  public:
@@ -24,7 +25,10 @@ class MdnsReceiver {
    public:
     virtual ~ResponseClient();
 
-    virtual void OnMessageReceived(const MdnsMessage& message) = 0;
+    // Called with each response message received. `message` refers to the
+    // received packet, so it is only valid for the duration of the call, and
+    // its questions and records must be read from it as needed.
+    virtual void OnMessageReceived(const MdnsMessageView& message) = 0;
   };
 
   // MdnsReceiver does not own `socket` and `delegate`
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "discovery/common/config.h"
+#include "discovery/mdns/public/mdns_message_view.h"
 #include "discovery/mdns/public/mdns_records.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -21,10 +22,21 @@ using testing::_;
 using testing::Return;
 
 class MockMdnsReceiverDelegate : public MdnsReceiver::ResponseClient {
+ public:
+  MOCK_METHOD(void, OnMessageReceived, (const MdnsMessageView&));
+};
+
+class MockMdnsQueryDelegate {
  public:
   MOCK_METHOD(void, OnMessageReceived, (const MdnsMessage&));
 };
 
+// Matches a MdnsMessageView which reads as `message`.
+MATCHER_P(ReadsAs, message, "") {
+  const ErrorOr<MdnsMessage> read_message = arg.ReadMessage();
+  return read_message.is_value() && read_message.value() == message;
+}
+
 TEST(MdnsReceiverTest, ReceiveQuery) {
   // clang-format off
   const std::vector<uint8_t> kQueryBytes = {
@@ -45,7 +57,7 @@ TEST(MdnsReceiverTest, ReceiveQuery) {
 
   Config config;
   FakeUdpSocket socket;
-  MockMdnsReceiverDelegate delegate;
+  MockMdnsQueryDelegate delegate;
   MdnsReceiver receiver(config);
   receiver.SetQueryCallback(
       [&delegate](const MdnsMessage& message, const IPEndpoint& endpoint) {
@@ -121,7 +133,7 @@ TEST(MdnsReceiverTest, ReceiveResponse) {
                  .port = kDefaultMulticastPort});
 
   // Imitate a call to OnRead from NetworkRunner by calling it manually here
-  EXPECT_CALL(delegate, OnMessageReceived(message)).Times(1);
+  EXPECT_CALL(delegate, OnMessageReceived(ReadsAs(message))).Times(1);
   receiver.OnRead(&socket, std::move(packet));
 
   receiver.Stop();
@@ -376,7 +376,8 @@ MdnsResponder::MdnsResponder(RecordHandler& record_handler,
       task_runner_(task_runner),
       now_function_(now_function),
       random_delay_(random_delay),
-      config_(config) {
+      config_(config),
+      response_aggregator_(sender, task_runner, now_function) {
   OSP_CHECK_GT(config_.maximum_truncated_messages_per_query, 0);
   OSP_CHECK_GT(config_.maximum_concurrent_truncated_queries_per_interface, 0);
 
@@ -553,9 +554,17 @@ void MdnsResponder::ProcessQueries(
 
     // If this host is the exclusive owner, respond immediately. Else, there may
     // be network contention if all hosts respond simultaneously, so delay the
-    // response as dictated by RFC 6762.
+    // response as dictated by RFC 6762. Delayed multicast responses are
+    // aggregated with those to other queries due in the same window, per RFC
+    // 6762 section 6.4.
     if (is_exclusive_owner) {
       SendResponse(question, known_answers, send_response, is_exclusive_owner);
+    } else if (question.response_type() == ResponseType::kMulticast) {
+      response_aggregator_.AddResponse(
+          [this, question, known_answers]() {
+            return CreateResponse(question, known_answers, false);
+          },
+          random_delay_->GetSharedRecordResponseDelay());
     } else {
       const auto delay = random_delay_->GetSharedRecordResponseDelay();
       std::function<void()> response = [this, question, known_answers,
@@ -568,10 +577,9 @@ void MdnsResponder::ProcessQueries(
   }
 }
 
-void MdnsResponder::SendResponse(
+MdnsMessage MdnsResponder::CreateResponse(
     const MdnsQuestion& question,
     const std::vector<MdnsRecord>& known_answers,
-    std::function<void(const MdnsMessage&)> send_response,
     bool is_exclusive_owner) {
   OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
 
@@ -593,7 +601,6 @@ void MdnsResponder::SendResponse(
                       is_exclusive_owner);
   }
 
-  // Send the response only if it contains answers to the query.
   OSP_DVLOG << "\tCompleted Processing mDNS Query for domain: '"
             << question.name() << "', type: '" << question.dns_type()
             << "', with " << message.answers().size() << " results:";
@@ -606,6 +613,18 @@ void MdnsResponder::SendResponse(
   }
 #endif
 
+  return message;
+}
+
+void MdnsResponder::SendResponse(
+    const MdnsQuestion& question,
+    const std::vector<MdnsRecord>& known_answers,
+    std::function<void(const MdnsMessage&)> send_response,
+    bool is_exclusive_owner) {
+  const MdnsMessage message =
+      CreateResponse(question, known_answers, is_exclusive_owner);
+
+  // Send the response only if it contains answers to the query.
   if (!message.answers().empty()) {
     send_response(message);
   }
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "discovery/common/config.h"
+#include "discovery/mdns/impl/mdns_response_aggregator.h"
 #include "discovery/mdns/public/mdns_records.h"
 #include "platform/api/time.h"
 #include "util/alarm.h"
@@ -144,6 +145,11 @@ class MdnsResponder {
                       const std::vector<MdnsQuestion>& questions,
                       const std::vector<MdnsRecord>& known_answers);
 
+  // Creates the response to the provided query.
+  MdnsMessage CreateResponse(const MdnsQuestion& question,
+                             const std::vector<MdnsRecord>& known_answers,
+                             bool is_exclusive_owner);
+
   // Sends the response to the provided query.
   void SendResponse(const MdnsQuestion& question,
                     const std::vector<MdnsRecord>& known_answers,
@@ -165,6 +171,9 @@ class MdnsResponder {
   const raw_ref<MdnsRandom> random_delay_;
   Config config_;
 
+  // Aggregates the delayed multicast responses sent on this interface.
+  MdnsResponseAggregator response_aggregator_;
+
   friend class MdnsResponderTest;
 };
 
@@ -6,6 +6,7 @@
 
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "discovery/common/config.h"
 #include "discovery/mdns/impl/mdns_probe_manager.h"
@@ -16,6 +17,7 @@
 #include "platform/test/fake_clock.h"
 #include "platform/test/fake_task_runner.h"
 #include "platform/test/fake_udp_socket.h"
+#include "util/osp_logging.h"
 #include "util/std_util.h"
 
 namespace openscreen::discovery {
@@ -284,6 +286,58 @@ TEST_F(MdnsResponderTest, MultipleQuestionsProcessed) {
   clock_.Advance(Clock::duration(kMaximumSharedRecordResponseDelayMs));
 }
 
+// Simulates a query storm, with many clients browsing for the same service
+// type, and validates that the responses are aggregated into few packets.
+TEST_F(MdnsResponderTest, QueryStormResponsesAggregated) {
+  constexpr int kNumClients = 200;
+  constexpr auto kQueryInterval = std::chrono::milliseconds(5);
+
+  const MdnsRecord ptr = GetFakePtrRecord(domain_);
+  record_handler_.AddRecord(ptr);
+  record_handler_.AddRecord(GetFakeSrvRecord(domain_));
+  record_handler_.AddRecord(GetFakeTxtRecord(domain_));
+  record_handler_.AddRecord(GetFakeARecord(domain_));
+  EXPECT_CALL(probe_manager_, IsDomainClaimed(_)).WillRepeatedly(Return(false));
+  EXPECT_CALL(record_handler_, HasRecords(_, _, _))
+      .WillRepeatedly(Return(true));
+
+  int packets_sent = 0;
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillRepeatedly([&packets_sent, &ptr](const MdnsMessage& message) {
+        packets_sent++;
+        EXPECT_EQ(message.answers(), std::vector<MdnsRecord>{ptr});
+        EXPECT_EQ(message.additional_records().size(), size_t{3});
+        return Error::None();
+      });
+
+  // One in four clients already knows the answer, which must not prevent it
+  // from being sent to the others.
+  int queries_answered = 0;
+  for (int i = 0; i < kNumClients; i++) {
+    MdnsMessage message(0, MessageType::Query);
+    message.AddQuestion(MdnsQuestion(ptr.name(), DnsType::kPTR, DnsClass::kIN,
+                                     ResponseType::kMulticast));
+    if (i % 4 == 0) {
+      message.AddAnswer(ptr);
+    } else {
+      queries_answered++;
+    }
+    OnMessageReceived(message,
+                      IPEndpoint{IPAddress(192, 168, 1, i % 256), 5353});
+    clock_.Advance(kQueryInterval);
+  }
+  clock_.Advance(Clock::duration(kMaximumSharedRecordResponseDelayMs));
+
+  EXPECT_GT(packets_sent, 0);
+  EXPECT_LT(packets_sent, queries_answered / 2);
+  OSP_LOG_INFO << "Query storm of " << kNumClients << " clients: "
+               << queries_answered << " responses sent in " << packets_sent
+               << " packets, " << queries_answered - packets_sent
+               << " packets saved";
+  RecordProperty("query_storm_packets_sent", packets_sent);
+  RecordProperty("query_storm_packets_saved", queries_answered - packets_sent);
+}
+
 // Validate that the correct messaging scheme (unicast vs multicast) is used.
 TEST_F(MdnsResponderTest, UnicastMessageSentOverUnicast) {
   MdnsQuestion question(domain_, DnsType::kANY, DnsClass::kANY,
@@ -0,0 +1,168 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/impl/mdns_response_aggregator.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "discovery/mdns/impl/mdns_sender.h"
+#include "discovery/mdns/public/mdns_writer.h"
+#include "platform/api/task_runner.h"
+#include "util/osp_logging.h"
+#include "util/std_util.h"
+
+namespace openscreen::discovery {
+namespace {
+
+bool IsEmpty(const MdnsMessage& message) {
+  return message.answers().empty() && message.additional_records().empty();
+}
+
+}  // namespace
+
+MdnsResponseAggregator::MdnsResponseAggregator(MdnsSender& sender,
+                                               TaskRunner& task_runner,
+                                               ClockNowFunctionPtr now_function,
+                                               size_t max_message_size)
+    : sender_(sender),
+      now_function_(now_function),
+      max_message_size_(max_message_size),
+      buffer_(max_message_size),
+      alarm_(now_function, task_runner) {}
+
+MdnsResponseAggregator::~MdnsResponseAggregator() = default;
+
+void MdnsResponseAggregator::AddResponse(ResponseBuilder builder,
+                                         Clock::duration delay) {
+  OSP_CHECK_GE(delay, kMinimumResponseDelay);
+
+  const Clock::time_point now = now_function_();
+  pending_responses_.push_back(PendingResponse{
+      now + kMinimumResponseDelay, now + delay, std::move(builder)});
+  ScheduleAlarm();
+}
+
+void MdnsResponseAggregator::SendPendingResponses() {
+  const Clock::time_point now = now_function_();
+
+  // Remove the responses to send before building them, so that the pending
+  // list is in a consistent state whatever the builders do.
+  auto it = std::stable_partition(
+      pending_responses_.begin(), pending_responses_.end(),
+      [now](const PendingResponse& response) {
+        return response.earliest_send_time > now;
+      });
+  std::vector<PendingResponse> responses(
+      std::make_move_iterator(it),
+      std::make_move_iterator(pending_responses_.end()));
+  pending_responses_.erase(it, pending_responses_.end());
+
+  std::vector<MdnsMessage> messages;
+  messages.reserve(responses.size());
+  for (PendingResponse& pending : responses) {
+    MdnsMessage message = pending.builder();
+    if (!message.answers().empty()) {
+      messages.push_back(std::move(message));
+    }
+  }
+  responses_sent_ += messages.size();
+
+  // Merge the responses. A record is only sent once, even if it answers
+  // multiple queries, and additional records are not repeated when they are
+  // already part of the aggregate.
+  std::vector<MdnsRecord> answers;
+  for (const MdnsMessage& message : messages) {
+    for (const MdnsRecord& record : message.answers()) {
+      if (!Contains(answers, record)) {
+        answers.push_back(record);
+      }
+    }
+  }
+  std::vector<MdnsRecord> additional_records;
+  for (const MdnsMessage& message : messages) {
+    for (const MdnsRecord& record : message.additional_records()) {
+      if (!Contains(answers, record) &&
+          !Contains(additional_records, record)) {
+        additional_records.push_back(record);
+      }
+    }
+  }
+
+  if (!answers.empty()) {
+    OSP_DVLOG << "Sending " << answers.size() << " answers and "
+              << additional_records.size() << " additional records for "
+              << messages.size() << " aggregated responses";
+    SendRecords(std::move(answers), std::move(additional_records));
+  }
+
+  if (!pending_responses_.empty()) {
+    ScheduleAlarm();
+  }
+}
+
+void MdnsResponseAggregator::ScheduleAlarm() {
+  OSP_CHECK(!pending_responses_.empty());
+  const auto it = std::min_element(
+      pending_responses_.begin(), pending_responses_.end(),
+      [](const PendingResponse& a, const PendingResponse& b) {
+        return a.send_time < b.send_time;
+      });
+  alarm_.Schedule([this]() { SendPendingResponses(); }, it->send_time);
+}
+
+void MdnsResponseAggregator::SendRecords(
+    std::vector<MdnsRecord> answers,
+    std::vector<MdnsRecord> additional_records) {
+  MdnsMessage message(CreateMessageId(), MessageType::Response);
+  for (MdnsRecord& record : answers) {
+    if (!IsEmpty(message) && !CanAddRecord(message, record, true)) {
+      SendMessage(message);
+      message = MdnsMessage(CreateMessageId(), MessageType::Response);
+    }
+    message.AddAnswer(std::move(record));
+  }
+
+  for (MdnsRecord& record : additional_records) {
+    if (!IsEmpty(message) && !CanAddRecord(message, record, false)) {
+      SendMessage(message);
+      message = MdnsMessage(CreateMessageId(), MessageType::Response);
+    }
+    message.AddAdditionalRecord(std::move(record));
+  }
+
+  if (!IsEmpty(message)) {
+    SendMessage(message);
+  }
+}
+
+bool MdnsResponseAggregator::CanAddRecord(const MdnsMessage& message,
+                                          const MdnsRecord& record,
+                                          bool is_answer) {
+  if (message.MaxWireSize() + record.MaxWireSize() <= max_message_size_) {
+    return true;
+  }
+
+  // Domain name compression might still make the record fit, so try writing
+  // the resulting message.
+  MdnsMessage candidate = message;
+  if (is_answer) {
+    candidate.AddAnswer(record);
+  } else {
+    candidate.AddAdditionalRecord(record);
+  }
+  MdnsWriter writer(buffer_.data(), buffer_.size());
+  return writer.Write(candidate);
+}
+
+void MdnsResponseAggregator::SendMessage(const MdnsMessage& message) {
+  messages_sent_++;
+  const Error error = sender_->SendMulticast(message);
+  if (!error.ok()) {
+    OSP_DVLOG << "Failed to send aggregated mDNS response: " << error;
+  }
+}
+
+}  // namespace openscreen::discovery
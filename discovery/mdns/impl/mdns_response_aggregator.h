@@ -0,0 +1,123 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_IMPL_MDNS_RESPONSE_AGGREGATOR_H_
+#define DISCOVERY_MDNS_IMPL_MDNS_RESPONSE_AGGREGATOR_H_
+
+#include <stddef.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "discovery/mdns/public/mdns_constants.h"
+#include "discovery/mdns/public/mdns_records.h"
+#include "platform/api/time.h"
+#include "util/alarm.h"
+#include "util/raw_ref.h"
+
+namespace openscreen {
+
+class TaskRunner;
+
+namespace discovery {
+
+class MdnsSender;
+
+// Coalesces the delayed multicast responses of a single interface into as few
+// messages as possible, as recommended by RFC 6762 section 6.4.
+//
+// Each response is due at a time chosen by the caller within the 20-120 ms
+// window of RFC 6762 section 6. When the first pending response becomes due,
+// every pending response which has already waited for at least the minimum
+// delay of that window is sent along with it. The answers of the aggregated
+// responses are deduplicated, additional records already present in the
+// aggregate are dropped, and the result is split into messages which fit into
+// a single packet.
+class MdnsResponseAggregator {
+ public:
+  // Builds the response to send, at the time that it is sent. Known answer
+  // suppression is expected to have been applied to the result by the builder,
+  // so the union of the results only holds records which at least one of the
+  // aggregated queriers did not know.
+  using ResponseBuilder = std::function<MdnsMessage()>;
+
+  // Per RFC 6762 section 6, the minimum delay before responding to a query for
+  // shared records.
+  static constexpr std::chrono::milliseconds kMinimumResponseDelay{20};
+
+  // `sender` and `task_runner` are expected to persist for the duration of
+  // this instance's lifetime. Messages sent are at most `max_message_size`
+  // bytes on the wire.
+  MdnsResponseAggregator(MdnsSender& sender,
+                         TaskRunner& task_runner,
+                         ClockNowFunctionPtr now_function,
+                         size_t max_message_size = kMaxMulticastMessageSize);
+  ~MdnsResponseAggregator();
+
+  MdnsResponseAggregator(const MdnsResponseAggregator&) = delete;
+  MdnsResponseAggregator(MdnsResponseAggregator&&) noexcept = delete;
+  MdnsResponseAggregator& operator=(const MdnsResponseAggregator&) = delete;
+  MdnsResponseAggregator& operator=(MdnsResponseAggregator&&) = delete;
+
+  // Queues the response built by `builder` to be multicast `delay` from now,
+  // or earlier if it can be aggregated with another response. `delay` must be
+  // at least kMinimumResponseDelay.
+  void AddResponse(ResponseBuilder builder, Clock::duration delay);
+
+  // Returns the number of responses which have been sent, and the number of
+  // messages they were sent in.
+  size_t responses_sent() const { return responses_sent_; }
+  size_t messages_sent() const { return messages_sent_; }
+
+ private:
+  struct PendingResponse {
+    // The earliest time at which the response may be sent.
+    Clock::time_point earliest_send_time;
+
+    // The time at which the response is due.
+    Clock::time_point send_time;
+
+    ResponseBuilder builder;
+  };
+
+  // Sends all pending responses which may be sent now and reschedules the
+  // alarm for the remaining ones.
+  void SendPendingResponses();
+
+  // Schedules `alarm_` for the earliest send time of `pending_responses_`.
+  void ScheduleAlarm();
+
+  // Splits the provided records into messages which fit into
+  // `max_message_size_` and sends them.
+  void SendRecords(std::vector<MdnsRecord> answers,
+                   std::vector<MdnsRecord> additional_records);
+
+  // Returns whether `message` still fits into `max_message_size_` once
+  // `record` has been added to its answers or additional records.
+  bool CanAddRecord(const MdnsMessage& message,
+                    const MdnsRecord& record,
+                    bool is_answer);
+
+  void SendMessage(const MdnsMessage& message);
+
+  const raw_ref<MdnsSender> sender_;
+  const ClockNowFunctionPtr now_function_;
+  const size_t max_message_size_;
+
+  std::vector<PendingResponse> pending_responses_;
+
+  // Scratch buffer used to measure the compressed size of messages.
+  std::vector<uint8_t> buffer_;
+
+  size_t responses_sent_ = 0;
+  size_t messages_sent_ = 0;
+
+  Alarm alarm_;
+};
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_MDNS_IMPL_MDNS_RESPONSE_AGGREGATOR_H_
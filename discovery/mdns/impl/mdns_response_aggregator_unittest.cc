@@ -0,0 +1,177 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/impl/mdns_response_aggregator.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "discovery/mdns/impl/mdns_sender.h"
+#include "discovery/mdns/public/mdns_writer.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "platform/test/fake_udp_socket.h"
+
+namespace openscreen::discovery {
+namespace {
+
+using testing::_;
+using testing::StrictMock;
+
+constexpr std::chrono::seconds kTtl(120);
+
+class MockMdnsSender : public MdnsSender {
+ public:
+  explicit MockMdnsSender(UdpSocket& socket) : MdnsSender(socket) {}
+
+  MOCK_METHOD(Error, SendMulticast, (const MdnsMessage& message), (override));
+};
+
+MdnsRecord CreatePtrRecord(const std::string& instance) {
+  const DomainName service{"_googlecast", "_tcp", "local"};
+  return MdnsRecord(service, DnsType::kPTR, DnsClass::kIN, RecordType::kShared,
+                    kTtl,
+                    PtrRecordRdata(DomainName{instance, "_googlecast", "_tcp",
+                                              "local"}));
+}
+
+MdnsRecord CreateARecord(const std::string& host) {
+  return MdnsRecord(DomainName{host, "local"}, DnsType::kA, DnsClass::kIN,
+                    RecordType::kUnique, kTtl,
+                    ARecordRdata(IPAddress{192, 168, 0, 1}));
+}
+
+MdnsMessage CreateResponse(std::vector<MdnsRecord> answers,
+                           std::vector<MdnsRecord> additional_records = {}) {
+  return MdnsMessage(CreateMessageId(), MessageType::Response, {},
+                     std::move(answers), {}, std::move(additional_records));
+}
+
+size_t GetWireSize(const MdnsMessage& message) {
+  std::vector<uint8_t> buffer(message.MaxWireSize());
+  MdnsWriter writer(buffer.data(), buffer.size());
+  EXPECT_TRUE(writer.Write(message));
+  return writer.offset();
+}
+
+}  // namespace
+
+class MdnsResponseAggregatorTest : public testing::Test {
+ public:
+  MdnsResponseAggregatorTest()
+      : clock_(Clock::now()),
+        task_runner_(clock_),
+        sender_(socket_),
+        aggregator_(sender_, task_runner_, FakeClock::now) {}
+
+ protected:
+  void AddResponse(MdnsMessage response, Clock::duration delay) {
+    aggregator_.AddResponse(
+        [response = std::move(response)]() { return response; }, delay);
+  }
+
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  FakeUdpSocket socket_;
+  StrictMock<MockMdnsSender> sender_;
+  MdnsResponseAggregator aggregator_;
+};
+
+TEST_F(MdnsResponseAggregatorTest, ResponsesInWindowAreAggregated) {
+  const MdnsRecord ptr1 = CreatePtrRecord("instance1");
+  const MdnsRecord ptr2 = CreatePtrRecord("instance2");
+  const MdnsRecord a = CreateARecord("host");
+  AddResponse(CreateResponse({ptr1}, {a}), std::chrono::milliseconds(100));
+  clock_.Advance(std::chrono::milliseconds(10));
+  AddResponse(CreateResponse({ptr2, a}), std::chrono::milliseconds(60));
+  clock_.Advance(std::chrono::milliseconds(10));
+  AddResponse(CreateResponse({ptr1}), std::chrono::milliseconds(100));
+
+  // The second response is due first, and the first and third responses have
+  // waited long enough to be sent along with it. The A record is only sent
+  // once, as an answer.
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillOnce([&](const MdnsMessage& message) {
+        EXPECT_EQ(message.answers(),
+                  (std::vector<MdnsRecord>{ptr1, ptr2, a}));
+        EXPECT_TRUE(message.additional_records().empty());
+        return Error::None();
+      });
+  clock_.Advance(std::chrono::milliseconds(50));
+  testing::Mock::VerifyAndClearExpectations(&sender_);
+
+  EXPECT_EQ(aggregator_.responses_sent(), size_t{3});
+  EXPECT_EQ(aggregator_.messages_sent(), size_t{1});
+  clock_.Advance(std::chrono::milliseconds(200));
+}
+
+TEST_F(MdnsResponseAggregatorTest, ResponsesAreNotSentBeforeMinimumDelay) {
+  const MdnsRecord ptr1 = CreatePtrRecord("instance1");
+  const MdnsRecord ptr2 = CreatePtrRecord("instance2");
+  AddResponse(CreateResponse({ptr1}), std::chrono::milliseconds(20));
+  clock_.Advance(std::chrono::milliseconds(10));
+  AddResponse(CreateResponse({ptr2}), std::chrono::milliseconds(100));
+
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillOnce([&](const MdnsMessage& message) {
+        EXPECT_EQ(message.answers(), std::vector<MdnsRecord>{ptr1});
+        return Error::None();
+      });
+  clock_.Advance(std::chrono::milliseconds(10));
+  testing::Mock::VerifyAndClearExpectations(&sender_);
+
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillOnce([&](const MdnsMessage& message) {
+        EXPECT_EQ(message.answers(), std::vector<MdnsRecord>{ptr2});
+        return Error::None();
+      });
+  clock_.Advance(std::chrono::milliseconds(90));
+}
+
+TEST_F(MdnsResponseAggregatorTest, EmptyResponsesAreNotSent) {
+  AddResponse(CreateResponse({}, {CreateARecord("host")}),
+              std::chrono::milliseconds(20));
+  clock_.Advance(std::chrono::milliseconds(200));
+  EXPECT_EQ(aggregator_.responses_sent(), size_t{0});
+  EXPECT_EQ(aggregator_.messages_sent(), size_t{0});
+}
+
+TEST_F(MdnsResponseAggregatorTest, AggregateIsSplitIntoPackets) {
+  // Instance names long enough that only a few PTR records fit in a message
+  // when ignoring domain name compression, while many more fit once the common
+  // suffix is compressed.
+  std::vector<MdnsRecord> expected_answers;
+  for (int i = 0; i < 100; i++) {
+    expected_answers.push_back(
+        CreatePtrRecord(std::string(60, 'a') + std::to_string(i)));
+    AddResponse(CreateResponse({expected_answers.back()}),
+                std::chrono::milliseconds(20));
+  }
+
+  std::vector<MdnsRecord> answers;
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillRepeatedly([&](const MdnsMessage& message) {
+        EXPECT_LE(GetWireSize(message), kMaxMulticastMessageSize);
+        answers.insert(answers.end(), message.answers().begin(),
+                       message.answers().end());
+        return Error::None();
+      });
+  clock_.Advance(std::chrono::milliseconds(20));
+
+  EXPECT_EQ(answers, expected_answers);
+  EXPECT_EQ(aggregator_.responses_sent(), size_t{100});
+
+  // Each message holds more records than its uncompressed size would allow.
+  size_t max_wire_size = 0;
+  for (const MdnsRecord& record : expected_answers) {
+    max_wire_size += record.MaxWireSize();
+  }
+  EXPECT_LT(aggregator_.messages_sent(),
+            max_wire_size / kMaxMulticastMessageSize);
+}
+
+}  // namespace openscreen::discovery
@@ -0,0 +1,97 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/public/mdns_message_view.h"
+
+#include <utility>
+
+#include "discovery/mdns/public/mdns_reader.h"
+
+namespace openscreen::discovery {
+
+MdnsMessageView::MdnsMessageView(size_t maximum_allowed_rdata_size,
+                                 ByteView buffer,
+                                 uint16_t id,
+                                 MessageType type,
+                                 bool is_truncated,
+                                 std::vector<Entry> questions,
+                                 std::vector<Entry> answers,
+                                 std::vector<Entry> authority_records,
+                                 std::vector<Entry> additional_records)
+    : maximum_allowed_rdata_size_(maximum_allowed_rdata_size),
+      buffer_(buffer),
+      id_(id),
+      type_(type),
+      is_truncated_(is_truncated),
+      questions_(std::move(questions)),
+      answers_(std::move(answers)),
+      authority_records_(std::move(authority_records)),
+      additional_records_(std::move(additional_records)) {}
+
+MdnsMessageView::MdnsMessageView(const MdnsMessageView& other) = default;
+
+MdnsMessageView::MdnsMessageView(MdnsMessageView&& other) noexcept = default;
+
+MdnsMessageView::~MdnsMessageView() = default;
+
+MdnsMessageView& MdnsMessageView::operator=(const MdnsMessageView& rhs) =
+    default;
+
+MdnsMessageView& MdnsMessageView::operator=(MdnsMessageView&& rhs) = default;
+
+ErrorOr<MdnsQuestion> MdnsMessageView::ReadQuestion(const Entry& entry) const {
+  MdnsReader reader(maximum_allowed_rdata_size_, buffer_.data(),
+                    buffer_.size());
+  MdnsQuestion question;
+  if (!reader.Skip(entry.offset) || !reader.Read(&question)) {
+    return Error::Code::kMdnsReadFailure;
+  }
+  return question;
+}
+
+ErrorOr<MdnsRecord> MdnsMessageView::ReadRecord(const Entry& entry) const {
+  MdnsReader reader(maximum_allowed_rdata_size_, buffer_.data(),
+                    buffer_.size());
+  MdnsRecord record;
+  if (!reader.Skip(entry.offset) || !reader.Read(&record)) {
+    return Error::Code::kMdnsReadFailure;
+  }
+  return record;
+}
+
+ErrorOr<MdnsMessage> MdnsMessageView::ReadMessage() const {
+  std::vector<MdnsQuestion> questions;
+  questions.reserve(questions_.size());
+  for (const Entry& entry : questions_) {
+    ErrorOr<MdnsQuestion> question = ReadQuestion(entry);
+    if (question.is_error()) {
+      return std::move(question.error());
+    }
+    questions.push_back(std::move(question.value()));
+  }
+
+  std::vector<MdnsRecord> sections[3];
+  const std::vector<Entry>* entry_sections[3] = {
+      &answers_, &authority_records_, &additional_records_};
+  for (int i = 0; i < 3; ++i) {
+    sections[i].reserve(entry_sections[i]->size());
+    for (const Entry& entry : *entry_sections[i]) {
+      ErrorOr<MdnsRecord> record = ReadRecord(entry);
+      if (record.is_error()) {
+        return std::move(record.error());
+      }
+      sections[i].push_back(std::move(record.value()));
+    }
+  }
+
+  ErrorOr<MdnsMessage> message = MdnsMessage::TryCreate(
+      id_, type_, std::move(questions), std::move(sections[0]),
+      std::move(sections[1]), std::move(sections[2]));
+  if (message.is_value() && is_truncated_) {
+    message.value().set_truncated();
+  }
+  return message;
+}
+
+}  // namespace openscreen::discovery
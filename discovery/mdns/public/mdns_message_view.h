@@ -0,0 +1,96 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_PUBLIC_MDNS_MESSAGE_VIEW_H_
+#define DISCOVERY_MDNS_PUBLIC_MDNS_MESSAGE_VIEW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "discovery/mdns/public/mdns_constants.h"
+#include "discovery/mdns/public/mdns_records.h"
+#include "platform/base/error.h"
+#include "platform/base/span.h"
+
+namespace openscreen::discovery {
+
+// A mDNS message which has been indexed but not parsed, as returned by
+// MdnsReader::ReadView(). The location and fixed-size fields of each of its
+// questions and records are known, along with the hash of its domain name, but
+// domain names and RDATA are only decoded when a question or record is read.
+// This allows a receiver to drop the records it has no interest in without
+// decoding them.
+//
+// A MdnsMessageView refers to the buffer it was read from, which must outlive
+// it.
+class MdnsMessageView {
+ public:
+  // A question or record of the message.
+  struct Entry {
+    // The offset of the entry's domain name from the start of the message.
+    size_t offset;
+
+    // The DomainName::Hash() of the entry's domain name.
+    uint64_t name_hash;
+
+    DnsType dns_type;
+    DnsClass dns_class;
+  };
+
+  MdnsMessageView(size_t maximum_allowed_rdata_size,
+                  ByteView buffer,
+                  uint16_t id,
+                  MessageType type,
+                  bool is_truncated,
+                  std::vector<Entry> questions,
+                  std::vector<Entry> answers,
+                  std::vector<Entry> authority_records,
+                  std::vector<Entry> additional_records);
+  MdnsMessageView(const MdnsMessageView& other);
+  MdnsMessageView(MdnsMessageView&& other) noexcept;
+  ~MdnsMessageView();
+
+  MdnsMessageView& operator=(const MdnsMessageView& rhs);
+  MdnsMessageView& operator=(MdnsMessageView&& rhs);
+
+  uint16_t id() const { return id_; }
+  MessageType type() const { return type_; }
+  bool is_truncated() const { return is_truncated_; }
+  const std::vector<Entry>& questions() const { return questions_; }
+  const std::vector<Entry>& answers() const { return answers_; }
+  const std::vector<Entry>& authority_records() const {
+    return authority_records_;
+  }
+  const std::vector<Entry>& additional_records() const {
+    return additional_records_;
+  }
+
+  // Decodes the question or record at `entry`, which must be an entry of the
+  // corresponding section of this message.
+  ErrorOr<MdnsQuestion> ReadQuestion(const Entry& entry) const;
+  ErrorOr<MdnsRecord> ReadRecord(const Entry& entry) const;
+
+  // Decodes the whole message, failing if any of its questions or records
+  // cannot be decoded.
+  ErrorOr<MdnsMessage> ReadMessage() const;
+
+ private:
+  // The Config::maximum_valid_rdata_size of the MdnsReader which created this
+  // view.
+  size_t maximum_allowed_rdata_size_;
+  ByteView buffer_;
+  uint16_t id_;
+  MessageType type_;
+  bool is_truncated_;
+  std::vector<Entry> questions_;
+  std::vector<Entry> answers_;
+  std::vector<Entry> authority_records_;
+  std::vector<Entry> additional_records_;
+};
+
+}  // namespace openscreen::discovery
+
+#endif  // DISCOVERY_MDNS_PUBLIC_MDNS_MESSAGE_VIEW_H_
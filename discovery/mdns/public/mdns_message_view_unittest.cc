@@ -0,0 +1,178 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/public/mdns_message_view.h"
+
+#include <vector>
+
+#include "discovery/common/config.h"
+#include "discovery/mdns/public/mdns_reader.h"
+#include "discovery/mdns/public/mdns_writer.h"
+#include "discovery/mdns/testing/mdns_test_util.h"
+#include "gtest/gtest.h"
+
+namespace openscreen::discovery {
+
+namespace {
+
+constexpr std::chrono::seconds kTtl(120);
+
+}  // namespace
+
+TEST(MdnsMessageViewTest, ReadsSameMessageAsReader) {
+  const DomainName instance{"Device", "_googlecast", "_tcp", "local"};
+  const DomainName host{"Host", "local"};
+  MdnsMessage message(1, MessageType::Response);
+  message.AddQuestion(MdnsQuestion(DomainName{"_googlecast", "_tcp", "local"},
+                                   DnsType::kPTR, DnsClass::kIN,
+                                   ResponseType::kMulticast));
+  message.AddAnswer(MdnsRecord(DomainName{"_googlecast", "_tcp", "local"},
+                               DnsType::kPTR, DnsClass::kIN,
+                               RecordType::kShared, kTtl,
+                               PtrRecordRdata(instance)));
+  message.AddAnswer(MdnsRecord(instance, DnsType::kSRV, DnsClass::kIN,
+                               RecordType::kUnique, kTtl,
+                               SrvRecordRdata(0, 0, 8009, host)));
+  message.AddAdditionalRecord(MdnsRecord(host, DnsType::kA, DnsClass::kIN,
+                                         RecordType::kUnique, kTtl,
+                                         ARecordRdata(IPAddress{10, 0, 0, 1})));
+  message.set_truncated();
+
+  std::vector<uint8_t> buffer(message.MaxWireSize());
+  MdnsWriter writer(buffer.data(), buffer.size());
+  ASSERT_TRUE(writer.Write(message));
+
+  Config config;
+  MdnsReader reader(config, buffer.data(), writer.offset());
+  const ErrorOr<MdnsMessageView> view = reader.ReadView();
+  ASSERT_TRUE(view.is_value());
+  EXPECT_EQ(reader.remaining(), UINT64_C(0));
+  EXPECT_EQ(view.value().id(), 1);
+  EXPECT_EQ(view.value().type(), MessageType::Response);
+  EXPECT_TRUE(view.value().is_truncated());
+
+  ASSERT_EQ(view.value().questions().size(), size_t{1});
+  ASSERT_EQ(view.value().answers().size(), size_t{2});
+  EXPECT_TRUE(view.value().authority_records().empty());
+  ASSERT_EQ(view.value().additional_records().size(), size_t{1});
+
+  // The name hashes are computed through compressed names.
+  const MdnsMessageView::Entry& srv_entry = view.value().answers()[1];
+  EXPECT_EQ(srv_entry.name_hash, instance.Hash());
+  EXPECT_EQ(srv_entry.dns_type, DnsType::kSRV);
+  EXPECT_EQ(srv_entry.dns_class, DnsClass::kIN);
+  EXPECT_EQ(view.value().additional_records()[0].name_hash,
+            DomainName({"host", "LOCAL"}).Hash());
+
+  const ErrorOr<MdnsRecord> srv = view.value().ReadRecord(srv_entry);
+  ASSERT_TRUE(srv.is_value());
+  EXPECT_EQ(srv.value(), message.answers()[1]);
+  const ErrorOr<MdnsQuestion> question =
+      view.value().ReadQuestion(view.value().questions()[0]);
+  ASSERT_TRUE(question.is_value());
+  EXPECT_EQ(question.value(), message.questions()[0]);
+
+  const ErrorOr<MdnsMessage> read_message = view.value().ReadMessage();
+  ASSERT_TRUE(read_message.is_value());
+  EXPECT_EQ(read_message.value(), message);
+}
+
+TEST(MdnsMessageViewTest, DefersRdataErrorsUntilRead) {
+  // clang-format off
+  constexpr uint8_t kMessage[] = {
+      // Header
+      0x00, 0x01,  // ID = 1
+      0x84, 0x00,  // FLAGS = AA | RESPONSE
+      0x00, 0x00,  // Questions = 0
+      0x00, 0x02,  // Answers = 2
+      0x00, 0x00,  // Authority = 0
+      0x00, 0x00,  // Additional = 0
+      // Record 1
+      0x07, 'r', 'e', 'c', 'o', 'r', 'd', '1',
+      0x00,
+      0x00, 0x01,              // TYPE = A (1)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x03,              // RDLENGTH = 3 bytes, too short for A.
+      0xac, 0x00, 0x00,
+      // Record 2
+      0x07, 'r', 'e', 'c', 'o', 'r', 'd', '2',
+      0x00,
+      0x00, 0x01,              // TYPE = A (1)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x04,              // RDLENGTH = 4 bytes
+      0xac, 0x00, 0x00, 0x01,  // 172.0.0.1
+  };
+  // clang-format on
+
+  Config config;
+  MdnsReader reader(config, kMessage, sizeof(kMessage));
+  const ErrorOr<MdnsMessageView> view = reader.ReadView();
+  ASSERT_TRUE(view.is_value());
+  ASSERT_EQ(view.value().answers().size(), size_t{2});
+
+  EXPECT_TRUE(view.value().ReadRecord(view.value().answers()[0]).is_error());
+  const ErrorOr<MdnsRecord> record =
+      view.value().ReadRecord(view.value().answers()[1]);
+  ASSERT_TRUE(record.is_value());
+  EXPECT_EQ(record.value(),
+            MdnsRecord(DomainName{"record2"}, DnsType::kA, DnsClass::kIN,
+                       RecordType::kShared, kTtl,
+                       ARecordRdata(IPAddress{172, 0, 0, 1})));
+
+  // The whole message cannot be read, as with MdnsReader::Read().
+  EXPECT_TRUE(view.value().ReadMessage().is_error());
+  MdnsReader message_reader(config, kMessage, sizeof(kMessage));
+  EXPECT_TRUE(message_reader.Read().is_error());
+}
+
+TEST(MdnsMessageViewTest, FailsOnMissingRecord) {
+  // clang-format off
+  constexpr uint8_t kInvalidMessage[] = {
+      0x00, 0x00,  // ID = 0
+      0x00, 0x00,  // FLAGS = 0
+      0x00, 0x00,  // Questions = 0
+      0x00, 0x00,  // Answers = 0
+      0x00, 0x00,  // Authority = 0
+      0x00, 0x02,  // Additional = 2
+      0x07, 't', 'e', 's', 't', 'i', 'n', 'g',
+      0x05, 'l', 'o', 'c', 'a', 'l',
+      0x00,
+      0x00, 0x0c,              // TYPE = PTR (12)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x00,              // RDLENGTH = 0
+      // NOTE: Only 1 additional record is given.
+  };
+  // clang-format on
+
+  Config config;
+  MdnsReader reader(config, kInvalidMessage, sizeof(kInvalidMessage));
+  const ErrorOr<MdnsMessageView> view = reader.ReadView();
+  ASSERT_TRUE(view.is_error());
+  EXPECT_EQ(view.error().code(), Error::Code::kMdnsReadFailure);
+  EXPECT_EQ(reader.offset(), UINT64_C(0));
+}
+
+TEST(MdnsMessageViewTest, FailsOnNonConformingFlags) {
+  // clang-format off
+  constexpr uint8_t kMessage[] = {
+      0x00, 0x00,  // ID = 0
+      0x84, 0x03,  // FLAGS = AA | RESPONSE | RCODE = NXDOMAIN
+      0x00, 0x00,  // Questions = 0
+      0x00, 0x00,  // Answers = 0
+      0x00, 0x00,  // Authority = 0
+      0x00, 0x00,  // Additional = 0
+  };
+  // clang-format on
+
+  Config config;
+  MdnsReader reader(config, kMessage, sizeof(kMessage));
+  const ErrorOr<MdnsMessageView> view = reader.ReadView();
+  ASSERT_TRUE(view.is_error());
+  EXPECT_EQ(view.error().code(), Error::Code::kMdnsNonConformingFailure);
+}
+
+}  // namespace openscreen::discovery
@@ -5,6 +5,7 @@
 #include "discovery/mdns/public/mdns_reader.h"
 
 #include <algorithm>
+#include <limits>
 #include <string_view>
 #include <utility>
 
@@ -16,6 +17,9 @@
 namespace openscreen::discovery {
 namespace {
 
+constexpr size_t kMaxMessageFieldEntryCount =
+    std::numeric_limits<uint16_t>::max();
+
 bool TryParseDnsType(uint16_t to_parse, DnsType* type) {
   auto it = std::find(kSupportedDnsTypes.begin(), kSupportedDnsTypes.end(),
                       static_cast<DnsType>(to_parse));
@@ -41,6 +45,12 @@ MdnsReader::MdnsReader(const Config& config,
   OSP_CHECK_GT(config.maximum_valid_rdata_size, 0);
 }
 
+MdnsReader::MdnsReader(size_t maximum_allowed_rdata_size,
+                       const uint8_t* buffer,
+                       size_t length)
+    : BigEndianReader(buffer, length),
+      kMaximumAllowedRdataSize(maximum_allowed_rdata_size) {}
+
 bool MdnsReader::Read(TxtRecordRdata::Entry* out) {
   Cursor cursor(this);
   uint8_t entry_length;
@@ -57,10 +67,26 @@ bool MdnsReader::Read(TxtRecordRdata::Entry* out) {
   return true;
 }
 
-// RFC 1035: https://www.ietf.org/rfc/rfc1035.txt
-// See section 4.1.4. Message compression.
 bool MdnsReader::Read(DomainName* out) {
   OSP_CHECK(out);
+  Cursor cursor(this);
+  if (!ReadLabels()) {
+    return false;
+  }
+  ErrorOr<DomainName> domain =
+      DomainName::TryCreate(labels_.begin(), labels_.end());
+  if (domain.is_error()) {
+    return false;
+  }
+  *out = std::move(domain.value());
+  cursor.Commit();
+  return true;
+}
+
+// RFC 1035: https://www.ietf.org/rfc/rfc1035.txt
+// See section 4.1.4. Message compression.
+bool MdnsReader::ReadLabels() {
+  labels_.clear();
   const uint8_t* position = current();
   // The number of bytes consumed reading from the starting position to either
   // the first label pointer or the final termination byte, including the
@@ -73,7 +99,6 @@ bool MdnsReader::Read(DomainName* out) {
   // greater than the length of the buffer.
   size_t bytes_processed = 0;
   size_t domain_name_length = 0;
-  std::vector<std::string_view> labels;
   // If we are pointing before the beginning or past the end of the buffer, we
   // hit a malformed pointer. If we have processed more bytes than there are in
   // the buffer, we are in a circular compression loop.
@@ -81,12 +106,6 @@ bool MdnsReader::Read(DomainName* out) {
          bytes_processed <= length()) {
     const uint8_t label_type = ReadBigEndian<uint8_t>(position);
     if (IsTerminationLabel(label_type)) {
-      ErrorOr<DomainName> domain =
-          DomainName::TryCreate(labels.begin(), labels.end());
-      if (domain.is_error()) {
-        return false;
-      }
-      *out = std::move(domain.value());
       if (!bytes_consumed) {
         bytes_consumed = position + sizeof(uint8_t) - current();
       }
@@ -117,7 +136,7 @@ bool MdnsReader::Read(DomainName* out) {
           domain_name_length > kMaxDomainNameLength) {
         return false;
       }
-      labels.push_back(label);
+      labels_.push_back(label);
       bytes_processed += label_length;
       position += label_length;
     } else {
@@ -358,6 +377,94 @@ ErrorOr<MdnsMessage> MdnsReader::Read() {
   return Error::Code::kMdnsReadFailure;
 }
 
+ErrorOr<MdnsMessageView> MdnsReader::ReadView() {
+  Cursor cursor(this);
+  Header header;
+  std::vector<MdnsMessageView::Entry> questions;
+  std::vector<MdnsMessageView::Entry> answers;
+  std::vector<MdnsMessageView::Entry> authority_records;
+  std::vector<MdnsMessageView::Entry> additional_records;
+  if (Read(&header) &&
+      ReadEntries(header.question_count, /* are_questions= */ true,
+                  &questions) &&
+      ReadEntries(header.answer_count, /* are_questions= */ false, &answers) &&
+      ReadEntries(header.authority_record_count, /* are_questions= */ false,
+                  &authority_records) &&
+      ReadEntries(header.additional_record_count, /* are_questions= */ false,
+                  &additional_records)) {
+    if (!IsValidFlagsSection(header.flags)) {
+      return Error::Code::kMdnsNonConformingFailure;
+    }
+
+    // Matches the limits enforced by MdnsMessage::TryCreate().
+    if (questions.size() >= kMaxMessageFieldEntryCount ||
+        answers.size() >= kMaxMessageFieldEntryCount ||
+        authority_records.size() >= kMaxMessageFieldEntryCount ||
+        additional_records.size() >= kMaxMessageFieldEntryCount) {
+      return Error::Code::kParameterInvalid;
+    }
+
+    cursor.Commit();
+    return MdnsMessageView(kMaximumAllowedRdataSize, buffer(), header.id,
+                           GetMessageType(header.flags),
+                           IsMessageTruncated(header.flags),
+                           std::move(questions), std::move(answers),
+                           std::move(authority_records),
+                           std::move(additional_records));
+  }
+  return Error::Code::kMdnsReadFailure;
+}
+
+bool MdnsReader::ReadQuestionEntry(MdnsMessageView::Entry* out) {
+  OSP_CHECK(out);
+  Cursor cursor(this);
+  const size_t offset = this->offset();
+  uint16_t type;
+  uint16_t rrclass;
+  if (ReadLabels() && !labels_.empty() && Read(&type) && Read(&rrclass)) {
+    *out = MdnsMessageView::Entry{offset, DomainName::ComputeHash(labels_),
+                                  static_cast<DnsType>(type),
+                                  GetDnsClass(rrclass)};
+    cursor.Commit();
+    return true;
+  }
+  return false;
+}
+
+bool MdnsReader::ReadRecordEntry(MdnsMessageView::Entry* out) {
+  OSP_CHECK(out);
+  Cursor cursor(this);
+  const size_t offset = this->offset();
+  uint16_t type;
+  uint16_t rrclass;
+  uint32_t ttl;
+  uint16_t record_length;
+  if (ReadLabels() && Read(&type) && Read(&rrclass) && Read(&ttl) &&
+      Read(&record_length) && Skip(record_length)) {
+    *out = MdnsMessageView::Entry{offset, DomainName::ComputeHash(labels_),
+                                  static_cast<DnsType>(type),
+                                  GetDnsClass(rrclass)};
+    cursor.Commit();
+    return true;
+  }
+  return false;
+}
+
+bool MdnsReader::ReadEntries(uint16_t count,
+                             bool are_questions,
+                             std::vector<MdnsMessageView::Entry>* out) {
+  Cursor cursor(this);
+  out->resize(count);
+  for (MdnsMessageView::Entry& entry : *out) {
+    if (!(are_questions ? ReadQuestionEntry(&entry)
+                        : ReadRecordEntry(&entry))) {
+      return false;
+    }
+  }
+  cursor.Commit();
+  return true;
+}
+
 bool MdnsReader::Read(IPAddress::Version version, IPAddress* out) {
   OSP_CHECK(out);
   size_t ipaddress_size = (version == IPAddress::Version::kV6)
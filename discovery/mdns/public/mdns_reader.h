@@ -5,9 +5,11 @@
 #ifndef DISCOVERY_MDNS_PUBLIC_MDNS_READER_H_
 #define DISCOVERY_MDNS_PUBLIC_MDNS_READER_H_
 
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "discovery/mdns/public/mdns_message_view.h"
 #include "discovery/mdns/public/mdns_records.h"
 #include "platform/base/error.h"
 #include "util/big_endian.h"
@@ -46,7 +48,18 @@ class MdnsReader : public BigEndianReader {
   // a mDNS message being read.
   ErrorOr<MdnsMessage> Read();
 
+  // Indexes the questions and records of the mDNS message being read, reading
+  // only their fixed-size fields and the hashes of their domain names. The
+  // returned view refers to the buffer being read.
+  ErrorOr<MdnsMessageView> ReadView();
+
  private:
+  friend class MdnsMessageView;
+
+  MdnsReader(size_t maximum_allowed_rdata_size,
+             const uint8_t* buffer,
+             size_t length);
+
   struct NsecBitMapField {
     uint8_t window_block;
     uint8_t bitmap_length;
@@ -59,6 +72,18 @@ class MdnsReader : public BigEndianReader {
   bool Read(std::vector<DnsType>* types, int remaining_length);
   bool Read(NsecBitMapField* out);
 
+  // Reads the labels of a domain name into `labels_`, which is reused across
+  // reads to avoid allocating for each domain name.
+  bool ReadLabels();
+
+  // Read the location, name hash, type and class of a question or record,
+  // skipping over its RDATA.
+  bool ReadQuestionEntry(MdnsMessageView::Entry* out);
+  bool ReadRecordEntry(MdnsMessageView::Entry* out);
+  bool ReadEntries(uint16_t count,
+                   bool are_questions,
+                   std::vector<MdnsMessageView::Entry>* out);
+
   template <class ItemType>
   bool Read(uint16_t count, std::vector<ItemType>* out) {
     Cursor cursor(this);
@@ -86,6 +111,8 @@ class MdnsReader : public BigEndianReader {
 
   // Maximum allowed size for the rdata in any received record.
   const size_t kMaximumAllowedRdataSize;
+
+  std::vector<std::string_view> labels_;
 };
 
 }  // namespace openscreen::discovery
@@ -7,8 +7,15 @@
 
 namespace openscreen::discovery {
 void Fuzz(const uint8_t* data, size_t size) {
-  MdnsReader reader(Config{}, data, size);
+  const Config config;
+  MdnsReader reader(config, data, size);
   reader.Read();
+
+  MdnsReader view_reader(config, data, size);
+  const ErrorOr<MdnsMessageView> view = view_reader.ReadView();
+  if (view.is_value()) {
+    view.value().ReadMessage();
+  }
 }
 }  // namespace openscreen::discovery
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
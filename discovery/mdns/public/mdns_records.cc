@@ -7,12 +7,20 @@
 #include <algorithm>
 #include <cctype>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <ostream>
+#include <span>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 #include "discovery/mdns/public/mdns_writer.h"
+#include "util/hashing.h"
+#include "util/no_destructor.h"
 #include "util/string_util.h"
 
 namespace openscreen::discovery {
@@ -41,6 +49,46 @@ inline int CompareIgnoreCase(const std::string& x, const std::string& y) {
   return i == y.size() ? 0 : -1;
 }
 
+char ToLower(char c) {
+  return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+// Returns the 64-bit FNV-1a hash of the lowercased characters of `label`.
+uint64_t HashLabelIgnoringCase(std::string_view label) {
+  constexpr uint64_t kFnvOffsetBasis = UINT64_C(0xcbf29ce484222325);
+  constexpr uint64_t kFnvPrime = UINT64_C(0x100000001b3);
+  uint64_t hash = kFnvOffsetBasis;
+  for (const char c : label) {
+    hash ^= static_cast<uint8_t>(ToLower(c));
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+// Returns the case-insensitive hashes of each suffix of the domain name with
+// `labels`, combining the label hashes from the last label to the first.
+std::vector<uint64_t> ComputeSuffixHashes(
+    const std::vector<std::string_view>& labels) {
+  std::vector<uint64_t> suffix_hashes(labels.size());
+  uint64_t hash = kDefaultSeed;
+  for (size_t i = labels.size(); i-- > 0;) {
+    hash = CombineHash(hash, HashLabelIgnoringCase(labels[i]));
+    suffix_hashes[i] = hash;
+  }
+  return suffix_hashes;
+}
+
+bool IsLowercase(const std::vector<std::string_view>& labels) {
+  for (std::string_view label : labels) {
+    for (const char c : label) {
+      if (ToLower(c) != c) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 template <typename RDataType>
 bool IsGreaterThan(const Rdata& lhs, const Rdata& rhs) {
   const RDataType& lhs_cast = std::get<RDataType>(lhs);
@@ -98,6 +146,152 @@ bool IsValidDomainLabel(std::string_view label) {
   return label_size > 0 && label_size <= kMaxLabelLength;
 }
 
+// Interns the representations of domain names. Its entries do not keep the
+// representations alive: each is removed when the last DomainName using it is
+// destroyed.
+class DomainName::InternTable {
+ public:
+  static InternTable& Get() {
+    static NoDestructor<InternTable> table;
+    return *table;
+  }
+
+  // Returns the interned representation of the domain name with `labels`,
+  // which must be valid and non-empty, creating it if needed.
+  std::shared_ptr<const Rep> Intern(const std::vector<std::string_view>& labels,
+                                    size_t max_wire_size);
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  // Returns the bytes held by the table and its representations, from the
+  // capacities of their containers. Allocator and std::shared_ptr bookkeeping
+  // is not counted.
+  size_t GetMemoryUsage() {
+    static const size_t kInlineStringCapacity = std::string().capacity();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Each node of the table holds a link and an entry.
+    const size_t node_size =
+        sizeof(void*) + sizeof(decltype(entries_)::value_type);
+    size_t bytes = entries_.bucket_count() * sizeof(void*) +
+                   entries_.size() * node_size;
+    for (const auto& [hash, entry] : entries_) {
+      const Rep& rep = *entry.rep;
+      bytes += sizeof(Rep) + rep.labels.capacity() * sizeof(std::string) +
+               rep.suffix_hashes.capacity() * sizeof(uint64_t);
+      for (const std::string& label : rep.labels) {
+        if (label.capacity() > kInlineStringCapacity) {
+          bytes += label.capacity() + 1;
+        }
+      }
+    }
+    return bytes;
+  }
+
+ private:
+  struct Entry {
+    const Rep* rep;
+    std::weak_ptr<const Rep> weak_rep;
+  };
+
+  // Returns the live representation with exactly `labels`, if any. Must be
+  // called with `mutex_` held.
+  std::shared_ptr<const Rep> FindLocked(
+      const std::vector<std::string_view>& labels,
+      uint64_t hash);
+
+  // Called when the last DomainName using `rep` is destroyed.
+  void Remove(const Rep* rep);
+
+  std::mutex mutex_;
+
+  // Keyed by DomainName::Hash(), so that all the spellings of a name share a
+  // key.
+  std::unordered_multimap<uint64_t, Entry> entries_;
+};
+
+std::shared_ptr<const DomainName::Rep> DomainName::InternTable::Intern(
+    const std::vector<std::string_view>& labels,
+    size_t max_wire_size) {
+  // Most names are already interned, so only the hash of the whole name is
+  // computed until the lookup has missed.
+  const uint64_t hash = DomainName::ComputeHash(labels);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<const Rep> rep = FindLocked(labels, hash);
+    if (rep) {
+      return rep;
+    }
+  }
+
+  auto new_rep = std::make_unique<Rep>();
+  new_rep->labels.assign(labels.begin(), labels.end());
+  new_rep->max_wire_size = max_wire_size;
+  new_rep->suffix_hashes = ComputeSuffixHashes(labels);
+  if (!IsLowercase(labels)) {
+    std::vector<std::string> lowercase_labels = new_rep->labels;
+    for (std::string& label : lowercase_labels) {
+      for (char& c : label) {
+        c = ToLower(c);
+      }
+    }
+    new_rep->lowercase = Intern(std::vector<std::string_view>(
+                                    lowercase_labels.begin(),
+                                    lowercase_labels.end()),
+                                max_wire_size);
+  }
+  std::shared_ptr<const Rep> rep(
+      new_rep.release(), [this](const Rep* rep) { Remove(rep); });
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Another thread may have interned the same name in the meantime. If so,
+  // `rep` is discarded once `lock` has been released.
+  std::shared_ptr<const Rep> existing_rep = FindLocked(labels, hash);
+  if (existing_rep) {
+    return existing_rep;
+  }
+  entries_.emplace(hash, Entry{rep.get(), rep});
+  return rep;
+}
+
+std::shared_ptr<const DomainName::Rep> DomainName::InternTable::FindLocked(
+    const std::vector<std::string_view>& labels,
+    uint64_t hash) {
+  const auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const std::vector<std::string>& rep_labels = it->second.rep->labels;
+    if (!std::equal(rep_labels.begin(), rep_labels.end(), labels.begin(),
+                    labels.end())) {
+      continue;
+    }
+    // A representation that is being destroyed may not have been removed yet,
+    // in which case a live one with the same labels may follow it.
+    std::shared_ptr<const Rep> rep = it->second.weak_rep.lock();
+    if (rep) {
+      return rep;
+    }
+  }
+  return nullptr;
+}
+
+void DomainName::InternTable::Remove(const Rep* rep) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto range = entries_.equal_range(rep->suffix_hashes[0]);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.rep == rep) {
+        entries_.erase(it);
+        break;
+      }
+    }
+  }
+  // Deleting `rep` may release its lowercase form, which removes itself in
+  // turn, so the lock must not be held.
+  delete rep;
+}
+
 DomainName::DomainName() = default;
 
 DomainName::DomainName(std::vector<std::string> labels)
@@ -109,24 +303,36 @@ DomainName::DomainName(const std::vector<std::string_view>& labels)
 DomainName::DomainName(std::initializer_list<std::string_view> labels)
     : DomainName(labels.begin(), labels.end()) {}
 
-DomainName::DomainName(std::vector<std::string> labels, size_t max_wire_size)
-    : max_wire_size_(max_wire_size), labels_(std::move(labels)) {}
+DomainName::DomainName(const std::vector<std::string_view>& labels,
+                       size_t max_wire_size) {
+  if (!labels.empty()) {
+    rep_ = InternTable::Get().Intern(labels, max_wire_size);
+  }
+}
 
 DomainName::DomainName(const DomainName& other) = default;
 
 DomainName::DomainName(DomainName&& other) noexcept = default;
 
+DomainName::~DomainName() = default;
+
 DomainName& DomainName::operator=(const DomainName& rhs) = default;
 
 DomainName& DomainName::operator=(DomainName&& rhs) = default;
 
 bool DomainName::operator<(const DomainName& rhs) const {
+  if (*this == rhs) {
+    return false;
+  }
+
+  const std::vector<std::string>& lhs_labels = labels();
+  const std::vector<std::string>& rhs_labels = rhs.labels();
   size_t i = 0;
-  for (; i < labels_.size(); i++) {
-    if (i == rhs.labels_.size()) {
+  for (; i < lhs_labels.size(); i++) {
+    if (i == rhs_labels.size()) {
       return false;
     } else {
-      int result = CompareIgnoreCase(labels_[i], rhs.labels_[i]);
+      int result = CompareIgnoreCase(lhs_labels[i], rhs_labels[i]);
       if (result < 0) {
         return true;
       } else if (result > 0) {
@@ -134,7 +340,7 @@ bool DomainName::operator<(const DomainName& rhs) const {
       }
     }
   }
-  return i < rhs.labels_.size();
+  return i < rhs_labels.size();
 }
 
 bool DomainName::operator<=(const DomainName& rhs) const {
@@ -150,28 +356,57 @@ bool DomainName::operator>=(const DomainName& rhs) const {
 }
 
 bool DomainName::operator==(const DomainName& rhs) const {
-  if (labels_.size() != rhs.labels_.size()) {
-    return false;
-  }
-  for (size_t i = 0; i < labels_.size(); i++) {
-    if (CompareIgnoreCase(labels_[i], rhs.labels_[i]) != 0) {
-      return false;
-    }
+  if (!rep_ || !rhs.rep_) {
+    return rep_ == rhs.rep_;
   }
-  return true;
+  return rep_->GetLowercase() == rhs.rep_->GetLowercase();
 }
 
 bool DomainName::operator!=(const DomainName& rhs) const {
   return !(*this == rhs);
 }
 
+uint64_t DomainName::Hash() const {
+  return rep_ ? rep_->suffix_hashes[0] : kDefaultSeed;
+}
+
+// static
+uint64_t DomainName::ComputeHash(std::span<const std::string_view> labels) {
+  uint64_t hash = kDefaultSeed;
+  for (size_t i = labels.size(); i-- > 0;) {
+    hash = CombineHash(hash, HashLabelIgnoringCase(labels[i]));
+  }
+  return hash;
+}
+
+const std::vector<uint64_t>& DomainName::SuffixHashes() const {
+  static const NoDestructor<std::vector<uint64_t>> kNoSuffixHashes;
+  return rep_ ? rep_->suffix_hashes : *kNoSuffixHashes;
+}
+
 size_t DomainName::MaxWireSize() const {
-  return max_wire_size_;
+  // The root domain name is only the terminating character.
+  return rep_ ? rep_->max_wire_size : 1;
+}
+
+const std::vector<std::string>& DomainName::labels() const {
+  static const NoDestructor<std::vector<std::string>> kNoLabels;
+  return rep_ ? rep_->labels : *kNoLabels;
+}
+
+// static
+size_t DomainName::GetInternedCountForTesting() {
+  return InternTable::Get().size();
+}
+
+// static
+size_t DomainName::GetInternedBytesForTesting() {
+  return InternTable::Get().GetMemoryUsage();
 }
 
 std::ostream& operator<<(std::ostream& os, const DomainName& domain_name) {
-  return os << string_util::Join(domain_name.labels_.cbegin(),
-                                 domain_name.labels_.cend(), ".");
+  const std::vector<std::string>& labels = domain_name.labels();
+  return os << string_util::Join(labels.cbegin(), labels.cend(), ".");
 }
 
 // static
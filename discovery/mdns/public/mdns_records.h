@@ -9,7 +9,9 @@
 #include <chrono>
 #include <functional>
 #include <initializer_list>
+#include <memory>
 #include <ostream>
+#include <span>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -30,28 +32,35 @@ bool IsValidDomainLabel(std::string_view label);
 
 // Represents domain name as a collection of labels, ensures label length and
 // domain name length requirements are met.
+//
+// Domain names are interned: all DomainNames with the same labels share one
+// immutable representation, which also caches the name's hash and wire size,
+// so copies are cheap. Since domain names compare case-insensitively, each
+// representation also refers to the interned lowercase form of the name, which
+// makes comparing two DomainNames for equality O(1).
 class DomainName {
  public:
   DomainName();
 
   template <typename IteratorType>
   static ErrorOr<DomainName> TryCreate(IteratorType first, IteratorType last) {
-    std::vector<std::string> labels;
+    std::vector<std::string_view> labels;
     size_t max_wire_size = 1;
     labels.reserve(std::distance(first, last));
     for (IteratorType entry = first; entry != last; ++entry) {
-      if (!IsValidDomainLabel(*entry)) {
+      const std::string_view label(*entry);
+      if (!IsValidDomainLabel(label)) {
         return Error::Code::kParameterInvalid;
       }
-      labels.emplace_back(*entry);
+      labels.push_back(label);
       // Include the length byte in the size calculation.
-      max_wire_size += entry->size() + 1;
+      max_wire_size += label.size() + 1;
     }
 
     if (max_wire_size > kMaxDomainNameLength) {
       return Error::Code::kIndexOutOfBounds;
     } else {
-      return DomainName(std::move(labels), max_wire_size);
+      return DomainName(labels, max_wire_size);
     }
   }
 
@@ -65,6 +74,7 @@ class DomainName {
   explicit DomainName(std::initializer_list<std::string_view> labels);
   DomainName(const DomainName& other);
   DomainName(DomainName&& other) noexcept;
+  ~DomainName();
 
   DomainName& operator=(const DomainName& rhs);
   DomainName& operator=(DomainName&& rhs);
@@ -75,21 +85,57 @@ class DomainName {
   bool operator==(const DomainName& rhs) const;
   bool operator!=(const DomainName& rhs) const;
 
+  // Returns a hash of the domain name which, like the comparison operators
+  // above, ignores the case of its labels.
+  uint64_t Hash() const;
+
+  // Returns the Hash() of the domain name made of `labels`, without creating
+  // it.
+  static uint64_t ComputeHash(std::span<const std::string_view> labels);
+
+  // Returns the hashes of each of the domain name's suffixes, starting with
+  // the whole name: the i-th element is the Hash() of the name made of the
+  // labels from the i-th onwards.
+  const std::vector<uint64_t>& SuffixHashes() const;
+
   // Returns the maximum space that the domain name could take up in its
   // on-the-wire format. This is an upper bound based on the length of the
   // labels that make up the domain name. It's possible that with domain name
   // compression the actual space taken in on-the-wire format is smaller.
   size_t MaxWireSize() const;
-  bool empty() const { return labels_.empty(); }
-  bool IsRoot() const { return labels_.empty(); }
-  const std::vector<std::string>& labels() const { return labels_; }
+  bool empty() const { return !rep_; }
+  bool IsRoot() const { return !rep_; }
+  const std::vector<std::string>& labels() const;
+
+  // Returns the number of distinct domain names currently interned.
+  static size_t GetInternedCountForTesting();
+
+  // Returns the memory used by the interned domain names, in bytes.
+  static size_t GetInternedBytesForTesting();
 
  private:
-  DomainName(std::vector<std::string> labels, size_t max_wire_size);
+  class InternTable;
+
+  // The shared, immutable representation of a non-root domain name.
+  struct Rep {
+    std::vector<std::string> labels;
+    size_t max_wire_size;
+    std::vector<uint64_t> suffix_hashes;
+
+    // The interned lowercase form of the name, or null if the name is already
+    // lowercase.
+    std::shared_ptr<const Rep> lowercase;
+
+    const Rep* GetLowercase() const {
+      return lowercase ? lowercase.get() : this;
+    }
+  };
+
+  DomainName(const std::vector<std::string_view>& labels,
+             size_t max_wire_size);
 
-  // max_wire_size_ starts at 1 for the terminating character length.
-  size_t max_wire_size_ = 1;
-  std::vector<std::string> labels_;
+  // Null for the root domain name.
+  std::shared_ptr<const Rep> rep_;
 
   friend std::ostream& operator<<(std::ostream& os,
                                   const DomainName& domain_name);
@@ -4,12 +4,15 @@
 
 #include "discovery/mdns/public/mdns_records.h"
 
+#include <chrono>
 #include <limits>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
+#include "discovery/common/config.h"
 #include "discovery/mdns/public/mdns_reader.h"
 #include "discovery/mdns/public/mdns_writer.h"
 #include "discovery/mdns/testing/mdns_test_util.h"
@@ -117,6 +120,67 @@ TEST(MdnsDomainNameTest, CopyAndMove) {
   TestCopyAndMove(DomainName{"testing", "local"});
 }
 
+TEST(MdnsDomainNameTest, Intern) {
+  const size_t initial_count = DomainName::GetInternedCountForTesting();
+  {
+    DomainName first({"testing", "local"});
+    DomainName second({"testing", "local"});
+    EXPECT_EQ(DomainName::GetInternedCountForTesting(), initial_count + 1);
+    EXPECT_EQ(&first.labels(), &second.labels());
+
+    // A mixed-case name keeps its spelling, and also interns its lowercase
+    // form, which it shares with `first`.
+    DomainName third({"TeStInG", "LOCAL"});
+    EXPECT_EQ(DomainName::GetInternedCountForTesting(), initial_count + 2);
+    EXPECT_EQ(third.labels()[0], "TeStInG");
+    EXPECT_EQ(first, third);
+    EXPECT_EQ(first.Hash(), third.Hash());
+    EXPECT_EQ(first.MaxWireSize(), third.MaxWireSize());
+
+    DomainName copy = third;
+    EXPECT_EQ(&copy.labels(), &third.labels());
+    EXPECT_EQ(DomainName::GetInternedCountForTesting(), initial_count + 2);
+
+    // Each suffix hash is the hash of the corresponding suffix of the name.
+    ASSERT_EQ(third.SuffixHashes().size(), size_t{2});
+    EXPECT_EQ(third.SuffixHashes()[0], third.Hash());
+    EXPECT_EQ(third.SuffixHashes()[1], DomainName{"local"}.Hash());
+    EXPECT_TRUE(DomainName().SuffixHashes().empty());
+  }
+
+  // The names are no longer interned once no DomainName uses them.
+  EXPECT_EQ(DomainName::GetInternedCountForTesting(), initial_count);
+}
+
+// Tests that the names of parsed records refer to the interned names.
+TEST(MdnsDomainNameTest, ParsedNamesAreInterned) {
+  const DomainName instance{"Device", "_googlecast", "_tcp", "local"};
+  const DomainName host{"host", "local"};
+  MdnsMessage message(0, MessageType::Response);
+  message.AddAnswer(MdnsRecord(instance, DnsType::kSRV, DnsClass::kIN,
+                               RecordType::kUnique, kTtl,
+                               SrvRecordRdata(0, 0, 8009, host)));
+  message.AddAnswer(MdnsRecord(host, DnsType::kA, DnsClass::kIN,
+                               RecordType::kUnique, kTtl,
+                               ARecordRdata(IPAddress{192, 168, 0, 1})));
+  std::vector<uint8_t> buffer(message.MaxWireSize());
+  MdnsWriter writer(buffer.data(), buffer.size());
+  ASSERT_TRUE(writer.Write(message));
+
+  const size_t initial_count = DomainName::GetInternedCountForTesting();
+  MdnsReader reader(Config{}, buffer.data(), writer.offset());
+  ErrorOr<MdnsMessage> parsed = reader.Read();
+  ASSERT_TRUE(parsed.is_value());
+  ASSERT_EQ(parsed.value().answers().size(), size_t{2});
+  const MdnsRecord& srv = parsed.value().answers()[0];
+  const MdnsRecord& a = parsed.value().answers()[1];
+  EXPECT_EQ(&srv.name().labels(), &instance.labels());
+  EXPECT_EQ(&std::get<SrvRecordRdata>(srv.rdata()).target().labels(),
+            &host.labels());
+  EXPECT_EQ(&a.name().labels(), &host.labels());
+  EXPECT_EQ(DomainName::GetInternedCountForTesting(), initial_count);
+}
+
 TEST(MdnsRawRecordRdataTest, Construct) {
   constexpr uint8_t kRawRdata[] = {
       0x05, 'c', 'n', 'a', 'm', 'e', 0xc0, 0x00,
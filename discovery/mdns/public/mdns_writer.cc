@@ -10,26 +10,12 @@
 #include <variant>
 #include <vector>
 
-#include "util/hashing.h"
 #include "util/osp_logging.h"
-#include "util/string_util.h"
 
 namespace openscreen::discovery {
 
 namespace {
 
-std::vector<uint64_t> ComputeDomainNameSubhashes(const DomainName& name) {
-  const std::vector<std::string>& labels = name.labels();
-  uint64_t hash_value = kDefaultSeed;
-  std::vector<uint64_t> subhashes(labels.size());
-  for (size_t i = labels.size(); i-- > 0;) {
-    hash_value = ComputeAggregateHash(hash_value,
-                                      string_util::AsciiStrToLower(labels[i]));
-    subhashes[i] = hash_value;
-  }
-  return subhashes;
-}
-
 // This helper method writes the number of bytes between `begin` and `end` minus
 // the size of the uint16_t into the uint16_t length field at `begin`. The
 // method returns true if the number of bytes between `begin` and `end` fits in
@@ -67,7 +53,9 @@ bool MdnsWriter::Write(const DomainName& name) {
   }
 
   Cursor cursor(this);
-  const std::vector<uint64_t> subhashes = ComputeDomainNameSubhashes(name);
+  // The interned name caches the hashes of its suffixes, which are the keys of
+  // the compression dictionary.
+  const std::vector<uint64_t>& subhashes = name.SuffixHashes();
   // Tentative dictionary contains label pointer entries to be added to the
   // compression dictionary after successfully writing the domain name.
   std::unordered_map<uint64_t, uint16_t> tentative_dictionary;
@@ -5,10 +5,12 @@
 #ifndef PLATFORM_API_TASK_RUNNER_H_
 #define PLATFORM_API_TASK_RUNNER_H_
 
-#include <future>
+#include <stdint.h>
+
 #include <utility>
 
 #include "platform/api/time.h"
+#include "platform/base/inline_task.h"
 
 namespace openscreen {
 
@@ -22,7 +24,13 @@ namespace openscreen {
 //     B runs (even if A and B run on different threads).
 class TaskRunner {
  public:
-  using Task = std::packaged_task<void()>;
+  // Tasks only allocate if the callable is larger than
+  // InlineTask::kInlineCapacity.
+  using Task = InlineTask;
+
+  // Identifies a delayed task posted by PostCancelableTaskWithDelay(), so that
+  // it can be canceled. Zero identifies no task.
+  using DelayedTaskId = uint64_t;
 
   virtual ~TaskRunner() = default;
 
@@ -42,12 +50,35 @@ class TaskRunner {
     PostPackagedTaskWithDelay(Task(std::move(f)), delay);
   }
 
+  // Same as PostTaskWithDelay(), but returns an id that CancelDelayedTask()
+  // takes to remove the task from the queue before it runs.
+  template <typename Functor>
+  inline DelayedTaskId PostCancelableTaskWithDelay(Functor f,
+                                                   Clock::duration delay) {
+    return PostCancelablePackagedTaskWithDelay(Task(std::move(f)), delay);
+  }
+
   // Implementations should provide the behavior explained in the comments above
   // for PostTask[WithDelay](). Client code may also call these directly when
   // passing an existing Task object.
   virtual void PostPackagedTask(Task task) = 0;
   virtual void PostPackagedTaskWithDelay(Task task, Clock::duration delay) = 0;
 
+  // Implementations that can cancel delayed tasks override both of these. By
+  // default, tasks cannot be canceled: the id is zero, and the task runs as if
+  // posted by PostPackagedTaskWithDelay().
+  virtual DelayedTaskId PostCancelablePackagedTaskWithDelay(
+      Task task,
+      Clock::duration delay) {
+    PostPackagedTaskWithDelay(std::move(task), delay);
+    return 0;
+  }
+
+  // Destroys the delayed task identified by `id` without running it. Returns
+  // false if the task cannot be canceled, such as when it has already run or
+  // is about to run, in which case nothing is done.
+  virtual bool CancelDelayedTask(DelayedTaskId id) { return false; }
+
   // Return true if the calling thread is the thread that task runner is using
   // to run tasks, false otherwise.
   virtual bool IsRunningOnTaskRunner() = 0;
@@ -4,6 +4,8 @@
 
 #include "platform/api/udp_socket.h"
 
+#include <utility>
+
 namespace openscreen {
 
 UdpSocket::UdpSocket() = default;
@@ -11,4 +13,28 @@ UdpSocket::~UdpSocket() = default;
 
 UdpSocket::Client::~Client() = default;
 
+void UdpSocket::Client::OnReadBatch(UdpSocket* socket,
+                                    std::vector<UdpPacket> packets) {
+  for (UdpPacket& packet : packets) {
+    OnRead(socket, std::move(packet));
+  }
+}
+
+void UdpSocket::SendMessages(std::span<const ByteView> messages,
+                             const IPEndpoint& dest) {
+  for (const ByteView& message : messages) {
+    SendMessage(message, dest);
+  }
+}
+
+void UdpSocket::SendGatheredMessages(std::span<const GatheredMessage> messages,
+                                     const IPEndpoint& dest) {
+  std::vector<uint8_t> buffer;
+  for (const GatheredMessage& message : messages) {
+    buffer.assign(message.header.begin(), message.header.end());
+    buffer.insert(buffer.end(), message.payload.begin(), message.payload.end());
+    SendMessage(buffer, dest);
+  }
+}
+
 }  // namespace openscreen
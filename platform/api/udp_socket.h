@@ -9,12 +9,14 @@
 #include <stdint.h>  // uint8_t
 
 #include <memory>
+#include <vector>
 
 #include "platform/api/network_interface.h"
 #include "platform/base/error.h"
 #include "platform/base/ip_address.h"
 #include "platform/base/span.h"
 #include "platform/base/udp_packet.h"
+#include "platform/base/udp_packet_pool.h"
 
 namespace openscreen {
 
@@ -43,12 +45,19 @@ class UdpSocket {
     //   UdpSocket::SetDscp(...)
     virtual void OnError(UdpSocket* socket, const Error& error) = 0;
 
-    // Method called when an error occurs during a SendMessage call.
+    // Method called when an error occurs during a SendMessage, SendMessages or
+    // SendGatheredMessages call.
     virtual void OnSendError(UdpSocket* socket, const Error& error) = 0;
 
     // Method called when a packet is read.
     virtual void OnRead(UdpSocket* socket, ErrorOr<UdpPacket> packet) = 0;
 
+    // Method called when several packets were read at once, which only happens
+    // if batched reads were enabled with SetReceiveBatchSize(). `packets` are
+    // in the order they were received. The default implementation calls
+    // OnRead() for each packet.
+    virtual void OnReadBatch(UdpSocket* socket, std::vector<UdpPacket> packets);
+
    protected:
     virtual ~Client();
   };
@@ -128,6 +137,31 @@ class UdpSocket {
   // block, which can be expected during normal operation.
   virtual void SendMessage(ByteView data, const IPEndpoint& dest) = 0;
 
+  // Sends several messages to `dest`, in order. Implementations may override
+  // this to reduce the per-message system call overhead. Failures are reported
+  // just like for SendMessage(), except that the messages following a failed
+  // one may be dropped. The default implementation calls SendMessage() for
+  // each message.
+  virtual void SendMessages(std::span<const ByteView> messages,
+                            const IPEndpoint& dest);
+
+  // A message whose bytes are not contiguous in memory: a `header` followed by
+  // a `payload`. Either may be empty.
+  struct GatheredMessage {
+    ByteView header;
+    ByteView payload;
+
+    size_t size() const { return header.size() + payload.size(); }
+  };
+
+  // Like SendMessages(), but each message is sent as the concatenation of its
+  // parts. Implementations should override this to gather the parts in the
+  // system call, so that large payloads need not be copied to prepend a
+  // header. The default implementation copies each message into a temporary
+  // buffer and calls SendMessage().
+  virtual void SendGatheredMessages(std::span<const GatheredMessage> messages,
+                                    const IPEndpoint& dest);
+
   // Sets the DSCP value to use for all messages sent from this socket.
   virtual void SetDscp(DscpMode mode) = 0;
 
@@ -142,6 +176,20 @@ class UdpSocket {
   virtual void SetReceiveBufferSize(size_t size) {}
   virtual void SetSendBufferSize(size_t size) {}
 
+  // Optional: Sets the maximum number of packets that may be read from the
+  // socket each time it becomes readable. Values greater than one allow the
+  // implementation to drain several queued packets with a single system call
+  // and hand them to Client::OnReadBatch() together, which is useful for
+  // high-rate streams. Implementations may ignore this if not supported by the
+  // underlying platform.
+  virtual void SetReceiveBatchSize(size_t max_packets) {}
+
+  // Optional: Sets the pool that received packets are acquired from, so that
+  // their buffers can be reused once the Client is done with them. This must
+  // be called before Bind(). Implementations may ignore this and allocate each
+  // packet separately.
+  virtual void SetPacketPool(std::shared_ptr<UdpPacketPool> pool) {}
+
  protected:
   UdpSocket();
 };
@@ -0,0 +1,27 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/base/inline_task.h"
+
+#include <atomic>
+
+namespace openscreen {
+
+namespace {
+
+std::atomic<uint64_t> g_heap_allocation_count{0};
+
+}  // namespace
+
+// static
+uint64_t InlineTask::GetHeapAllocationCount() {
+  return g_heap_allocation_count.load(std::memory_order_relaxed);
+}
+
+// static
+void InlineTask::OnHeapAllocation() {
+  g_heap_allocation_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace openscreen
@@ -0,0 +1,136 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PLATFORM_BASE_INLINE_TASK_H_
+#define PLATFORM_BASE_INLINE_TASK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace openscreen {
+
+// A move-only, type-erased callable taking no arguments and returning nothing,
+// like a std::packaged_task<void()> without the future.
+//
+// Callables of up to kInlineCapacity bytes, which covers the typical lambda
+// capturing a WeakPtr and a few values, or even a whole UdpPacket, are stored
+// inside the InlineTask itself. Only larger callables are moved to the heap.
+// This keeps posting a task from allocating, so long as the TaskRunner
+// implementation does not allocate either.
+class InlineTask {
+ public:
+  static constexpr size_t kInlineCapacity = 128;
+
+  InlineTask() = default;
+
+  template <typename Functor,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::decay_t<Functor>, InlineTask>>>
+  explicit InlineTask(Functor&& functor) {
+    using StoredType = std::decay_t<Functor>;
+    if constexpr (IsStoredInline<StoredType>()) {
+      new (storage_) StoredType(std::forward<Functor>(functor));
+      operations_ = &kInlineOperations<StoredType>;
+    } else {
+      *reinterpret_cast<StoredType**>(storage_) =
+          new StoredType(std::forward<Functor>(functor));
+      operations_ = &kHeapOperations<StoredType>;
+      OnHeapAllocation();
+    }
+  }
+
+  InlineTask(const InlineTask&) = delete;
+  InlineTask(InlineTask&& other) noexcept { MoveFrom(other); }
+
+  InlineTask& operator=(const InlineTask&) = delete;
+  InlineTask& operator=(InlineTask&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  ~InlineTask() { Reset(); }
+
+  // Returns true if this holds a callable.
+  bool valid() const { return operations_ != nullptr; }
+
+  // Runs the callable. The callable is kept until this InlineTask is destroyed
+  // or assigned over.
+  void operator()() {
+    assert(valid());
+    operations_->invoke(storage_);
+  }
+
+  // Returns true if a callable of type Functor would be stored inline.
+  template <typename Functor>
+  static constexpr bool IsStoredInline() {
+    return sizeof(Functor) <= kInlineCapacity &&
+           alignof(Functor) <= alignof(std::max_align_t);
+  }
+
+  // Returns the number of callables that have been moved to the heap, by all
+  // InlineTasks in the process. Used to verify that hot paths do not allocate.
+  static uint64_t GetHeapAllocationCount();
+
+ private:
+  struct Operations {
+    void (*invoke)(void* storage);
+
+    // Move-constructs the callable in `to` from the one in `from`, and
+    // destroys the latter.
+    void (*relocate)(void* from, void* to);
+
+    void (*destroy)(void* storage);
+  };
+
+  template <typename StoredType>
+  static constexpr Operations kInlineOperations = {
+      [](void* storage) { (*static_cast<StoredType*>(storage))(); },
+      [](void* from, void* to) {
+        StoredType* source = static_cast<StoredType*>(from);
+        new (to) StoredType(std::move(*source));
+        source->~StoredType();
+      },
+      [](void* storage) { static_cast<StoredType*>(storage)->~StoredType(); },
+  };
+
+  template <typename StoredType>
+  static constexpr Operations kHeapOperations = {
+      [](void* storage) { (**static_cast<StoredType**>(storage))(); },
+      [](void* from, void* to) {
+        *static_cast<StoredType**>(to) = *static_cast<StoredType**>(from);
+      },
+      [](void* storage) { delete *static_cast<StoredType**>(storage); },
+  };
+
+  static void OnHeapAllocation();
+
+  void MoveFrom(InlineTask& other) {
+    if (other.operations_) {
+      other.operations_->relocate(other.storage_, storage_);
+      operations_ = std::exchange(other.operations_, nullptr);
+    }
+  }
+
+  void Reset() {
+    if (operations_) {
+      std::exchange(operations_, nullptr)->destroy(storage_);
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineCapacity];
+  const Operations* operations_ = nullptr;
+};
+
+}  // namespace openscreen
+
+#endif  // PLATFORM_BASE_INLINE_TASK_H_
@@ -0,0 +1,127 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/base/inline_task.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace {
+
+// A callable that counts how many live instances of it there are.
+class CountingFunctor {
+ public:
+  CountingFunctor(int* instances, int* runs)
+      : instances_(instances), runs_(runs) {
+    ++*instances_;
+  }
+  CountingFunctor(CountingFunctor&& other) noexcept
+      : instances_(other.instances_), runs_(other.runs_) {
+    ++*instances_;
+  }
+  ~CountingFunctor() { --*instances_; }
+
+  void operator()() { ++*runs_; }
+
+ private:
+  int* instances_;
+  int* runs_;
+};
+
+// Same as CountingFunctor, but too large to be stored inline.
+class LargeCountingFunctor : public CountingFunctor {
+ public:
+  using CountingFunctor::CountingFunctor;
+
+ private:
+  std::array<char, InlineTask::kInlineCapacity> padding_{};
+};
+
+static_assert(InlineTask::IsStoredInline<CountingFunctor>());
+static_assert(!InlineTask::IsStoredInline<LargeCountingFunctor>());
+
+}  // namespace
+
+TEST(InlineTaskTest, RunsSmallCallableWithoutAllocating) {
+  const uint64_t heap_allocations = InlineTask::GetHeapAllocationCount();
+  int value = 0;
+  InlineTask task([&value, increment = 2] { value += increment; });
+  ASSERT_TRUE(task.valid());
+  task();
+  EXPECT_EQ(value, 2);
+  EXPECT_EQ(InlineTask::GetHeapAllocationCount(), heap_allocations);
+}
+
+TEST(InlineTaskTest, DefaultConstructedTaskIsNotValid) {
+  InlineTask task;
+  EXPECT_FALSE(task.valid());
+}
+
+TEST(InlineTaskTest, SupportsMoveOnlyCaptures) {
+  int value = 0;
+  auto captured = std::make_unique<int>(42);
+  InlineTask task([&value, captured = std::move(captured)]() mutable {
+    value = *captured;
+    captured.reset();
+  });
+  task();
+  EXPECT_EQ(value, 42);
+}
+
+TEST(InlineTaskTest, MovesInlineCallable) {
+  int instances = 0;
+  int runs = 0;
+  {
+    InlineTask task(CountingFunctor(&instances, &runs));
+    EXPECT_EQ(instances, 1);
+
+    InlineTask moved_task(std::move(task));
+    EXPECT_FALSE(task.valid());  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(instances, 1);
+
+    task = std::move(moved_task);
+    EXPECT_EQ(instances, 1);
+    task();
+    EXPECT_EQ(runs, 1);
+  }
+  EXPECT_EQ(instances, 0);
+}
+
+TEST(InlineTaskTest, StoresLargeCallableOnHeap) {
+  const uint64_t heap_allocations = InlineTask::GetHeapAllocationCount();
+  int instances = 0;
+  int runs = 0;
+  {
+    InlineTask task(LargeCountingFunctor(&instances, &runs));
+    EXPECT_EQ(InlineTask::GetHeapAllocationCount(), heap_allocations + 1);
+
+    // Moving the task moves the pointer, not the callable.
+    InlineTask moved_task(std::move(task));
+    EXPECT_EQ(instances, 1);
+    moved_task();
+    EXPECT_EQ(runs, 1);
+    EXPECT_EQ(InlineTask::GetHeapAllocationCount(), heap_allocations + 1);
+  }
+  EXPECT_EQ(instances, 0);
+}
+
+TEST(InlineTaskTest, AssigningOverTaskDestroysCallable) {
+  int instances = 0;
+  int runs = 0;
+  InlineTask task(CountingFunctor(&instances, &runs));
+  InlineTask large_task(LargeCountingFunctor(&instances, &runs));
+  EXPECT_EQ(instances, 2);
+
+  task = InlineTask();
+  EXPECT_EQ(instances, 1);
+  large_task = InlineTask();
+  EXPECT_EQ(instances, 0);
+  EXPECT_EQ(runs, 0);
+}
+
+}  // namespace openscreen
@@ -7,6 +7,8 @@
 #include <cassert>
 #include <sstream>
 
+#include "platform/base/udp_packet_pool.h"
+
 namespace openscreen {
 
 UdpPacket::UdpPacket() : std::vector<uint8_t>() {}
@@ -23,8 +25,30 @@ UdpPacket::UdpPacket(std::initializer_list<uint8_t> init)
   assert(size() <= kUdpMaxPacketSize);
 }
 
-UdpPacket::~UdpPacket() = default;
+UdpPacket::UdpPacket(std::vector<uint8_t> buffer,
+                     std::shared_ptr<UdpPacketPool> pool)
+    : std::vector<uint8_t>(std::move(buffer)), pool_(std::move(pool)) {}
+
+UdpPacket::~UdpPacket() {
+  ReleaseToPool();
+}
+
+UdpPacket& UdpPacket::operator=(UdpPacket&& other) {
+  if (this != &other) {
+    ReleaseToPool();
+    std::vector<uint8_t>::operator=(std::move(other));
+    source_ = std::move(other.source_);
+    destination_ = std::move(other.destination_);
+    pool_ = std::move(other.pool_);
+  }
+  return *this;
+}
 
-UdpPacket& UdpPacket::operator=(UdpPacket&& other) = default;
+void UdpPacket::ReleaseToPool() {
+  if (pool_) {
+    pool_->Recycle(std::move(static_cast<std::vector<uint8_t>&>(*this)));
+    pool_.reset();
+  }
+}
 
 }  // namespace openscreen
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,9 +16,16 @@
 
 namespace openscreen {
 
+class UdpPacketPool;
+
 // A move-only std::vector of bytes that may not exceed the maximum possible
 // size of a UDP packet. Implicit copy construction/assignment is disabled to
 // prevent hidden copies (i.e., those not explicitly coded).
+//
+// A packet obtained from a UdpPacketPool returns its buffer to that pool when
+// it is destroyed or assigned over. To benefit from this, consumers should
+// pass the UdpPacket itself along, rather than moving its contents into a
+// plain std::vector.
 class UdpPacket : public std::vector<uint8_t> {
  public:
   // C++14 vector constructors, sans Allocator foo, and no copy ctor.
@@ -42,11 +50,22 @@ class UdpPacket : public std::vector<uint8_t> {
     destination_ = std::move(endpoint);
   }
 
+  // Returns true if this packet's buffer will be returned to a UdpPacketPool.
+  bool is_pooled() const { return !!pool_; }
+
   static constexpr size_type kUdpMaxPacketSize = 1 << 16;
 
  private:
+  friend class UdpPacketPool;
+
+  UdpPacket(std::vector<uint8_t> buffer, std::shared_ptr<UdpPacketPool> pool);
+
+  // Returns the buffer to `pool_`, if any.
+  void ReleaseToPool();
+
   IPEndpoint source_ = {};
   IPEndpoint destination_ = {};
+  std::shared_ptr<UdpPacketPool> pool_;
 };
 
 }  // namespace openscreen
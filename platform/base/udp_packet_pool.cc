@@ -0,0 +1,87 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/base/udp_packet_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace openscreen {
+
+// static
+std::shared_ptr<UdpPacketPool> UdpPacketPool::Create(
+    size_t max_free_buffers,
+    size_t min_buffer_capacity) {
+  return std::shared_ptr<UdpPacketPool>(
+      new UdpPacketPool(max_free_buffers, min_buffer_capacity));
+}
+
+UdpPacketPool::UdpPacketPool(size_t max_free_buffers,
+                             size_t min_buffer_capacity)
+    : max_free_buffers_(max_free_buffers),
+      min_buffer_capacity_(min_buffer_capacity) {
+  assert(min_buffer_capacity_ <= UdpPacket::kUdpMaxPacketSize);
+  free_buffers_.reserve(max_free_buffers_);
+}
+
+UdpPacketPool::~UdpPacketPool() = default;
+
+UdpPacket UdpPacketPool::Acquire(size_t size) {
+  assert(size <= UdpPacket::kUdpMaxPacketSize);
+
+  std::vector<uint8_t> buffer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.packets_acquired;
+    if (!free_buffers_.empty()) {
+      buffer = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+    }
+    if (buffer.capacity() < size) {
+      ++stats_.heap_allocations;
+      stats_.bytes_zero_filled += size;
+    } else if (buffer.size() < size) {
+      stats_.bytes_zero_filled += size - buffer.size();
+    }
+  }
+
+  // Any allocation happens outside of the lock.
+  if (buffer.capacity() < size) {
+    buffer = std::vector<uint8_t>();
+    buffer.reserve(std::max(size, min_buffer_capacity_));
+  }
+  // Only the bytes beyond the recycled buffer's previous contents are
+  // zero-filled.
+  buffer.resize(size);
+  return UdpPacket(std::move(buffer), shared_from_this());
+}
+
+UdpPacketPool::Stats UdpPacketPool::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.free_buffers = free_buffers_.size();
+  return stats;
+}
+
+void UdpPacketPool::Recycle(std::vector<uint8_t> buffer) {
+  // The storage may have been moved out of the packet (e.g., by slicing it into
+  // a plain std::vector), in which case there is nothing to recycle.
+  if (buffer.capacity() == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_buffers_.size() < max_free_buffers_) {
+    // The buffer keeps its size, so that the next Acquire() of up to that many
+    // bytes does not zero-fill them again.
+    free_buffers_.push_back(std::move(buffer));
+    ++stats_.buffers_recycled;
+  } else {
+    // `buffer` is freed after the lock is released.
+    ++stats_.buffers_discarded;
+  }
+}
+
+}  // namespace openscreen
@@ -0,0 +1,93 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PLATFORM_BASE_UDP_PACKET_POOL_H_
+#define PLATFORM_BASE_UDP_PACKET_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "platform/base/udp_packet.h"
+
+namespace openscreen {
+
+// A free list of UdpPacket buffers. A UdpPacket acquired from the pool holds a
+// reference to it, and returns its buffer to the free list when it is
+// destroyed or assigned over, no matter how far downstream it was moved. Once
+// the pool has warmed up, acquiring a packet does not touch the heap.
+//
+// The pool is thread-safe: packets are typically acquired on a network thread
+// and released on the TaskRunner thread.
+class UdpPacketPool : public std::enable_shared_from_this<UdpPacketPool> {
+ public:
+  struct Stats {
+    // Total number of packets handed out by Acquire().
+    uint64_t packets_acquired = 0;
+
+    // Number of Acquire() calls that had to allocate memory, either because
+    // the free list was empty or because the recycled buffer was too small.
+    uint64_t heap_allocations = 0;
+
+    // Number of buffers returned to the free list.
+    uint64_t buffers_recycled = 0;
+
+    // Number of buffers freed instead of recycled, because the free list was
+    // already full.
+    uint64_t buffers_discarded = 0;
+
+    // Number of bytes that Acquire() had to zero-fill, because the packet was
+    // longer than the recycled buffer's previous contents.
+    uint64_t bytes_zero_filled = 0;
+
+    // Number of buffers currently sitting in the free list.
+    size_t free_buffers = 0;
+  };
+
+  // Creates a pool that keeps up to `max_free_buffers` unused buffers around.
+  // Newly-allocated buffers have a capacity of at least `min_buffer_capacity`
+  // bytes, so that they can be reused for any packet up to that size.
+  static std::shared_ptr<UdpPacketPool> Create(size_t max_free_buffers,
+                                               size_t min_buffer_capacity);
+
+  UdpPacketPool(const UdpPacketPool&) = delete;
+  UdpPacketPool& operator=(const UdpPacketPool&) = delete;
+  ~UdpPacketPool();
+
+  // Returns a packet of `size` bytes, reusing a recycled buffer if possible.
+  // The contents of the packet are unspecified: recycled buffers keep the bytes
+  // of the packet they last held, so that only the part of a packet extending
+  // beyond those is zero-filled, rather than the whole packet on every call.
+  UdpPacket Acquire(size_t size);
+
+  Stats GetStats() const;
+
+  size_t min_buffer_capacity() const { return min_buffer_capacity_; }
+
+ private:
+  friend class UdpPacket;
+
+  UdpPacketPool(size_t max_free_buffers, size_t min_buffer_capacity);
+
+  // Called by UdpPacket to return its `buffer` to the free list.
+  void Recycle(std::vector<uint8_t> buffer);
+
+  const size_t max_free_buffers_;
+  const size_t min_buffer_capacity_;
+
+  // Guards all the members below.
+  mutable std::mutex mutex_;
+
+  // Reserved up-front, so that recycling a buffer never allocates.
+  std::vector<std::vector<uint8_t>> free_buffers_;
+
+  Stats stats_;
+};
+
+}  // namespace openscreen
+
+#endif  // PLATFORM_BASE_UDP_PACKET_POOL_H_
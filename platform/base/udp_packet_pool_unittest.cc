@@ -0,0 +1,141 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/base/udp_packet_pool.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace {
+
+constexpr size_t kMaxFreeBuffers = 4;
+constexpr size_t kMinBufferCapacity = 1500;
+
+}  // namespace
+
+TEST(UdpPacketPoolTest, ReusesReleasedBuffers) {
+  auto pool = UdpPacketPool::Create(kMaxFreeBuffers, kMinBufferCapacity);
+
+  const uint8_t* first_data = nullptr;
+  {
+    UdpPacket packet = pool->Acquire(100);
+    EXPECT_TRUE(packet.is_pooled());
+    EXPECT_EQ(packet.size(), 100u);
+    EXPECT_GE(packet.capacity(), kMinBufferCapacity);
+    first_data = packet.data();
+  }
+
+  UdpPacketPool::Stats stats = pool->GetStats();
+  EXPECT_EQ(stats.packets_acquired, 1u);
+  EXPECT_EQ(stats.heap_allocations, 1u);
+  EXPECT_EQ(stats.buffers_recycled, 1u);
+  EXPECT_EQ(stats.free_buffers, 1u);
+
+  // A packet of any size up to the minimum capacity reuses the buffer.
+  UdpPacket packet = pool->Acquire(kMinBufferCapacity);
+  EXPECT_EQ(packet.data(), first_data);
+  stats = pool->GetStats();
+  EXPECT_EQ(stats.packets_acquired, 2u);
+  EXPECT_EQ(stats.heap_allocations, 1u);
+  EXPECT_EQ(stats.free_buffers, 0u);
+}
+
+TEST(UdpPacketPoolTest, ZeroFillsOnlyBeyondRecycledContents) {
+  auto pool = UdpPacketPool::Create(kMaxFreeBuffers, kMinBufferCapacity);
+  {
+    UdpPacket packet = pool->Acquire(1000);
+    std::fill(packet.begin(), packet.end(), uint8_t{0xab});
+  }
+  EXPECT_EQ(pool->GetStats().bytes_zero_filled, 1000u);
+
+  // The recycled bytes are handed out again as they are.
+  {
+    UdpPacket packet = pool->Acquire(800);
+    EXPECT_EQ(packet[799], 0xab);
+  }
+  EXPECT_EQ(pool->GetStats().bytes_zero_filled, 1000u);
+
+  // Only the bytes beyond the previous packet are zero-filled.
+  UdpPacket packet = pool->Acquire(1200);
+  EXPECT_EQ(packet[799], 0xab);
+  EXPECT_EQ(packet[800], 0);
+  EXPECT_EQ(pool->GetStats().bytes_zero_filled, 1400u);
+}
+
+TEST(UdpPacketPoolTest, BufferFollowsMovedPacket) {
+  auto pool = UdpPacketPool::Create(kMaxFreeBuffers, kMinBufferCapacity);
+
+  std::vector<UdpPacket> consumed;
+  {
+    UdpPacket packet = pool->Acquire(10);
+    packet.set_source(IPEndpoint{IPAddress(10, 0, 0, 1), 1234});
+    consumed.push_back(std::move(packet));
+  }
+  // The moved-from packet does not return anything to the pool.
+  EXPECT_EQ(pool->GetStats().buffers_recycled, 0u);
+  EXPECT_TRUE(consumed[0].is_pooled());
+  EXPECT_EQ(consumed[0].source().port, 1234);
+
+  // Assigning over a pooled packet returns its buffer.
+  consumed[0] = UdpPacket(5);
+  EXPECT_FALSE(consumed[0].is_pooled());
+  EXPECT_EQ(pool->GetStats().buffers_recycled, 1u);
+}
+
+TEST(UdpPacketPoolTest, GrowsTooSmallBuffers) {
+  auto pool = UdpPacketPool::Create(kMaxFreeBuffers, kMinBufferCapacity);
+  pool->Acquire(10);
+
+  UdpPacket big_packet = pool->Acquire(kMinBufferCapacity * 2);
+  EXPECT_EQ(big_packet.size(), kMinBufferCapacity * 2);
+  EXPECT_EQ(pool->GetStats().heap_allocations, 2u);
+}
+
+TEST(UdpPacketPoolTest, DiscardsBuffersBeyondLimit) {
+  auto pool = UdpPacketPool::Create(kMaxFreeBuffers, kMinBufferCapacity);
+
+  std::vector<UdpPacket> packets;
+  for (size_t i = 0; i < kMaxFreeBuffers + 2; ++i) {
+    packets.push_back(pool->Acquire(10));
+  }
+  packets.clear();
+
+  const UdpPacketPool::Stats stats = pool->GetStats();
+  EXPECT_EQ(stats.buffers_recycled, kMaxFreeBuffers);
+  EXPECT_EQ(stats.buffers_discarded, 2u);
+  EXPECT_EQ(stats.free_buffers, kMaxFreeBuffers);
+}
+
+TEST(UdpPacketPoolTest, SteadyStateDoesNotAllocate) {
+  auto pool = UdpPacketPool::Create(kMaxFreeBuffers, kMinBufferCapacity);
+
+  // Simulate a consumer that holds on to a few packets at a time.
+  std::vector<UdpPacket> in_flight;
+  in_flight.reserve(kMaxFreeBuffers);
+  for (int i = 0; i < 1000; ++i) {
+    if (in_flight.size() == kMaxFreeBuffers) {
+      in_flight.clear();
+    }
+    in_flight.push_back(pool->Acquire(100 + (i % 1000)));
+  }
+
+  EXPECT_EQ(pool->GetStats().heap_allocations, kMaxFreeBuffers);
+}
+
+TEST(UdpPacketPoolTest, PacketsKeepPoolAlive) {
+  auto pool = UdpPacketPool::Create(kMaxFreeBuffers, kMinBufferCapacity);
+  UdpPacket packet = pool->Acquire(10);
+  pool.reset();
+
+  // Destroying the packet must not touch a freed pool.
+  packet = UdpPacket();
+  EXPECT_FALSE(packet.is_pooled());
+}
+
+}  // namespace openscreen
@@ -0,0 +1,192 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "platform/api/task_runner.h"
+#include "platform/api/time.h"
+#include "platform/impl/delayed_task_queue.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace {
+
+using Task = TaskRunner::Task;
+
+// The number of timers pending at once, such as the Alarms of many sessions.
+constexpr int kNumTimers = 10000;
+
+// Each round posts all the timers, cancels some of them, and fires the rest.
+// The queues are reused across rounds, as a TaskRunner reuses its queue.
+constexpr int kNumRounds = 20;
+
+// The timers fire as a run loop waking up this many times.
+constexpr int kNumFireSteps = 100;
+
+constexpr Clock::duration kMaxDelay = std::chrono::seconds(10);
+
+// The timers, and which of them are canceled, in the order of cancellation.
+struct Workload {
+  std::vector<Clock::duration> delays;
+  std::vector<int> canceled;
+};
+
+Workload CreateWorkload() {
+  std::mt19937 random(42);
+  std::uniform_int_distribution<Clock::rep> delay(1, kMaxDelay.count());
+  Workload workload;
+  for (int i = 0; i < kNumTimers; ++i) {
+    workload.delays.push_back(Clock::duration(delay(random)));
+  }
+  // A third of the timers are canceled, as Alarms re-armed sooner or destroyed.
+  for (int i = 0; i < kNumTimers; i += 3) {
+    workload.canceled.push_back(i);
+  }
+  std::shuffle(workload.canceled.begin(), workload.canceled.end(), random);
+  return workload;
+}
+
+// The std::multimap that TaskRunnerImpl used before DelayedTaskQueue, handled
+// the same way.
+class MultimapTimers {
+ public:
+  using Handle = std::multimap<Clock::time_point, Task>::iterator;
+
+  Handle Post(Clock::time_point run_time, Task task) {
+    return tasks_.emplace(run_time, std::move(task));
+  }
+
+  void Cancel(Handle handle) { tasks_.erase(handle); }
+
+  void PopReadyTasks(Clock::time_point now, std::vector<Task>* ready_tasks) {
+    const auto end_of_range = tasks_.upper_bound(now);
+    for (auto it = tasks_.begin(); it != end_of_range; ++it) {
+      ready_tasks->push_back(std::move(it->second));
+    }
+    tasks_.erase(tasks_.begin(), end_of_range);
+  }
+
+ private:
+  std::multimap<Clock::time_point, Task> tasks_;
+};
+
+class HeapTimers {
+ public:
+  using Handle = DelayedTaskQueue<Task>::Handle;
+
+  Handle Post(Clock::time_point run_time, Task task) {
+    return tasks_.Push(run_time, std::move(task));
+  }
+
+  void Cancel(Handle handle) { OSP_CHECK(tasks_.Cancel(handle)); }
+
+  void PopReadyTasks(Clock::time_point now, std::vector<Task>* ready_tasks) {
+    tasks_.PopReadyTasks(now, ready_tasks);
+  }
+
+ private:
+  DelayedTaskQueue<Task> tasks_;
+};
+
+struct TimerResults {
+  double post_ns = 0;
+  double cancel_ns = 0;
+  double fire_ns = 0;
+  int fired = 0;
+};
+
+double NanosecondsPer(std::chrono::steady_clock::duration time, int count) {
+  return std::chrono::duration<double, std::nano>(time).count() / count;
+}
+
+template <typename Timers>
+TimerResults RunTimers(const Workload& workload) {
+  using SteadyClock = std::chrono::steady_clock;
+  Timers timers;
+  std::vector<typename Timers::Handle> handles;
+  handles.reserve(kNumTimers);
+  std::vector<Task> ready_tasks;
+  ready_tasks.reserve(kNumTimers);
+  int fired = 0;
+  SteadyClock::duration post_time{};
+  SteadyClock::duration cancel_time{};
+  SteadyClock::duration fire_time{};
+
+  for (int round = 0; round < kNumRounds; ++round) {
+    const Clock::time_point start = Clock::time_point(kMaxDelay * round);
+
+    SteadyClock::time_point begin = SteadyClock::now();
+    for (const Clock::duration& delay : workload.delays) {
+      handles.push_back(
+          timers.Post(start + delay, Task([&fired] { ++fired; })));
+    }
+    post_time += SteadyClock::now() - begin;
+
+    begin = SteadyClock::now();
+    for (int index : workload.canceled) {
+      timers.Cancel(handles[index]);
+    }
+    cancel_time += SteadyClock::now() - begin;
+
+    begin = SteadyClock::now();
+    for (int step = 1; step <= kNumFireSteps; ++step) {
+      timers.PopReadyTasks(start + kMaxDelay * step / kNumFireSteps,
+                           &ready_tasks);
+      for (Task& task : ready_tasks) {
+        task();
+      }
+      ready_tasks.clear();
+    }
+    fire_time += SteadyClock::now() - begin;
+
+    handles.clear();
+  }
+
+  const int num_canceled = static_cast<int>(workload.canceled.size());
+  TimerResults results;
+  results.post_ns = NanosecondsPer(post_time, kNumRounds * kNumTimers);
+  results.cancel_ns = NanosecondsPer(cancel_time, kNumRounds * num_canceled);
+  results.fire_ns =
+      NanosecondsPer(fire_time, kNumRounds * (kNumTimers - num_canceled));
+  results.fired = fired;
+  return results;
+}
+
+void Report(const std::string& name, const TimerResults& results) {
+  OSP_LOG_INFO << name << " with " << kNumTimers << " timers: "
+               << results.post_ns << " ns per post, " << results.cancel_ns
+               << " ns per cancel, " << results.fire_ns << " ns per fire.";
+  testing::Test::RecordProperty(name + "_post_ns",
+                                static_cast<int>(results.post_ns));
+  testing::Test::RecordProperty(name + "_cancel_ns",
+                                static_cast<int>(results.cancel_ns));
+  testing::Test::RecordProperty(name + "_fire_ns",
+                                static_cast<int>(results.fire_ns));
+}
+
+}  // namespace
+
+// Measures posting, canceling and firing many pending timers with
+// DelayedTaskQueue, against the std::multimap it replaced.
+TEST(DelayedTaskQueueBenchmarkTest, ComparesHeapAndMultimapTimers) {
+  const Workload workload = CreateWorkload();
+  const TimerResults multimap = RunTimers<MultimapTimers>(workload);
+  Report("multimap", multimap);
+  const TimerResults heap = RunTimers<HeapTimers>(workload);
+  Report("heap", heap);
+
+  const int expected_fired =
+      kNumRounds * (kNumTimers - static_cast<int>(workload.canceled.size()));
+  EXPECT_EQ(expected_fired, multimap.fired);
+  EXPECT_EQ(expected_fired, heap.fired);
+}
+
+}  // namespace openscreen
@@ -0,0 +1,128 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "platform/api/task_runner.h"
+#include "platform/impl/immediate_task_queue.h"
+#include "util/osp_logging.h"
+#include "util/thread_annotations.h"
+
+namespace openscreen {
+namespace {
+
+using Task = TaskRunner::Task;
+
+// The number of tasks pushed by each producer thread.
+constexpr int kTasksPerProducer = 100000;
+
+constexpr int kProducerCounts[] = {1, 2, 4, 8};
+
+// The mutex-guarded vector that TaskRunnerImpl used for immediate tasks before
+// ImmediateTaskQueue, handled the same way.
+class MutexTaskQueue {
+ public:
+  void Push(Task task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+
+  void PopAll(std::vector<Task>* tasks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks->swap(tasks_);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<Task> tasks_ OSP_GUARDED_BY(mutex_);
+};
+
+struct ContentionResults {
+  double ns_per_task = 0;
+  int tasks_run = 0;
+};
+
+// Starts `num_producers` threads that all push kTasksPerProducer tasks at once,
+// while the calling thread pops and runs them, as the run loop does, and
+// measures the time until all of them have run.
+template <typename Queue>
+ContentionResults RunProducers(int num_producers) {
+  Queue queue;
+  std::atomic<bool> started{false};
+  int tasks_run = 0;
+  std::vector<std::thread> producers;
+  for (int i = 0; i < num_producers; ++i) {
+    producers.emplace_back([&queue, &started, &tasks_run] {
+      while (!started.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      for (int j = 0; j < kTasksPerProducer; ++j) {
+        queue.Push(Task([&tasks_run] { ++tasks_run; }));
+      }
+    });
+  }
+
+  const int num_tasks = num_producers * kTasksPerProducer;
+  std::vector<Task> running_tasks;
+  const auto start_time = std::chrono::steady_clock::now();
+  started.store(true, std::memory_order_release);
+  while (tasks_run < num_tasks) {
+    queue.PopAll(&running_tasks);
+    if (running_tasks.empty()) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (Task& task : running_tasks) {
+      task();
+    }
+    running_tasks.clear();
+  }
+  const auto run_time = std::chrono::steady_clock::now() - start_time;
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+
+  ContentionResults results;
+  results.ns_per_task =
+      std::chrono::duration<double, std::nano>(run_time).count() / num_tasks;
+  results.tasks_run = tasks_run;
+  return results;
+}
+
+void Report(const std::string& name,
+            int num_producers,
+            const ContentionResults& results) {
+  OSP_LOG_INFO << name << " with " << num_producers
+               << " producers: " << results.ns_per_task << " ns per task.";
+  testing::Test::RecordProperty(
+      name + "_" + std::to_string(num_producers) + "_producers_ns_per_task",
+      static_cast<int>(results.ns_per_task));
+}
+
+}  // namespace
+
+// Measures pushing immediate tasks from 1 to 8 threads at once while one
+// thread runs them, with ImmediateTaskQueue and with the mutex-guarded vector
+// it replaced.
+TEST(ImmediateTaskQueueBenchmarkTest, ComparesContendedPushes) {
+  for (int num_producers : kProducerCounts) {
+    const ContentionResults mutex = RunProducers<MutexTaskQueue>(num_producers);
+    Report("mutex", num_producers, mutex);
+    const ContentionResults ring =
+        RunProducers<ImmediateTaskQueue<Task>>(num_producers);
+    Report("ring", num_producers, ring);
+
+    EXPECT_EQ(num_producers * kTasksPerProducer, mutex.tasks_run);
+    EXPECT_EQ(num_producers * kTasksPerProducer, ring.tasks_run);
+  }
+}
+
+}  // namespace openscreen
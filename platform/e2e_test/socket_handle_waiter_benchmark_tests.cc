@@ -0,0 +1,214 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "platform/api/time.h"
+#include "platform/impl/scoped_pipe.h"
+#include "platform/impl/socket_handle_posix.h"
+#include "platform/impl/socket_handle_waiter_epoll.h"
+#include "platform/impl/socket_handle_waiter_posix.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+// The number of wakeups measured for each configuration. Each one is caused by
+// a single datagram, sent to one of the watched sockets once the previous one
+// has been received.
+constexpr int kNumWakeups = 2000;
+
+constexpr Clock::duration kWaitTimeout = std::chrono::milliseconds(50);
+
+struct WakeupResults {
+  Clock::duration median_latency;
+  Clock::duration p99_latency;
+  Clock::duration cpu_time_per_wakeup;
+};
+
+nanoseconds GetThreadCpuTime() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + nanoseconds(ts.tv_nsec);
+}
+
+// Receives the datagrams, and records the time from each send until the
+// waiter reported its socket as readable.
+class LatencyRecorder : public SocketHandleWaiter::Subscriber {
+ public:
+  using SocketHandleRef = SocketHandleWaiter::SocketHandleRef;
+
+  void ProcessReadyHandle(SocketHandleRef handle, uint32_t flags) override {
+    Clock::rep sent_at;
+    ASSERT_EQ(recv(handle.get().fd, &sent_at, sizeof(sent_at), 0),
+              static_cast<ssize_t>(sizeof(sent_at)));
+    const Clock::duration latency =
+        Clock::now() - Clock::time_point(Clock::duration(sent_at));
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_.push_back(latency);
+    received_.notify_one();
+  }
+
+  bool HasPendingWrite(SocketHandleRef handle) override { return false; }
+
+  void WaitForCount(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    received_.wait(lock, [&] { return latencies_.size() >= count; });
+  }
+
+  std::vector<Clock::duration> TakeLatencies() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(latencies_);
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable received_;
+  std::vector<Clock::duration> latencies_;
+};
+
+// Watches `num_sockets` UDP sockets with a `Waiter` on its own thread, and
+// wakes it up `kNumWakeups` times, one socket at a time. Returns nothing if the
+// `Waiter` cannot watch that many sockets.
+template <typename Waiter>
+std::optional<WakeupResults> MeasureWakeups(int num_sockets) {
+  std::vector<ScopedFd> sockets;
+  std::vector<sockaddr_in> addresses;
+  for (int i = 0; i < num_sockets; ++i) {
+    ScopedFd fd(socket(AF_INET, SOCK_DGRAM, 0));
+    OSP_CHECK(fd);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_size = sizeof(address);
+    OSP_CHECK_EQ(bind(fd.get(), reinterpret_cast<sockaddr*>(&address),
+                      sizeof(address)),
+                 0);
+    OSP_CHECK_EQ(getsockname(fd.get(), reinterpret_cast<sockaddr*>(&address),
+                             &address_size),
+                 0);
+    sockets.push_back(std::move(fd));
+    addresses.push_back(address);
+  }
+  const ScopedFd sender(socket(AF_INET, SOCK_DGRAM, 0));
+  OSP_CHECK(sender);
+  if constexpr (std::is_same_v<Waiter, SocketHandleWaiterPosix>) {
+    if (sockets.back().get() >= FD_SETSIZE) {
+      return std::nullopt;
+    }
+  }
+
+  std::vector<SocketHandle> handles;
+  handles.reserve(num_sockets);
+  Waiter waiter(&Clock::now);
+  LatencyRecorder recorder;
+  for (const ScopedFd& fd : sockets) {
+    handles.emplace_back(fd.get());
+    waiter.Subscribe(&recorder, handles.back(), SocketHandleWaiter::kReadable);
+  }
+
+  std::mutex mutex;
+  bool done = false;
+  nanoseconds waiter_cpu_time{};
+  std::thread waiter_thread([&] {
+    const nanoseconds start = GetThreadCpuTime();
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (done) {
+          break;
+        }
+      }
+      waiter.ProcessHandles(kWaitTimeout);
+    }
+    waiter_cpu_time = GetThreadCpuTime() - start;
+  });
+
+  for (int i = 0; i < kNumWakeups; ++i) {
+    // Spread the wakeups over the sockets, in an order unrelated to the order
+    // in which they were subscribed.
+    const sockaddr_in& address = addresses[(i * 7919) % num_sockets];
+    const Clock::rep sent_at = Clock::now().time_since_epoch().count();
+    OSP_CHECK_EQ(sendto(sender.get(), &sent_at, sizeof(sent_at), 0,
+                        reinterpret_cast<const sockaddr*>(&address),
+                        sizeof(address)),
+                 static_cast<ssize_t>(sizeof(sent_at)));
+    recorder.WaitForCount(i + 1);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  waiter_thread.join();
+
+  waiter.UnsubscribeAll(&recorder);
+
+  std::vector<Clock::duration> latencies = recorder.TakeLatencies();
+  EXPECT_EQ(latencies.size(), size_t{kNumWakeups});
+  std::sort(latencies.begin(), latencies.end());
+  return WakeupResults{
+      .median_latency = latencies[latencies.size() / 2],
+      .p99_latency = latencies[latencies.size() * 99 / 100],
+      .cpu_time_per_wakeup =
+          duration_cast<Clock::duration>(waiter_cpu_time / kNumWakeups)};
+}
+
+void Report(const std::string& name,
+            int num_sockets,
+            const std::optional<WakeupResults>& maybe_results) {
+  if (!maybe_results) {
+    OSP_LOG_INFO << name << " cannot watch " << num_sockets << " sockets";
+    return;
+  }
+  const WakeupResults& results = *maybe_results;
+  const auto us = [](Clock::duration d) {
+    return static_cast<int>(duration_cast<microseconds>(d).count());
+  };
+  OSP_LOG_INFO << name << " watching " << num_sockets
+               << " sockets: median wakeup latency "
+               << us(results.median_latency) << " us, p99 "
+               << us(results.p99_latency) << " us, "
+               << us(results.cpu_time_per_wakeup) << " us CPU per wakeup";
+  const std::string prefix = name + "_" + std::to_string(num_sockets);
+  testing::Test::RecordProperty(prefix + "_median_latency_us",
+                                us(results.median_latency));
+  testing::Test::RecordProperty(prefix + "_p99_latency_us",
+                                us(results.p99_latency));
+  testing::Test::RecordProperty(prefix + "_cpu_us_per_wakeup",
+                                us(results.cpu_time_per_wakeup));
+}
+
+}  // namespace
+
+// Compares select() and epoll, as the number of watched sockets grows, by the
+// time taken to wake up for a datagram and the CPU time spent per wakeup.
+TEST(SocketHandleWaiterBenchmarkTest, ComparesSelectAndEpollWakeups) {
+  for (int num_sockets : {10, 100, 1000}) {
+    Report("select", num_sockets,
+           MeasureWakeups<SocketHandleWaiterPosix>(num_sockets));
+    Report("epoll", num_sockets,
+           MeasureWakeups<SocketHandleWaiterEpoll>(num_sockets));
+  }
+}
+
+}  // namespace openscreen
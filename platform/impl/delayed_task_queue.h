@@ -0,0 +1,230 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PLATFORM_IMPL_DELAYED_TASK_QUEUE_H_
+#define PLATFORM_IMPL_DELAYED_TASK_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "platform/api/time.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+
+// A queue of tasks ordered by the time at which they should run, and then by
+// the order in which they were pushed.
+//
+// This is a flat 4-ary min-heap. The heap itself only holds small nodes, which
+// refer to the tasks kept in a separate slot array, so that tasks are never
+// moved while the heap is reordered. Both arrays, and the list of free slots,
+// are reused, so once the queue has grown to its working size, pushing,
+// popping and canceling tasks do not allocate. All operations are O(log n),
+// except for peeking at the next run time, which is O(1).
+//
+// This class is not thread-safe.
+template <typename TaskType>
+class DelayedTaskQueue {
+ public:
+  // Identifies a task in the queue, so that it can be canceled. A handle
+  // becomes stale once its task has been popped or canceled, even if the
+  // task's slot is later reused.
+  class Handle {
+   public:
+    Handle() = default;
+
+    bool is_valid() const { return slot_ != kInvalidSlot; }
+
+    // Returns the handle as an integer, from which FromValue() recreates it.
+    // An invalid handle is zero.
+    uint64_t value() const {
+      return (uint64_t{generation_} << 32) | static_cast<uint32_t>(slot_ + 1);
+    }
+    static Handle FromValue(uint64_t value) {
+      return Handle(static_cast<uint32_t>(value) - 1,
+                    static_cast<uint32_t>(value >> 32));
+    }
+
+   private:
+    friend class DelayedTaskQueue;
+
+    Handle(uint32_t slot, uint32_t generation)
+        : slot_(slot), generation_(generation) {}
+
+    uint32_t slot_ = kInvalidSlot;
+    uint32_t generation_ = 0;
+  };
+
+  DelayedTaskQueue() = default;
+  DelayedTaskQueue(const DelayedTaskQueue&) = delete;
+  DelayedTaskQueue& operator=(const DelayedTaskQueue&) = delete;
+  ~DelayedTaskQueue() = default;
+
+  bool empty() const { return heap_.empty(); }
+  size_t size() const { return heap_.size(); }
+
+  // Returns the run time of the task that will be popped next.
+  // Precondition: The queue is not empty.
+  Clock::time_point next_run_time() const {
+    OSP_CHECK(!empty());
+    return heap_.front().run_time;
+  }
+
+  // Adds a `task` that should run at `run_time`.
+  Handle Push(Clock::time_point run_time, TaskType task) {
+    uint32_t slot;
+    if (free_slots_.empty()) {
+      OSP_CHECK_LT(slots_.size(), size_t{kInvalidSlot});
+      slot = static_cast<uint32_t>(slots_.size());
+      slots_.emplace_back();
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    slots_[slot].task.emplace(std::move(task));
+
+    heap_.push_back(Node{run_time, next_sequence_number_++, slot});
+    SiftUp(heap_.size() - 1);
+    return Handle(slot, slots_[slot].generation);
+  }
+
+  // Removes the task identified by `handle` from the queue without running it,
+  // and returns it, so that the caller chooses where it is destroyed. Returns
+  // nothing if the handle is stale.
+  std::optional<TaskType> Cancel(Handle handle) {
+    if (handle.slot_ >= slots_.size()) {
+      return std::nullopt;
+    }
+    Slot& slot = slots_[handle.slot_];
+    if (!slot.task || slot.generation != handle.generation_) {
+      return std::nullopt;
+    }
+    std::optional<TaskType> task = std::move(slot.task);
+    RemoveAt(slot.heap_index);
+    ReleaseSlot(handle.slot_);
+    return task;
+  }
+
+  // Moves the tasks whose run time is at or before `now` to the end of
+  // `ready_tasks`, in the order they should run.
+  template <typename Container>
+  void PopReadyTasks(Clock::time_point now, Container* ready_tasks) {
+    while (!heap_.empty() && heap_.front().run_time <= now) {
+      const uint32_t slot = heap_.front().slot;
+      ready_tasks->push_back(std::move(*slots_[slot].task));
+      RemoveAt(0);
+      ReleaseSlot(slot);
+    }
+  }
+
+ private:
+  static constexpr uint32_t kInvalidSlot = std::numeric_limits<uint32_t>::max();
+  static constexpr size_t kArity = 4;
+
+  struct Node {
+    Clock::time_point run_time;
+
+    // Breaks ties between tasks having the same `run_time`, so that they run
+    // in the order they were pushed.
+    uint64_t sequence_number;
+
+    uint32_t slot;
+  };
+
+  struct Slot {
+    std::optional<TaskType> task;
+
+    // Incremented whenever the slot is released, to invalidate old Handles.
+    uint32_t generation = 0;
+
+    // The position of this slot's Node in `heap_`.
+    size_t heap_index = 0;
+  };
+
+  static bool IsBefore(const Node& a, const Node& b) {
+    if (a.run_time != b.run_time) {
+      return a.run_time < b.run_time;
+    }
+    return a.sequence_number < b.sequence_number;
+  }
+
+  // Stores `node` at `index` in the heap, keeping its slot's back-reference up
+  // to date.
+  void Place(size_t index, const Node& node) {
+    heap_[index] = node;
+    slots_[node.slot].heap_index = index;
+  }
+
+  void SiftUp(size_t index) {
+    const Node node = heap_[index];
+    while (index > 0) {
+      const size_t parent = (index - 1) / kArity;
+      if (!IsBefore(node, heap_[parent])) {
+        break;
+      }
+      Place(index, heap_[parent]);
+      index = parent;
+    }
+    Place(index, node);
+  }
+
+  void SiftDown(size_t index) {
+    const Node node = heap_[index];
+    while (true) {
+      const size_t first_child = index * kArity + 1;
+      if (first_child >= heap_.size()) {
+        break;
+      }
+      const size_t last_child = std::min(first_child + kArity, heap_.size());
+      size_t earliest_child = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (IsBefore(heap_[child], heap_[earliest_child])) {
+          earliest_child = child;
+        }
+      }
+      if (!IsBefore(heap_[earliest_child], node)) {
+        break;
+      }
+      Place(index, heap_[earliest_child]);
+      index = earliest_child;
+    }
+    Place(index, node);
+  }
+
+  // Removes the Node at `index` from the heap, restoring the heap order.
+  void RemoveAt(size_t index) {
+    const Node last = heap_.back();
+    heap_.pop_back();
+    if (index == heap_.size()) {
+      return;
+    }
+    Place(index, last);
+    if (index > 0 && IsBefore(last, heap_[(index - 1) / kArity])) {
+      SiftUp(index);
+    } else {
+      SiftDown(index);
+    }
+  }
+
+  void ReleaseSlot(uint32_t slot) {
+    slots_[slot].task.reset();
+    ++slots_[slot].generation;
+    free_slots_.push_back(slot);
+  }
+
+  std::vector<Node> heap_;
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> free_slots_;
+  uint64_t next_sequence_number_ = 0;
+};
+
+}  // namespace openscreen
+
+#endif  // PLATFORM_IMPL_DELAYED_TASK_QUEUE_H_
@@ -0,0 +1,167 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/delayed_task_queue.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "util/chrono_helpers.h"
+
+namespace openscreen {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// A move-only task type, like TaskRunner::Task.
+using TestTask = std::unique_ptr<int>;
+using TestQueue = DelayedTaskQueue<TestTask>;
+
+const Clock::time_point kStartTime = Clock::time_point(seconds(1000));
+
+std::vector<int> PopReadyValues(TestQueue& queue, Clock::time_point now) {
+  std::vector<TestTask> ready_tasks;
+  queue.PopReadyTasks(now, &ready_tasks);
+  std::vector<int> values;
+  for (const TestTask& task : ready_tasks) {
+    values.push_back(*task);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(DelayedTaskQueueTest, PopsTasksInRunTimeOrder) {
+  TestQueue queue;
+  queue.Push(kStartTime + milliseconds(30), std::make_unique<int>(3));
+  queue.Push(kStartTime + milliseconds(10), std::make_unique<int>(1));
+  queue.Push(kStartTime + milliseconds(20), std::make_unique<int>(2));
+  EXPECT_EQ(queue.size(), 3u);
+  EXPECT_EQ(queue.next_run_time(), kStartTime + milliseconds(10));
+
+  EXPECT_THAT(PopReadyValues(queue, kStartTime), IsEmpty());
+  EXPECT_THAT(PopReadyValues(queue, kStartTime + milliseconds(20)),
+              ElementsAre(1, 2));
+  EXPECT_EQ(queue.next_run_time(), kStartTime + milliseconds(30));
+  EXPECT_THAT(PopReadyValues(queue, kStartTime + milliseconds(100)),
+              ElementsAre(3));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(DelayedTaskQueueTest, TasksWithSameRunTimePopInPushOrder) {
+  TestQueue queue;
+  for (int i = 0; i < 20; ++i) {
+    queue.Push(kStartTime, std::make_unique<int>(i));
+  }
+  const std::vector<int> values = PopReadyValues(queue, kStartTime);
+  ASSERT_EQ(values.size(), 20u);
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST(DelayedTaskQueueTest, CanceledTasksAreNotPopped) {
+  TestQueue queue;
+  queue.Push(kStartTime + milliseconds(1), std::make_unique<int>(1));
+  const TestQueue::Handle handle =
+      queue.Push(kStartTime + milliseconds(2), std::make_unique<int>(2));
+  queue.Push(kStartTime + milliseconds(3), std::make_unique<int>(3));
+  ASSERT_TRUE(handle.is_valid());
+
+  const std::optional<TestTask> canceled = queue.Cancel(handle);
+  ASSERT_TRUE(canceled);
+  EXPECT_EQ(**canceled, 2);
+  EXPECT_EQ(queue.size(), 2u);
+  // Canceling again is a no-op.
+  EXPECT_FALSE(queue.Cancel(handle));
+
+  EXPECT_THAT(PopReadyValues(queue, kStartTime + milliseconds(3)),
+              ElementsAre(1, 3));
+}
+
+TEST(DelayedTaskQueueTest, StaleHandlesDoNotCancelReusedSlots) {
+  TestQueue queue;
+  const TestQueue::Handle popped_handle =
+      queue.Push(kStartTime, std::make_unique<int>(1));
+  EXPECT_THAT(PopReadyValues(queue, kStartTime), ElementsAre(1));
+
+  // The new task reuses the slot of the popped one.
+  const TestQueue::Handle new_handle =
+      queue.Push(kStartTime, std::make_unique<int>(2));
+  EXPECT_FALSE(queue.Cancel(popped_handle));
+  EXPECT_FALSE(queue.Cancel(TestQueue::Handle()));
+  EXPECT_EQ(queue.size(), 1u);
+
+  EXPECT_TRUE(queue.Cancel(new_handle));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(DelayedTaskQueueTest, HandlesRoundTripThroughValues) {
+  TestQueue queue;
+  EXPECT_EQ(TestQueue::Handle().value(), 0u);
+  EXPECT_FALSE(TestQueue::Handle::FromValue(0).is_valid());
+  EXPECT_FALSE(queue.Cancel(TestQueue::Handle::FromValue(0)));
+
+  queue.Push(kStartTime, std::make_unique<int>(1));
+  const TestQueue::Handle handle =
+      queue.Push(kStartTime, std::make_unique<int>(2));
+  ASSERT_NE(handle.value(), 0u);
+  EXPECT_TRUE(queue.Cancel(TestQueue::Handle::FromValue(handle.value())));
+  EXPECT_THAT(PopReadyValues(queue, kStartTime), ElementsAre(1));
+}
+
+// Compares the queue against a std::multimap, which has the same ordering
+// semantics, over a random mix of pushes, cancellations and pops.
+TEST(DelayedTaskQueueTest, MatchesMultimapOrdering) {
+  constexpr int kNumOperations = 10000;
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> delay_ms(0, 500);
+  std::uniform_int_distribution<int> operation(0, 9);
+
+  TestQueue queue;
+  std::multimap<Clock::time_point, int> expected;
+  std::vector<std::pair<TestQueue::Handle, int>> handles;
+  Clock::time_point now = kStartTime;
+  for (int i = 0; i < kNumOperations; ++i) {
+    const int op = operation(random);
+    if (op < 6) {
+      const Clock::time_point run_time = now + milliseconds(delay_ms(random));
+      handles.emplace_back(queue.Push(run_time, std::make_unique<int>(i)), i);
+      expected.emplace(run_time, i);
+    } else if (op < 8 && !handles.empty()) {
+      std::uniform_int_distribution<size_t> pick(0, handles.size() - 1);
+      const auto& [handle, value] = handles[pick(random)];
+      if (queue.Cancel(handle)) {
+        for (auto it = expected.begin(); it != expected.end(); ++it) {
+          if (it->second == value) {
+            expected.erase(it);
+            break;
+          }
+        }
+      }
+    } else {
+      now += milliseconds(delay_ms(random) / 10);
+      std::vector<int> expected_values;
+      const auto end = expected.upper_bound(now);
+      for (auto it = expected.begin(); it != end; ++it) {
+        expected_values.push_back(it->second);
+      }
+      expected.erase(expected.begin(), end);
+      ASSERT_EQ(PopReadyValues(queue, now), expected_values);
+    }
+    ASSERT_EQ(queue.size(), expected.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(queue.next_run_time(), expected.begin()->first);
+    }
+  }
+}
+
+}  // namespace openscreen
@@ -0,0 +1,169 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PLATFORM_IMPL_IMMEDIATE_TASK_QUEUE_H_
+#define PLATFORM_IMPL_IMMEDIATE_TASK_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "util/thread_annotations.h"
+
+namespace openscreen {
+
+// A multi-producer, single-consumer FIFO queue of tasks that should run as soon
+// as possible.
+//
+// Tasks are stored in a fixed-size ring of cells, each carrying a sequence
+// number that tells producers and the consumer whose turn it is to use the
+// cell (see Dmitry Vyukov's bounded MPMC queue). Pushing a task takes one
+// compare-and-swap and never blocks on other producers or on the consumer, and
+// neither pushing nor popping allocates.
+//
+// If the ring fills up, producers fall back to a mutex-guarded overflow list
+// until the consumer has drained the ring, so that the queue is unbounded and
+// tasks are still popped in the order they were pushed: a task pushed after
+// another Push() call has returned is always popped after that task.
+//
+// Push() may be called from any thread. PopAll() and empty() may only be
+// called from the consumer thread.
+template <typename TaskType>
+class ImmediateTaskQueue {
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  // `capacity` is rounded up to the next power of two, and to at least two so
+  // that a full cell can be told apart from one that is free for the next lap.
+  explicit ImmediateTaskQueue(size_t capacity = kDefaultCapacity)
+      : mask_(RoundUpToPowerOfTwo(capacity) - 1),
+        cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+  ImmediateTaskQueue(const ImmediateTaskQueue&) = delete;
+  ImmediateTaskQueue& operator=(const ImmediateTaskQueue&) = delete;
+  ~ImmediateTaskQueue() = default;
+
+  size_t capacity() const { return mask_ + 1; }
+
+  void Push(TaskType task) {
+    if (!overflowing_.load(std::memory_order_acquire)) {
+      size_t position = enqueue_position_.load(std::memory_order_relaxed);
+      while (true) {
+        Cell& cell = cells_[position & mask_];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const intptr_t lag = static_cast<intptr_t>(sequence) -
+                             static_cast<intptr_t>(position);
+        if (lag == 0) {
+          // The cell is free: try to claim it.
+          if (enqueue_position_.compare_exchange_weak(
+                  position, position + 1, std::memory_order_relaxed)) {
+            cell.task.emplace(std::move(task));
+            cell.sequence.store(position + 1, std::memory_order_release);
+            return;
+          }
+        } else if (lag < 0) {
+          // The consumer has not popped the task pushed one lap ago yet: the
+          // ring is full.
+          break;
+        } else {
+          // Another producer claimed the cell first.
+          position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    overflowing_.store(true, std::memory_order_release);
+    overflow_tasks_.push_back(std::move(task));
+  }
+
+  // Moves the tasks pushed so far to the end of `tasks`, in the order they
+  // were pushed. A task whose Push() call is still in progress may be left for
+  // a later call.
+  template <typename Container>
+  void PopAll(Container* tasks) {
+    size_t position = dequeue_position_;
+    while (true) {
+      Cell& cell = cells_[position & mask_];
+      if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+        break;
+      }
+      tasks->push_back(std::move(*cell.task));
+      cell.task.reset();
+      // Hand the cell over to the producer that will use it on the next lap.
+      cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+      ++position;
+    }
+    dequeue_position_ = position;
+
+    // Overflow tasks were pushed after everything in the ring, so they may
+    // only be popped once the ring is empty.
+    if (overflowing_.load(std::memory_order_acquire) &&
+        position == enqueue_position_.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(overflow_mutex_);
+      for (TaskType& task : overflow_tasks_) {
+        tasks->push_back(std::move(task));
+      }
+      overflow_tasks_.clear();
+      overflowing_.store(false, std::memory_order_release);
+    }
+  }
+
+  // Returns true if there is no task to pop, and no Push() call in progress
+  // would make one available without a following call to Push().
+  bool empty() const {
+    const Cell& cell = cells_[dequeue_position_ & mask_];
+    return cell.sequence.load(std::memory_order_acquire) !=
+               dequeue_position_ + 1 &&
+           !overflowing_.load(std::memory_order_acquire);
+  }
+
+ private:
+  // Avoids false sharing between the positions written by the producers and
+  // the one written by the consumer.
+  static constexpr size_t kCacheLineSize = 64;
+
+  struct Cell {
+    // Equal to the cell's position when it is free for the producer of that
+    // position, and to the position plus one once that producer has stored
+    // its task.
+    std::atomic<size_t> sequence{0};
+    std::optional<TaskType> task;
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_t mask_;
+  const std::unique_ptr<Cell[]> cells_;
+
+  alignas(kCacheLineSize) std::atomic<size_t> enqueue_position_{0};
+
+  // Only accessed by the consumer.
+  alignas(kCacheLineSize) size_t dequeue_position_ = 0;
+
+  // Set while `overflow_tasks_` is not empty, which sends all producers to the
+  // overflow list.
+  alignas(kCacheLineSize) std::atomic<bool> overflowing_{false};
+  std::mutex overflow_mutex_;
+  std::vector<TaskType> overflow_tasks_ OSP_GUARDED_BY(overflow_mutex_);
+};
+
+}  // namespace openscreen
+
+#endif  // PLATFORM_IMPL_IMMEDIATE_TASK_QUEUE_H_
@@ -0,0 +1,129 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/immediate_task_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// A move-only task type, like TaskRunner::Task.
+using TestTask = std::unique_ptr<int>;
+using TestQueue = ImmediateTaskQueue<TestTask>;
+
+std::vector<int> PopAllValues(TestQueue& queue) {
+  std::vector<TestTask> tasks;
+  queue.PopAll(&tasks);
+  std::vector<int> values;
+  for (const TestTask& task : tasks) {
+    values.push_back(*task);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(ImmediateTaskQueueTest, PopsTasksInPushOrder) {
+  TestQueue queue(4);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_THAT(PopAllValues(queue), IsEmpty());
+
+  // Go around the ring a few times.
+  for (int lap = 0; lap < 3; ++lap) {
+    queue.Push(std::make_unique<int>(1));
+    queue.Push(std::make_unique<int>(2));
+    queue.Push(std::make_unique<int>(3));
+    EXPECT_FALSE(queue.empty());
+    EXPECT_THAT(PopAllValues(queue), ElementsAre(1, 2, 3));
+    EXPECT_TRUE(queue.empty());
+  }
+}
+
+TEST(ImmediateTaskQueueTest, RoundsCapacityUpToPowerOfTwo) {
+  EXPECT_EQ(TestQueue(1).capacity(), 2u);
+  EXPECT_EQ(TestQueue(5).capacity(), 8u);
+  EXPECT_EQ(TestQueue(64).capacity(), 64u);
+}
+
+TEST(ImmediateTaskQueueTest, OverflowKeepsPushOrder) {
+  TestQueue queue(4);
+  for (int i = 0; i < 10; ++i) {
+    queue.Push(std::make_unique<int>(i));
+  }
+  EXPECT_THAT(PopAllValues(queue),
+              ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+  EXPECT_TRUE(queue.empty());
+
+  // Once the overflow list has been drained, the ring is used again.
+  queue.Push(std::make_unique<int>(10));
+  EXPECT_THAT(PopAllValues(queue), ElementsAre(10));
+}
+
+TEST(ImmediateTaskQueueTest, DestroysTasksLeftInQueue) {
+  std::weak_ptr<int> in_ring;
+  std::weak_ptr<int> in_overflow;
+  {
+    auto ring_task = std::make_shared<int>(1);
+    auto overflow_task = std::make_shared<int>(2);
+    in_ring = ring_task;
+    in_overflow = overflow_task;
+    ImmediateTaskQueue<std::shared_ptr<int>> queue(2);
+    queue.Push(std::make_shared<int>(0));
+    queue.Push(std::move(ring_task));
+    queue.Push(std::move(overflow_task));
+    EXPECT_FALSE(in_ring.expired());
+    EXPECT_FALSE(in_overflow.expired());
+  }
+  EXPECT_TRUE(in_ring.expired());
+  EXPECT_TRUE(in_overflow.expired());
+}
+
+// Several producers push concurrently while the consumer pops, through a ring
+// small enough to overflow regularly. Every task must be popped exactly once,
+// and the tasks of each producer must be popped in the order it pushed them.
+TEST(ImmediateTaskQueueTest, MultipleProducersKeepPerProducerOrder) {
+  constexpr int kNumProducers = 8;
+  constexpr int kTasksPerProducer = 20000;
+  TestQueue queue(64);
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kNumProducers; ++producer) {
+    producers.emplace_back([&queue, producer] {
+      for (int i = 0; i < kTasksPerProducer; ++i) {
+        queue.Push(std::make_unique<int>(producer * kTasksPerProducer + i));
+      }
+    });
+  }
+
+  std::vector<int> next_expected(kNumProducers, 0);
+  int popped = 0;
+  std::vector<TestTask> tasks;
+  while (popped < kNumProducers * kTasksPerProducer) {
+    queue.PopAll(&tasks);
+    for (const TestTask& task : tasks) {
+      const int producer = *task / kTasksPerProducer;
+      ASSERT_EQ(*task % kTasksPerProducer, next_expected[producer]);
+      ++next_expected[producer];
+    }
+    popped += static_cast<int>(tasks.size());
+    tasks.clear();
+  }
+
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  EXPECT_TRUE(queue.empty());
+  EXPECT_THAT(PopAllValues(queue), IsEmpty());
+}
+
+}  // namespace openscreen
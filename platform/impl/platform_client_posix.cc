@@ -9,26 +9,61 @@
 #include <utility>
 #include <vector>
 
+#include "build/build_config.h"
 #include "platform/base/trivial_clock_traits.h"
+#include "platform/impl/socket_handle_waiter_posix.h"
 #include "platform/impl/udp_socket_reader_posix.h"
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+#include "platform/impl/socket_handle_waiter_epoll.h"
+#include "platform/impl/task_waiter_eventfd.h"
+#endif
+
 namespace openscreen {
 
 using clock_operators::operator<<;
 
+namespace {
+
+// The eventfd keeps every wakeup until it is consumed, so the TaskRunner never
+// has to wake up to check for a missed one, and only does so for delayed
+// tasks.
+constexpr Clock::duration kTaskWaiterTimeout = std::chrono::hours(1);
+
+// Returns the TaskWaiter for a TaskRunner created by PlatformClientPosix, or
+// nullptr to have it wait on a condition variable instead.
+std::unique_ptr<TaskRunnerImpl::TaskWaiter> CreateTaskWaiter() {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  ErrorOr<std::unique_ptr<TaskWaiterEventFd>> waiter =
+      TaskWaiterEventFd::Create();
+  if (waiter) {
+    return std::move(waiter.value());
+  }
+  OSP_LOG_WARN << "Unable to create an eventfd TaskWaiter, falling back to a "
+                  "condition variable: "
+               << waiter.error();
+#endif
+  return nullptr;
+}
+
+}  // namespace
+
 // static
 PlatformClientPosix* PlatformClientPosix::instance_ = nullptr;
 
 // static
 void PlatformClientPosix::Create(Clock::duration networking_operation_timeout,
-                                 std::unique_ptr<TaskRunnerImpl> task_runner) {
-  SetInstance(new PlatformClientPosix(networking_operation_timeout,
-                                      std::move(task_runner)));
+                                 std::unique_ptr<TaskRunnerImpl> task_runner,
+                                 WaiterType waiter_type) {
+  SetInstance(new PlatformClientPosix(
+      networking_operation_timeout, std::move(task_runner), waiter_type));
 }
 
 // static
-void PlatformClientPosix::Create(Clock::duration networking_operation_timeout) {
-  SetInstance(new PlatformClientPosix(networking_operation_timeout));
+void PlatformClientPosix::Create(Clock::duration networking_operation_timeout,
+                                 WaiterType waiter_type) {
+  SetInstance(
+      new PlatformClientPosix(networking_operation_timeout, waiter_type));
 }
 
 // static
@@ -80,9 +115,14 @@ void PlatformClientPosix::SetInstance(PlatformClientPosix* instance) {
 }
 
 PlatformClientPosix::PlatformClientPosix(
-    Clock::duration networking_operation_timeout)
-    : task_runner_(new TaskRunnerImpl(Clock::now)),
+    Clock::duration networking_operation_timeout,
+    WaiterType waiter_type)
+    : task_waiter_(CreateTaskWaiter()),
+      task_runner_(new TaskRunnerImpl(Clock::now,
+                                      task_waiter_.get(),
+                                      kTaskWaiterTimeout)),
       networking_loop_timeout_(networking_operation_timeout),
+      waiter_type_(waiter_type),
       networking_loop_thread_(&PlatformClientPosix::RunNetworkLoopUntilStopped,
                               this),
       task_runner_thread_(
@@ -90,15 +130,24 @@ PlatformClientPosix::PlatformClientPosix(
 
 PlatformClientPosix::PlatformClientPosix(
     Clock::duration networking_operation_timeout,
-    std::unique_ptr<TaskRunnerImpl> task_runner)
+    std::unique_ptr<TaskRunnerImpl> task_runner,
+    WaiterType waiter_type)
     : task_runner_(std::move(task_runner)),
       networking_loop_timeout_(networking_operation_timeout),
+      waiter_type_(waiter_type),
       networking_loop_thread_(&PlatformClientPosix::RunNetworkLoopUntilStopped,
                               this) {}
 
-SocketHandleWaiterPosix* PlatformClientPosix::socket_handle_waiter() {
+SocketHandleWaiter* PlatformClientPosix::socket_handle_waiter() {
   std::call_once(waiter_initialization_, [this]() {
-    waiter_ = std::make_unique<SocketHandleWaiterPosix>(&Clock::now);
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+    if (waiter_type_ == WaiterType::kEpoll) {
+      waiter_ = std::make_unique<SocketHandleWaiterEpoll>(&Clock::now);
+    }
+#endif
+    if (!waiter_) {
+      waiter_ = std::make_unique<SocketHandleWaiterPosix>(&Clock::now);
+    }
     waiter_created_.store(true);
   });
   return waiter_.get();
@@ -13,7 +13,7 @@
 #include <vector>
 
 #include "platform/api/time.h"
-#include "platform/impl/socket_handle_waiter_posix.h"
+#include "platform/impl/socket_handle_waiter.h"
 #include "platform/impl/task_runner.h"
 #include "platform/impl/tls_data_router_posix.h"
 
@@ -35,6 +35,17 @@ class UdpSocketReaderPosix;
 // FIXME: Remove Create and Shutdown and use the ctor/dtor directly.
 class PlatformClientPosix {
  public:
+  // The mechanism used to wait for socket handles to become ready.
+  enum class WaiterType {
+    // select()-based waiter, available on all POSIX platforms.
+    kSelect,
+
+    // epoll()-based waiter with persistent handle registrations, which scales
+    // better with large numbers of sockets. Only available on Linux, Chrome OS
+    // and Android; other platforms fall back to kSelect.
+    kEpoll,
+  };
+
   // Initializes the platform implementation.
   //
   // `networking_loop_interval` sets the minimum amount of time that should pass
@@ -47,12 +58,16 @@ class PlatformClientPosix {
   // single networking operation type.
   //
   // `task_runner` is a client-provided TaskRunner implementation.
+  //
+  // `waiter_type` selects how socket readiness is waited on.
   static void Create(Clock::duration networking_operation_timeout,
-                     std::unique_ptr<TaskRunnerImpl> task_runner);
+                     std::unique_ptr<TaskRunnerImpl> task_runner,
+                     WaiterType waiter_type = WaiterType::kSelect);
 
   // Initializes the platform implementation and creates a new TaskRunner (which
   // starts a new thread).
-  static void Create(Clock::duration networking_operation_timeout);
+  static void Create(Clock::duration networking_operation_timeout,
+                     WaiterType waiter_type = WaiterType::kSelect);
 
   // Shuts down and deletes the PlatformClient instance currently stored as a
   // singleton. This method is expected to be called before program exit. After
@@ -86,16 +101,23 @@ class PlatformClientPosix {
   static void SetInstance(PlatformClientPosix* client);
 
  private:
-  explicit PlatformClientPosix(Clock::duration networking_operation_timeout);
+  PlatformClientPosix(Clock::duration networking_operation_timeout,
+                      WaiterType waiter_type);
 
   PlatformClientPosix(Clock::duration networking_operation_timeout,
-                      std::unique_ptr<TaskRunnerImpl> task_runner);
+                      std::unique_ptr<TaskRunnerImpl> task_runner,
+                      WaiterType waiter_type);
 
   // This method is thread-safe.
-  SocketHandleWaiterPosix* socket_handle_waiter();
+  SocketHandleWaiter* socket_handle_waiter();
 
   void RunNetworkLoopUntilStopped();
 
+  // Wakes up `task_runner_` when it was created by this instance, or nullptr
+  // if it falls back to its condition variable. Declared first, so that it
+  // outlives the TaskRunner.
+  std::unique_ptr<TaskRunnerImpl::TaskWaiter> task_waiter_;
+
   std::unique_ptr<TaskRunnerImpl> task_runner_;
 
   // Track whether the associated instance variable has been created yet.
@@ -106,6 +128,8 @@ class PlatformClientPosix {
   std::atomic_bool networking_loop_running_{true};
   Clock::duration networking_loop_timeout_;
 
+  const WaiterType waiter_type_;
+
   // Flags used to ensure that initialization of below instance objects occurs
   // only once across all threads.
   std::once_flag waiter_initialization_;
@@ -113,7 +137,7 @@ class PlatformClientPosix {
   std::once_flag tls_data_router_initialization_;
 
   // Instance objects are created at runtime when they are first needed.
-  std::unique_ptr<SocketHandleWaiterPosix> waiter_;
+  std::unique_ptr<SocketHandleWaiter> waiter_;
   std::unique_ptr<UdpSocketReaderPosix> udp_socket_reader_;
   std::unique_ptr<TlsDataRouterPosix> tls_data_router_;
 
@@ -4,6 +4,7 @@
 
 #include "platform/impl/platform_client_posix.h"
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -73,6 +74,28 @@ TEST_F(PlatformClientPosixTest, CreateAndShutdown_DefaultTaskRunner) {
   EXPECT_EQ(PlatformClientPosix::GetInstance(), nullptr);
 }
 
+TEST_F(PlatformClientPosixTest, DefaultTaskRunnerRunsPostedTasks) {
+  PlatformClientPosix::Create(kDefaultTestTimeout);
+  TaskRunner& task_runner = PlatformClientPosix::GetInstance()->GetTaskRunner();
+
+  // Tasks posted while the TaskRunner sleeps wake it up, whichever TaskWaiter
+  // it was given.
+  std::atomic<int> ran_tasks{0};
+  for (int i = 0; i < 10; ++i) {
+    task_runner.PostTask([&ran_tasks] { ++ran_tasks; });
+    while (ran_tasks.load() != i + 1) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  task_runner.PostTaskWithDelay([&ran_tasks] { ++ran_tasks; },
+                                std::chrono::milliseconds(5));
+  while (ran_tasks.load() != 11) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  PlatformClientPosix::ShutDown();
+}
+
 TEST_F(PlatformClientPosixTest, CreateAndShutdown_ProvidedTaskRunner) {
   EXPECT_EQ(PlatformClientPosix::GetInstance(), nullptr);
   auto mock_task_runner = std::make_unique<MockTaskRunnerImpl>(&FakeClock::now);
@@ -123,6 +146,19 @@ TEST_F(PlatformClientPosixTest, ComponentInitialization_UdpSocketReader) {
   PlatformClientPosix::ShutDown();
 }
 
+TEST_F(PlatformClientPosixTest, CreateAndShutdown_EpollWaiter) {
+  PlatformClientPosix::Create(kDefaultTestTimeout,
+                              PlatformClientPosix::WaiterType::kEpoll);
+  PlatformClientPosix* instance = PlatformClientPosix::GetInstance();
+  ASSERT_NE(instance, nullptr);
+
+  // Creating a component forces creation of the underlying waiter.
+  EXPECT_NE(instance->udp_socket_reader(), nullptr);
+
+  PlatformClientPosix::ShutDown();
+  EXPECT_EQ(PlatformClientPosix::GetInstance(), nullptr);
+}
+
 TEST_F(PlatformClientPosixTest, ComponentInitialization_TlsDataRouter) {
   PlatformClientPosix::Create(kDefaultTestTimeout);
   PlatformClientPosix* instance = PlatformClientPosix::GetInstance();
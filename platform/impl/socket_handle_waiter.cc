@@ -25,6 +25,7 @@ void SocketHandleWaiter::Subscribe(Subscriber* subscriber,
   std::lock_guard<std::mutex> lock(mutex_);
   if (handle_mappings_.find(handle) == handle_mappings_.end()) {
     handle_mappings_.emplace(handle, SocketSubscription{subscriber, flags});
+    OnHandleSubscribed(handle, flags);
   }
 }
 
@@ -34,6 +35,7 @@ void SocketHandleWaiter::Unsubscribe(Subscriber* subscriber,
   auto iterator = handle_mappings_.find(handle);
   if (handle_mappings_.find(handle) != handle_mappings_.end()) {
     handle_mappings_.erase(iterator);
+    OnHandleUnsubscribed(handle);
   }
 }
 
@@ -41,6 +43,7 @@ void SocketHandleWaiter::UnsubscribeAll(Subscriber* subscriber) {
   std::lock_guard<std::mutex> lock(mutex_);
   for (auto it = handle_mappings_.begin(); it != handle_mappings_.end();) {
     if (it->second.subscriber == subscriber) {
+      OnHandleUnsubscribed(it->first);
       it = handle_mappings_.erase(it);
     } else {
       it++;
@@ -56,6 +59,7 @@ void SocketHandleWaiter::OnHandleDeletion(
   auto it = handle_mappings_.find(handle);
   if (it != handle_mappings_.end()) {
     handle_mappings_.erase(it);
+    OnHandleUnsubscribed(handle);
     if (!disable_locking_for_testing) {
       handles_being_deleted_.push_back(handle);
 
@@ -109,6 +113,15 @@ void SocketHandleWaiter::ProcessReadyHandles(
   } while (now_function_() - start_time <= timeout);
 }
 
+bool SocketHandleWaiter::TracksSubscriptions() const {
+  return false;
+}
+
+void SocketHandleWaiter::OnHandleSubscribed(SocketHandleRef handle,
+                                            uint32_t flags) {}
+
+void SocketHandleWaiter::OnHandleUnsubscribed(SocketHandleRef handle) {}
+
 Error SocketHandleWaiter::ProcessHandles(Clock::duration timeout) {
   Clock::time_point start_time = now_function_();
   std::vector<HandleWithFlags> handles;
@@ -116,9 +129,19 @@ Error SocketHandleWaiter::ProcessHandles(Clock::duration timeout) {
     std::lock_guard<std::mutex> lock(mutex_);
     handles_being_deleted_.clear();
     handle_deletion_block_.notify_all();
+    if (handle_mappings_.empty()) {
+      return Error::Code::kAgain;
+    }
+
+    // Implementations tracking subscriptions themselves only need to be told
+    // about handles whose write interest may have changed.
+    const bool tracks_subscriptions = TracksSubscriptions();
     handles.reserve(handle_mappings_.size());
     for (auto& pair : handle_mappings_) {
       uint32_t flags = pair.second.flags;
+      if (tracks_subscriptions && !(flags & kWritable)) {
+        continue;
+      }
       // Remove the write flag if there is no pending write.
       if (flags & kWritable) {
         const bool has_pending_write =
@@ -130,10 +153,6 @@ Error SocketHandleWaiter::ProcessHandles(Clock::duration timeout) {
       handles.push_back(HandleWithFlags{.handle = pair.first, .flags = flags});
     }
   }
-  if (handles.empty()) {
-    return Error::Code::kAgain;
-  }
-
   Clock::time_point current_time = now_function_();
   Clock::duration remaining_timeout = timeout - (current_time - start_time);
   ErrorOr<std::vector<HandleWithFlags>> changed_handles =
@@ -104,10 +104,25 @@ class SocketHandleWaiter {
   // may be deleted while this method is being invoked, however the handle
   // itself is guaranteed to not be deleted until the invocation of this method
   // has been completed.
+  //
+  // If TracksSubscriptions() returns true, `sockets` only contains the handles
+  // subscribed to write events, since the implementation already knows about
+  // every watched handle.
   virtual ErrorOr<std::vector<HandleWithFlags>> AwaitSocketsReady(
       const std::vector<HandleWithFlags>& sockets,
       const Clock::duration& timeout) = 0;
 
+  // Implementations that keep a persistent registration of watched handles
+  // (such as epoll) return true here, and are then kept up to date through the
+  // OnHandleSubscribed() and OnHandleUnsubscribed() calls below instead of
+  // being handed the full set of handles on every call to AwaitSocketsReady().
+  virtual bool TracksSubscriptions() const;
+
+  // Called when `handle` starts or stops being watched. Both are called with
+  // `mutex_` held, so implementations must not call back into this class.
+  virtual void OnHandleSubscribed(SocketHandleRef handle, uint32_t flags);
+  virtual void OnHandleUnsubscribed(SocketHandleRef handle);
+
  private:
   struct SocketSubscription {
     raw_ptr<Subscriber> subscriber = nullptr;
@@ -0,0 +1,184 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/socket_handle_waiter_epoll.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "platform/base/error.h"
+#include "platform/impl/socket_handle_posix.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+
+namespace {
+
+// Converts `timeout` into the millisecond timeout used by epoll_wait(),
+// rounding up so that short timeouts do not turn into a busy loop.
+int ToEpollTimeout(const Clock::duration& timeout) {
+  if (timeout <= Clock::duration::zero()) {
+    return 0;
+  }
+  const auto millis = std::chrono::ceil<std::chrono::milliseconds>(timeout);
+  return static_cast<int>(
+      std::min<std::chrono::milliseconds::rep>(millis.count(), INT32_MAX));
+}
+
+}  // namespace
+
+SocketHandleWaiterEpoll::SocketHandleWaiterEpoll(
+    ClockNowFunctionPtr now_function)
+    : SocketHandleWaiter(now_function),
+      epoll_fd_(epoll_create1(EPOLL_CLOEXEC)),
+      events_(kMaxEventsPerWait) {
+  OSP_CHECK(epoll_fd_) << "epoll_create1() failed: " << strerror(errno);
+}
+
+SocketHandleWaiterEpoll::~SocketHandleWaiterEpoll() = default;
+
+ErrorOr<std::vector<SocketHandleWaiterEpoll::HandleWithFlags>>
+SocketHandleWaiterEpoll::AwaitSocketsReady(
+    const std::vector<HandleWithFlags>& sockets,
+    const Clock::duration& timeout) {
+  {
+    // Only handles subscribed to write events are passed in, and only their
+    // write interest can change between calls.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const HandleWithFlags& hwf : sockets) {
+      const int fd = hwf.handle.get().fd;
+      auto it = registrations_.find(fd);
+      if (it == registrations_.end()) {
+        continue;
+      }
+      uint32_t events = it->second.registered_events & ~EPOLLOUT;
+      if (hwf.flags & Flags::kWritable) {
+        events |= EPOLLOUT;
+      }
+      UpdateRegisteredEvents(fd, it->second, events);
+    }
+  }
+
+  const int rv = epoll_wait(epoll_fd_.get(), events_.data(),
+                            static_cast<int>(events_.size()),
+                            ToEpollTimeout(timeout));
+  if (rv == -1) {
+    // Being interrupted by a signal is equivalent to timing out.
+    return errno == EINTR ? Error::Code::kAgain : Error::Code::kIOFailure;
+  } else if (rv == 0) {
+    return Error::Code::kAgain;
+  }
+
+  std::vector<HandleWithFlags> changed_handles;
+  changed_handles.reserve(rv);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < rv; ++i) {
+    // The handle may have been unsubscribed while we were waiting.
+    auto it = registrations_.find(events_[i].data.fd);
+    if (it == registrations_.end()) {
+      continue;
+    }
+
+    // Like select(), report errors and hangups as readiness so that the
+    // subscriber's next operation surfaces them. epoll reports these even when
+    // no events are armed, so they are reported for every direction the handle
+    // is subscribed to, including a currently disarmed write interest.
+    const uint32_t ready_events = events_[i].events;
+    const Registration& registration = it->second;
+    uint32_t flags = 0;
+    if ((registration.subscribed_flags & Flags::kReadable) &&
+        (ready_events & EPOLLIN)) {
+      flags |= Flags::kReadable;
+    }
+    if ((registration.registered_events & EPOLLOUT) &&
+        (ready_events & EPOLLOUT)) {
+      flags |= Flags::kWritable;
+    }
+    if (ready_events & (EPOLLHUP | EPOLLERR)) {
+      flags |= registration.subscribed_flags & kReadWriteFlags;
+    }
+    if (flags) {
+      changed_handles.push_back({registration.handle, flags});
+    } else if (ready_events & (EPOLLHUP | EPOLLERR)) {
+      // Nobody can be told about the hangup, so stop watching the handle
+      // rather than have every following wait return it again.
+      epoll_ctl(epoll_fd_.get(), EPOLL_CTL_DEL, events_[i].data.fd, nullptr);
+      registrations_.erase(it);
+    }
+  }
+
+  if (changed_handles.empty()) {
+    return Error::Code::kAgain;
+  }
+  return changed_handles;
+}
+
+bool SocketHandleWaiterEpoll::TracksSubscriptions() const {
+  return true;
+}
+
+void SocketHandleWaiterEpoll::OnHandleSubscribed(SocketHandleRef handle,
+                                                 uint32_t flags) {
+  const int fd = handle.get().fd;
+  epoll_event event{};
+  if (flags & Flags::kReadable) {
+    event.events = EPOLLIN;
+  }
+  event.data.fd = fd;
+
+  // A stale registration may still exist if the descriptor was closed and
+  // reused without being unsubscribed first.
+  int rv = epoll_ctl(epoll_fd_.get(), EPOLL_CTL_ADD, fd, &event);
+  if (rv == -1 && errno == EEXIST) {
+    rv = epoll_ctl(epoll_fd_.get(), EPOLL_CTL_MOD, fd, &event);
+  }
+  if (rv == -1) {
+    OSP_LOG_ERROR << "Failed to register fd " << fd
+                  << " with epoll: " << strerror(errno);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  registrations_.insert_or_assign(
+      fd, Registration{handle, flags, event.events});
+}
+
+void SocketHandleWaiterEpoll::OnHandleUnsubscribed(SocketHandleRef handle) {
+  const int fd = handle.get().fd;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (registrations_.erase(fd) == 0) {
+      return;
+    }
+  }
+
+  // The descriptor may already have been closed, which removes it from the
+  // epoll set automatically, so failures here are expected and ignored.
+  epoll_ctl(epoll_fd_.get(), EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void SocketHandleWaiterEpoll::UpdateRegisteredEvents(
+    int fd,
+    Registration& registration,
+    uint32_t events) {
+  if (registration.registered_events == events) {
+    return;
+  }
+
+  epoll_event event{};
+  event.events = events;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll_fd_.get(), EPOLL_CTL_MOD, fd, &event) == -1) {
+    OSP_LOG_ERROR << "Failed to update epoll events for fd " << fd << ": "
+                  << strerror(errno);
+    return;
+  }
+  registration.registered_events = events;
+}
+
+}  // namespace openscreen
@@ -0,0 +1,82 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PLATFORM_IMPL_SOCKET_HANDLE_WAITER_EPOLL_H_
+#define PLATFORM_IMPL_SOCKET_HANDLE_WAITER_EPOLL_H_
+
+#include <sys/epoll.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/impl/scoped_pipe.h"
+#include "platform/impl/socket_handle_waiter.h"
+#include "util/thread_annotations.h"
+
+namespace openscreen {
+
+// Linux implementation of the SocketHandleWaiter, backed by epoll. Unlike
+// SocketHandleWaiterPosix, handles are registered with the kernel once when
+// they are subscribed, rather than on every wait, so the cost of each wakeup
+// scales with the number of ready handles instead of the number of watched
+// handles, and there is no FD_SETSIZE limit.
+//
+// Read interest is level-triggered, since readers such as UdpSocketPosix only
+// consume one message per notification. Write interest is only armed while the
+// subscriber reports a pending write, and is disarmed again as soon as that is
+// no longer the case.
+class SocketHandleWaiterEpoll : public SocketHandleWaiter {
+ public:
+  using SocketHandleRef = SocketHandleWaiter::SocketHandleRef;
+  using HandleWithFlags = SocketHandleWaiter::HandleWithFlags;
+
+  explicit SocketHandleWaiterEpoll(ClockNowFunctionPtr now_function);
+  ~SocketHandleWaiterEpoll() override;
+
+ protected:
+  // SocketHandleWaiter overrides.
+  ErrorOr<std::vector<HandleWithFlags>> AwaitSocketsReady(
+      const std::vector<HandleWithFlags>& sockets,
+      const Clock::duration& timeout) override;
+  bool TracksSubscriptions() const override;
+  void OnHandleSubscribed(SocketHandleRef handle, uint32_t flags) override;
+  void OnHandleUnsubscribed(SocketHandleRef handle) override;
+
+ private:
+  struct Registration {
+    SocketHandleRef handle;
+
+    // The SocketHandleWaiter::Flags the handle was subscribed with.
+    uint32_t subscribed_flags;
+
+    // The epoll events currently registered with the kernel.
+    uint32_t registered_events;
+  };
+
+  // Updates the kernel registration of `registration` to `events`, if needed.
+  void UpdateRegisteredEvents(int fd,
+                              Registration& registration,
+                              uint32_t events)
+      OSP_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Upper bound on the number of events returned by a single wait. Any
+  // additional ready handles are picked up on the following call.
+  static constexpr int kMaxEventsPerWait = 256;
+
+  const ScopedFd epoll_fd_;
+
+  // Guards the registrations below, which are modified from the
+  // SocketHandleWaiter subscription hooks and read after each wait.
+  std::mutex mutex_;
+  std::unordered_map<int, Registration> registrations_ OSP_GUARDED_BY(mutex_);
+
+  // Reused across waits to avoid reallocating on every wakeup. Only accessed
+  // from AwaitSocketsReady(), which is never called concurrently.
+  std::vector<epoll_event> events_;
+};
+
+}  // namespace openscreen
+
+#endif  // PLATFORM_IMPL_SOCKET_HANDLE_WAITER_EPOLL_H_
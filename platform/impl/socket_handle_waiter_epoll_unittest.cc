@@ -0,0 +1,194 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/socket_handle_waiter_epoll.h"
+
+#include <fcntl.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/impl/scoped_pipe.h"
+#include "platform/impl/socket_handle_posix.h"
+#include "platform/test/fake_clock.h"
+
+namespace openscreen {
+namespace {
+
+using ::testing::_;
+using ::testing::Gt;
+using ::testing::Return;
+
+constexpr Clock::duration kTimeout = std::chrono::milliseconds(10);
+constexpr char kTestBuf[] = "test";
+
+class MockSubscriber : public SocketHandleWaiter::Subscriber {
+ public:
+  using SocketHandleRef = SocketHandleWaiter::SocketHandleRef;
+  MOCK_METHOD(void, ProcessReadyHandle, (SocketHandleRef, uint32_t));
+  MOCK_METHOD(bool, HasPendingWrite, (SocketHandleRef));
+};
+
+class SocketHandleWaiterEpollTest : public ::testing::Test {
+ protected:
+  SocketHandleWaiterEpollTest()
+      : clock_(Clock::time_point{Clock::duration{1234567}}),
+        waiter_(&clock_.now) {}
+
+  // Creates a pipe, returning the read end in `read_fd` and the write end in
+  // `write_fd`.
+  void CreatePipe(ScopedFd* read_fd, ScopedFd* write_fd) {
+    int fds[2];
+    ASSERT_NE(-1, pipe(fds));
+    *read_fd = ScopedFd(fds[0]);
+    *write_fd = ScopedFd(fds[1]);
+  }
+
+  void WriteTestData(const ScopedFd& fd) {
+    ASSERT_THAT(write(fd.get(), kTestBuf, sizeof(kTestBuf) - 1),
+                Gt(ssize_t{0}));
+  }
+
+  FakeClock clock_;
+  SocketHandleWaiterEpoll waiter_;
+  MockSubscriber subscriber_;
+};
+
+}  // namespace
+
+TEST_F(SocketHandleWaiterEpollTest, ReportsReadableHandle) {
+  ScopedFd read_fd;
+  ScopedFd write_fd;
+  CreatePipe(&read_fd, &write_fd);
+  SocketHandle handle(read_fd.get());
+  waiter_.Subscribe(&subscriber_, handle, SocketHandleWaiter::kReadable);
+
+  // Nothing has been written yet.
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(_, _)).Times(0);
+  EXPECT_EQ(Error::Code::kAgain, waiter_.ProcessHandles(kTimeout).code());
+  testing::Mock::VerifyAndClearExpectations(&subscriber_);
+
+  WriteTestData(write_fd);
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(std::cref(handle),
+                                              SocketHandleWaiter::kReadable))
+      .Times(1);
+  EXPECT_TRUE(waiter_.ProcessHandles(kTimeout).ok());
+  testing::Mock::VerifyAndClearExpectations(&subscriber_);
+
+  // Reads are level-triggered, so unread data is reported again.
+  clock_.Advance(std::chrono::milliseconds(1));
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(std::cref(handle),
+                                              SocketHandleWaiter::kReadable))
+      .Times(1);
+  EXPECT_TRUE(waiter_.ProcessHandles(kTimeout).ok());
+
+  waiter_.Unsubscribe(&subscriber_, handle);
+}
+
+TEST_F(SocketHandleWaiterEpollTest, UnsubscribedHandleIsNotReported) {
+  ScopedFd read_fd;
+  ScopedFd write_fd;
+  CreatePipe(&read_fd, &write_fd);
+  SocketHandle handle(read_fd.get());
+  waiter_.Subscribe(&subscriber_, handle, SocketHandleWaiter::kReadable);
+  WriteTestData(write_fd);
+  waiter_.Unsubscribe(&subscriber_, handle);
+
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(_, _)).Times(0);
+  EXPECT_EQ(Error::Code::kAgain, waiter_.ProcessHandles(kTimeout).code());
+}
+
+TEST_F(SocketHandleWaiterEpollTest, WriteOnlyReportedWhileWritePending) {
+  ScopedFd read_fd;
+  ScopedFd write_fd;
+  CreatePipe(&read_fd, &write_fd);
+  SocketHandle handle(write_fd.get());
+  waiter_.Subscribe(&subscriber_, handle, SocketHandleWaiter::kWritable);
+
+  EXPECT_CALL(subscriber_, HasPendingWrite(std::cref(handle)))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(std::cref(handle),
+                                              SocketHandleWaiter::kWritable))
+      .Times(1);
+  EXPECT_TRUE(waiter_.ProcessHandles(kTimeout).ok());
+
+  // Once there is nothing left to write, the write interest is disarmed.
+  EXPECT_EQ(Error::Code::kAgain, waiter_.ProcessHandles(kTimeout).code());
+
+  waiter_.Unsubscribe(&subscriber_, handle);
+}
+
+TEST_F(SocketHandleWaiterEpollTest, HangupReportedForWriteOnlyHandle) {
+  ScopedFd read_fd;
+  ScopedFd write_fd;
+  CreatePipe(&read_fd, &write_fd);
+  SocketHandle handle(write_fd.get());
+  waiter_.Subscribe(&subscriber_, handle, SocketHandleWaiter::kWritable);
+
+  // Closing the read end raises EPOLLERR on the write end, which must reach the
+  // subscriber even though no write is pending.
+  read_fd = ScopedFd();
+  EXPECT_CALL(subscriber_, HasPendingWrite(std::cref(handle)))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(std::cref(handle),
+                                              SocketHandleWaiter::kWritable))
+      .Times(1);
+  EXPECT_TRUE(waiter_.ProcessHandles(kTimeout).ok());
+
+  waiter_.Unsubscribe(&subscriber_, handle);
+}
+
+TEST_F(SocketHandleWaiterEpollTest, ReportsOnlyReadyHandles) {
+  constexpr int kNumPipes = 100;
+  std::vector<ScopedFd> read_fds(kNumPipes);
+  std::vector<ScopedFd> write_fds(kNumPipes);
+  std::vector<SocketHandle> handles;
+  handles.reserve(kNumPipes);
+  for (int i = 0; i < kNumPipes; ++i) {
+    CreatePipe(&read_fds[i], &write_fds[i]);
+    handles.emplace_back(read_fds[i].get());
+    waiter_.Subscribe(&subscriber_, handles.back(),
+                      SocketHandleWaiter::kReadable);
+  }
+
+  WriteTestData(write_fds[17]);
+  WriteTestData(write_fds[42]);
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(std::cref(handles[17]),
+                                              SocketHandleWaiter::kReadable))
+      .Times(1);
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(std::cref(handles[42]),
+                                              SocketHandleWaiter::kReadable))
+      .Times(1);
+  EXPECT_TRUE(waiter_.ProcessHandles(kTimeout).ok());
+
+  waiter_.UnsubscribeAll(&subscriber_);
+}
+
+TEST_F(SocketHandleWaiterEpollTest, HandlesDescriptorsAboveFdSetSize) {
+  ScopedFd read_fd;
+  ScopedFd write_fd;
+  CreatePipe(&read_fd, &write_fd);
+  ScopedFd high_fd(fcntl(read_fd.get(), F_DUPFD_CLOEXEC, FD_SETSIZE + 1));
+  if (!high_fd) {
+    GTEST_SKIP() << "Descriptor limit too low to exceed FD_SETSIZE";
+  }
+
+  SocketHandle handle(high_fd.get());
+  waiter_.Subscribe(&subscriber_, handle, SocketHandleWaiter::kReadable);
+  WriteTestData(write_fd);
+  EXPECT_CALL(subscriber_, ProcessReadyHandle(std::cref(handle),
+                                              SocketHandleWaiter::kReadable))
+      .Times(1);
+  EXPECT_TRUE(waiter_.ProcessHandles(kTimeout).ok());
+
+  waiter_.Unsubscribe(&subscriber_, handle);
+}
+
+}  // namespace openscreen
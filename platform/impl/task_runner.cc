@@ -4,7 +4,9 @@
 
 #include "platform/impl/task_runner.h"
 
+#include <atomic>
 #include <csignal>
+#include <optional>
 #include <thread>
 
 #include "util/osp_logging.h"
@@ -46,29 +48,39 @@ TaskRunnerImpl::~TaskRunnerImpl() {
 }
 
 void TaskRunnerImpl::PostPackagedTask(Task task) {
-  std::lock_guard<std::mutex> lock(task_mutex_);
-  tasks_.emplace_back(std::move(task));
-  if (task_waiter_) {
-    task_waiter_->OnTaskPosted();
-  } else {
-    run_loop_wakeup_.notify_one();
-  }
+  tasks_.Push(std::move(task));
+  WakeUpRunLoop();
 }
 
 void TaskRunnerImpl::PostPackagedTaskWithDelay(Task task,
                                                Clock::duration delay) {
-  std::lock_guard<std::mutex> lock(task_mutex_);
+  PostCancelablePackagedTaskWithDelay(std::move(task), delay);
+}
+
+TaskRunner::DelayedTaskId TaskRunnerImpl::PostCancelablePackagedTaskWithDelay(
+    Task task,
+    Clock::duration delay) {
+  DelayedTaskId id = 0;
   if (delay <= Clock::duration::zero()) {
-    tasks_.emplace_back(std::move(task));
+    tasks_.Push(std::move(task));
   } else {
-    delayed_tasks_.emplace(
-        std::make_pair(now_function_() + delay, std::move(task)));
+    std::lock_guard<std::mutex> lock(task_mutex_);
+    id = delayed_tasks_.Push(now_function_() + delay, std::move(task)).value();
   }
-  if (task_waiter_) {
-    task_waiter_->OnTaskPosted();
-  } else {
-    run_loop_wakeup_.notify_one();
+  WakeUpRunLoop();
+  return id;
+}
+
+bool TaskRunnerImpl::CancelDelayedTask(DelayedTaskId id) {
+  std::optional<TaskWithMetadata> task;
+  {
+    std::lock_guard<std::mutex> lock(task_mutex_);
+    task = delayed_tasks_.Cancel(
+        DelayedTaskQueue<TaskWithMetadata>::Handle::FromValue(id));
   }
+  // The task is destroyed here, after releasing `task_mutex_`, in case its
+  // destruction posts or cancels other tasks.
+  return task.has_value();
 }
 
 bool TaskRunnerImpl::IsRunningOnTaskRunner() {
@@ -147,23 +159,20 @@ void TaskRunnerImpl::RunRunnableTasks() {
 }
 
 void TaskRunnerImpl::ScheduleDelayedTasks() {
+  // Grab the immediate tasks first, so that they run before the delayed tasks
+  // that become ready after them.
+  tasks_.PopAll(&running_tasks_);
+
   std::lock_guard<std::mutex> lock(task_mutex_);
 
   // Getting the time can be expensive on some platforms, so only get it once.
   const auto current_time = now_function_();
-  const auto end_of_range = delayed_tasks_.upper_bound(current_time);
-  for (auto it = delayed_tasks_.begin(); it != end_of_range; ++it) {
-    tasks_.push_back(std::move(it->second));
-  }
-  delayed_tasks_.erase(delayed_tasks_.begin(), end_of_range);
+  delayed_tasks_.PopReadyTasks(current_time, &running_tasks_);
 }
 
 bool TaskRunnerImpl::GrabMoreRunnableTasks() OSP_NO_THREAD_SAFETY_ANALYSIS {
-  OSP_CHECK(running_tasks_.empty());
-
-  std::unique_lock<std::mutex> lock(task_mutex_);
-  if (!tasks_.empty()) {
-    running_tasks_.swap(tasks_);
+  tasks_.PopAll(&running_tasks_);
+  if (!running_tasks_.empty()) {
     return true;
   }
 
@@ -171,27 +180,60 @@ bool TaskRunnerImpl::GrabMoreRunnableTasks() OSP_NO_THREAD_SAFETY_ANALYSIS {
     return false;  // Stop was requested. Don't wait for more tasks.
   }
 
+  // `is_sleeping_` is set while holding `task_mutex_`, so that a delayed task
+  // posted after the timeout below has been computed wakes up the run loop.
+  std::unique_lock<std::mutex> lock(task_mutex_);
+  is_sleeping_.store(true, std::memory_order_relaxed);
+
+  // Pairs with the fence in WakeUpRunLoop(): either a task posted concurrently
+  // is seen here, or the thread that posted it sees `is_sleeping_` and wakes
+  // up the run loop.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!tasks_.empty()) {
+    is_sleeping_.store(false, std::memory_order_relaxed);
+    return false;
+  }
+
+  const auto is_woken_up = [this] {
+    return !is_sleeping_.load(std::memory_order_relaxed);
+  };
   if (task_waiter_) {
     Clock::duration timeout = waiter_timeout_;
     if (!delayed_tasks_.empty()) {
       Clock::duration next_task_delta =
-          delayed_tasks_.begin()->first - now_function_();
+          delayed_tasks_.next_run_time() - now_function_();
       if (next_task_delta < timeout) {
         timeout = next_task_delta;
       }
     }
     lock.unlock();
     task_waiter_->WaitForTaskToBePosted(timeout);
-    return false;
+  } else if (delayed_tasks_.empty()) {
+    run_loop_wakeup_.wait(lock, is_woken_up);
+  } else {
+    run_loop_wakeup_.wait_for(
+        lock, delayed_tasks_.next_run_time() - now_function_(), is_woken_up);
+  }
+  is_sleeping_.store(false, std::memory_order_relaxed);
+  return false;
+}
+
+void TaskRunnerImpl::WakeUpRunLoop() {
+  // Pairs with the fence in GrabMoreRunnableTasks().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!is_sleeping_.load(std::memory_order_relaxed) ||
+      !is_sleeping_.exchange(false)) {
+    return;
   }
 
-  if (delayed_tasks_.empty()) {
-    run_loop_wakeup_.wait(lock);
+  if (task_waiter_) {
+    task_waiter_->OnTaskPosted();
   } else {
-    run_loop_wakeup_.wait_for(lock,
-                              delayed_tasks_.begin()->first - now_function_());
+    // Taking the lock guarantees that the run loop is either waiting on
+    // `run_loop_wakeup_`, or has not checked `is_sleeping_` yet.
+    std::lock_guard<std::mutex> lock(task_mutex_);
+    run_loop_wakeup_.notify_one();
   }
-  return false;
 }
 
 }  // namespace openscreen
@@ -5,8 +5,8 @@
 #ifndef PLATFORM_IMPL_TASK_RUNNER_H_
 #define PLATFORM_IMPL_TASK_RUNNER_H_
 
+#include <atomic>
 #include <condition_variable>  // NOLINT
-#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -16,6 +16,8 @@
 #include "platform/api/task_runner.h"
 #include "platform/api/time.h"
 #include "platform/base/error.h"
+#include "platform/impl/delayed_task_queue.h"
+#include "platform/impl/immediate_task_queue.h"
 #include "util/raw_ptr.h"
 #include "util/thread_annotations.h"
 #include "util/trace_logging.h"
@@ -33,8 +35,12 @@ class TaskRunnerImpl : public TaskRunner {
     // These calls should be thread-safe.  The absolute minimum is that
     // OnTaskPosted must be safe to call from another thread while this is
     // inside WaitForTaskToBePosted.  NOTE: There may be spurious wakeups from
-    // WaitForTaskToBePosted depending on whether the specific implementation
-    // chooses to clear queued WakeUps before entering WaitForTaskToBePosted.
+    // WaitForTaskToBePosted.
+    //
+    // The TaskRunnerImpl only calls OnTaskPosted when it is about to wait, and
+    // may do so just before it enters WaitForTaskToBePosted, so an
+    // implementation must not discard wakeups that are queued before
+    // WaitForTaskToBePosted is entered.
 
     // Blocks until some event occurs, which means new tasks may have been
     // posted.  Wait may only block up to `timeout` where 0 means don't block at
@@ -59,6 +65,10 @@ class TaskRunnerImpl : public TaskRunner {
   ~TaskRunnerImpl() override;
   void PostPackagedTask(Task task) override;
   void PostPackagedTaskWithDelay(Task task, Clock::duration delay) override;
+  DelayedTaskId PostCancelablePackagedTaskWithDelay(
+      Task task,
+      Clock::duration delay) override;
+  bool CancelDelayedTask(DelayedTaskId id) override;
   bool IsRunningOnTaskRunner() override;
 
   // Blocks the current thread, executing tasks from the queue with the desired
@@ -118,18 +128,32 @@ class TaskRunnerImpl : public TaskRunner {
   // transferred.
   bool GrabMoreRunnableTasks() OSP_NO_THREAD_SAFETY_ANALYSIS;
 
+  // Wakes up the run loop if it is sleeping, or about to sleep. Called after a
+  // task has been posted.
+  void WakeUpRunLoop();
+
   const ClockNowFunctionPtr now_function_;
 
   // Flag that indicates whether the task runner loop should continue. This is
   // only meant to be read/written on the thread executing RunUntilStopped().
   bool is_running_;
 
-  // This mutex is used for `tasks_` and `delayed_tasks_`, and also for
-  // notifying the run loop to wake up when it is waiting for a task to be added
-  // to the queue in `run_loop_wakeup_`.
+  // Immediately-runnable tasks. Posting to this queue does not take any lock,
+  // so that the threads posting tasks do not contend with each other or with
+  // the run loop.
+  ImmediateTaskQueue<TaskWithMetadata> tasks_;
+
+  // This mutex is used for `delayed_tasks_`, and also for notifying the run
+  // loop to wake up when it is waiting for a task to be posted in
+  // `run_loop_wakeup_`.
   std::mutex task_mutex_;
-  std::vector<TaskWithMetadata> tasks_ OSP_GUARDED_BY(task_mutex_);
-  std::multimap<Clock::time_point, TaskWithMetadata> delayed_tasks_ OSP_GUARDED_BY(task_mutex_);
+  DelayedTaskQueue<TaskWithMetadata> delayed_tasks_
+      OSP_GUARDED_BY(task_mutex_);
+
+  // Set by the run loop right before it goes to sleep, and cleared by whoever
+  // wakes it up. Posting a task only wakes up the run loop, which involves a
+  // system call, when this is set.
+  std::atomic<bool> is_sleeping_{false};
 
   // When `task_waiter_` is nullptr, `run_loop_wakeup_` is used for sleeping the
   // task runner.  Otherwise, `run_loop_wakeup_` isn't used and `task_waiter_`
@@ -138,9 +162,9 @@ class TaskRunnerImpl : public TaskRunner {
   const raw_ptr<TaskWaiter> task_waiter_;
   Clock::duration waiter_timeout_;
 
-  // To prevent excessive re-allocation of the underlying array of the `tasks_`
-  // vector, use an A/B vector-swap mechanism. `running_tasks_` starts out
-  // empty, and is swapped with `tasks_` when it is time to run the Tasks.
+  // Tasks are moved from `tasks_` and `delayed_tasks_` to `running_tasks_` in
+  // batches, and then run. The vector is reused to prevent excessive
+  // re-allocation of its underlying array.
   std::vector<TaskWithMetadata> running_tasks_;
 
   std::thread::id task_runner_thread_id_;
@@ -9,6 +9,7 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -128,6 +129,40 @@ TEST(TaskRunnerImplTest, TaskRunnerRunsDelayedTasksInOrder) {
   t.join();
 }
 
+TEST(TaskRunnerImplTest, CanceledDelayedTasksDoNotRun) {
+  FakeClock fake_clock{Clock::time_point(milliseconds(1337))};
+  TaskRunnerImpl runner(&fake_clock.now);
+
+  std::thread t([&runner] { runner.RunUntilStopped(); });
+
+  std::atomic<int> ran_tasks{0};
+  const auto kDelayTime = milliseconds(5);
+  const TaskRunner::DelayedTaskId canceled_id =
+      runner.PostCancelableTaskWithDelay([&ran_tasks] { ran_tasks |= 0b01; },
+                                         kDelayTime);
+  const TaskRunner::DelayedTaskId id = runner.PostCancelableTaskWithDelay(
+      [&ran_tasks] { ran_tasks |= 0b10; }, kDelayTime);
+  EXPECT_NE(canceled_id, 0u);
+  EXPECT_NE(id, canceled_id);
+  EXPECT_TRUE(runner.CancelDelayedTask(canceled_id));
+  EXPECT_FALSE(runner.CancelDelayedTask(canceled_id));
+
+  // Tasks without a delay are not queued as delayed tasks, and cannot be
+  // canceled.
+  EXPECT_EQ(runner.PostCancelableTaskWithDelay([] {}, Clock::duration::zero()),
+            0u);
+  EXPECT_FALSE(runner.CancelDelayedTask(0));
+
+  fake_clock.Advance(kDelayTime);
+  WaitUntilCondition([&ran_tasks] { return ran_tasks.load() != 0; });
+  EXPECT_EQ(ran_tasks.load(), 0b10);
+  // The task has run, so canceling it is a no-op.
+  EXPECT_FALSE(runner.CancelDelayedTask(id));
+
+  runner.RequestStopSoon();
+  t.join();
+}
+
 TEST(TaskRunnerImplTest, SingleThreadedTaskRunnerRunsSequentially) {
   FakeClock fake_clock{Clock::time_point(milliseconds(1337))};
   TaskRunnerImpl runner(&fake_clock.now);
@@ -220,6 +255,57 @@ TEST(TaskRunnerImplTest, TaskRunnerDelayedTasksDontBlockImmediateTasks) {
   EXPECT_EQ(ran_tasks, "1");
 }
 
+TEST(TaskRunnerImplTest, RunsTasksPostedFromManyThreadsInOrder) {
+  constexpr int kNumThreads = 8;
+  constexpr int kTasksPerThread = 5000;
+  TaskRunnerImpl runner(Clock::now);
+  std::thread runner_thread([&runner] { runner.RunUntilStopped(); });
+
+  // Only accessed from the task runner thread.
+  std::vector<int> next_task(kNumThreads, 0);
+  int out_of_order_tasks = 0;
+  std::atomic<int> ran_tasks{0};
+
+  std::vector<std::thread> posting_threads;
+  for (int thread = 0; thread < kNumThreads; ++thread) {
+    posting_threads.emplace_back([&, thread] {
+      for (int i = 0; i < kTasksPerThread; ++i) {
+        runner.PostTask([&, thread, i] {
+          if (next_task[thread]++ != i) {
+            ++out_of_order_tasks;
+          }
+          ++ran_tasks;
+        });
+      }
+    });
+  }
+  for (std::thread& posting_thread : posting_threads) {
+    posting_thread.join();
+  }
+
+  WaitUntilCondition([&ran_tasks] {
+    return ran_tasks.load() == kNumThreads * kTasksPerThread;
+  });
+  runner.RequestStopSoon();
+  runner_thread.join();
+  EXPECT_EQ(out_of_order_tasks, 0);
+}
+
+TEST(TaskRunnerImplTest, DelayedTaskWakesUpSleepingTaskRunner) {
+  TaskRunnerImpl runner(Clock::now);
+  std::thread runner_thread([&runner] { runner.RunUntilStopped(); });
+
+  // Let the runner go to sleep with nothing to do, and without a timeout.
+  std::this_thread::sleep_for(milliseconds(10));
+
+  std::atomic<bool> ran{false};
+  runner.PostTaskWithDelay([&ran] { ran = true; }, milliseconds(1));
+  WaitUntilCondition([&ran] { return ran.load(); });
+
+  runner.RequestStopSoon();
+  runner_thread.join();
+}
+
 TEST(TaskRunnerImplTest, TaskRunnerUsesEventWaiter) {
   std::unique_ptr<TaskRunnerImpl> runner =
       TaskRunnerWithWaiterFactory::Create(Clock::now);
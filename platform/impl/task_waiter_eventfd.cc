@@ -0,0 +1,77 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/task_waiter_eventfd.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "util/osp_logging.h"
+
+namespace openscreen {
+
+namespace {
+
+// poll() only has millisecond resolution. Round up, so that the run loop does
+// not wake up right before a delayed task is due and then spin until it is.
+int ToPollTimeout(Clock::duration timeout) {
+  if (timeout <= Clock::duration::zero()) {
+    return 0;
+  }
+  const auto millis = std::chrono::ceil<std::chrono::milliseconds>(timeout);
+  return static_cast<int>(
+      std::min<std::chrono::milliseconds::rep>(millis.count(), INT32_MAX));
+}
+
+}  // namespace
+
+// static
+ErrorOr<std::unique_ptr<TaskWaiterEventFd>> TaskWaiterEventFd::Create() {
+  ScopedFd event_fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+  if (!event_fd) {
+    return Error(Error::Code::kInitializationFailure, strerror(errno));
+  }
+  return std::unique_ptr<TaskWaiterEventFd>(
+      new TaskWaiterEventFd(std::move(event_fd)));
+}
+
+TaskWaiterEventFd::TaskWaiterEventFd(ScopedFd event_fd)
+    : event_fd_(std::move(event_fd)) {}
+
+TaskWaiterEventFd::~TaskWaiterEventFd() = default;
+
+Error TaskWaiterEventFd::WaitForTaskToBePosted(Clock::duration timeout) {
+  pollfd poll_fd = {event_fd_.get(), POLLIN, 0};
+  const int rv = poll(&poll_fd, 1, ToPollTimeout(timeout));
+  if (rv == -1) {
+    return errno == EINTR ? Error::Code::kAgain : Error::Code::kIOFailure;
+  } else if (rv == 0) {
+    return Error::Code::kAgain;
+  }
+
+  // Reset the counter, consuming all the wakeups queued so far.
+  uint64_t count;
+  if (read(event_fd_.get(), &count, sizeof(count)) == -1 && errno != EAGAIN) {
+    return Error::Code::kIOFailure;
+  }
+  return Error::None();
+}
+
+void TaskWaiterEventFd::OnTaskPosted() {
+  const uint64_t increment = 1;
+  // This can only fail if the counter would overflow, in which case a wakeup
+  // is already pending.
+  [[maybe_unused]] const ssize_t rv =
+      write(event_fd_.get(), &increment, sizeof(increment));
+}
+
+}  // namespace openscreen
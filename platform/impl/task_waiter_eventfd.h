@@ -0,0 +1,49 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PLATFORM_IMPL_TASK_WAITER_EVENTFD_H_
+#define PLATFORM_IMPL_TASK_WAITER_EVENTFD_H_
+
+#include <memory>
+
+#include "platform/api/time.h"
+#include "platform/base/error.h"
+#include "platform/impl/scoped_pipe.h"
+#include "platform/impl/task_runner.h"
+
+namespace openscreen {
+
+// Linux implementation of the TaskRunnerImpl::TaskWaiter, backed by an
+// eventfd. OnTaskPosted() is a single write() that is latched by the kernel
+// until the next WaitForTaskToBePosted() call consumes it, so no wakeup is lost
+// if it races with the run loop going to sleep.
+//
+// Embedders that run their own poll loop on the TaskRunner thread can watch
+// fd() for readability, and call WaitForTaskToBePosted() with a zero timeout
+// to reset it once it has fired.
+class TaskWaiterEventFd final : public TaskRunnerImpl::TaskWaiter {
+ public:
+  // Returns an error if the eventfd could not be created, for example because
+  // the process ran out of file descriptors.
+  static ErrorOr<std::unique_ptr<TaskWaiterEventFd>> Create();
+
+  TaskWaiterEventFd(const TaskWaiterEventFd&) = delete;
+  TaskWaiterEventFd& operator=(const TaskWaiterEventFd&) = delete;
+  ~TaskWaiterEventFd() override;
+
+  int fd() const { return event_fd_.get(); }
+
+  // TaskRunnerImpl::TaskWaiter overrides.
+  Error WaitForTaskToBePosted(Clock::duration timeout) override;
+  void OnTaskPosted() override;
+
+ private:
+  explicit TaskWaiterEventFd(ScopedFd event_fd);
+
+  const ScopedFd event_fd_;
+};
+
+}  // namespace openscreen
+
+#endif  // PLATFORM_IMPL_TASK_WAITER_EVENTFD_H_
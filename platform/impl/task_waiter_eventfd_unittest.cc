@@ -0,0 +1,65 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/task_waiter_eventfd.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "platform/impl/task_runner.h"
+#include "util/chrono_helpers.h"
+
+namespace openscreen {
+
+TEST(TaskWaiterEventFdTest, TimesOutWithoutWakeup) {
+  ErrorOr<std::unique_ptr<TaskWaiterEventFd>> create_result =
+      TaskWaiterEventFd::Create();
+  ASSERT_TRUE(create_result) << create_result.error();
+  TaskWaiterEventFd& waiter = *create_result.value();
+  EXPECT_EQ(waiter.WaitForTaskToBePosted(Clock::duration::zero()).code(),
+            Error::Code::kAgain);
+  EXPECT_EQ(waiter.WaitForTaskToBePosted(milliseconds(1)).code(),
+            Error::Code::kAgain);
+}
+
+TEST(TaskWaiterEventFdTest, KeepsWakeupsPostedBeforeWaiting) {
+  ErrorOr<std::unique_ptr<TaskWaiterEventFd>> create_result =
+      TaskWaiterEventFd::Create();
+  ASSERT_TRUE(create_result) << create_result.error();
+  TaskWaiterEventFd& waiter = *create_result.value();
+  waiter.OnTaskPosted();
+  waiter.OnTaskPosted();
+
+  // Both wakeups are consumed by a single wait.
+  EXPECT_TRUE(waiter.WaitForTaskToBePosted(seconds(10)).ok());
+  EXPECT_EQ(waiter.WaitForTaskToBePosted(Clock::duration::zero()).code(),
+            Error::Code::kAgain);
+}
+
+TEST(TaskWaiterEventFdTest, WakesUpTaskRunner) {
+  ErrorOr<std::unique_ptr<TaskWaiterEventFd>> create_result =
+      TaskWaiterEventFd::Create();
+  ASSERT_TRUE(create_result) << create_result.error();
+  TaskRunnerImpl runner(Clock::now, create_result.value().get(),
+                        std::chrono::hours(1));
+  std::thread thread([&runner] { runner.RunUntilStopped(); });
+
+  // Tasks posted from other threads while the runner sleeps for (up to) an
+  // hour must still run promptly.
+  std::atomic<int> ran_tasks{0};
+  for (int i = 0; i < 10; ++i) {
+    runner.PostTask([&ran_tasks] { ++ran_tasks; });
+    while (ran_tasks.load() != i + 1) {
+      std::this_thread::sleep_for(milliseconds(1));
+    }
+  }
+
+  runner.RequestStopSoon();
+  thread.join();
+  EXPECT_EQ(ran_tasks.load(), 10);
+}
+
+}  // namespace openscreen
@@ -8,12 +8,14 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/ip.h>
+#include <netinet/udp.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <limits>
 #include <memory>
@@ -37,6 +39,26 @@ namespace {
 // 64 KB is the maximum possible UDP datagram size.
 constexpr int kMaxUdpBufferSize = 64 << 10;
 
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// The size of the packets that batched reads receive into when there is no
+// packet pool, enough for any datagram sent over Ethernet. Larger datagrams
+// are still received in full, at the cost of copying the excess.
+constexpr size_t kDefaultBatchPacketSize = 2048;
+
+#ifndef UDP_SEGMENT
+// Older libc headers lack this, even though the running kernel may support it.
+#define UDP_SEGMENT 103
+#endif
+
+// The maximum number of messages passed to a single sendmmsg() call, which is
+// also the kernel's limit on the number of segments in one UDP_SEGMENT send.
+constexpr size_t kMaxMessagesPerSend = 64;
+
+// The maximum total payload of one UDP_SEGMENT send, which must fit in a single
+// IP datagram (the IPv6 header being the larger of the two).
+constexpr size_t kMaxSegmentedPayloadSize = 0xffff - 40 - 8;
+#endif
+
 constexpr bool IsPowerOf2(uint32_t x) {
   return (x > 0) && ((x & (x - 1)) == 0);
 }
@@ -63,6 +85,88 @@ ErrorOr<int> CreateNonBlockingUdpSocket(int domain) {
 
 }  // namespace
 
+// Preallocated storage for reading a batch of datagrams with one recvmmsg()
+// call. Each datagram is read straight into the UdpPacket handed to the
+// client: its first `packet_size` bytes land in the packet's own buffer, and
+// only the remainder of a larger datagram goes to a staging area, from which it
+// is appended to the packet.
+class ReceiveBatchBuffers {
+ public:
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  ReceiveBatchBuffers(size_t capacity, size_t packet_size)
+      : packet_size_(std::clamp<size_t>(packet_size, 1, kMaxUdpBufferSize)),
+        overflow_size_(kMaxUdpBufferSize - packet_size_),
+        headers_(capacity),
+        iovecs_(capacity * 2),
+        addresses_(capacity),
+        controls_(capacity),
+        packets_(capacity),
+        overflow_(capacity * overflow_size_) {}
+
+  size_t capacity() const { return headers_.size(); }
+
+  // Prepares the message headers for the next recvmmsg() call, replacing the
+  // packets taken by the previous call with new ones from `pool`, if any. This
+  // must be done before every call, since the kernel overwrites the name and
+  // control lengths.
+  mmsghdr* Reset(UdpPacketPool* pool) {
+    for (size_t i = 0; i < headers_.size(); ++i) {
+      UdpPacket& packet = packets_[i];
+      if (packet.size() != packet_size_) {
+        packet = pool ? pool->Acquire(packet_size_) : UdpPacket(packet_size_);
+      }
+      iovec* iov = &iovecs_[i * 2];
+      iov[0] = {packet.data(), packet_size_};
+      iov[1] = {overflow(i), overflow_size_};
+
+      msghdr& msg = headers_[i].msg_hdr;
+      msg = {};
+      msg.msg_name = &addresses_[i];
+      msg.msg_namelen = sizeof(addresses_[i]);
+      msg.msg_iov = iov;
+      msg.msg_iovlen = 2;
+      msg.msg_control = controls_[i].data;
+      msg.msg_controllen = sizeof(controls_[i].data);
+      headers_[i].msg_len = 0;
+    }
+    return headers_.data();
+  }
+
+  mmsghdr& header(size_t index) { return headers_[index]; }
+
+  // Returns the packet that the datagram at `index` was read into, trimmed to
+  // the datagram's `size`.
+  UdpPacket TakePacket(size_t index, size_t size) {
+    UdpPacket& packet = packets_[index];
+    if (size > packet_size_) {
+      const uint8_t* data = overflow(index);
+      packet.insert(packet.end(), data, data + (size - packet_size_));
+    } else {
+      packet.resize(size);
+    }
+    return std::move(packet);
+  }
+
+ private:
+  // Only packet info control messages are requested, so this comfortably
+  // holds the largest one (in6_pktinfo).
+  struct ControlBuffer {
+    alignas(alignof(cmsghdr)) uint8_t data[256];
+  };
+
+  uint8_t* overflow(size_t index) { return &overflow_[index * overflow_size_]; }
+
+  const size_t packet_size_;
+  const size_t overflow_size_;
+  std::vector<mmsghdr> headers_;
+  std::vector<iovec> iovecs_;
+  std::vector<sockaddr_storage> addresses_;
+  std::vector<ControlBuffer> controls_;
+  std::vector<UdpPacket> packets_;
+  std::vector<uint8_t> overflow_;
+#endif
+};
+
 UdpSocketPosix::UdpSocketPosix(TaskRunner& task_runner,
                                Client* client,
                                SocketHandle handle,
@@ -392,8 +496,41 @@ bool IsPacketInfo<in6_pktinfo>(cmsghdr* cmh) {
   return cmh->cmsg_level == IPPROTO_IPV6 && cmh->cmsg_type == IPV6_PKTINFO;
 }
 
+// Sets the source and destination endpoints of `packet` from the address and
+// control data filled in by recvmsg() or recvmmsg().
+template <class SockAddrType, class PktInfoType>
+void SetPacketEndpoints(msghdr* msg,
+                        const SockAddrType& sa,
+                        uint16_t local_port,
+                        UdpPacket& packet) {
+  IPEndpoint source_endpoint = {.address = GetIPAddressFromSockAddr(sa),
+                                .port = GetPortFromFromSockAddr(sa)};
+  packet.set_source(std::move(source_endpoint));
+
+  // For multicast sockets, the packet's original destination address may be
+  // the host address (since we called bind()) but it may also be a
+  // multicast address.  This may be relevant for handling multicast data;
+  // specifically, mDNSResponder requires this information to work properly.
+  for (cmsghdr* cmh = CMSG_FIRSTHDR(msg); cmh; cmh = CMSG_NXTHDR(msg, cmh)) {
+    if (IsPacketInfo<PktInfoType>(cmh)) {
+      PktInfoType* pktinfo = reinterpret_cast<PktInfoType*>(CMSG_DATA(cmh));
+      IPEndpoint destination_endpoint = {
+          .address = GetIPAddressFromPktInfo(*pktinfo), .port = local_port};
+      packet.set_destination(std::move(destination_endpoint));
+      break;
+    }
+  }
+}
+
+// Returns a packet of `size` bytes, acquired from `pool` if there is one.
+UdpPacket AllocatePacket(UdpPacketPool* pool, size_t size) {
+  return pool ? pool->Acquire(size) : UdpPacket(size);
+}
+
 template <class SockAddrType, class PktInfoType>
-ErrorOr<UdpPacket> ReceiveMessageInternal(int fd) {
+ErrorOr<UdpPacket> ReceiveMessageInternal(int fd,
+                                          const ErrorOr<uint16_t>& local_port,
+                                          UdpPacketPool* pool) {
   // Try to determine the size of the incoming packet.  If we cannot,
   // it's not a fatal error, we will just allocate kMaxUdpBufferSize
   // and shrink-to-fit below.
@@ -417,7 +554,7 @@ ErrorOr<UdpPacket> ReceiveMessageInternal(int fd) {
     upper_bound_bytes = kMaxUdpBufferSize;
   }
 
-  UdpPacket packet(upper_bound_bytes);
+  UdpPacket packet = AllocatePacket(pool, upper_bound_bytes);
   struct msghdr msg {};
   SockAddrType sa{};
   msg.msg_name = &sa;
@@ -443,35 +580,143 @@ ErrorOr<UdpPacket> ReceiveMessageInternal(int fd) {
   OSP_CHECK_LE(static_cast<size_t>(bytes_received), packet.size());
   packet.resize(bytes_received);
 
-  IPEndpoint source_endpoint = {.address = GetIPAddressFromSockAddr(sa),
-                                .port = GetPortFromFromSockAddr(sa)};
-  packet.set_source(std::move(source_endpoint));
-
-  // For multicast sockets, the packet's original destination address may be
-  // the host address (since we called bind()) but it may also be a
-  // multicast address.  This may be relevant for handling multicast data;
-  // specifically, mDNSResponder requires this information to work properly.
-
-  socklen_t sa_len = sizeof(sa);
   if (((msg.msg_flags & MSG_CTRUNC) != 0)) {
     return Error(Error::Code::kSocketReadFailure, "Packet was truncated");
   }
+  if (local_port.is_error()) {
+    return local_port.error();
+  }
+  SetPacketEndpoints<SockAddrType, PktInfoType>(&msg, sa, local_port.value(),
+                                                packet);
+  return std::move(packet);
+}
 
-  if ((getsockname(fd, reinterpret_cast<sockaddr*>(&sa), &sa_len) == -1)) {
-    return Error(Error::Code::kSocketReadFailure, "Failed to get socket name");
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+template <class SockAddrType, class PktInfoType>
+ErrorOr<std::vector<UdpPacket>> ReceiveMessageBatchInternal(
+    int fd,
+    uint16_t local_port,
+    ReceiveBatchBuffers& buffers,
+    UdpPacketPool* pool) {
+  const int count = recvmmsg(fd, buffers.Reset(pool),
+                             static_cast<unsigned>(buffers.capacity()),
+                             /* flags */ 0, /* timeout */ nullptr);
+  if (count == -1) {
+    OSP_DVLOG << "Failed to read from socket.";
+    return ChooseError(errno, Error::Code::kSocketReadFailure);
   }
-  for (cmsghdr* cmh = CMSG_FIRSTHDR(&msg); cmh; cmh = CMSG_NXTHDR(&msg, cmh)) {
-    if (IsPacketInfo<PktInfoType>(cmh)) {
-      PktInfoType* pktinfo = reinterpret_cast<PktInfoType*>(CMSG_DATA(cmh));
-      IPEndpoint destination_endpoint = {
-          .address = GetIPAddressFromPktInfo(*pktinfo),
-          .port = GetPortFromFromSockAddr(sa)};
-      packet.set_destination(std::move(destination_endpoint));
+
+  std::vector<UdpPacket> packets;
+  packets.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    mmsghdr& header = buffers.header(i);
+    if ((header.msg_hdr.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+      OSP_DVLOG << "Dropping truncated packet.";
+      continue;
+    }
+
+    UdpPacket packet = buffers.TakePacket(i, header.msg_len);
+    SetPacketEndpoints<SockAddrType, PktInfoType>(
+        &header.msg_hdr,
+        *reinterpret_cast<const SockAddrType*>(header.msg_hdr.msg_name),
+        local_port, packet);
+    packets.push_back(std::move(packet));
+  }
+  return packets;
+}
+#endif
+
+// Fills in `sa` with the address of `endpoint`, returning its length.
+socklen_t ToSockAddr(const IPEndpoint& endpoint, sockaddr_storage* sa) {
+  *sa = {};
+  switch (endpoint.address.version()) {
+    case UdpSocket::Version::kV4: {
+      auto* sa4 = reinterpret_cast<sockaddr_in*>(sa);
+      sa4->sin_family = AF_INET;
+      sa4->sin_port = htons(endpoint.port);
+      endpoint.address.CopyTo(std::span<uint8_t>(
+          reinterpret_cast<uint8_t*>(&sa4->sin_addr.s_addr), 4));
+      return sizeof(sockaddr_in);
+    }
+
+    case UdpSocket::Version::kV6: {
+      auto* sa6 = reinterpret_cast<sockaddr_in6*>(sa);
+      sa6->sin6_family = AF_INET6;
+      sa6->sin6_port = htons(endpoint.port);
+      endpoint.address.CopyTo(std::span<uint8_t>(
+          reinterpret_cast<uint8_t*>(&sa6->sin6_addr.s6_addr), 16));
+      if (endpoint.address.IsLinkLocal() &&
+          endpoint.address.GetScopeId() != 0) {
+        sa6->sin6_scope_id = endpoint.address.GetScopeId();
+      }
+      return sizeof(sockaddr_in6);
+    }
+  }
+  OSP_NOTREACHED();
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+// The maximum number of iovecs needed for one message passed to
+// SendMessageBatch().
+constexpr size_t kMaxIovecsPerMessage = 2;
+
+size_t GetMessageSize(const ByteView& message) {
+  return message.size();
+}
+
+size_t GetMessageSize(const UdpSocket::GatheredMessage& message) {
+  return message.size();
+}
+
+iovec ToIovec(ByteView data) {
+  return {const_cast<uint8_t*>(data.data()), data.size()};
+}
+
+// Fills `iovecs` with the non-empty parts of `message`, returning how many
+// were used.
+size_t FillIovecs(const ByteView& message, iovec* iovecs) {
+  iovecs[0] = ToIovec(message);
+  return 1;
+}
+
+size_t FillIovecs(const UdpSocket::GatheredMessage& message, iovec* iovecs) {
+  size_t count = 0;
+  if (!message.header.empty()) {
+    iovecs[count++] = ToIovec(message.header);
+  }
+  if (!message.payload.empty() || count == 0) {
+    iovecs[count++] = ToIovec(message.payload);
+  }
+  return count;
+}
+
+// Returns the number of messages at the front of `messages` that can be sent as
+// one UDP_SEGMENT send: a run of messages of the same size, optionally followed
+// by one smaller message.
+template <typename Message>
+size_t CountSegmentableMessages(std::span<const Message> messages) {
+  const size_t segment_size = GetMessageSize(messages.front());
+  if (segment_size == 0) {
+    return 1;
+  }
+
+  size_t count = 0;
+  size_t total_size = 0;
+  for (const Message& message : messages) {
+    const size_t message_size = GetMessageSize(message);
+    if (message_size == 0 || message_size > segment_size ||
+        total_size + message_size > kMaxSegmentedPayloadSize) {
+      break;
+    }
+    total_size += message_size;
+    ++count;
+    if (message_size < segment_size) {
       break;
     }
   }
-  return std::move(packet);
+  return count;
 }
+#endif
 
 }  // namespace
 
@@ -490,15 +735,60 @@ void UdpSocketPosix::ReceiveMessage() {
     return;
   }
 
+  const size_t batch_size = receive_batch_size_.load(std::memory_order_relaxed);
+  if (batch_size > 1) {
+    ReceiveMessageBatch(batch_size);
+    return;
+  }
+
+  const ErrorOr<uint16_t> local_port = GetBoundPort();
   ErrorOr<UdpPacket> read_result = Error::Code::kUnknownError;
   switch (local_endpoint_.address.version()) {
     case UdpSocket::Version::kV4: {
-      read_result = ReceiveMessageInternal<sockaddr_in, in_pktinfo>(handle_.fd);
+      read_result = ReceiveMessageInternal<sockaddr_in, in_pktinfo>(
+          handle_.fd, local_port, packet_pool_.get());
+      break;
+    }
+    case UdpSocket::Version::kV6: {
+      read_result = ReceiveMessageInternal<sockaddr_in6, in6_pktinfo>(
+          handle_.fd, local_port, packet_pool_.get());
+      break;
+    }
+    default: {
+      OSP_NOTREACHED();
+    }
+  }
+
+  PostReadResult(std::move(read_result));
+}
+
+void UdpSocketPosix::ReceiveMessageBatch(size_t max_packets) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  const ErrorOr<uint16_t> local_port = GetBoundPort();
+  if (local_port.is_error()) {
+    PostReadResult(local_port.error());
+    return;
+  }
+
+  if (!receive_batch_buffers_ ||
+      receive_batch_buffers_->capacity() != max_packets) {
+    receive_batch_buffers_ = std::make_unique<ReceiveBatchBuffers>(
+        max_packets, packet_pool_ ? packet_pool_->min_buffer_capacity()
+                                  : kDefaultBatchPacketSize);
+  }
+
+  ErrorOr<std::vector<UdpPacket>> read_result = Error::Code::kUnknownError;
+  switch (local_endpoint_.address.version()) {
+    case UdpSocket::Version::kV4: {
+      read_result = ReceiveMessageBatchInternal<sockaddr_in, in_pktinfo>(
+          handle_.fd, local_port.value(), *receive_batch_buffers_,
+          packet_pool_.get());
       break;
     }
     case UdpSocket::Version::kV6: {
-      read_result =
-          ReceiveMessageInternal<sockaddr_in6, in6_pktinfo>(handle_.fd);
+      read_result = ReceiveMessageBatchInternal<sockaddr_in6, in6_pktinfo>(
+          handle_.fd, local_port.value(), *receive_batch_buffers_,
+          packet_pool_.get());
       break;
     }
     default: {
@@ -506,8 +796,60 @@ void UdpSocketPosix::ReceiveMessage() {
     }
   }
 
+  if (read_result.is_error()) {
+    PostReadResult(std::move(read_result.error()));
+    return;
+  }
+
+  // Every datagram read may have been dropped for being truncated, in which
+  // case there is nothing to tell the client about.
+  if (read_result.value().empty()) {
+    return;
+  }
+
+  task_runner_->PostTask([weak_this = weak_factory_.GetWeakPtr(),
+                          packets = std::move(read_result.value())]() mutable {
+    if (auto* self = weak_this.get()) {
+      if (auto* client = self->client_.get()) {
+        client->OnReadBatch(self, std::move(packets));
+      }
+    }
+  });
+#else
+  OSP_NOTREACHED();
+#endif
+}
+
+ErrorOr<uint16_t> UdpSocketPosix::GetBoundPort() {
+  const uint16_t cached_port = bound_port_.load(std::memory_order_relaxed);
+  if (cached_port != 0) {
+    return cached_port;
+  }
+
+  sockaddr_storage sa{};
+  socklen_t sa_len = sizeof(sa);
+  if (getsockname(handle_.fd, reinterpret_cast<sockaddr*>(&sa), &sa_len) ==
+      -1) {
+    return Error(Error::Code::kSocketReadFailure, "Failed to get socket name");
+  }
+
+  uint16_t port = 0;
+  if (sa.ss_family == AF_INET) {
+    port = GetPortFromFromSockAddr(reinterpret_cast<const sockaddr_in&>(sa));
+  } else if (sa.ss_family == AF_INET6) {
+    port = GetPortFromFromSockAddr(reinterpret_cast<const sockaddr_in6&>(sa));
+  }
+
+  // Only cache the port once the socket has actually been bound.
+  if (port != 0) {
+    bound_port_.store(port, std::memory_order_relaxed);
+  }
+  return port;
+}
+
+void UdpSocketPosix::PostReadResult(ErrorOr<UdpPacket> result) {
   task_runner_->PostTask([weak_this = weak_factory_.GetWeakPtr(),
-                          result = std::move(read_result)]() mutable {
+                          result = std::move(result)]() mutable {
     if (auto* self = weak_this.get()) {
       if (auto* client = self->client_.get()) {
         client->OnRead(self, std::move(result));
@@ -527,43 +869,17 @@ void UdpSocketPosix::SendMessage(ByteView data, const IPEndpoint& dest) {
 
   struct iovec iov = {
       reinterpret_cast<void*>(const_cast<uint8_t*>(data.data())), data.size()};
+  sockaddr_storage sa;
   struct msghdr msg {};
+  msg.msg_name = &sa;
+  msg.msg_namelen = ToSockAddr(dest, &sa);
   msg.msg_iov = &iov;
   msg.msg_iovlen = 1;
   msg.msg_control = nullptr;
   msg.msg_controllen = 0;
   msg.msg_flags = 0;
 
-  ssize_t num_bytes_sent = -2;
-  switch (dest.address.version()) {
-    case UdpSocket::Version::kV4: {
-      struct sockaddr_in sa {};
-      sa.sin_family = AF_INET;
-      sa.sin_port = htons(dest.port);
-      dest.address.CopyTo(std::span<uint8_t>(
-          reinterpret_cast<uint8_t*>(&sa.sin_addr.s_addr), 4));
-      msg.msg_name = &sa;
-      msg.msg_namelen = sizeof(sa);
-      num_bytes_sent = sendmsg(handle_.fd, &msg, 0);
-      break;
-    }
-
-    case UdpSocket::Version::kV6: {
-      struct sockaddr_in6 sa {};
-      sa.sin6_family = AF_INET6;
-      sa.sin6_port = htons(dest.port);
-      dest.address.CopyTo(std::span<uint8_t>(
-          reinterpret_cast<uint8_t*>(&sa.sin6_addr.s6_addr), 16));
-      if (dest.address.IsLinkLocal() && dest.address.GetScopeId() != 0) {
-        sa.sin6_scope_id = dest.address.GetScopeId();
-      }
-      msg.msg_name = &sa;
-      msg.msg_namelen = sizeof(sa);
-      num_bytes_sent = sendmsg(handle_.fd, &msg, 0);
-      break;
-    }
-  }
-
+  const ssize_t num_bytes_sent = sendmsg(handle_.fd, &msg, 0);
   if (num_bytes_sent == -1) {
     if (client_) {
       client_->OnSendError(this,
@@ -576,6 +892,152 @@ void UdpSocketPosix::SendMessage(ByteView data, const IPEndpoint& dest) {
   OSP_CHECK_EQ(static_cast<size_t>(num_bytes_sent), data.size());
 }
 
+void UdpSocketPosix::SendMessages(std::span<const ByteView> messages,
+                                  const IPEndpoint& dest) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  SendMessagesInBatches(messages, dest);
+#else
+  UdpSocket::SendMessages(messages, dest);
+#endif
+}
+
+void UdpSocketPosix::SendGatheredMessages(
+    std::span<const GatheredMessage> messages,
+    const IPEndpoint& dest) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  SendMessagesInBatches(messages, dest);
+#else
+  UdpSocket::SendGatheredMessages(messages, dest);
+#endif
+}
+
+template <typename Message>
+void UdpSocketPosix::SendMessagesInBatches(std::span<const Message> messages,
+                                           const IPEndpoint& dest) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
+  if (is_closed()) {
+    if (client_) {
+      client_->OnSendError(this, Error::Code::kSocketClosedFailure);
+    }
+    return;
+  }
+
+  sockaddr_storage sa;
+  const socklen_t sa_len = ToSockAddr(dest, &sa);
+  while (!messages.empty()) {
+    const ErrorOr<size_t> num_sent = SendMessageBatch(
+        messages, reinterpret_cast<const sockaddr*>(&sa), sa_len);
+    if (num_sent.is_error()) {
+      // Drop the rest of the messages, since they would most likely fail for
+      // the same reason.
+      if (client_) {
+        client_->OnSendError(this, num_sent.error());
+      }
+      return;
+    }
+    messages = messages.subspan(num_sent.value());
+  }
+#else
+  OSP_NOTREACHED();
+#endif
+}
+
+template <typename Message>
+ErrorOr<size_t> UdpSocketPosix::SendMessageBatch(
+    std::span<const Message> messages,
+    const sockaddr* dest,
+    socklen_t dest_len) {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  // Each mmsghdr is either a single message, or a run of messages coalesced
+  // into one UDP_SEGMENT send. Either way, the parts of each message get their
+  // own iovecs, and the kernel gathers them.
+  using SegmentControlBuffer =
+      std::array<uint8_t, CMSG_SPACE(sizeof(uint16_t))>;
+  std::array<mmsghdr, kMaxMessagesPerSend> headers;
+  std::array<iovec, kMaxMessagesPerSend * kMaxIovecsPerMessage> iovecs;
+  std::array<size_t, kMaxMessagesPerSend> messages_per_header;
+  alignas(cmsghdr) std::array<SegmentControlBuffer, kMaxMessagesPerSend>
+      control_buffers;
+
+  messages = messages.first(std::min(messages.size(), kMaxMessagesPerSend));
+  const bool use_segmentation = IsSegmentationOffloadSupported();
+  size_t num_headers = 0;
+  size_t num_messages = 0;
+  size_t num_iovecs = 0;
+  while (num_messages < messages.size()) {
+    const std::span<const Message> remaining = messages.subspan(num_messages);
+    const size_t run_length =
+        use_segmentation ? CountSegmentableMessages(remaining) : 1;
+
+    const size_t first_iovec = num_iovecs;
+    for (size_t i = 0; i < run_length; ++i) {
+      num_iovecs += FillIovecs(remaining[i], &iovecs[num_iovecs]);
+    }
+
+    msghdr& msg = headers[num_headers].msg_hdr;
+    msg = {};
+    msg.msg_name = const_cast<sockaddr*>(dest);
+    msg.msg_namelen = dest_len;
+    msg.msg_iov = &iovecs[first_iovec];
+    msg.msg_iovlen = num_iovecs - first_iovec;
+    if (run_length > 1) {
+      SegmentControlBuffer& control = control_buffers[num_headers];
+      msg.msg_control = control.data();
+      msg.msg_controllen = control.size();
+      cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+      cmsg->cmsg_level = IPPROTO_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      const uint16_t segment_size =
+          static_cast<uint16_t>(GetMessageSize(remaining[0]));
+      memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+    }
+
+    messages_per_header[num_headers++] = run_length;
+    num_messages += run_length;
+  }
+
+  const int num_headers_sent =
+      sendmmsg(handle_.fd, headers.data(), num_headers, 0);
+  if (num_headers_sent == -1) {
+    // A segmented send may fail if the route's device cannot checksum the
+    // segments, or if the kernel rejects the option. Stop using it, and have
+    // the caller retry the same messages without it.
+    if (messages_per_header[0] > 1 &&
+        (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT)) {
+      OSP_DVLOG << "Disabling UDP segmentation offload: " << strerror(errno);
+      segmentation_offload_supported_ = false;
+      return size_t{0};
+    }
+    return ChooseError(errno, Error::Code::kSocketSendFailure);
+  }
+
+  size_t num_messages_sent = 0;
+  for (int i = 0; i < num_headers_sent; ++i) {
+    num_messages_sent += messages_per_header[i];
+  }
+  return num_messages_sent;
+#else
+  OSP_NOTREACHED();
+#endif
+}
+
+bool UdpSocketPosix::IsSegmentationOffloadSupported() {
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  if (!segmentation_offload_supported_) {
+    int segment_size = 0;
+    socklen_t length = sizeof(segment_size);
+    segmentation_offload_supported_ =
+        getsockopt(handle_.fd, IPPROTO_UDP, UDP_SEGMENT, &segment_size,
+                   &length) == 0;
+  }
+  return *segmentation_offload_supported_;
+#else
+  return false;
+#endif
+}
+
 void UdpSocketPosix::SetDscp(UdpSocket::DscpMode mode) {
   OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
   if (is_closed()) {
@@ -646,6 +1108,20 @@ void UdpSocketPosix::SetSendBufferSize(size_t size) {
   }
 }
 
+void UdpSocketPosix::SetReceiveBatchSize(size_t max_packets) {
+  OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+  receive_batch_size_.store(
+      std::clamp<size_t>(max_packets, 1, kMaxReceiveBatchSize),
+      std::memory_order_relaxed);
+#endif
+}
+
+void UdpSocketPosix::SetPacketPool(std::shared_ptr<UdpPacketPool> pool) {
+  OSP_CHECK(task_runner_->IsRunningOnTaskRunner());
+  packet_pool_ = std::move(pool);
+}
+
 void UdpSocketPosix::OnError(Error::Code error_code) {
   // The call to Close() may change `errno`, so save it here.
   const auto original_errno = errno;
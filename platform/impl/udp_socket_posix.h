@@ -5,6 +5,12 @@
 #ifndef PLATFORM_IMPL_UDP_SOCKET_POSIX_H_
 #define PLATFORM_IMPL_UDP_SOCKET_POSIX_H_
 
+#include <sys/socket.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
 #include "platform/api/udp_socket.h"
 #include "platform/impl/platform_client_posix.h"
 #include "platform/impl/socket_handle_posix.h"
@@ -14,6 +20,7 @@
 
 namespace openscreen {
 
+class ReceiveBatchBuffers;
 class UdpSocketReaderPosix;
 
 // Threading: All public methods must be called on the same thread--the one
@@ -44,12 +51,21 @@ class UdpSocketPosix : public UdpSocket {
   void JoinMulticastGroup(const IPAddress& address,
                           NetworkInterfaceIndex ifindex) override;
   void SendMessage(ByteView data, const IPEndpoint& dest) override;
+  void SendMessages(std::span<const ByteView> messages,
+                    const IPEndpoint& dest) override;
+  void SendGatheredMessages(std::span<const GatheredMessage> messages,
+                            const IPEndpoint& dest) override;
   void SetDscp(DscpMode mode) override;
   void SetReceiveBufferSize(size_t size) override;
   void SetSendBufferSize(size_t size) override;
+  void SetReceiveBatchSize(size_t max_packets) override;
+  void SetPacketPool(std::shared_ptr<UdpPacketPool> pool) override;
 
   const SocketHandle& GetHandle() const;
 
+  // Upper bound for SetReceiveBatchSize().
+  static constexpr size_t kMaxReceiveBatchSize = 32;
+
  protected:
   friend class UdpSocketReaderPosix;
 
@@ -66,6 +82,38 @@ class UdpSocketPosix : public UdpSocket {
   bool is_closed() const { return handle_.fd < 0; }
   void Close();
 
+  // Reads up to `max_packets` datagrams with a single recvmmsg() call and
+  // dispatches all of them to the `client_` in one task. Like
+  // ReceiveMessage(), this may be called from another thread.
+  void ReceiveMessageBatch(size_t max_packets);
+
+  // Returns the port the socket is bound to, which is looked up once and then
+  // cached, since it cannot change after Bind(). Like ReceiveMessage(), this
+  // may be called from another thread.
+  ErrorOr<uint16_t> GetBoundPort();
+
+  // Posts a task dispatching `result` to the `client_`.
+  void PostReadResult(ErrorOr<UdpPacket> result);
+
+  // Sends all of `messages` to `dest` with as few sendmmsg() calls as possible.
+  // `Message` is either a ByteView or a GatheredMessage.
+  template <typename Message>
+  void SendMessagesInBatches(std::span<const Message> messages,
+                             const IPEndpoint& dest);
+
+  // Sends a prefix of `messages` to `dest` with a single sendmmsg() call,
+  // coalescing runs of same-sized messages with UDP_SEGMENT where supported.
+  // Returns the number of messages sent, which is zero if the call must be
+  // retried because segmentation offload turned out to be unavailable.
+  template <typename Message>
+  ErrorOr<size_t> SendMessageBatch(std::span<const Message> messages,
+                                   const sockaddr* dest,
+                                   socklen_t dest_len);
+
+  // Returns true if the kernel supports UDP_SEGMENT (generic segmentation
+  // offload) on this socket.
+  bool IsSegmentationOffloadSupported();
+
   // Task runner to use for queuing `client_` callbacks.
   const raw_ref<TaskRunner> task_runner_;
 
@@ -82,6 +130,27 @@ class UdpSocketPosix : public UdpSocket {
   // port is non-zero, it is assumed never to change again.
   mutable IPEndpoint local_endpoint_;
 
+  // The port used for received packets' destination endpoints, or zero if not
+  // yet known. Unlike `local_endpoint_`, this is safe to access from the
+  // thread calling ReceiveMessage().
+  std::atomic<uint16_t> bound_port_{0};
+
+  // Maximum number of datagrams read per ReceiveMessage() call. Set on the
+  // TaskRunner thread and read from the thread calling ReceiveMessage().
+  std::atomic<size_t> receive_batch_size_{1};
+
+  // Preallocated storage for batched reads, lazily (re)created by
+  // ReceiveMessageBatch() and only accessed from that method.
+  std::unique_ptr<ReceiveBatchBuffers> receive_batch_buffers_;
+
+  // If set, received packets are acquired from this pool. Only set before
+  // Bind(), so it is never modified while ReceiveMessage() may be running.
+  std::shared_ptr<UdpPacketPool> packet_pool_;
+
+  // Whether UDP_SEGMENT can be used by SendMessageBatch(), or nullopt if not
+  // yet probed. Set to false if a segmented send ever fails.
+  std::optional<bool> segmentation_offload_supported_;
+
   WeakPtrFactory<UdpSocketPosix> weak_factory_{this};
 
   const raw_ptr<PlatformClientPosix> platform_client_;
@@ -8,10 +8,13 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "build/build_config.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "platform/api/time.h"
+#include "platform/base/inline_task.h"
 #include "platform/test/fake_clock.h"
 #include "platform/test/fake_task_runner.h"
 #include "platform/test/fake_udp_socket.h"
@@ -20,6 +23,242 @@ namespace openscreen {
 namespace {
 
 using testing::_;
+using testing::ElementsAre;
+
+// Exposes ReceiveMessage(), which is normally only called by the
+// UdpSocketReaderPosix.
+class TestingUdpSocketPosix : public UdpSocketPosix {
+ public:
+  TestingUdpSocketPosix(TaskRunner& task_runner, Client* client, int fd)
+      : UdpSocketPosix(task_runner,
+                       client,
+                       SocketHandle(fd),
+                       IPEndpoint{IPAddress(127, 0, 0, 1), 0},
+                       /* platform_client */ nullptr) {}
+
+  using UdpSocketPosix::ReceiveMessage;
+};
+
+// Records every packet received, along with the size of each batch that it
+// was delivered in.
+class RecordingClient : public UdpSocket::Client {
+ public:
+  void OnError(UdpSocket* socket, const Error& error) override {
+    ADD_FAILURE() << error;
+  }
+  void OnSendError(UdpSocket* socket, const Error& error) override {
+    ADD_FAILURE() << error;
+  }
+  void OnRead(UdpSocket* socket, ErrorOr<UdpPacket> packet) override {
+    ASSERT_TRUE(packet) << packet.error();
+    batch_sizes.push_back(1);
+    packets.push_back(std::move(packet.value()));
+  }
+  void OnReadBatch(UdpSocket* socket, std::vector<UdpPacket> batch) override {
+    batch_sizes.push_back(batch.size());
+    for (UdpPacket& packet : batch) {
+      packets.push_back(std::move(packet));
+    }
+  }
+
+  std::vector<size_t> batch_sizes;
+  std::vector<UdpPacket> packets;
+};
+
+class UdpSocketPosixReceiveTest : public testing::Test {
+ protected:
+  UdpSocketPosixReceiveTest() : clock_(Clock::now()), task_runner_(clock_) {
+    receiver_ = std::make_unique<TestingUdpSocketPosix>(
+        task_runner_, &receiver_client_,
+        socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0));
+    receiver_->Bind();
+    sender_ = std::make_unique<TestingUdpSocketPosix>(
+        task_runner_, &sender_client_,
+        socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0));
+    sender_->Bind();
+  }
+
+  void SendPackets(int count) {
+    for (int i = 0; i < count; ++i) {
+      const uint8_t payload[] = {static_cast<uint8_t>(i), 0xab};
+      sender_->SendMessage(payload, receiver_->GetLocalEndpoint());
+    }
+  }
+
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  RecordingClient receiver_client_;
+  RecordingClient sender_client_;
+  std::unique_ptr<TestingUdpSocketPosix> receiver_;
+  std::unique_ptr<TestingUdpSocketPosix> sender_;
+};
+
+TEST_F(UdpSocketPosixReceiveTest, ReceivesOnePacketPerReadByDefault) {
+  SendPackets(3);
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+
+  EXPECT_THAT(receiver_client_.batch_sizes, ElementsAre(1));
+  ASSERT_EQ(receiver_client_.packets.size(), 1u);
+  EXPECT_THAT(receiver_client_.packets[0], ElementsAre(0, 0xab));
+  EXPECT_EQ(receiver_client_.packets[0].source(), sender_->GetLocalEndpoint());
+}
+
+TEST_F(UdpSocketPosixReceiveTest, AcquiresPacketsFromPool) {
+  auto pool = UdpPacketPool::Create(/* max_free_buffers */ 4,
+                                    /* min_buffer_capacity */ 1500);
+  receiver_->SetPacketPool(pool);
+  SendPackets(1);
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+
+  ASSERT_EQ(receiver_client_.packets.size(), 1u);
+  EXPECT_TRUE(receiver_client_.packets[0].is_pooled());
+  EXPECT_THAT(receiver_client_.packets[0], ElementsAre(0, 0xab));
+
+  receiver_client_.packets.clear();
+  const UdpPacketPool::Stats stats = pool->GetStats();
+  EXPECT_EQ(stats.packets_acquired, 1u);
+  EXPECT_EQ(stats.buffers_recycled, 1u);
+}
+
+// Posting a received packet to the TaskRunner must not allocate: the task's
+// captures, including the UdpPacket itself, fit inside the InlineTask.
+TEST_F(UdpSocketPosixReceiveTest, PostsReceivedPacketWithoutAllocatingTask) {
+  receiver_->SetPacketPool(UdpPacketPool::Create(
+      /* max_free_buffers */ 4, /* min_buffer_capacity */ 1500));
+  SendPackets(3);
+
+  const uint64_t heap_allocations = InlineTask::GetHeapAllocationCount();
+  for (int i = 0; i < 3; ++i) {
+    receiver_->ReceiveMessage();
+  }
+  task_runner_.RunTasksUntilIdle();
+  EXPECT_EQ(InlineTask::GetHeapAllocationCount(), heap_allocations);
+  EXPECT_EQ(receiver_client_.packets.size(), 3u);
+}
+
+#if BUILDFLAG(IS_LINUX) || BUILDFLAG(IS_CHROMEOS) || BUILDFLAG(IS_ANDROID)
+TEST_F(UdpSocketPosixReceiveTest, ReceivesBatchInOneTask) {
+  receiver_->SetReceiveBatchSize(8);
+  SendPackets(5);
+  receiver_->ReceiveMessage();
+  EXPECT_EQ(task_runner_.ready_task_count(), 1);
+  task_runner_.RunTasksUntilIdle();
+
+  EXPECT_THAT(receiver_client_.batch_sizes, ElementsAre(5));
+  ASSERT_EQ(receiver_client_.packets.size(), 5u);
+  for (size_t i = 0; i < receiver_client_.packets.size(); ++i) {
+    const UdpPacket& packet = receiver_client_.packets[i];
+    EXPECT_THAT(packet, ElementsAre(i, 0xab));
+    EXPECT_EQ(packet.source(), sender_->GetLocalEndpoint());
+  }
+}
+
+TEST_F(UdpSocketPosixReceiveTest, SendsMessagesInOrder) {
+  // A mix of same-sized messages, which may be coalesced into one segmented
+  // send, and differently-sized ones, which may not.
+  const std::vector<std::vector<uint8_t>> payloads = {
+      std::vector<uint8_t>(100, 1), std::vector<uint8_t>(100, 2),
+      std::vector<uint8_t>(100, 3), std::vector<uint8_t>(40, 4),
+      std::vector<uint8_t>(200, 5), std::vector<uint8_t>(10, 6)};
+  std::vector<ByteView> messages(payloads.begin(), payloads.end());
+  sender_->SendMessages(messages, receiver_->GetLocalEndpoint());
+
+  receiver_->SetReceiveBatchSize(UdpSocketPosix::kMaxReceiveBatchSize);
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+
+  ASSERT_EQ(receiver_client_.packets.size(), payloads.size());
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    EXPECT_THAT(receiver_client_.packets[i],
+                testing::ElementsAreArray(payloads[i]));
+  }
+}
+
+TEST_F(UdpSocketPosixReceiveTest, SendsGatheredMessagesInOrder) {
+  // Same-sized messages split differently between header and payload may still
+  // be coalesced, since only the total size of each message matters.
+  const std::vector<uint8_t> header(12, 0xaa);
+  const std::vector<uint8_t> payload(100, 0xbb);
+  const ByteView payload_view(payload);
+  const std::vector<UdpSocket::GatheredMessage> messages = {
+      {header, payload_view.first(88)},
+      {header, payload_view.first(88)},
+      {ByteView(), payload_view},
+      {header, ByteView()},
+      {header, payload_view}};
+  sender_->SendGatheredMessages(messages, receiver_->GetLocalEndpoint());
+
+  receiver_->SetReceiveBatchSize(UdpSocketPosix::kMaxReceiveBatchSize);
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+
+  ASSERT_EQ(receiver_client_.packets.size(), messages.size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    std::vector<uint8_t> expected(messages[i].header.begin(),
+                                  messages[i].header.end());
+    expected.insert(expected.end(), messages[i].payload.begin(),
+                    messages[i].payload.end());
+    EXPECT_THAT(receiver_client_.packets[i],
+                testing::ElementsAreArray(expected));
+  }
+}
+
+TEST_F(UdpSocketPosixReceiveTest, BatchIsLimitedToBatchSize) {
+  receiver_->SetReceiveBatchSize(2);
+  SendPackets(5);
+  receiver_->ReceiveMessage();
+  receiver_->ReceiveMessage();
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+
+  EXPECT_THAT(receiver_client_.batch_sizes, ElementsAre(2, 2, 1));
+  EXPECT_EQ(receiver_client_.packets.size(), 5u);
+}
+
+TEST_F(UdpSocketPosixReceiveTest, BatchIsReceivedIntoPooledPackets) {
+  auto pool = UdpPacketPool::Create(/* max_free_buffers */ 8,
+                                    /* min_buffer_capacity */ 1500);
+  receiver_->SetPacketPool(pool);
+  receiver_->SetReceiveBatchSize(4);
+  SendPackets(3);
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+
+  ASSERT_EQ(receiver_client_.packets.size(), 3u);
+  for (size_t i = 0; i < receiver_client_.packets.size(); ++i) {
+    EXPECT_TRUE(receiver_client_.packets[i].is_pooled());
+    EXPECT_THAT(receiver_client_.packets[i], ElementsAre(i, 0xab));
+  }
+
+  // Only the packets handed out are replaced for the next read.
+  EXPECT_EQ(pool->GetStats().packets_acquired, 4u);
+  SendPackets(1);
+  receiver_->ReceiveMessage();
+  EXPECT_EQ(pool->GetStats().packets_acquired, 7u);
+}
+
+TEST_F(UdpSocketPosixReceiveTest, BatchReceivesDatagramsLargerThanPackets) {
+  receiver_->SetPacketPool(UdpPacketPool::Create(
+      /* max_free_buffers */ 8, /* min_buffer_capacity */ 1500));
+  receiver_->SetReceiveBatchSize(4);
+  std::vector<uint8_t> large_payload(4000);
+  for (size_t i = 0; i < large_payload.size(); ++i) {
+    large_payload[i] = static_cast<uint8_t>(i);
+  }
+  const uint8_t small_payload[] = {1, 2, 3};
+  sender_->SendMessage(large_payload, receiver_->GetLocalEndpoint());
+  sender_->SendMessage(small_payload, receiver_->GetLocalEndpoint());
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+
+  ASSERT_EQ(receiver_client_.packets.size(), 2u);
+  EXPECT_THAT(receiver_client_.packets[0],
+              testing::ElementsAreArray(large_payload));
+  EXPECT_THAT(receiver_client_.packets[1], ElementsAre(1, 2, 3));
+}
+#endif
 
 TEST(UdpSocketPosixTest, SetsBufferSizes) {
   const uint8_t kIpV4AddrAny[4] = {};
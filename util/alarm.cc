@@ -5,6 +5,7 @@
 #include "util/alarm.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "util/osp_logging.h"
 
@@ -67,14 +68,12 @@ Alarm::Alarm(ClockNowFunctionPtr now_function, TaskRunner& task_runner)
 }
 
 Alarm::~Alarm() {
-  if (queued_fire_) {
-    queued_fire_->Cancel();
-    OSP_CHECK(!queued_fire_);
-  }
+  CancelQueuedFire();
 }
 
 void Alarm::Cancel() {
   scheduled_task_ = TaskRunner::Task();
+  CancelQueuedFire();
 }
 
 void Alarm::ScheduleWithTask(TaskRunner::Task task,
@@ -91,8 +90,7 @@ void Alarm::ScheduleWithTask(TaskRunner::Task task,
     if (next_fire_time_ <= alarm_time_) {
       return;
     }
-    queued_fire_->Cancel();
-    OSP_CHECK(!queued_fire_);
+    CancelQueuedFire();
   }
   InvokeLater(now, alarm_time_);
 }
@@ -101,7 +99,19 @@ void Alarm::InvokeLater(Clock::time_point now, Clock::time_point fire_time) {
   OSP_CHECK(!queued_fire_);
   next_fire_time_ = fire_time;
   // Note: Instantiating the CancelableFunctor below sets |this->queued_fire_|.
-  task_runner_->PostTaskWithDelay(CancelableFunctor(this), fire_time - now);
+  queued_fire_id_ = task_runner_->PostCancelableTaskWithDelay(
+      CancelableFunctor(this), fire_time - now);
+}
+
+void Alarm::CancelQueuedFire() {
+  if (!queued_fire_) {
+    return;
+  }
+  queued_fire_->Cancel();
+  OSP_CHECK(!queued_fire_);
+  // The functor is now a no-op. Removing it saves the TaskRunner from holding
+  // it, and waking up to run it, until its fire time.
+  task_runner_->CancelDelayedTask(std::exchange(queued_fire_id_, 0));
 }
 
 void Alarm::TryInvoke() {
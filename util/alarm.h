@@ -82,6 +82,10 @@ class Alarm {
   // Posts a delayed call to TryInvoke() to the TaskRunner.
   void InvokeLater(Clock::time_point now, Clock::time_point fire_time);
 
+  // Turns the queued call to TryInvoke(), if any, into a no-op, and removes it
+  // from the TaskRunner's queue if the TaskRunner supports canceling tasks.
+  void CancelQueuedFire();
+
   // Examines whether to invoke the client's Task now; or try again later; or
   // just do nothing. See class-level design comments.
   void TryInvoke();
@@ -99,6 +103,10 @@ class Alarm {
   // by the CancelableFunctor class methods.
   raw_ptr<CancelableFunctor> queued_fire_;
 
+  // Identifies the task holding `queued_fire_` in the TaskRunner's queue, or is
+  // zero if the TaskRunner cannot cancel it.
+  TaskRunner::DelayedTaskId queued_fire_id_ = 0;
+
   // When the CancelableFunctor is scheduled to run. It may possibly execute
   // later than this, if the TaskRunner is falling behind.
   Clock::time_point next_fire_time_{};
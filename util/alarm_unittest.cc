@@ -6,7 +6,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <utility>
+#include <vector>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "platform/test/fake_clock.h"
 #include "platform/test/fake_task_runner.h"
@@ -145,5 +148,59 @@ TEST_F(AlarmTest, CancelsAndRearms) {
   }
 }
 
+// A FakeTaskRunner that hands out ids for delayed tasks, and records which ones
+// are canceled. The canceled tasks stay queued, and run as no-ops.
+class CancelRecordingTaskRunner : public FakeTaskRunner {
+ public:
+  using FakeTaskRunner::FakeTaskRunner;
+
+  const std::vector<DelayedTaskId>& canceled_ids() const {
+    return canceled_ids_;
+  }
+
+  // TaskRunner overrides.
+  DelayedTaskId PostCancelablePackagedTaskWithDelay(
+      Task task,
+      Clock::duration delay) override {
+    PostPackagedTaskWithDelay(std::move(task), delay);
+    return ++last_id_;
+  }
+  bool CancelDelayedTask(DelayedTaskId id) override {
+    canceled_ids_.push_back(id);
+    return false;
+  }
+
+ private:
+  DelayedTaskId last_id_ = 0;
+  std::vector<DelayedTaskId> canceled_ids_;
+};
+
+TEST(AlarmCancelationTest, CancelsQueuedFiresInTaskRunner) {
+  constexpr Clock::duration kDelay = milliseconds(20);
+  FakeClock clock(Clock::now());
+  CancelRecordingTaskRunner task_runner(clock);
+  int count = 0;
+  {
+    Alarm alarm(&FakeClock::now, task_runner);
+
+    // Re-arming later reuses the queued fire, but re-arming sooner replaces it.
+    alarm.ScheduleFromNow([&] { ++count; }, kDelay);
+    alarm.ScheduleFromNow([&] { ++count; }, kDelay * 2);
+    EXPECT_TRUE(task_runner.canceled_ids().empty());
+    alarm.ScheduleFromNow([&] { ++count; }, kDelay / 2);
+    EXPECT_THAT(task_runner.canceled_ids(), testing::ElementsAre(1u));
+
+    alarm.Cancel();
+    EXPECT_THAT(task_runner.canceled_ids(), testing::ElementsAre(1u, 2u));
+
+    // Destroying the Alarm cancels the fire queued for this task.
+    alarm.ScheduleFromNow([&] { ++count; }, kDelay);
+  }
+  EXPECT_THAT(task_runner.canceled_ids(), testing::ElementsAre(1u, 2u, 3u));
+
+  clock.Advance(kDelay * 100);
+  EXPECT_EQ(0, count);
+}
+
 }  // namespace
 }  // namespace openscreen
@@ -21,14 +21,30 @@ void BitVector::Resize(size_t size, Fill fill) {
   }
 }
 
-size_t BitVector::FindFirstSet() const {
-  for (size_t i = 0; i < v_.size(); ++i) {
-    if (v_[i] != 0) {
-      size_t pos = i * kBitsPerWord + std::countr_zero(v_[i]);
+void BitVector::SetAll() {
+  std::fill(v_.begin(), v_.end(), ~uint64_t{0});
+  if (size_ % kBitsPerWord != 0) {
+    v_.back() &= (uint64_t{1} << (size_ % kBitsPerWord)) - 1;
+  }
+}
+
+size_t BitVector::FindNextSet(size_t from) const {
+  if (from >= size_) {
+    return size_;
+  }
+  size_t i = from / kBitsPerWord;
+  // Mask-off the bits before `from` in its word.
+  uint64_t word = v_[i] & (~uint64_t{0} << (from % kBitsPerWord));
+  while (true) {
+    if (word != 0) {
+      const size_t pos = i * kBitsPerWord + std::countr_zero(word);
       return (pos < size_) ? pos : size_;
     }
+    if (++i == v_.size()) {
+      return size_;
+    }
+    word = v_[i];
   }
-  return size_;
 }
 
 }  // namespace openscreen
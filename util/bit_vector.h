@@ -52,7 +52,16 @@ class BitVector {
     return (v_[pos / kBitsPerWord] >> (pos % kBitsPerWord)) & 1;
   }
 
-  [[nodiscard]] size_t FindFirstSet() const;
+  // Sets all of the bits at once, one word at a time.
+  void SetAll();
+
+  // Returns the position of the first bit set, or size() if none are set.
+  [[nodiscard]] size_t FindFirstSet() const { return FindNextSet(0); }
+
+  // Returns the position of the first bit set at or after `from`, or size() if
+  // none are. Only the words from the one containing `from` are scanned, so
+  // callers that track a lower bound for the bits set can skip the rest.
+  [[nodiscard]] size_t FindNextSet(size_t from) const;
 
  private:
   static constexpr size_t kBitsPerWord = std::numeric_limits<uint64_t>::digits;
@@ -131,5 +131,41 @@ TEST(BitVectorTest, FindsTheFirstBitSet) {
   }
 }
 
+// Tests the FindNextSet() operation, for various vector sizes, bit patterns
+// and starting positions.
+TEST(BitVectorTest, FindsTheNextBitSet) {
+  BitVector v;
+  for (size_t size : kTestSizes) {
+    v.Resize(size, BitVector::CLEARED);
+    for (uint8_t pattern : kBitPatterns) {
+      FillWithPattern(pattern, 0, &v);
+      for (size_t from = 0; from <= size + 1; ++from) {
+        size_t expected = from;
+        while (expected < size && !IsSetInPattern(pattern, expected)) {
+          ++expected;
+        }
+        ASSERT_EQ(std::min(expected, size), v.FindNextSet(from));
+      }
+    }
+  }
+}
+
+// Tests that SetAll() sets every bit, and only those within the vector.
+TEST(BitVectorTest, SetsAllBits) {
+  BitVector v;
+  for (size_t size : kTestSizes) {
+    v.Resize(size, BitVector::CLEARED);
+    v.SetAll();
+    for (size_t i = 0; i < size; ++i) {
+      ASSERT_TRUE(v.IsSet(i));
+    }
+    // No bits beyond the end of the vector may be found.
+    if (size > 0) {
+      v.Clear(size - 1);
+      ASSERT_EQ(size, v.FindNextSet(size - 1));
+    }
+  }
+}
+
 }  // namespace
 }  // namespace openscreen
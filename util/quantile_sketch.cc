@@ -0,0 +1,195 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "util/osp_logging.h"
+
+namespace openscreen {
+
+namespace {
+
+// Values closer to zero than this are counted as zero, rather than being given
+// buckets of their own.
+constexpr double kMinIndexableValue = 1e-9;
+
+}  // namespace
+
+QuantileSketch::QuantileSketch(double relative_accuracy, int max_num_buckets)
+    : relative_accuracy_(relative_accuracy),
+      gamma_((1 + relative_accuracy) / (1 - relative_accuracy)),
+      log_gamma_(std::log(gamma_)),
+      positive_store_(max_num_buckets),
+      negative_store_(max_num_buckets) {
+  OSP_CHECK_GT(relative_accuracy, 0);
+  OSP_CHECK_LT(relative_accuracy, 1);
+}
+
+QuantileSketch::QuantileSketch(const QuantileSketch&) = default;
+QuantileSketch::QuantileSketch(QuantileSketch&&) noexcept = default;
+QuantileSketch& QuantileSketch::operator=(const QuantileSketch&) = default;
+QuantileSketch& QuantileSketch::operator=(QuantileSketch&&) = default;
+QuantileSketch::~QuantileSketch() = default;
+
+void QuantileSketch::Add(double value) {
+  if (value > kMinIndexableValue) {
+    positive_store_.Add(GetIndex(value), 1);
+  } else if (value < -kMinIndexableValue) {
+    negative_store_.Add(GetIndex(-value), 1);
+  } else {
+    ++zero_count_;
+  }
+
+  if (count_ == 0) {
+    min_ = value;
+    max_ = value;
+  } else {
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+  ++count_;
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+  OSP_CHECK_EQ(relative_accuracy_, other.relative_accuracy_);
+  if (other.empty()) {
+    return;
+  }
+
+  positive_store_.Merge(other.positive_store_);
+  negative_store_.Merge(other.negative_store_);
+  zero_count_ += other.zero_count_;
+  if (empty()) {
+    min_ = other.min_;
+    max_ = other.max_;
+  } else {
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+  }
+  count_ += other.count_;
+}
+
+void QuantileSketch::Reset() {
+  positive_store_.Reset();
+  negative_store_.Reset();
+  zero_count_ = 0;
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+}
+
+double QuantileSketch::GetQuantile(double quantile) const {
+  OSP_CHECK(!empty());
+  OSP_CHECK_GE(quantile, 0);
+  OSP_CHECK_LE(quantile, 1);
+
+  // The extremes are known exactly, and bound all other estimates.
+  int64_t rank = static_cast<int64_t>(quantile * (count_ - 1));
+  if (rank == 0) {
+    return min_;
+  }
+  if (rank == count_ - 1) {
+    return max_;
+  }
+
+  // The values are ordered from the most negative to the most positive.
+  double value = 0;
+  if (rank < negative_store_.count()) {
+    value = -GetValue(negative_store_.GetIndexOfRank(rank, false));
+  } else {
+    rank -= negative_store_.count() + zero_count_;
+    if (rank >= 0) {
+      value = GetValue(positive_store_.GetIndexOfRank(rank, true));
+    }
+  }
+
+  return std::clamp(value, min_, max_);
+}
+
+int QuantileSketch::GetIndex(double value) const {
+  // Bucket i holds the values in (gamma^(i-1), gamma^i].
+  return static_cast<int>(std::ceil(std::log(value) / log_gamma_));
+}
+
+double QuantileSketch::GetValue(int index) const {
+  // The value with the same relative error to both bounds of the bucket.
+  return 2 * std::exp(index * log_gamma_) / (gamma_ + 1);
+}
+
+QuantileSketch::Store::Store(int max_num_buckets)
+    : max_num_buckets_(max_num_buckets) {
+  OSP_CHECK_GT(max_num_buckets_, 0);
+}
+
+QuantileSketch::Store::Store(const Store&) = default;
+QuantileSketch::Store::Store(Store&&) noexcept = default;
+QuantileSketch::Store& QuantileSketch::Store::operator=(const Store&) = default;
+QuantileSketch::Store& QuantileSketch::Store::operator=(Store&&) = default;
+QuantileSketch::Store::~Store() = default;
+
+void QuantileSketch::Store::Add(int index, int64_t count) {
+  index = ExtendRange(index);
+  counts_[index - offset_] += count;
+  count_ += count;
+}
+
+void QuantileSketch::Store::Merge(const Store& other) {
+  for (size_t i = 0; i < other.counts_.size(); ++i) {
+    if (other.counts_[i] > 0) {
+      Add(other.offset_ + static_cast<int>(i), other.counts_[i]);
+    }
+  }
+}
+
+void QuantileSketch::Store::Reset() {
+  counts_.clear();
+  offset_ = 0;
+  count_ = 0;
+}
+
+int QuantileSketch::Store::GetIndexOfRank(int64_t rank, bool ascending) const {
+  OSP_CHECK_LT(rank, count_);
+  int64_t seen = 0;
+  const int size = static_cast<int>(counts_.size());
+  for (int i = 0; i < size; ++i) {
+    const int position = ascending ? i : size - 1 - i;
+    seen += counts_[position];
+    if (seen > rank) {
+      return offset_ + position;
+    }
+  }
+  OSP_NOTREACHED();
+}
+
+int QuantileSketch::Store::ExtendRange(int index) {
+  if (counts_.empty()) {
+    counts_.resize(1);
+    offset_ = index;
+    return index;
+  }
+
+  const int low = offset_;
+  const int high = offset_ + static_cast<int>(counts_.size()) - 1;
+  if (index >= low && index <= high) {
+    return index;
+  }
+
+  const int new_high = std::max(high, index);
+  const int new_low =
+      std::max(std::min(low, index), new_high - max_num_buckets_ + 1);
+  std::vector<int64_t> new_counts(new_high - new_low + 1);
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    const int old_index = low + static_cast<int>(i);
+    new_counts[std::max(old_index, new_low) - new_low] += counts_[i];
+  }
+  counts_ = std::move(new_counts);
+  offset_ = new_low;
+  return std::max(index, new_low);
+}
+
+}  // namespace openscreen
@@ -0,0 +1,119 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UTIL_QUANTILE_SKETCH_H_
+#define UTIL_QUANTILE_SKETCH_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace openscreen {
+
+// A streaming quantile sketch, based on DDSketch (Masson et al., "DDSketch: A
+// Fast and Fully-Mergeable Quantile Sketch with Relative-Error Guarantees",
+// VLDB 2019).
+//
+// Values are counted in logarithmically-sized buckets, so that any quantile
+// estimate is within `relative_accuracy` of the exact quantile's value. Memory
+// is bounded by `max_num_buckets`, for each of the positive and negative
+// values: should more buckets be needed, the buckets of the values closest to
+// zero are merged, losing accuracy only for those values. With the default
+// settings, that takes a range of values spanning more than 17 orders of
+// magnitude.
+//
+// Two sketches with the same settings can be merged, with the result being the
+// same as if all values had been added to one of them.
+class QuantileSketch {
+ public:
+  static constexpr double kDefaultRelativeAccuracy = 0.01;
+  static constexpr int kDefaultMaxNumBuckets = 2048;
+
+  explicit QuantileSketch(double relative_accuracy = kDefaultRelativeAccuracy,
+                          int max_num_buckets = kDefaultMaxNumBuckets);
+  QuantileSketch(const QuantileSketch&);
+  QuantileSketch(QuantileSketch&&) noexcept;
+  QuantileSketch& operator=(const QuantileSketch&);
+  QuantileSketch& operator=(QuantileSketch&&);
+  ~QuantileSketch();
+
+  void Add(double value);
+
+  // Adds all of the values added to `other`, which must have the same
+  // settings.
+  void Merge(const QuantileSketch& other);
+
+  void Reset();
+
+  // Returns an estimate of the `quantile`, between 0 and 1, of the values
+  // added. Must not be called if empty().
+  double GetQuantile(double quantile) const;
+
+  bool empty() const { return count_ == 0; }
+  int64_t count() const { return count_; }
+
+  // The exact minimum and maximum of the values added, if not empty().
+  double min() const { return min_; }
+  double max() const { return max_; }
+
+ private:
+  // Counts of the values in a contiguous range of bucket indices. The range
+  // grows as needed, up to a maximum size, beyond which the lowest buckets are
+  // collapsed into one.
+  class Store {
+   public:
+    explicit Store(int max_num_buckets);
+    Store(const Store&);
+    Store(Store&&) noexcept;
+    Store& operator=(const Store&);
+    Store& operator=(Store&&);
+    ~Store();
+
+    void Add(int index, int64_t count);
+    void Merge(const Store& other);
+    void Reset();
+
+    // Returns the index of the bucket holding the value of the given `rank`,
+    // counting from the lowest bucket if `ascending`, or the highest one
+    // otherwise.
+    int GetIndexOfRank(int64_t rank, bool ascending) const;
+
+    int64_t count() const { return count_; }
+
+   private:
+    // Makes the range of buckets include `index`, collapsing the lowest
+    // buckets if needed, and returns the (possibly collapsed) index to use.
+    int ExtendRange(int index);
+
+    int max_num_buckets_;
+    std::vector<int64_t> counts_;
+
+    // The bucket index of `counts_[0]`.
+    int offset_ = 0;
+    int64_t count_ = 0;
+  };
+
+  // Returns the index of the bucket of a positive `value`, and the value that
+  // represents the bucket of an `index`.
+  int GetIndex(double value) const;
+  double GetValue(int index) const;
+
+  double relative_accuracy_;
+  double gamma_;
+  double log_gamma_;
+
+  // The buckets of the positive and negative values, and the count of the
+  // values too close to zero to be indexed.
+  Store positive_store_;
+  Store negative_store_;
+  int64_t zero_count_ = 0;
+
+  int64_t count_ = 0;
+  double min_ = 0;
+  double max_ = 0;
+};
+
+}  // namespace openscreen
+
+#endif  // UTIL_QUANTILE_SKETCH_H_
@@ -0,0 +1,160 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/quantile_sketch.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace {
+
+constexpr double kQuantiles[] = {0,   0.01, 0.1,  0.25, 0.5,  0.75,
+                                 0.9, 0.95, 0.99, 0.999, 1};
+
+// Returns the exact `quantile` of the `sorted_values`, with the same definition
+// of rank as QuantileSketch.
+double GetExactQuantile(const std::vector<double>& sorted_values,
+                        double quantile) {
+  const auto rank =
+      static_cast<size_t>(quantile * (sorted_values.size() - 1));
+  return sorted_values[rank];
+}
+
+// Checks that every estimate of `sketch` is within its relative accuracy of
+// the exact quantile of `values`.
+void ExpectAccurate(const QuantileSketch& sketch,
+                    std::vector<double> values,
+                    double relative_accuracy) {
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(static_cast<int64_t>(values.size()), sketch.count());
+  EXPECT_EQ(values.front(), sketch.min());
+  EXPECT_EQ(values.back(), sketch.max());
+  for (double quantile : kQuantiles) {
+    const double exact = GetExactQuantile(values, quantile);
+    EXPECT_NEAR(exact, sketch.GetQuantile(quantile),
+                relative_accuracy * std::abs(exact) + 1e-9)
+        << "quantile=" << quantile;
+  }
+}
+
+TEST(QuantileSketchTest, StartsEmpty) {
+  QuantileSketch sketch;
+  EXPECT_TRUE(sketch.empty());
+  EXPECT_EQ(0, sketch.count());
+
+  sketch.Add(42);
+  EXPECT_FALSE(sketch.empty());
+  EXPECT_EQ(1, sketch.count());
+  for (double quantile : kQuantiles) {
+    EXPECT_EQ(42, sketch.GetQuantile(quantile));
+  }
+
+  sketch.Reset();
+  EXPECT_TRUE(sketch.empty());
+}
+
+TEST(QuantileSketchTest, IsAccurateForUniformValues) {
+  std::minstd_rand rand(1);
+  std::uniform_real_distribution<double> distribution(0, 1000);
+  QuantileSketch sketch;
+  std::vector<double> values;
+  for (int i = 0; i < 100000; ++i) {
+    values.push_back(distribution(rand));
+    sketch.Add(values.back());
+  }
+  ExpectAccurate(sketch, values, QuantileSketch::kDefaultRelativeAccuracy);
+}
+
+// Latencies typically have a long tail, which is where the accuracy of a
+// fixed-width histogram suffers the most.
+TEST(QuantileSketchTest, IsAccurateForLongTailedValues) {
+  std::minstd_rand rand(2);
+  std::lognormal_distribution<double> distribution(3, 1.5);
+  for (double relative_accuracy : {0.005, 0.01, 0.05}) {
+    QuantileSketch sketch(relative_accuracy);
+    std::vector<double> values;
+    for (int i = 0; i < 100000; ++i) {
+      values.push_back(distribution(rand));
+      sketch.Add(values.back());
+    }
+    ExpectAccurate(sketch, values, relative_accuracy);
+  }
+}
+
+TEST(QuantileSketchTest, IsAccurateForNegativeAndZeroValues) {
+  std::minstd_rand rand(3);
+  std::normal_distribution<double> distribution(5, 20);
+  QuantileSketch sketch;
+  std::vector<double> values;
+  for (int i = 0; i < 50000; ++i) {
+    values.push_back(distribution(rand));
+    sketch.Add(values.back());
+    if (i % 10 == 0) {
+      values.push_back(0);
+      sketch.Add(0);
+    }
+  }
+  ExpectAccurate(sketch, values, QuantileSketch::kDefaultRelativeAccuracy);
+}
+
+TEST(QuantileSketchTest, MergesAsIfAllValuesWereAddedToOne) {
+  std::minstd_rand rand(4);
+  std::exponential_distribution<double> distribution(0.01);
+  QuantileSketch first;
+  QuantileSketch second;
+  QuantileSketch both;
+  std::vector<double> values;
+  for (int i = 0; i < 20000; ++i) {
+    const double value = distribution(rand);
+    values.push_back(value);
+    (i % 3 == 0 ? first : second).Add(value);
+    both.Add(value);
+  }
+
+  first.Merge(second);
+  first.Merge(QuantileSketch());
+  ExpectAccurate(first, values, QuantileSketch::kDefaultRelativeAccuracy);
+  for (double quantile : kQuantiles) {
+    EXPECT_EQ(both.GetQuantile(quantile), first.GetQuantile(quantile));
+  }
+
+  QuantileSketch empty;
+  empty.Merge(both);
+  EXPECT_EQ(both.count(), empty.count());
+  EXPECT_EQ(both.min(), empty.min());
+  EXPECT_EQ(both.max(), empty.max());
+}
+
+// Tests that when the values span more buckets than allowed, only the
+// estimates of the values closest to zero lose accuracy.
+TEST(QuantileSketchTest, CollapsesTheLowestBuckets) {
+  // 64 buckets of 1% cover a range of about 3.6x.
+  QuantileSketch sketch(0.01, 64);
+  std::vector<double> values;
+  for (int i = 1; i <= 1000; ++i) {
+    values.push_back(i);
+    sketch.Add(i);
+  }
+  std::sort(values.begin(), values.end());
+
+  for (double quantile : {0.5, 0.9, 0.99}) {
+    const double exact = GetExactQuantile(values, quantile);
+    EXPECT_NEAR(exact, sketch.GetQuantile(quantile), 0.01 * exact);
+  }
+  EXPECT_EQ(1000, sketch.GetQuantile(1));
+  EXPECT_EQ(1, sketch.GetQuantile(0));
+
+  // The lowest values were collapsed into the lowest remaining bucket.
+  EXPECT_LT(100, sketch.GetQuantile(0.01));
+}
+
+}  // namespace
+}  // namespace openscreen
@@ -0,0 +1,113 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UTIL_SPSC_RING_BUFFER_H_
+#define UTIL_SPSC_RING_BUFFER_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "util/osp_logging.h"
+
+namespace openscreen {
+
+// A fixed-capacity, lock-free queue for exactly one producer thread and one
+// consumer thread. Pushing never allocates: when the queue is full, the new
+// element is rejected, so that a slow consumer can never stall the producer.
+//
+// The producer calls only TryPush(), and the consumer calls only TryPop() and
+// PopAll(). Both may call capacity() and empty(). The producer and the consumer
+// may also be the same thread.
+template <typename T>
+class SpscRingBuffer {
+ public:
+  // `capacity` must be a power of two.
+  explicit SpscRingBuffer(size_t capacity)
+      : capacity_(capacity), slots_(std::make_unique<T[]>(capacity)) {
+    OSP_CHECK_GT(capacity_, size_t{0});
+    OSP_CHECK_EQ(capacity_ & (capacity_ - 1), size_t{0});
+  }
+
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+  ~SpscRingBuffer() = default;
+
+  size_t capacity() const { return capacity_; }
+
+  // Returns true if there are no elements to pop. Only a snapshot, if called
+  // while the other thread is pushing or popping.
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+  // Appends `value` to the queue, or returns false if the queue is full.
+  bool TryPush(T value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == capacity_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ == capacity_) {
+        return false;
+      }
+    }
+    slots_[tail & (capacity_ - 1)] = std::move(value);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Removes the oldest element of the queue into `value`, or returns false if
+  // the queue is empty.
+  bool TryPop(T* value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) {
+        return false;
+      }
+    }
+    *value = std::move(slots_[head & (capacity_ - 1)]);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Removes all of the elements of the queue, appending them to `values`.
+  // Returns the number of elements removed.
+  size_t PopAll(std::vector<T>* values) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    for (size_t i = head; i != cached_tail_; ++i) {
+      values->push_back(std::move(slots_[i & (capacity_ - 1)]));
+    }
+    head_.store(cached_tail_, std::memory_order_release);
+    return cached_tail_ - head;
+  }
+
+ private:
+  // The size of a cache line, used to keep the positions owned by the producer
+  // and the consumer from sharing one.
+  static constexpr size_t kCacheLineSize = 64;
+
+  const size_t capacity_;
+  const std::unique_ptr<T[]> slots_;
+
+  // The total number of elements ever popped, written only by the consumer,
+  // and the consumer's last read of `tail_`. Both are on the consumer's cache
+  // line, so that TryPop() never touches the producer's.
+  alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+  size_t cached_tail_ = 0;
+
+  // The total number of elements ever pushed, written only by the producer,
+  // and the producer's last read of `head_`. Both are on the producer's cache
+  // line, so that TryPush() never touches the consumer's.
+  alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+  size_t cached_head_ = 0;
+};
+
+}  // namespace openscreen
+
+#endif  // UTIL_SPSC_RING_BUFFER_H_
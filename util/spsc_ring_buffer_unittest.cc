@@ -0,0 +1,113 @@
+// Copyright 2026 The Chromium Authors
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/spsc_ring_buffer.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace {
+
+TEST(SpscRingBufferTest, PushesAndPopsInOrder) {
+  SpscRingBuffer<int> buffer(4);
+  EXPECT_EQ(4u, buffer.capacity());
+  EXPECT_TRUE(buffer.empty());
+
+  int value = 0;
+  EXPECT_FALSE(buffer.TryPop(&value));
+
+  EXPECT_TRUE(buffer.TryPush(1));
+  EXPECT_TRUE(buffer.TryPush(2));
+  EXPECT_FALSE(buffer.empty());
+  ASSERT_TRUE(buffer.TryPop(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(buffer.TryPop(&value));
+  EXPECT_EQ(2, value);
+  EXPECT_FALSE(buffer.TryPop(&value));
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(SpscRingBufferTest, RejectsPushesWhenFull) {
+  SpscRingBuffer<int> buffer(4);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(buffer.TryPush(i));
+  }
+  EXPECT_FALSE(buffer.TryPush(4));
+
+  // Popping one element makes room for one more.
+  int value = 0;
+  ASSERT_TRUE(buffer.TryPop(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(buffer.TryPush(5));
+  EXPECT_FALSE(buffer.TryPush(6));
+
+  std::vector<int> values;
+  EXPECT_EQ(4u, buffer.PopAll(&values));
+  EXPECT_EQ((std::vector<int>{1, 2, 3, 5}), values);
+}
+
+TEST(SpscRingBufferTest, PopAllAppendsAcrossTheWrapAround) {
+  SpscRingBuffer<int> buffer(8);
+  std::vector<int> values;
+  int next_value = 0;
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 5; ++i) {
+      ASSERT_TRUE(buffer.TryPush(next_value++));
+    }
+    EXPECT_EQ(5u, buffer.PopAll(&values));
+    EXPECT_EQ(0u, buffer.PopAll(&values));
+  }
+
+  ASSERT_EQ(50u, values.size());
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(i, values[i]);
+  }
+}
+
+TEST(SpscRingBufferTest, MovesElements) {
+  SpscRingBuffer<std::unique_ptr<int>> buffer(2);
+  EXPECT_TRUE(buffer.TryPush(std::make_unique<int>(42)));
+  std::unique_ptr<int> value;
+  ASSERT_TRUE(buffer.TryPop(&value));
+  ASSERT_TRUE(value);
+  EXPECT_EQ(42, *value);
+}
+
+// Tests that every element pushed by one thread is popped, in order, by
+// another thread.
+TEST(SpscRingBufferTest, TransfersElementsBetweenThreads) {
+  constexpr int kNumElements = 100000;
+  SpscRingBuffer<int> buffer(64);
+
+  std::thread producer([&buffer] {
+    for (int i = 0; i < kNumElements;) {
+      if (buffer.TryPush(i)) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::vector<int> values;
+  values.reserve(kNumElements);
+  while (values.size() < kNumElements) {
+    if (buffer.PopAll(&values) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  for (int i = 0; i < kNumElements; ++i) {
+    ASSERT_EQ(i, values[i]);
+  }
+  EXPECT_TRUE(buffer.empty());
+}
+
+}  // namespace
+}  // namespace openscreen